@@ -1,11 +1,20 @@
 # LIBRARIES
 ##################################################
-common_libolacommon_la_SOURCES += common/dmx/RunLengthEncoder.cpp
+common_libolacommon_la_SOURCES += \
+    common/dmx/RunLengthEncoder.cpp \
+    common/dmx/SignalDecoder.cpp \
+    common/dmx/SignalDecoder.h
 
 # TESTS
 ##################################################
-test_programs += common/dmx/RunLengthEncoderTester
+test_programs += \
+    common/dmx/RunLengthEncoderTester \
+    common/dmx/SignalDecoderTester
 
 common_dmx_RunLengthEncoderTester_SOURCES = common/dmx/RunLengthEncoderTest.cpp
 common_dmx_RunLengthEncoderTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 common_dmx_RunLengthEncoderTester_LDADD = $(COMMON_TESTING_LIBS)
+
+common_dmx_SignalDecoderTester_SOURCES = common/dmx/SignalDecoderTest.cpp
+common_dmx_SignalDecoderTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
+common_dmx_SignalDecoderTester_LDADD = $(COMMON_TESTING_LIBS)
@@ -0,0 +1,316 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * SignalDecoder.cpp
+ * Decode DMX / RDM frames from a sampled signal.
+ * Copyright (C) 2026 agent
+ *
+ * Rather than running a state machine for every sample, the decoder measures
+ * the length of each run of high or low samples, and works out how many bits
+ * the run covers. A falling edge after the stop bits could either be a start
+ * bit or a break; once the low run ends we know which it was.
+ */
+
+#include <string.h>
+#include <ola/Logging.h>
+#include <vector>
+
+#include "common/dmx/SignalDecoder.h"
+
+namespace ola {
+namespace dmx {
+
+using std::vector;
+
+namespace {
+
+const uint64_t ONES = 0x0101010101010101ULL;
+const uint64_t HIGH_BITS = 0x8080808080808080ULL;
+
+inline uint64_t LoadWord(const uint8_t *data) {
+  uint64_t word;
+  memcpy(&word, data, sizeof(word));
+  return word;
+}
+
+// True if any of the bytes in word are 0.
+inline bool HasZeroByte(uint64_t word) {
+  return (word - ONES) & ~word & HIGH_BITS;
+}
+}  // namespace
+
+unsigned int FindEndOfRun(const uint8_t *data, unsigned int size,
+                          uint8_t value) {
+  const uint64_t pattern = ONES * value;
+  unsigned int i = 0;
+  while (i + sizeof(pattern) <= size && LoadWord(data + i) == pattern) {
+    i += sizeof(pattern);
+  }
+  while (i < size && data[i] == value) {
+    i++;
+  }
+  return i;
+}
+
+unsigned int FindLevelChange(const uint8_t *samples, unsigned int size,
+                             uint8_t mask, bool level) {
+  const uint64_t word_mask = ONES * mask;
+  unsigned int i = 0;
+  if (level) {
+    while (i + sizeof(word_mask) <= size &&
+           !HasZeroByte(LoadWord(samples + i) & word_mask)) {
+      i += sizeof(word_mask);
+    }
+    while (i < size && (samples[i] & mask)) {
+      i++;
+    }
+  } else {
+    while (i + sizeof(word_mask) <= size &&
+           !(LoadWord(samples + i) & word_mask)) {
+      i += sizeof(word_mask);
+    }
+    while (i < size && !(samples[i] & mask)) {
+      i++;
+    }
+  }
+  return i;
+}
+
+
+const double SignalDecoder::BIT_TIME = 4.0;
+const double SignalDecoder::MIN_BREAK_TIME = 88.0;
+const double SignalDecoder::MIN_MAB_TIME = 8.0;
+const double SignalDecoder::MAX_MAB_TIME = 1000000.0;
+const double SignalDecoder::MAX_MARK_BETWEEN_SLOTS = 1000000.0;
+
+SignalDecoder::SignalDecoder(FrameCallback *callback,
+                             unsigned int sample_rate)
+    : m_callback(callback),
+      m_microseconds_per_tick(1000000.0 / sample_rate),
+      m_state(IDLE),
+      m_level(true),
+      m_run_ticks(0),
+      m_bit(0),
+      m_current_byte(0) {
+  if (sample_rate % DMX_BITRATE) {
+    OLA_WARN << "Sample rate is not a multiple of " << DMX_BITRATE;
+  }
+}
+
+void SignalDecoder::Reset() {
+  m_state = IDLE;
+  m_level = true;
+  m_run_ticks = 0;
+  m_frame.clear();
+}
+
+void SignalDecoder::Process(const uint8_t *samples, unsigned int size,
+                            uint8_t mask) {
+  unsigned int i = 0;
+  while (i < size) {
+    unsigned int end = i + FindLevelChange(samples + i, size - i, mask,
+                                           m_level);
+    m_run_ticks += end - i;
+    i = end;
+    if (i < size) {
+      EndRun();
+    }
+  }
+  CheckForTimeout();
+}
+
+void SignalDecoder::ProcessPacked(const uint8_t *data, unsigned int size) {
+  unsigned int i = 0;
+  while (i < size) {
+    unsigned int end = i + FindEndOfRun(data + i, size - i,
+                                        m_level ? 0xff : 0x00);
+    m_run_ticks += 8 * (end - i);
+    i = end;
+    if (i == size) {
+      break;
+    }
+
+    uint8_t byte = data[i++];
+    for (int bit = 7; bit >= 0; bit--) {
+      bool level = (byte >> bit) & 0x01;
+      if (level != m_level) {
+        EndRun();
+      }
+      m_run_ticks++;
+    }
+  }
+  CheckForTimeout();
+}
+
+void SignalDecoder::Flush() {
+  // The stop bits of the last slot are part of the current high run, so
+  // that slot isn't complete until the run ends.
+  if (m_level && m_state == IN_SLOT) {
+    HighRun(m_run_ticks * m_microseconds_per_tick);
+  }
+  HandleFrame();
+  m_state = IDLE;
+}
+
+/**
+ * Called on each edge, with the length of the run that just ended.
+ */
+void SignalDecoder::EndRun() {
+  double duration = m_run_ticks * m_microseconds_per_tick;
+  if (m_level) {
+    HighRun(duration);
+  } else {
+    LowRun(duration);
+  }
+  m_level = !m_level;
+  m_run_ticks = 0;
+}
+
+void SignalDecoder::LowRun(double duration) {
+  if (duration >= MIN_BREAK_TIME) {
+    if (m_state == IN_SLOT && m_bit > 0) {
+      OLA_INFO << "Break during slot " << m_frame.size();
+    }
+    HandleFrame();
+    m_state = BREAK;
+    return;
+  }
+
+  switch (m_state) {
+    case IDLE:
+      OLA_DEBUG << "Break too short, was " << duration << " us";
+      break;
+    case MARK_BETWEEN_SLOTS:
+      m_state = IN_SLOT;
+      m_bit = 0;
+      m_current_byte = 0;
+      // fall through
+    case IN_SLOT:
+      {
+        unsigned int bits = DurationToBits(duration);
+        if (bits == 0) {
+          OLA_INFO << "Bit " << m_bit << " was too short, was " << duration
+                   << " us";
+          HandleFrame();
+          m_state = UNDEFINED;
+        } else if (m_bit + bits > 9) {
+          OLA_INFO << "Saw a low during a stop bit";
+          HandleFrame();
+          m_state = UNDEFINED;
+        } else {
+          m_bit += bits;
+        }
+      }
+      break;
+    default:
+      break;
+  }
+}
+
+void SignalDecoder::HighRun(double duration) {
+  switch (m_state) {
+    case UNDEFINED:
+      m_state = IDLE;
+      break;
+    case BREAK:
+      if (duration < MIN_MAB_TIME) {
+        OLA_INFO << "Mark too short, was " << duration << " us";
+        m_state = UNDEFINED;
+      } else if (duration >= MAX_MAB_TIME) {
+        m_state = IDLE;
+      } else {
+        m_frame.clear();
+        m_state = MARK_BETWEEN_SLOTS;
+      }
+      break;
+    case IN_SLOT:
+      {
+        unsigned int bits = DurationToBits(duration);
+        if (bits == 0) {
+          OLA_INFO << "Bit " << m_bit << " was too short, was " << duration
+                   << " us";
+          HandleFrame();
+          m_state = UNDEFINED;
+          break;
+        }
+
+        // Data bits are sent LSB first, starting at bit 1.
+        for (unsigned int bit = m_bit; bit < m_bit + bits && bit < 9; bit++) {
+          m_current_byte |= 1 << (bit - 1);
+        }
+        m_bit += bits;
+        if (m_bit >= 11) {
+          m_frame.push_back(m_current_byte);
+          m_state = MARK_BETWEEN_SLOTS;
+          if (duration >= MAX_MARK_BETWEEN_SLOTS) {
+            HandleFrame();
+            m_state = IDLE;
+          }
+        } else if (m_bit > 9) {
+          OLA_INFO << "Saw a low during a stop bit";
+          HandleFrame();
+          m_state = UNDEFINED;
+        }
+      }
+      break;
+    case MARK_BETWEEN_SLOTS:
+      if (duration >= MAX_MARK_BETWEEN_SLOTS) {
+        HandleFrame();
+        m_state = IDLE;
+      }
+      break;
+    default:
+      break;
+  }
+}
+
+/**
+ * Check if the current high run has lasted long enough to end the frame.
+ */
+void SignalDecoder::CheckForTimeout() {
+  if (!m_level || (m_state != IN_SLOT && m_state != MARK_BETWEEN_SLOTS)) {
+    return;
+  }
+  double duration = m_run_ticks * m_microseconds_per_tick;
+  if (duration >= MAX_MARK_BETWEEN_SLOTS) {
+    // This moves us to IDLE, so the rest of the run is ignored.
+    HighRun(duration);
+  }
+}
+
+/**
+ * Return the number of bits a run covers.
+ */
+unsigned int SignalDecoder::DurationToBits(double duration) const {
+  return static_cast<unsigned int>((duration + BIT_TIME / 2) / BIT_TIME);
+}
+
+/**
+ * Called when we know the previous frame is complete. This invokes the
+ * callback if there is one, and resets the frame.
+ */
+void SignalDecoder::HandleFrame() {
+  if (m_state != IN_SLOT && m_state != MARK_BETWEEN_SLOTS) {
+    m_frame.clear();
+    return;
+  }
+  OLA_DEBUG << "Got frame of size " << m_frame.size();
+  if (m_callback.get() && !m_frame.empty()) {
+    m_callback->Run(&m_frame[0], m_frame.size());
+  }
+  m_frame.clear();
+}
+}  // namespace dmx
+}  // namespace ola
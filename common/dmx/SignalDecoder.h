@@ -0,0 +1,163 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * SignalDecoder.h
+ * Decode DMX / RDM frames from a sampled signal.
+ * Copyright (C) 2026 agent
+ */
+
+#ifndef COMMON_DMX_SIGNALDECODER_H_
+#define COMMON_DMX_SIGNALDECODER_H_
+
+#include <stdint.h>
+#include <ola/Callback.h>
+#include <ola/base/Macro.h>
+
+#include <memory>
+#include <vector>
+
+namespace ola {
+namespace dmx {
+
+/**
+ * @brief Find the end of a run of identical bytes.
+ * @param data the data to scan.
+ * @param size the size of the data.
+ * @param value the value of the bytes in the run.
+ * @returns the index of the first byte which doesn't equal value, or size if
+ *   all the bytes match.
+ */
+unsigned int FindEndOfRun(const uint8_t *data, unsigned int size,
+                          uint8_t value);
+
+/**
+ * @brief Find the first sample with a different level.
+ * @param samples the samples to scan, one per byte.
+ * @param size the number of samples.
+ * @param mask the bits of each sample which make up the signal. The signal is
+ *   high if any of these bits are set.
+ * @param level the level of the current run.
+ * @returns the index of the first sample which isn't at level, or size if
+ *   all the samples are at that level.
+ */
+unsigned int FindLevelChange(const uint8_t *samples, unsigned int size,
+                             uint8_t mask, bool level);
+
+/**
+ * @brief Decodes DMX / RDM frames from a sampled signal.
+ *
+ * The decoder finds the edges in the signal, and then decodes the frames from
+ * the time between the edges. Runs of samples at the same level, which make
+ * up most of a DMX signal, are skipped a word at a time.
+ *
+ * See E1.11 for the details including timing. It generally goes something
+ * like:
+ *  - Mark (Idle) - High
+ *  - Break - Low
+ *  - Mark After Break - High
+ *  - Start bit (low)
+ *  - LSB to MSB (8)
+ *  - 2 stop bits (high)
+ *  - Mark between slots (high)
+ *
+ * A frame is complete when the next break arrives, the mark between slots
+ * exceeds 1s, or Flush() is called.
+ */
+class SignalDecoder {
+ public:
+  /**
+   * @brief Called with each frame, the first byte is the start code.
+   */
+  typedef Callback2<void, const uint8_t*, unsigned int> FrameCallback;
+
+  /**
+   * @brief Create a new SignalDecoder.
+   * @param callback the callback to run when a frame is received, ownership
+   *   is transferred.
+   * @param sample_rate the sample rate in Hz.
+   */
+  SignalDecoder(FrameCallback *callback, unsigned int sample_rate);
+
+  /**
+   * @brief Reset the decoder. Used if there is a gap in the stream.
+   */
+  void Reset();
+
+  /**
+   * @brief Decode samples which are stored one per byte.
+   * @param samples the samples to decode.
+   * @param size the number of samples.
+   * @param mask the bits of each sample which make up the signal.
+   */
+  void Process(const uint8_t *samples, unsigned int size,
+               uint8_t mask = 0xff);
+
+  /**
+   * @brief Decode samples which are packed 8 per byte, MSB first, as
+   *   received from a SPI bus.
+   * @param data the packed samples.
+   * @param size the size of the data in bytes.
+   */
+  void ProcessPacked(const uint8_t *data, unsigned int size);
+
+  /**
+   * @brief Run the callback for any partial frame, e.g. at the end of a
+   *   capture.
+   */
+  void Flush();
+
+ private:
+  enum State {
+    UNDEFINED,  // when the signal is low and we have no idea where we are.
+    IDLE,
+    BREAK,
+    IN_SLOT,
+    MARK_BETWEEN_SLOTS,
+  };
+
+  std::auto_ptr<FrameCallback> m_callback;
+  const double m_microseconds_per_tick;
+
+  State m_state;
+  // The level of the current run and the number of samples it has lasted.
+  bool m_level;
+  uint64_t m_run_ticks;
+
+  // The bit within the current slot, 0 is the start bit, 9 & 10 are the stop
+  // bits.
+  unsigned int m_bit;
+  uint8_t m_current_byte;
+  std::vector<uint8_t> m_frame;
+
+  void EndRun();
+  void LowRun(double duration);
+  void HighRun(double duration);
+  void CheckForTimeout();
+  unsigned int DurationToBits(double duration) const;
+  void HandleFrame();
+
+  static const unsigned int DMX_BITRATE = 250000;
+  // These are all in microseconds and are the receiver side limits.
+  static const double BIT_TIME;
+  static const double MIN_BREAK_TIME;
+  static const double MIN_MAB_TIME;
+  static const double MAX_MAB_TIME;
+  static const double MAX_MARK_BETWEEN_SLOTS;
+
+  DISALLOW_COPY_AND_ASSIGN(SignalDecoder);
+};
+}  // namespace dmx
+}  // namespace ola
+#endif  // COMMON_DMX_SIGNALDECODER_H_
@@ -0,0 +1,343 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * SignalDecoderTest.cpp
+ * Test fixture for the SignalDecoder class
+ * Copyright (C) 2026 agent
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+
+#include "common/dmx/SignalDecoder.h"
+#include "ola/Callback.h"
+#include "ola/Logging.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::dmx::FindEndOfRun;
+using ola::dmx::FindLevelChange;
+using ola::dmx::SignalDecoder;
+using std::vector;
+
+namespace {
+
+/**
+ * Build a sampled DMX signal.
+ */
+class SignalBuilder {
+ public:
+  explicit SignalBuilder(unsigned int sample_rate)
+      : m_samples_per_bit(sample_rate / 250000) {
+  }
+
+  // Add a level for a number of microseconds.
+  void Add(bool level, unsigned int micro_seconds) {
+    m_samples.insert(m_samples.end(),
+                     micro_seconds * m_samples_per_bit / 4,
+                     level ? 0x01 : 0x00);
+  }
+
+  void AddFrame(const uint8_t *data, unsigned int size,
+                unsigned int break_time = 100) {
+    Add(false, break_time);
+    Add(true, 12);
+    for (unsigned int i = 0; i < size; i++) {
+      AddBits(false, 1);  // start bit
+      for (unsigned int bit = 0; bit < 8; bit++) {
+        AddBits((data[i] >> bit) & 0x01, 1);
+      }
+      AddBits(true, 2);  // stop bits
+    }
+  }
+
+  // Pack the samples 8 per byte, MSB first.
+  vector<uint8_t> Packed() const {
+    vector<uint8_t> packed((m_samples.size() + 7) / 8, 0xff);
+    for (unsigned int i = 0; i < m_samples.size(); i++) {
+      if (!m_samples[i]) {
+        packed[i / 8] &= ~(0x80 >> (i % 8));
+      }
+    }
+    return packed;
+  }
+
+  const vector<uint8_t> &Samples() const { return m_samples; }
+
+ private:
+  const unsigned int m_samples_per_bit;
+  vector<uint8_t> m_samples;
+
+  void AddBits(bool level, unsigned int bits) {
+    m_samples.insert(m_samples.end(), bits * m_samples_per_bit,
+                     level ? 0x01 : 0x00);
+  }
+};
+}  // namespace
+
+
+class SignalDecoderTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(SignalDecoderTest);
+  CPPUNIT_TEST(testFindEndOfRun);
+  CPPUNIT_TEST(testFindLevelChange);
+  CPPUNIT_TEST(testDecode);
+  CPPUNIT_TEST(testChunkedDecode);
+  CPPUNIT_TEST(testPackedDecode);
+  CPPUNIT_TEST(testShortBreak);
+  CPPUNIT_TEST(testMarkTimeout);
+  CPPUNIT_TEST(testFlush);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void testFindEndOfRun();
+  void testFindLevelChange();
+  void testDecode();
+  void testChunkedDecode();
+  void testPackedDecode();
+  void testShortBreak();
+  void testMarkTimeout();
+  void testFlush();
+
+  void setUp() {
+    ola::InitLogging(ola::OLA_LOG_INFO, ola::OLA_LOG_STDERR);
+    m_frames.clear();
+  }
+
+ private:
+  vector<vector<uint8_t> > m_frames;
+
+  SignalDecoder::FrameCallback *NewFrameCallback() {
+    return ola::NewCallback(this, &SignalDecoderTest::FrameReceived);
+  }
+
+  void FrameReceived(const uint8_t *data, unsigned int length) {
+    m_frames.push_back(vector<uint8_t>(data, data + length));
+  }
+
+  void BuildTwoFrames(SignalBuilder *builder);
+  void CheckTwoFrames();
+};
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(SignalDecoderTest);
+
+namespace {
+const uint8_t DMX_FRAME[] = {0x00, 0x00, 0xff, 0x55, 0x80, 0x01};
+const uint8_t RDM_FRAME[] = {0xcc, 0x01, 0x18, 0xaa};
+}  // namespace
+
+
+/**
+ * Add a DMX frame and an RDM frame, followed by a break to end the last one.
+ */
+void SignalDecoderTest::BuildTwoFrames(SignalBuilder *builder) {
+  builder->Add(true, 200);
+  builder->AddFrame(DMX_FRAME, sizeof(DMX_FRAME));
+  builder->Add(true, 20);
+  builder->AddFrame(RDM_FRAME, sizeof(RDM_FRAME), 176);
+  builder->Add(true, 100);
+  builder->Add(false, 100);
+  builder->Add(true, 20);
+}
+
+
+void SignalDecoderTest::CheckTwoFrames() {
+  OLA_ASSERT_EQ(static_cast<size_t>(2), m_frames.size());
+  OLA_ASSERT_DATA_EQUALS(DMX_FRAME, sizeof(DMX_FRAME),
+                         &m_frames[0][0], m_frames[0].size());
+  OLA_ASSERT_DATA_EQUALS(RDM_FRAME, sizeof(RDM_FRAME),
+                         &m_frames[1][0], m_frames[1].size());
+}
+
+
+/**
+ * Check FindEndOfRun.
+ */
+void SignalDecoderTest::testFindEndOfRun() {
+  uint8_t data[40];
+  memset(data, 0xff, sizeof(data));
+  OLA_ASSERT_EQ(40u, FindEndOfRun(data, sizeof(data), 0xff));
+  OLA_ASSERT_EQ(0u, FindEndOfRun(data, sizeof(data), 0x00));
+  OLA_ASSERT_EQ(0u, FindEndOfRun(data, 0, 0xff));
+
+  for (unsigned int i = 0; i < sizeof(data); i++) {
+    data[i] = 0xfe;
+    OLA_ASSERT_EQ(i, FindEndOfRun(data, sizeof(data), 0xff));
+    // Check the scan doesn't read past the end.
+    OLA_ASSERT_EQ(i, FindEndOfRun(data, i, 0xff));
+    data[i] = 0xff;
+  }
+}
+
+
+/**
+ * Check FindLevelChange.
+ */
+void SignalDecoderTest::testFindLevelChange() {
+  uint8_t samples[40];
+  memset(samples, 0x03, sizeof(samples));
+  OLA_ASSERT_EQ(40u, FindLevelChange(samples, sizeof(samples), 0x01, true));
+  OLA_ASSERT_EQ(0u, FindLevelChange(samples, sizeof(samples), 0x01, false));
+  OLA_ASSERT_EQ(0u, FindLevelChange(samples, sizeof(samples), 0x04, true));
+
+  for (unsigned int i = 0; i < sizeof(samples); i++) {
+    // Bit 1 changes, but the signal is on bit 0
+    samples[i] = 0x01;
+    OLA_ASSERT_EQ(40u, FindLevelChange(samples, sizeof(samples), 0x01, true));
+    samples[i] = 0x02;
+    OLA_ASSERT_EQ(i, FindLevelChange(samples, sizeof(samples), 0x01, true));
+    OLA_ASSERT_EQ(i, FindLevelChange(samples, i, 0x01, true));
+    samples[i] = 0x03;
+  }
+
+  memset(samples, 0x00, sizeof(samples));
+  for (unsigned int i = 0; i < sizeof(samples); i++) {
+    samples[i] = 0x80;
+    OLA_ASSERT_EQ(i, FindLevelChange(samples, sizeof(samples), 0x81, false));
+    OLA_ASSERT_EQ(40u, FindLevelChange(samples, sizeof(samples), 0x01,
+                                       false));
+    samples[i] = 0x00;
+  }
+}
+
+
+/**
+ * Check that frames are decoded.
+ */
+void SignalDecoderTest::testDecode() {
+  SignalBuilder builder(4000000);
+  BuildTwoFrames(&builder);
+
+  SignalDecoder decoder(NewFrameCallback(), 4000000);
+  const vector<uint8_t> &samples = builder.Samples();
+  decoder.Process(&samples[0], samples.size(), 0x01);
+  CheckTwoFrames();
+
+  // Flush with nothing pending doesn't produce a frame.
+  decoder.Flush();
+  OLA_ASSERT_EQ(static_cast<size_t>(2), m_frames.size());
+}
+
+
+/**
+ * Check that frames split across calls to Process are decoded.
+ */
+void SignalDecoderTest::testChunkedDecode() {
+  SignalBuilder builder(4000000);
+  BuildTwoFrames(&builder);
+  const vector<uint8_t> &samples = builder.Samples();
+
+  const unsigned int chunk_sizes[] = {1, 7, 9, 64};
+  for (unsigned int i = 0; i < sizeof(chunk_sizes) / sizeof(unsigned int);
+       i++) {
+    m_frames.clear();
+    SignalDecoder decoder(NewFrameCallback(), 4000000);
+    for (unsigned int offset = 0; offset < samples.size();
+         offset += chunk_sizes[i]) {
+      unsigned int size = std::min(chunk_sizes[i],
+          static_cast<unsigned int>(samples.size()) - offset);
+      decoder.Process(&samples[offset], size, 0x01);
+    }
+    CheckTwoFrames();
+  }
+}
+
+
+/**
+ * Check that packed samples are decoded.
+ */
+void SignalDecoderTest::testPackedDecode() {
+  SignalBuilder builder(2000000);
+  BuildTwoFrames(&builder);
+  vector<uint8_t> packed = builder.Packed();
+
+  SignalDecoder decoder(NewFrameCallback(), 2000000);
+  decoder.ProcessPacked(&packed[0], packed.size());
+  CheckTwoFrames();
+}
+
+
+/**
+ * Check that a break that's too short doesn't start a frame.
+ */
+void SignalDecoderTest::testShortBreak() {
+  SignalBuilder builder(4000000);
+  builder.Add(true, 200);
+  builder.AddFrame(DMX_FRAME, sizeof(DMX_FRAME), 60);
+  builder.Add(true, 100);
+
+  SignalDecoder decoder(NewFrameCallback(), 4000000);
+  const vector<uint8_t> &samples = builder.Samples();
+  decoder.Process(&samples[0], samples.size(), 0x01);
+  decoder.Flush();
+  OLA_ASSERT_EQ(static_cast<size_t>(0), m_frames.size());
+}
+
+
+/**
+ * Check that a long mark after the last slot ends the frame.
+ */
+void SignalDecoderTest::testMarkTimeout() {
+  SignalBuilder builder(1000000);
+  builder.Add(true, 200);
+  builder.AddFrame(DMX_FRAME, sizeof(DMX_FRAME));
+
+  SignalDecoder decoder(NewFrameCallback(), 1000000);
+  const vector<uint8_t> &samples = builder.Samples();
+  decoder.Process(&samples[0], samples.size(), 0x01);
+  OLA_ASSERT_EQ(static_cast<size_t>(0), m_frames.size());
+
+  vector<uint8_t> idle(1000000, 0x01);
+  decoder.Process(&idle[0], idle.size(), 0x01);
+  OLA_ASSERT_EQ(static_cast<size_t>(1), m_frames.size());
+  OLA_ASSERT_DATA_EQUALS(DMX_FRAME, sizeof(DMX_FRAME),
+                         &m_frames[0][0], m_frames[0].size());
+}
+
+
+/**
+ * Check that Flush() includes the last slot, when the samples end during the
+ * mark after it.
+ */
+void SignalDecoderTest::testFlush() {
+  SignalBuilder builder(2000000);
+  builder.Add(true, 200);
+  builder.AddFrame(DMX_FRAME, sizeof(DMX_FRAME));
+  builder.Add(true, 100);
+  vector<uint8_t> packed = builder.Packed();
+
+  SignalDecoder decoder(NewFrameCallback(), 2000000);
+  decoder.ProcessPacked(&packed[0], packed.size());
+  OLA_ASSERT_EQ(static_cast<size_t>(0), m_frames.size());
+  decoder.Flush();
+  OLA_ASSERT_EQ(static_cast<size_t>(1), m_frames.size());
+  OLA_ASSERT_DATA_EQUALS(DMX_FRAME, sizeof(DMX_FRAME),
+                         &m_frames[0][0], m_frames[0].size());
+
+  // The samples end with the stop bits of the last slot.
+  m_frames.clear();
+  SignalBuilder unpacked(4000000);
+  unpacked.Add(true, 200);
+  unpacked.AddFrame(DMX_FRAME, sizeof(DMX_FRAME));
+  const vector<uint8_t> &samples = unpacked.Samples();
+  SignalDecoder unpacked_decoder(NewFrameCallback(), 4000000);
+  unpacked_decoder.Process(&samples[0], samples.size(), 0x01);
+  unpacked_decoder.Flush();
+  OLA_ASSERT_EQ(static_cast<size_t>(1), m_frames.size());
+  OLA_ASSERT_DATA_EQUALS(DMX_FRAME, sizeof(DMX_FRAME),
+                         &m_frames[0][0], m_frames[0].size());
+}
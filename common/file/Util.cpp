@@ -22,11 +22,16 @@
 #include <ola/file/Util.h>
 #include <dirent.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
 #include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #ifdef _WIN32
 #define VC_EXTRALEAN
 #define WIN32_LEAN_AND_MEAN
 #include <ola/win/CleanWindows.h>
+#include <io.h>
 #endif  // _WIN32
 
 #if HAVE_CONFIG_H
@@ -196,5 +201,98 @@ string FilenameFromPathOrPath(const string &path) {
 string FilenameFromPath(const string &path) {
   return FilenameFromPathOrDefault(path, "");
 }
+
+bool WriteFileAtomically(const string &path, const string &data) {
+  const string temp_path = path + ".tmp";
+#ifdef _WIN32
+  int fd = open(temp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_BINARY,
+                _S_IREAD | _S_IWRITE);
+#else
+  int fd = open(temp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC,
+                S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+#endif  // _WIN32
+  if (fd < 0) {
+    OLA_WARN << "Could not open " << temp_path << ": " << strerror(errno);
+    return false;
+  }
+
+  const char *ptr = data.data();
+  size_t remaining = data.size();
+  while (remaining) {
+    ssize_t written = write(fd, ptr, remaining);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      OLA_WARN << "Failed to write " << temp_path << ": " << strerror(errno);
+      close(fd);
+      unlink(temp_path.c_str());
+      return false;
+    }
+    ptr += written;
+    remaining -= written;
+  }
+
+#ifdef _WIN32
+  bool synced = _commit(fd) == 0;
+#else
+  bool synced = fsync(fd) == 0;
+#endif  // _WIN32
+  if (!synced) {
+    OLA_WARN << "Failed to sync " << temp_path << ": " << strerror(errno);
+  }
+
+  if (close(fd) != 0 || !synced) {
+    unlink(temp_path.c_str());
+    return false;
+  }
+
+#ifdef _WIN32
+  if (!MoveFileEx(temp_path.c_str(), path.c_str(),
+                  MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+    OLA_WARN << "Failed to rename " << temp_path << " to " << path;
+    unlink(temp_path.c_str());
+    return false;
+  }
+#else
+  if (rename(temp_path.c_str(), path.c_str()) != 0) {
+    OLA_WARN << "Failed to rename " << temp_path << " to " << path << ": "
+             << strerror(errno);
+    unlink(temp_path.c_str());
+    return false;
+  }
+#endif  // _WIN32
+  return true;
+}
+
+bool ReadFile(const string &path, string *data) {
+#ifdef _WIN32
+  int fd = open(path.c_str(), O_RDONLY | O_BINARY);
+#else
+  int fd = open(path.c_str(), O_RDONLY);
+#endif  // _WIN32
+  if (fd < 0) {
+    return false;
+  }
+
+  data->clear();
+  char buffer[4096];
+  while (true) {
+    ssize_t bytes_read = read(fd, buffer, sizeof(buffer));
+    if (bytes_read < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      OLA_WARN << "Failed to read " << path << ": " << strerror(errno);
+      close(fd);
+      return false;
+    } else if (bytes_read == 0) {
+      break;
+    }
+    data->append(buffer, bytes_read);
+  }
+  close(fd);
+  return true;
+}
 }  // namespace file
 }  // namespace ola
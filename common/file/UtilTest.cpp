@@ -19,6 +19,7 @@
  */
 
 #include <cppunit/extensions/HelperMacros.h>
+#include <unistd.h>
 #include <string>
 #include <iterator>
 #include <vector>
@@ -32,6 +33,8 @@ using ola::file::FilenameFromPathOrDefault;
 using ola::file::FilenameFromPathOrPath;
 using ola::file::JoinPaths;
 using ola::file::FindMatchingFiles;
+using ola::file::ReadFile;
+using ola::file::WriteFileAtomically;
 using std::string;
 
 class UtilTest: public CppUnit::TestFixture {
@@ -39,12 +42,14 @@ class UtilTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testJoinPaths);
   CPPUNIT_TEST(testFilenameFromPath);
   CPPUNIT_TEST(testFindMatchingFiles);
+  CPPUNIT_TEST(testWriteFileAtomically);
   CPPUNIT_TEST_SUITE_END();
 
  public:
   void testFilenameFromPath();
   void testJoinPaths();
   void testFindMatchingFiles();
+  void testWriteFileAtomically();
 };
 
 
@@ -149,3 +154,28 @@ void UtilTest::testFindMatchingFiles() {
   OLA_ASSERT_TRUE_MSG(rdm_test_server_found,
                       "Result lacks rdm_test_server.py.1");
 }
+
+/*
+ * Test the WriteFileAtomically and ReadFile functions
+ */
+void UtilTest::testWriteFileAtomically() {
+  const string path = JoinPaths(TEST_BUILD_DIR, "UtilTest.atomic");
+  const string data1("first contents\0with a nul", 25);
+  const string data2("second");
+
+  OLA_ASSERT_TRUE(WriteFileAtomically(path, data1));
+  string contents;
+  OLA_ASSERT_TRUE(ReadFile(path, &contents));
+  OLA_ASSERT_EQ(data1, contents);
+
+  // Replacing the file leaves no trace of the old contents.
+  OLA_ASSERT_TRUE(WriteFileAtomically(path, data2));
+  OLA_ASSERT_TRUE(ReadFile(path, &contents));
+  OLA_ASSERT_EQ(data2, contents);
+
+  // The temporary file is renamed over the destination.
+  OLA_ASSERT_FALSE(ReadFile(path + ".tmp", &contents));
+  unlink(path.c_str());
+
+  OLA_ASSERT_FALSE(ReadFile(path, &contents));
+}
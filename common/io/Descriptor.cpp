@@ -490,6 +490,53 @@ int ConnectedDescriptor::Receive(
   return 0;
 }
 
+int ConnectedDescriptor::Receive(
+    IOQueue *queue,
+    unsigned int size,
+    unsigned int &data_read) {  // NOLINT(runtime/references)
+  data_read = 0;
+  if (!ValidReadDescriptor())
+    return -1;
+
+  int iocnt;
+  const struct IOVec *iov = queue->Reserve(size, &iocnt);
+  int ret = 0;
+
+#ifdef _WIN32
+  /* There is no scatter/gather functionality for generic descriptors on
+   * Windows, so read into each block in turn.
+   */
+  for (int io = 0; io < iocnt; ++io) {
+    unsigned int block_read = 0;
+    ret = Receive(reinterpret_cast<uint8_t*>(iov[io].iov_base),
+                  iov[io].iov_len, block_read);
+    data_read += block_read;
+    if (ret < 0 || block_read != iov[io].iov_len) {
+      break;
+    }
+  }
+#else
+  ssize_t bytes_read;
+  do {
+    bytes_read = readv(ReadDescriptor(),
+                       reinterpret_cast<const struct iovec*>(iov), iocnt);
+  } while (bytes_read < 0 && errno == EINTR);
+
+  if (bytes_read < 0) {
+    if (errno != EAGAIN) {
+      OLA_WARN << "readv failed, " << strerror(errno);
+      ret = -1;
+    }
+  } else {
+    data_read = bytes_read;
+  }
+#endif  // _WIN32
+
+  IOQueue::FreeIOVec(iov);
+  queue->CommitReserved(data_read);
+  return ret;
+}
+
 bool ConnectedDescriptor::IsClosed() const {
   return DataRemaining() == 0;
 }
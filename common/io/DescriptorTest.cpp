@@ -30,13 +30,17 @@
 #include "ola/Callback.h"
 #include "ola/Logging.h"
 #include "ola/io/Descriptor.h"
+#include "ola/io/IOQueue.h"
+#include "ola/io/MemoryBlockPool.h"
 #include "ola/io/SelectServer.h"
 #include "ola/testing/TestUtils.h"
 
 
 using std::string;
 using ola::io::ConnectedDescriptor;
+using ola::io::IOQueue;
 using ola::io::LoopbackDescriptor;
+using ola::io::MemoryBlockPool;
 using ola::io::PipeDescriptor;
 #ifndef _WIN32
 using ola::io::UnixSocket;
@@ -51,6 +55,7 @@ class DescriptorTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(DescriptorTest);
 
   CPPUNIT_TEST(testLoopbackDescriptor);
+  CPPUNIT_TEST(testReceiveToIOQueue);
   CPPUNIT_TEST(testPipeDescriptorClientClose);
   CPPUNIT_TEST(testPipeDescriptorServerClose);
 #ifndef _WIN32
@@ -63,6 +68,7 @@ class DescriptorTest: public CppUnit::TestFixture {
     void setUp();
     void tearDown();
     void testLoopbackDescriptor();
+    void testReceiveToIOQueue();
     void testPipeDescriptorClientClose();
     void testPipeDescriptorServerClose();
 #ifndef _WIN32
@@ -150,6 +156,44 @@ void DescriptorTest::testLoopbackDescriptor() {
 }
 
 
+/*
+ * Test reading into an IOQueue.
+ */
+void DescriptorTest::testReceiveToIOQueue() {
+  LoopbackDescriptor socket;
+  OLA_ASSERT_TRUE(socket.Init());
+
+  // Use small blocks so the data spans several of them.
+  MemoryBlockPool pool(4);
+  IOQueue queue(&pool);
+  queue.Write(test_cstring, 2);
+
+  uint8_t data[10];
+  for (unsigned int i = 0; i < sizeof(data); i++) {
+    data[i] = i;
+  }
+  OLA_ASSERT_EQ(static_cast<ssize_t>(sizeof(data)),
+                socket.Send(data, sizeof(data)));
+
+  unsigned int data_read;
+  OLA_ASSERT_EQ(0, socket.Receive(&queue, 100, data_read));
+  OLA_ASSERT_EQ(static_cast<unsigned int>(sizeof(data)), data_read);
+  OLA_ASSERT_EQ(12u, queue.Size());
+
+  uint8_t output[12];
+  OLA_ASSERT_EQ(12u, queue.Read(output, sizeof(output)));
+  OLA_ASSERT_DATA_EQUALS(test_cstring, 2, output, 2);
+  OLA_ASSERT_DATA_EQUALS(data, sizeof(data), output + 2, sizeof(data));
+  OLA_ASSERT_TRUE(queue.Empty());
+
+  // Nothing left to read, the unused blocks are returned to the pool.
+  OLA_ASSERT_EQ(0, socket.Receive(&queue, 100, data_read));
+  OLA_ASSERT_EQ(0u, data_read);
+  OLA_ASSERT_TRUE(queue.Empty());
+  OLA_ASSERT_EQ(pool.BlocksAllocated(), pool.FreeBlocks());
+}
+
+
 /*
  * Test a pipe socket works correctly.
  * The client sends some data and expects the same data to be returned. The
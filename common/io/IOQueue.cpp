@@ -41,13 +41,15 @@ using std::string;
  */
 IOQueue::IOQueue()
     : m_pool(new MemoryBlockPool()),
-      m_delete_pool(true) {
+      m_delete_pool(true),
+      m_reserved_index(0) {
 }
 
 
 IOQueue::IOQueue(MemoryBlockPool *block_pool)
     : m_pool(block_pool),
-      m_delete_pool(false) {
+      m_delete_pool(false),
+      m_reserved_index(0) {
 }
 
 /**
@@ -205,6 +207,73 @@ const struct IOVec *IOQueue::AsIOVec(int *iocnt) const {
 }
 
 
+IOQueueView IOQueue::View(unsigned int offset, unsigned int length) const {
+  return View().SubView(offset, length);
+}
+
+
+IOQueueView IOQueue::View() const {
+  if (m_blocks.empty()) {
+    return IOQueueView();
+  }
+  return IOQueueView(this, 0, 0, Size());
+}
+
+
+/**
+ * Reserve space at the end of the queue. The free space in the last block is
+ * used first, then new blocks are added until there is at least size bytes.
+ */
+const struct IOVec *IOQueue::Reserve(unsigned int size, int *io_count) {
+  unsigned int available = 0;
+  m_reserved_index = m_blocks.size();
+  if (!m_blocks.empty() && m_blocks.back()->Remaining()) {
+    m_reserved_index--;
+    available = m_blocks.back()->Remaining();
+  }
+
+  while (available < size) {
+    MemoryBlock *block = m_pool->Allocate();
+    if (!block) {
+      OLA_FATAL << "Failed to allocate block, we're out of memory!";
+      break;
+    }
+    m_blocks.push_back(block);
+    available += block->Remaining();
+  }
+
+  int block_count = m_blocks.size() - m_reserved_index;
+  if (block_count == 0) {
+    *io_count = 0;
+    return NULL;
+  }
+
+  struct IOVec *vector = new struct IOVec[block_count];
+  for (int i = 0; i < block_count; i++) {
+    MemoryBlock *block = m_blocks[m_reserved_index + i];
+    vector[i].iov_base = block->Tail();
+    vector[i].iov_len = block->Remaining();
+  }
+  *io_count = block_count;
+  return vector;
+}
+
+
+void IOQueue::CommitReserved(unsigned int length) {
+  unsigned int bytes_remaining = length;
+  for (unsigned int i = m_reserved_index;
+       i < m_blocks.size() && bytes_remaining; i++) {
+    bytes_remaining -= m_blocks[i]->Extend(bytes_remaining);
+  }
+
+  // Return the unused blocks to the pool.
+  while (!m_blocks.empty() && m_blocks.back()->Empty()) {
+    m_pool->Release(m_blocks.back());
+    m_blocks.pop_back();
+  }
+}
+
+
 /**
  * Append an MemoryBlock to this queue. This may leave a hole in the last block
  * before this method was called, but that's unavoidable without copying (which
@@ -228,8 +297,11 @@ void IOQueue::AppendMove(IOQueue *other) {
  */
 void IOQueue::Clear() {
   BlockVector::iterator iter = m_blocks.begin();
-  for (; iter != m_blocks.end(); ++iter)
+  for (; iter != m_blocks.end(); ++iter) {
+    // Reset the block so it's empty when it's next allocated.
+    (*iter)->PopFront((*iter)->Size());
     m_pool->Release(*iter);
+  }
   m_blocks.clear();
 }
 
@@ -260,5 +332,93 @@ void IOQueue::AppendBlock() {
   }
   m_blocks.push_back(block);
 }
+
+
+const uint8_t *IOQueueView::Contiguous() const {
+  if (!m_size) {
+    return NULL;
+  }
+  const MemoryBlock *block = m_queue->m_blocks[m_block_index];
+  if (m_offset + m_size > block->Size()) {
+    return NULL;
+  }
+  return block->Data() + m_offset;
+}
+
+
+unsigned int IOQueueView::Peek(uint8_t *data, unsigned int length) const {
+  unsigned int bytes_read = 0;
+  length = min(length, m_size);
+  unsigned int offset = m_offset;
+  for (unsigned int i = m_block_index; bytes_read != length; i++) {
+    const MemoryBlock *block = m_queue->m_blocks[i];
+    unsigned int bytes_to_copy = min(block->Size() - offset,
+                                     length - bytes_read);
+    memcpy(data + bytes_read, block->Data() + offset, bytes_to_copy);
+    bytes_read += bytes_to_copy;
+    offset = 0;
+  }
+  return bytes_read;
+}
+
+
+const struct IOVec *IOQueueView::AsIOVec(int *io_count) const {
+  if (!m_size) {
+    *io_count = 0;
+    return NULL;
+  }
+
+  // Find how many blocks the view covers.
+  unsigned int block_count = 0;
+  unsigned int bytes_covered = 0;
+  unsigned int offset = m_offset;
+  for (unsigned int i = m_block_index; bytes_covered < m_size; i++) {
+    bytes_covered += m_queue->m_blocks[i]->Size() - offset;
+    offset = 0;
+    block_count++;
+  }
+
+  struct IOVec *vector = new struct IOVec[block_count];
+  unsigned int bytes_remaining = m_size;
+  offset = m_offset;
+  for (unsigned int i = 0; i < block_count; i++) {
+    const MemoryBlock *block = m_queue->m_blocks[m_block_index + i];
+    vector[i].iov_base = block->Data() + offset;
+    vector[i].iov_len = min(block->Size() - offset, bytes_remaining);
+    bytes_remaining -= vector[i].iov_len;
+    offset = 0;
+  }
+  *io_count = block_count;
+  return vector;
+}
+
+
+IOQueueView IOQueueView::SubView(unsigned int offset,
+                                 unsigned int length) const {
+  if (offset >= m_size) {
+    return IOQueueView();
+  }
+  IOQueueView view(*this);
+  view.Advance(offset);
+  view.m_size = min(length, view.m_size);
+  return view;
+}
+
+
+void IOQueueView::Advance(unsigned int length) {
+  length = min(length, m_size);
+  m_size -= length;
+  if (!m_size) {
+    *this = IOQueueView();
+    return;
+  }
+
+  // Skip over any blocks that are now before the start of the view.
+  m_offset += length;
+  while (m_offset >= m_queue->m_blocks[m_block_index]->Size()) {
+    m_offset -= m_queue->m_blocks[m_block_index]->Size();
+    m_block_index++;
+  }
+}
 }  // namespace io
 }  // namespace ola
@@ -19,6 +19,7 @@
  */
 
 #include <cppunit/extensions/HelperMacros.h>
+#include <string.h>
 #include <memory>
 #include <iostream>
 #include <string>
@@ -45,6 +46,8 @@ class IOQueueTest: public CppUnit::TestFixture {
     CPPUNIT_TEST(testIOVec);
     CPPUNIT_TEST(testDump);
     CPPUNIT_TEST(testStringRead);
+    CPPUNIT_TEST(testView);
+    CPPUNIT_TEST(testReserve);
     CPPUNIT_TEST_SUITE_END();
 
  public:
@@ -57,6 +60,8 @@ class IOQueueTest: public CppUnit::TestFixture {
     void testIOVec();
     void testDump();
     void testStringRead();
+    void testView();
+    void testReserve();
 
  private:
     auto_ptr<IOQueue> m_buffer;
@@ -339,3 +344,119 @@ void IOQueueTest::testStringRead() {
   OLA_ASSERT_EQ(9u, queue.Read(&output, 9u));
   OLA_ASSERT_EQ(string("abcd1234 "), output);
 }
+
+
+/**
+ * Test views of the data in the queue.
+ */
+void IOQueueTest::testView() {
+  MemoryBlockPool pool(4);
+  IOQueue queue(&pool);
+  OLA_ASSERT_TRUE(queue.View().Empty());
+  OLA_ASSERT_NULL(queue.View().Contiguous());
+
+  uint8_t data1[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+  queue.Write(data1, sizeof(data1));
+  // Move the start of the data away from the block boundary.
+  queue.Pop(1);
+
+  ola::io::IOQueueView view = queue.View();
+  OLA_ASSERT_EQ(9u, view.Size());
+
+  uint8_t output[10];
+  OLA_ASSERT_EQ(9u, view.Peek(output, sizeof(output)));
+  OLA_ASSERT_DATA_EQUALS(data1 + 1, 9, output, 9u);
+  // The view spans three blocks.
+  OLA_ASSERT_NULL(view.Contiguous());
+
+  int iocnt;
+  const struct IOVec *vector = view.AsIOVec(&iocnt);
+  OLA_ASSERT_EQ(3, iocnt);
+  OLA_ASSERT_EQ(9u, SumLengthOfIOVec(vector, iocnt));
+  IOQueue::FreeIOVec(vector);
+
+  // A view within the second block points at the queue's memory.
+  ola::io::IOQueueView sub_view = queue.View(3, 4);
+  OLA_ASSERT_EQ(4u, sub_view.Size());
+  const uint8_t *contiguous = sub_view.Contiguous();
+  OLA_ASSERT_NOT_NULL(contiguous);
+  OLA_ASSERT_DATA_EQUALS(data1 + 4, 4, contiguous, 4u);
+
+  // One that crosses the boundary doesn't.
+  sub_view = queue.View(2, 4);
+  OLA_ASSERT_NULL(sub_view.Contiguous());
+  OLA_ASSERT_EQ(4u, sub_view.Peek(output, sizeof(output)));
+  OLA_ASSERT_DATA_EQUALS(data1 + 3, 4, output, 4u);
+  vector = sub_view.AsIOVec(&iocnt);
+  OLA_ASSERT_EQ(2, iocnt);
+  OLA_ASSERT_EQ(1u, static_cast<unsigned int>(vector[0].iov_len));
+  OLA_ASSERT_EQ(3u, static_cast<unsigned int>(vector[1].iov_len));
+  IOQueue::FreeIOVec(vector);
+
+  // Sub views of sub views, truncated to the end of the data.
+  sub_view = view.SubView(5, 100).SubView(1, 100);
+  OLA_ASSERT_EQ(3u, sub_view.Size());
+  OLA_ASSERT_EQ(3u, sub_view.Peek(output, sizeof(output)));
+  OLA_ASSERT_DATA_EQUALS(data1 + 7, 3, output, 3u);
+  OLA_ASSERT_TRUE(view.SubView(9, 1).Empty());
+
+  // Advance to the end of the first block.
+  view.Advance(3);
+  OLA_ASSERT_EQ(6u, view.Size());
+  OLA_ASSERT_NOT_NULL(view.SubView(0, 4).Contiguous());
+  view.Advance(100);
+  OLA_ASSERT_TRUE(view.Empty());
+
+  // Views don't change the queue.
+  OLA_ASSERT_EQ(9u, queue.Size());
+}
+
+
+/**
+ * Test writing directly into the queue.
+ */
+void IOQueueTest::testReserve() {
+  MemoryBlockPool pool(4);
+  IOQueue queue(&pool);
+  uint8_t data1[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+  queue.Write(data1, 3);
+
+  // The free space in the last block is used first.
+  int iocnt;
+  const struct IOVec *vector = queue.Reserve(6, &iocnt);
+  OLA_ASSERT_EQ(3, iocnt);
+  OLA_ASSERT_EQ(9u, SumLengthOfIOVec(vector, iocnt));
+  OLA_ASSERT_EQ(1u, static_cast<unsigned int>(vector[0].iov_len));
+
+  // Fill the first two IOVecs, as readv() would.
+  memcpy(vector[0].iov_base, data1 + 3, 1);
+  memcpy(vector[1].iov_base, data1 + 4, 4);
+  IOQueue::FreeIOVec(vector);
+  queue.CommitReserved(5);
+  OLA_ASSERT_EQ(8u, queue.Size());
+  OLA_ASSERT_EQ(1u, pool.FreeBlocks());
+
+  uint8_t output[10];
+  OLA_ASSERT_EQ(8u, queue.Peek(output, sizeof(output)));
+  OLA_ASSERT_DATA_EQUALS(data1, 8, output, 8u);
+
+  // Reserve without writing anything.
+  vector = queue.Reserve(3, &iocnt);
+  OLA_ASSERT_EQ(1, iocnt);
+  IOQueue::FreeIOVec(vector);
+  queue.CommitReserved(0);
+  OLA_ASSERT_EQ(8u, queue.Size());
+  OLA_ASSERT_EQ(1u, pool.FreeBlocks());
+
+  // And the same on an empty queue.
+  queue.Clear();
+  vector = queue.Reserve(1, &iocnt);
+  IOQueue::FreeIOVec(vector);
+  queue.CommitReserved(0);
+  OLA_ASSERT_TRUE(queue.Empty());
+  OLA_ASSERT_EQ(pool.BlocksAllocated(), pool.FreeBlocks());
+
+  // Cleared blocks are reused empty.
+  queue.Write(data1, 4);
+  OLA_ASSERT_EQ(4u, queue.Size());
+}
@@ -7,11 +7,14 @@ common_libolacommon_la_SOURCES += \
     common/io/IOQueue.cpp \
     common/io/IOStack.cpp \
     common/io/IOUtils.cpp \
+    common/io/MemoryBlockPool.cpp \
     common/io/NonBlockingSender.cpp \
     common/io/PollerInterface.cpp \
     common/io/PollerInterface.h \
     common/io/SelectServer.cpp \
     common/io/Serial.cpp \
+    common/io/SerialFrameWriter.cpp \
+    common/io/SerialFrameWriter.h \
     common/io/StdinHandler.cpp \
     common/io/TimeoutManager.cpp \
     common/io/TimeoutManager.h
@@ -38,6 +41,13 @@ common_libolacommon_la_SOURCES += \
     common/io/KQueuePoller.cpp
 endif
 
+# PROGRAMS
+##################################################
+noinst_PROGRAMS += common/io/ioqueue_benchmark
+
+common_io_ioqueue_benchmark_SOURCES = common/io/ioqueue_benchmark.cpp
+common_io_ioqueue_benchmark_LDADD = common/libolacommon.la
+
 # TESTS
 ##################################################
 test_programs += \
@@ -46,6 +56,7 @@ test_programs += \
     common/io/IOStackTester \
     common/io/MemoryBlockTester \
     common/io/SelectServerTester \
+    common/io/SerialFrameWriterTester \
     common/io/StreamTester \
     common/io/TimeoutManagerTester
 
@@ -61,7 +72,8 @@ common_io_DescriptorTester_SOURCES = common/io/DescriptorTest.cpp
 common_io_DescriptorTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 common_io_DescriptorTester_LDADD = $(COMMON_TESTING_LIBS)
 
-common_io_MemoryBlockTester_SOURCES = common/io/MemoryBlockTest.cpp
+common_io_MemoryBlockTester_SOURCES = common/io/MemoryBlockPoolTest.cpp \
+                                      common/io/MemoryBlockTest.cpp
 common_io_MemoryBlockTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 common_io_MemoryBlockTester_LDADD = $(COMMON_TESTING_LIBS)
 
@@ -70,6 +82,11 @@ common_io_SelectServerTester_SOURCES = common/io/SelectServerTest.cpp \
 common_io_SelectServerTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 common_io_SelectServerTester_LDADD = $(COMMON_TESTING_LIBS)
 
+common_io_SerialFrameWriterTester_SOURCES = \
+    common/io/SerialFrameWriterTest.cpp
+common_io_SerialFrameWriterTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
+common_io_SerialFrameWriterTester_LDADD = $(COMMON_TESTING_LIBS)
+
 common_io_TimeoutManagerTester_SOURCES = common/io/TimeoutManagerTest.cpp
 common_io_TimeoutManagerTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 common_io_TimeoutManagerTester_LDADD = $(COMMON_TESTING_LIBS)
@@ -0,0 +1,165 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * MemoryBlockPool.cpp
+ * Allocates and Releases MemoryBlocks.
+ * Copyright (C) 2026 agent
+ */
+
+#include <ola/Logging.h>
+#include <ola/io/MemoryBlockPool.h>
+#include <pthread.h>
+#include <algorithm>
+#include <new>
+#include <vector>
+
+namespace ola {
+namespace io {
+
+using std::vector;
+
+namespace {
+
+pthread_key_t pool_key;
+pthread_once_t pool_key_once = PTHREAD_ONCE_INIT;
+
+void DeleteThreadLocalPool(void *pool) {
+  delete static_cast<MemoryBlockPool*>(pool);
+}
+
+void CreatePoolKey() {
+  pthread_key_create(&pool_key, DeleteThreadLocalPool);
+}
+
+unsigned int next_pool_id = 0;
+
+unsigned int NewPoolId() {
+#ifdef __ATOMIC_RELAXED
+  return __atomic_add_fetch(&next_pool_id, 1, __ATOMIC_RELAXED);
+#else
+  return __sync_add_and_fetch(&next_pool_id, 1);
+#endif  // __ATOMIC_RELAXED
+}
+}  // namespace
+
+void MemorySlab::Ref() {
+#ifdef __ATOMIC_RELAXED
+  __atomic_add_fetch(&m_references, 1, __ATOMIC_RELAXED);
+#else
+  __sync_add_and_fetch(&m_references, 1);
+#endif  // __ATOMIC_RELAXED
+}
+
+void MemorySlab::Unref() {
+  // The release / acquire pair makes sure all writes to the slab happen
+  // before it's freed.
+#ifdef __ATOMIC_ACQ_REL
+  unsigned int references = __atomic_sub_fetch(&m_references, 1,
+                                                __ATOMIC_ACQ_REL);
+#else
+  unsigned int references = __sync_sub_and_fetch(&m_references, 1);
+#endif  // __ATOMIC_ACQ_REL
+  if (references == 0) {
+    delete this;
+  }
+}
+
+MemoryBlockPool::MemoryBlockPool(unsigned int block_size)
+    : m_id(NewPoolId()),
+      m_slab(NULL),
+      m_slab_offset(0),
+      m_block_size(block_size),
+      m_blocks_allocated(0) {
+}
+
+MemoryBlockPool::~MemoryBlockPool() {
+  Purge();
+  if (m_slab) {
+    m_slab->Unref();
+  }
+}
+
+MemoryBlock *MemoryBlockPool::Allocate() {
+  if (!m_free_blocks.empty()) {
+    MemoryBlock *block = m_free_blocks.back();
+    m_free_blocks.pop_back();
+    return block;
+  }
+
+  if (!m_slab && !NewSlab()) {
+    return NULL;
+  }
+
+  MemoryBlock *block = new MemoryBlock(m_slab, m_slab_offset, m_block_size);
+  m_slab_offset += m_block_size;
+  m_blocks_allocated++;
+  if (m_slab_offset == m_slab->Size()) {
+    // The blocks now hold the only references to the slab.
+    m_slab->Unref();
+    m_slab = NULL;
+  }
+  return block;
+}
+
+void MemoryBlockPool::Purge(unsigned int remaining) {
+  if (m_free_blocks.size() <= remaining) {
+    return;
+  }
+
+  // The front of the vector holds the least recently released blocks.
+  vector<MemoryBlock*>::iterator end = m_free_blocks.end() - remaining;
+  vector<MemoryBlock*>::iterator iter = m_free_blocks.begin();
+  for (; iter != end; ++iter) {
+    if (Owns(*iter)) {
+      m_blocks_allocated--;
+    }
+    delete *iter;
+  }
+  m_free_blocks.erase(m_free_blocks.begin(), end);
+}
+
+MemoryBlockPool *MemoryBlockPool::ThreadLocalPool() {
+  pthread_once(&pool_key_once, CreatePoolKey);
+  MemoryBlockPool *pool = static_cast<MemoryBlockPool*>(
+      pthread_getspecific(pool_key));
+  if (!pool) {
+    pool = new MemoryBlockPool();
+    pthread_setspecific(pool_key, pool);
+  }
+  return pool;
+}
+
+bool MemoryBlockPool::NewSlab() {
+  unsigned int block_count = std::max(m_blocks_allocated, 1u);
+  if (block_count > MAX_SLAB_BLOCKS) {
+    block_count = MAX_SLAB_BLOCKS;
+  }
+  const unsigned int size = block_count * m_block_size;
+  uint8_t *data = new(std::nothrow) uint8_t[size];
+  if (!data) {
+    return false;
+  }
+  OLA_DEBUG << "new slab of " << block_count << " blocks allocated at @"
+            << reinterpret_cast<int*>(data);
+  m_slab = new MemorySlab(data, size, m_id);
+  m_slab_offset = 0;
+  return true;
+}
+
+bool MemoryBlockPool::Owns(const MemoryBlock *block) const {
+  return block->Slab() && block->Slab()->Owner() == m_id;
+}
+}  // namespace io
+}  // namespace ola
@@ -0,0 +1,273 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * MemoryBlockPoolTest.cpp
+ * Test fixture for the MemoryBlockPool class.
+ * Copyright (C) 2026 agent
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <vector>
+
+#include "ola/Logging.h"
+#include "ola/io/MemoryBlock.h"
+#include "ola/io/MemoryBlockPool.h"
+#include "ola/testing/TestUtils.h"
+#include "ola/thread/Thread.h"
+
+using ola::io::MemoryBlock;
+using ola::io::MemoryBlockPool;
+using std::vector;
+
+class MemoryBlockPoolTest: public CppUnit::TestFixture {
+ public:
+  CPPUNIT_TEST_SUITE(MemoryBlockPoolTest);
+  CPPUNIT_TEST(testAllocate);
+  CPPUNIT_TEST(testSlabs);
+  CPPUNIT_TEST(testPurge);
+  CPPUNIT_TEST(testBlocksOutlivePool);
+  CPPUNIT_TEST(testCrossPoolRelease);
+  CPPUNIT_TEST(testThreadLocalPool);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void testAllocate();
+  void testSlabs();
+  void testPurge();
+  void testBlocksOutlivePool();
+  void testCrossPoolRelease();
+  void testThreadLocalPool();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(MemoryBlockPoolTest);
+
+namespace {
+
+/*
+ * Records the pool for the thread it runs in.
+ */
+class PoolThread: public ola::thread::Thread {
+ public:
+  PoolThread() : m_pool(NULL) {}
+
+  void *Run() {
+    m_pool = MemoryBlockPool::ThreadLocalPool();
+    // Check the pool works, this block is deleted when the thread exits.
+    m_pool->Release(m_pool->Allocate());
+    return NULL;
+  }
+
+  const MemoryBlockPool *Pool() const { return m_pool; }
+
+ private:
+  MemoryBlockPool *m_pool;
+};
+
+/*
+ * Allocates a block from the pool for the thread it runs in.
+ */
+class AllocatingThread: public ola::thread::Thread {
+ public:
+  AllocatingThread() : m_block(NULL) {}
+
+  void *Run() {
+    m_block = MemoryBlockPool::ThreadLocalPool()->Allocate();
+    return NULL;
+  }
+
+  MemoryBlock *Block() const { return m_block; }
+
+ private:
+  MemoryBlock *m_block;
+};
+}  // namespace
+
+
+/*
+ * Check that allocating and releasing blocks works.
+ */
+void MemoryBlockPoolTest::testAllocate() {
+  MemoryBlockPool pool(16);
+  OLA_ASSERT_EQ(16u, pool.BlockSize());
+  OLA_ASSERT_EQ(0u, pool.BlocksAllocated());
+  OLA_ASSERT_EQ(0u, pool.FreeBlocks());
+
+  MemoryBlock *block1 = pool.Allocate();
+  MemoryBlock *block2 = pool.Allocate();
+  OLA_ASSERT_NOT_NULL(block1);
+  OLA_ASSERT_NOT_NULL(block2);
+  OLA_ASSERT_EQ(16u, block1->Capacity());
+  OLA_ASSERT_TRUE(block1->Empty());
+  OLA_ASSERT_EQ(2u, pool.BlocksAllocated());
+
+  pool.Release(block1);
+  pool.Release(block2);
+  OLA_ASSERT_EQ(2u, pool.FreeBlocks());
+
+  // The most recently released block is reused first.
+  OLA_ASSERT_EQ(block2, pool.Allocate());
+  OLA_ASSERT_EQ(block1, pool.Allocate());
+  OLA_ASSERT_EQ(0u, pool.FreeBlocks());
+  OLA_ASSERT_EQ(2u, pool.BlocksAllocated());
+
+  pool.Release(block1);
+  pool.Release(block2);
+}
+
+
+/*
+ * Check that blocks are carved from slabs which grow with the pool.
+ */
+void MemoryBlockPoolTest::testSlabs() {
+  MemoryBlockPool pool(16);
+  vector<MemoryBlock*> blocks;
+  for (unsigned int i = 0; i < 8; i++) {
+    blocks.push_back(pool.Allocate());
+  }
+
+  // The slabs hold 1, 1, 2 and 4 blocks.
+  OLA_ASSERT_EQ(blocks[2]->Data() + 16, blocks[3]->Data());
+  OLA_ASSERT_EQ(blocks[4]->Data() + 16, blocks[5]->Data());
+  OLA_ASSERT_EQ(blocks[4]->Data() + 48, blocks[7]->Data());
+
+  // Writing to a block doesn't touch its neighbours.
+  const uint8_t data[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+                          16, 17};
+  OLA_ASSERT_EQ(16u, blocks[4]->Append(data, sizeof(data)));
+  OLA_ASSERT_TRUE(blocks[5]->Empty());
+
+  vector<MemoryBlock*>::iterator iter = blocks.begin();
+  for (; iter != blocks.end(); ++iter) {
+    pool.Release(*iter);
+  }
+  OLA_ASSERT_EQ(8u, pool.FreeBlocks());
+}
+
+
+/*
+ * Check Purge.
+ */
+void MemoryBlockPoolTest::testPurge() {
+  MemoryBlockPool pool(16);
+  vector<MemoryBlock*> blocks;
+  for (unsigned int i = 0; i < 4; i++) {
+    blocks.push_back(pool.Allocate());
+  }
+  vector<MemoryBlock*>::iterator iter = blocks.begin();
+  for (; iter != blocks.end(); ++iter) {
+    pool.Release(*iter);
+  }
+
+  // The most recently released blocks are kept.
+  pool.Purge(1);
+  OLA_ASSERT_EQ(1u, pool.FreeBlocks());
+  OLA_ASSERT_EQ(1u, pool.BlocksAllocated());
+  OLA_ASSERT_EQ(blocks[3], pool.Allocate());
+
+  // Purging more than we have is a no-op.
+  pool.Purge(10);
+  OLA_ASSERT_EQ(1u, pool.BlocksAllocated());
+
+  pool.Release(blocks[3]);
+  pool.Purge();
+  OLA_ASSERT_EQ(0u, pool.FreeBlocks());
+  OLA_ASSERT_EQ(0u, pool.BlocksAllocated());
+
+  // Blocks we didn't allocate can be released and purged.
+  pool.Release(new MemoryBlock(new uint8_t[8], 8));
+  OLA_ASSERT_EQ(1u, pool.FreeBlocks());
+  pool.Purge();
+  OLA_ASSERT_EQ(0u, pool.FreeBlocks());
+  OLA_ASSERT_EQ(0u, pool.BlocksAllocated());
+}
+
+
+/*
+ * Check that blocks can outlive the pool they came from.
+ */
+void MemoryBlockPoolTest::testBlocksOutlivePool() {
+  MemoryBlockPool *pool = new MemoryBlockPool(16);
+  MemoryBlock *block1 = pool->Allocate();
+  MemoryBlock *block2 = pool->Allocate();
+  delete pool;
+
+  const uint8_t data[] = {1, 2, 3, 4};
+  OLA_ASSERT_EQ(4u, block1->Append(data, sizeof(data)));
+  OLA_ASSERT_DATA_EQUALS(data, sizeof(data), block1->Data(), block1->Size());
+
+  // Release a block to another pool.
+  MemoryBlockPool other_pool(16);
+  other_pool.Release(block2);
+  OLA_ASSERT_EQ(block2, other_pool.Allocate());
+  other_pool.Release(block2);
+  delete block1;
+}
+
+
+/*
+ * Check that purging blocks from another pool doesn't change the count.
+ */
+void MemoryBlockPoolTest::testCrossPoolRelease() {
+  MemoryBlockPool pool1(16);
+  MemoryBlockPool pool2(16);
+  MemoryBlock *block1 = pool1.Allocate();
+  MemoryBlock *block2 = pool1.Allocate();
+  MemoryBlock *block3 = pool2.Allocate();
+  OLA_ASSERT_EQ(2u, pool1.BlocksAllocated());
+  OLA_ASSERT_EQ(1u, pool2.BlocksAllocated());
+
+  pool2.Release(block1);
+  pool2.Purge();
+  OLA_ASSERT_EQ(2u, pool1.BlocksAllocated());
+  OLA_ASSERT_EQ(1u, pool2.BlocksAllocated());
+
+  // Blocks released back to their own pool are still counted.
+  pool2.Release(block3);
+  pool2.Purge();
+  OLA_ASSERT_EQ(0u, pool2.BlocksAllocated());
+  pool1.Release(block2);
+  pool1.Purge();
+  OLA_ASSERT_EQ(1u, pool1.BlocksAllocated());
+
+  // A block from another thread's pool, released to ours.
+  MemoryBlockPool *pool = MemoryBlockPool::ThreadLocalPool();
+  pool->Purge();
+  unsigned int blocks_allocated = pool->BlocksAllocated();
+  AllocatingThread thread;
+  OLA_ASSERT_TRUE(thread.Start());
+  OLA_ASSERT_TRUE(thread.Join());
+  OLA_ASSERT_NOT_NULL(thread.Block());
+  pool->Release(thread.Block());
+  pool->Purge();
+  OLA_ASSERT_EQ(blocks_allocated, pool->BlocksAllocated());
+}
+
+
+/*
+ * Check that each thread gets its own pool.
+ */
+void MemoryBlockPoolTest::testThreadLocalPool() {
+  MemoryBlockPool *pool = MemoryBlockPool::ThreadLocalPool();
+  OLA_ASSERT_NOT_NULL(pool);
+  OLA_ASSERT_EQ(pool, MemoryBlockPool::ThreadLocalPool());
+  OLA_ASSERT_EQ(static_cast<unsigned int>(MemoryBlockPool::DEFAULT_BLOCK_SIZE),
+                pool->BlockSize());
+
+  PoolThread thread;
+  OLA_ASSERT_TRUE(thread.Start());
+  OLA_ASSERT_TRUE(thread.Join());
+  OLA_ASSERT_NOT_NULL(thread.Pool());
+  OLA_ASSERT_NE(static_cast<const MemoryBlockPool*>(pool), thread.Pool());
+}
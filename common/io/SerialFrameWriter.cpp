@@ -0,0 +1,262 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * SerialFrameWriter.cpp
+ * Writes DMX frames to a serial widget without blocking.
+ * Copyright (C) 2026 agent
+ */
+
+#include "common/io/SerialFrameWriter.h"
+
+#include <errno.h>
+#include <string.h>
+
+#include <algorithm>
+
+#include "ola/Callback.h"
+#include "ola/Logging.h"
+
+namespace ola {
+namespace io {
+
+using ola::thread::INVALID_TIMEOUT;
+
+void SerialFrameEncoder::ChangedRanges(const DmxBuffer &previous,
+                                       const DmxBuffer &frame,
+                                       unsigned int max_gap,
+                                       SlotRanges *ranges) {
+  ranges->clear();
+  const uint8_t *old_data = previous.GetRaw();
+  const uint8_t *new_data = frame.GetRaw();
+  const unsigned int common_size = std::min(previous.Size(), frame.Size());
+
+  unsigned int slot = 0;
+  while (slot < frame.Size()) {
+    if (slot < common_size && old_data[slot] == new_data[slot]) {
+      slot++;
+      continue;
+    }
+
+    if (!ranges->empty()) {
+      SlotRange &last = ranges->back();
+      if (slot - (last.start + last.length) <= max_gap) {
+        last.length = slot + 1 - last.start;
+        slot++;
+        continue;
+      }
+    }
+    SlotRange range = {slot, 1};
+    ranges->push_back(range);
+    slot++;
+  }
+}
+
+
+SerialFrameWriter::SerialFrameWriter(SelectServerInterface *ss,
+                                     ConnectedDescriptor *descriptor,
+                                     SerialFrameEncoder *encoder,
+                                     const Options &options)
+    : m_ss(ss),
+      m_descriptor(descriptor),
+      m_encoder(encoder),
+      m_options(options),
+      m_full_frame_interval(
+          static_cast<int64_t>(options.full_frame_interval) * 1000),
+      m_has_pending(false),
+      m_output_offset(0),
+      m_full_frame_size(0),
+      m_write_registered(false),
+      m_pace_timeout(INVALID_TIMEOUT) {
+  m_descriptor->SetOnWritable(
+      NewCallback(this, &SerialFrameWriter::PerformWrite));
+}
+
+SerialFrameWriter::~SerialFrameWriter() {
+  if (m_write_registered) {
+    m_ss->RemoveWriteDescriptor(m_descriptor);
+  }
+  if (m_pace_timeout != INVALID_TIMEOUT) {
+    m_ss->RemoveTimeout(m_pace_timeout);
+  }
+  m_descriptor->SetOnWritable(NULL);
+}
+
+void SerialFrameWriter::SetOnError(Callback0<void> *on_error) {
+  m_on_error.reset(on_error);
+}
+
+bool SerialFrameWriter::SendDmx(const DmxBuffer &buffer) {
+  if (m_has_pending) {
+    m_stats.frames_dropped++;
+  }
+  // Copy the data, rather than sharing it, since the caller's buffer will
+  // change.
+  m_pending.Set(buffer.GetRaw(), buffer.Size());
+  m_has_pending = true;
+  return MaybeSendFrame();
+}
+
+bool SerialFrameWriter::SendCommand(const uint8_t *data,
+                                    unsigned int length) {
+  m_commands.append(data, length);
+  return MaybeSendFrame();
+}
+
+void SerialFrameWriter::Reset() {
+  m_sent.Reset();
+}
+
+unsigned int SerialFrameWriter::MaxRefreshRate() const {
+  if (!(m_options.baud_rate && m_full_frame_size)) {
+    return 0;
+  }
+  return m_options.baud_rate / (10 * m_full_frame_size);
+}
+
+TimeInterval SerialFrameWriter::TransmitTime(unsigned int baud_rate,
+                                             unsigned int bytes) {
+  if (!baud_rate) {
+    return TimeInterval();
+  }
+  // 10 bits per byte, rounded up to the next microsecond.
+  const int64_t bits = static_cast<int64_t>(bytes) * 10;
+  return TimeInterval((bits * 1000000 + baud_rate - 1) / baud_rate);
+}
+
+bool SerialFrameWriter::Busy() const {
+  return !m_output.empty() || m_pace_timeout != INVALID_TIMEOUT;
+}
+
+bool SerialFrameWriter::MaybeSendFrame() {
+  if (Busy()) {
+    return true;
+  }
+
+  if (!m_commands.empty()) {
+    m_output.swap(m_commands);
+    if (!StartWrite()) {
+      return false;
+    }
+    if (Busy()) {
+      return true;
+    }
+  }
+
+  if (!m_has_pending) {
+    return true;
+  }
+
+  TimeStamp now;
+  m_clock.CurrentMonotonicTime(&now);
+  const bool full_frame = (m_sent.Size() == 0 ||
+                           now - m_last_full_frame >= m_full_frame_interval);
+
+  m_encoder->Encode(full_frame ? DmxBuffer() : m_sent, m_pending, &m_output);
+  m_sent.Set(m_pending.GetRaw(), m_pending.Size());
+  m_has_pending = false;
+
+  if (full_frame) {
+    m_last_full_frame = now;
+    m_full_frame_size = m_output.size();
+    m_stats.full_frames++;
+  }
+
+  if (m_output.empty()) {
+    // Nothing changed.
+    return true;
+  }
+
+  m_stats.frames_sent++;
+  return StartWrite();
+}
+
+/*
+ * Start writing the output, and pace the next write if we know the baud rate.
+ */
+bool SerialFrameWriter::StartWrite() {
+  if (m_options.baud_rate) {
+    m_pace_timeout = m_ss->RegisterSingleTimeout(
+        TransmitTime(m_options.baud_rate, m_output.size()),
+        NewSingleCallback(this, &SerialFrameWriter::PaceTimeout));
+  }
+
+  if (!Write()) {
+    Failed();
+    return false;
+  }
+  return true;
+}
+
+/*
+ * Write as much of the output as the descriptor will take.
+ */
+bool SerialFrameWriter::Write() {
+  const unsigned int remaining = m_output.size() - m_output_offset;
+  ssize_t bytes_sent = m_descriptor->Send(m_output.data() + m_output_offset,
+                                          remaining);
+  if (bytes_sent < 0) {
+    if (errno != EAGAIN && errno != EWOULDBLOCK) {
+      OLA_WARN << "Failed to write DMX frame: " << strerror(errno);
+      return false;
+    }
+    bytes_sent = 0;
+  }
+
+  m_output_offset += bytes_sent;
+  m_stats.bytes_sent += bytes_sent;
+
+  if (m_output_offset == m_output.size()) {
+    m_output.clear();
+    m_output_offset = 0;
+    if (m_write_registered) {
+      m_ss->RemoveWriteDescriptor(m_descriptor);
+      m_write_registered = false;
+    }
+  } else if (!m_write_registered) {
+    m_write_registered = m_ss->AddWriteDescriptor(m_descriptor);
+  }
+  return true;
+}
+
+void SerialFrameWriter::PerformWrite() {
+  if (!Write()) {
+    Failed();
+    return;
+  }
+  MaybeSendFrame();
+}
+
+void SerialFrameWriter::PaceTimeout() {
+  m_pace_timeout = INVALID_TIMEOUT;
+  MaybeSendFrame();
+}
+
+/*
+ * Drop the frame, and run the error handler.
+ */
+void SerialFrameWriter::Failed() {
+  m_output.clear();
+  m_output_offset = 0;
+  m_sent.Reset();
+  if (m_write_registered) {
+    m_ss->RemoveWriteDescriptor(m_descriptor);
+    m_write_registered = false;
+  }
+  if (m_on_error.get()) {
+    m_on_error->Run();
+  }
+}
+}  // namespace io
+}  // namespace ola
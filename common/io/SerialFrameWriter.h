@@ -0,0 +1,237 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * SerialFrameWriter.h
+ * Writes DMX frames to a serial widget without blocking.
+ * Copyright (C) 2026 agent
+ */
+
+#ifndef COMMON_IO_SERIALFRAMEWRITER_H_
+#define COMMON_IO_SERIALFRAMEWRITER_H_
+
+#include <stdint.h>
+#include <ola/Callback.h>
+#include <ola/Clock.h>
+#include <ola/DmxBuffer.h>
+#include <ola/base/Macro.h>
+#include <ola/io/ByteString.h>
+#include <ola/io/Descriptor.h>
+#include <ola/io/SelectServerInterface.h>
+
+#include <memory>
+#include <vector>
+
+namespace ola {
+namespace io {
+
+/**
+ * @brief Converts DMX frames into the bytes for a serial protocol.
+ *
+ * Protocols that can address part of the universe only need to send the
+ * slots that changed since the previous frame.
+ */
+class SerialFrameEncoder {
+ public:
+  /**
+   * @brief A run of slots.
+   */
+  struct SlotRange {
+    unsigned int start;
+    unsigned int length;
+  };
+
+  typedef std::vector<SlotRange> SlotRanges;
+
+  virtual ~SerialFrameEncoder() {}
+
+  /**
+   * @brief Encode a frame.
+   * @param previous the last frame the widget was sent. This is empty if the
+   *   state of the widget is unknown, in which case all slots must be sent.
+   * @param frame the frame to encode.
+   * @param output the bytes to send are appended to this.
+   */
+  virtual void Encode(const DmxBuffer &previous,
+                      const DmxBuffer &frame,
+                      ByteString *output) = 0;
+
+  /**
+   * @brief Find the runs of slots that differ between two frames.
+   * @param previous the last frame that was sent.
+   * @param frame the new frame.
+   * @param max_gap runs that are separated by this many unchanged slots or
+   *   fewer are merged. This should be the size of the per-run header, since
+   *   it's cheaper to resend a few slots than start a new run.
+   * @param[out] ranges the changed runs.
+   *
+   * Slots beyond the end of previous are always considered changed.
+   */
+  static void ChangedRanges(const DmxBuffer &previous,
+                            const DmxBuffer &frame,
+                            unsigned int max_gap,
+                            SlotRanges *ranges);
+};
+
+
+/**
+ * @brief Writes DMX frames to a ConnectedDescriptor without blocking.
+ *
+ * Only one frame is in progress at once. If SendDmx() is called while a frame
+ * is still being written, the new frame replaces any other frame waiting to
+ * be sent, so a slow widget always gets the latest data rather than a
+ * growing backlog.
+ *
+ * If the baud rate is known, the next frame isn't started until the previous
+ * one would have left the UART. This stops frames piling up in the kernel's
+ * tty buffer, which would otherwise add latency.
+ *
+ * Every full_frame_interval a complete frame is sent, so a widget that missed
+ * bytes recovers.
+ */
+class SerialFrameWriter {
+ public:
+  struct Options {
+    /**
+     * @brief The baud rate of the serial line, 0 if it's not a serial line.
+     */
+    unsigned int baud_rate;
+
+    /**
+     * @brief How often to send a complete frame, in ms. 0 means always send
+     *   complete frames.
+     */
+    unsigned int full_frame_interval;
+
+    Options()
+        : baud_rate(0),
+          full_frame_interval(DEFAULT_FULL_FRAME_INTERVAL) {
+    }
+  };
+
+  struct Stats {
+    unsigned int frames_sent;  //!< frames written
+    unsigned int frames_dropped;  //!< frames replaced by a newer frame
+    unsigned int full_frames;  //!< frames that were sent in full
+    unsigned int bytes_sent;  //!< bytes written
+
+    Stats()
+        : frames_sent(0),
+          frames_dropped(0),
+          full_frames(0),
+          bytes_sent(0) {
+    }
+  };
+
+  /**
+   * @brief Create a new SerialFrameWriter.
+   * @param ss the SelectServer to use.
+   * @param descriptor the descriptor to write to, ownership is not
+   *   transferred. It must outlive the SerialFrameWriter.
+   * @param encoder the encoder for the protocol, ownership is transferred.
+   * @param options the Options.
+   */
+  SerialFrameWriter(SelectServerInterface *ss,
+                    ConnectedDescriptor *descriptor,
+                    SerialFrameEncoder *encoder,
+                    const Options &options);
+
+  ~SerialFrameWriter();
+
+  /**
+   * @brief Set the callback run if a write fails.
+   * @param on_error the callback to run, ownership is transferred.
+   *
+   * The callback is the last thing run, so it's safe for it to schedule the
+   * deletion of the SerialFrameWriter.
+   */
+  void SetOnError(Callback0<void> *on_error);
+
+  /**
+   * @brief Send a frame.
+   * @param buffer the frame to send.
+   * @returns false if the frame couldn't be written.
+   */
+  bool SendDmx(const DmxBuffer &buffer);
+
+  /**
+   * @brief Send bytes that aren't part of a frame, e.g. a query.
+   * @param data the bytes to send.
+   * @param length the number of bytes.
+   * @returns false if the bytes couldn't be written.
+   *
+   * The bytes are sent once the frame in progress has been written, and
+   * before the next frame, so they're never interleaved with frame data.
+   */
+  bool SendCommand(const uint8_t *data, unsigned int length);
+
+  /**
+   * @brief Forget the state of the widget, so the next frame is sent in full.
+   */
+  void Reset();
+
+  /**
+   * @brief Return the highest rate complete frames could be sent at.
+   * @returns the frames per second, or 0 if the baud rate isn't known or no
+   *   complete frame has been sent yet.
+   */
+  unsigned int MaxRefreshRate() const;
+
+  const Stats &GetStats() const { return m_stats; }
+
+  /**
+   * @brief The time it takes to send some bytes at a baud rate.
+   *
+   * This assumes 8N1, so each byte is 10 bits on the wire.
+   */
+  static TimeInterval TransmitTime(unsigned int baud_rate,
+                                   unsigned int bytes);
+
+  static const unsigned int DEFAULT_FULL_FRAME_INTERVAL = 1000;
+
+ private:
+  SelectServerInterface *m_ss;
+  ConnectedDescriptor *m_descriptor;
+  std::auto_ptr<SerialFrameEncoder> m_encoder;
+  std::auto_ptr<Callback0<void> > m_on_error;
+  const Options m_options;
+  const TimeInterval m_full_frame_interval;
+  Clock m_clock;
+
+  DmxBuffer m_sent;
+  DmxBuffer m_pending;
+  bool m_has_pending;
+  TimeStamp m_last_full_frame;
+
+  ByteString m_commands;
+  ByteString m_output;
+  unsigned int m_output_offset;
+  unsigned int m_full_frame_size;
+  bool m_write_registered;
+  ola::thread::timeout_id m_pace_timeout;
+  Stats m_stats;
+
+  bool Busy() const;
+  bool MaybeSendFrame();
+  bool StartWrite();
+  bool Write();
+  void PerformWrite();
+  void PaceTimeout();
+  void Failed();
+
+  DISALLOW_COPY_AND_ASSIGN(SerialFrameWriter);
+};
+}  // namespace io
+}  // namespace ola
+#endif  // COMMON_IO_SERIALFRAMEWRITER_H_
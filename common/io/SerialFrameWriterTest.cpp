@@ -0,0 +1,292 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * SerialFrameWriterTest.cpp
+ * Test fixture for the SerialFrameWriter class.
+ * Copyright (C) 2026 agent
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <stdint.h>
+
+#include "common/io/SerialFrameWriter.h"
+#include "ola/Callback.h"
+#include "ola/DmxBuffer.h"
+#include "ola/io/ByteString.h"
+#include "ola/io/Descriptor.h"
+#include "ola/io/SelectServer.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::DmxBuffer;
+using ola::TimeInterval;
+using ola::io::ByteString;
+using ola::io::LoopbackDescriptor;
+using ola::io::SelectServer;
+using ola::io::SerialFrameEncoder;
+using ola::io::SerialFrameWriter;
+
+namespace {
+
+/*
+ * Encodes each run as: start, length, data.
+ */
+class RangeEncoder : public SerialFrameEncoder {
+ public:
+  void Encode(const DmxBuffer &previous, const DmxBuffer &frame,
+              ByteString *output) {
+    SlotRanges ranges;
+    ChangedRanges(previous, frame, 2, &ranges);
+    SlotRanges::const_iterator iter = ranges.begin();
+    for (; iter != ranges.end(); ++iter) {
+      output->push_back(iter->start);
+      output->push_back(iter->length);
+      output->append(frame.GetRaw() + iter->start, iter->length);
+    }
+  }
+};
+}  // namespace
+
+class SerialFrameWriterTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(SerialFrameWriterTest);
+  CPPUNIT_TEST(testChangedRanges);
+  CPPUNIT_TEST(testDelta);
+  CPPUNIT_TEST(testFullFrames);
+  CPPUNIT_TEST(testCoalescing);
+  CPPUNIT_TEST(testCommands);
+  CPPUNIT_TEST(testTransmitTime);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void setUp();
+
+  void testChangedRanges();
+  void testDelta();
+  void testFullFrames();
+  void testCoalescing();
+  void testCommands();
+  void testTransmitTime();
+
+ private:
+  SelectServer m_ss;
+  LoopbackDescriptor m_descriptor;
+
+  ByteString ReadOutput();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(SerialFrameWriterTest);
+
+void SerialFrameWriterTest::setUp() {
+  OLA_ASSERT_TRUE(m_descriptor.Init());
+}
+
+ByteString SerialFrameWriterTest::ReadOutput() {
+  ByteString output;
+  while (m_descriptor.DataRemaining()) {
+    uint8_t data[64];
+    unsigned int data_read;
+    OLA_ASSERT_EQ(0, m_descriptor.Receive(data, sizeof(data), data_read));
+    output.append(data, data_read);
+  }
+  return output;
+}
+
+/*
+ * Check ChangedRanges().
+ */
+void SerialFrameWriterTest::testChangedRanges() {
+  SerialFrameEncoder::SlotRanges ranges;
+  DmxBuffer previous, frame;
+
+  // Everything is new.
+  frame.SetFromString("1,2,3,4");
+  SerialFrameEncoder::ChangedRanges(previous, frame, 0, &ranges);
+  OLA_ASSERT_EQ(static_cast<size_t>(1), ranges.size());
+  OLA_ASSERT_EQ(0u, ranges[0].start);
+  OLA_ASSERT_EQ(4u, ranges[0].length);
+
+  // No changes
+  previous.SetFromString("1,2,3,4");
+  SerialFrameEncoder::ChangedRanges(previous, frame, 0, &ranges);
+  OLA_ASSERT_TRUE(ranges.empty());
+
+  // Two separate runs
+  frame.SetFromString("9,2,3,4,5,6,7,8");
+  previous.SetFromString("1,2,3,4,5,6,0,0");
+  SerialFrameEncoder::ChangedRanges(previous, frame, 2, &ranges);
+  OLA_ASSERT_EQ(static_cast<size_t>(2), ranges.size());
+  OLA_ASSERT_EQ(0u, ranges[0].start);
+  OLA_ASSERT_EQ(1u, ranges[0].length);
+  OLA_ASSERT_EQ(6u, ranges[1].start);
+  OLA_ASSERT_EQ(2u, ranges[1].length);
+
+  // The gap is small enough to merge the runs.
+  SerialFrameEncoder::ChangedRanges(previous, frame, 5, &ranges);
+  OLA_ASSERT_EQ(static_cast<size_t>(1), ranges.size());
+  OLA_ASSERT_EQ(0u, ranges[0].start);
+  OLA_ASSERT_EQ(8u, ranges[0].length);
+
+  // Slots past the end of the previous frame have changed.
+  previous.SetFromString("9,2,3,4,5,6");
+  SerialFrameEncoder::ChangedRanges(previous, frame, 0, &ranges);
+  OLA_ASSERT_EQ(static_cast<size_t>(1), ranges.size());
+  OLA_ASSERT_EQ(6u, ranges[0].start);
+  OLA_ASSERT_EQ(2u, ranges[0].length);
+}
+
+/*
+ * Check only the changed slots are sent.
+ */
+void SerialFrameWriterTest::testDelta() {
+  SerialFrameWriter::Options options;
+  options.full_frame_interval = 60000;
+  SerialFrameWriter writer(&m_ss, &m_descriptor, new RangeEncoder(), options);
+
+  DmxBuffer frame;
+  frame.SetFromString("1,2,3,4,5,6,7,8");
+  OLA_ASSERT_TRUE(writer.SendDmx(frame));
+  const uint8_t expected1[] = {0, 8, 1, 2, 3, 4, 5, 6, 7, 8};
+  OLA_ASSERT_DATA_EQUALS(expected1, sizeof(expected1),
+                         ReadOutput().data(), sizeof(expected1));
+
+  frame.SetChannel(6, 100);
+  OLA_ASSERT_TRUE(writer.SendDmx(frame));
+  const uint8_t expected2[] = {6, 1, 100};
+  ByteString output = ReadOutput();
+  OLA_ASSERT_DATA_EQUALS(expected2, sizeof(expected2),
+                         output.data(), output.size());
+
+  // Nothing changed, so nothing is sent.
+  OLA_ASSERT_TRUE(writer.SendDmx(frame));
+  OLA_ASSERT_EQ(0, m_descriptor.DataRemaining());
+
+  // After a reset the whole frame is sent.
+  writer.Reset();
+  OLA_ASSERT_TRUE(writer.SendDmx(frame));
+  OLA_ASSERT_EQ(10u, static_cast<unsigned int>(ReadOutput().size()));
+
+  const SerialFrameWriter::Stats &stats = writer.GetStats();
+  OLA_ASSERT_EQ(3u, stats.frames_sent);
+  OLA_ASSERT_EQ(0u, stats.frames_dropped);
+  OLA_ASSERT_EQ(2u, stats.full_frames);
+  OLA_ASSERT_EQ(23u, stats.bytes_sent);
+}
+
+/*
+ * Check a full_frame_interval of 0 disables the delta encoding.
+ */
+void SerialFrameWriterTest::testFullFrames() {
+  SerialFrameWriter::Options options;
+  options.full_frame_interval = 0;
+  SerialFrameWriter writer(&m_ss, &m_descriptor, new RangeEncoder(), options);
+
+  DmxBuffer frame;
+  frame.SetFromString("1,2,3,4");
+  OLA_ASSERT_TRUE(writer.SendDmx(frame));
+  OLA_ASSERT_EQ(6u, static_cast<unsigned int>(ReadOutput().size()));
+  OLA_ASSERT_TRUE(writer.SendDmx(frame));
+  OLA_ASSERT_EQ(6u, static_cast<unsigned int>(ReadOutput().size()));
+  OLA_ASSERT_EQ(2u, writer.GetStats().full_frames);
+}
+
+/*
+ * Check frames sent faster than the line can carry them are coalesced.
+ */
+void SerialFrameWriterTest::testCoalescing() {
+  SerialFrameWriter::Options options;
+  options.baud_rate = 9600;
+  SerialFrameWriter writer(&m_ss, &m_descriptor, new RangeEncoder(), options);
+
+  // 1 byte takes ~1ms at 9600, so this frame takes ~10ms.
+  DmxBuffer frame;
+  frame.SetFromString("1,2,3,4,5,6,7,8");
+  OLA_ASSERT_TRUE(writer.SendDmx(frame));
+  OLA_ASSERT_EQ(96u, writer.MaxRefreshRate());
+
+  for (unsigned int i = 0; i < 5; i++) {
+    frame.SetChannel(0, i);
+    OLA_ASSERT_TRUE(writer.SendDmx(frame));
+  }
+  OLA_ASSERT_EQ(1u, writer.GetStats().frames_sent);
+  OLA_ASSERT_EQ(4u, writer.GetStats().frames_dropped);
+  OLA_ASSERT_EQ(10u, static_cast<unsigned int>(ReadOutput().size()));
+
+  m_ss.RegisterSingleTimeout(
+      100, ola::NewSingleCallback(&m_ss, &SelectServer::Terminate));
+  m_ss.Run();
+
+  // Only the last frame was sent.
+  OLA_ASSERT_EQ(2u, writer.GetStats().frames_sent);
+  const uint8_t expected[] = {0, 1, 4};
+  ByteString output = ReadOutput();
+  OLA_ASSERT_DATA_EQUALS(expected, sizeof(expected),
+                         output.data(), output.size());
+}
+
+/*
+ * Check commands are sent between frames.
+ */
+void SerialFrameWriterTest::testCommands() {
+  SerialFrameWriter::Options options;
+  options.baud_rate = 9600;
+  SerialFrameWriter writer(&m_ss, &m_descriptor, new RangeEncoder(), options);
+
+  // The writer is idle, so the command is sent immediately.
+  const uint8_t command[] = {'C', '?'};
+  OLA_ASSERT_TRUE(writer.SendCommand(command, sizeof(command)));
+  ByteString output = ReadOutput();
+  OLA_ASSERT_DATA_EQUALS(command, sizeof(command),
+                         output.data(), output.size());
+
+  // The command waits for the frame in progress, and is sent before the next
+  // frame.
+  m_ss.RegisterSingleTimeout(
+      10, ola::NewSingleCallback(&m_ss, &SelectServer::Terminate));
+  m_ss.Run();
+  DmxBuffer frame;
+  frame.SetFromString("1,2,3");
+  OLA_ASSERT_TRUE(writer.SendDmx(frame));
+  OLA_ASSERT_TRUE(writer.SendCommand(command, sizeof(command)));
+  frame.SetChannel(0, 9);
+  OLA_ASSERT_TRUE(writer.SendDmx(frame));
+  const uint8_t first_frame[] = {0, 3, 1, 2, 3};
+  output = ReadOutput();
+  OLA_ASSERT_DATA_EQUALS(first_frame, sizeof(first_frame),
+                         output.data(), output.size());
+
+  m_ss.RegisterSingleTimeout(
+      100, ola::NewSingleCallback(&m_ss, &SelectServer::Terminate));
+  m_ss.Run();
+
+  const uint8_t expected[] = {'C', '?', 0, 1, 9};
+  output = ReadOutput();
+  OLA_ASSERT_DATA_EQUALS(expected, sizeof(expected),
+                         output.data(), output.size());
+  OLA_ASSERT_EQ(2u, writer.GetStats().frames_sent);
+}
+
+/*
+ * Check TransmitTime().
+ */
+void SerialFrameWriterTest::testTransmitTime() {
+  OLA_ASSERT_EQ(TimeInterval(), SerialFrameWriter::TransmitTime(0, 100));
+  OLA_ASSERT_EQ(TimeInterval(0, 1000),
+                SerialFrameWriter::TransmitTime(10000, 1));
+  // 513 slots at 250k is ~20.5ms
+  OLA_ASSERT_EQ(TimeInterval(0, 20520),
+                SerialFrameWriter::TransmitTime(250000, 513));
+  // rounded up
+  OLA_ASSERT_EQ(TimeInterval(0, 1042),
+                SerialFrameWriter::TransmitTime(9600, 1));
+}
@@ -0,0 +1,197 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * ioqueue_benchmark.cpp
+ * Measure the throughput of the IOQueue and MemoryBlockPool.
+ * Copyright (C) 2026 agent
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "ola/Clock.h"
+#include "ola/Logging.h"
+#include "ola/base/Flags.h"
+#include "ola/base/Init.h"
+#include "ola/io/Descriptor.h"
+#include "ola/io/IOQueue.h"
+#include "ola/io/MemoryBlock.h"
+#include "ola/io/MemoryBlockPool.h"
+
+using ola::Clock;
+using ola::TimeInterval;
+using ola::TimeStamp;
+using ola::io::IOQueue;
+using ola::io::IOQueueView;
+using ola::io::LoopbackDescriptor;
+using ola::io::MemoryBlock;
+using ola::io::MemoryBlockPool;
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+
+DEFINE_s_uint32(iterations, i, 100000, "The number of iterations of each test");
+DEFINE_s_uint32(message_size, m, 4096, "The size of each message in bytes");
+
+namespace {
+
+// The number of blocks held at once by the allocation tests.
+const unsigned int BLOCKS_IN_USE = 32;
+
+class Timer {
+ public:
+    Timer() { m_clock.CurrentMonotonicTime(&m_start); }
+
+    void Report(const string &name, double bytes) {
+      TimeStamp end;
+      m_clock.CurrentMonotonicTime(&end);
+      TimeInterval elapsed = end - m_start;
+      double seconds = elapsed.AsInt() / 1000000.0;
+      cout << std::left << std::setw(36) << name << std::right << std::fixed
+           << std::setprecision(1) << std::setw(10)
+           << (seconds ? bytes / seconds / 1000000 : 0) << " MB/s" << endl;
+    }
+
+ private:
+    Clock m_clock;
+    TimeStamp m_start;
+};
+
+/*
+ * Allocate a new block for each use, as the pool used to.
+ */
+void AllocateUnpooled() {
+  Timer timer;
+  vector<MemoryBlock*> blocks(BLOCKS_IN_USE);
+  for (unsigned int i = 0; i < FLAGS_iterations; i++) {
+    for (unsigned int j = 0; j < BLOCKS_IN_USE; j++) {
+      blocks[j] = new MemoryBlock(
+          new uint8_t[MemoryBlockPool::DEFAULT_BLOCK_SIZE],
+          MemoryBlockPool::DEFAULT_BLOCK_SIZE);
+    }
+    for (unsigned int j = 0; j < BLOCKS_IN_USE; j++) {
+      delete blocks[j];
+    }
+  }
+  timer.Report("Unpooled block allocation",
+               static_cast<double>(FLAGS_iterations) * BLOCKS_IN_USE *
+               MemoryBlockPool::DEFAULT_BLOCK_SIZE);
+}
+
+/*
+ * Allocate blocks from a pool.
+ */
+void AllocatePooled(const string &name, MemoryBlockPool *pool) {
+  Timer timer;
+  vector<MemoryBlock*> blocks(BLOCKS_IN_USE);
+  for (unsigned int i = 0; i < FLAGS_iterations; i++) {
+    for (unsigned int j = 0; j < BLOCKS_IN_USE; j++) {
+      blocks[j] = pool->Allocate();
+    }
+    for (unsigned int j = 0; j < BLOCKS_IN_USE; j++) {
+      pool->Release(blocks[j]);
+    }
+  }
+  timer.Report(name, static_cast<double>(FLAGS_iterations) * BLOCKS_IN_USE *
+               pool->BlockSize());
+}
+
+/*
+ * Write messages to a queue and read them out again.
+ */
+void WriteAndRead(const string &name, IOQueue *queue) {
+  vector<uint8_t> message(FLAGS_message_size, 0x55);
+  vector<uint8_t> output(FLAGS_message_size);
+  Timer timer;
+  for (unsigned int i = 0; i < FLAGS_iterations; i++) {
+    queue->Write(&message[0], message.size());
+    queue->Read(&output[0], output.size());
+  }
+  timer.Report(name, static_cast<double>(FLAGS_iterations) * message.size());
+}
+
+/*
+ * Read messages from a descriptor, either by copying them into the queue or
+ * with readv() into the queue's blocks. Then parse the message, copying it
+ * out, or in place if it's contiguous.
+ */
+void Receive(const string &name, bool scatter_gather) {
+  LoopbackDescriptor descriptor;
+  if (!descriptor.Init()) {
+    OLA_WARN << "Failed to create loopback descriptor";
+    return;
+  }
+
+  IOQueue queue;
+  vector<uint8_t> message(FLAGS_message_size, 0x55);
+  vector<uint8_t> buffer(FLAGS_message_size);
+  unsigned int checksum = 0;
+
+  Timer timer;
+  for (unsigned int i = 0; i < FLAGS_iterations; i++) {
+    descriptor.Send(&message[0], message.size());
+    unsigned int data_read;
+    if (scatter_gather) {
+      descriptor.Receive(&queue, message.size(), data_read);
+      IOQueueView view = queue.View();
+      const uint8_t *data = view.Contiguous();
+      if (!data) {
+        view.Peek(&buffer[0], buffer.size());
+        data = &buffer[0];
+      }
+      checksum += data[data_read - 1];
+    } else {
+      descriptor.Receive(&buffer[0], buffer.size(), data_read);
+      queue.Write(&buffer[0], data_read);
+      queue.Peek(&buffer[0], buffer.size());
+      checksum += buffer[data_read - 1];
+    }
+    queue.Pop(data_read);
+  }
+  timer.Report(name, static_cast<double>(FLAGS_iterations) * message.size());
+  if (checksum != FLAGS_iterations * message[0]) {
+    OLA_WARN << name << ": data mismatch";
+  }
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  ola::AppInit(&argc, argv, "",
+               "Measure the throughput of the IOQueue and MemoryBlockPool.");
+
+  if (FLAGS_message_size == 0 || FLAGS_message_size > 65536) {
+    OLA_FATAL << "--message-size must be between 1 and 65536";
+    return 1;
+  }
+
+  AllocateUnpooled();
+  MemoryBlockPool pool;
+  AllocatePooled("Pooled block allocation", &pool);
+  AllocatePooled("Thread local pool allocation",
+                 MemoryBlockPool::ThreadLocalPool());
+
+  IOQueue queue;
+  WriteAndRead("IOQueue Write / Read", &queue);
+  IOQueue thread_local_queue(MemoryBlockPool::ThreadLocalPool());
+  WriteAndRead("IOQueue Write / Read, thread pool", &thread_local_queue);
+
+  Receive("Receive and copy to IOQueue", false);
+  Receive("Receive to IOQueue with readv", true);
+  return 0;
+}
@@ -36,10 +36,17 @@ AdvancedTCPConnector::AdvancedTCPConnector(
     : m_socket_factory(socket_factory),
       m_ss(ss),
       m_connector(ss),
-      m_connection_timeout(connection_timeout) {
+      m_connection_timeout(connection_timeout),
+      m_max_pending(0),
+      m_pending(0),
+      m_draining_queue(false),
+      m_connect_attempts(0),
+      m_connect_failures(0) {
 }
 
 AdvancedTCPConnector::~AdvancedTCPConnector() {
+  // Don't start any queued connections while we cancel the pending ones.
+  m_connect_queue.clear();
   ConnectionMap::iterator iter = m_connections.begin();
   for (; iter != m_connections.end(); ++iter) {
     AbortConnection(iter->second);
@@ -65,6 +72,7 @@ void AdvancedTCPConnector::AddEndpoint(const IPV4SocketAddress &endpoint,
   state->connection_id = 0;
   state->policy = backoff_policy;
   state->reconnect = true;
+  state->queued = false;
 
   m_connections[key] = state;
 
@@ -83,6 +91,40 @@ void AdvancedTCPConnector::RemoveEndpoint(const IPV4SocketAddress &endpoint) {
   m_connections.erase(iter);
 }
 
+void AdvancedTCPConnector::SetMaxPendingConnections(
+    unsigned int max_pending) {
+  m_max_pending = max_pending;
+  DrainConnectQueue();
+}
+
+void AdvancedTCPConnector::GetStats(ConnectorStats *stats) const {
+  stats->endpoints = static_cast<unsigned int>(m_connections.size());
+  stats->connected = 0;
+  stats->disconnected = 0;
+  stats->paused = 0;
+  stats->pending = m_pending;
+  stats->queued = 0;
+  stats->connect_attempts = m_connect_attempts;
+  stats->connect_failures = m_connect_failures;
+
+  ConnectionMap::const_iterator iter = m_connections.begin();
+  for (; iter != m_connections.end(); ++iter) {
+    switch (iter->second->state) {
+      case CONNECTED:
+        stats->connected++;
+        break;
+      case DISCONNECTED:
+        stats->disconnected++;
+        break;
+      case PAUSED:
+        stats->paused++;
+        break;
+    }
+    if (iter->second->queued)
+      stats->queued++;
+  }
+}
+
 bool AdvancedTCPConnector::GetEndpointState(
     const IPV4SocketAddress &endpoint,
     ConnectionState *connected,
@@ -182,25 +224,49 @@ void AdvancedTCPConnector::ConnectionResult(IPPortPair key, int fd, int) {
   ConnectionInfo *info = iter->second;
 
   info->connection_id = 0;
+  m_pending--;
   if (fd != -1) {
     // ok
     info->state = CONNECTED;
     m_socket_factory->NewTCPSocket(fd);
   } else {
     // error
+    m_connect_failures++;
     info->failed_attempts++;
     if (info->reconnect) {
       ScheduleRetry(key, info);
     }
   }
+  DrainConnectQueue();
 }
 
 
 /**
- * Initiate a connection to this ip:port pair
+ * Initiate a connection to this ip:port pair, or queue it if there are
+ * already too many connections in progress.
  */
 void AdvancedTCPConnector::AttemptConnection(const IPPortPair &key,
                                              ConnectionInfo *state) {
+  if (state->queued)
+    return;
+
+  if (m_max_pending && (m_pending >= m_max_pending ||
+                        !m_connect_queue.empty())) {
+    state->queued = true;
+    m_connect_queue.push_back(key);
+    return;
+  }
+  StartConnection(key, state);
+}
+
+
+/**
+ * Start the non-blocking connect.
+ */
+void AdvancedTCPConnector::StartConnection(const IPPortPair &key,
+                                           ConnectionInfo *state) {
+  m_pending++;
+  m_connect_attempts++;
   state->connection_id = m_connector.Connect(
       IPV4SocketAddress(key.first, key.second),
       m_connection_timeout,
@@ -210,6 +276,31 @@ void AdvancedTCPConnector::AttemptConnection(const IPPortPair &key,
 }
 
 
+/**
+ * Start queued connections until we hit the pending limit.
+ */
+void AdvancedTCPConnector::DrainConnectQueue() {
+  // Connect() may run the callback immediately, which would call back into
+  // here.
+  if (m_draining_queue)
+    return;
+  m_draining_queue = true;
+
+  while (!m_connect_queue.empty() &&
+         (m_max_pending == 0 || m_pending < m_max_pending)) {
+    IPPortPair key = m_connect_queue.front();
+    m_connect_queue.pop_front();
+    ConnectionMap::iterator iter = m_connections.find(key);
+    if (iter == m_connections.end() || !iter->second->queued)
+      continue;
+
+    iter->second->queued = false;
+    StartConnection(key, iter->second);
+  }
+  m_draining_queue = false;
+}
+
+
 /**
  * Abort and clean up a pending connection
  * @param state the ConnectionInfo to cleanup.
@@ -220,6 +311,7 @@ void AdvancedTCPConnector::AbortConnection(ConnectionInfo *state) {
     if (!m_connector.Cancel(state->connection_id))
       OLA_WARN << "Failed to cancel connection " << state->connection_id;
   }
+  state->queued = false;
   if (state->retry_timeout != ola::thread::INVALID_TIMEOUT)
     m_ss->RemoveTimeout(state->retry_timeout);
 }
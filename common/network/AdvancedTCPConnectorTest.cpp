@@ -23,6 +23,7 @@
 #include <string.h>
 #include <iostream>
 #include <string>
+#include <vector>
 
 #include "ola/Callback.h"
 #include "ola/Clock.h"
@@ -49,6 +50,7 @@ using ola::network::TCPAcceptingSocket;
 using ola::network::TCPSocket;
 using std::auto_ptr;
 using std::string;
+using std::vector;
 
 // used to set a timeout which aborts the tests
 static const int CONNECT_TIMEOUT_IN_MS = 500;
@@ -61,6 +63,7 @@ class AdvancedTCPConnectorTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testPause);
   CPPUNIT_TEST(testBackoff);
   CPPUNIT_TEST(testEarlyDestruction);
+  CPPUNIT_TEST(testMaxPendingConnections);
   CPPUNIT_TEST_SUITE_END();
 
  public:
@@ -76,6 +79,7 @@ class AdvancedTCPConnectorTest: public CppUnit::TestFixture {
   void testPause();
   void testBackoff();
   void testEarlyDestruction();
+  void testMaxPendingConnections();
 
   // timing out indicates something went wrong
   void Timeout() {
@@ -105,6 +109,9 @@ class AdvancedTCPConnectorTest: public CppUnit::TestFixture {
   uint16_t ReservePort();
   void AcceptedConnection(TCPSocket *socket);
   void OnConnect(TCPSocket *socket);
+  void HoldSocket(vector<TCPSocket*> *sockets, TCPSocket *socket);
+  void CountConnection(vector<TCPSocket*> *sockets, unsigned int expected,
+                       TCPSocket *socket);
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(AdvancedTCPConnectorTest);
@@ -332,6 +339,86 @@ void AdvancedTCPConnectorTest::testEarlyDestruction() {
   }
 }
 
+/**
+ * Test that limiting the number of pending connections still connects to
+ * every endpoint, and that the stats are correct.
+ */
+void AdvancedTCPConnectorTest::testMaxPendingConnections() {
+  const unsigned int LISTENER_COUNT = 4;
+  vector<TCPSocket*> accepted_sockets;
+  vector<TCPSocket*> connected_sockets;
+
+  ola::network::TCPSocketFactory accept_factory(
+      ola::NewCallback(this, &AdvancedTCPConnectorTest::HoldSocket,
+                       &accepted_sockets));
+  ola::network::TCPSocketFactory connect_factory(
+      ola::NewCallback(this, &AdvancedTCPConnectorTest::CountConnection,
+                       &connected_sockets, LISTENER_COUNT));
+
+  vector<TCPAcceptingSocket*> listeners;
+  vector<IPV4SocketAddress> endpoints;
+  for (unsigned int i = 0; i < LISTENER_COUNT; i++) {
+    TCPAcceptingSocket *listener = new TCPAcceptingSocket(&accept_factory);
+    SetupListeningSocket(listener);
+    listeners.push_back(listener);
+    endpoints.push_back(m_server_address);
+  }
+
+  AdvancedTCPConnector connector(
+      m_ss,
+      &connect_factory,
+      TimeInterval(0, CONNECT_TIMEOUT_IN_MS * 1000));
+  connector.SetMaxPendingConnections(1);
+
+  LinearBackoffPolicy policy(TimeInterval(5, 0), TimeInterval(30, 0));
+  for (unsigned int i = 0; i < LISTENER_COUNT; i++) {
+    connector.AddEndpoint(endpoints[i], &policy);
+  }
+
+  AdvancedTCPConnector::ConnectorStats stats;
+  connector.GetStats(&stats);
+  OLA_ASSERT_EQ(LISTENER_COUNT, stats.endpoints);
+  OLA_ASSERT_EQ(0u, stats.paused);
+  // Sockets may connect immediately depending on the platform.
+  OLA_ASSERT_TRUE(stats.pending <= 1);
+  OLA_ASSERT_EQ(LISTENER_COUNT,
+                stats.connected + stats.pending + stats.queued);
+
+  if (connected_sockets.size() != LISTENER_COUNT) {
+    m_ss->Run();
+  }
+
+  connector.GetStats(&stats);
+  OLA_ASSERT_EQ(LISTENER_COUNT, stats.endpoints);
+  OLA_ASSERT_EQ(LISTENER_COUNT, stats.connected);
+  OLA_ASSERT_EQ(0u, stats.disconnected);
+  OLA_ASSERT_EQ(0u, stats.pending);
+  OLA_ASSERT_EQ(0u, stats.queued);
+  OLA_ASSERT_EQ(static_cast<uint64_t>(LISTENER_COUNT),
+                stats.connect_attempts);
+  OLA_ASSERT_EQ(static_cast<uint64_t>(0), stats.connect_failures);
+  OLA_ASSERT_EQ(static_cast<size_t>(LISTENER_COUNT),
+                connected_sockets.size());
+
+  // clean up
+  for (unsigned int i = 0; i < LISTENER_COUNT; i++) {
+    connector.RemoveEndpoint(endpoints[i]);
+    m_ss->RemoveReadDescriptor(listeners[i]);
+    delete listeners[i];
+  }
+  OLA_ASSERT_EQ(0u, connector.EndpointCount());
+
+  vector<TCPSocket*>::iterator iter = connected_sockets.begin();
+  for (; iter != connected_sockets.end(); ++iter) {
+    delete *iter;
+  }
+  for (iter = accepted_sockets.begin(); iter != accepted_sockets.end();
+       ++iter) {
+    delete *iter;
+  }
+}
+
+
 /**
  * Confirm the state & failed attempts matches what we expected
  */
@@ -421,3 +508,26 @@ void AdvancedTCPConnectorTest::OnConnect(TCPSocket *socket) {
   m_connected_socket = socket;
   m_ss->Terminate();
 }
+
+
+/*
+ * Keep hold of an accepted connection.
+ */
+void AdvancedTCPConnectorTest::HoldSocket(vector<TCPSocket*> *sockets,
+                                          TCPSocket *socket) {
+  OLA_ASSERT_NOT_NULL(socket);
+  sockets->push_back(socket);
+}
+
+
+/*
+ * Called when one of many connections completes.
+ */
+void AdvancedTCPConnectorTest::CountConnection(vector<TCPSocket*> *sockets,
+                                               unsigned int expected,
+                                               TCPSocket *socket) {
+  OLA_ASSERT_NOT_NULL(socket);
+  sockets->push_back(socket);
+  if (sockets->size() == expected)
+    m_ss->Terminate();
+}
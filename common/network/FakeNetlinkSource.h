@@ -0,0 +1,211 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * FakeNetlinkSource.h
+ * A NetlinkSource for testing.
+ * Copyright (C) 2026 agent
+ */
+
+#ifndef COMMON_NETWORK_FAKENETLINKSOURCE_H_
+#define COMMON_NETWORK_FAKENETLINKSOURCE_H_
+
+#if defined(HAVE_LINUX_NETLINK_H) && defined(HAVE_LINUX_RTNETLINK_H)
+
+#include <string.h>
+#include <net/if.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+
+#include "common/network/NetlinkSource.h"
+#include "ola/Callback.h"
+#include "ola/io/ByteString.h"
+#include "ola/network/IPV4Address.h"
+#include "ola/network/MACAddress.h"
+
+namespace ola {
+namespace network {
+
+/**
+ * @brief A NetlinkSource that returns scripted messages.
+ */
+class FakeNetlinkSource : public NetlinkSource {
+ public:
+  FakeNetlinkSource()
+      : m_init_ok(true),
+        m_overflowed(false),
+        m_dump_count(0) {
+  }
+
+  bool Init() { return m_init_ok; }
+
+  bool RequestDump(uint16_t message_type) {
+    ola::io::ByteString datagram = m_dumps[message_type];
+    AppendDone(&datagram);
+    m_pending.push_back(datagram);
+    m_dump_count++;
+    return true;
+  }
+
+  bool Receive(ola::io::ByteString *datagram, bool) {
+    if (m_pending.empty()) {
+      return false;
+    }
+    *datagram = m_pending.front();
+    m_pending.pop_front();
+    return true;
+  }
+
+  bool CheckOverflow() {
+    const bool overflowed = m_overflowed;
+    m_overflowed = false;
+    return overflowed;
+  }
+
+  void SetOnData(Callback0<void> *on_data) {
+    m_on_data.reset(on_data);
+  }
+
+  void SetInitResult(bool ok) { m_init_ok = ok; }
+
+  /**
+   * @brief The number of dumps that have been requested.
+   */
+  unsigned int DumpCount() const { return m_dump_count; }
+
+  /**
+   * @brief Set the messages returned when a dump is requested.
+   */
+  void SetDump(uint16_t message_type, const ola::io::ByteString &datagram) {
+    m_dumps[message_type] = datagram;
+  }
+
+  /**
+   * @brief Deliver a datagram, as if the kernel had sent a notification.
+   */
+  void Inject(const ola::io::ByteString &datagram) {
+    m_pending.push_back(datagram);
+    if (m_on_data.get()) {
+      m_on_data->Run();
+    }
+  }
+
+  /**
+   * @brief Simulate the kernel dropping notifications (ENOBUFS).
+   */
+  void Overflow() {
+    m_pending.clear();
+    m_overflowed = true;
+    if (m_on_data.get()) {
+      m_on_data->Run();
+    }
+  }
+
+  static void AppendLink(ola::io::ByteString *datagram,
+                         uint16_t message_type,
+                         int index,
+                         const std::string &name,
+                         const MACAddress &hw_address,
+                         unsigned int flags) {
+    struct ifinfomsg info;
+    memset(&info, 0, sizeof(info));
+    info.ifi_family = AF_UNSPEC;
+    info.ifi_index = index;
+    info.ifi_flags = flags;
+    info.ifi_type = 1;  // ARPHRD_ETHER
+
+    ola::io::ByteString payload(reinterpret_cast<uint8_t*>(&info),
+                                sizeof(info));
+    AppendAttribute(&payload, IFLA_IFNAME,
+                    reinterpret_cast<const uint8_t*>(name.c_str()),
+                    name.size() + 1);
+    uint8_t mac[MACAddress::LENGTH];
+    hw_address.Get(mac);
+    AppendAttribute(&payload, IFLA_ADDRESS, mac, sizeof(mac));
+    AppendMessage(datagram, message_type, payload);
+  }
+
+  static void AppendAddress(ola::io::ByteString *datagram,
+                            uint16_t message_type,
+                            int index,
+                            const IPV4Address &ip_address,
+                            uint8_t prefix_length,
+                            const IPV4Address &bcast_address) {
+    struct ifaddrmsg info;
+    memset(&info, 0, sizeof(info));
+    info.ifa_family = AF_INET;
+    info.ifa_prefixlen = prefix_length;
+    info.ifa_index = index;
+
+    ola::io::ByteString payload(reinterpret_cast<uint8_t*>(&info),
+                                sizeof(info));
+    uint8_t address[IPV4Address::LENGTH];
+    ip_address.Get(address);
+    AppendAttribute(&payload, IFA_LOCAL, address, sizeof(address));
+    AppendAttribute(&payload, IFA_ADDRESS, address, sizeof(address));
+    bcast_address.Get(address);
+    AppendAttribute(&payload, IFA_BROADCAST, address, sizeof(address));
+    AppendMessage(datagram, message_type, payload);
+  }
+
+  static void AppendDone(ola::io::ByteString *datagram) {
+    int32_t status = 0;
+    AppendMessage(datagram, NLMSG_DONE,
+                  ola::io::ByteString(reinterpret_cast<uint8_t*>(&status),
+                                      sizeof(status)));
+  }
+
+ private:
+  typedef std::map<uint16_t, ola::io::ByteString> DumpMap;
+
+  bool m_init_ok;
+  bool m_overflowed;
+  unsigned int m_dump_count;
+  DumpMap m_dumps;
+  std::deque<ola::io::ByteString> m_pending;
+  std::auto_ptr<Callback0<void> > m_on_data;
+
+  static void AppendAttribute(ola::io::ByteString *payload, uint16_t type,
+                              const uint8_t *data, unsigned int length) {
+    struct rtattr attribute;
+    attribute.rta_len = RTA_LENGTH(length);
+    attribute.rta_type = type;
+    payload->append(reinterpret_cast<uint8_t*>(&attribute),
+                    sizeof(attribute));
+    payload->append(data, length);
+    payload->append(RTA_SPACE(length) - attribute.rta_len, 0);
+  }
+
+  static void AppendMessage(ola::io::ByteString *datagram,
+                            uint16_t message_type,
+                            const ola::io::ByteString &payload) {
+    struct nlmsghdr header;
+    memset(&header, 0, sizeof(header));
+    header.nlmsg_len = NLMSG_LENGTH(payload.size());
+    header.nlmsg_type = message_type;
+    datagram->append(reinterpret_cast<uint8_t*>(&header), sizeof(header));
+    datagram->append(payload);
+    datagram->append(NLMSG_SPACE(payload.size()) - header.nlmsg_len, 0);
+  }
+};
+}  // namespace network
+}  // namespace ola
+#endif  // defined(HAVE_LINUX_NETLINK_H) && defined(HAVE_LINUX_RTNETLINK_H)
+#endif  // COMMON_NETWORK_FAKENETLINKSOURCE_H_
@@ -32,7 +32,10 @@ HealthCheckedConnection::HealthCheckedConnection(
       m_heartbeat_interval(heartbeat_interval),
       m_timeout_interval(timeout_interval),
       m_send_timeout_id(ola::thread::INVALID_TIMEOUT),
-      m_receive_timeout_id(ola::thread::INVALID_TIMEOUT) {
+      m_receive_timeout_id(ola::thread::INVALID_TIMEOUT),
+      m_timer_wheel(NULL),
+      m_send_timer(NULL),
+      m_receive_timer(NULL) {
 }
 
 
@@ -45,7 +48,35 @@ HealthCheckedConnection::HealthCheckedConnection(
                                   2.5 * heartbeat_interval.AsInt()))) {
 }
 
+HealthCheckedConnection::HealthCheckedConnection(
+  ola::thread::TimerWheel *timer_wheel,
+  const ola::TimeInterval heartbeat_interval,
+  const ola::TimeInterval timeout_interval)
+    : m_scheduler(NULL),
+      m_heartbeat_interval(heartbeat_interval),
+      m_timeout_interval(timeout_interval),
+      m_send_timeout_id(ola::thread::INVALID_TIMEOUT),
+      m_receive_timeout_id(ola::thread::INVALID_TIMEOUT),
+      m_timer_wheel(timer_wheel),
+      m_send_timer(NULL),
+      m_receive_timer(NULL) {
+  CreateTimers();
+}
+
+
+HealthCheckedConnection::HealthCheckedConnection(
+  ola::thread::TimerWheel *timer_wheel,
+  const ola::TimeInterval heartbeat_interval)
+    : HealthCheckedConnection(timer_wheel,
+                              heartbeat_interval,
+                              ola::TimeInterval(static_cast<int>(
+                                  2.5 * heartbeat_interval.AsInt()))) {
+}
+
 HealthCheckedConnection::~HealthCheckedConnection() {
+  // Deleting the timers cancels them.
+  delete m_send_timer;
+  delete m_receive_timer;
   if (m_send_timeout_id != ola::thread::INVALID_TIMEOUT)
     m_scheduler->RemoveTimeout(m_send_timeout_id);
   if (m_receive_timeout_id != ola::thread::INVALID_TIMEOUT)
@@ -68,6 +99,10 @@ bool HealthCheckedConnection::Setup() {
  * Reset the send timer
  */
 void HealthCheckedConnection::HeartbeatSent() {
+  if (m_timer_wheel) {
+    m_timer_wheel->Schedule(m_send_timer, m_heartbeat_interval);
+    return;
+  }
   if (m_send_timeout_id != ola::thread::INVALID_TIMEOUT)
     m_scheduler->RemoveTimeout(m_send_timeout_id);
   m_send_timeout_id = m_scheduler->RegisterRepeatingTimeout(
@@ -80,6 +115,10 @@ void HealthCheckedConnection::HeartbeatSent() {
  * Reset the RX timer
  */
 void HealthCheckedConnection::HeartbeatReceived() {
+  if (m_timer_wheel) {
+    m_timer_wheel->Schedule(m_receive_timer, m_timeout_interval);
+    return;
+  }
   m_scheduler->RemoveTimeout(m_receive_timeout_id);
   UpdateReceiveTimer();
 }
@@ -89,6 +128,10 @@ void HealthCheckedConnection::HeartbeatReceived() {
  * Pause the receive timer
  */
 void HealthCheckedConnection::PauseTimer() {
+  if (m_timer_wheel) {
+    m_timer_wheel->Cancel(m_receive_timer);
+    return;
+  }
   if (m_receive_timeout_id != ola::thread::INVALID_TIMEOUT) {
     m_scheduler->RemoveTimeout(m_receive_timeout_id);
     m_receive_timeout_id = ola::thread::INVALID_TIMEOUT;
@@ -100,17 +143,38 @@ void HealthCheckedConnection::PauseTimer() {
  * Resume the receive timer
  */
 void HealthCheckedConnection::ResumeTimer() {
+  if (m_timer_wheel) {
+    if (!m_receive_timer->Scheduled())
+      m_timer_wheel->Schedule(m_receive_timer, m_timeout_interval);
+    return;
+  }
   if (m_receive_timeout_id == ola::thread::INVALID_TIMEOUT)
     UpdateReceiveTimer();
 }
 
 
+void HealthCheckedConnection::CreateTimers() {
+  m_send_timer = new ola::thread::TimerWheel::Timer(
+    NewCallback(this, &HealthCheckedConnection::SendHeartbeatFromWheel));
+  m_receive_timer = new ola::thread::TimerWheel::Timer(
+    NewCallback(this, &HealthCheckedConnection::HeartbeatTimeout));
+}
+
+
 bool HealthCheckedConnection::SendNextHeartbeat() {
   SendHeartbeat();
   return true;
 }
 
 
+void HealthCheckedConnection::SendHeartbeatFromWheel() {
+  // Schedule the next heartbeat first, SendHeartbeat() may call
+  // HeartbeatSent() itself.
+  m_timer_wheel->Schedule(m_send_timer, m_heartbeat_interval);
+  SendHeartbeat();
+}
+
+
 void HealthCheckedConnection::UpdateReceiveTimer() {
   m_receive_timeout_id = m_scheduler->RegisterSingleTimeout(
     m_timeout_interval,
@@ -27,6 +27,7 @@
 #include "ola/network/HealthCheckedConnection.h"
 #include "ola/network/Socket.h"
 #include "ola/testing/TestUtils.h"
+#include "ola/thread/TimerWheel.h"
 
 
 using ola::MockClock;
@@ -36,6 +37,7 @@ using ola::TimeInterval;
 using ola::network::HealthCheckedConnection;
 using ola::io::LoopbackDescriptor;
 using ola::io::SelectServer;
+using ola::thread::TimerWheel;
 
 
 class MockHealthCheckedConnection: public HealthCheckedConnection {
@@ -87,6 +89,25 @@ class MockHealthCheckedConnection: public HealthCheckedConnection {
           m_clock(clock) {
     }
 
+    MockHealthCheckedConnection(ola::io::ConnectedDescriptor *descriptor,
+                                SelectServer *scheduler,
+                                TimerWheel *timer_wheel,
+                                const ola::TimeInterval heartbeat_interval,
+                                const ola::TimeInterval timeout_interval,
+                                const Options &options,
+                                MockClock *clock)
+        : HealthCheckedConnection(timer_wheel,
+                                  heartbeat_interval,
+                                  timeout_interval),
+          m_descriptor(descriptor),
+          m_ss(scheduler),
+          m_options(options),
+          m_next_heartbeat(0),
+          m_expected_heartbeat(0),
+          m_channel_ok(true),
+          m_clock(clock) {
+    }
+
     void SendHeartbeat() {
       OLA_DEBUG << "Maybe send heartbeat";
       if (m_options.send_every == 0 ||
@@ -148,6 +169,8 @@ class HealthCheckedConnectionTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testChannelWithHeavyPacketLossLongerTimeout);
   CPPUNIT_TEST(testChannelWithVeryHeavyPacketLossLongerTimeout);
   CPPUNIT_TEST(testPauseAndResume);
+  CPPUNIT_TEST(testTimerWheel);
+  CPPUNIT_TEST(testTimerWheelWithHeavyPacketLoss);
   CPPUNIT_TEST_SUITE_END();
 
  public:
@@ -159,6 +182,8 @@ class HealthCheckedConnectionTest: public CppUnit::TestFixture {
     void testChannelWithHeavyPacketLossLongerTimeout();
     void testChannelWithVeryHeavyPacketLossLongerTimeout();
     void testPauseAndResume();
+    void testTimerWheel();
+    void testTimerWheelWithHeavyPacketLoss();
 
     void PauseReading(MockHealthCheckedConnection *connection) {
       connection->PauseTimer();
@@ -336,3 +361,54 @@ void HealthCheckedConnectionTest::testPauseAndResume() {
   m_ss.Run();
   OLA_ASSERT_TRUE(connection.ChannelOk());
 }
+
+
+/**
+ * Check the channel stays up when the heartbeats are scheduled on a
+ * TimerWheel.
+ */
+void HealthCheckedConnectionTest::testTimerWheel() {
+  options.validate_heartbeat = true;
+  TimerWheel wheel(&m_ss, TimeInterval(0, 50000));
+  MockHealthCheckedConnection connection(&socket,
+                                         &m_ss,
+                                         &wheel,
+                                         heartbeat_interval,
+                                         timeout_interval,
+                                         options,
+                                         &m_clock);
+
+  socket.SetOnData(
+      NewCallback(&connection, &MockHealthCheckedConnection::ReadData));
+  m_ss.AddReadDescriptor(&socket);
+  connection.Setup();
+  OLA_ASSERT_EQ(2u, wheel.Size());
+
+  m_ss.Run();
+  OLA_ASSERT_TRUE(connection.ChannelOk());
+}
+
+
+/**
+ * Check a TimerWheel connection fails when 2 of every 3 heartbeats are lost.
+ */
+void HealthCheckedConnectionTest::testTimerWheelWithHeavyPacketLoss() {
+  options.send_every = 3;
+  options.abort_on_failure = false;
+  TimerWheel wheel(&m_ss, TimeInterval(0, 50000));
+  MockHealthCheckedConnection connection(&socket,
+                                         &m_ss,
+                                         &wheel,
+                                         heartbeat_interval,
+                                         timeout_interval,
+                                         options,
+                                         &m_clock);
+
+  socket.SetOnData(
+      NewCallback(&connection, &MockHealthCheckedConnection::ReadData));
+  m_ss.AddReadDescriptor(&socket);
+  connection.Setup();
+
+  m_ss.Run();
+  OLA_ASSERT_FALSE(connection.ChannelOk());
+}
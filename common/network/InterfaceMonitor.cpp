@@ -0,0 +1,494 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * InterfaceMonitor.cpp
+ * Track the network interfaces as they change.
+ * Copyright (C) 2026 agent
+ */
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
+#include "ola/network/InterfaceMonitor.h"
+
+#include <string.h>
+
+#if defined(HAVE_LINUX_NETLINK_H) && defined(HAVE_LINUX_RTNETLINK_H)
+#include <net/if.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#endif  // defined(HAVE_LINUX_NETLINK_H) && defined(HAVE_LINUX_RTNETLINK_H)
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/network/NetlinkSource.h"
+#include "ola/Callback.h"
+#include "ola/Logging.h"
+#include "ola/network/NetworkUtils.h"
+
+namespace ola {
+namespace network {
+
+using ola::io::ByteString;
+using ola::thread::MutexLocker;
+using std::string;
+using std::vector;
+
+InterfaceMonitor::InterfaceMonitor(ola::io::SelectServerInterface *ss)
+    : m_ss(ss),
+      m_source(new NetlinkSocket(ss)),
+      m_live(false) {
+}
+
+InterfaceMonitor::InterfaceMonitor(ola::io::SelectServerInterface *ss,
+                                   NetlinkSource *source)
+    : m_ss(ss),
+      m_source(source),
+      m_live(false) {
+}
+
+InterfaceMonitor::~InterfaceMonitor() {
+  // Make sure the data callback doesn't outlive us.
+  m_source.reset();
+}
+
+bool InterfaceMonitor::Init() {
+#if defined(HAVE_LINUX_NETLINK_H) && defined(HAVE_LINUX_RTNETLINK_H)
+  if (m_source->Init() && Dump(RTM_GETLINK) && Dump(RTM_GETADDR)) {
+    UpdateInterfaces(false);
+    m_source->SetOnData(
+        NewCallback(this, &InterfaceMonitor::ReceiveMessages));
+    m_live = true;
+    OLA_INFO << "Tracking " << GetInterfaces(true).size()
+             << " interface(s) with netlink";
+    return true;
+  }
+#endif  // defined(HAVE_LINUX_NETLINK_H) && defined(HAVE_LINUX_RTNETLINK_H)
+
+  OLA_INFO << "Interface changes won't be tracked, using a snapshot";
+  m_source.reset();
+  m_links.clear();
+  m_addresses.clear();
+  std::auto_ptr<InterfacePicker> picker(InterfacePicker::NewPicker());
+  const vector<Interface> interfaces = picker->GetInterfaces(true);
+  MutexLocker locker(&m_mutex);
+  m_interfaces = interfaces;
+  return false;
+}
+
+vector<Interface> InterfaceMonitor::GetInterfaces(
+    bool include_loopback) const {
+  MutexLocker locker(&m_mutex);
+  if (include_loopback) {
+    return m_interfaces;
+  }
+
+  vector<Interface> interfaces;
+  vector<Interface>::const_iterator iter = m_interfaces.begin();
+  for (; iter != m_interfaces.end(); ++iter) {
+    if (!iter->loopback) {
+      interfaces.push_back(*iter);
+    }
+  }
+  return interfaces;
+}
+
+bool InterfaceMonitor::FollowInterface(const Interface &current,
+                                       const string &ip_or_name,
+                                       Interface *iface) const {
+  IPV4Address preferred_ip;
+  const bool has_preferred_ip = IPV4Address::FromString(ip_or_name,
+                                                        &preferred_ip);
+  const Interface *still_present = NULL;
+  const Interface *preferred = NULL;
+  const Interface *first = NULL;
+
+  MutexLocker locker(&m_mutex);
+  vector<Interface>::const_iterator iter = m_interfaces.begin();
+  for (; iter != m_interfaces.end(); ++iter) {
+    if (iter->name != current.name) {
+      continue;
+    }
+    if (!first) {
+      first = &(*iter);
+    }
+    if (iter->ip_address == current.ip_address) {
+      still_present = &(*iter);
+    }
+    if (has_preferred_ip && iter->ip_address == preferred_ip) {
+      preferred = &(*iter);
+    }
+  }
+
+  const Interface *chosen = preferred;
+  if (!chosen) {
+    // Stay on the current address while it's valid, otherwise take whatever
+    // the link has.
+    chosen = still_present ? still_present : first;
+  }
+  // The same address on a recreated link still needs the node to rebind.
+  if (!chosen ||
+      (chosen == still_present && chosen->index == current.index)) {
+    return false;
+  }
+  *iface = *chosen;
+  return true;
+}
+
+void InterfaceMonitor::AddObserver(InterfaceObserver *observer) {
+  MutexLocker locker(&m_mutex);
+  m_observers.insert(observer);
+}
+
+void InterfaceMonitor::RemoveObserver(InterfaceObserver *observer) {
+  MutexLocker locker(&m_mutex);
+  m_observers.erase(observer);
+}
+
+/*
+ * Request a dump and process the responses until the end of the dump.
+ */
+bool InterfaceMonitor::Dump(uint16_t message_type) {
+  if (!m_source->RequestDump(message_type)) {
+    return false;
+  }
+
+  ByteString datagram;
+  while (m_source->Receive(&datagram, true)) {
+    if (HandleDatagram(datagram)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/*
+ * Called when there are datagrams to read.
+ */
+void InterfaceMonitor::ReceiveMessages() {
+  ByteString datagram;
+  while (m_source->Receive(&datagram, false)) {
+    HandleDatagram(datagram);
+  }
+  if (m_source->CheckOverflow()) {
+    Resync();
+  }
+  UpdateInterfaces(true);
+}
+
+/*
+ * Called when the kernel dropped notifications. Rebuild the link & address
+ * tables from a fresh dump, UpdateInterfaces() then works out what changed.
+ */
+void InterfaceMonitor::Resync() {
+#if defined(HAVE_LINUX_NETLINK_H) && defined(HAVE_LINUX_RTNETLINK_H)
+  OLA_INFO << "Netlink notifications were dropped, requesting a new dump";
+  LinkMap links;
+  AddressList addresses;
+  links.swap(m_links);
+  addresses.swap(m_addresses);
+  if (!(Dump(RTM_GETLINK) && Dump(RTM_GETADDR))) {
+    // Keep the old tables rather than reporting every interface as removed.
+    OLA_WARN << "Failed to dump the interfaces after a netlink overflow";
+    m_links.swap(links);
+    m_addresses.swap(addresses);
+  }
+#endif  // defined(HAVE_LINUX_NETLINK_H) && defined(HAVE_LINUX_RTNETLINK_H)
+}
+
+/*
+ * Rebuild the interface list from the link & address tables, and if notify is
+ * true tell the observers what changed.
+ */
+void InterfaceMonitor::UpdateInterfaces(bool notify) {
+  vector<Interface> interfaces;
+  AddressList::const_iterator address = m_addresses.begin();
+  for (; address != m_addresses.end(); ++address) {
+    LinkMap::const_iterator link = m_links.find(address->index);
+    if (link == m_links.end() || !link->second.up) {
+      continue;
+    }
+    // Aliases like eth0:1 have their own label.
+    interfaces.push_back(Interface(
+        address->label.empty() ? link->second.name : address->label,
+        address->ip_address,
+        address->bcast_address,
+        address->subnet_mask,
+        link->second.hw_address,
+        link->second.loopback,
+        address->index,
+        link->second.type));
+  }
+
+  vector<Interface> removed, added;
+  std::set<InterfaceObserver*> observers;
+  {
+    MutexLocker locker(&m_mutex);
+    vector<Interface>::const_iterator iter = m_interfaces.begin();
+    for (; iter != m_interfaces.end(); ++iter) {
+      if (std::find(interfaces.begin(), interfaces.end(), *iter) ==
+          interfaces.end()) {
+        removed.push_back(*iter);
+      }
+    }
+    for (iter = interfaces.begin(); iter != interfaces.end(); ++iter) {
+      if (std::find(m_interfaces.begin(), m_interfaces.end(), *iter) ==
+          m_interfaces.end()) {
+        added.push_back(*iter);
+      }
+    }
+    m_interfaces = interfaces;
+    // The observers are run without the lock held, so they can call back into
+    // the monitor.
+    observers = m_observers;
+  }
+
+  if (!notify) {
+    return;
+  }
+
+  vector<Interface>::const_iterator if_iter;
+  std::set<InterfaceObserver*>::const_iterator observer;
+  for (if_iter = removed.begin(); if_iter != removed.end(); ++if_iter) {
+    OLA_INFO << "Interface removed: " << *if_iter;
+    for (observer = observers.begin(); observer != observers.end();
+         ++observer) {
+      (*observer)->InterfaceRemoved(*if_iter);
+    }
+  }
+  for (if_iter = added.begin(); if_iter != added.end(); ++if_iter) {
+    OLA_INFO << "Interface added: " << *if_iter;
+    for (observer = observers.begin(); observer != observers.end();
+         ++observer) {
+      (*observer)->InterfaceAdded(*if_iter);
+    }
+  }
+}
+
+#if defined(HAVE_LINUX_NETLINK_H) && defined(HAVE_LINUX_RTNETLINK_H)
+namespace {
+
+typedef std::map<uint16_t, ByteString> AttributeMap;
+
+/*
+ * Split a block of rtattrs into a map of type to payload.
+ */
+void ParseAttributes(const uint8_t *data, unsigned int length,
+                     AttributeMap *attributes) {
+  while (length >= sizeof(struct rtattr)) {
+    struct rtattr attribute;
+    memcpy(&attribute, data, sizeof(attribute));
+    if (attribute.rta_len < sizeof(attribute) ||
+        attribute.rta_len > length) {
+      OLA_WARN << "Truncated netlink attribute";
+      return;
+    }
+    (*attributes)[attribute.rta_type] = ByteString(
+        data + RTA_LENGTH(0), attribute.rta_len - RTA_LENGTH(0));
+    const unsigned int aligned = RTA_ALIGN(attribute.rta_len);
+    if (aligned >= length) {
+      return;
+    }
+    data += aligned;
+    length -= aligned;
+  }
+}
+
+string AttributeToString(const AttributeMap &attributes, uint16_t type) {
+  AttributeMap::const_iterator iter = attributes.find(type);
+  if (iter == attributes.end()) {
+    return "";
+  }
+  const ByteString &value = iter->second;
+  return string(reinterpret_cast<const char*>(value.data()),
+                strnlen(reinterpret_cast<const char*>(value.data()),
+                        value.size()));
+}
+
+bool AttributeToIPV4Address(const AttributeMap &attributes, uint16_t type,
+                            IPV4Address *address) {
+  AttributeMap::const_iterator iter = attributes.find(type);
+  if (iter == attributes.end() || iter->second.size() != IPV4Address::LENGTH) {
+    return false;
+  }
+  uint32_t value;
+  memcpy(&value, iter->second.data(), sizeof(value));
+  *address = IPV4Address(value);
+  return true;
+}
+}  // namespace
+
+/*
+ * Process the messages in a datagram.
+ * @returns true if the datagram ended a dump.
+ */
+bool InterfaceMonitor::HandleDatagram(const ByteString &datagram) {
+  unsigned int offset = 0;
+  while (datagram.size() - offset >= sizeof(struct nlmsghdr)) {
+    struct nlmsghdr header;
+    memcpy(&header, datagram.data() + offset, sizeof(header));
+    if (header.nlmsg_len < sizeof(header) ||
+        header.nlmsg_len > datagram.size() - offset) {
+      OLA_WARN << "Truncated netlink message";
+      return false;
+    }
+
+    const uint8_t *payload = datagram.data() + offset + NLMSG_HDRLEN;
+    const unsigned int payload_length = header.nlmsg_len - NLMSG_HDRLEN;
+    switch (header.nlmsg_type) {
+      case NLMSG_DONE:
+        return true;
+      case NLMSG_ERROR:
+        OLA_WARN << "Netlink returned an error";
+        return true;
+      case RTM_NEWLINK:
+      case RTM_DELLINK:
+        HandleLinkMessage(header.nlmsg_type, payload, payload_length);
+        break;
+      case RTM_NEWADDR:
+      case RTM_DELADDR:
+        HandleAddressMessage(header.nlmsg_type, payload, payload_length);
+        break;
+      default:
+        break;
+    }
+    offset += NLMSG_ALIGN(header.nlmsg_len);
+    if (offset >= datagram.size()) {
+      break;
+    }
+  }
+  return false;
+}
+
+void InterfaceMonitor::HandleLinkMessage(uint16_t message_type,
+                                         const uint8_t *data,
+                                         unsigned int length) {
+  struct ifinfomsg info;
+  if (length < sizeof(info)) {
+    return;
+  }
+  memcpy(&info, data, sizeof(info));
+  const int32_t index = info.ifi_index;
+
+  if (message_type == RTM_DELLINK) {
+    m_links.erase(index);
+    AddressList::iterator iter = m_addresses.begin();
+    while (iter != m_addresses.end()) {
+      if (iter->index == index) {
+        iter = m_addresses.erase(iter);
+      } else {
+        ++iter;
+      }
+    }
+    return;
+  }
+
+  AttributeMap attributes;
+  const unsigned int header_length = NLMSG_ALIGN(sizeof(info));
+  if (length > header_length) {
+    ParseAttributes(data + header_length, length - header_length,
+                    &attributes);
+  }
+
+  LinkState &link = m_links[index];
+  const string name = AttributeToString(attributes, IFLA_IFNAME);
+  if (!name.empty()) {
+    link.name = name;
+  }
+  AttributeMap::const_iterator hw_address = attributes.find(IFLA_ADDRESS);
+  if (hw_address != attributes.end() &&
+      hw_address->second.size() == MACAddress::LENGTH) {
+    link.hw_address = MACAddress(hw_address->second.data());
+  }
+  link.up = info.ifi_flags & IFF_UP;
+  link.loopback = info.ifi_flags & IFF_LOOPBACK;
+  link.type = info.ifi_type;
+}
+
+void InterfaceMonitor::HandleAddressMessage(uint16_t message_type,
+                                            const uint8_t *data,
+                                            unsigned int length) {
+  struct ifaddrmsg info;
+  if (length < sizeof(info)) {
+    return;
+  }
+  memcpy(&info, data, sizeof(info));
+  if (info.ifa_family != AF_INET) {
+    return;
+  }
+
+  AttributeMap attributes;
+  const unsigned int header_length = NLMSG_ALIGN(sizeof(info));
+  if (length > header_length) {
+    ParseAttributes(data + header_length, length - header_length,
+                    &attributes);
+  }
+
+  AddressState address;
+  address.index = info.ifa_index;
+  // For point-to-point links IFA_ADDRESS is the remote end.
+  if (!AttributeToIPV4Address(attributes, IFA_LOCAL, &address.ip_address) &&
+      !AttributeToIPV4Address(attributes, IFA_ADDRESS,
+                              &address.ip_address)) {
+    return;
+  }
+  AttributeToIPV4Address(attributes, IFA_BROADCAST, &address.bcast_address);
+  address.label = AttributeToString(attributes, IFA_LABEL);
+  const unsigned int prefix = std::min(
+      static_cast<unsigned int>(info.ifa_prefixlen), 32u);
+  address.subnet_mask = IPV4Address(
+      prefix ? HostToNetwork(0xffffffffu << (32 - prefix)) : 0);
+
+  AddressList::iterator iter = m_addresses.begin();
+  for (; iter != m_addresses.end(); ++iter) {
+    if (iter->index == address.index &&
+        iter->ip_address == address.ip_address) {
+      break;
+    }
+  }
+
+  if (message_type == RTM_DELADDR) {
+    if (iter != m_addresses.end()) {
+      m_addresses.erase(iter);
+    }
+  } else if (iter != m_addresses.end()) {
+    *iter = address;
+  } else {
+    m_addresses.push_back(address);
+  }
+}
+#else
+bool InterfaceMonitor::HandleDatagram(OLA_UNUSED const ByteString &datagram) {
+  return false;
+}
+
+void InterfaceMonitor::HandleLinkMessage(OLA_UNUSED uint16_t message_type,
+                                         OLA_UNUSED const uint8_t *data,
+                                         OLA_UNUSED unsigned int length) {
+}
+
+void InterfaceMonitor::HandleAddressMessage(OLA_UNUSED uint16_t message_type,
+                                            OLA_UNUSED const uint8_t *data,
+                                            OLA_UNUSED unsigned int length) {
+}
+#endif  // defined(HAVE_LINUX_NETLINK_H) && defined(HAVE_LINUX_RTNETLINK_H)
+}  // namespace network
+}  // namespace ola
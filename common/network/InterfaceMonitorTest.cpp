@@ -0,0 +1,374 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * InterfaceMonitorTest.cpp
+ * Test fixture for the InterfaceMonitor class.
+ * Copyright (C) 2026 agent
+ */
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/network/FakeNetlinkSource.h"
+#include "ola/io/SelectServer.h"
+#include "ola/network/InterfaceMonitor.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::io::ByteString;
+using ola::network::IPV4Address;
+using ola::network::Interface;
+using ola::network::InterfaceMonitor;
+using ola::network::InterfaceObserver;
+using ola::network::MACAddress;
+using std::string;
+using std::vector;
+
+#if defined(HAVE_LINUX_NETLINK_H) && defined(HAVE_LINUX_RTNETLINK_H)
+using ola::network::FakeNetlinkSource;
+
+namespace {
+
+class MockObserver : public InterfaceObserver {
+ public:
+  void InterfaceAdded(const Interface &iface) {
+    added.push_back(iface);
+  }
+
+  void InterfaceRemoved(const Interface &iface) {
+    removed.push_back(iface);
+  }
+
+  void Reset() {
+    added.clear();
+    removed.clear();
+  }
+
+  vector<Interface> added;
+  vector<Interface> removed;
+};
+}  // namespace
+#endif  // defined(HAVE_LINUX_NETLINK_H) && defined(HAVE_LINUX_RTNETLINK_H)
+
+class InterfaceMonitorTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(InterfaceMonitorTest);
+#if defined(HAVE_LINUX_NETLINK_H) && defined(HAVE_LINUX_RTNETLINK_H)
+  CPPUNIT_TEST(testDump);
+  CPPUNIT_TEST(testChanges);
+  CPPUNIT_TEST(testOverflow);
+  CPPUNIT_TEST(testFollowInterface);
+  CPPUNIT_TEST(testFallback);
+#endif  // defined(HAVE_LINUX_NETLINK_H) && defined(HAVE_LINUX_RTNETLINK_H)
+  CPPUNIT_TEST(testSystemInterfaces);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void setUp();
+
+#if defined(HAVE_LINUX_NETLINK_H) && defined(HAVE_LINUX_RTNETLINK_H)
+  void testDump();
+  void testChanges();
+  void testOverflow();
+  void testFollowInterface();
+  void testFallback();
+#endif  // defined(HAVE_LINUX_NETLINK_H) && defined(HAVE_LINUX_RTNETLINK_H)
+  void testSystemInterfaces();
+
+ private:
+  MACAddress m_mac1, m_mac2;
+  IPV4Address m_ip1, m_ip2, m_ip3, m_bcast;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(InterfaceMonitorTest);
+
+void InterfaceMonitorTest::setUp() {
+  MACAddress::FromString("01:23:45:67:89:ab", &m_mac1);
+  MACAddress::FromString("01:23:45:67:89:ac", &m_mac2);
+  IPV4Address::FromString("10.0.0.1", &m_ip1);
+  IPV4Address::FromString("10.0.0.2", &m_ip2);
+  IPV4Address::FromString("10.0.0.3", &m_ip3);
+  IPV4Address::FromString("10.0.0.255", &m_bcast);
+}
+
+#if defined(HAVE_LINUX_NETLINK_H) && defined(HAVE_LINUX_RTNETLINK_H)
+/*
+ * Check the table is populated from the initial dump.
+ */
+void InterfaceMonitorTest::testDump() {
+  FakeNetlinkSource *source = new FakeNetlinkSource();
+  ByteString links, addresses;
+  FakeNetlinkSource::AppendLink(&links, RTM_NEWLINK, 1, "lo",
+                                MACAddress(), IFF_UP | IFF_LOOPBACK);
+  FakeNetlinkSource::AppendLink(&links, RTM_NEWLINK, 2, "eth0", m_mac1,
+                                IFF_UP);
+  FakeNetlinkSource::AppendLink(&links, RTM_NEWLINK, 3, "eth1", m_mac2, 0);
+  FakeNetlinkSource::AppendAddress(&addresses, RTM_NEWADDR, 1,
+                                   IPV4Address::Loopback(), 8,
+                                   IPV4Address());
+  FakeNetlinkSource::AppendAddress(&addresses, RTM_NEWADDR, 2, m_ip1, 24,
+                                   m_bcast);
+  FakeNetlinkSource::AppendAddress(&addresses, RTM_NEWADDR, 3, m_ip2, 24,
+                                   m_bcast);
+  source->SetDump(RTM_GETLINK, links);
+  source->SetDump(RTM_GETADDR, addresses);
+
+  InterfaceMonitor monitor(NULL, source);
+  OLA_ASSERT_TRUE(monitor.Init());
+  OLA_ASSERT_TRUE(monitor.IsLive());
+
+  // eth1 is down
+  OLA_ASSERT_EQ(static_cast<size_t>(2), monitor.GetInterfaces(true).size());
+  vector<Interface> interfaces = monitor.GetInterfaces(false);
+  OLA_ASSERT_EQ(static_cast<size_t>(1), interfaces.size());
+
+  Interface expected("eth0", m_ip1, m_bcast,
+                     IPV4Address::FromStringOrDie("255.255.255.0"), m_mac1,
+                     false, 2, 1);
+  OLA_ASSERT_EQ(expected, interfaces[0]);
+
+  Interface iface;
+  OLA_ASSERT_TRUE(monitor.ChooseInterface(&iface, "eth0"));
+  OLA_ASSERT_EQ(expected, iface);
+  OLA_ASSERT_TRUE(monitor.ChooseInterface(&iface, 2));
+  OLA_ASSERT_EQ(expected, iface);
+}
+
+/*
+ * Check changes are reported to the observers.
+ */
+void InterfaceMonitorTest::testChanges() {
+  FakeNetlinkSource *source = new FakeNetlinkSource();
+  ByteString links, addresses;
+  FakeNetlinkSource::AppendLink(&links, RTM_NEWLINK, 2, "eth0", m_mac1,
+                                IFF_UP);
+  FakeNetlinkSource::AppendAddress(&addresses, RTM_NEWADDR, 2, m_ip1, 24,
+                                   m_bcast);
+  source->SetDump(RTM_GETLINK, links);
+  source->SetDump(RTM_GETADDR, addresses);
+
+  InterfaceMonitor monitor(NULL, source);
+  MockObserver observer;
+  monitor.AddObserver(&observer);
+  OLA_ASSERT_TRUE(monitor.Init());
+  // The initial dump isn't reported.
+  OLA_ASSERT_TRUE(observer.added.empty());
+
+  // Bring up a second link, this isn't an interface until it has an address.
+  ByteString datagram;
+  FakeNetlinkSource::AppendLink(&datagram, RTM_NEWLINK, 3, "eth1", m_mac2,
+                                IFF_UP);
+  source->Inject(datagram);
+  OLA_ASSERT_TRUE(observer.added.empty());
+
+  datagram.clear();
+  FakeNetlinkSource::AppendAddress(&datagram, RTM_NEWADDR, 3, m_ip2, 24,
+                                   m_bcast);
+  source->Inject(datagram);
+  OLA_ASSERT_EQ(static_cast<size_t>(1), observer.added.size());
+  OLA_ASSERT_TRUE(observer.removed.empty());
+  OLA_ASSERT_EQ(string("eth1"), observer.added[0].name);
+  OLA_ASSERT_EQ(m_ip2, observer.added[0].ip_address);
+  OLA_ASSERT_EQ(static_cast<size_t>(2), monitor.GetInterfaces(false).size());
+
+  // Re-address eth0, this is reported as a removal and an addition.
+  observer.Reset();
+  datagram.clear();
+  FakeNetlinkSource::AppendAddress(&datagram, RTM_DELADDR, 2, m_ip1, 24,
+                                   m_bcast);
+  FakeNetlinkSource::AppendAddress(&datagram, RTM_NEWADDR, 2, m_ip3, 24,
+                                   m_bcast);
+  source->Inject(datagram);
+  OLA_ASSERT_EQ(static_cast<size_t>(1), observer.removed.size());
+  OLA_ASSERT_EQ(m_ip1, observer.removed[0].ip_address);
+  OLA_ASSERT_EQ(static_cast<size_t>(1), observer.added.size());
+  OLA_ASSERT_EQ(m_ip3, observer.added[0].ip_address);
+  OLA_ASSERT_EQ(string("eth0"), observer.added[0].name);
+
+  // Take eth1 down.
+  observer.Reset();
+  datagram.clear();
+  FakeNetlinkSource::AppendLink(&datagram, RTM_NEWLINK, 3, "eth1", m_mac2, 0);
+  source->Inject(datagram);
+  OLA_ASSERT_TRUE(observer.added.empty());
+  OLA_ASSERT_EQ(static_cast<size_t>(1), observer.removed.size());
+  OLA_ASSERT_EQ(string("eth1"), observer.removed[0].name);
+
+  // Remove eth0 entirely.
+  observer.Reset();
+  datagram.clear();
+  FakeNetlinkSource::AppendLink(&datagram, RTM_DELLINK, 2, "eth0", m_mac1, 0);
+  source->Inject(datagram);
+  OLA_ASSERT_EQ(static_cast<size_t>(1), observer.removed.size());
+  OLA_ASSERT_TRUE(monitor.GetInterfaces(true).empty());
+
+  // Once removed, the observer isn't notified.
+  monitor.RemoveObserver(&observer);
+  observer.Reset();
+  datagram.clear();
+  FakeNetlinkSource::AppendLink(&datagram, RTM_NEWLINK, 3, "eth1", m_mac2,
+                                IFF_UP);
+  source->Inject(datagram);
+  OLA_ASSERT_TRUE(observer.added.empty());
+  OLA_ASSERT_EQ(static_cast<size_t>(1), monitor.GetInterfaces(true).size());
+}
+
+/*
+ * Check the table is rebuilt when the kernel drops notifications.
+ */
+void InterfaceMonitorTest::testOverflow() {
+  FakeNetlinkSource *source = new FakeNetlinkSource();
+  ByteString links, addresses;
+  FakeNetlinkSource::AppendLink(&links, RTM_NEWLINK, 2, "eth0", m_mac1,
+                                IFF_UP);
+  FakeNetlinkSource::AppendLink(&links, RTM_NEWLINK, 3, "eth1", m_mac2,
+                                IFF_UP);
+  FakeNetlinkSource::AppendAddress(&addresses, RTM_NEWADDR, 2, m_ip1, 24,
+                                   m_bcast);
+  FakeNetlinkSource::AppendAddress(&addresses, RTM_NEWADDR, 3, m_ip2, 24,
+                                   m_bcast);
+  source->SetDump(RTM_GETLINK, links);
+  source->SetDump(RTM_GETADDR, addresses);
+
+  InterfaceMonitor monitor(NULL, source);
+  MockObserver observer;
+  monitor.AddObserver(&observer);
+  OLA_ASSERT_TRUE(monitor.Init());
+  OLA_ASSERT_EQ(2u, source->DumpCount());
+  OLA_ASSERT_EQ(static_cast<size_t>(2), monitor.GetInterfaces(false).size());
+
+  // While the notifications were lost, eth0 moved to a new address and eth1
+  // went away.
+  links.clear();
+  addresses.clear();
+  FakeNetlinkSource::AppendLink(&links, RTM_NEWLINK, 2, "eth0", m_mac1,
+                                IFF_UP);
+  FakeNetlinkSource::AppendAddress(&addresses, RTM_NEWADDR, 2, m_ip3, 24,
+                                   m_bcast);
+  source->SetDump(RTM_GETLINK, links);
+  source->SetDump(RTM_GETADDR, addresses);
+  source->Overflow();
+
+  OLA_ASSERT_EQ(4u, source->DumpCount());
+  OLA_ASSERT_EQ(static_cast<size_t>(2), observer.removed.size());
+  OLA_ASSERT_EQ(m_ip1, observer.removed[0].ip_address);
+  OLA_ASSERT_EQ(m_ip2, observer.removed[1].ip_address);
+  OLA_ASSERT_EQ(static_cast<size_t>(1), observer.added.size());
+  OLA_ASSERT_EQ(m_ip3, observer.added[0].ip_address);
+  OLA_ASSERT_EQ(string("eth0"), observer.added[0].name);
+
+  vector<Interface> interfaces = monitor.GetInterfaces(false);
+  OLA_ASSERT_EQ(static_cast<size_t>(1), interfaces.size());
+  OLA_ASSERT_EQ(m_ip3, interfaces[0].ip_address);
+
+  // A resync that finds nothing new doesn't notify anyone.
+  observer.Reset();
+  source->Overflow();
+  OLA_ASSERT_EQ(6u, source->DumpCount());
+  OLA_ASSERT_TRUE(observer.added.empty());
+  OLA_ASSERT_TRUE(observer.removed.empty());
+}
+
+/*
+ * Check nodes only move when their address goes, or the configured address
+ * appears.
+ */
+void InterfaceMonitorTest::testFollowInterface() {
+  FakeNetlinkSource *source = new FakeNetlinkSource();
+  ByteString links, addresses;
+  FakeNetlinkSource::AppendLink(&links, RTM_NEWLINK, 2, "eth0", m_mac1,
+                                IFF_UP);
+  FakeNetlinkSource::AppendAddress(&addresses, RTM_NEWADDR, 2, m_ip1, 24,
+                                   m_bcast);
+  source->SetDump(RTM_GETLINK, links);
+  source->SetDump(RTM_GETADDR, addresses);
+
+  InterfaceMonitor monitor(NULL, source);
+  OLA_ASSERT_TRUE(monitor.Init());
+  Interface current;
+  OLA_ASSERT_TRUE(monitor.ChooseInterface(&current, "eth0"));
+  OLA_ASSERT_EQ(m_ip1, current.ip_address);
+
+  // A secondary address doesn't move the node.
+  ByteString datagram;
+  FakeNetlinkSource::AppendAddress(&datagram, RTM_NEWADDR, 2, m_ip2, 24,
+                                   m_bcast);
+  source->Inject(datagram);
+  Interface iface;
+  OLA_ASSERT_FALSE(monitor.FollowInterface(current, "", &iface));
+  OLA_ASSERT_FALSE(monitor.FollowInterface(current, "eth0", &iface));
+  OLA_ASSERT_FALSE(monitor.FollowInterface(current, m_ip1.ToString(),
+                                           &iface));
+
+  // Unless it's the address the node was configured with.
+  OLA_ASSERT_TRUE(monitor.FollowInterface(current, m_ip2.ToString(),
+                                          &iface));
+  OLA_ASSERT_EQ(m_ip2, iface.ip_address);
+
+  // Once the current address goes, the node moves to the preferred address
+  // if there is one, otherwise to another address on the link.
+  datagram.clear();
+  FakeNetlinkSource::AppendAddress(&datagram, RTM_NEWADDR, 2, m_ip3, 24,
+                                   m_bcast);
+  FakeNetlinkSource::AppendAddress(&datagram, RTM_DELADDR, 2, m_ip1, 24,
+                                   m_bcast);
+  source->Inject(datagram);
+  OLA_ASSERT_TRUE(monitor.FollowInterface(current, m_ip3.ToString(),
+                                          &iface));
+  OLA_ASSERT_EQ(m_ip3, iface.ip_address);
+  OLA_ASSERT_TRUE(monitor.FollowInterface(current, "", &iface));
+  OLA_ASSERT_EQ(m_ip2, iface.ip_address);
+  OLA_ASSERT_EQ(string("eth0"), iface.name);
+
+  // With no addresses left there's nowhere to go.
+  datagram.clear();
+  FakeNetlinkSource::AppendAddress(&datagram, RTM_DELADDR, 2, m_ip2, 24,
+                                   m_bcast);
+  FakeNetlinkSource::AppendAddress(&datagram, RTM_DELADDR, 2, m_ip3, 24,
+                                   m_bcast);
+  source->Inject(datagram);
+  OLA_ASSERT_FALSE(monitor.FollowInterface(current, "", &iface));
+}
+
+/*
+ * Check we fall back to a snapshot if netlink isn't available.
+ */
+void InterfaceMonitorTest::testFallback() {
+  FakeNetlinkSource *source = new FakeNetlinkSource();
+  source->SetInitResult(false);
+  InterfaceMonitor monitor(NULL, source);
+  OLA_ASSERT_FALSE(monitor.Init());
+  OLA_ASSERT_FALSE(monitor.IsLive());
+  OLA_ASSERT_GT(monitor.GetInterfaces(true).size(), 0);
+}
+#endif  // defined(HAVE_LINUX_NETLINK_H) && defined(HAVE_LINUX_RTNETLINK_H)
+
+/*
+ * Check the monitor finds the same interfaces as the InterfacePicker.
+ */
+void InterfaceMonitorTest::testSystemInterfaces() {
+  ola::io::SelectServer ss;
+  InterfaceMonitor monitor(&ss);
+  monitor.Init();
+
+  std::auto_ptr<ola::network::InterfacePicker> picker(
+      ola::network::InterfacePicker::NewPicker());
+  OLA_ASSERT_EQ(picker->GetInterfaces(true).size(),
+                monitor.GetInterfaces(true).size());
+}
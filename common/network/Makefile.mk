@@ -3,13 +3,17 @@
 common_libolacommon_la_SOURCES += \
     common/network/AdvancedTCPConnector.cpp \
     common/network/FakeInterfacePicker.h \
+    common/network/FakeNetlinkSource.h \
     common/network/HealthCheckedConnection.cpp \
     common/network/IPV4Address.cpp \
     common/network/IPV6Address.cpp \
     common/network/Interface.cpp \
+    common/network/InterfaceMonitor.cpp \
     common/network/InterfacePicker.cpp \
     common/network/MACAddress.cpp \
     common/network/NetworkUtils.cpp \
+    common/network/NetlinkSource.cpp \
+    common/network/NetlinkSource.h \
     common/network/NetworkUtilsInternal.h \
     common/network/Socket.cpp \
     common/network/SocketAddress.cpp \
@@ -46,6 +50,7 @@ common_network_HealthCheckedConnectionTester_LDADD = $(COMMON_TESTING_LIBS)
 common_network_NetworkTester_SOURCES = \
     common/network/IPV4AddressTest.cpp \
     common/network/IPV6AddressTest.cpp \
+    common/network/InterfaceMonitorTest.cpp \
     common/network/InterfacePickerTest.cpp \
     common/network/InterfaceTest.cpp \
     common/network/MACAddressTest.cpp \
@@ -0,0 +1,213 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * NetlinkSource.cpp
+ * Where the InterfaceMonitor gets its routing messages from.
+ * Copyright (C) 2026 agent
+ */
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
+#include "common/network/NetlinkSource.h"
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+
+#if defined(HAVE_LINUX_NETLINK_H) && defined(HAVE_LINUX_RTNETLINK_H)
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#endif  // defined(HAVE_LINUX_NETLINK_H) && defined(HAVE_LINUX_RTNETLINK_H)
+
+#include "ola/Logging.h"
+
+namespace ola {
+namespace network {
+
+using ola::io::ByteString;
+using ola::io::UnmanagedFileDescriptor;
+
+NetlinkSocket::NetlinkSocket(ola::io::SelectServerInterface *ss)
+    : m_ss(ss),
+      m_sequence(0),
+      m_registered(false),
+      m_overflowed(false) {
+}
+
+NetlinkSocket::~NetlinkSocket() {
+  if (m_descriptor.get()) {
+    if (m_registered) {
+      m_ss->RemoveReadDescriptor(m_descriptor.get());
+    }
+    close(m_descriptor->ReadDescriptor());
+  }
+}
+
+#if defined(HAVE_LINUX_NETLINK_H) && defined(HAVE_LINUX_RTNETLINK_H)
+bool NetlinkSocket::Available() {
+  return true;
+}
+
+bool NetlinkSocket::Init() {
+  if (m_descriptor.get()) {
+    return false;
+  }
+
+  int fd = socket(AF_NETLINK, SOCK_RAW, NETLINK_ROUTE);
+  if (fd < 0) {
+    OLA_WARN << "Failed to create netlink socket: " << strerror(errno);
+    return false;
+  }
+
+  struct sockaddr_nl address;
+  memset(&address, 0, sizeof(address));
+  address.nl_family = AF_NETLINK;
+  address.nl_groups = RTMGRP_LINK | RTMGRP_IPV4_IFADDR;
+  if (bind(fd, reinterpret_cast<struct sockaddr*>(&address),
+           sizeof(address)) < 0) {
+    OLA_WARN << "Failed to bind netlink socket: " << strerror(errno);
+    close(fd);
+    return false;
+  }
+
+  int flags = fcntl(fd, F_GETFL, 0);
+  if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0) {
+    OLA_WARN << "Failed to make netlink socket non-blocking: "
+             << strerror(errno);
+    close(fd);
+    return false;
+  }
+
+  m_descriptor.reset(new UnmanagedFileDescriptor(fd));
+  return true;
+}
+
+bool NetlinkSocket::RequestDump(uint16_t message_type) {
+  if (!m_descriptor.get()) {
+    return false;
+  }
+
+  struct {
+    struct nlmsghdr header;
+    struct rtgenmsg message;
+  } request;
+  memset(&request, 0, sizeof(request));
+  request.header.nlmsg_len = NLMSG_LENGTH(sizeof(request.message));
+  request.header.nlmsg_type = message_type;
+  request.header.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+  request.header.nlmsg_seq = ++m_sequence;
+  request.message.rtgen_family = AF_PACKET;
+  if (message_type == RTM_GETADDR) {
+    request.message.rtgen_family = AF_INET;
+  }
+
+  struct sockaddr_nl kernel;
+  memset(&kernel, 0, sizeof(kernel));
+  kernel.nl_family = AF_NETLINK;
+
+  if (sendto(m_descriptor->ReadDescriptor(), &request,
+             request.header.nlmsg_len, 0,
+             reinterpret_cast<struct sockaddr*>(&kernel),
+             sizeof(kernel)) < 0) {
+    OLA_WARN << "Failed to send netlink request: " << strerror(errno);
+    return false;
+  }
+  return true;
+}
+
+bool NetlinkSocket::Receive(ByteString *datagram, bool wait) {
+  if (!m_descriptor.get()) {
+    return false;
+  }
+  const int fd = m_descriptor->ReadDescriptor();
+
+  if (wait) {
+    struct pollfd poll_fd;
+    poll_fd.fd = fd;
+    poll_fd.events = POLLIN;
+    poll_fd.revents = 0;
+    if (poll(&poll_fd, 1, DUMP_TIMEOUT_MS) <= 0) {
+      OLA_WARN << "Timed out waiting for a netlink response";
+      return false;
+    }
+  }
+
+  datagram->resize(RECEIVE_BUFFER_SIZE);
+  ssize_t r = recv(fd, &(*datagram)[0], datagram->size(), 0);
+  if (r < 0) {
+    if (errno == ENOBUFS) {
+      // The kernel dropped messages, the monitor will be out of sync.
+      OLA_WARN << "Netlink receive buffer overflowed";
+      m_overflowed = true;
+    } else if (errno != EAGAIN && errno != EWOULDBLOCK) {
+      OLA_WARN << "Netlink recv failed: " << strerror(errno);
+    }
+    datagram->clear();
+    return false;
+  }
+  datagram->resize(r);
+  return true;
+}
+
+bool NetlinkSocket::CheckOverflow() {
+  const bool overflowed = m_overflowed;
+  m_overflowed = false;
+  return overflowed;
+}
+
+void NetlinkSocket::SetOnData(Callback0<void> *on_data) {
+  if (!m_descriptor.get()) {
+    delete on_data;
+    return;
+  }
+
+  m_descriptor->SetOnData(on_data);
+  if (!m_registered) {
+    m_registered = m_ss->AddReadDescriptor(m_descriptor.get());
+  }
+}
+#else
+bool NetlinkSocket::Available() {
+  return false;
+}
+
+bool NetlinkSocket::Init() {
+  return false;
+}
+
+bool NetlinkSocket::RequestDump(OLA_UNUSED uint16_t message_type) {
+  return false;
+}
+
+bool NetlinkSocket::Receive(OLA_UNUSED ByteString *datagram,
+                            OLA_UNUSED bool wait) {
+  return false;
+}
+
+bool NetlinkSocket::CheckOverflow() {
+  return false;
+}
+
+void NetlinkSocket::SetOnData(Callback0<void> *on_data) {
+  delete on_data;
+}
+#endif  // defined(HAVE_LINUX_NETLINK_H) && defined(HAVE_LINUX_RTNETLINK_H)
+}  // namespace network
+}  // namespace ola
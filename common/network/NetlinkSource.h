@@ -0,0 +1,113 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * NetlinkSource.h
+ * Where the InterfaceMonitor gets its routing messages from.
+ * Copyright (C) 2026 agent
+ */
+
+#ifndef COMMON_NETWORK_NETLINKSOURCE_H_
+#define COMMON_NETWORK_NETLINKSOURCE_H_
+
+#include <stdint.h>
+#include <ola/Callback.h>
+#include <ola/base/Macro.h>
+#include <ola/io/ByteString.h>
+#include <ola/io/Descriptor.h>
+#include <ola/io/SelectServerInterface.h>
+
+#include <memory>
+
+namespace ola {
+namespace network {
+
+/**
+ * @brief A source of rtnetlink messages.
+ *
+ * This is split out from the InterfaceMonitor so the tests can provide the
+ * messages.
+ */
+class NetlinkSource {
+ public:
+  virtual ~NetlinkSource() {}
+
+  /**
+   * @brief Open the source and subscribe to link and IPv4 address changes.
+   */
+  virtual bool Init() = 0;
+
+  /**
+   * @brief Ask for a dump of the current state.
+   * @param message_type either RTM_GETLINK or RTM_GETADDR.
+   */
+  virtual bool RequestDump(uint16_t message_type) = 0;
+
+  /**
+   * @brief Receive a datagram.
+   * @param[out] datagram the data received, this may hold several messages.
+   * @param wait true to wait for a datagram to arrive.
+   * @returns true if a datagram was received.
+   */
+  virtual bool Receive(ola::io::ByteString *datagram, bool wait) = 0;
+
+  /**
+   * @brief Check if messages were dropped, and clear the flag.
+   * @returns true if the kernel dropped messages since the last call, in
+   *   which case the caller needs to request a new dump.
+   */
+  virtual bool CheckOverflow() = 0;
+
+  /**
+   * @brief Set the callback to run when datagrams are available.
+   * @param on_data the callback to run, ownership is transferred.
+   */
+  virtual void SetOnData(Callback0<void> *on_data) = 0;
+};
+
+
+/**
+ * @brief A NetlinkSource that uses a NETLINK_ROUTE socket.
+ */
+class NetlinkSocket : public NetlinkSource {
+ public:
+  explicit NetlinkSocket(ola::io::SelectServerInterface *ss);
+  ~NetlinkSocket();
+
+  bool Init();
+  bool RequestDump(uint16_t message_type);
+  bool Receive(ola::io::ByteString *datagram, bool wait);
+  bool CheckOverflow();
+  void SetOnData(Callback0<void> *on_data);
+
+  /**
+   * @brief Check if netlink is available on this platform.
+   */
+  static bool Available();
+
+ private:
+  ola::io::SelectServerInterface *m_ss;
+  std::auto_ptr<ola::io::UnmanagedFileDescriptor> m_descriptor;
+  uint32_t m_sequence;
+  bool m_registered;
+  bool m_overflowed;
+
+  static const unsigned int RECEIVE_BUFFER_SIZE = 16384;
+  static const int DUMP_TIMEOUT_MS = 1000;
+
+  DISALLOW_COPY_AND_ASSIGN(NetlinkSocket);
+};
+}  // namespace network
+}  // namespace ola
+#endif  // COMMON_NETWORK_NETLINKSOURCE_H_
@@ -58,6 +58,13 @@ EXTRA_DIST += common/rdm/Pids.proto
 common/rdm/Pids.pb.cc common/rdm/Pids.pb.h: common/rdm/Makefile.mk common/rdm/Pids.proto
 	$(PROTOC) --cpp_out $(top_builddir)/common/rdm --proto_path $(srcdir)/common/rdm $(srcdir)/common/rdm/Pids.proto
 
+# PROGRAMS
+##################################################
+noinst_PROGRAMS += common/rdm/responder_benchmark
+
+common_rdm_responder_benchmark_SOURCES = common/rdm/responder_benchmark.cpp
+common_rdm_responder_benchmark_LDADD = common/libolacommon.la
+
 # TESTS_DATA
 ##################################################
 
@@ -86,6 +93,7 @@ test_programs += \
     common/rdm/RDMHelperTester \
     common/rdm/RDMMessageTester \
     common/rdm/RDMReplyTester \
+    common/rdm/ResponderOpsTester \
     common/rdm/UIDAllocatorTester \
     common/rdm/UIDTester
 
@@ -148,6 +156,11 @@ common_rdm_QueueingRDMControllerTester_SOURCES = \
 common_rdm_QueueingRDMControllerTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 common_rdm_QueueingRDMControllerTester_LDADD = $(COMMON_TESTING_LIBS)
 
+common_rdm_ResponderOpsTester_SOURCES = \
+    common/rdm/ResponderOpsTest.cpp
+common_rdm_ResponderOpsTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
+common_rdm_ResponderOpsTester_LDADD = $(COMMON_TESTING_LIBS)
+
 common_rdm_UIDAllocatorTester_SOURCES = \
     common/rdm/UIDAllocatorTest.cpp
 common_rdm_UIDAllocatorTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
@@ -1065,13 +1065,10 @@ RDMResponse *ResponderHelper::GetString(
   if (request->ParamDataSize()) {
     return NackWithReason(request, NR_FORMAT_ERROR, queued_message_count);
   }
-  string sanitised_value = value.substr(
-      0,
-      min(static_cast<uint8_t>(value.length()), max_length));
   return GetResponseFromData(
       request,
-      reinterpret_cast<const uint8_t*>(sanitised_value.data()),
-      sanitised_value.size(),
+      reinterpret_cast<const uint8_t*>(value.data()),
+      min(value.length(), static_cast<size_t>(max_length)),
       RDM_ACK,
       queued_message_count);
 }
@@ -1104,9 +1101,8 @@ RDMResponse *ResponderHelper::SetString(
   if (request->ParamDataSize() > max_length) {
     return NackWithReason(request, NR_FORMAT_ERROR, queued_message_count);
   }
-  const string new_label(reinterpret_cast<const char*>(request->ParamData()),
-                         request->ParamDataSize());
-  *value = new_label;
+  value->assign(reinterpret_cast<const char*>(request->ParamData()),
+                request->ParamDataSize());
   return EmptySetResponse(request, queued_message_count);
 }
 
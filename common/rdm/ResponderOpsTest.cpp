@@ -0,0 +1,244 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * ResponderOpsTest.cpp
+ * Test fixture for the ResponderOps dispatcher.
+ * Copyright (C) 2026 agent
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <string.h>
+#include <memory>
+
+#include "ola/Callback.h"
+#include "ola/network/NetworkUtils.h"
+#include "ola/rdm/RDMCommand.h"
+#include "ola/rdm/RDMEnums.h"
+#include "ola/rdm/RDMReply.h"
+#include "ola/rdm/ResponderHelper.h"
+#include "ola/rdm/ResponderOps.h"
+#include "ola/rdm/UID.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::network::HostToNetwork;
+using ola::rdm::RDMGetRequest;
+using ola::rdm::RDMReply;
+using ola::rdm::RDMRequest;
+using ola::rdm::RDMResponse;
+using ola::rdm::RDMSetRequest;
+using ola::rdm::ResponderHelper;
+using ola::rdm::ResponderOps;
+using ola::rdm::UID;
+using std::auto_ptr;
+
+namespace {
+
+/*
+ * A responder which records the last handler called.
+ */
+class TestResponder {
+ public:
+  TestResponder() : last_handler(0) {}
+
+  RDMResponse *GetLabel(const RDMRequest *request) {
+    last_handler = 1;
+    return ResponderHelper::GetString(request, "label");
+  }
+
+  RDMResponse *SetLabel(const RDMRequest *request) {
+    last_handler = 2;
+    return ResponderHelper::EmptySetResponse(request);
+  }
+
+  RDMResponse *GetLampHours(const RDMRequest *request) {
+    last_handler = 3;
+    return ResponderHelper::GetUInt32Value(request, 0);
+  }
+
+  RDMResponse *GetLampHoursOverride(const RDMRequest *request) {
+    last_handler = 4;
+    return ResponderHelper::GetUInt32Value(request, 0);
+  }
+
+  RDMResponse *GetDeviceInfo(const RDMRequest *request) {
+    last_handler = 5;
+    return ResponderHelper::EmptyGetResponse(request);
+  }
+
+  int last_handler;
+};
+
+// Deliberately not sorted
+const ResponderOps<TestResponder>::ParamHandler PARAM_HANDLERS[] = {
+  { ola::rdm::PID_LAMP_HOURS,
+    &TestResponder::GetLampHours,
+    NULL},
+  { ola::rdm::PID_DEVICE_LABEL,
+    &TestResponder::GetLabel,
+    &TestResponder::SetLabel},
+  { ola::rdm::PID_DEVICE_INFO,
+    &TestResponder::GetDeviceInfo,
+    NULL},
+  { ola::rdm::PID_LAMP_HOURS,
+    &TestResponder::GetLampHoursOverride,
+    NULL},
+  { 0, NULL, NULL},
+};
+}  // namespace
+
+class ResponderOpsTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(ResponderOpsTest);
+  CPPUNIT_TEST(testDispatch);
+  CPPUNIT_TEST(testSupportedParams);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  ResponderOpsTest()
+      : m_uid(0x7a70, 1),
+        m_source(1, 2) {
+  }
+
+  void setUp() {
+    m_status = ola::rdm::RDM_FAILED_TO_SEND;
+    m_response.reset();
+  }
+
+  void testDispatch();
+  void testSupportedParams();
+
+ private:
+  UID m_uid;
+  UID m_source;
+  ola::rdm::RDMStatusCode m_status;
+  auto_ptr<RDMResponse> m_response;
+
+  void SendRequest(ResponderOps<TestResponder> *ops,
+                   TestResponder *responder,
+                   RDMRequest *request);
+  void HandleReply(RDMReply *reply);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(ResponderOpsTest);
+
+void ResponderOpsTest::SendRequest(ResponderOps<TestResponder> *ops,
+                                   TestResponder *responder,
+                                   RDMRequest *request) {
+  ops->HandleRDMRequest(
+      responder, m_uid, ola::rdm::ROOT_RDM_DEVICE, request,
+      ola::NewSingleCallback(this, &ResponderOpsTest::HandleReply));
+}
+
+void ResponderOpsTest::HandleReply(RDMReply *reply) {
+  m_status = reply->StatusCode();
+  m_response.reset(
+      reply->Response() ? reply->Response()->Duplicate() : NULL);
+}
+
+
+/*
+ * Check requests are sent to the right handler.
+ */
+void ResponderOpsTest::testDispatch() {
+  ResponderOps<TestResponder> ops(PARAM_HANDLERS);
+  TestResponder responder;
+
+  SendRequest(&ops, &responder, new RDMGetRequest(
+      m_source, m_uid, 0, 1, 0, ola::rdm::PID_DEVICE_LABEL, NULL, 0));
+  OLA_ASSERT_EQ(ola::rdm::RDM_COMPLETED_OK, m_status);
+  OLA_ASSERT_EQ(1, responder.last_handler);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(ola::rdm::RDM_ACK),
+                m_response->ResponseType());
+  OLA_ASSERT_DATA_EQUALS(reinterpret_cast<const uint8_t*>("label"), 5,
+                         m_response->ParamData(),
+                         m_response->ParamDataSize());
+
+  SendRequest(&ops, &responder, new RDMSetRequest(
+      m_source, m_uid, 0, 1, 0, ola::rdm::PID_DEVICE_LABEL, NULL, 0));
+  OLA_ASSERT_EQ(2, responder.last_handler);
+
+  SendRequest(&ops, &responder, new RDMGetRequest(
+      m_source, m_uid, 0, 1, 0, ola::rdm::PID_DEVICE_INFO, NULL, 0));
+  OLA_ASSERT_EQ(5, responder.last_handler);
+
+  // The last handler registered for a PID is used.
+  SendRequest(&ops, &responder, new RDMGetRequest(
+      m_source, m_uid, 0, 1, 0, ola::rdm::PID_LAMP_HOURS, NULL, 0));
+  OLA_ASSERT_EQ(4, responder.last_handler);
+
+  // No SET handler
+  responder.last_handler = 0;
+  SendRequest(&ops, &responder, new RDMSetRequest(
+      m_source, m_uid, 0, 1, 0, ola::rdm::PID_LAMP_HOURS, NULL, 0));
+  OLA_ASSERT_EQ(0, responder.last_handler);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(ola::rdm::RDM_NACK_REASON),
+                m_response->ResponseType());
+
+  // Unknown PIDs, either side of the registered ones.
+  const uint16_t unknown_pids[] = {
+    ola::rdm::PID_COMMS_STATUS,
+    ola::rdm::PID_LAMP_STRIKES,
+    0xffff
+  };
+  for (unsigned int i = 0; i < sizeof(unknown_pids) / sizeof(uint16_t); i++) {
+    SendRequest(&ops, &responder, new RDMGetRequest(
+        m_source, m_uid, 0, 1, 0, unknown_pids[i], NULL, 0));
+    OLA_ASSERT_EQ(0, responder.last_handler);
+    OLA_ASSERT_EQ(static_cast<uint8_t>(ola::rdm::RDM_NACK_REASON),
+                  m_response->ResponseType());
+    uint16_t reason = HostToNetwork(
+        static_cast<uint16_t>(ola::rdm::NR_UNKNOWN_PID));
+    OLA_ASSERT_DATA_EQUALS(reinterpret_cast<const uint8_t*>(&reason),
+                           sizeof(reason),
+                           m_response->ParamData(),
+                           m_response->ParamDataSize());
+  }
+}
+
+
+/*
+ * Check SUPPORTED_PARAMETERS is sorted and skips the required PIDs.
+ */
+void ResponderOpsTest::testSupportedParams() {
+  TestResponder responder;
+  ResponderOps<TestResponder> ops(PARAM_HANDLERS);
+  SendRequest(&ops, &responder, new RDMGetRequest(
+      m_source, m_uid, 0, 1, 0, ola::rdm::PID_SUPPORTED_PARAMETERS, NULL,
+      0));
+  OLA_ASSERT_EQ(ola::rdm::RDM_COMPLETED_OK, m_status);
+  uint16_t expected[] = {
+    HostToNetwork(static_cast<uint16_t>(ola::rdm::PID_DEVICE_LABEL)),
+    HostToNetwork(static_cast<uint16_t>(ola::rdm::PID_LAMP_HOURS)),
+  };
+  OLA_ASSERT_DATA_EQUALS(reinterpret_cast<const uint8_t*>(expected),
+                         sizeof(expected),
+                         m_response->ParamData(),
+                         m_response->ParamDataSize());
+
+  // Sub devices include the required PIDs.
+  ResponderOps<TestResponder> sub_device_ops(PARAM_HANDLERS, true);
+  SendRequest(&sub_device_ops, &responder, new RDMGetRequest(
+      m_source, m_uid, 0, 1, 0, ola::rdm::PID_SUPPORTED_PARAMETERS, NULL,
+      0));
+  uint16_t sub_device_expected[] = {
+    HostToNetwork(static_cast<uint16_t>(ola::rdm::PID_SUPPORTED_PARAMETERS)),
+    HostToNetwork(static_cast<uint16_t>(ola::rdm::PID_DEVICE_INFO)),
+    HostToNetwork(static_cast<uint16_t>(ola::rdm::PID_DEVICE_LABEL)),
+    HostToNetwork(static_cast<uint16_t>(ola::rdm::PID_LAMP_HOURS)),
+  };
+  OLA_ASSERT_DATA_EQUALS(reinterpret_cast<const uint8_t*>(sub_device_expected),
+                         sizeof(sub_device_expected),
+                         m_response->ParamData(),
+                         m_response->ParamDataSize());
+}
@@ -0,0 +1,132 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * responder_benchmark.cpp
+ * Measure how fast the software responders handle RDM requests.
+ * Copyright (C) 2026 agent
+ */
+
+#include <stdint.h>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include "ola/Callback.h"
+#include "ola/Clock.h"
+#include "ola/Logging.h"
+#include "ola/base/Flags.h"
+#include "ola/base/Init.h"
+#include "ola/network/NetworkUtils.h"
+#include "ola/rdm/DimmerResponder.h"
+#include "ola/rdm/RDMCommand.h"
+#include "ola/rdm/RDMEnums.h"
+#include "ola/rdm/RDMReply.h"
+#include "ola/rdm/UID.h"
+
+using ola::Clock;
+using ola::TimeInterval;
+using ola::TimeStamp;
+using ola::rdm::DimmerResponder;
+using ola::rdm::RDMGetRequest;
+using ola::rdm::RDMReply;
+using ola::rdm::RDMRequest;
+using ola::rdm::RDMSetRequest;
+using ola::rdm::UID;
+using std::auto_ptr;
+using std::cout;
+using std::endl;
+using std::string;
+
+DEFINE_s_uint32(requests, r, 1000000, "The number of requests of each type");
+
+namespace {
+
+const UID SOURCE_UID(0x7a70, 1);
+const UID DEST_UID(0x7a70, 2);
+
+unsigned int reply_count = 0;
+
+void CountReply(RDMReply *reply) {
+  if (reply->StatusCode() == ola::rdm::RDM_COMPLETED_OK) {
+    reply_count++;
+  }
+}
+
+/*
+ * Send the same request to the responder and report the rate.
+ */
+void Run(const string &name, DimmerResponder *responder,
+         const RDMRequest &request, ola::rdm::RDMCallback *callback) {
+  Clock clock;
+  TimeStamp start, end;
+  reply_count = 0;
+
+  clock.CurrentMonotonicTime(&start);
+  for (unsigned int i = 0; i < FLAGS_requests; i++) {
+    responder->SendRDMRequest(request.Duplicate(), callback);
+  }
+  clock.CurrentMonotonicTime(&end);
+
+  if (reply_count != FLAGS_requests) {
+    OLA_WARN << name << ": only " << reply_count << " of " << FLAGS_requests
+             << " requests completed";
+  }
+
+  TimeInterval elapsed = end - start;
+  double seconds = elapsed.InMilliSeconds() / 1000.0;
+  cout << std::left << std::setw(32) << name << std::right << std::fixed
+       << std::setprecision(0) << std::setw(12)
+       << (seconds ? FLAGS_requests / seconds : 0) << " requests/s" << endl;
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  ola::AppInit(&argc, argv, "",
+               "Send RDM requests to a DimmerResponder as fast as possible.");
+
+  DimmerResponder responder(DEST_UID, 4);
+  auto_ptr<ola::rdm::RDMCallback> callback(ola::NewCallback(&CountReply));
+
+  uint16_t start_address = ola::network::HostToNetwork(
+      static_cast<uint16_t>(1));
+  const uint8_t *address_data = reinterpret_cast<uint8_t*>(&start_address);
+
+  Run("GET DEVICE_INFO", &responder,
+      RDMGetRequest(SOURCE_UID, DEST_UID, 0, 1, ola::rdm::ROOT_RDM_DEVICE,
+                    ola::rdm::PID_DEVICE_INFO, NULL, 0),
+      callback.get());
+  Run("GET SUPPORTED_PARAMETERS", &responder,
+      RDMGetRequest(SOURCE_UID, DEST_UID, 0, 1, ola::rdm::ROOT_RDM_DEVICE,
+                    ola::rdm::PID_SUPPORTED_PARAMETERS, NULL, 0),
+      callback.get());
+  Run("GET DEVICE_LABEL", &responder,
+      RDMGetRequest(SOURCE_UID, DEST_UID, 0, 1, ola::rdm::ROOT_RDM_DEVICE,
+                    ola::rdm::PID_DEVICE_LABEL, NULL, 0),
+      callback.get());
+  Run("GET unknown PID", &responder,
+      RDMGetRequest(SOURCE_UID, DEST_UID, 0, 1, ola::rdm::ROOT_RDM_DEVICE,
+                    0x7fff, NULL, 0),
+      callback.get());
+  Run("GET DMX_START_ADDRESS, sub dev", &responder,
+      RDMGetRequest(SOURCE_UID, DEST_UID, 0, 1, 1,
+                    ola::rdm::PID_DMX_START_ADDRESS, NULL, 0),
+      callback.get());
+  Run("SET DMX_START_ADDRESS, sub dev", &responder,
+      RDMSetRequest(SOURCE_UID, DEST_UID, 0, 1, 1,
+                    ola::rdm::PID_DMX_START_ADDRESS, address_data,
+                    sizeof(start_address)),
+      callback.get());
+  return 0;
+}
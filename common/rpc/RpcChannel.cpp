@@ -58,6 +58,36 @@ const char *RpcChannel::K_RPC_VARIABLES[] = {
   K_RPC_SENT_VAR,
 };
 
+namespace {
+
+void HashBytes(const char *data, size_t size, uint32_t *hash) {
+  for (size_t i = 0; i < size; i++) {
+    *hash ^= static_cast<uint8_t>(data[i]);
+    *hash *= 16777619u;
+  }
+  // Separate the strings so "ab" + "c" differs from "a" + "bc".
+  *hash *= 16777619u;
+}
+
+/*
+ * Hash the names & types of the methods in a service, so both ends can check
+ * they agree on the method indexes. This is FNV-1a.
+ */
+uint32_t MethodTableHash(const ServiceDescriptor *service) {
+  uint32_t hash = 2166136261u;
+  HashBytes(service->full_name().data(), service->full_name().size(), &hash);
+  for (int i = 0; i < service->method_count(); i++) {
+    const MethodDescriptor *method = service->method(i);
+    HashBytes(method->name().data(), method->name().size(), &hash);
+    HashBytes(method->input_type()->full_name().data(),
+              method->input_type()->full_name().size(), &hash);
+    HashBytes(method->output_type()->full_name().data(),
+              method->output_type()->full_name().size(), &hash);
+  }
+  return hash;
+}
+}  // namespace
+
 class OutstandingRequest {
   /*
    * These are requests on the server end that haven't completed yet.
@@ -118,7 +148,11 @@ RpcChannel::RpcChannel(
       m_expected_size(0),
       m_current_size(0),
       m_export_map(export_map),
-      m_recv_type_map(NULL) {
+      m_recv_type_map(NULL),
+      m_received_message(false),
+      m_peer_offers_tables(false),
+      m_incoming(new RpcMessage()),
+      m_outgoing(new RpcMessage()) {
   if (descriptor) {
     descriptor->SetOnData(
         ola::NewCallback(this, &RpcChannel::DescriptorReady));
@@ -136,6 +170,7 @@ RpcChannel::RpcChannel(
 }
 
 RpcChannel::~RpcChannel() {
+  STLDeleteValues(&m_stream_requests);
   free(m_buffer);
 }
 
@@ -207,9 +242,6 @@ void RpcChannel::CallMethod(const MethodDescriptor *method,
                             const Message *request,
                             Message *reply,
                             SingleUseCallback0<void> *done) {
-  // TODO(simonn): reduce the number of copies here
-  string output;
-  RpcMessage message;
   bool is_streaming = false;
 
   // Streaming methods are those with a reply set to STREAMING_NO_RESPONSE and
@@ -223,13 +255,21 @@ void RpcChannel::CallMethod(const MethodDescriptor *method,
     is_streaming = true;
   }
 
-  message.set_type(is_streaming ? STREAM_REQUEST : REQUEST);
-  message.set_id(m_sequence.Next());
-  message.set_name(method->name());
+  // This may send an offer, so it needs to happen before we use m_outgoing.
+  bool use_method_index = UseMethodIndex(method->service());
 
-  request->SerializeToString(&output);
-  message.set_buffer(output);
-  bool r = SendMsg(&message);
+  const uint32_t id = m_sequence.Next();
+  RpcMessage *message = m_outgoing.get();
+  message->Clear();
+  message->set_type(is_streaming ? STREAM_REQUEST : REQUEST);
+  message->set_id(id);
+  if (use_method_index) {
+    message->set_method_index(method->index());
+  } else {
+    message->set_name(method->name());
+  }
+  request->SerializeToString(message->mutable_buffer());
+  bool r = SendMsg(message);
 
   if (is_streaming)
     return;
@@ -242,10 +282,10 @@ void RpcChannel::CallMethod(const MethodDescriptor *method,
   }
 
   OutstandingResponse *response = new OutstandingResponse(
-      message.id(), controller, done, reply);
+      id, controller, done, reply);
 
   auto_ptr<OutstandingResponse> old_response(
-      STLReplacePtr(&m_responses, message.id(), response));
+      STLReplacePtr(&m_responses, id, response));
 
   if (old_response.get()) {
     // fail any outstanding response with the same id
@@ -257,19 +297,17 @@ void RpcChannel::CallMethod(const MethodDescriptor *method,
 }
 
 void RpcChannel::RequestComplete(OutstandingRequest *request) {
-  string output;
-  RpcMessage message;
-
   if (request->controller->Failed()) {
     SendRequestFailed(request);
     return;
   }
 
-  message.set_type(RESPONSE);
-  message.set_id(request->id);
-  request->response->SerializeToString(&output);
-  message.set_buffer(output);
-  SendMsg(&message);
+  RpcMessage *message = m_outgoing.get();
+  message->Clear();
+  message->set_type(RESPONSE);
+  message->set_id(request->id);
+  request->response->SerializeToString(message->mutable_buffer());
+  SendMsg(message);
   DeleteOutstandingRequest(request);
 }
 
@@ -277,6 +315,12 @@ RpcSession *RpcChannel::Session() {
   return m_session.get();
 }
 
+bool RpcChannel::MethodIndexesAccepted(
+    const ServiceDescriptor *service) const {
+  const MethodTable *table = STLFind(&m_method_tables, service);
+  return table && table->accepted;
+}
+
 // private
 //-----------------------------------------------------------------------------
 
@@ -290,19 +334,20 @@ bool RpcChannel::SendMsg(RpcMessage *msg) {
   }
 
   uint32_t header;
-  // reserve the first 4 bytes for the header
-  string output(sizeof(header), 0);
-  msg->AppendToString(&output);
-  int length = output.size();
+  // reserve the first 4 bytes for the header. The buffer is reused so we
+  // don't allocate for each message.
+  m_send_buffer.assign(sizeof(header), 0);
+  msg->AppendToString(&m_send_buffer);
+  int length = m_send_buffer.size();
 
   RpcHeader::EncodeHeader(&header, PROTOCOL_VERSION,
                                 length - sizeof(header));
-  output.replace(
+  m_send_buffer.replace(
       0, sizeof(header),
       reinterpret_cast<const char*>(&header), sizeof(header));
 
   ssize_t ret = m_descriptor->Send(
-      reinterpret_cast<const uint8_t*>(output.data()), length);
+      reinterpret_cast<const uint8_t*>(m_send_buffer.data()), length);
 
   if (ret != length) {
     OLA_WARN << "Failed to send full RPC message, closing channel";
@@ -387,48 +432,50 @@ int RpcChannel::ReadHeader(unsigned int *version,
  * Parse a new message and handle it.
  */
 bool RpcChannel::HandleNewMsg(uint8_t *data, unsigned int size) {
-  RpcMessage msg;
-  if (!msg.ParseFromArray(data, size)) {
+  // The message is reused, so the handlers below mustn't hold on to it.
+  RpcMessage *msg = m_incoming.get();
+  if (!msg->ParseFromArray(data, size)) {
     OLA_WARN << "Failed to parse RPC";
     return false;
   }
 
   if (m_export_map)
     (*m_export_map->GetCounterVar(K_RPC_RECEIVED_VAR))++;
+  m_received_message = true;
 
-  switch (msg.type()) {
+  switch (msg->type()) {
     case REQUEST:
       if (m_recv_type_map)
         (*m_recv_type_map)["request"]++;
-      HandleRequest(&msg);
+      HandleRequest(msg);
       break;
     case RESPONSE:
       if (m_recv_type_map)
         (*m_recv_type_map)["response"]++;
-      HandleResponse(&msg);
+      HandleResponse(msg);
       break;
     case RESPONSE_CANCEL:
       if (m_recv_type_map)
         (*m_recv_type_map)["cancelled"]++;
-      HandleCanceledResponse(&msg);
+      HandleCanceledResponse(msg);
       break;
     case RESPONSE_FAILED:
       if (m_recv_type_map)
         (*m_recv_type_map)["failed"]++;
-      HandleFailedResponse(&msg);
+      HandleFailedResponse(msg);
       break;
     case RESPONSE_NOT_IMPLEMENTED:
       if (m_recv_type_map)
         (*m_recv_type_map)["not-implemented"]++;
-      HandleNotImplemented(&msg);
+      HandleNotImplemented(msg);
       break;
     case STREAM_REQUEST:
       if (m_recv_type_map)
         (*m_recv_type_map)["stream_request"]++;
-      HandleStreamRequest(&msg);
+      HandleStreamRequest(msg);
       break;
     default:
-      OLA_WARN << "not sure of msg type " << msg.type();
+      OLA_WARN << "not sure of msg type " << msg->type();
       break;
   }
   return true;
@@ -439,6 +486,11 @@ bool RpcChannel::HandleNewMsg(uint8_t *data, unsigned int size) {
  * Handle a new RPC method call.
  */
 void RpcChannel::HandleRequest(RpcMessage *msg) {
+  if (msg->has_method_table_hash()) {
+    HandleMethodTableOffer(msg);
+    return;
+  }
+
   if (!m_service) {
     OLA_WARN << "no service registered";
     return;
@@ -449,17 +501,18 @@ void RpcChannel::HandleRequest(RpcMessage *msg) {
     OLA_WARN << "failed to get service descriptor";
     return;
   }
-  const MethodDescriptor *method = service->FindMethodByName(msg->name());
+  const MethodDescriptor *method = LookupMethod(service, msg);
   if (!method) {
     OLA_WARN << "failed to get method descriptor";
     SendNotImplemented(msg->id());
     return;
   }
 
-  Message* request_pb = m_service->GetRequestPrototype(method).New();
-  Message* response_pb = m_service->GetResponsePrototype(method).New();
+  auto_ptr<Message> request_pb(m_service->GetRequestPrototype(method).New());
+  auto_ptr<Message> response_pb(
+      m_service->GetResponsePrototype(method).New());
 
-  if (!request_pb || !response_pb) {
+  if (!request_pb.get() || !response_pb.get()) {
     OLA_WARN << "failed to get request or response objects";
     return;
   }
@@ -470,7 +523,7 @@ void RpcChannel::HandleRequest(RpcMessage *msg) {
   }
 
   OutstandingRequest *request = new OutstandingRequest(
-      msg->id(), m_session.get(), response_pb);
+      msg->id(), m_session.get(), response_pb.release());
 
   if (m_requests.find(msg->id()) != m_requests.end()) {
     OLA_WARN << "dup sequence number for request " << msg->id();
@@ -480,9 +533,8 @@ void RpcChannel::HandleRequest(RpcMessage *msg) {
   m_requests[msg->id()] = request;
   SingleUseCallback0<void> *callback = NewSingleCallback(
       this, &RpcChannel::RequestComplete, request);
-  m_service->CallMethod(method, request->controller, request_pb, response_pb,
-                        callback);
-  delete request_pb;
+  m_service->CallMethod(method, request->controller, request_pb.get(),
+                        request->response, callback);
 }
 
 
@@ -500,7 +552,7 @@ void RpcChannel::HandleStreamRequest(RpcMessage *msg) {
     OLA_WARN << "failed to get service descriptor";
     return;
   }
-  const MethodDescriptor *method = service->FindMethodByName(msg->name());
+  const MethodDescriptor *method = LookupMethod(service, msg);
   if (!method) {
     OLA_WARN << "failed to get method descriptor";
     SendNotImplemented(msg->id());
@@ -513,7 +565,14 @@ void RpcChannel::HandleStreamRequest(RpcMessage *msg) {
     return;
   }
 
-  Message* request_pb = m_service->GetRequestPrototype(method).New();
+  // Streaming methods don't take a completion callback, so the request isn't
+  // used once CallMethod() returns. We keep one request per method and reuse
+  // it. It's removed from the pool while in use, in case the handler causes
+  // another request to be processed.
+  Message* request_pb = STLLookupAndRemovePtr(&m_stream_requests, method);
+  if (!request_pb) {
+    request_pb = m_service->GetRequestPrototype(method).New();
+  }
 
   if (!request_pb) {
     OLA_WARN << "failed to get request or response objects";
@@ -522,12 +581,93 @@ void RpcChannel::HandleStreamRequest(RpcMessage *msg) {
 
   if (!request_pb->ParseFromString(msg->buffer())) {
     OLA_WARN << "parsing of request pb failed";
+    delete request_pb;
     return;
   }
 
   RpcController controller(m_session.get());
   m_service->CallMethod(method, &controller, request_pb, NULL, NULL);
-  delete request_pb;
+  STLReplaceAndDelete(&m_stream_requests, method, request_pb);
+}
+
+
+/*
+ * Find the method for a request, using either the method index or the name.
+ */
+const MethodDescriptor *RpcChannel::LookupMethod(
+    const ServiceDescriptor *service,
+    const RpcMessage *msg) const {
+  if (!msg->has_method_index()) {
+    return service->FindMethodByName(msg->name());
+  }
+
+  // Indexes are only valid if we accepted the method table for this service.
+  if (!STLContains(m_indexed_services, service) ||
+      msg->method_index() >=
+        static_cast<unsigned int>(service->method_count())) {
+    return NULL;
+  }
+  return service->method(msg->method_index());
+}
+
+
+/*
+ * Handle a method table offer from the peer. If the table matches our
+ * service, the peer can use method indexes from now on.
+ */
+void RpcChannel::HandleMethodTableOffer(RpcMessage *msg) {
+  // Even if we reject it, the offer tells us the peer can handle ours.
+  m_peer_offers_tables = true;
+  const ServiceDescriptor *service = (
+      m_service ? m_service->GetDescriptor() : NULL);
+  if (!service || service->full_name() != msg->name() ||
+      MethodTableHash(service) != msg->method_table_hash()) {
+    OLA_DEBUG << "Rejecting method table for " << msg->name();
+    SendNotImplemented(msg->id());
+    return;
+  }
+
+  m_indexed_services.insert(service);
+  RpcMessage message;
+  message.set_type(RESPONSE);
+  message.set_id(msg->id());
+  message.set_method_table_hash(msg->method_table_hash());
+  SendMsg(&message);
+}
+
+
+/*
+ * Check if we can use method indexes for a service. The first time a service
+ * is used, this sends an offer to the peer.
+ *
+ * Some older peers (the Python client) can't cope with an offer, so we only
+ * send one if we're the first to speak, or if the peer has sent us an offer.
+ * A peer that speaks first without offering is treated as an older peer.
+ */
+bool RpcChannel::UseMethodIndex(const ServiceDescriptor *service) {
+  MethodTableMap::const_iterator iter = m_method_tables.find(service);
+  if (iter != m_method_tables.end()) {
+    return iter->second.accepted;
+  }
+
+  if (m_received_message && !m_peer_offers_tables) {
+    return false;
+  }
+
+  MethodTable table;
+  table.hash = MethodTableHash(service);
+  table.accepted = false;
+  m_method_tables[service] = table;
+
+  RpcMessage message;
+  message.set_type(REQUEST);
+  message.set_id(m_sequence.Next());
+  message.set_name(service->full_name());
+  message.set_method_table_hash(table.hash);
+  if (SendMsg(&message)) {
+    m_method_table_offers[message.id()] = service;
+  }
+  return false;
 }
 
 
@@ -565,10 +705,34 @@ void RpcChannel::DeleteOutstandingRequest(OutstandingRequest *request) {
 
 
 // client side methods
+/*
+ * Check if a message is the reply to a method table offer.
+ * @returns true if the message was handled.
+ */
+bool RpcChannel::HandleMethodTableReply(RpcMessage *msg) {
+  const ServiceDescriptor *service;
+  if (!STLLookupAndRemove(&m_method_table_offers, msg->id(), &service)) {
+    return false;
+  }
+
+  MethodTable *table = STLFind(&m_method_tables, service);
+  if (table && msg->type() == RESPONSE &&
+      msg->has_method_table_hash() &&
+      msg->method_table_hash() == table->hash) {
+    table->accepted = true;
+    m_peer_offers_tables = true;
+  }
+  return true;
+}
+
+
 /*
  * Handle a RPC response by invoking the callback.
  */
 void RpcChannel::HandleResponse(RpcMessage *msg) {
+  if (HandleMethodTableReply(msg)) {
+    return;
+  }
   auto_ptr<OutstandingResponse> response(
       STLLookupAndRemovePtr(&m_responses, msg->id()));
   if (response.get()) {
@@ -585,6 +749,9 @@ void RpcChannel::HandleResponse(RpcMessage *msg) {
  * Handle a RPC response by invoking the callback.
  */
 void RpcChannel::HandleFailedResponse(RpcMessage *msg) {
+  if (HandleMethodTableReply(msg)) {
+    return;
+  }
   auto_ptr<OutstandingResponse> response(
       STLLookupAndRemovePtr(&m_responses, msg->id()));
   if (response.get()) {
@@ -598,6 +765,9 @@ void RpcChannel::HandleFailedResponse(RpcMessage *msg) {
  * Handle a RPC response by invoking the callback.
  */
 void RpcChannel::HandleCanceledResponse(RpcMessage *msg) {
+  if (HandleMethodTableReply(msg)) {
+    return;
+  }
   OLA_INFO << "Received a canceled response";
   auto_ptr<OutstandingResponse> response(
       STLLookupAndRemovePtr(&m_responses, msg->id()));
@@ -612,6 +782,9 @@ void RpcChannel::HandleCanceledResponse(RpcMessage *msg) {
  * Handle a NOT_IMPLEMENTED by invoking the callback.
  */
 void RpcChannel::HandleNotImplemented(RpcMessage *msg) {
+  if (HandleMethodTableReply(msg)) {
+    return;
+  }
   OLA_INFO << "Received a non-implemented response";
   auto_ptr<OutstandingResponse> response(
       STLLookupAndRemovePtr(&m_responses, msg->id()));
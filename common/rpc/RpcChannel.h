@@ -30,7 +30,10 @@
 #include <ola/Callback.h>
 #include <ola/io/Descriptor.h>
 #include <ola/util/SequenceNumber.h>
+#include <map>
 #include <memory>
+#include <set>
+#include <string>
 
 #include "ola/ExportMap.h"
 
@@ -47,6 +50,15 @@ class RpcService;
  * server.
  * This implementation runs over a ConnectedDescriptor which means it can be
  * used over TCP or pipes.
+ *
+ * The first time a method from a service is called, the channel offers the
+ * service's method table to the peer, identified by a hash of the method
+ * names & types. Once the peer accepts the offer, requests carry the index of
+ * the method rather than the name. Peers that don't understand the offer
+ * reply with RESPONSE_NOT_IMPLEMENTED, and we keep sending names.
+ *
+ * Offers are only sent if we speak first, or once the peer has sent one of
+ * its own, so peers that predate method tables never receive one.
  */
 class RpcChannel {
  public :
@@ -130,6 +142,15 @@ class RpcChannel {
      */
     RpcSession *Session();
 
+    /**
+     * @brief Check if the peer has accepted the method table for a service.
+     * @param service the service to check.
+     * @returns true if requests for the service's methods are sent with the
+     *   method index, false if the method name is used.
+     */
+    bool MethodIndexesAccepted(
+        const google::protobuf::ServiceDescriptor *service) const;
+
     /**
      * @brief the RPC protocol version.
      */
@@ -139,6 +160,20 @@ class RpcChannel {
     typedef HASH_NAMESPACE::HASH_MAP_CLASS<int, class OutstandingResponse*>
       ResponseMap;
 
+    struct MethodTable {
+      uint32_t hash;
+      bool accepted;
+    };
+
+    typedef std::map<const google::protobuf::ServiceDescriptor*, MethodTable>
+      MethodTableMap;
+    // Offers we've sent, by message id.
+    typedef std::map<uint32_t, const google::protobuf::ServiceDescriptor*>
+      MethodTableOffers;
+    // Request messages for streaming methods, reused for each call.
+    typedef std::map<const google::protobuf::MethodDescriptor*,
+                     google::protobuf::Message*> RequestPool;
+
     std::auto_ptr<RpcSession> m_session;
     RpcService *m_service;  // service to dispatch requests to
     std::auto_ptr<CloseCallback> m_on_close;
@@ -154,12 +189,32 @@ class RpcChannel {
     ExportMap *m_export_map;
     UIntMap *m_recv_type_map;
 
+    // The method tables we've offered to the peer.
+    MethodTableMap m_method_tables;
+    MethodTableOffers m_method_table_offers;
+    // The services the peer can send method indexes for.
+    std::set<const google::protobuf::ServiceDescriptor*> m_indexed_services;
+    // True once we've received a message from the peer.
+    bool m_received_message;
+    // True if the peer has shown it understands method table offers.
+    bool m_peer_offers_tables;
+    RequestPool m_stream_requests;
+    // Reused to avoid allocating for each message.
+    std::auto_ptr<RpcMessage> m_incoming;
+    std::auto_ptr<RpcMessage> m_outgoing;
+    std::string m_send_buffer;
+
     bool SendMsg(RpcMessage *msg);
     int AllocateMsgBuffer(unsigned int size);
     int ReadHeader(unsigned int *version, unsigned int *size) const;
     bool HandleNewMsg(uint8_t *buffer, unsigned int size);
     void HandleRequest(RpcMessage *msg);
     void HandleStreamRequest(RpcMessage *msg);
+    const google::protobuf::MethodDescriptor *LookupMethod(
+        const google::protobuf::ServiceDescriptor *service,
+        const RpcMessage *msg) const;
+    void HandleMethodTableOffer(RpcMessage *msg);
+    bool UseMethodIndex(const google::protobuf::ServiceDescriptor *service);
 
     // server end
     void SendRequestFailed(class OutstandingRequest *request);
@@ -167,6 +222,7 @@ class RpcChannel {
     void DeleteOutstandingRequest(class OutstandingRequest *request);
 
     // client end
+    bool HandleMethodTableReply(RpcMessage *msg);
     void HandleResponse(RpcMessage *msg);
     void HandleFailedResponse(RpcMessage *msg);
     void HandleCanceledResponse(RpcMessage *msg);
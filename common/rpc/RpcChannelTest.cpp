@@ -19,28 +19,36 @@
  */
 
 #include <cppunit/extensions/HelperMacros.h>
+#include <google/protobuf/descriptor.h>
 #include <google/protobuf/stubs/common.h>
+#include <stdint.h>
 #include <memory>
 #include <string>
 
+#include "common/rpc/Rpc.pb.h"
 #include "common/rpc/RpcChannel.h"
 #include "common/rpc/RpcController.h"
+#include "common/rpc/RpcHeader.h"
 #include "common/rpc/TestService.h"
 #include "common/rpc/TestService.pb.h"
 #include "common/rpc/TestServiceService.pb.h"
 #include "ola/Callback.h"
+#include "ola/Clock.h"
 #include "ola/io/SelectServer.h"
 #include "ola/network/Socket.h"
 #include "ola/testing/TestUtils.h"
 
 
+using google::protobuf::ServiceDescriptor;
 using ola::NewSingleCallback;
+using ola::TimeInterval;
 using ola::io::LoopbackDescriptor;
 using ola::io::SelectServer;
 using ola::rpc::EchoReply;
 using ola::rpc::EchoRequest;
 using ola::rpc::RpcChannel;
 using ola::rpc::RpcController;
+using ola::rpc::RpcMessage;
 using ola::rpc::STREAMING_NO_RESPONSE;
 using ola::rpc::RpcController;
 using ola::rpc::TestService;
@@ -53,6 +61,9 @@ class RpcChannelTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testEcho);
   CPPUNIT_TEST(testFailedEcho);
   CPPUNIT_TEST(testStreamRequest);
+  CPPUNIT_TEST(testMethodIndexes);
+  CPPUNIT_TEST(testMethodTableRejected);
+  CPPUNIT_TEST(testNoOfferToOlderPeers);
   CPPUNIT_TEST_SUITE_END();
 
  public:
@@ -61,6 +72,9 @@ class RpcChannelTest: public CppUnit::TestFixture {
   void testEcho();
   void testFailedEcho();
   void testStreamRequest();
+  void testMethodIndexes();
+  void testMethodTableRejected();
+  void testNoOfferToOlderPeers();
   void EchoComplete();
   void FailedEchoComplete();
 
@@ -74,6 +88,10 @@ class RpcChannelTest: public CppUnit::TestFixture {
   auto_ptr<RpcChannel> m_channel;
   auto_ptr<TestService_Stub> m_stub;
   auto_ptr<LoopbackDescriptor> m_socket;
+
+  void WaitForMethodTable(const ServiceDescriptor *service);
+  int StreamFrameSize(bool use_method_index);
+  void SendFromPeer(const RpcMessage &message);
 };
 
 
@@ -93,6 +111,49 @@ void RpcChannelTest::tearDown() {
   m_ss.RemoveReadDescriptor(m_socket.get());
 }
 
+/*
+ * The accept for a method table arrives after the first request, so run the
+ * event loop until it's been processed.
+ */
+void RpcChannelTest::WaitForMethodTable(const ServiceDescriptor *service) {
+  for (unsigned int i = 0;
+       i < 10 && !m_channel->MethodIndexesAccepted(service); i++) {
+    m_ss.RunOnce(TimeInterval(0, 10000));
+  }
+}
+
+/*
+ * The expected size of a Stream() frame, including the header.
+ */
+int RpcChannelTest::StreamFrameSize(bool use_method_index) {
+  RpcMessage message;
+  message.set_type(ola::rpc::STREAM_REQUEST);
+  message.set_id(1);
+  if (use_method_index) {
+    message.set_method_index(
+        TestService::descriptor()->FindMethodByName("Stream")->index());
+  } else {
+    message.set_name("Stream");
+  }
+  message.set_buffer(m_request.SerializeAsString());
+  return static_cast<int>(sizeof(uint32_t) +
+                          message.SerializeAsString().size());
+}
+
+/*
+ * Write a message to the channel, as if it came from the peer.
+ */
+void RpcChannelTest::SendFromPeer(const RpcMessage &message) {
+  uint32_t header;
+  const string data = message.SerializeAsString();
+  ola::rpc::RpcHeader::EncodeHeader(&header, RpcChannel::PROTOCOL_VERSION,
+                                    data.size());
+  string frame(reinterpret_cast<const char*>(&header), sizeof(header));
+  frame.append(data);
+  m_socket->Send(reinterpret_cast<const uint8_t*>(frame.data()),
+                 frame.size());
+}
+
 void RpcChannelTest::EchoComplete() {
   m_ss.Terminate();
   OLA_ASSERT_FALSE(m_controller.Failed());
@@ -139,3 +200,95 @@ void RpcChannelTest::testStreamRequest() {
   m_stub->Stream(NULL, &m_request, NULL, NULL);
   m_ss.Run();
 }
+
+
+/*
+ * Check the method table is negotiated, and that streaming requests then use
+ * the method index and reuse the request object.
+ */
+void RpcChannelTest::testMethodIndexes() {
+  const ServiceDescriptor *service = TestService::descriptor();
+  OLA_ASSERT_FALSE(m_channel->MethodIndexesAccepted(service));
+
+  // The first request is sent with the name, along with the offer.
+  m_request.set_data("foo");
+  m_stub->Stream(NULL, &m_request, NULL, NULL);
+  m_ss.Run();
+  OLA_ASSERT_EQ(1u, m_service->StreamCount());
+
+  WaitForMethodTable(service);
+  OLA_ASSERT_TRUE(m_channel->MethodIndexesAccepted(service));
+
+  // Check the bytes on the wire for each frame.
+  OLA_ASSERT_EQ(0, m_socket->DataRemaining());
+  m_stub->Stream(NULL, &m_request, NULL, NULL);
+  OLA_ASSERT_EQ(StreamFrameSize(true), m_socket->DataRemaining());
+  OLA_ASSERT_LT(StreamFrameSize(true), StreamFrameSize(false));
+  m_ss.Run();
+  OLA_ASSERT_EQ(2u, m_service->StreamCount());
+
+  // The same request object is used for each frame, rather than allocating a
+  // new one.
+  const EchoRequest *request = m_service->LastStreamRequest();
+  m_stub->Stream(NULL, &m_request, NULL, NULL);
+  m_ss.Run();
+  OLA_ASSERT_EQ(3u, m_service->StreamCount());
+  OLA_ASSERT_EQ(request, m_service->LastStreamRequest());
+
+  // Requests with a response work as well.
+  m_request.set_session_ptr(0);
+  m_stub->Echo(&m_controller,
+               &m_request,
+               &m_reply,
+               NewSingleCallback(this, &RpcChannelTest::EchoComplete));
+  m_ss.Run();
+}
+
+/*
+ * Check we keep using method names if the peer rejects the method table.
+ */
+void RpcChannelTest::testMethodTableRejected() {
+  const ServiceDescriptor *service = TestService::descriptor();
+
+  // With no service, the offer is rejected.
+  m_channel->SetService(NULL);
+  m_request.set_data("foo");
+  m_stub->Stream(NULL, &m_request, NULL, NULL);
+  WaitForMethodTable(service);
+  OLA_ASSERT_FALSE(m_channel->MethodIndexesAccepted(service));
+  OLA_ASSERT_EQ(0, m_socket->DataRemaining());
+
+  m_channel->SetService(m_service.get());
+  m_stub->Stream(NULL, &m_request, NULL, NULL);
+  OLA_ASSERT_EQ(StreamFrameSize(false), m_socket->DataRemaining());
+  m_ss.Run();
+  OLA_ASSERT_EQ(1u, m_service->StreamCount());
+  OLA_ASSERT_FALSE(m_channel->MethodIndexesAccepted(service));
+}
+
+/*
+ * Check we don't send an offer to a peer that spoke first without offering,
+ * since older peers can't handle it.
+ */
+void RpcChannelTest::testNoOfferToOlderPeers() {
+  const ServiceDescriptor *service = TestService::descriptor();
+
+  // A request from an older peer, which only knows about method names.
+  m_request.set_data("foo");
+  RpcMessage message;
+  message.set_type(ola::rpc::STREAM_REQUEST);
+  message.set_id(1);
+  message.set_name("Stream");
+  message.set_buffer(m_request.SerializeAsString());
+  SendFromPeer(message);
+  m_ss.Run();
+  OLA_ASSERT_EQ(1u, m_service->StreamCount());
+
+  // Our request goes out on its own, without an offer in front of it.
+  OLA_ASSERT_EQ(0, m_socket->DataRemaining());
+  m_stub->Stream(NULL, &m_request, NULL, NULL);
+  OLA_ASSERT_EQ(StreamFrameSize(false), m_socket->DataRemaining());
+  m_ss.Run();
+  OLA_ASSERT_EQ(2u, m_service->StreamCount());
+  OLA_ASSERT_FALSE(m_channel->MethodIndexesAccepted(service));
+}
@@ -31,7 +31,11 @@
 
 class TestServiceImpl: public ola::rpc::TestService {
  public:
-  explicit TestServiceImpl(ola::io::SelectServer *ss) : m_ss(ss) {}
+  explicit TestServiceImpl(ola::io::SelectServer *ss)
+      : m_ss(ss),
+        m_stream_count(0),
+        m_last_stream_request(NULL) {
+  }
   ~TestServiceImpl() {}
 
   void Echo(ola::rpc::RpcController* controller,
@@ -48,8 +52,18 @@ class TestServiceImpl: public ola::rpc::TestService {
               const ola::rpc::EchoRequest* request,
               ola::rpc::STREAMING_NO_RESPONSE* response,
               CompletionCallback* done);
+
+  unsigned int StreamCount() const { return m_stream_count; }
+
+  // Only used to check if the request objects are reused.
+  const ola::rpc::EchoRequest *LastStreamRequest() const {
+    return m_last_stream_request;
+  }
+
  private:
   ola::io::SelectServer *m_ss;
+  unsigned int m_stream_count;
+  const ola::rpc::EchoRequest *m_last_stream_request;
 };
 
 
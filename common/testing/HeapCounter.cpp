@@ -0,0 +1,133 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * HeapCounter.cpp
+ * Replaces the global operator new & delete to count the heap usage.
+ * Copyright (C) 2026 agent
+ */
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <new>
+
+#include "ola/testing/HeapCounter.h"
+
+namespace {
+
+// The lock is statically initialized, since memory can be allocated before
+// any constructors run.
+pthread_mutex_t heap_lock = PTHREAD_MUTEX_INITIALIZER;
+ola::testing::HeapStats heap_stats = {0, 0, 0, 0};
+
+// Each allocation is prefixed with its size. This keeps the allocations
+// aligned.
+const size_t HEADER_SIZE = 16;
+
+void *CountedAlloc(size_t size) {
+  uint8_t *ptr = static_cast<uint8_t*>(malloc(size + HEADER_SIZE));
+  if (!ptr) {
+    return NULL;
+  }
+  *reinterpret_cast<size_t*>(ptr) = size;
+
+  pthread_mutex_lock(&heap_lock);
+  heap_stats.current += size;
+  heap_stats.allocations++;
+  heap_stats.bytes += size;
+  if (heap_stats.current > heap_stats.peak) {
+    heap_stats.peak = heap_stats.current;
+  }
+  pthread_mutex_unlock(&heap_lock);
+  return ptr + HEADER_SIZE;
+}
+
+void *CountedAllocOrThrow(size_t size) {
+  void *ptr = CountedAlloc(size);
+  if (!ptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void CountedFree(void *ptr) {
+  if (!ptr) {
+    return;
+  }
+  uint8_t *block = static_cast<uint8_t*>(ptr) - HEADER_SIZE;
+  pthread_mutex_lock(&heap_lock);
+  heap_stats.current -= *reinterpret_cast<size_t*>(block);
+  pthread_mutex_unlock(&heap_lock);
+  free(block);
+}
+}  // namespace
+
+namespace ola {
+namespace testing {
+
+HeapStats GetHeapStats() {
+  pthread_mutex_lock(&heap_lock);
+  HeapStats stats = heap_stats;
+  pthread_mutex_unlock(&heap_lock);
+  return stats;
+}
+
+void ResetHeapPeak() {
+  pthread_mutex_lock(&heap_lock);
+  heap_stats.peak = heap_stats.current;
+  pthread_mutex_unlock(&heap_lock);
+}
+}  // namespace testing
+}  // namespace ola
+
+#if __cplusplus >= 201103L
+#define OLA_HEAP_NEW_THROW
+#define OLA_HEAP_NO_THROW noexcept
+#else
+#define OLA_HEAP_NEW_THROW throw(std::bad_alloc)
+#define OLA_HEAP_NO_THROW throw()
+#endif
+
+void *operator new(size_t size) OLA_HEAP_NEW_THROW {
+  return CountedAllocOrThrow(size);
+}
+
+void *operator new[](size_t size) OLA_HEAP_NEW_THROW {
+  return CountedAllocOrThrow(size);
+}
+
+void *operator new(size_t size, const std::nothrow_t&) OLA_HEAP_NO_THROW {
+  return CountedAlloc(size);
+}
+
+void *operator new[](size_t size, const std::nothrow_t&) OLA_HEAP_NO_THROW {
+  return CountedAlloc(size);
+}
+
+void operator delete(void *ptr) OLA_HEAP_NO_THROW {
+  CountedFree(ptr);
+}
+
+void operator delete[](void *ptr) OLA_HEAP_NO_THROW {
+  CountedFree(ptr);
+}
+
+void operator delete(void *ptr, const std::nothrow_t&) OLA_HEAP_NO_THROW {
+  CountedFree(ptr);
+}
+
+void operator delete[](void *ptr, const std::nothrow_t&) OLA_HEAP_NO_THROW {
+  CountedFree(ptr);
+}
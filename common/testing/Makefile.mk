@@ -8,3 +8,8 @@ common_testing_libolatesting_la_SOURCES = \
     common/testing/TestUtils.cpp
 common_testing_libtestmain_la_SOURCES = common/testing/GenericTester.cpp
 endif
+
+# This replaces the global operator new & delete, so it's only linked into
+# the benchmarks.
+noinst_LTLIBRARIES += common/testing/libolaheapcounter.la
+common_testing_libolaheapcounter_la_SOURCES = common/testing/HeapCounter.cpp
@@ -8,6 +8,8 @@ common_libolacommon_la_SOURCES += \
     common/thread/SignalThread.cpp \
     common/thread/Thread.cpp \
     common/thread/ThreadPool.cpp \
+    common/thread/TimerWheel.cpp \
+    common/thread/TripleBuffer.cpp \
     common/thread/Utils.cpp
 
 # TESTS
@@ -18,7 +20,9 @@ test_programs += common/thread/ExecutorThreadTester \
 
 common_thread_ThreadTester_SOURCES = \
     common/thread/ThreadPoolTest.cpp \
-    common/thread/ThreadTest.cpp
+    common/thread/ThreadTest.cpp \
+    common/thread/TimerWheelTest.cpp \
+    common/thread/TripleBufferTest.cpp
 common_thread_ThreadTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 common_thread_ThreadTester_LDADD = $(COMMON_TESTING_LIBS)
 
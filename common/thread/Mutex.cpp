@@ -32,6 +32,23 @@ Mutex::Mutex() {
 }
 
 
+/**
+ * Construct a new mutex object of the given type.
+ * @param type the type of mutex to create.
+ */
+Mutex::Mutex(MutexType type) {
+  if (type == RECURSIVE) {
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&m_mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+  } else {
+    pthread_mutex_init(&m_mutex, NULL);
+  }
+}
+
+
 /**
  * Clean up
  */
@@ -0,0 +1,166 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * TimerWheel.cpp
+ * Schedule many coarse timers with a single timeout.
+ * Copyright (C) 2026 agent
+ */
+
+#include <stdint.h>
+#include "ola/Callback.h"
+#include "ola/Logging.h"
+#include "ola/thread/TimerWheel.h"
+
+namespace ola {
+namespace thread {
+
+TimerWheel::Timer::Timer(Callback0<void> *callback)
+    : m_callback(callback),
+      m_wheel(NULL),
+      m_expiry(0),
+      m_previous(this),
+      m_next(this) {
+}
+
+TimerWheel::Timer::Timer()
+    : m_callback(NULL),
+      m_wheel(NULL),
+      m_expiry(0),
+      m_previous(this),
+      m_next(this) {
+}
+
+TimerWheel::Timer::~Timer() {
+  if (m_wheel) {
+    m_wheel->Cancel(this);
+  }
+  delete m_callback;
+}
+
+void TimerWheel::Timer::Unlink() {
+  m_previous->m_next = m_next;
+  m_next->m_previous = m_previous;
+  m_previous = this;
+  m_next = this;
+}
+
+TimerWheel::TimerWheel(SchedulerInterface *scheduler,
+                       const TimeInterval &tick,
+                       unsigned int slot_count)
+    : m_scheduler(scheduler),
+      m_tick(tick),
+      m_slot_count(slot_count ? slot_count : 1),
+      m_slots(new Timer[m_slot_count]),
+      m_current_tick(0),
+      m_size(0),
+      m_tick_timeout(INVALID_TIMEOUT) {
+}
+
+TimerWheel::~TimerWheel() {
+  if (m_tick_timeout != INVALID_TIMEOUT) {
+    m_scheduler->RemoveTimeout(m_tick_timeout);
+  }
+  // Detach any timers which are still scheduled.
+  for (unsigned int i = 0; i < m_slot_count; i++) {
+    Timer *head = &m_slots[i];
+    while (head->m_next != head) {
+      Timer *timer = head->m_next;
+      timer->Unlink();
+      timer->m_wheel = NULL;
+    }
+  }
+  delete[] m_slots;
+}
+
+void TimerWheel::Schedule(Timer *timer, const TimeInterval &delay) {
+  if (timer->m_wheel) {
+    timer->m_wheel->Cancel(timer);
+  }
+
+  // The next tick may be almost immediate, so add one to the tick count.
+  int64_t tick = m_tick.AsInt();
+  int64_t ticks = tick > 0 ? (delay.AsInt() + tick - 1) / tick : 0;
+  if (ticks < 0) {
+    ticks = 0;
+  }
+  timer->m_expiry = m_current_tick + ticks + 1;
+  timer->m_wheel = this;
+  Insert(timer);
+  m_size++;
+
+  if (m_tick_timeout == INVALID_TIMEOUT) {
+    m_tick_timeout = m_scheduler->RegisterRepeatingTimeout(
+        m_tick, NewCallback(this, &TimerWheel::AdvanceTick));
+  }
+}
+
+void TimerWheel::Cancel(Timer *timer) {
+  if (timer->m_wheel != this) {
+    if (timer->m_wheel) {
+      OLA_WARN << "Attempt to cancel a timer on a different wheel";
+    }
+    return;
+  }
+  timer->Unlink();
+  timer->m_wheel = NULL;
+  m_size--;
+}
+
+bool TimerWheel::AdvanceTick() {
+  m_current_tick++;
+
+  // Move the slot's timers to a separate list first, the callbacks may
+  // schedule or cancel other timers in this slot.
+  Timer *head = &m_slots[m_current_tick % m_slot_count];
+  Timer pending;
+  if (head->m_next != head) {
+    pending.m_next = head->m_next;
+    pending.m_previous = head->m_previous;
+    pending.m_next->m_previous = &pending;
+    pending.m_previous->m_next = &pending;
+    head->m_next = head;
+    head->m_previous = head;
+  }
+
+  while (pending.m_next != &pending) {
+    Timer *timer = pending.m_next;
+    timer->Unlink();
+    if (timer->m_expiry > m_current_tick) {
+      // Not due until a later revolution.
+      Insert(timer);
+      continue;
+    }
+    timer->m_wheel = NULL;
+    m_size--;
+    timer->m_callback->Run();
+  }
+
+  if (m_size == 0) {
+    // Stop ticking until a timer is scheduled.
+    m_tick_timeout = INVALID_TIMEOUT;
+    return false;
+  }
+  return true;
+}
+
+void TimerWheel::Insert(Timer *timer) {
+  Timer *head = &m_slots[timer->m_expiry % m_slot_count];
+  timer->m_next = head;
+  timer->m_previous = head->m_previous;
+  head->m_previous->m_next = timer;
+  head->m_previous = timer;
+}
+}  // namespace thread
+}  // namespace ola
@@ -0,0 +1,266 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * TimerWheelTest.cpp
+ * Test fixture for the TimerWheel class
+ * Copyright (C) 2026 agent
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <memory>
+#include <vector>
+
+#include "ola/Callback.h"
+#include "ola/Clock.h"
+#include "ola/Logging.h"
+#include "ola/testing/TestUtils.h"
+#include "ola/thread/SchedulerInterface.h"
+#include "ola/thread/TimerWheel.h"
+
+using ola::NewCallback;
+using ola::TimeInterval;
+using ola::thread::TimerWheel;
+using ola::thread::timeout_id;
+using std::auto_ptr;
+using std::vector;
+
+namespace {
+
+/*
+ * A scheduler which only holds the wheel's repeating timeout, and runs it when
+ * Tick() is called.
+ */
+class TickScheduler: public ola::thread::SchedulerInterface {
+ public:
+  TickScheduler() : m_callback(NULL), m_registrations(0) {}
+  ~TickScheduler() { delete m_callback; }
+
+  timeout_id RegisterRepeatingTimeout(unsigned int,
+                                      ola::Callback0<bool> *callback) {
+    return Register(callback);
+  }
+
+  timeout_id RegisterRepeatingTimeout(const TimeInterval &,
+                                      ola::Callback0<bool> *callback) {
+    return Register(callback);
+  }
+
+  timeout_id RegisterSingleTimeout(unsigned int,
+                                   ola::SingleUseCallback0<void> *callback) {
+    delete callback;
+    return ola::thread::INVALID_TIMEOUT;
+  }
+
+  timeout_id RegisterSingleTimeout(const TimeInterval &,
+                                   ola::SingleUseCallback0<void> *callback) {
+    delete callback;
+    return ola::thread::INVALID_TIMEOUT;
+  }
+
+  void RemoveTimeout(timeout_id) {
+    delete m_callback;
+    m_callback = NULL;
+  }
+
+  // Run the repeating timeout n times.
+  void Tick(unsigned int n = 1) {
+    for (unsigned int i = 0; i < n && m_callback; i++) {
+      if (!m_callback->Run()) {
+        delete m_callback;
+        m_callback = NULL;
+      }
+    }
+  }
+
+  bool Active() const { return m_callback != NULL; }
+  unsigned int Registrations() const { return m_registrations; }
+
+ private:
+  ola::Callback0<bool> *m_callback;
+  unsigned int m_registrations;
+
+  timeout_id Register(ola::Callback0<bool> *callback) {
+    delete m_callback;
+    m_callback = callback;
+    m_registrations++;
+    return this;
+  }
+};
+}  // namespace
+
+
+class TimerWheelTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(TimerWheelTest);
+  CPPUNIT_TEST(testExpiry);
+  CPPUNIT_TEST(testReschedule);
+  CPPUNIT_TEST(testLongDelay);
+  CPPUNIT_TEST(testCallbacks);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void testExpiry();
+  void testReschedule();
+  void testLongDelay();
+  void testCallbacks();
+
+  void Expired(unsigned int id) { m_expired.push_back(id); }
+
+  void CancelTimer(TimerWheel *wheel, TimerWheel::Timer *timer) {
+    wheel->Cancel(timer);
+  }
+
+  void RescheduleTimer(TimerWheel *wheel, TimerWheel::Timer *timer) {
+    wheel->Schedule(timer, TimeInterval(0, 100000));
+  }
+
+ private:
+  vector<unsigned int> m_expired;
+
+  TimerWheel::Timer *NewTimer(unsigned int id) {
+    return new TimerWheel::Timer(
+        NewCallback(this, &TimerWheelTest::Expired, id));
+  }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TimerWheelTest);
+
+
+/*
+ * Check timers expire after their delay, and the tick stops when idle.
+ */
+void TimerWheelTest::testExpiry() {
+  TickScheduler scheduler;
+  TimerWheel wheel(&scheduler, TimeInterval(0, 100000), 8);
+  auto_ptr<TimerWheel::Timer> timer1(NewTimer(1));
+  auto_ptr<TimerWheel::Timer> timer2(NewTimer(2));
+
+  OLA_ASSERT_FALSE(scheduler.Active());
+  wheel.Schedule(timer1.get(), TimeInterval(0, 200000));
+  wheel.Schedule(timer2.get(), TimeInterval(0, 250000));
+  OLA_ASSERT_EQ(2u, wheel.Size());
+  OLA_ASSERT_TRUE(timer1->Scheduled());
+  OLA_ASSERT_TRUE(scheduler.Active());
+  OLA_ASSERT_EQ(1u, scheduler.Registrations());
+
+  // 200ms is two ticks, plus one for the partial tick.
+  scheduler.Tick(2);
+  OLA_ASSERT_EMPTY(m_expired);
+  scheduler.Tick();
+  OLA_ASSERT_EQ(static_cast<size_t>(1), m_expired.size());
+  OLA_ASSERT_EQ(1u, m_expired[0]);
+  OLA_ASSERT_FALSE(timer1->Scheduled());
+  OLA_ASSERT_EQ(1u, wheel.Size());
+
+  // 250ms rounds up to three ticks.
+  scheduler.Tick();
+  OLA_ASSERT_EQ(static_cast<size_t>(2), m_expired.size());
+  OLA_ASSERT_EQ(2u, m_expired[1]);
+  OLA_ASSERT_EQ(0u, wheel.Size());
+
+  // No timers are left, so the wheel stops ticking.
+  OLA_ASSERT_FALSE(scheduler.Active());
+
+  // And starts again when one is scheduled.
+  wheel.Schedule(timer1.get(), TimeInterval());
+  OLA_ASSERT_EQ(2u, scheduler.Registrations());
+  scheduler.Tick();
+  OLA_ASSERT_EQ(static_cast<size_t>(3), m_expired.size());
+}
+
+
+/*
+ * Check rescheduling and cancelling timers.
+ */
+void TimerWheelTest::testReschedule() {
+  TickScheduler scheduler;
+  TimerWheel wheel(&scheduler, TimeInterval(0, 100000), 8);
+  auto_ptr<TimerWheel::Timer> timer1(NewTimer(1));
+  auto_ptr<TimerWheel::Timer> timer2(NewTimer(2));
+
+  wheel.Schedule(timer1.get(), TimeInterval(0, 300000));
+  wheel.Schedule(timer2.get(), TimeInterval(0, 300000));
+
+  // Keep pushing timer1 back, as a heartbeat would.
+  for (unsigned int i = 0; i < 10; i++) {
+    scheduler.Tick();
+    wheel.Schedule(timer1.get(), TimeInterval(0, 300000));
+  }
+  OLA_ASSERT_EQ(static_cast<size_t>(1), m_expired.size());
+  OLA_ASSERT_EQ(2u, m_expired[0]);
+  OLA_ASSERT_EQ(1u, wheel.Size());
+
+  wheel.Cancel(timer1.get());
+  OLA_ASSERT_FALSE(timer1->Scheduled());
+  OLA_ASSERT_EQ(0u, wheel.Size());
+  // Cancelling twice is fine.
+  wheel.Cancel(timer1.get());
+  scheduler.Tick(10);
+  OLA_ASSERT_EQ(static_cast<size_t>(1), m_expired.size());
+
+  // Deleting a scheduled timer cancels it.
+  wheel.Schedule(timer2.get(), TimeInterval(0, 100000));
+  OLA_ASSERT_EQ(1u, wheel.Size());
+  timer2.reset();
+  OLA_ASSERT_EQ(0u, wheel.Size());
+  scheduler.Tick(10);
+  OLA_ASSERT_EQ(static_cast<size_t>(1), m_expired.size());
+}
+
+
+/*
+ * Check timers further away than one revolution of the wheel.
+ */
+void TimerWheelTest::testLongDelay() {
+  TickScheduler scheduler;
+  TimerWheel wheel(&scheduler, TimeInterval(0, 100000), 4);
+  auto_ptr<TimerWheel::Timer> timer1(NewTimer(1));
+
+  // 10 ticks is two and a half revolutions.
+  wheel.Schedule(timer1.get(), TimeInterval(1, 0));
+  scheduler.Tick(10);
+  OLA_ASSERT_EMPTY(m_expired);
+  scheduler.Tick();
+  OLA_ASSERT_EQ(static_cast<size_t>(1), m_expired.size());
+}
+
+
+/*
+ * Check callbacks can cancel and schedule timers in the same slot.
+ */
+void TimerWheelTest::testCallbacks() {
+  TickScheduler scheduler;
+  TimerWheel wheel(&scheduler, TimeInterval(0, 100000), 8);
+  auto_ptr<TimerWheel::Timer> timer1(NewTimer(1));
+  auto_ptr<TimerWheel::Timer> timer2(NewTimer(2));
+  auto_ptr<TimerWheel::Timer> canceller(new TimerWheel::Timer(
+      NewCallback(this, &TimerWheelTest::CancelTimer, &wheel, timer1.get())));
+  auto_ptr<TimerWheel::Timer> rescheduler(new TimerWheel::Timer(
+      NewCallback(this, &TimerWheelTest::RescheduleTimer, &wheel,
+                  timer2.get())));
+
+  wheel.Schedule(canceller.get(), TimeInterval());
+  wheel.Schedule(rescheduler.get(), TimeInterval());
+  wheel.Schedule(timer1.get(), TimeInterval());
+  wheel.Schedule(timer2.get(), TimeInterval());
+  OLA_ASSERT_EQ(4u, wheel.Size());
+
+  scheduler.Tick();
+  // timer1 was cancelled and timer2 pushed back before they ran.
+  OLA_ASSERT_EMPTY(m_expired);
+  OLA_ASSERT_EQ(1u, wheel.Size());
+  scheduler.Tick(2);
+  OLA_ASSERT_EQ(static_cast<size_t>(1), m_expired.size());
+  OLA_ASSERT_EQ(2u, m_expired[0]);
+}
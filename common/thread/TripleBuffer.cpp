@@ -0,0 +1,86 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * TripleBuffer.cpp
+ * Pass the latest value from one thread to another without locking.
+ * Copyright (C) 2026 agent
+ *
+ * The slot indices are swapped with a single atomic exchange on each side.
+ * The exchange is acquire-release, so the writer's changes to a slot are
+ * visible to the reader once it swaps that slot in, and the reader is done
+ * with a slot before the writer can get it back.
+ */
+
+#include <stdint.h>
+#include "ola/thread/TripleBuffer.h"
+
+namespace ola {
+namespace thread {
+
+namespace {
+
+inline uint32_t AtomicExchange(uint32_t *ptr, uint32_t value) {
+#ifdef __ATOMIC_ACQ_REL
+  return __atomic_exchange_n(ptr, value, __ATOMIC_ACQ_REL);
+#else
+  // __sync_lock_test_and_set is only an acquire barrier.
+  __sync_synchronize();
+  return __sync_lock_test_and_set(ptr, value);
+#endif  // __ATOMIC_ACQ_REL
+}
+
+inline uint32_t AtomicLoad(const uint32_t *ptr) {
+#ifdef __ATOMIC_ACQUIRE
+  return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+#else
+  uint32_t value = *const_cast<const volatile uint32_t*>(ptr);
+  __sync_synchronize();
+  return value;
+#endif  // __ATOMIC_ACQUIRE
+}
+}  // namespace
+
+TripleBufferIndex::TripleBufferIndex()
+    : m_front(0),
+      m_back(2),
+      m_middle(1),
+      m_next_sequence(1) {
+  for (unsigned int i = 0; i < 3; i++) {
+    m_sequence[i] = 0;
+  }
+}
+
+bool TripleBufferIndex::Publish() {
+  m_sequence[m_back] = m_next_sequence++;
+  uint32_t old_middle = AtomicExchange(&m_middle, m_back | FRESH);
+  m_back = old_middle & INDEX_MASK;
+  return old_middle & FRESH;
+}
+
+bool TripleBufferIndex::HasUpdate() const {
+  return AtomicLoad(&m_middle) & FRESH;
+}
+
+bool TripleBufferIndex::Update() {
+  // Only the reader clears FRESH, so if it's set now it will still be set
+  // when we swap, although the slot may have changed.
+  if (!HasUpdate()) {
+    return false;
+  }
+  m_front = AtomicExchange(&m_middle, m_front) & INDEX_MASK;
+  return true;
+}
+}  // namespace thread
+}  // namespace ola
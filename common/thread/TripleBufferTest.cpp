@@ -0,0 +1,182 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * TripleBufferTest.cpp
+ * Test fixture for the TripleBuffer class
+ * Copyright (C) 2026 agent
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <stdint.h>
+
+#include "ola/DmxBuffer.h"
+#include "ola/Logging.h"
+#include "ola/testing/TestUtils.h"
+#include "ola/thread/Thread.h"
+#include "ola/thread/TripleBuffer.h"
+
+using ola::DmxBuffer;
+using ola::thread::Thread;
+using ola::thread::TripleBuffer;
+
+namespace {
+
+const unsigned int FRAME_COUNT = 200000;
+
+// A value that's easy to spot if it's only partly written.
+struct Frame {
+  Frame() : value(0), inverse(~0u) {}
+
+  unsigned int value;
+  unsigned int inverse;
+};
+
+// Publishes FRAME_COUNT frames as fast as it can.
+class WriterThread: public Thread {
+ public:
+  explicit WriterThread(TripleBuffer<Frame> *frames)
+      : Thread(Thread::Options("TripleBufferWriter")),
+        m_frames(frames) {
+  }
+
+  void *Run() {
+    for (unsigned int i = 1; i <= FRAME_COUNT; i++) {
+      Frame *frame = m_frames->WriteBuffer();
+      frame->value = i;
+      frame->inverse = ~i;
+      m_frames->Publish();
+    }
+    return NULL;
+  }
+
+ private:
+  TripleBuffer<Frame> *m_frames;
+};
+}  // namespace
+
+
+class TripleBufferTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(TripleBufferTest);
+  CPPUNIT_TEST(testLatestValue);
+  CPPUNIT_TEST(testDmxBuffer);
+  CPPUNIT_TEST(testConcurrentAccess);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void testLatestValue();
+  void testDmxBuffer();
+  void testConcurrentAccess();
+
+  void setUp() {
+    ola::InitLogging(ola::OLA_LOG_INFO, ola::OLA_LOG_STDERR);
+  }
+};
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TripleBufferTest);
+
+
+/**
+ * Check the reader sees the newest value, and the sequence numbers.
+ */
+void TripleBufferTest::testLatestValue() {
+  TripleBuffer<unsigned int> values;
+  OLA_ASSERT_FALSE(values.HasUpdate());
+  OLA_ASSERT_FALSE(values.Update());
+  OLA_ASSERT_EQ(static_cast<uint64_t>(0), values.Sequence());
+
+  *values.WriteBuffer() = 10;
+  OLA_ASSERT_FALSE(values.Publish());
+  OLA_ASSERT_TRUE(values.HasUpdate());
+  OLA_ASSERT_TRUE(values.Update());
+  OLA_ASSERT_FALSE(values.HasUpdate());
+  OLA_ASSERT_EQ(10u, values.ReadBuffer());
+  OLA_ASSERT_EQ(static_cast<uint64_t>(1), values.Sequence());
+
+  // Nothing new, the read buffer doesn't change.
+  OLA_ASSERT_FALSE(values.Update());
+  OLA_ASSERT_EQ(10u, values.ReadBuffer());
+
+  // Publish twice, the first value is dropped.
+  *values.WriteBuffer() = 11;
+  OLA_ASSERT_FALSE(values.Publish());
+  *values.WriteBuffer() = 12;
+  OLA_ASSERT_TRUE(values.Publish());
+  OLA_ASSERT_EQ(10u, values.ReadBuffer());
+  OLA_ASSERT_TRUE(values.Update());
+  OLA_ASSERT_EQ(12u, values.ReadBuffer());
+  OLA_ASSERT_EQ(static_cast<uint64_t>(3), values.Sequence());
+
+  // The writer never gets the slot the reader is using.
+  for (unsigned int i = 13; i < 20; i++) {
+    *values.WriteBuffer() = i;
+    values.Publish();
+    OLA_ASSERT_EQ(12u, values.ReadBuffer());
+  }
+  OLA_ASSERT_TRUE(values.Update());
+  OLA_ASSERT_EQ(19u, values.ReadBuffer());
+  OLA_ASSERT_EQ(static_cast<uint64_t>(10), values.Sequence());
+}
+
+
+/**
+ * Check DmxBuffers are passed through.
+ */
+void TripleBufferTest::testDmxBuffer() {
+  TripleBuffer<DmxBuffer> frames;
+  OLA_ASSERT_EQ(0u, frames.ReadBuffer().Size());
+
+  DmxBuffer buffer;
+  buffer.SetFromString("1,2,3");
+  frames.WriteBuffer()->Set(buffer);
+  frames.Publish();
+  frames.Update();
+  OLA_ASSERT_EQ(buffer, frames.ReadBuffer());
+
+  buffer.SetFromString("4,5");
+  frames.WriteBuffer()->Set(buffer);
+  frames.Publish();
+  OLA_ASSERT_EQ(3u, frames.ReadBuffer().Size());
+  frames.Update();
+  OLA_ASSERT_EQ(buffer, frames.ReadBuffer());
+}
+
+
+/**
+ * Check the reader never sees a partly written value, and the values only
+ * move forwards.
+ */
+void TripleBufferTest::testConcurrentAccess() {
+  TripleBuffer<Frame> frames;
+  WriterThread writer(&frames);
+  OLA_ASSERT_TRUE(writer.Start());
+
+  unsigned int last_value = 0;
+  unsigned int updates = 0;
+  while (last_value < FRAME_COUNT) {
+    if (!frames.Update()) {
+      continue;
+    }
+    const Frame &frame = frames.ReadBuffer();
+    OLA_ASSERT_EQ(~frame.value, frame.inverse);
+    OLA_ASSERT_TRUE(frame.value > last_value);
+    OLA_ASSERT_EQ(static_cast<uint64_t>(frame.value), frames.Sequence());
+    last_value = frame.value;
+    updates++;
+  }
+  OLA_ASSERT_TRUE(writer.Join());
+  OLA_ASSERT_TRUE(updates > 0);
+  OLA_ASSERT_FALSE(frames.Update());
+}
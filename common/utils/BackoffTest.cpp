@@ -26,12 +26,14 @@
 
 #include "ola/Callback.h"
 #include "ola/Clock.h"
+#include "ola/math/Random.h"
 #include "ola/util/Backoff.h"
 #include "ola/testing/TestUtils.h"
 
 
 using ola::BackoffGenerator;
 using ola::ExponentialBackoffPolicy;
+using ola::ExponentialJitterBackoffPolicy;
 using ola::LinearBackoffPolicy;
 using ola::TimeInterval;
 
@@ -40,12 +42,14 @@ class BackoffTest: public CppUnit::TestFixture {
 
   CPPUNIT_TEST(testLinearBackoffPolicy);
   CPPUNIT_TEST(testExponentialBackoffPolicy);
+  CPPUNIT_TEST(testExponentialJitterBackoffPolicy);
   CPPUNIT_TEST(testBackoffGenerator);
   CPPUNIT_TEST_SUITE_END();
 
  public:
     void testLinearBackoffPolicy();
     void testExponentialBackoffPolicy();
+    void testExponentialJitterBackoffPolicy();
     void testBackoffGenerator();
 };
 
@@ -85,6 +89,32 @@ void BackoffTest::testExponentialBackoffPolicy() {
 }
 
 
+/**
+ * Test the exponential backoff policy with jitter.
+ */
+void BackoffTest::testExponentialJitterBackoffPolicy() {
+  ola::math::InitRandom();
+  // start with 10s, up to 170s.
+  ExponentialJitterBackoffPolicy policy(TimeInterval(10, 0),
+                                        TimeInterval(170, 0));
+
+  OLA_ASSERT_EQ(TimeInterval(0, 0), policy.BackOffTime(0));
+
+  const int expected[] = {10, 20, 40, 80, 160, 170, 170, 170};
+  for (unsigned int i = 0; i < sizeof(expected) / sizeof(expected[0]); i++) {
+    for (unsigned int j = 0; j < 20; j++) {
+      TimeInterval interval = policy.BackOffTime(i + 1);
+      OLA_ASSERT_TRUE(interval >= TimeInterval(expected[i] / 2, 0));
+      OLA_ASSERT_TRUE(interval <= TimeInterval(expected[i], 0));
+    }
+  }
+
+  // Large numbers of failures shouldn't overflow.
+  OLA_ASSERT_TRUE(policy.BackOffTime(1000) <= TimeInterval(170, 0));
+  OLA_ASSERT_TRUE(policy.BackOffTime(1000) >= TimeInterval(85, 0));
+}
+
+
 /**
  * Test the BackoffGenerator
  */
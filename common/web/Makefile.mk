@@ -30,6 +30,8 @@ common_web_libolaweb_la_SOURCES = \
     common/web/JsonWriter.cpp \
     common/web/PointerTracker.cpp \
     common/web/PointerTracker.h \
+    common/web/SchemaCompiler.cpp \
+    common/web/SchemaCompiler.h \
     common/web/SchemaErrorLogger.cpp \
     common/web/SchemaErrorLogger.h \
     common/web/SchemaKeywords.cpp \
@@ -37,13 +39,23 @@ common_web_libolaweb_la_SOURCES = \
     common/web/SchemaParseContext.cpp \
     common/web/SchemaParseContext.h \
     common/web/SchemaParser.cpp \
-    common/web/SchemaParser.h
+    common/web/SchemaParser.h \
+    common/web/StreamingSchemaValidator.cpp
 
 if USING_WIN32
 #Work around limitations with Windows library linking
 common_web_libolaweb_la_LIBADD = common/libolacommon.la
 endif
 
+# PROGRAMS
+################################################
+noinst_PROGRAMS += common/web/schema_benchmark
+
+common_web_schema_benchmark_SOURCES = common/web/schema_benchmark.cpp
+common_web_schema_benchmark_LDADD = common/libolacommon.la \
+                                    common/web/libolaweb.la \
+                                    common/testing/libolaheapcounter.la
+
 # TESTS
 ################################################
 # Patch test names are abbreviated to prevent Windows' UAC from blocking them.
@@ -56,7 +68,8 @@ test_programs += \
     common/web/PointerTrackerTester \
     common/web/SchemaParserTester \
     common/web/SchemaTester \
-    common/web/SectionsTester
+    common/web/SectionsTester \
+    common/web/StreamingSchemaTester
 
 COMMON_WEB_TEST_LDADD = $(COMMON_TESTING_LIBS) \
                         common/web/libolaweb.la
@@ -96,3 +109,8 @@ common_web_SchemaTester_LDADD = $(COMMON_WEB_TEST_LDADD)
 common_web_SectionsTester_SOURCES = common/web/SectionsTest.cpp
 common_web_SectionsTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 common_web_SectionsTester_LDADD = $(COMMON_WEB_TEST_LDADD)
+
+common_web_StreamingSchemaTester_SOURCES = \
+    common/web/StreamingSchemaValidatorTest.cpp
+common_web_StreamingSchemaTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
+common_web_StreamingSchemaTester_LDADD = $(COMMON_WEB_TEST_LDADD)
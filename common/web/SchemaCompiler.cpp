@@ -0,0 +1,259 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * SchemaCompiler.cpp
+ * Compiles a JsonSchema into a form that can validate parser events.
+ * Copyright (C) 2026 agent
+ */
+
+#include <string>
+#include <vector>
+
+#include "common/web/SchemaCompiler.h"
+#include "ola/stl/STLUtils.h"
+#include "ola/web/Json.h"
+#include "ola/web/JsonSchema.h"
+
+namespace ola {
+namespace web {
+
+using std::string;
+using std::vector;
+
+namespace {
+
+/*
+ * Collects the string values from a list of enums.
+ */
+class StringEnumCollector : public JsonValueConstVisitorInterface {
+ public:
+  explicit StringEnumCollector(CompiledSchemaNode::StringSet *strings)
+      : m_strings(strings) {
+  }
+
+  void Visit(const JsonString &value) { m_strings->insert(value.Value()); }
+  void Visit(const JsonBool &) {}
+  void Visit(const JsonNull &) {}
+  void Visit(const JsonRawValue &) {}
+  void Visit(const JsonObject &) {}
+  void Visit(const JsonArray &) {}
+  void Visit(const JsonUInt &) {}
+  void Visit(const JsonUInt64 &) {}
+  void Visit(const JsonInt &) {}
+  void Visit(const JsonInt64 &) {}
+  void Visit(const JsonDouble &) {}
+
+ private:
+  CompiledSchemaNode::StringSet *m_strings;
+};
+}  // namespace
+
+CompiledSchema::~CompiledSchema() {
+  STLDeleteElements(&m_nodes);
+}
+
+CompiledSchema *SchemaCompiler::Compile(JsonSchema *schema) {
+  m_schema = new CompiledSchema();
+  m_cache.clear();
+  m_schema->m_root = CompileValidator(schema->m_root_validator.get());
+  m_cache.clear();
+
+  CompiledSchema *compiled_schema = m_schema;
+  m_schema = NULL;
+  return compiled_schema;
+}
+
+void SchemaCompiler::Visit(WildcardValidator *) {
+  m_current->kind = CompiledSchemaNode::ANY;
+}
+
+void SchemaCompiler::Visit(ReferenceValidator *validator) {
+  CompiledSchemaNode *node = m_current;
+  node->kind = CompiledSchemaNode::REFERENCE;
+  ValidatorInterface *target = validator->m_definitions->Lookup(
+      validator->m_schema);
+  if (target) {
+    node->children.push_back(CompileValidator(target));
+  }
+}
+
+void SchemaCompiler::Visit(StringValidator *validator) {
+  CompiledSchemaNode *node = m_current;
+  node->kind = CompiledSchemaNode::SCALAR;
+  if (validator->m_enums.empty()) {
+    return;
+  }
+
+  // Build a table of the enums so we don't need to create a JsonString for
+  // every value.
+  node->has_string_enums = true;
+  node->min_length = validator->m_options.min_length;
+  node->max_length = validator->m_options.max_length;
+  StringEnumCollector collector(&node->string_enums);
+  vector<const JsonValue*>::const_iterator iter = validator->m_enums.begin();
+  for (; iter != validator->m_enums.end(); ++iter) {
+    (*iter)->Accept(&collector);
+  }
+}
+
+void SchemaCompiler::Visit(BoolValidator *) {
+  m_current->kind = CompiledSchemaNode::SCALAR;
+}
+
+void SchemaCompiler::Visit(NullValidator *) {
+  m_current->kind = CompiledSchemaNode::SCALAR;
+}
+
+void SchemaCompiler::Visit(IntegerValidator *) {
+  m_current->kind = CompiledSchemaNode::SCALAR;
+}
+
+void SchemaCompiler::Visit(NumberValidator *) {
+  m_current->kind = CompiledSchemaNode::SCALAR;
+}
+
+void SchemaCompiler::Visit(ObjectValidator *validator) {
+  CompiledSchemaNode *node = m_current;
+  const ObjectValidator::Options &options = validator->m_options;
+
+  node->kind = CompiledSchemaNode::OBJECT;
+  node->min_properties = options.min_properties;
+  node->max_properties = options.max_properties;
+  node->required_properties = options.required_properties;
+  node->allow_additional_properties = !(
+      options.has_allow_additional_properties &&
+      !options.allow_additional_properties);
+  node->property_dependencies = validator->m_property_dependencies;
+
+  ObjectValidator::PropertyValidators::const_iterator iter =
+      validator->m_property_validators.begin();
+  for (; iter != validator->m_property_validators.end(); ++iter) {
+    node->properties[iter->first] = CompileValidator(iter->second);
+  }
+
+  node->additional_properties = CompileValidator(
+      validator->m_additional_property_validator.get());
+
+  ObjectValidator::SchemaDependencies::const_iterator dep_iter =
+      validator->m_schema_dependencies.begin();
+  for (; dep_iter != validator->m_schema_dependencies.end(); ++dep_iter) {
+    node->schema_dependencies[dep_iter->first] = CompileValidator(
+        dep_iter->second);
+  }
+
+  node->track_properties = (
+      node->min_properties > 0 || node->max_properties > 0 ||
+      !node->required_properties.empty() ||
+      !node->property_dependencies.empty() ||
+      !node->schema_dependencies.empty());
+}
+
+void SchemaCompiler::Visit(ArrayValidator *validator) {
+  CompiledSchemaNode *node = m_current;
+  const ArrayValidator::Options &options = validator->m_options;
+
+  if (options.unique_items) {
+    // Checking uniqueness needs all the items, so leave this as OPAQUE.
+    return;
+  }
+
+  node->kind = CompiledSchemaNode::ARRAY;
+  node->min_items = options.min_items;
+  node->max_items = options.max_items;
+
+  // See ArrayValidator::ConstructElementValidator()
+  const ArrayValidator::Items *items = validator->m_items.get();
+  const ArrayValidator::AdditionalItems *additional_items =
+      validator->m_additional_items.get();
+  if (!items) {
+    return;
+  }
+
+  if (items->Validator()) {
+    node->additional_items = CompileValidator(items->Validator());
+    return;
+  }
+
+  const ValidatorInterface::ValidatorList &validators = items->Validators();
+  ValidatorInterface::ValidatorList::const_iterator iter = validators.begin();
+  for (; iter != validators.end(); ++iter) {
+    node->item_list.push_back(CompileValidator(*iter));
+  }
+
+  if (additional_items) {
+    if (additional_items->Validator()) {
+      node->additional_items = CompileValidator(additional_items->Validator());
+    } else {
+      node->allow_additional_items = additional_items->AllowAdditional();
+    }
+  }
+}
+
+void SchemaCompiler::Visit(AllOfValidator *validator) {
+  CompileConjunction(CompiledSchemaNode::ALL_OF, validator);
+}
+
+void SchemaCompiler::Visit(AnyOfValidator *validator) {
+  CompileConjunction(CompiledSchemaNode::ANY_OF, validator);
+}
+
+void SchemaCompiler::Visit(OneOfValidator *validator) {
+  CompileConjunction(CompiledSchemaNode::ONE_OF, validator);
+}
+
+void SchemaCompiler::Visit(NotValidator *validator) {
+  CompiledSchemaNode *node = m_current;
+  node->kind = CompiledSchemaNode::NOT;
+  node->children.push_back(CompileValidator(validator->m_validator.get()));
+}
+
+/*
+ * Compile a validator, or return the existing node if we've already seen it.
+ */
+const CompiledSchemaNode *SchemaCompiler::CompileValidator(
+    ValidatorInterface *validator) {
+  if (!validator) {
+    return NULL;
+  }
+
+  CompiledSchemaNode *node = STLFindOrNull(m_cache, validator);
+  if (node) {
+    return node;
+  }
+
+  // Add the node to the cache before visiting so that loops terminate.
+  node = new CompiledSchemaNode(validator);
+  m_schema->m_nodes.push_back(node);
+  m_cache[validator] = node;
+
+  CompiledSchemaNode *parent = m_current;
+  m_current = node;
+  validator->Accept(this);
+  m_current = parent;
+  return node;
+}
+
+void SchemaCompiler::CompileConjunction(CompiledSchemaNode::Kind kind,
+                                        ConjunctionValidator *validator) {
+  CompiledSchemaNode *node = m_current;
+  node->kind = kind;
+  ValidatorInterface::ValidatorList::const_iterator iter =
+      validator->m_validators.begin();
+  for (; iter != validator->m_validators.end(); ++iter) {
+    node->children.push_back(CompileValidator(*iter));
+  }
+}
+}  // namespace web
+}  // namespace ola
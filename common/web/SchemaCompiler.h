@@ -0,0 +1,197 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * SchemaCompiler.h
+ * Compiles a JsonSchema into a form that can validate parser events.
+ * Copyright (C) 2026 agent
+ */
+
+#ifndef COMMON_WEB_SCHEMACOMPILER_H_
+#define COMMON_WEB_SCHEMACOMPILER_H_
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "ola/base/Macro.h"
+#include "ola/web/JsonSchema.h"
+
+namespace ola {
+namespace web {
+
+/**
+ * @brief A node in a compiled schema.
+ *
+ * The structure of objects and arrays is copied out of the validators so that
+ * containers can be checked one event at a time. Scalars are still checked
+ * by the validator the node was compiled from.
+ *
+ * A NULL node pointer means the empty (wildcard) schema.
+ */
+class CompiledSchemaNode {
+ public:
+  enum Kind {
+    ANY,  // Matches everything.
+    SCALAR,  // string, boolean, null, integer & number. Containers fail.
+    OBJECT,
+    ARRAY,
+    ALL_OF,
+    ANY_OF,
+    ONE_OF,
+    NOT,
+    REFERENCE,  // children[0] is the target, no children if unresolved.
+    // A validator that can't be run incrementally. Containers are collected
+    // into a JsonValue and passed to the validator.
+    OPAQUE,
+  };
+
+  typedef std::vector<const CompiledSchemaNode*> NodeList;
+  typedef std::map<std::string, const CompiledSchemaNode*> NodeMap;
+  typedef std::set<std::string> StringSet;
+
+  explicit CompiledSchemaNode(ValidatorInterface *validator_arg)
+      : kind(OPAQUE),
+        validator(validator_arg),
+        has_string_enums(false),
+        min_length(0),
+        max_length(-1),
+        additional_properties(NULL),
+        allow_additional_properties(true),
+        track_properties(false),
+        min_properties(0),
+        max_properties(-1),
+        additional_items(NULL),
+        allow_additional_items(true),
+        min_items(0),
+        max_items(-1) {
+  }
+
+  Kind kind;
+  ValidatorInterface *validator;
+
+  // Strings, only used if there were enums.
+  bool has_string_enums;
+  StringSet string_enums;
+  unsigned int min_length;
+  int max_length;
+
+  // Objects
+  NodeMap properties;
+  const CompiledSchemaNode *additional_properties;
+  bool allow_additional_properties;
+  bool track_properties;
+  unsigned int min_properties;
+  int max_properties;
+  StringSet required_properties;
+  std::map<std::string, StringSet> property_dependencies;
+  NodeMap schema_dependencies;
+
+  // Arrays. item_list is used for the first N items, then additional_items.
+  NodeList item_list;
+  const CompiledSchemaNode *additional_items;
+  bool allow_additional_items;
+  unsigned int min_items;
+  int max_items;
+
+  // allOf, anyOf, oneOf, not & $ref
+  NodeList children;
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(CompiledSchemaNode);
+};
+
+
+/**
+ * @brief A JsonSchema that has been compiled.
+ *
+ * The CompiledSchema points to the validators in the JsonSchema, so the
+ * JsonSchema must outlive it.
+ */
+class CompiledSchema {
+ public:
+  ~CompiledSchema();
+
+  /**
+   * @brief The root of the compiled schema.
+   */
+  const CompiledSchemaNode *Root() const { return m_root; }
+
+  /**
+   * @brief The number of nodes in the compiled schema.
+   */
+  unsigned int NodeCount() const {
+    return static_cast<unsigned int>(m_nodes.size());
+  }
+
+ private:
+  const CompiledSchemaNode *m_root;
+  std::vector<CompiledSchemaNode*> m_nodes;
+
+  CompiledSchema() : m_root(NULL) {}
+
+  friend class SchemaCompiler;
+
+  DISALLOW_COPY_AND_ASSIGN(CompiledSchema);
+};
+
+
+/**
+ * @brief Compiles the tree of validators in a JsonSchema.
+ *
+ * Each validator is compiled once, so recursive $refs end up as loops in the
+ * compiled graph.
+ */
+class SchemaCompiler : public ValidatorVisitorInterface {
+ public:
+  SchemaCompiler() : m_schema(NULL), m_current(NULL) {}
+
+  /**
+   * @brief Compile a JsonSchema.
+   * @param schema the schema to compile.
+   * @returns a new CompiledSchema, ownership is transferred.
+   */
+  CompiledSchema *Compile(JsonSchema *schema);
+
+  void Visit(WildcardValidator *validator);
+  void Visit(ReferenceValidator *validator);
+  void Visit(StringValidator *validator);
+  void Visit(BoolValidator *validator);
+  void Visit(NullValidator *validator);
+  void Visit(IntegerValidator *validator);
+  void Visit(NumberValidator *validator);
+  void Visit(ObjectValidator *validator);
+  void Visit(ArrayValidator *validator);
+  void Visit(AllOfValidator *validator);
+  void Visit(AnyOfValidator *validator);
+  void Visit(OneOfValidator *validator);
+  void Visit(NotValidator *validator);
+
+ private:
+  typedef std::map<const ValidatorInterface*, CompiledSchemaNode*> NodeCache;
+
+  CompiledSchema *m_schema;
+  CompiledSchemaNode *m_current;
+  NodeCache m_cache;
+
+  const CompiledSchemaNode *CompileValidator(ValidatorInterface *validator);
+  void CompileConjunction(CompiledSchemaNode::Kind kind,
+                          ConjunctionValidator *validator);
+
+  DISALLOW_COPY_AND_ASSIGN(SchemaCompiler);
+};
+}  // namespace web
+}  // namespace ola
+#endif  // COMMON_WEB_SCHEMACOMPILER_H_
@@ -0,0 +1,791 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * StreamingSchemaValidator.cpp
+ * Validate JSON against a schema as it's parsed.
+ * Copyright (C) 2026 agent
+ */
+
+#include <memory>
+#include <set>
+#include <stack>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/web/SchemaCompiler.h"
+#include "ola/stl/STLUtils.h"
+#include "ola/web/Json.h"
+#include "ola/web/JsonLexer.h"
+#include "ola/web/JsonSchema.h"
+#include "ola/web/StreamingSchemaValidator.h"
+
+namespace ola {
+namespace web {
+
+using std::auto_ptr;
+using std::string;
+using std::vector;
+
+/*
+ * A ValueMatcher consumes the parser events for a single object or array and
+ * checks them against a CompiledSchemaNode. The matcher is created once the
+ * OpenObject() / OpenArray() event has been seen, and is complete when the
+ * matching close event arrives.
+ */
+class ValueMatcher {
+ public:
+  virtual ~ValueMatcher() {}
+
+  virtual void String(const string &value) = 0;
+  // Called for all other scalar values.
+  virtual void Value(const JsonValue &value) = 0;
+  virtual void OpenArray() = 0;
+  virtual void CloseArray() = 0;
+  virtual void OpenObject() = 0;
+  virtual void ObjectKey(const string &key) = 0;
+  virtual void CloseObject() = 0;
+
+  virtual bool IsComplete() const = 0;
+  virtual bool IsValid() const = 0;
+};
+
+namespace {
+
+// Limits how many $refs we'll follow, in case they form a loop.
+const unsigned int MAX_REFERENCE_DEPTH = 32;
+
+ValueMatcher *NewMatcher(const CompiledSchemaNode *node, bool is_object);
+
+bool MatchValue(const CompiledSchemaNode *node, const JsonValue &value) {
+  if (!node || node->kind == CompiledSchemaNode::ANY) {
+    return true;
+  }
+  value.Accept(node->validator);
+  return node->validator->IsValid();
+}
+
+bool MatchString(const CompiledSchemaNode *node, const string &value) {
+  if (!node || node->kind == CompiledSchemaNode::ANY) {
+    return true;
+  }
+
+  if (node->has_string_enums) {
+    if (value.size() < node->min_length) {
+      return false;
+    }
+    if (node->max_length >= 0 &&
+        value.size() > static_cast<size_t>(node->max_length)) {
+      return false;
+    }
+    return STLContains(node->string_enums, value);
+  }
+
+  JsonString json_value(value);
+  return MatchValue(node, json_value);
+}
+
+/*
+ * Skips over a container, returning a fixed result.
+ */
+class SkipMatcher : public ValueMatcher {
+ public:
+  explicit SkipMatcher(bool is_valid)
+      : m_depth(1),
+        m_is_valid(is_valid) {
+  }
+
+  void String(const string &) {}
+  void Value(const JsonValue &) {}
+  void OpenArray() { m_depth++; }
+  void CloseArray() { m_depth--; }
+  void OpenObject() { m_depth++; }
+  void ObjectKey(const string &) {}
+  void CloseObject() { m_depth--; }
+
+  bool IsComplete() const { return m_depth == 0; }
+  bool IsValid() const { return m_is_valid; }
+
+ private:
+  unsigned int m_depth;
+  bool m_is_valid;
+};
+
+/*
+ * The base class for the object & array matchers. Events for nested
+ * containers are passed to a child matcher.
+ *
+ * Observers are given every event, including those for nested containers.
+ * They are used to check schema dependencies.
+ */
+class ContainerMatcher : public ValueMatcher {
+ public:
+  ContainerMatcher()
+      : m_is_valid(true),
+        m_complete(false) {
+  }
+
+  virtual ~ContainerMatcher() {
+    STLDeleteElements(&m_observers);
+  }
+
+  void String(const string &value) {
+    vector<ValueMatcher*>::iterator iter = m_observers.begin();
+    for (; iter != m_observers.end(); ++iter) {
+      (*iter)->String(value);
+    }
+
+    if (m_child.get()) {
+      m_child->String(value);
+      ChildUpdated();
+      return;
+    }
+    const CompiledSchemaNode *node;
+    if (StartElement(&node)) {
+      m_is_valid = MatchString(node, value);
+    }
+  }
+
+  void Value(const JsonValue &value) {
+    vector<ValueMatcher*>::iterator iter = m_observers.begin();
+    for (; iter != m_observers.end(); ++iter) {
+      (*iter)->Value(value);
+    }
+
+    if (m_child.get()) {
+      m_child->Value(value);
+      ChildUpdated();
+      return;
+    }
+    const CompiledSchemaNode *node;
+    if (StartElement(&node)) {
+      m_is_valid = MatchValue(node, value);
+    }
+  }
+
+  void OpenArray() {
+    vector<ValueMatcher*>::iterator iter = m_observers.begin();
+    for (; iter != m_observers.end(); ++iter) {
+      (*iter)->OpenArray();
+    }
+
+    if (m_child.get()) {
+      m_child->OpenArray();
+      return;
+    }
+    const CompiledSchemaNode *node;
+    // Once we're invalid, the rest of the container is skipped.
+    m_child.reset(NewMatcher(StartElement(&node) ? node : NULL, false));
+  }
+
+  void CloseArray() {
+    vector<ValueMatcher*>::iterator iter = m_observers.begin();
+    for (; iter != m_observers.end(); ++iter) {
+      (*iter)->CloseArray();
+    }
+
+    if (m_child.get()) {
+      m_child->CloseArray();
+      ChildUpdated();
+      return;
+    }
+    m_complete = true;
+    Finish();
+  }
+
+  void OpenObject() {
+    vector<ValueMatcher*>::iterator iter = m_observers.begin();
+    for (; iter != m_observers.end(); ++iter) {
+      (*iter)->OpenObject();
+    }
+
+    if (m_child.get()) {
+      m_child->OpenObject();
+      return;
+    }
+    const CompiledSchemaNode *node;
+    m_child.reset(NewMatcher(StartElement(&node) ? node : NULL, true));
+  }
+
+  void ObjectKey(const string &key) {
+    vector<ValueMatcher*>::iterator iter = m_observers.begin();
+    for (; iter != m_observers.end(); ++iter) {
+      (*iter)->ObjectKey(key);
+    }
+
+    if (m_child.get()) {
+      m_child->ObjectKey(key);
+      return;
+    }
+    Key(key);
+  }
+
+  void CloseObject() {
+    vector<ValueMatcher*>::iterator iter = m_observers.begin();
+    for (; iter != m_observers.end(); ++iter) {
+      (*iter)->CloseObject();
+    }
+
+    if (m_child.get()) {
+      m_child->CloseObject();
+      ChildUpdated();
+      return;
+    }
+    m_complete = true;
+    Finish();
+  }
+
+  bool IsComplete() const { return m_complete; }
+  bool IsValid() const { return m_is_valid; }
+
+ protected:
+  bool m_is_valid;
+  vector<ValueMatcher*> m_observers;
+
+  /*
+   * Called at the start of each element, to get the node to check it with.
+   * Returns false if the element isn't allowed.
+   */
+  virtual bool NextElement(const CompiledSchemaNode **node) = 0;
+
+  virtual void Key(const string &) {}
+
+  // Called once the container is closed.
+  virtual void Finish() = 0;
+
+ private:
+  auto_ptr<ValueMatcher> m_child;
+  bool m_complete;
+
+  bool StartElement(const CompiledSchemaNode **node) {
+    if (!NextElement(node)) {
+      m_is_valid = false;
+    }
+    return m_is_valid;
+  }
+
+  void ChildUpdated() {
+    if (m_child->IsComplete()) {
+      if (!m_child->IsValid()) {
+        m_is_valid = false;
+      }
+      m_child.reset();
+    }
+  }
+};
+
+/*
+ * See ObjectValidator::Visit().
+ */
+class ObjectMatcher : public ContainerMatcher {
+ public:
+  explicit ObjectMatcher(const CompiledSchemaNode *node)
+      : ContainerMatcher(),
+        m_node(node),
+        m_next_node(NULL),
+        m_next_allowed(true) {
+    // If a schema dependency is triggered, the whole object is checked
+    // against it. We don't know that until we see the key, so start them all
+    // now.
+    CompiledSchemaNode::NodeMap::const_iterator iter =
+        node->schema_dependencies.begin();
+    for (; iter != node->schema_dependencies.end(); ++iter) {
+      m_observers.push_back(NewMatcher(iter->second, true));
+    }
+  }
+
+ protected:
+  bool NextElement(const CompiledSchemaNode **node) {
+    *node = m_next_node;
+    return m_next_allowed;
+  }
+
+  void Key(const string &key) {
+    if (m_node->track_properties) {
+      m_seen_properties.insert(key);
+    }
+
+    // The algorithm is described in section 8.3.3
+    CompiledSchemaNode::NodeMap::const_iterator iter =
+        m_node->properties.find(key);
+    if (iter != m_node->properties.end()) {
+      m_next_node = iter->second;
+      m_next_allowed = true;
+    } else if (m_node->additional_properties) {
+      m_next_node = m_node->additional_properties;
+      m_next_allowed = true;
+    } else {
+      m_next_node = NULL;
+      m_next_allowed = m_node->allow_additional_properties;
+    }
+  }
+
+  void Finish() {
+    if (!m_is_valid || !m_node->track_properties) {
+      return;
+    }
+
+    if (m_seen_properties.size() < m_node->min_properties) {
+      m_is_valid = false;
+      return;
+    }
+
+    if (m_node->max_properties > 0 &&
+        m_seen_properties.size() >
+          static_cast<size_t>(m_node->max_properties)) {
+      m_is_valid = false;
+      return;
+    }
+
+    CompiledSchemaNode::StringSet::const_iterator iter =
+        m_node->required_properties.begin();
+    for (; iter != m_node->required_properties.end(); ++iter) {
+      if (!STLContains(m_seen_properties, *iter)) {
+        m_is_valid = false;
+        return;
+      }
+    }
+
+    std::map<string, CompiledSchemaNode::StringSet>::const_iterator prop_iter =
+        m_node->property_dependencies.begin();
+    for (; prop_iter != m_node->property_dependencies.end(); ++prop_iter) {
+      if (!STLContains(m_seen_properties, prop_iter->first)) {
+        continue;
+      }
+      iter = prop_iter->second.begin();
+      for (; iter != prop_iter->second.end(); ++iter) {
+        if (!STLContains(m_seen_properties, *iter)) {
+          m_is_valid = false;
+          return;
+        }
+      }
+    }
+
+    // The observers are in the same order as the schema_dependencies map.
+    CompiledSchemaNode::NodeMap::const_iterator schema_iter =
+        m_node->schema_dependencies.begin();
+    vector<ValueMatcher*>::const_iterator matcher_iter = m_observers.begin();
+    for (; schema_iter != m_node->schema_dependencies.end();
+         ++schema_iter, ++matcher_iter) {
+      if (STLContains(m_seen_properties, schema_iter->first) &&
+          !(*matcher_iter)->IsValid()) {
+        m_is_valid = false;
+        return;
+      }
+    }
+  }
+
+ private:
+  const CompiledSchemaNode *m_node;
+  const CompiledSchemaNode *m_next_node;
+  bool m_next_allowed;
+  CompiledSchemaNode::StringSet m_seen_properties;
+};
+
+/*
+ * See ArrayValidator::Visit().
+ */
+class ArrayMatcher : public ContainerMatcher {
+ public:
+  explicit ArrayMatcher(const CompiledSchemaNode *node)
+      : ContainerMatcher(),
+        m_node(node),
+        m_index(0) {
+  }
+
+ protected:
+  bool NextElement(const CompiledSchemaNode **node) {
+    unsigned int index = m_index++;
+    if (index < m_node->item_list.size()) {
+      *node = m_node->item_list[index];
+      return true;
+    }
+    *node = m_node->additional_items;
+    return m_node->additional_items || m_node->allow_additional_items;
+  }
+
+  void Finish() {
+    if (m_index < m_node->min_items) {
+      m_is_valid = false;
+    } else if (m_node->max_items > 0 &&
+               m_index > static_cast<unsigned int>(m_node->max_items)) {
+      m_is_valid = false;
+    }
+  }
+
+ private:
+  const CompiledSchemaNode *m_node;
+  unsigned int m_index;
+};
+
+/*
+ * Runs a matcher for each of the child schemas, for allOf, anyOf, oneOf &
+ * not.
+ */
+class ConjunctionMatcher : public ValueMatcher {
+ public:
+  ConjunctionMatcher(const CompiledSchemaNode *node, bool is_object)
+      : m_kind(node->kind),
+        m_depth(1) {
+    CompiledSchemaNode::NodeList::const_iterator iter = node->children.begin();
+    for (; iter != node->children.end(); ++iter) {
+      m_matchers.push_back(NewMatcher(*iter, is_object));
+    }
+  }
+
+  ~ConjunctionMatcher() {
+    STLDeleteElements(&m_matchers);
+  }
+
+  void String(const string &value) {
+    vector<ValueMatcher*>::iterator iter = m_matchers.begin();
+    for (; iter != m_matchers.end(); ++iter) {
+      (*iter)->String(value);
+    }
+  }
+
+  void Value(const JsonValue &value) {
+    vector<ValueMatcher*>::iterator iter = m_matchers.begin();
+    for (; iter != m_matchers.end(); ++iter) {
+      (*iter)->Value(value);
+    }
+  }
+
+  void OpenArray() {
+    m_depth++;
+    vector<ValueMatcher*>::iterator iter = m_matchers.begin();
+    for (; iter != m_matchers.end(); ++iter) {
+      (*iter)->OpenArray();
+    }
+  }
+
+  void CloseArray() {
+    m_depth--;
+    vector<ValueMatcher*>::iterator iter = m_matchers.begin();
+    for (; iter != m_matchers.end(); ++iter) {
+      (*iter)->CloseArray();
+    }
+  }
+
+  void OpenObject() {
+    m_depth++;
+    vector<ValueMatcher*>::iterator iter = m_matchers.begin();
+    for (; iter != m_matchers.end(); ++iter) {
+      (*iter)->OpenObject();
+    }
+  }
+
+  void ObjectKey(const string &key) {
+    vector<ValueMatcher*>::iterator iter = m_matchers.begin();
+    for (; iter != m_matchers.end(); ++iter) {
+      (*iter)->ObjectKey(key);
+    }
+  }
+
+  void CloseObject() {
+    m_depth--;
+    vector<ValueMatcher*>::iterator iter = m_matchers.begin();
+    for (; iter != m_matchers.end(); ++iter) {
+      (*iter)->CloseObject();
+    }
+  }
+
+  bool IsComplete() const { return m_depth == 0; }
+
+  bool IsValid() const {
+    unsigned int valid_count = 0;
+    vector<ValueMatcher*>::const_iterator iter = m_matchers.begin();
+    for (; iter != m_matchers.end(); ++iter) {
+      if ((*iter)->IsValid()) {
+        valid_count++;
+      }
+    }
+
+    switch (m_kind) {
+      case CompiledSchemaNode::ALL_OF:
+        return valid_count == m_matchers.size();
+      case CompiledSchemaNode::ANY_OF:
+        return valid_count > 0;
+      case CompiledSchemaNode::ONE_OF:
+        return valid_count == 1;
+      case CompiledSchemaNode::NOT:
+        return valid_count == 0;
+      default:
+        return false;
+    }
+  }
+
+ private:
+  const CompiledSchemaNode::Kind m_kind;
+  unsigned int m_depth;
+  vector<ValueMatcher*> m_matchers;
+};
+
+/*
+ * Collects a container into a JsonValue, and then passes it to the validator.
+ * This is the fallback for validators that can't be run incrementally.
+ */
+class CaptureMatcher : public ValueMatcher {
+ public:
+  CaptureMatcher(const CompiledSchemaNode *node, bool is_object)
+      : m_node(node),
+        m_is_valid(false) {
+    if (is_object) {
+      JsonObject *object = new JsonObject();
+      m_root.reset(object);
+      m_containers.push(Container(object, NULL));
+    } else {
+      JsonArray *array = new JsonArray();
+      m_root.reset(array);
+      m_containers.push(Container(NULL, array));
+    }
+  }
+
+  void String(const string &value) {
+    AddValue(new JsonString(value));
+  }
+
+  void Value(const JsonValue &value) {
+    AddValue(value.Clone());
+  }
+
+  void OpenArray() {
+    const Container &top = m_containers.top();
+    JsonArray *array = top.second ? top.second->AppendArray() :
+        top.first->AddArray(m_key);
+    m_containers.push(Container(NULL, array));
+  }
+
+  void CloseArray() {
+    CloseContainer();
+  }
+
+  void OpenObject() {
+    const Container &top = m_containers.top();
+    JsonObject *object = top.second ? top.second->AppendObject() :
+        top.first->AddObject(m_key);
+    m_containers.push(Container(object, NULL));
+  }
+
+  void ObjectKey(const string &key) {
+    m_key = key;
+  }
+
+  void CloseObject() {
+    CloseContainer();
+  }
+
+  bool IsComplete() const { return m_containers.empty(); }
+  bool IsValid() const { return m_is_valid; }
+
+ private:
+  typedef std::pair<JsonObject*, JsonArray*> Container;
+
+  const CompiledSchemaNode *m_node;
+  auto_ptr<JsonValue> m_root;
+  std::stack<Container> m_containers;
+  string m_key;
+  bool m_is_valid;
+
+  void AddValue(JsonValue *value) {
+    const Container &top = m_containers.top();
+    if (top.second) {
+      top.second->AppendValue(value);
+    } else {
+      top.first->AddValue(m_key, value);
+    }
+  }
+
+  void CloseContainer() {
+    m_containers.pop();
+    if (m_containers.empty()) {
+      m_root->Accept(m_node->validator);
+      m_is_valid = m_node->validator->IsValid();
+      m_root.reset();
+    }
+  }
+};
+
+/*
+ * Create a matcher for a container that matches the node.
+ */
+ValueMatcher *NewMatcher(const CompiledSchemaNode *node, bool is_object) {
+  unsigned int references = 0;
+  while (node && node->kind == CompiledSchemaNode::REFERENCE) {
+    if (node->children.empty() || ++references > MAX_REFERENCE_DEPTH) {
+      return new SkipMatcher(false);
+    }
+    node = node->children[0];
+  }
+
+  if (!node) {
+    return new SkipMatcher(true);
+  }
+
+  switch (node->kind) {
+    case CompiledSchemaNode::ANY:
+      return new SkipMatcher(true);
+    case CompiledSchemaNode::OBJECT:
+      if (is_object) {
+        return new ObjectMatcher(node);
+      }
+      return new SkipMatcher(false);
+    case CompiledSchemaNode::ARRAY:
+      if (!is_object) {
+        return new ArrayMatcher(node);
+      }
+      return new SkipMatcher(false);
+    case CompiledSchemaNode::ALL_OF:
+    case CompiledSchemaNode::ANY_OF:
+    case CompiledSchemaNode::ONE_OF:
+    case CompiledSchemaNode::NOT:
+      return new ConjunctionMatcher(node, is_object);
+    case CompiledSchemaNode::OPAQUE:
+      return new CaptureMatcher(node, is_object);
+    default:
+      return new SkipMatcher(false);
+  }
+}
+}  // namespace
+
+StreamingSchemaValidator::StreamingSchemaValidator(JsonSchema *schema)
+    : m_complete(false),
+      m_is_valid(false) {
+  SchemaCompiler compiler;
+  m_schema.reset(compiler.Compile(schema));
+}
+
+StreamingSchemaValidator::~StreamingSchemaValidator() {}
+
+void StreamingSchemaValidator::Begin() {
+  m_matcher.reset();
+  m_error.clear();
+  m_complete = false;
+  m_is_valid = false;
+}
+
+void StreamingSchemaValidator::End() {}
+
+void StreamingSchemaValidator::String(const string &value) {
+  if (m_matcher.get()) {
+    m_matcher->String(value);
+    MatcherUpdated();
+  } else {
+    m_is_valid = MatchString(m_schema->Root(), value);
+    m_complete = true;
+  }
+}
+
+void StreamingSchemaValidator::Number(uint32_t value) {
+  ScalarValue(JsonUInt(value));
+}
+
+void StreamingSchemaValidator::Number(int32_t value) {
+  ScalarValue(JsonInt(value));
+}
+
+void StreamingSchemaValidator::Number(uint64_t value) {
+  ScalarValue(JsonUInt64(value));
+}
+
+void StreamingSchemaValidator::Number(int64_t value) {
+  ScalarValue(JsonInt64(value));
+}
+
+void StreamingSchemaValidator::Number(
+    const JsonDouble::DoubleRepresentation &rep) {
+  ScalarValue(JsonDouble(rep));
+}
+
+void StreamingSchemaValidator::Number(double value) {
+  ScalarValue(JsonDouble(value));
+}
+
+void StreamingSchemaValidator::Bool(bool value) {
+  ScalarValue(JsonBool(value));
+}
+
+void StreamingSchemaValidator::Null() {
+  ScalarValue(JsonNull());
+}
+
+void StreamingSchemaValidator::OpenArray() {
+  if (m_matcher.get()) {
+    m_matcher->OpenArray();
+  } else {
+    m_matcher.reset(NewMatcher(m_schema->Root(), false));
+  }
+}
+
+void StreamingSchemaValidator::CloseArray() {
+  if (m_matcher.get()) {
+    m_matcher->CloseArray();
+    MatcherUpdated();
+  }
+}
+
+void StreamingSchemaValidator::OpenObject() {
+  if (m_matcher.get()) {
+    m_matcher->OpenObject();
+  } else {
+    m_matcher.reset(NewMatcher(m_schema->Root(), true));
+  }
+}
+
+void StreamingSchemaValidator::ObjectKey(const string &key) {
+  if (m_matcher.get()) {
+    m_matcher->ObjectKey(key);
+  }
+}
+
+void StreamingSchemaValidator::CloseObject() {
+  if (m_matcher.get()) {
+    m_matcher->CloseObject();
+    MatcherUpdated();
+  }
+}
+
+void StreamingSchemaValidator::SetError(const string &error) {
+  m_error = error;
+  m_matcher.reset();
+}
+
+bool StreamingSchemaValidator::Validate(const string &input) {
+  return JsonLexer::Parse(input, this) && IsValid();
+}
+
+bool StreamingSchemaValidator::IsValid() const {
+  return m_error.empty() && m_complete && m_is_valid;
+}
+
+void StreamingSchemaValidator::ScalarValue(const JsonValue &value) {
+  if (m_matcher.get()) {
+    m_matcher->Value(value);
+    MatcherUpdated();
+  } else {
+    m_is_valid = MatchValue(m_schema->Root(), value);
+    m_complete = true;
+  }
+}
+
+void StreamingSchemaValidator::MatcherUpdated() {
+  if (m_matcher->IsComplete()) {
+    m_is_valid = m_matcher->IsValid();
+    m_complete = true;
+    m_matcher.reset();
+  }
+}
+}  // namespace web
+}  // namespace ola
@@ -0,0 +1,410 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * StreamingSchemaValidatorTest.cpp
+ * Unittests for the StreamingSchemaValidator.
+ * Copyright (C) 2026 agent
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ola/Logging.h"
+#include "ola/file/Util.h"
+#include "ola/testing/TestUtils.h"
+#include "ola/web/Json.h"
+#include "ola/web/JsonParser.h"
+#include "ola/web/JsonSchema.h"
+#include "ola/web/StreamingSchemaValidator.h"
+
+using ola::web::JsonParser;
+using ola::web::JsonSchema;
+using ola::web::JsonValue;
+using ola::web::StreamingSchemaValidator;
+using std::auto_ptr;
+using std::string;
+using std::vector;
+
+class StreamingSchemaValidatorTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(StreamingSchemaValidatorTest);
+  CPPUNIT_TEST(testScalars);
+  CPPUNIT_TEST(testStringEnums);
+  CPPUNIT_TEST(testObjects);
+  CPPUNIT_TEST(testDependencies);
+  CPPUNIT_TEST(testArrays);
+  CPPUNIT_TEST(testConjunctions);
+  CPPUNIT_TEST(testReferences);
+  CPPUNIT_TEST(testUniqueItems);
+  CPPUNIT_TEST(testInvalidJson);
+  CPPUNIT_TEST(testMatchesSchemaTestData);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void testScalars();
+  void testStringEnums();
+  void testObjects();
+  void testDependencies();
+  void testArrays();
+  void testConjunctions();
+  void testReferences();
+  void testUniqueItems();
+  void testInvalidJson();
+  void testMatchesSchemaTestData();
+
+ private:
+  bool Validate(const string &schema_json, const string &input);
+  void ReadSchemas(const string &filename, vector<string> *schemas);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(StreamingSchemaValidatorTest);
+
+/*
+ * Validate the input with both the streaming validator and the JsonSchema,
+ * and check they agree.
+ */
+bool StreamingSchemaValidatorTest::Validate(const string &schema_json,
+                                            const string &input) {
+  string error;
+  auto_ptr<JsonSchema> schema(JsonSchema::FromString(schema_json, &error));
+  OLA_ASSERT_NOT_NULL(schema.get());
+
+  StreamingSchemaValidator validator(schema.get());
+  bool streaming_result = validator.Validate(input);
+
+  auto_ptr<JsonValue> value(JsonParser::Parse(input, &error));
+  bool dom_result = value.get() && schema->IsValid(*value);
+  OLA_ASSERT_EQ_MSG(dom_result, streaming_result,
+                    "Schema: " + schema_json + ", input: " + input);
+  return streaming_result;
+}
+
+/**
+ * Read the positive schemas from one of the files in testdata.
+ */
+void StreamingSchemaValidatorTest::ReadSchemas(const string &filename,
+                                               vector<string> *schemas) {
+  string file_path;
+  file_path.append(TEST_SRC_DIR);
+  file_path.push_back(ola::file::PATH_SEPARATOR);
+  file_path.append("common");
+  file_path.push_back(ola::file::PATH_SEPARATOR);
+  file_path.append("web");
+  file_path.push_back(ola::file::PATH_SEPARATOR);
+  file_path.append("testdata");
+  file_path.push_back(ola::file::PATH_SEPARATOR);
+  file_path.append(filename);
+
+  std::ifstream in(file_path.data(), std::ios::in);
+  OLA_ASSERT_TRUE_MSG(in.is_open(), file_path);
+
+  const string comment_prefix = "//";
+  bool in_schema = false;
+  string schema;
+  string line;
+  while (getline(in, line)) {
+    line.erase(line.find_last_not_of("\r") + 1);
+    if (line.compare(0, comment_prefix.size(), comment_prefix) == 0) {
+      continue;
+    } else if (line == "=== POSITIVE ===" || line == "=== NEGATIVE ===" ||
+               line == "--------") {
+      if (in_schema && !schema.empty()) {
+        schemas->push_back(schema);
+      }
+      schema.clear();
+      in_schema = (line == "=== POSITIVE ===");
+    } else if (in_schema) {
+      schema.append(line);
+      schema.push_back('\n');
+    }
+  }
+  if (in_schema && !schema.empty()) {
+    schemas->push_back(schema);
+  }
+}
+
+void StreamingSchemaValidatorTest::testScalars() {
+  OLA_ASSERT_TRUE(Validate("{}", "1"));
+  OLA_ASSERT_TRUE(Validate("{}", "[1, {\"a\": [null]}]"));
+  OLA_ASSERT_TRUE(Validate("{\"type\": \"boolean\"}", "true"));
+  OLA_ASSERT_FALSE(Validate("{\"type\": \"boolean\"}", "1"));
+  OLA_ASSERT_FALSE(Validate("{\"type\": \"boolean\"}", "[]"));
+  OLA_ASSERT_FALSE(Validate("{\"type\": \"boolean\"}", "{}"));
+  OLA_ASSERT_TRUE(Validate("{\"type\": \"null\"}", "null"));
+  OLA_ASSERT_TRUE(Validate("{\"type\": \"integer\", \"maximum\": 10}", "10"));
+  OLA_ASSERT_FALSE(Validate("{\"type\": \"integer\", \"maximum\": 10}", "11"));
+  OLA_ASSERT_FALSE(Validate("{\"type\": \"integer\"}", "1.5"));
+  OLA_ASSERT_TRUE(Validate("{\"type\": \"number\", \"minimum\": 1}", "1.5"));
+  OLA_ASSERT_FALSE(Validate("{\"type\": \"number\", \"minimum\": 1}", "-3"));
+  OLA_ASSERT_TRUE(Validate("{\"type\": \"string\", \"maxLength\": 3}",
+                           "\"foo\""));
+  OLA_ASSERT_FALSE(Validate("{\"type\": \"string\", \"maxLength\": 2}",
+                            "\"foo\""));
+}
+
+void StreamingSchemaValidatorTest::testStringEnums() {
+  const string schema =
+    "{\"type\": \"string\", \"enum\": [\"red\", \"green\", \"yellow\"],"
+    " \"maxLength\": 5}";
+  OLA_ASSERT_TRUE(Validate(schema, "\"red\""));
+  OLA_ASSERT_TRUE(Validate(schema, "\"green\""));
+  OLA_ASSERT_FALSE(Validate(schema, "\"blue\""));
+  // In the enum, but too long.
+  OLA_ASSERT_FALSE(Validate(schema, "\"yellow\""));
+  OLA_ASSERT_FALSE(Validate(schema, "1"));
+  OLA_ASSERT_TRUE(Validate("{\"type\": \"array\", \"items\": " + schema + "}",
+                           "[\"red\", \"red\", \"green\"]"));
+  OLA_ASSERT_FALSE(Validate("{\"type\": \"array\", \"items\": " + schema + "}",
+                            "[\"red\", \"blue\"]"));
+}
+
+void StreamingSchemaValidatorTest::testObjects() {
+  const string schema =
+    "{\"type\": \"object\","
+    " \"properties\": {"
+    "   \"name\": {\"type\": \"string\"},"
+    "   \"address\": {"
+    "     \"type\": \"object\","
+    "     \"properties\": {\"number\": {\"type\": \"integer\"}},"
+    "     \"additionalProperties\": false"
+    "   }"
+    " },"
+    " \"required\": [\"name\"],"
+    " \"maxProperties\": 3"
+    "}";
+  OLA_ASSERT_TRUE(Validate(schema, "{\"name\": \"Simon\"}"));
+  OLA_ASSERT_TRUE(Validate(schema,
+                           "{\"name\": \"Simon\", \"address\": {\"number\": 1}"
+                           ", \"other\": [1, 2]}"));
+  OLA_ASSERT_FALSE(Validate(schema, "{}"));
+  OLA_ASSERT_FALSE(Validate(schema, "{\"name\": 1}"));
+  OLA_ASSERT_FALSE(Validate(schema,
+                            "{\"name\": \"Simon\", \"address\": {\"x\": 1}}"));
+  OLA_ASSERT_FALSE(Validate(schema,
+                            "{\"name\": \"Simon\", \"address\": "
+                            "{\"number\": \"1\"}}"));
+  OLA_ASSERT_FALSE(Validate(schema,
+                            "{\"name\": \"\", \"a\": 1, \"b\": 2, \"c\": 3}"));
+  OLA_ASSERT_FALSE(Validate(schema, "[]"));
+
+  const string additional =
+    "{\"type\": \"object\","
+    " \"additionalProperties\": {\"type\": \"array\", \"minItems\": 1},"
+    " \"minProperties\": 1}";
+  OLA_ASSERT_TRUE(Validate(additional, "{\"a\": [1], \"b\": [{}]}"));
+  OLA_ASSERT_FALSE(Validate(additional, "{\"a\": [1], \"b\": []}"));
+  OLA_ASSERT_FALSE(Validate(additional, "{}"));
+}
+
+void StreamingSchemaValidatorTest::testDependencies() {
+  const string schema =
+    "{\"type\": \"object\", \"dependencies\": {"
+    "   \"credit_card\": [\"billing_address\"],"
+    "   \"name\": {\"type\": \"object\","
+    "              \"properties\": {\"age\": {\"type\": \"integer\"}},"
+    "              \"required\": [\"age\"]}"
+    "}}";
+  OLA_ASSERT_TRUE(Validate(schema, "{}"));
+  OLA_ASSERT_TRUE(Validate(schema,
+                           "{\"credit_card\": 1, \"billing_address\": 2}"));
+  OLA_ASSERT_FALSE(Validate(schema, "{\"credit_card\": 1}"));
+  OLA_ASSERT_TRUE(Validate(schema, "{\"age\": \"old\"}"));
+  OLA_ASSERT_TRUE(Validate(schema, "{\"age\": 1, \"name\": \"Simon\"}"));
+  OLA_ASSERT_FALSE(Validate(schema, "{\"name\": \"Simon\"}"));
+  OLA_ASSERT_FALSE(Validate(schema, "{\"age\": \"old\", \"name\": \"Simon\"}"));
+}
+
+void StreamingSchemaValidatorTest::testArrays() {
+  const string schema =
+    "{\"type\": \"array\","
+    " \"items\": [{\"type\": \"integer\"}, {\"type\": \"string\"}],"
+    " \"additionalItems\": {\"type\": \"boolean\"},"
+    " \"minItems\": 1, \"maxItems\": 4}";
+  OLA_ASSERT_TRUE(Validate(schema, "[1]"));
+  OLA_ASSERT_TRUE(Validate(schema, "[1, \"foo\", true, false]"));
+  OLA_ASSERT_FALSE(Validate(schema, "[]"));
+  OLA_ASSERT_FALSE(Validate(schema, "[\"foo\"]"));
+  OLA_ASSERT_FALSE(Validate(schema, "[1, \"foo\", null]"));
+  OLA_ASSERT_FALSE(Validate(schema, "[1, \"foo\", true, true, true]"));
+  OLA_ASSERT_FALSE(Validate(schema, "{}"));
+
+  const string no_additional =
+    "{\"type\": \"array\", \"items\": [{}, {\"type\": \"array\"}],"
+    " \"additionalItems\": false}";
+  OLA_ASSERT_TRUE(Validate(no_additional, "[{\"a\": 1}, [[]]]"));
+  OLA_ASSERT_FALSE(Validate(no_additional, "[{}, {}]"));
+  OLA_ASSERT_FALSE(Validate(no_additional, "[1, [], 2]"));
+
+  const string nested =
+    "{\"type\": \"array\","
+    " \"items\": {\"type\": \"array\", \"items\": {\"type\": \"integer\"},"
+    "           \"maxItems\": 2}}";
+  OLA_ASSERT_TRUE(Validate(nested, "[[1, 2], [], [3]]"));
+  OLA_ASSERT_FALSE(Validate(nested, "[[1, 2], [1, 2, 3]]"));
+  OLA_ASSERT_FALSE(Validate(nested, "[[1, 2], [true]]"));
+}
+
+void StreamingSchemaValidatorTest::testConjunctions() {
+  const string all_of =
+    "{\"allOf\": [{\"type\": \"object\", \"required\": [\"a\"]},"
+    "             {\"type\": \"object\","
+    "              \"properties\": {\"a\": {\"type\": \"integer\"}}}]}";
+  OLA_ASSERT_TRUE(Validate(all_of, "{\"a\": 1}"));
+  OLA_ASSERT_FALSE(Validate(all_of, "{\"a\": true}"));
+  OLA_ASSERT_FALSE(Validate(all_of, "{}"));
+
+  const string any_of =
+    "{\"anyOf\": [{\"type\": \"array\"}, {\"type\": \"string\"}]}";
+  OLA_ASSERT_TRUE(Validate(any_of, "[1, {}]"));
+  OLA_ASSERT_TRUE(Validate(any_of, "\"foo\""));
+  OLA_ASSERT_FALSE(Validate(any_of, "{\"a\": [1]}"));
+
+  const string one_of =
+    "{\"oneOf\": [{\"type\": \"array\", \"maxItems\": 2},"
+    "             {\"type\": \"array\", \"minItems\": 2}]}";
+  OLA_ASSERT_TRUE(Validate(one_of, "[1]"));
+  OLA_ASSERT_TRUE(Validate(one_of, "[1, 2, 3]"));
+  OLA_ASSERT_FALSE(Validate(one_of, "[1, 2]"));
+
+  const string not_schema =
+    "{\"type\": \"array\", \"items\": {\"not\": {\"type\": \"object\"}}}";
+  OLA_ASSERT_TRUE(Validate(not_schema, "[1, [{}], null]"));
+  OLA_ASSERT_FALSE(Validate(not_schema, "[1, {\"a\": []}]"));
+}
+
+void StreamingSchemaValidatorTest::testReferences() {
+  // A recursive schema for a tree of integers.
+  const string schema =
+    "{\"definitions\": {"
+    "   \"node\": {"
+    "     \"type\": \"object\","
+    "     \"properties\": {"
+    "       \"value\": {\"type\": \"integer\"},"
+    "       \"children\": {"
+    "         \"type\": \"array\", \"items\": {\"$ref\": \"node\"}"
+    "       }"
+    "     },"
+    "     \"required\": [\"value\"]"
+    "   }"
+    " },"
+    " \"$ref\": \"node\""
+    "}";
+  OLA_ASSERT_TRUE(Validate(schema, "{\"value\": 1}"));
+  OLA_ASSERT_TRUE(Validate(schema,
+                           "{\"value\": 1, \"children\": [{\"value\": 2, "
+                           "\"children\": [{\"value\": 3}]}]}"));
+  OLA_ASSERT_FALSE(Validate(schema,
+                            "{\"value\": 1, \"children\": [{\"value\": 2, "
+                            "\"children\": [{\"value\": \"3\"}]}]}"));
+  OLA_ASSERT_FALSE(Validate(schema, "{\"value\": 1, \"children\": [{}]}"));
+
+  // Unresolved references never match.
+  OLA_ASSERT_FALSE(Validate("{\"$ref\": \"missing\"}", "{}"));
+  OLA_ASSERT_FALSE(Validate("{\"$ref\": \"missing\"}", "1"));
+}
+
+void StreamingSchemaValidatorTest::testUniqueItems() {
+  // uniqueItems falls back to collecting the array.
+  const string schema =
+    "{\"type\": \"object\","
+    " \"properties\": {\"a\": {\"type\": \"array\", \"uniqueItems\": true,"
+    "                         \"items\": {\"type\": \"array\"}}}}";
+  OLA_ASSERT_TRUE(Validate(schema, "{\"a\": [[1], [2, {\"b\": null}]]}"));
+  OLA_ASSERT_FALSE(Validate(schema, "{\"a\": [[1], [1]]}"));
+  OLA_ASSERT_FALSE(Validate(schema, "{\"a\": [1, 2]}"));
+}
+
+void StreamingSchemaValidatorTest::testInvalidJson() {
+  string error;
+  auto_ptr<JsonSchema> schema(JsonSchema::FromString("{}", &error));
+  OLA_ASSERT_NOT_NULL(schema.get());
+
+  StreamingSchemaValidator validator(schema.get());
+  OLA_ASSERT_FALSE(validator.Validate(""));
+  OLA_ASSERT_FALSE(validator.Validate("[1, 2"));
+  OLA_ASSERT_FALSE(validator.GetError().empty());
+  OLA_ASSERT_FALSE(validator.Validate("{\"a\": }"));
+  OLA_ASSERT_FALSE(validator.IsValid());
+
+  // The validator can be reused.
+  OLA_ASSERT_TRUE(validator.Validate("[1, 2]"));
+  OLA_ASSERT_TRUE(validator.IsValid());
+  OLA_ASSERT_TRUE(validator.GetError().empty());
+}
+
+/*
+ * Check every schema from the SchemaParser tests gives the same results as
+ * JsonSchema::IsValid().
+ */
+void StreamingSchemaValidatorTest::testMatchesSchemaTestData() {
+  const char *files[] = {
+    "allof.test",
+    "anyof.test",
+    "arrays.test",
+    "basic-keywords.test",
+    "definitions.test",
+    "integers.test",
+    "misc.test",
+    "not.test",
+    "objects.test",
+    "oneof.test",
+    "strings.test",
+    "type.test",
+  };
+
+  const char *documents[] = {
+    "true",
+    "null",
+    "-12",
+    "4",
+    "1.2",
+    "\"foo\"",
+    "\"\"",
+    "[]",
+    "{}",
+    "[1, 2, 3]",
+    "[1, 1]",
+    "[\"foo\", true, null, {}]",
+    "[[1], [2, [3]]]",
+    "{\"foo\": 1}",
+    "{\"foo\": \"bar\", \"baz\": [1, 2]}",
+    "{\"name\": {\"first\": \"Simon\"}, \"age\": 30, \"tags\": []}",
+    "[{\"a\": 1}, {\"a\": \"b\"}]",
+  };
+
+  unsigned int schema_count = 0;
+  for (unsigned int i = 0; i < sizeof(files) / sizeof(files[0]); i++) {
+    vector<string> schemas;
+    ReadSchemas(files[i], &schemas);
+    OLA_ASSERT_FALSE(schemas.empty());
+
+    vector<string>::const_iterator iter = schemas.begin();
+    for (; iter != schemas.end(); ++iter) {
+      string error;
+      auto_ptr<JsonSchema> schema(JsonSchema::FromString(*iter, &error));
+      if (!schema.get()) {
+        continue;
+      }
+      schema_count++;
+      for (unsigned int j = 0; j < sizeof(documents) / sizeof(documents[0]);
+           j++) {
+        Validate(*iter, documents[j]);
+      }
+    }
+  }
+  OLA_ASSERT_GT(schema_count, 0);
+}
@@ -0,0 +1,310 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * schema_benchmark.cpp
+ * Compare JsonSchema::IsValid() with the StreamingSchemaValidator.
+ * Copyright (C) 2026 agent
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "ola/Clock.h"
+#include "ola/Logging.h"
+#include "ola/base/Flags.h"
+#include "ola/base/Init.h"
+#include "ola/file/Util.h"
+#include "ola/testing/HeapCounter.h"
+#include "ola/web/Json.h"
+#include "ola/web/JsonParser.h"
+#include "ola/web/JsonSchema.h"
+#include "ola/web/StreamingSchemaValidator.h"
+
+using ola::Clock;
+using ola::TimeInterval;
+using ola::TimeStamp;
+using ola::testing::GetHeapStats;
+using ola::testing::HeapStats;
+using ola::web::JsonParser;
+using ola::web::JsonSchema;
+using ola::web::JsonValue;
+using ola::web::StreamingSchemaValidator;
+using std::auto_ptr;
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+
+DEFINE_string(testdata, "common/web/testdata",
+              "The directory containing the schema test files");
+DEFINE_s_uint32(iterations, i, 200, "The number of iterations of each test");
+DEFINE_s_uint32(fixtures, f, 5000,
+                "The number of fixtures in the large document");
+
+namespace {
+
+/*
+ * Measures the time, peak heap usage & number of allocations.
+ */
+class Measurement {
+ public:
+  Measurement()
+      : m_start_stats(GetHeapStats()) {
+    ola::testing::ResetHeapPeak();
+    m_clock.CurrentMonotonicTime(&m_start);
+  }
+
+  void Report(const string &name, unsigned int runs) {
+    TimeStamp end;
+    m_clock.CurrentMonotonicTime(&end);
+    TimeInterval elapsed = end - m_start;
+    HeapStats stats = GetHeapStats();
+    uint64_t allocations = stats.allocations - m_start_stats.allocations;
+    cout << std::left << std::setw(36) << name << std::right << std::fixed
+         << std::setprecision(2) << std::setw(12)
+         << (runs ? static_cast<double>(elapsed.AsInt()) / runs : 0)
+         << " us" << std::setw(12) << (stats.peak - m_start_stats.current)
+         << " B peak" << std::setw(12)
+         << (runs ? allocations / runs : 0)
+         << " allocs" << endl;
+  }
+
+ private:
+  Clock m_clock;
+  TimeStamp m_start;
+  HeapStats m_start_stats;
+};
+
+/*
+ * Read the positive schemas from a file in the testdata directory.
+ */
+void ReadSchemas(const string &filename, vector<string> *schemas) {
+  string file_path = FLAGS_testdata.str();
+  file_path.push_back(ola::file::PATH_SEPARATOR);
+  file_path.append(filename);
+
+  std::ifstream in(file_path.data(), std::ios::in);
+  if (!in.is_open()) {
+    OLA_WARN << "Failed to open " << file_path;
+    return;
+  }
+
+  bool in_schema = false;
+  string schema;
+  string line;
+  while (getline(in, line)) {
+    if (line.compare(0, 2, "//") == 0) {
+      continue;
+    } else if (line == "=== POSITIVE ===" || line == "=== NEGATIVE ===" ||
+               line == "--------") {
+      if (in_schema && !schema.empty()) {
+        schemas->push_back(schema);
+      }
+      schema.clear();
+      in_schema = (line == "=== POSITIVE ===");
+    } else if (in_schema) {
+      schema.append(line);
+      schema.push_back('\n');
+    }
+  }
+  if (in_schema && !schema.empty()) {
+    schemas->push_back(schema);
+  }
+}
+
+bool ValidateDOM(JsonSchema *schema, const string &input) {
+  string error;
+  auto_ptr<JsonValue> value(JsonParser::Parse(input, &error));
+  return value.get() && schema->IsValid(*value);
+}
+
+/*
+ * Run every schema from the testdata directory against a set of small
+ * documents.
+ */
+void RunCorpus() {
+  const char *files[] = {
+    "allof.test", "anyof.test", "arrays.test", "basic-keywords.test",
+    "definitions.test", "integers.test", "misc.test", "not.test",
+    "objects.test", "oneof.test", "strings.test", "type.test",
+  };
+
+  const char *documents[] = {
+    "true", "null", "-12", "1.2", "\"foo\"", "[]", "{}", "[1, 2, 3]",
+    "[\"foo\", true, null, {}]", "[[1], [2, [3]]]",
+    "{\"foo\": \"bar\", \"baz\": [1, 2]}",
+    "{\"name\": {\"first\": \"Simon\"}, \"age\": 30, \"tags\": []}",
+  };
+  const unsigned int document_count = sizeof(documents) / sizeof(documents[0]);
+
+  vector<JsonSchema*> schemas;
+  for (unsigned int i = 0; i < sizeof(files) / sizeof(files[0]); i++) {
+    vector<string> inputs;
+    ReadSchemas(files[i], &inputs);
+    vector<string>::const_iterator iter = inputs.begin();
+    for (; iter != inputs.end(); ++iter) {
+      string error;
+      JsonSchema *schema = JsonSchema::FromString(*iter, &error);
+      if (schema) {
+        schemas.push_back(schema);
+      }
+    }
+  }
+
+  if (schemas.empty()) {
+    OLA_WARN << "No schemas found in " << FLAGS_testdata.str();
+    return;
+  }
+  cout << schemas.size() << " schemas x " << document_count << " documents"
+       << endl;
+
+  const unsigned int runs = FLAGS_iterations * schemas.size() * document_count;
+  unsigned int dom_valid = 0;
+  {
+    Measurement measurement;
+    for (unsigned int i = 0; i < FLAGS_iterations; i++) {
+      vector<JsonSchema*>::iterator iter = schemas.begin();
+      for (; iter != schemas.end(); ++iter) {
+        for (unsigned int j = 0; j < document_count; j++) {
+          dom_valid += ValidateDOM(*iter, documents[j]);
+        }
+      }
+    }
+    measurement.Report("Corpus, JsonSchema::IsValid", runs);
+  }
+
+  unsigned int streaming_valid = 0;
+  {
+    vector<StreamingSchemaValidator*> validators;
+    vector<JsonSchema*>::iterator iter = schemas.begin();
+    for (; iter != schemas.end(); ++iter) {
+      validators.push_back(new StreamingSchemaValidator(*iter));
+    }
+
+    Measurement measurement;
+    for (unsigned int i = 0; i < FLAGS_iterations; i++) {
+      vector<StreamingSchemaValidator*>::iterator validator_iter =
+          validators.begin();
+      for (; validator_iter != validators.end(); ++validator_iter) {
+        for (unsigned int j = 0; j < document_count; j++) {
+          streaming_valid += (*validator_iter)->Validate(documents[j]);
+        }
+      }
+    }
+    measurement.Report("Corpus, StreamingSchemaValidator", runs);
+
+    for (unsigned int i = 0; i < validators.size(); i++) {
+      delete validators[i];
+    }
+  }
+
+  if (dom_valid != streaming_valid) {
+    OLA_WARN << "Results differ: " << dom_valid << " vs " << streaming_valid;
+  }
+
+  for (unsigned int i = 0; i < schemas.size(); i++) {
+    delete schemas[i];
+  }
+}
+
+/*
+ * Validate a large document, a list of fixtures.
+ */
+void RunLargeDocument() {
+  const string schema_json =
+    "{\"type\": \"array\","
+    " \"items\": {"
+    "   \"type\": \"object\","
+    "   \"properties\": {"
+    "     \"id\": {\"type\": \"integer\", \"minimum\": 0},"
+    "     \"label\": {\"type\": \"string\", \"maxLength\": 32},"
+    "     \"mode\": {\"type\": \"string\","
+    "                \"enum\": [\"dimmer\", \"rgb\", \"rgbw\", \"cmy\"]},"
+    "     \"channels\": {"
+    "       \"type\": \"array\","
+    "       \"items\": {\"type\": \"integer\", \"minimum\": 0,"
+    "                   \"maximum\": 255}"
+    "     }"
+    "   },"
+    "   \"required\": [\"id\", \"mode\"],"
+    "   \"additionalProperties\": false"
+    " }"
+    "}";
+
+  std::ostringstream str;
+  str << "[";
+  for (unsigned int i = 0; i < FLAGS_fixtures; i++) {
+    if (i) {
+      str << ", ";
+    }
+    str << "{\"id\": " << i << ", \"label\": \"Fixture " << i
+        << "\", \"mode\": \"rgbw\", \"channels\": [" << (i % 256)
+        << ", 0, 255, 128]}";
+  }
+  str << "]";
+  const string document = str.str();
+
+  string error;
+  auto_ptr<JsonSchema> schema(JsonSchema::FromString(schema_json, &error));
+  if (!schema.get()) {
+    OLA_WARN << "Failed to parse schema: " << error;
+    return;
+  }
+
+  cout << FLAGS_fixtures << " fixtures, " << document.size() << " bytes"
+       << endl;
+
+  const unsigned int runs = std::max(1u, FLAGS_iterations / 10);
+  bool dom_result = true;
+  {
+    Measurement measurement;
+    for (unsigned int i = 0; i < runs; i++) {
+      dom_result &= ValidateDOM(schema.get(), document);
+    }
+    measurement.Report("Large, JsonSchema::IsValid", runs);
+  }
+
+  bool streaming_result = true;
+  {
+    StreamingSchemaValidator validator(schema.get());
+    Measurement measurement;
+    for (unsigned int i = 0; i < runs; i++) {
+      streaming_result &= validator.Validate(document);
+    }
+    measurement.Report("Large, StreamingSchemaValidator", runs);
+  }
+
+  if (!dom_result || !streaming_result) {
+    OLA_WARN << "Large document failed validation";
+  }
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  ola::AppInit(&argc, argv, "",
+               "Compare JsonSchema::IsValid() with the "
+               "StreamingSchemaValidator.");
+
+  RunCorpus();
+  RunLargeDocument();
+  return 0;
+}
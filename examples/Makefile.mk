@@ -72,6 +72,7 @@ examples_ola_rdm_discover_LDADD = $(EXAMPLE_COMMON_LIBS)
 
 examples_ola_recorder_SOURCES = \
     examples/ola-recorder.cpp \
+    examples/ShowFormat.h \
     examples/ShowLoader.h \
     examples/ShowLoader.cpp \
     examples/ShowPlayer.h \
@@ -147,5 +148,12 @@ examples/RecorderVerifyTest.sh: examples/Makefile.mk
 	echo "for FILE in ${srcdir}/examples/testdata/dos_line_endings ${srcdir}/examples/testdata/multiple_unis ${srcdir}/examples/testdata/partial_frames ${srcdir}/examples/testdata/single_uni ${srcdir}/examples/testdata/trailing_timeout; do echo \"Checking \$$FILE\"; ${top_builddir}/examples/ola_recorder${EXEEXT} --verify \$$FILE; STATUS=\$$?; if [ \$$STATUS -ne 0 ]; then echo \"FAIL: \$$FILE caused ola_recorder to exit with status \$$STATUS\"; exit \$$STATUS; fi; done; exit 0" > examples/RecorderVerifyTest.sh
 	chmod +x examples/RecorderVerifyTest.sh
 
-CLEANFILES += examples/RecorderVerifyTest.sh
+test_scripts += examples/RecorderConvertTest.sh
+
+examples/RecorderConvertTest.sh: examples/Makefile.mk
+	echo "for FILE in ${srcdir}/examples/testdata/dos_line_endings ${srcdir}/examples/testdata/multiple_unis ${srcdir}/examples/testdata/partial_frames ${srcdir}/examples/testdata/single_uni ${srcdir}/examples/testdata/trailing_timeout; do echo \"Checking \$$FILE\"; BINARY=examples/RecorderConvertTest.bin; TEXT=examples/RecorderConvertTest.txt; ${top_builddir}/examples/ola_recorder${EXEEXT} --convert \$$FILE --output \$$BINARY --binary || exit 1; ${top_builddir}/examples/ola_recorder${EXEEXT} --convert \$$BINARY --output \$$TEXT || exit 1; for START in 0 500 1000; do EXPECTED=\`${top_builddir}/examples/ola_recorder${EXEEXT} --verify \$$FILE --start \$$START 2>/dev/null\`; for CONVERTED in \$$BINARY \$$TEXT; do ACTUAL=\`${top_builddir}/examples/ola_recorder${EXEEXT} --verify \$$CONVERTED --start \$$START 2>/dev/null\`; if [ \"\$$EXPECTED\" != \"\$$ACTUAL\" ]; then echo \"FAIL: \$$CONVERTED differs from \$$FILE when starting at \$$START\"; exit 1; fi; done; done; done; rm -f examples/RecorderConvertTest.bin examples/RecorderConvertTest.txt; exit 0" > examples/RecorderConvertTest.sh
+	chmod +x examples/RecorderConvertTest.sh
+
+CLEANFILES += examples/RecorderVerifyTest.sh \
+              examples/RecorderConvertTest.sh
 endif
@@ -0,0 +1,61 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * ShowFormat.h
+ * Constants for the binary show file format.
+ * Copyright (C) 2026 agent
+ *
+ * All values are in network byte order. The file starts with an 8 byte magic
+ * string and a version byte, followed by a series of records. Each record
+ * starts with a type byte:
+ *
+ *  - SHOW_FULL_FRAME: universe (4), next wait in ms (4), length (2), data.
+ *  - SHOW_DELTA_FRAME: universe (4), next wait in ms (4), length (2), run
+ *    count (2), then for each run: offset (2), run length (2), data. The runs
+ *    are the slots that changed since the previous frame for the universe.
+ *  - SHOW_KEYFRAME: show time in ms (8), universe count (2), then for each
+ *    universe: universe (4), length (2), data. A keyframe holds the state of
+ *    every universe at that point in the show, so playback can start from
+ *    there.
+ *  - SHOW_INDEX: entry count (4), then for each keyframe: show time in ms (8),
+ *    file offset (8).
+ *
+ * The file ends with the offset of the index (8) and an 8 byte index magic
+ * string. A file without an index, e.g. if the recording was interrupted, can
+ * still be played from the start.
+ */
+
+#include <stdint.h>
+
+#ifndef EXAMPLES_SHOWFORMAT_H_
+#define EXAMPLES_SHOWFORMAT_H_
+
+typedef enum {
+  SHOW_FULL_FRAME = 1,
+  SHOW_DELTA_FRAME = 2,
+  SHOW_KEYFRAME = 3,
+  SHOW_INDEX = 4
+} BinaryShowRecord;
+
+const char BINARY_SHOW_MAGIC[] = "OLASHOWB";
+const char BINARY_SHOW_INDEX_MAGIC[] = "OLAINDEX";
+const unsigned int BINARY_SHOW_MAGIC_SIZE = 8;
+const uint8_t BINARY_SHOW_VERSION = 1;
+const unsigned int BINARY_SHOW_HEADER_SIZE = BINARY_SHOW_MAGIC_SIZE + 1;
+const unsigned int BINARY_SHOW_TRAILER_SIZE = 8 + BINARY_SHOW_MAGIC_SIZE;
+
+// Write a keyframe at most once every this many ms of show time.
+const unsigned int BINARY_SHOW_KEYFRAME_INTERVAL = 1000;
+#endif  // EXAMPLES_SHOWFORMAT_H_
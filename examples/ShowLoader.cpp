@@ -17,26 +17,36 @@
  * A class that reads OLA show files
  * Copyright (C) 2011 Simon Newton
  *
- * The data file is in the form:
+ * The text data file is in the form:
  * universe-number channel1,channel2,channel3
  * delay-in-ms
  * universe-number channel1,channel2,channel3
+ *
+ * See ShowFormat.h for the binary format.
  */
 
 #include <errno.h>
 #include <string.h>
+#include <ola/Constants.h>
 #include <ola/DmxBuffer.h>
 #include <ola/Logging.h>
 #include <ola/StringUtils.h>
+#include <ola/network/NetworkUtils.h>
+#include <algorithm>
 #include <fstream>
 #include <ios>
 #include <iostream>
+#include <limits>
+#include <map>
 #include <sstream>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "examples/ShowFormat.h"
 #include "examples/ShowLoader.h"
 
+using std::map;
 using std::vector;
 using std::string;
 using ola::DmxBuffer;
@@ -46,7 +56,8 @@ const char ShowLoader::OLA_SHOW_HEADER[] = "OLA Show";
 
 ShowLoader::ShowLoader(const string &filename)
     : m_filename(filename),
-      m_line(0) {
+      m_line(0),
+      m_binary(false) {
 }
 
 
@@ -62,12 +73,32 @@ ShowLoader::~ShowLoader() {
  * @returns true if we could open the file, false otherwise.
  */
 bool ShowLoader::Load() {
-  m_show_file.open(m_filename.data());
+  m_show_file.open(m_filename.data(), std::ios::in | std::ios::binary);
   if (!m_show_file.is_open()) {
     OLA_FATAL << "Can't open " << m_filename << ": " << strerror(errno);
     return false;
   }
 
+  char magic[BINARY_SHOW_MAGIC_SIZE];
+  m_show_file.read(magic, BINARY_SHOW_MAGIC_SIZE);
+  if (m_show_file.gcount() == BINARY_SHOW_MAGIC_SIZE &&
+      memcmp(magic, BINARY_SHOW_MAGIC, BINARY_SHOW_MAGIC_SIZE) == 0) {
+    uint8_t version;
+    if (!ReadValue(&version) || version != BINARY_SHOW_VERSION) {
+      OLA_WARN << "Unknown binary show file version";
+      return false;
+    }
+    m_binary = true;
+    if (!LoadIndex()) {
+      OLA_INFO << m_filename << " doesn't have an index, seeking will be "
+               << "slow";
+    }
+    Reset();
+    return true;
+  }
+
+  m_show_file.clear();
+  m_show_file.seekg(0, std::ios::beg);
   string line;
   ReadLine(&line);
   if (line != OLA_SHOW_HEADER) {
@@ -84,6 +115,13 @@ bool ShowLoader::Load() {
  */
 void ShowLoader::Reset() {
   m_show_file.clear();
+  if (m_binary) {
+    m_show_file.seekg(BINARY_SHOW_HEADER_SIZE, std::ios::beg);
+    m_universe_state.clear();
+    m_line = 0;
+    return;
+  }
+
   m_show_file.seekg(0, std::ios::beg);
   // skip over the first line
   string line;
@@ -154,6 +192,10 @@ ShowLoader::State ShowLoader::NextFrame(unsigned int *universe,
  * @param entry a ShowEntry to fill with data
  */
 ShowLoader::State ShowLoader::NextEntry(ShowEntry *entry) {
+  if (m_binary) {
+    return NextBinaryEntry(entry);
+  }
+
   State state = NextFrame(&entry->universe, &entry->buffer);
   if (state != OK) {
     return state;
@@ -174,3 +216,214 @@ void ShowLoader::ReadLine(string *line) {
   ola::StripSuffix(line, "\r");
   m_line++;
 }
+
+
+bool ShowLoader::FindKeyframe(uint64_t time, uint64_t *keyframe_time) const {
+  if (m_index.empty()) {
+    return false;
+  }
+
+  KeyframeIndex::const_iterator iter = std::upper_bound(
+      m_index.begin(), m_index.end(),
+      std::make_pair(time, std::numeric_limits<uint64_t>::max()));
+  if (iter == m_index.begin()) {
+    return false;
+  }
+  --iter;
+  *keyframe_time = iter->first;
+  return true;
+}
+
+
+ShowLoader::State ShowLoader::SeekToKeyframe(uint64_t keyframe_time,
+                                             vector<ShowEntry> *entries) {
+  KeyframeIndex::const_iterator iter = std::lower_bound(
+      m_index.begin(), m_index.end(),
+      std::make_pair(keyframe_time, static_cast<uint64_t>(0)));
+  if (iter == m_index.end() || iter->first != keyframe_time) {
+    return INVALID_LINE;
+  }
+
+  m_show_file.clear();
+  m_show_file.seekg(iter->second, std::ios::beg);
+  uint8_t type;
+  if (!ReadValue(&type) || type != SHOW_KEYFRAME || !ReadKeyframe()) {
+    OLA_WARN << "Invalid keyframe at offset " << iter->second;
+    return INVALID_LINE;
+  }
+
+  map<unsigned int, DmxBuffer>::const_iterator state_iter;
+  for (state_iter = m_universe_state.begin();
+       state_iter != m_universe_state.end(); ++state_iter) {
+    ShowEntry entry;
+    entry.universe = state_iter->first;
+    entry.buffer = state_iter->second;
+    entry.next_wait = 0;
+    entries->push_back(entry);
+  }
+  return OK;
+}
+
+
+/**
+ * Load the keyframe index from the end of a binary show file.
+ */
+bool ShowLoader::LoadIndex() {
+  m_index.clear();
+  m_show_file.seekg(0, std::ios::end);
+  const uint64_t file_size = m_show_file.tellg();
+  if (file_size < BINARY_SHOW_HEADER_SIZE + BINARY_SHOW_TRAILER_SIZE) {
+    return false;
+  }
+
+  m_show_file.seekg(file_size - BINARY_SHOW_TRAILER_SIZE, std::ios::beg);
+  uint64_t index_offset;
+  char magic[BINARY_SHOW_MAGIC_SIZE];
+  if (!ReadValue(&index_offset) ||
+      !ReadData(reinterpret_cast<uint8_t*>(magic), BINARY_SHOW_MAGIC_SIZE) ||
+      memcmp(magic, BINARY_SHOW_INDEX_MAGIC, BINARY_SHOW_MAGIC_SIZE) != 0 ||
+      index_offset >= file_size) {
+    return false;
+  }
+
+  m_show_file.seekg(index_offset, std::ios::beg);
+  uint8_t type;
+  uint32_t count;
+  if (!ReadValue(&type) || type != SHOW_INDEX || !ReadValue(&count)) {
+    return false;
+  }
+
+  for (uint32_t i = 0; i < count; i++) {
+    uint64_t time, offset;
+    if (!ReadValue(&time) || !ReadValue(&offset) || offset >= index_offset) {
+      m_index.clear();
+      return false;
+    }
+    m_index.push_back(std::make_pair(time, offset));
+  }
+  return true;
+}
+
+
+ShowLoader::State ShowLoader::NextBinaryEntry(ShowEntry *entry) {
+  while (true) {
+    uint8_t type;
+    if (!ReadValue(&type)) {
+      return END_OF_FILE;
+    }
+    m_line++;
+
+    switch (type) {
+      case SHOW_FULL_FRAME:
+      case SHOW_DELTA_FRAME:
+        if (!ReadBinaryFrame(type, entry)) {
+          OLA_WARN << "Record " << m_line << " is truncated";
+          return INVALID_LINE;
+        }
+        // Match the text format, where the last frame has no timeout.
+        return (entry->next_wait == 0 && AtBinaryEnd()) ? END_OF_FILE : OK;
+      case SHOW_KEYFRAME:
+        if (!ReadKeyframe()) {
+          OLA_WARN << "Record " << m_line << " is truncated";
+          return INVALID_LINE;
+        }
+        break;
+      case SHOW_INDEX:
+        return END_OF_FILE;
+      default:
+        OLA_WARN << "Record " << m_line << " has unknown type "
+                 << static_cast<int>(type);
+        return INVALID_LINE;
+    }
+  }
+}
+
+
+bool ShowLoader::ReadBinaryFrame(uint8_t type, ShowEntry *entry) {
+  uint32_t universe, next_wait;
+  uint16_t length;
+  if (!ReadValue(&universe) || !ReadValue(&next_wait) ||
+      !ReadValue(&length) || length > ola::DMX_UNIVERSE_SIZE) {
+    return false;
+  }
+
+  uint8_t data[ola::DMX_UNIVERSE_SIZE];
+  if (type == SHOW_FULL_FRAME) {
+    if (!ReadData(data, length)) {
+      return false;
+    }
+  } else {
+    // Start with the previous frame for this universe and apply the changes.
+    memset(data, 0, length);
+    const DmxBuffer &previous = m_universe_state[universe];
+    unsigned int previous_length = std::min(
+        static_cast<unsigned int>(length), previous.Size());
+    previous.GetRange(0, data, &previous_length);
+
+    uint16_t run_count;
+    if (!ReadValue(&run_count)) {
+      return false;
+    }
+    for (uint16_t i = 0; i < run_count; i++) {
+      uint16_t offset, run_length;
+      if (!ReadValue(&offset) || !ReadValue(&run_length) ||
+          offset + run_length > length ||
+          !ReadData(data + offset, run_length)) {
+        return false;
+      }
+    }
+  }
+
+  entry->universe = universe;
+  entry->next_wait = next_wait;
+  entry->buffer.Set(data, length);
+  m_universe_state[universe] = entry->buffer;
+  return true;
+}
+
+
+bool ShowLoader::ReadKeyframe() {
+  uint64_t time;
+  uint16_t universe_count;
+  if (!ReadValue(&time) || !ReadValue(&universe_count)) {
+    return false;
+  }
+
+  m_universe_state.clear();
+  uint8_t data[ola::DMX_UNIVERSE_SIZE];
+  for (uint16_t i = 0; i < universe_count; i++) {
+    uint32_t universe;
+    uint16_t length;
+    if (!ReadValue(&universe) || !ReadValue(&length) ||
+        length > ola::DMX_UNIVERSE_SIZE || !ReadData(data, length)) {
+      return false;
+    }
+    m_universe_state[universe].Set(data, length);
+  }
+  return true;
+}
+
+
+/**
+ * Check if there are no more frames to read.
+ */
+bool ShowLoader::AtBinaryEnd() {
+  const int next = m_show_file.peek();
+  return next == std::char_traits<char>::eof() || next == SHOW_INDEX;
+}
+
+
+template <typename T>
+bool ShowLoader::ReadValue(T *value) {
+  if (!ReadData(reinterpret_cast<uint8_t*>(value), sizeof(T))) {
+    return false;
+  }
+  *value = ola::network::NetworkToHost(*value);
+  return true;
+}
+
+
+bool ShowLoader::ReadData(uint8_t *data, unsigned int length) {
+  m_show_file.read(reinterpret_cast<char*>(data), length);
+  return static_cast<unsigned int>(m_show_file.gcount()) == length;
+}
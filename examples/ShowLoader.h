@@ -19,9 +19,13 @@
  */
 
 #include <ola/DmxBuffer.h>
+#include <stdint.h>
 
+#include <map>
 #include <string>
 #include <fstream>
+#include <utility>
+#include <vector>
 
 #ifndef EXAMPLES_SHOWLOADER_H_
 #define EXAMPLES_SHOWLOADER_H_
@@ -36,7 +40,8 @@ struct ShowEntry {
 };
 
 /**
- * Loads a show file and reads the DMX data.
+ * Loads a show file and reads the DMX data. Both the text and binary formats
+ * are supported.
  */
 class ShowLoader {
  public:
@@ -55,15 +60,45 @@ class ShowLoader {
 
   State NextEntry(ShowEntry *entry);
 
+  /**
+   * @brief Find the last keyframe at or before @p time.
+   * @param time the show time in ms.
+   * @param[out] keyframe_time the time of the keyframe.
+   * @returns false if the show doesn't have a keyframe index.
+   */
+  bool FindKeyframe(uint64_t time, uint64_t *keyframe_time) const;
+
+  /**
+   * @brief Move to the keyframe at @p keyframe_time.
+   * @param keyframe_time the time of a keyframe, from FindKeyframe().
+   * @param[out] entries the state of each universe at the keyframe.
+   */
+  State SeekToKeyframe(uint64_t keyframe_time,
+                       std::vector<ShowEntry> *entries);
+
  private:
+  typedef std::vector<std::pair<uint64_t, uint64_t> > KeyframeIndex;
+
   const std::string m_filename;
   std::ifstream m_show_file;
   unsigned int m_line;
+  bool m_binary;
+  std::map<unsigned int, ola::DmxBuffer> m_universe_state;
+  KeyframeIndex m_index;
 
   static const char OLA_SHOW_HEADER[];
 
   void ReadLine(std::string *line);
   State NextTimeout(unsigned int *timeout);
   State NextFrame(unsigned int *universe, ola::DmxBuffer *data);
+
+  bool LoadIndex();
+  State NextBinaryEntry(ShowEntry *entry);
+  bool ReadBinaryFrame(uint8_t type, ShowEntry *entry);
+  bool ReadKeyframe();
+  bool AtBinaryEnd();
+  template <typename T>
+  bool ReadValue(T *value);
+  bool ReadData(uint8_t *data, unsigned int length);
 };
 #endif  // EXAMPLES_SHOWLOADER_H_
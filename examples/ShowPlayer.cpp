@@ -17,13 +17,16 @@
  * A simple show playback system.
  * Copyright (C) 2011 Simon Newton
  *
- * The data file is in the form:
+ * The text data file is in the form:
  * universe-number channel1,channel2,channel3
  * delay-in-ms
  * universe-number channel1,channel2,channel3
+ *
+ * See ShowFormat.h for the binary format.
  */
 
 #include <errno.h>
+#include <math.h>
 #include <string.h>
 #include <ola/Callback.h>
 #include <ola/Logging.h>
@@ -31,6 +34,7 @@
 #include <ola/base/SysExits.h>
 #include <ola/client/ClientWrapper.h>
 #include <ola/client/OlaClient.h>
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <string>
@@ -55,6 +59,11 @@ ShowPlayer::ShowPlayer(const string &filename)
       m_playback_pos(0),
       m_run_time(0),
       m_simulate(false),
+      m_timeout_count(0),
+      m_lateness_sum(0),
+      m_lateness_sum_squares(0),
+      m_max_lateness(0),
+      m_last_lateness(0),
       m_next_task(TASK_LOOP),
       m_status(ola::EXIT_SOFTWARE) {
 }
@@ -95,10 +104,12 @@ int ShowPlayer::Playback(unsigned int iterations,
           duration * 1000,
           ola::NewSingleCallback(ss, &ola::io::SelectServer::Terminate));
     }
+    m_clock.CurrentMonotonicTime(&m_epoch);
     if ((SeekTo(m_start) != ShowLoader::OK)) {
       return ola::EXIT_DATAERR;
     }
     ss->Run();
+    ReportTiming();
   } else {
     // Never infinite loop when simulating
     if (iterations == 0 && duration == 0) {
@@ -139,6 +150,7 @@ int ShowPlayer::Playback(unsigned int iterations,
  * Restart playback from start point
  */
 void ShowPlayer::Loop() {
+  RecordLateness();
   ShowLoader::State state = SeekTo(m_start);
 
   switch (state) {
@@ -164,18 +176,35 @@ void ShowPlayer::Loop() {
  * @param seek_time the time (in milliseconds) to seek to
  */
 ShowLoader::State ShowPlayer::SeekTo(uint64_t seek_time) {
-  // Seeking to a time before the playhead's position requires moving from the
-  // beginning of the file.  This could be optimized more if this happens
-  // frequently.
-  // Seeking to the current position can result in the frame being skipped;
-  // ensure the frame is loaded in this case as well.
-  if (seek_time <= m_playback_pos) {
+  map<unsigned int, ShowEntry> entries;
+
+  // If the show has a keyframe index, jump to the closest keyframe rather
+  // than reading through the file.
+  uint64_t keyframe_time;
+  if (m_loader.FindKeyframe(seek_time, &keyframe_time) &&
+      (seek_time <= m_playback_pos || keyframe_time > m_playback_pos)) {
+    vector<ShowEntry> keyframe;
+    ShowLoader::State state = m_loader.SeekToKeyframe(keyframe_time,
+                                                      &keyframe);
+    if (state != ShowLoader::OK) {
+      HandleInvalidLine();
+      return state;
+    }
+    vector<ShowEntry>::const_iterator iter = keyframe.begin();
+    for (; iter != keyframe.end(); ++iter) {
+      entries[iter->universe] = *iter;
+    }
+    m_playback_pos = keyframe_time;
+  } else if (seek_time <= m_playback_pos) {
+    // Seeking to a time before the playhead's position requires moving from
+    // the beginning of the file.
+    // Seeking to the current position can result in the frame being skipped;
+    // ensure the frame is loaded in this case as well.
     m_loader.Reset();
     m_playback_pos = 0;
   }
 
   // Keep reading through the show file until desired time is reached.
-  map<unsigned int, ShowEntry> entries;
   uint64_t playhead_time = m_playback_pos;
   ShowLoader::State state;
   bool found = false;
@@ -231,12 +260,23 @@ ShowLoader::State ShowPlayer::SeekTo(uint64_t seek_time) {
 
 
 /**
- * Send the next frame in the show file
+ * Send the next frame in the show file, along with any frames which share its
+ * timestamp.
  */
 void ShowPlayer::SendNextFrame() {
+  RecordLateness();
+
   ShowEntry entry;
   ShowLoader::State state = m_loader.NextEntry(&entry);
 
+  // Universes recorded in the same frame are sent together, rather than one
+  // per timeout.
+  while (state == ShowLoader::OK && entry.next_wait == 0) {
+    m_status = ola::EXIT_OK;
+    SendFrame(entry);
+    state = m_loader.NextEntry(&entry);
+  }
+
   if (state == ShowLoader::OK) {
     m_status = ola::EXIT_OK;
     SendEntry(entry);
@@ -283,10 +323,68 @@ void ShowPlayer::RegisterNextTimeout(const unsigned int timeout) {
   m_next_task = TASK_NEXT_FRAME;
   if (!m_simulate) {
     OLA_DEBUG << "Registering timeout for " << timeout << "ms";
-    m_client.GetSelectServer()->RegisterSingleTimeout(
-        timeout,
-        ola::NewSingleCallback(this, &ShowPlayer::SendNextFrame));
+    ScheduleAt(m_run_time,
+               ola::NewSingleCallback(this, &ShowPlayer::SendNextFrame));
+  }
+}
+
+
+/**
+ * Run @p callback when playback reaches @p run_time.
+ * @param run_time the time (in milliseconds) since playback started.
+ * @param callback the callback to run.
+ */
+void ShowPlayer::ScheduleAt(uint64_t run_time,
+                            ola::SingleUseCallback0<void> *callback) {
+  m_deadline = m_epoch + ola::TimeInterval(
+      static_cast<int64_t>(run_time * ola::ONE_THOUSAND));
+
+  ola::TimeStamp now;
+  m_clock.CurrentMonotonicTime(&now);
+  ola::TimeInterval delay;
+  if (m_deadline > now) {
+    delay = m_deadline - now;
+  }
+  m_client.GetSelectServer()->RegisterSingleTimeout(delay, callback);
+}
+
+
+/**
+ * Record how far after its deadline the current timeout fired.
+ */
+void ShowPlayer::RecordLateness() {
+  if (m_simulate || !m_deadline.IsSet()) {
+    return;
+  }
+  ola::TimeStamp now;
+  m_clock.CurrentMonotonicTime(&now);
+  const int64_t lateness = (now - m_deadline).AsInt();
+
+  m_timeout_count++;
+  m_lateness_sum += lateness;
+  m_lateness_sum_squares += static_cast<double>(lateness) * lateness;
+  m_max_lateness = std::max(m_max_lateness, lateness);
+  m_last_lateness = lateness;
+}
+
+
+/**
+ * Log the timing accuracy of the playback.
+ */
+void ShowPlayer::ReportTiming() const {
+  if (m_timeout_count == 0) {
+    return;
   }
+  const double mean = static_cast<double>(m_lateness_sum) / m_timeout_count;
+  const double variance = m_lateness_sum_squares / m_timeout_count -
+                          mean * mean;
+  const double jitter = variance > 0 ? sqrt(variance) : 0;
+
+  OLA_INFO << "Played " << m_timeout_count << " timeouts over " << m_run_time
+           << " ms";
+  OLA_INFO << "Lateness: mean " << mean << " us, max " << m_max_lateness
+           << " us, jitter " << jitter << " us";
+  OLA_INFO << "Drift at end of playback: " << m_last_lateness << " us";
 }
 
 
@@ -337,9 +435,7 @@ void ShowPlayer::HandleEndOfShow() {
                << m_iteration_remaining << " iteration(s) remain "
                << "-----";
       OLA_INFO << "----- Waiting " << loop_delay << " ms before looping -----";
-      m_client.GetSelectServer()->RegisterSingleTimeout(
-          loop_delay,
-          ola::NewSingleCallback(this, &ShowPlayer::Loop));
+      ScheduleAt(m_run_time, ola::NewSingleCallback(this, &ShowPlayer::Loop));
     }
     return;
   } else {
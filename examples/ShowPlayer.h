@@ -18,6 +18,8 @@
  * Copyright (C) 2011 Simon Newton
  */
 
+#include <ola/Callback.h>
+#include <ola/Clock.h>
 #include <ola/DmxBuffer.h>
 #include <ola/client/ClientWrapper.h>
 
@@ -90,6 +92,19 @@ class ShowPlayer {
   std::map<unsigned int, uint64_t> m_frame_count;
   bool m_simulate;
 
+  // Deadlines are absolute, measured from the monotonic time playback
+  // started, so that timer latency doesn't accumulate over long shows.
+  ola::Clock m_clock;
+  ola::TimeStamp m_epoch;
+  ola::TimeStamp m_deadline;
+
+  // How late each timeout fired, in microseconds.
+  uint64_t m_timeout_count;
+  int64_t m_lateness_sum;
+  double m_lateness_sum_squares;
+  int64_t m_max_lateness;
+  int64_t m_last_lateness;
+
   /** Used for tracking simulation progress */
   typedef enum {
     TASK_COMPLETE,
@@ -104,6 +119,9 @@ class ShowPlayer {
   void SendNextFrame();
   void SendEntry(const ShowEntry &entry);
   void RegisterNextTimeout(unsigned int timeout);
+  void ScheduleAt(uint64_t run_time, ola::SingleUseCallback0<void> *callback);
+  void RecordLateness();
+  void ReportTiming() const;
   void SendFrame(const ShowEntry &entry);
   void HandleEndOfShow();
   void HandleInvalidLine();
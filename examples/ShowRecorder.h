@@ -37,7 +37,8 @@
 class ShowRecorder {
  public:
   ShowRecorder(const std::string &filename,
-               const std::vector<unsigned int> &universes);
+               const std::vector<unsigned int> &universes,
+               ShowSaver::Format format = ShowSaver::TEXT);
   ~ShowRecorder();
 
   int Init();
@@ -17,31 +17,47 @@
  * Writes show data to a file.
  * Copyright (C) 2011 Simon Newton
  *
- * The data file is in the form:
+ * The text data file is in the form:
  * universe-number channel1,channel2,channel3
  * delay-in-ms
  * universe-number channel1,channel2,channel3
+ *
+ * See ShowFormat.h for the binary format.
  */
 
 #include <errno.h>
 #include <string.h>
 #include <ola/DmxBuffer.h>
 #include <ola/Logging.h>
+#include <ola/network/NetworkUtils.h>
 #include <fstream>
 #include <iostream>
 #include <string>
+#include <utility>
+#include <vector>
 
+#include "examples/ShowFormat.h"
 #include "examples/ShowSaver.h"
 
 using std::string;
+using std::vector;
 using ola::DmxBuffer;
 using std::endl;
 
 
 const char ShowSaver::OLA_SHOW_HEADER[] = "OLA Show";
 
-ShowSaver::ShowSaver(const string &filename)
-    : m_filename(filename) {
+// The overhead of starting a new run in a delta frame.
+static const unsigned int RUN_HEADER_SIZE = 4;
+
+ShowSaver::ShowSaver(const string &filename, Format format)
+    : m_filename(filename),
+      m_format(format),
+      m_has_pending_entry(false),
+      m_entry_count(0),
+      m_last_wait(0),
+      m_show_time(0),
+      m_last_keyframe(0) {
 }
 
 
@@ -55,13 +71,23 @@ ShowSaver::~ShowSaver() {
  * @returns true if we could open the file, false otherwise.
  */
 bool ShowSaver::Open() {
-  m_show_file.open(m_filename.data());
+  if (m_format == BINARY) {
+    m_show_file.open(m_filename.data(),
+                     std::ios::out | std::ios::trunc | std::ios::binary);
+  } else {
+    m_show_file.open(m_filename.data());
+  }
   if (!m_show_file.is_open()) {
     OLA_FATAL << "Can't open " << m_filename << ": " << strerror(errno);
     return false;
   }
 
-  m_show_file << OLA_SHOW_HEADER << endl;
+  if (m_format == BINARY) {
+    m_show_file.write(BINARY_SHOW_MAGIC, BINARY_SHOW_MAGIC_SIZE);
+    WriteValue(BINARY_SHOW_VERSION);
+  } else {
+    m_show_file << OLA_SHOW_HEADER << endl;
+  }
   return true;
 }
 
@@ -71,9 +97,22 @@ bool ShowSaver::Open() {
  * Close the show file
  */
 void ShowSaver::Close() {
-  if (m_show_file.is_open()) {
-    m_show_file.close();
+  if (!m_show_file.is_open()) {
+    return;
+  }
+
+  if (m_has_pending_entry) {
+    m_has_pending_entry = false;
+    NewEntry(m_pending_entry);
   }
+
+  if (m_format == BINARY) {
+    WriteIndex();
+  } else if (m_entry_count && m_last_wait) {
+    // Preserve a trailing timeout
+    m_show_file << m_last_wait << endl;
+  }
+  m_show_file.close();
 }
 
 
@@ -84,13 +123,149 @@ bool ShowSaver::NewFrame(const ola::TimeStamp &arrival_time,
                          unsigned int universe,
                          const ola::DmxBuffer &data) {
   // TODO(simon): add much better error handling here
-  if (m_last_frame.IsSet()) {
-    // this is not the first frame so write the delay in ms
+  bool ok = true;
+  if (m_has_pending_entry) {
+    // this is not the first frame so we now know the delay in ms
     const ola::TimeInterval delta = arrival_time - m_last_frame;
-
-    m_show_file << delta.InMilliSeconds() << endl;
+    m_pending_entry.next_wait = delta.InMilliSeconds();
+    ok = NewEntry(m_pending_entry);
   }
   m_last_frame = arrival_time;
-  m_show_file << universe << " " << data.ToString() << endl;
-  return true;
+  m_pending_entry.universe = universe;
+  m_pending_entry.buffer = data;
+  m_pending_entry.next_wait = 0;
+  m_has_pending_entry = true;
+  return ok;
+}
+
+
+bool ShowSaver::NewEntry(const ShowEntry &entry) {
+  if (m_format == BINARY) {
+    WriteBinaryEntry(entry);
+  } else {
+    WriteTextEntry(entry);
+  }
+  m_entry_count++;
+  return m_show_file.good();
+}
+
+
+void ShowSaver::WriteTextEntry(const ShowEntry &entry) {
+  if (m_entry_count) {
+    m_show_file << m_last_wait << endl;
+  }
+  m_show_file << entry.universe << " " << entry.buffer.ToString() << endl;
+  m_last_wait = entry.next_wait;
+}
+
+
+/**
+ * Write a frame as the slots that changed since the previous frame for the
+ * universe, or as a full frame if that's smaller.
+ */
+void ShowSaver::WriteBinaryEntry(const ShowEntry &entry) {
+  if (m_index.empty() ||
+      m_show_time >= m_last_keyframe + BINARY_SHOW_KEYFRAME_INTERVAL) {
+    WriteKeyframe();
+  }
+
+  const uint8_t *data = entry.buffer.GetRaw();
+  const unsigned int length = entry.buffer.Size();
+  UniverseStateMap::const_iterator previous_iter =
+      m_universe_state.find(entry.universe);
+
+  vector<std::pair<unsigned int, unsigned int> > runs;
+  unsigned int delta_size = 2;
+  if (previous_iter != m_universe_state.end()) {
+    const DmxBuffer &previous = previous_iter->second;
+    unsigned int i = 0;
+    while (i < length) {
+      if (i < previous.Size() && data[i] == previous.Get(i)) {
+        i++;
+        continue;
+      }
+
+      // Extend the run over short gaps of unchanged slots, since those are
+      // cheaper than the header for a new run.
+      const unsigned int start = i;
+      unsigned int last_changed = i;
+      for (i++; i < length; i++) {
+        if (i >= previous.Size() || data[i] != previous.Get(i)) {
+          last_changed = i;
+        } else if (i - last_changed > RUN_HEADER_SIZE) {
+          break;
+        }
+      }
+      runs.push_back(std::make_pair(start, last_changed + 1 - start));
+      delta_size += RUN_HEADER_SIZE + last_changed + 1 - start;
+      i = last_changed + 1;
+    }
+  }
+
+  const bool use_delta = (previous_iter != m_universe_state.end() &&
+                          delta_size < length);
+  WriteValue<uint8_t>(use_delta ? SHOW_DELTA_FRAME : SHOW_FULL_FRAME);
+  WriteValue<uint32_t>(entry.universe);
+  WriteValue<uint32_t>(entry.next_wait);
+  WriteValue<uint16_t>(length);
+  if (use_delta) {
+    WriteValue<uint16_t>(runs.size());
+    vector<std::pair<unsigned int, unsigned int> >::const_iterator iter;
+    for (iter = runs.begin(); iter != runs.end(); ++iter) {
+      WriteValue<uint16_t>(iter->first);
+      WriteValue<uint16_t>(iter->second);
+      WriteData(data + iter->first, iter->second);
+    }
+  } else {
+    WriteData(data, length);
+  }
+
+  m_universe_state[entry.universe] = entry.buffer;
+  m_show_time += entry.next_wait;
+}
+
+
+/**
+ * Write the state of all universes so playback can start from this point.
+ */
+void ShowSaver::WriteKeyframe() {
+  m_index.push_back(std::make_pair(
+      m_show_time, static_cast<uint64_t>(m_show_file.tellp())));
+  m_last_keyframe = m_show_time;
+
+  WriteValue<uint8_t>(SHOW_KEYFRAME);
+  WriteValue<uint64_t>(m_show_time);
+  WriteValue<uint16_t>(m_universe_state.size());
+  UniverseStateMap::const_iterator iter = m_universe_state.begin();
+  for (; iter != m_universe_state.end(); ++iter) {
+    WriteValue<uint32_t>(iter->first);
+    WriteValue<uint16_t>(iter->second.Size());
+    WriteData(iter->second.GetRaw(), iter->second.Size());
+  }
+}
+
+
+void ShowSaver::WriteIndex() {
+  const uint64_t index_offset = m_show_file.tellp();
+  WriteValue<uint8_t>(SHOW_INDEX);
+  WriteValue<uint32_t>(m_index.size());
+  KeyframeIndex::const_iterator iter = m_index.begin();
+  for (; iter != m_index.end(); ++iter) {
+    WriteValue<uint64_t>(iter->first);
+    WriteValue<uint64_t>(iter->second);
+  }
+  WriteValue<uint64_t>(index_offset);
+  m_show_file.write(BINARY_SHOW_INDEX_MAGIC, BINARY_SHOW_MAGIC_SIZE);
+}
+
+
+template <typename T>
+void ShowSaver::WriteValue(T value) {
+  value = ola::network::HostToNetwork(value);
+  m_show_file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+
+void ShowSaver::WriteData(const uint8_t *data, unsigned int length) {
+  m_show_file.write(reinterpret_cast<const char*>(data), length);
 }
@@ -20,9 +20,15 @@
 
 #include <ola/Clock.h>
 #include <ola/DmxBuffer.h>
+#include <stdint.h>
 
+#include <map>
 #include <string>
 #include <fstream>
+#include <utility>
+#include <vector>
+
+#include "examples/ShowLoader.h"
 
 #ifndef EXAMPLES_SHOWSAVER_H_
 #define EXAMPLES_SHOWSAVER_H_
@@ -32,20 +38,58 @@
  */
 class ShowSaver {
  public:
-  explicit ShowSaver(const std::string &filename);
+  typedef enum {
+    TEXT,
+    BINARY
+  } Format;
+
+  explicit ShowSaver(const std::string &filename, Format format = TEXT);
   ~ShowSaver();
 
   bool Open();
   void Close();
 
+  /**
+   * @brief Write a frame which arrived at @p arrival_time.
+   *
+   * Frames are held until the next one arrives, so we know how long to wait
+   * before playing the next frame.
+   */
   bool NewFrame(const ola::TimeStamp &arrival_time,
                 unsigned int universe,
                 const ola::DmxBuffer &data);
 
+  /**
+   * @brief Write a show entry, this is used when converting between formats.
+   */
+  bool NewEntry(const ShowEntry &entry);
+
  private:
+  typedef std::map<unsigned int, ola::DmxBuffer> UniverseStateMap;
+  typedef std::vector<std::pair<uint64_t, uint64_t> > KeyframeIndex;
+
   const std::string m_filename;
+  const Format m_format;
   std::ofstream m_show_file;
   ola::TimeStamp m_last_frame;
+  ShowEntry m_pending_entry;
+  bool m_has_pending_entry;
+  unsigned int m_entry_count;
+  unsigned int m_last_wait;
+
+  // Used for the binary format.
+  uint64_t m_show_time;
+  uint64_t m_last_keyframe;
+  UniverseStateMap m_universe_state;
+  KeyframeIndex m_index;
+
+  void WriteTextEntry(const ShowEntry &entry);
+  void WriteBinaryEntry(const ShowEntry &entry);
+  void WriteKeyframe();
+  void WriteIndex();
+  template <typename T>
+  void WriteValue(T value);
+  void WriteData(const uint8_t *data, unsigned int length);
 
   static const char OLA_SHOW_HEADER[];
 };
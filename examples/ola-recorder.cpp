@@ -35,6 +35,7 @@
 #include "examples/ShowPlayer.h"
 #include "examples/ShowLoader.h"
 #include "examples/ShowRecorder.h"
+#include "examples/ShowSaver.h"
 
 // On MinGW, SignalThread.h pulls in pthread.h which pulls in Windows.h, which
 // needs to be after WinSock2.h, hence this order
@@ -50,6 +51,13 @@ using std::string;
 DEFINE_s_string(playback, p, "", "The show file to playback.");
 DEFINE_s_string(record, r, "", "The show file to record data to.");
 DEFINE_string(verify, "", "The show file to verify.");
+DEFINE_string(convert, "",
+              "The show file to convert, the result is written to the file "
+              "given by --output.");
+DEFINE_string(output, "", "The file to write the converted show to.");
+DEFINE_default_bool(binary, false,
+                    "Use the binary show format when recording or "
+                    "converting.");
 DEFINE_default_bool(verify_playback, true,
                     "Don't verify show file before playback");
 DEFINE_s_string(universes, u, "",
@@ -97,7 +105,9 @@ int RecordShow() {
     universes.push_back(universe);
   }
 
-  ShowRecorder show_recorder(FLAGS_record.str(), universes);
+  ShowRecorder show_recorder(
+      FLAGS_record.str(), universes,
+      FLAGS_binary ? ShowSaver::BINARY : ShowSaver::TEXT);
   int status = show_recorder.Init();
   if (status)
     return status;
@@ -197,6 +207,49 @@ int VerifyShow(const string &filename, std::ostream *summary) {
 }
 
 
+/**
+ * Convert a show file between the text and binary formats.
+ */
+int ConvertShow() {
+  if (FLAGS_output.str().empty()) {
+    OLA_FATAL << "No output file specified, use --output";
+    return ola::EXIT_USAGE;
+  }
+
+  ShowLoader loader(FLAGS_convert.str());
+  if (!loader.Load()) {
+    return ola::EXIT_NOINPUT;
+  }
+
+  ShowSaver saver(FLAGS_output.str(),
+                  FLAGS_binary ? ShowSaver::BINARY : ShowSaver::TEXT);
+  if (!saver.Open()) {
+    return ola::EXIT_CANTCREAT;
+  }
+
+  uint64_t entries = 0;
+  ShowLoader::State state = ShowLoader::OK;
+  while (state == ShowLoader::OK) {
+    ShowEntry entry;
+    state = loader.NextEntry(&entry);
+    if (state == ShowLoader::INVALID_LINE) {
+      OLA_FATAL << "Invalid data at line " << loader.GetCurrentLineNumber();
+      return ola::EXIT_DATAERR;
+    }
+    if (entry.buffer.Size() > 0) {
+      if (!saver.NewEntry(entry)) {
+        OLA_FATAL << "Failed to write to " << FLAGS_output.str();
+        return ola::EXIT_IOERR;
+      }
+      entries++;
+    }
+  }
+  saver.Close();
+  cout << "Converted " << entries << " frames" << endl;
+  return ola::EXIT_OK;
+}
+
+
 /**
  * Playback a recorded show
  */
@@ -235,9 +288,10 @@ int PlaybackShow() {
 int main(int argc, char *argv[]) {
   ola::AppInit(&argc, argv,
                "[--record <file> --universes <universe_list>] [--playback "
-               "<file>] [--verify <file>]",
-               "Record a series of universes, or playback a previously "
-               "recorded show.");
+               "<file>] [--verify <file>] [--convert <file> --output <file>]",
+               "Record a series of universes, playback a previously "
+               "recorded show or convert a show between the text and binary "
+               "formats.");
 
   if (FLAGS_stop > 0 && FLAGS_stop < FLAGS_start) {
     OLA_FATAL << "Stop time must be later than start time.";
@@ -251,8 +305,11 @@ int main(int argc, char *argv[]) {
   } else if (!FLAGS_verify.str().empty()) {
     const int verified = VerifyShow(FLAGS_verify.str(), &cout);
     return verified;
+  } else if (!FLAGS_convert.str().empty()) {
+    return ConvertShow();
   } else {
-    OLA_FATAL << "One of --record or --playback or --verify must be provided";
+    OLA_FATAL << "One of --record, --playback, --verify or --convert must be "
+                 "provided";
     ola::DisplayUsage();
   }
   return ola::EXIT_OK;
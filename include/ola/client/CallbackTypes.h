@@ -32,6 +32,7 @@
 #include <ola/rdm/RDMCommand.h>
 #include <ola/rdm/UIDSet.h>
 
+#include <map>
 #include <string>
 #include <vector>
 
@@ -133,6 +134,16 @@ typedef SingleUseCallback2<void, const Result&, const ola::rdm::UIDSet&>
 typedef SingleUseCallback3<void, const Result&, const DMXMetadata&,
                            const DmxBuffer&> DMXCallback;
 
+/**
+ * @brief Called once when the multi-universe OlaClient::FetchDMX() completes.
+ * @param result the Result of the API call.
+ * @param data a map of universe id to DmxBuffer. Universes that don't exist
+ *   are left out.
+ */
+typedef SingleUseCallback2<void, const Result&,
+                           const std::map<unsigned int, DmxBuffer>&>
+    MultipleDMXCallback;
+
 /**
  * @brief Called when new DMX data arrives.
  * @param metadata the DMXMetadata associated with the frame.
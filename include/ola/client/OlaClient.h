@@ -34,6 +34,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace ola {
 namespace client {
@@ -255,6 +256,16 @@ class OlaClient {
    */
   void FetchDMX(unsigned int universe, DMXCallback *callback);
 
+  /**
+   * @brief Fetch the latest DMX data for a list of universes.
+   * @param universes the universe ids to get data for.
+   * @param callback the MultipleDMXCallback to invoke upon completion.
+   *
+   * This uses a single request if olad supports it.
+   */
+  void FetchDMX(const std::vector<unsigned int> &universes,
+                MultipleDMXCallback *callback);
+
   /**
    * @brief Trigger discovery for a universe.
    * @param universe the universe id to run discovery on.
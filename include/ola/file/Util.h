@@ -104,6 +104,26 @@ std::string FilenameFromPathOrPath(const std::string &path);
  * @return the filename (basename) part of the path or "" if it can't be found
  */
 std::string FilenameFromPath(const std::string &path);
+
+/**
+ * @brief Replace the contents of a file, atomically.
+ *
+ * The data is written to a temporary file in the same directory, flushed to
+ * disk and then renamed over the destination. Readers will either see the old
+ * contents or the new contents, never a partially written file.
+ * @param path the file to write.
+ * @param data the new contents of the file.
+ * @returns true if the file was replaced, false otherwise.
+ */
+bool WriteFileAtomically(const std::string &path, const std::string &data);
+
+/**
+ * @brief Read the entire contents of a file.
+ * @param path the file to read.
+ * @param[out] data the contents of the file.
+ * @returns true if the file was read, false otherwise.
+ */
+bool ReadFile(const std::string &path, std::string *data);
 }  // namespace file
 }  // namespace ola
 #endif  // INCLUDE_OLA_FILE_UTIL_H_
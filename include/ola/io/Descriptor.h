@@ -323,6 +323,21 @@ class ConnectedDescriptor: public BidirectionalFileDescriptor {
                       unsigned int size,
                       unsigned int &data_read);  // NOLINT(runtime/references)
 
+  /**
+   * @brief Read data from this descriptor into an IOQueue.
+   * @param queue the IOQueue to append the data to.
+   * @param size the maximum amount of data to read.
+   * @param data_read a value result argument which returns the size of the data
+   * appended to the queue.
+   * @returns -1 on error, 0 on success.
+   *
+   * The data is read directly into the free space at the end of the queue,
+   * using a single readv() call where available.
+   */
+  virtual int Receive(IOQueue *queue,
+                      unsigned int size,
+                      unsigned int &data_read);  // NOLINT(runtime/references)
+
   /**
    * @brief Enable on non-blocking reads..
    * @return true if it worked, false otherwise.
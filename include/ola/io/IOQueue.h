@@ -34,6 +34,85 @@
 namespace ola {
 namespace io {
 
+class IOQueue;
+
+/**
+ * @brief A read-only view of a range of bytes in an IOQueue.
+ *
+ * Views don't copy the data, so a message can be parsed in place while it's
+ * still in the queue. If the range lies within a single MemoryBlock,
+ * Contiguous() returns a pointer to it, otherwise the data can be accessed with
+ * Peek() or AsIOVec().
+ *
+ * A view is invalidated by any call that removes data from the front of the
+ * queue (Read, Pop, Clear etc.). Appending data to the queue doesn't invalidate
+ * it.
+ */
+class IOQueueView {
+ public:
+    IOQueueView()
+        : m_queue(NULL),
+          m_block_index(0),
+          m_offset(0),
+          m_size(0) {
+    }
+
+    unsigned int Size() const { return m_size; }
+    bool Empty() const { return m_size == 0; }
+
+    /**
+     * @brief Return a pointer to the data if it's contiguous.
+     * @returns a pointer to the data, or NULL if the view is empty or spans
+     *   more than one block.
+     */
+    const uint8_t *Contiguous() const;
+
+    /**
+     * @brief Copy up to length bytes from the start of the view.
+     * @returns the number of bytes copied.
+     */
+    unsigned int Peek(uint8_t *data, unsigned int length) const;
+
+    /**
+     * @brief Return the view as an array of IOVecs.
+     *
+     * Use IOVecInterface::FreeIOVec() to release the array.
+     */
+    const struct IOVec *AsIOVec(int *io_count) const;
+
+    /**
+     * @brief Return a view of part of this view.
+     * @param offset the offset from the start of this view.
+     * @param length the length of the new view, this is truncated to fit
+     *   within this view.
+     */
+    IOQueueView SubView(unsigned int offset, unsigned int length) const;
+
+    /**
+     * @brief Remove bytes from the start of the view.
+     *
+     * This doesn't change the underlying IOQueue.
+     */
+    void Advance(unsigned int length);
+
+ private:
+    const IOQueue *m_queue;
+    unsigned int m_block_index;
+    unsigned int m_offset;  // offset into the block's data
+    unsigned int m_size;
+
+    IOQueueView(const IOQueue *queue, unsigned int block_index,
+                unsigned int offset, unsigned int size)
+        : m_queue(queue),
+          m_block_index(block_index),
+          m_offset(offset),
+          m_size(size) {
+    }
+
+    friend class IOQueue;
+};
+
+
 /**
  * IOQueue.
  */
@@ -65,6 +144,39 @@ class IOQueue: public InputBufferInterface,
     const struct IOVec *AsIOVec(int *io_count) const;
     void Pop(unsigned int n);
 
+    /**
+     * @brief Return a view of a range of the data in the queue.
+     * @param offset the offset of the range from the front of the queue.
+     * @param length the length of the range, this is truncated to the data in
+     *   the queue.
+     */
+    IOQueueView View(unsigned int offset, unsigned int length) const;
+
+    /**
+     * @brief Return a view of all the data in the queue.
+     */
+    IOQueueView View() const;
+
+    /**
+     * @brief Reserve space at the end of the queue for data to be written to
+     * directly, e.g. by readv().
+     * @param size the minimum amount of space to reserve.
+     * @param io_count set to the number of IOVecs in the array.
+     * @returns an array of IOVecs describing the free space, which is at least
+     *   size bytes. Use FreeIOVec() to release the array.
+     *
+     * CommitReserved() must be called before any other non-const method.
+     */
+    const struct IOVec *Reserve(unsigned int size, int *io_count);
+
+    /**
+     * @brief Add data written to the space from Reserve() to the queue.
+     * @param length the number of bytes that were written.
+     *
+     * Any unused blocks are returned to the pool.
+     */
+    void CommitReserved(unsigned int length);
+
     // Append a MemoryBlock to this IOQueue. Ownership of the block is taken.
     void AppendBlock(class MemoryBlock *block);
 
@@ -88,11 +200,15 @@ class IOQueue: public InputBufferInterface,
     bool m_delete_pool;
 
     BlockVector m_blocks;
+    // The index of the first block covered by the last call to Reserve().
+    unsigned int m_reserved_index;
 
     void AppendBlock();
 
     // no copying / assignment for now
     DISALLOW_COPY_AND_ASSIGN(IOQueue);
+
+    friend class IOQueueView;
 };
 }  // namespace io
 }  // namespace ola
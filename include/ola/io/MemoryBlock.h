@@ -33,6 +33,58 @@
 namespace ola {
 namespace io {
 
+/**
+ * @class MemorySlab ola/io/MemoryBlock.h
+ * @brief A memory region shared by several MemoryBlocks.
+ *
+ * The slab is reference counted. Each MemoryBlock carved from the slab holds a
+ * reference, and the memory is freed when the last reference is dropped. The
+ * count is updated atomically, so blocks from the same slab may be destroyed
+ * by different threads.
+ */
+class MemorySlab {
+ public:
+    /**
+     * @brief Create a new slab.
+     * @param data the memory region, ownership is transferred.
+     * @param size the size of the memory region.
+     * @param owner the id of the MemoryBlockPool the slab belongs to, or 0.
+     *
+     * The new slab has a single reference, held by the caller.
+     */
+    MemorySlab(uint8_t *data, unsigned int size, unsigned int owner = 0)
+        : m_data(data),
+          m_size(size),
+          m_owner(owner),
+          m_references(1) {
+    }
+
+    uint8_t *Data() const { return m_data; }
+    unsigned int Size() const { return m_size; }
+    unsigned int Owner() const { return m_owner; }
+
+    /**
+     * @brief Add a reference to the slab.
+     */
+    void Ref();
+
+    /**
+     * @brief Drop a reference to the slab, freeing it if it was the last one.
+     */
+    void Unref();
+
+ private:
+    uint8_t* const m_data;
+    const unsigned int m_size;
+    const unsigned int m_owner;
+    unsigned int m_references;
+
+    ~MemorySlab() {
+      delete[] m_data;
+    }
+};
+
+
 /**
  * @class MemoryBlock ola/io/MemoryBlock.h
  * @brief A MemoryBlock encapsulates a chunk of memory. It's used by the
@@ -50,15 +102,37 @@ class MemoryBlock {
         : m_data(data),
           m_data_end(data + size),
           m_capacity(size),
+          m_slab(NULL),
           m_first(data),
           m_last(data) {
     }
 
     /**
-     * @brief Destructor, this frees the memory for the block.
+     * @brief Construct a new MemoryBlock from part of a MemorySlab.
+     * @param slab the slab to use, a reference to the slab is taken.
+     * @param offset the offset of the block within the slab.
+     * @param size the size of the block.
+     */
+    MemoryBlock(MemorySlab *slab, unsigned int offset, unsigned int size)
+        : m_data(slab->Data() + offset),
+          m_data_end(slab->Data() + offset + size),
+          m_capacity(size),
+          m_slab(slab),
+          m_first(m_data),
+          m_last(m_data) {
+      slab->Ref();
+    }
+
+    /**
+     * @brief Destructor, this frees the memory for the block, or drops the
+     * reference to its slab.
      */
     ~MemoryBlock() {
-      delete[] m_data;
+      if (m_slab) {
+        m_slab->Unref();
+      } else {
+        delete[] m_data;
+      }
     }
 
     /**
@@ -76,6 +150,12 @@ class MemoryBlock {
      */
     unsigned int Capacity() const { return m_capacity; }
 
+    /**
+     * @brief The slab this block was carved from.
+     * @returns the slab, or NULL if the block owns its memory.
+     */
+    const MemorySlab *Slab() const { return m_slab; }
+
     /**
      * @brief The free space at the end of the block.
      * @returns the free space at the end of the block.
@@ -121,6 +201,26 @@ class MemoryBlock {
       return bytes_to_write;
     }
 
+    /**
+     * @brief A pointer to the free space at the end of the block.
+     *
+     * Data can be written here directly, for example by readv(), and then
+     * added to the block with Extend().
+     */
+    uint8_t *Tail() const { return m_last; }
+
+    /**
+     * @brief Add data that was written directly into the free space.
+     * @param length the number of bytes written at Tail().
+     * @returns the number of bytes added, which is limited by Remaining().
+     */
+    unsigned int Extend(unsigned int length) {
+      unsigned int bytes_added = std::min(
+          length, static_cast<unsigned int>(m_data_end - m_last));
+      m_last += bytes_added;
+      return bytes_added;
+    }
+
     /**
      * @brief Prepend data to this block.
      * @param data the data to prepend.
@@ -171,6 +271,7 @@ class MemoryBlock {
     uint8_t* const m_data;
     uint8_t* const m_data_end;
     unsigned int m_capacity;
+    MemorySlab* const m_slab;
     // Points to the valid data in the block.
     uint8_t *m_first;
     uint8_t *m_last;  // points to one after last
@@ -21,49 +21,44 @@
 #ifndef INCLUDE_OLA_IO_MEMORYBLOCKPOOL_H_
 #define INCLUDE_OLA_IO_MEMORYBLOCKPOOL_H_
 
-#include <ola/Logging.h>
+#include <ola/base/Macro.h>
 #include <ola/io/MemoryBlock.h>
-#include <queue>
+#include <vector>
 
 namespace ola {
 namespace io {
 
 /**
  * @brief MemoryBlockPool. This class is not thread safe.
- * @param block_size the size of blocks to use.
+ *
+ * Rather than allocating each block separately, the memory for blocks is
+ * allocated in MemorySlabs. The first slab holds a single block, and each slab
+ * after that is as large as all the blocks allocated so far, up to
+ * MAX_SLAB_BLOCKS. This keeps small pools small, and a busy pool makes few
+ * allocations. Released blocks are reused most-recently-released first, since
+ * they're most likely to still be in the cache.
+ *
+ * A slab is freed once all the blocks carved from it have been deleted, so
+ * blocks may outlive the pool, or be released to a different pool, e.g. when
+ * an IOStack is moved to an IOQueue. Each slab records the pool it came from,
+ * so a pool only counts the blocks it allocated.
  */
 class MemoryBlockPool {
  public:
-    explicit MemoryBlockPool(unsigned int block_size = DEFAULT_BLOCK_SIZE)
-        : m_block_size(block_size),
-          m_blocks_allocated(0) {
-    }
-    ~MemoryBlockPool() {
-      Purge();
-    }
+    /**
+     * @brief Create a new pool.
+     * @param block_size the size of blocks to use.
+     */
+    explicit MemoryBlockPool(unsigned int block_size = DEFAULT_BLOCK_SIZE);
+    ~MemoryBlockPool();
 
     // Allocate a new MemoryBlock from the pool. May return NULL if allocation
     // fails.
-    MemoryBlock *Allocate() {
-      if (m_free_blocks.empty()) {
-        uint8_t* data = new uint8_t[m_block_size];
-        OLA_DEBUG << "new block allocated at @" << reinterpret_cast<int*>(data);
-        if (data) {
-          m_blocks_allocated++;
-          return new MemoryBlock(data, m_block_size);
-        } else {
-          return NULL;
-        }
-      } else {
-        MemoryBlock *block = m_free_blocks.front();
-        m_free_blocks.pop();
-        return block;
-      }
-    }
+    MemoryBlock *Allocate();
 
     // Release a MemoryBlock back to the pool.
     void Release(MemoryBlock *block) {
-      m_free_blocks.push(block);
+      m_free_blocks.push_back(block);
     }
 
     // Returns the number of free blocks in the pool.
@@ -76,25 +71,46 @@ class MemoryBlockPool {
       Purge(0);
     }
 
-    // Delete all but remaining free blocks.
-    void Purge(unsigned int remaining) {
-      while (m_free_blocks.size() != remaining) {
-        MemoryBlock *block = m_free_blocks.front();
-        m_blocks_allocated--;
-        delete block;
-        m_free_blocks.pop();
-      }
-    }
+    // Delete all but remaining free blocks. Least recently released blocks are
+    // deleted first.
+    void Purge(unsigned int remaining);
 
+    // Returns the number of blocks allocated from this pool which it hasn't
+    // deleted. Blocks released to, and deleted by, another pool are still
+    // counted.
     unsigned int BlocksAllocated() const { return m_blocks_allocated; }
 
+    unsigned int BlockSize() const { return m_block_size; }
+
+    /**
+     * @brief Return the pool for the calling thread.
+     *
+     * The pool is created on first use, and deleted when the thread exits, so
+     * IOQueues and IOStacks using it must not outlive the thread. Blocks
+     * allocated from it may be passed to other threads.
+     */
+    static MemoryBlockPool *ThreadLocalPool();
+
     // default to 1k blocks
     static const unsigned int DEFAULT_BLOCK_SIZE = 1024;
 
+    // The largest slab, in blocks.
+    static const unsigned int MAX_SLAB_BLOCKS = 64;
+
  private:
-    std::queue<MemoryBlock*> m_free_blocks;
+    std::vector<MemoryBlock*> m_free_blocks;
+    // Unique for each pool, unlike the address which may be reused.
+    const unsigned int m_id;
+    // The slab we're carving blocks from, we hold a reference to it.
+    MemorySlab *m_slab;
+    unsigned int m_slab_offset;
     const unsigned int m_block_size;
     unsigned int m_blocks_allocated;
+
+    bool NewSlab();
+    bool Owns(const MemoryBlock *block) const;
+
+    DISALLOW_COPY_AND_ASSIGN(MemoryBlockPool);
 };
 }  // namespace io
 }  // namespace ola
@@ -28,6 +28,8 @@
 #include <ola/network/TCPConnector.h>
 #include <ola/network/TCPSocketFactory.h>
 #include <ola/util/Backoff.h>
+#include <stdint.h>
+#include <deque>
 #include <map>
 #include <utility>
 
@@ -40,10 +42,14 @@ namespace network {
  * The AdvancedTCPConnector attempts to open connections to a endpoint. If
  * the connection fails it will retry according to a given BackOffPolicy.
  *
+ * When managing a large number of endpoints, use SetMaxPendingConnections()
+ * to limit the number of non-blocking connects in flight at once. Further
+ * attempts are queued and started, in order, as earlier ones complete. Pairing
+ * this with a jittered BackOffPolicy avoids retrying every endpoint at once
+ * after a network outage.
+ *
  * Limitations:
  *  - This class only supports a single connection per IP:Port.
- *  - This class should work fine for a small number of TCP connections (100 or
- *    so). It'll need to be re-written if we want to support 1000s.
  */
 class AdvancedTCPConnector {
  public:
@@ -81,6 +87,13 @@ class AdvancedTCPConnector {
    */
   void RemoveEndpoint(const IPV4SocketAddress &endpoint);
 
+  /**
+   * @brief Limit the number of connection attempts in progress at once.
+   * @param max_pending the maximum number of pending connects, 0 means no
+   *   limit. This is the default.
+   */
+  void SetMaxPendingConnections(unsigned int max_pending);
+
   /**
    * @brief Return the number of connections tracked by this connector.
    */
@@ -97,6 +110,26 @@ class AdvancedTCPConnector {
     CONNECTED,  /**< The socket is connected. */
   };
 
+  /**
+   * @brief Aggregate statistics for all endpoints.
+   */
+  struct ConnectorStats {
+    unsigned int endpoints;  /**< The number of endpoints */
+    unsigned int connected;  /**< Endpoints in the CONNECTED state */
+    unsigned int disconnected;  /**< Endpoints in the DISCONNECTED state */
+    unsigned int paused;  /**< Endpoints in the PAUSED state */
+    unsigned int pending;  /**< Connection attempts in progress */
+    unsigned int queued;  /**< Attempts waiting for a pending slot */
+    uint64_t connect_attempts;  /**< Total connection attempts started */
+    uint64_t connect_failures;  /**< Total connection attempts that failed */
+  };
+
+  /**
+   * @brief Get the aggregate statistics for this connector.
+   * @param[out] stats the ConnectorStats to populate.
+   */
+  void GetStats(ConnectorStats *stats) const;
+
   /**
    * @brief Get the state & number of failed_attempts for an endpoint
    * @param endpoint the IPV4SocketAddress to get the state of.
@@ -130,6 +163,7 @@ class AdvancedTCPConnector {
     TCPConnector::TCPConnectionID connection_id;
     BackOffPolicy *policy;
     bool reconnect;
+    bool queued;
   } ConnectionInfo;
 
   typedef std::pair<IPV4Address, uint16_t> IPPortPair;
@@ -140,11 +174,20 @@ class AdvancedTCPConnector {
   TCPConnector m_connector;
   const ola::TimeInterval m_connection_timeout;
   ConnectionMap m_connections;
+  // Endpoints waiting to connect. Entries for removed endpoints are skipped.
+  std::deque<IPPortPair> m_connect_queue;
+  unsigned int m_max_pending;
+  unsigned int m_pending;
+  bool m_draining_queue;
+  uint64_t m_connect_attempts;
+  uint64_t m_connect_failures;
 
   void ScheduleRetry(const IPPortPair &key, ConnectionInfo *info);
   void RetryTimeout(IPPortPair key);
   void ConnectionResult(IPPortPair key, int fd, int error);
   void AttemptConnection(const IPPortPair &key, ConnectionInfo *state);
+  void StartConnection(const IPPortPair &key, ConnectionInfo *state);
+  void DrainConnectQueue();
   void AbortConnection(ConnectionInfo *state);
 
   DISALLOW_COPY_AND_ASSIGN(AdvancedTCPConnector);
@@ -38,6 +38,9 @@
  *  - Some protocols may want to piggyback heartbeats on other messages, or
  *  even count any message as a heartbeat. When such a message is received, be
  *  sure to call HeartbeatReceived() which will update the timer.
+ *  - Processes with many connections should share a TimerWheel between them.
+ *  Each connection then uses two timers on the wheel, rather than registering
+ *  new timeouts with the scheduler every time a heartbeat is sent or received.
  */
 
 #ifndef INCLUDE_OLA_NETWORK_HEALTHCHECKEDCONNECTION_H_
@@ -47,6 +50,7 @@
 #include <ola/Clock.h>
 #include <ola/base/Macro.h>
 #include <ola/thread/SchedulerInterface.h>
+#include <ola/thread/TimerWheel.h>
 
 namespace ola {
 namespace network {
@@ -62,6 +66,16 @@ class HealthCheckedConnection {
                             const ola::TimeInterval timeout_interval);
     HealthCheckedConnection(ola::thread::SchedulerInterface *scheduler,
                             const ola::TimeInterval heartbeat_interval);
+
+    /**
+     * Create a connection which schedules its heartbeats on a shared
+     * TimerWheel. The wheel must outlive the connection.
+     */
+    HealthCheckedConnection(ola::thread::TimerWheel *timer_wheel,
+                            const ola::TimeInterval heartbeat_interval,
+                            const ola::TimeInterval timeout_interval);
+    HealthCheckedConnection(ola::thread::TimerWheel *timer_wheel,
+                            const ola::TimeInterval heartbeat_interval);
     virtual ~HealthCheckedConnection();
 
     /**
@@ -113,8 +127,14 @@ class HealthCheckedConnection {
     ola::TimeInterval m_timeout_interval;
     ola::thread::timeout_id m_send_timeout_id;
     ola::thread::timeout_id m_receive_timeout_id;
+    // Only used with a TimerWheel.
+    ola::thread::TimerWheel *m_timer_wheel;
+    ola::thread::TimerWheel::Timer *m_send_timer;
+    ola::thread::TimerWheel::Timer *m_receive_timer;
 
+    void CreateTimers();
     bool SendNextHeartbeat();
+    void SendHeartbeatFromWheel();
     void UpdateReceiveTimer();
     void InternalHeartbeatTimeout();
 
@@ -0,0 +1,199 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * InterfaceMonitor.h
+ * Track the network interfaces as they change.
+ * Copyright (C) 2026 agent
+ */
+
+#ifndef INCLUDE_OLA_NETWORK_INTERFACEMONITOR_H_
+#define INCLUDE_OLA_NETWORK_INTERFACEMONITOR_H_
+
+#include <stdint.h>
+#include <ola/base/Macro.h>
+#include <ola/io/ByteString.h>
+#include <ola/io/SelectServerInterface.h>
+#include <ola/network/IPV4Address.h>
+#include <ola/network/Interface.h>
+#include <ola/network/InterfacePicker.h>
+#include <ola/network/MACAddress.h>
+#include <ola/thread/Mutex.h>
+
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace ola {
+namespace network {
+
+class NetlinkSource;
+
+/**
+ * @addtogroup network
+ * @{
+ */
+
+/**
+ * @brief Receives notifications when interfaces change.
+ *
+ * A change to an interface, like a new IP address, is reported as the removal
+ * of the old Interface followed by the addition of the new one.
+ */
+class InterfaceObserver {
+ public:
+  virtual ~InterfaceObserver() {}
+
+  /**
+   * @brief Called when an interface is configured and up.
+   */
+  virtual void InterfaceAdded(const Interface &iface) = 0;
+
+  /**
+   * @brief Called when an interface goes down or loses its address.
+   */
+  virtual void InterfaceRemoved(const Interface &iface) = 0;
+};
+
+
+/**
+ * @brief An InterfacePicker that keeps a live table of interfaces.
+ *
+ * On Linux the table is populated from rtnetlink, and updated as the kernel
+ * reports link and address changes, so looking up an interface doesn't
+ * require rescanning the system. On other platforms, or if netlink isn't
+ * available, the table is a snapshot taken when Init() is called and no
+ * changes are reported.
+ *
+ * GetInterfaces(), AddObserver() and RemoveObserver() may be called from any
+ * thread. Observers are run on the SelectServer thread.
+ */
+class InterfaceMonitor : public InterfacePicker {
+ public:
+  /**
+   * @brief Create a new InterfaceMonitor.
+   * @param ss the SelectServer to use to receive change notifications.
+   */
+  explicit InterfaceMonitor(ola::io::SelectServerInterface *ss);
+
+  /**
+   * @brief Create a new InterfaceMonitor that uses a specific NetlinkSource.
+   * @param ss the SelectServer to use.
+   * @param source the NetlinkSource to use, ownership is transferred.
+   *
+   * This is used for testing.
+   */
+  InterfaceMonitor(ola::io::SelectServerInterface *ss,
+                   NetlinkSource *source);
+
+  ~InterfaceMonitor();
+
+  /**
+   * @brief Populate the interface table and start watching for changes.
+   * @returns true if changes will be tracked, false if the table is a
+   *   snapshot.
+   */
+  bool Init();
+
+  /**
+   * @brief Return the interfaces from the table.
+   */
+  std::vector<Interface> GetInterfaces(bool include_loopback) const;
+
+  /**
+   * @brief Work out where a node bound to an interface should move to.
+   * @param current the interface the node is using.
+   * @param ip_or_name the IP address or interface name the node was
+   *   configured with, may be empty.
+   * @param[out] iface the interface to move to.
+   * @returns true if the node should move to iface, false if it should stay
+   *   where it is.
+   *
+   * Nodes only move if their current address has gone from the link, or if
+   * the configured IP address has appeared on it. Adding a secondary address
+   * to the link doesn't move anyone.
+   */
+  bool FollowInterface(const Interface &current,
+                       const std::string &ip_or_name,
+                       Interface *iface) const;
+
+  /**
+   * @brief Check if changes are being tracked.
+   */
+  bool IsLive() const { return m_live; }
+
+  /**
+   * @brief Add an observer to be notified of interface changes.
+   * @param observer the observer, ownership is not transferred.
+   */
+  void AddObserver(InterfaceObserver *observer);
+
+  /**
+   * @brief Remove an observer.
+   */
+  void RemoveObserver(InterfaceObserver *observer);
+
+ private:
+  struct LinkState {
+    std::string name;
+    MACAddress hw_address;
+    bool up;
+    bool loopback;
+    uint16_t type;
+
+    LinkState() : up(false), loopback(false), type(0) {}
+  };
+
+  struct AddressState {
+    int32_t index;
+    std::string label;
+    IPV4Address ip_address;
+    IPV4Address bcast_address;
+    IPV4Address subnet_mask;
+  };
+
+  typedef std::map<int32_t, LinkState> LinkMap;
+  typedef std::vector<AddressState> AddressList;
+
+  ola::io::SelectServerInterface *m_ss;
+  std::auto_ptr<NetlinkSource> m_source;
+  LinkMap m_links;
+  AddressList m_addresses;
+  bool m_live;
+
+  // protects m_interfaces & m_observers
+  mutable ola::thread::Mutex m_mutex;
+  std::vector<Interface> m_interfaces;
+  std::set<InterfaceObserver*> m_observers;
+
+  bool Dump(uint16_t message_type);
+  void ReceiveMessages();
+  void Resync();
+  bool HandleDatagram(const ola::io::ByteString &datagram);
+  void HandleLinkMessage(uint16_t message_type, const uint8_t *data,
+                         unsigned int length);
+  void HandleAddressMessage(uint16_t message_type, const uint8_t *data,
+                            unsigned int length);
+  void UpdateInterfaces(bool notify);
+
+  DISALLOW_COPY_AND_ASSIGN(InterfaceMonitor);
+};
+/**
+ * @}
+ */
+}  // namespace network
+}  // namespace ola
+#endif  // INCLUDE_OLA_NETWORK_INTERFACEMONITOR_H_
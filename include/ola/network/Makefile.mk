@@ -5,6 +5,7 @@ olanetworkinclude_HEADERS = \
     include/ola/network/IPV4Address.h \
     include/ola/network/IPV6Address.h \
     include/ola/network/Interface.h \
+    include/ola/network/InterfaceMonitor.h \
     include/ola/network/InterfacePicker.h \
     include/ola/network/MACAddress.h \
     include/ola/network/NetworkUtils.h \
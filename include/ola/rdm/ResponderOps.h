@@ -33,7 +33,7 @@
 #include <ola/rdm/RDMControllerInterface.h>
 #include <ola/rdm/RDMResponseCodes.h>
 
-#include <map>
+#include <vector>
 
 namespace ola {
 namespace rdm {
@@ -106,15 +106,30 @@ class ResponderOps {
 
  private:
     struct InternalParamHandler {
+      uint16_t pid;
       RDMHandler get_handler;
       RDMHandler set_handler;
     };
-    typedef std::map<uint16_t, InternalParamHandler> RDMHandlers;
+    typedef std::vector<InternalParamHandler> RDMHandlers;
 
     bool m_include_required_pids;
+    // Sorted by PID, so handlers can be found with a binary search.
     RDMHandlers m_handlers;
+    // The SUPPORTED_PARAMETERS data never changes, so it's built once, in
+    // network byte order.
+    std::vector<uint16_t> m_supported_params;
 
+    const InternalParamHandler *FindHandler(uint16_t pid) const;
     RDMResponse *HandleSupportedParams(const RDMRequest *request);
+
+    static bool HandlerLessThan(const InternalParamHandler &a,
+                                const InternalParamHandler &b) {
+      return a.pid < b.pid;
+    }
+    static bool PIDLessThan(const InternalParamHandler &handler,
+                            uint16_t pid) {
+      return handler.pid < pid;
+    }
 };
 
 }  // namespace rdm
@@ -37,7 +37,6 @@
 #include <ola/stl/STLUtils.h>
 
 #include <algorithm>
-#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -50,18 +49,48 @@ ResponderOps<Target>::ResponderOps(const ParamHandler param_handlers[],
                                    bool include_required_pids)
     : m_include_required_pids(include_required_pids) {
   // We install placeholders for any pids which are handled internally.
-  struct InternalParamHandler placeholder = {NULL, NULL};
-  STLReplace(&m_handlers, PID_SUPPORTED_PARAMETERS, placeholder);
+  struct InternalParamHandler placeholder = {
+    PID_SUPPORTED_PARAMETERS, NULL, NULL
+  };
+  RDMHandlers handlers;
+  handlers.push_back(placeholder);
 
   const ParamHandler *handler = param_handlers;
   while (handler->pid && (handler->get_handler || handler->set_handler)) {
     struct InternalParamHandler pid_handler = {
+      handler->pid,
       handler->get_handler,
       handler->set_handler
     };
-    STLReplace(&m_handlers, handler->pid, pid_handler);
+    handlers.push_back(pid_handler);
     handler++;
   }
+
+  // If a PID is registered more than once, the last handler wins.
+  std::stable_sort(handlers.begin(), handlers.end(), HandlerLessThan);
+  m_handlers.reserve(handlers.size());
+  typename RDMHandlers::const_iterator iter = handlers.begin();
+  for (; iter != handlers.end(); ++iter) {
+    if (!m_handlers.empty() && m_handlers.back().pid == iter->pid) {
+      m_handlers.back() = *iter;
+    } else {
+      m_handlers.push_back(*iter);
+    }
+  }
+
+  for (iter = m_handlers.begin(); iter != m_handlers.end(); ++iter) {
+    uint16_t pid = iter->pid;
+    // some pids never appear in supported_parameters.
+    if (m_include_required_pids || (
+        pid != PID_SUPPORTED_PARAMETERS &&
+        pid != PID_PARAMETER_DESCRIPTION &&
+        pid != PID_DEVICE_INFO &&
+        pid != PID_SOFTWARE_VERSION_LABEL &&
+        pid != PID_DMX_START_ADDRESS &&
+        pid != PID_IDENTIFY_DEVICE)) {
+      m_supported_params.push_back(ola::network::HostToNetwork(pid));
+    }
+  }
 }
 
 template <class Target>
@@ -136,7 +165,7 @@ void ResponderOps<Target>::HandleRDMRequest(Target *target,
     return;
   }
 
-  InternalParamHandler *handler = STLFind(&m_handlers, request->ParamId());
+  const InternalParamHandler *handler = FindHandler(request->ParamId());
   if (!handler) {
     if (request->DestinationUID().IsBroadcast()) {
       RunRDMCallback(on_complete, RDM_WAS_BROADCAST);
@@ -185,39 +214,30 @@ void ResponderOps<Target>::HandleRDMRequest(Target *target,
   }
 }
 
+template <class Target>
+const typename ResponderOps<Target>::InternalParamHandler *
+    ResponderOps<Target>::FindHandler(uint16_t pid) const {
+  typename RDMHandlers::const_iterator iter = std::lower_bound(
+      m_handlers.begin(), m_handlers.end(), pid, PIDLessThan);
+  if (iter == m_handlers.end() || iter->pid != pid) {
+    return NULL;
+  }
+  return &(*iter);
+}
+
 template <class Target>
 RDMResponse *ResponderOps<Target>::HandleSupportedParams(
     const RDMRequest *request) {
   if (request->ParamDataSize())
     return NackWithReason(request, NR_FORMAT_ERROR);
 
-  std::vector<uint16_t> params;
-  params.reserve(m_handlers.size());
-  typename RDMHandlers::const_iterator iter = m_handlers.begin();
-  for (; iter != m_handlers.end(); ++iter) {
-    uint16_t pid = iter->first;
-    // some pids never appear in supported_parameters.
-    if (m_include_required_pids || (
-        pid != PID_SUPPORTED_PARAMETERS &&
-        pid != PID_PARAMETER_DESCRIPTION &&
-        pid != PID_DEVICE_INFO &&
-        pid != PID_SOFTWARE_VERSION_LABEL &&
-        pid != PID_DMX_START_ADDRESS &&
-        pid != PID_IDENTIFY_DEVICE)) {
-      params.push_back(iter->first);
-    }
+  if (m_supported_params.empty()) {
+    return GetResponseFromData(request, NULL, 0);
   }
-  sort(params.begin(), params.end());
-
-  std::vector<uint16_t>::iterator param_iter = params.begin();
-  for (; param_iter != params.end(); ++param_iter) {
-    *param_iter = ola::network::HostToNetwork(*param_iter);
-  }
-
   return GetResponseFromData(
       request,
-      reinterpret_cast<uint8_t*>(&params[0]),
-      params.size() * sizeof(uint16_t));
+      reinterpret_cast<const uint8_t*>(&m_supported_params[0]),
+      m_supported_params.size() * sizeof(uint16_t));
 }
 }  // namespace rdm
 }  // namespace ola
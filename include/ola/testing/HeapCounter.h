@@ -0,0 +1,67 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * HeapCounter.h
+ * Count the heap usage of a program.
+ * Copyright (C) 2026 agent
+ */
+
+#ifndef INCLUDE_OLA_TESTING_HEAPCOUNTER_H_
+#define INCLUDE_OLA_TESTING_HEAPCOUNTER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace ola {
+namespace testing {
+
+/*
+ * Linking against libolaheapcounter replaces the global operator new & delete,
+ * including the array and nothrow forms, with versions that count the memory
+ * allocated. This is used by the benchmarks to report the memory each method
+ * uses, e.g.
+ *
+ *   HeapStats start = GetHeapStats();
+ *   ResetHeapPeak();
+ *   ... code to measure
+ *   HeapStats end = GetHeapStats();
+ *   // end.allocations - start.allocations is the number of allocations.
+ *   // end.peak - start.current is the peak memory used.
+ *
+ * Don't link this into anything that's installed.
+ */
+
+/**
+ * @brief The heap usage so far.
+ */
+struct HeapStats {
+  size_t current;  /**< The bytes currently allocated */
+  size_t peak;  /**< The most bytes allocated at once */
+  uint64_t allocations;  /**< The number of allocations */
+  uint64_t bytes;  /**< The total bytes allocated */
+};
+
+/**
+ * @brief Return the heap usage so far.
+ */
+HeapStats GetHeapStats();
+
+/**
+ * @brief Reset the peak usage to the current usage.
+ */
+void ResetHeapPeak();
+}  // namespace testing
+}  // namespace ola
+#endif  // INCLUDE_OLA_TESTING_HEAPCOUNTER_H_
@@ -13,4 +13,6 @@ olathreadinclude_HEADERS = \
     include/ola/thread/SignalThread.h \
     include/ola/thread/Thread.h \
     include/ola/thread/ThreadPool.h \
+    include/ola/thread/TimerWheel.h \
+    include/ola/thread/TripleBuffer.h \
     include/ola/thread/Utils.h
@@ -42,7 +42,13 @@ class Mutex {
  public:
     friend class ConditionVariable;
 
+    enum MutexType {
+      NORMAL,  /**< A Mutex that deadlocks if locked twice by a thread */
+      RECURSIVE  /**< A Mutex that can be re-locked by the owning thread */
+    };
+
     Mutex();
+    explicit Mutex(MutexType type);
     ~Mutex();
 
     void Lock();
@@ -0,0 +1,140 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * TimerWheel.h
+ * Schedule many coarse timers with a single timeout.
+ * Copyright (C) 2026 agent
+ */
+
+#ifndef INCLUDE_OLA_THREAD_TIMERWHEEL_H_
+#define INCLUDE_OLA_THREAD_TIMERWHEEL_H_
+
+#include <stdint.h>
+#include <ola/Callback.h>
+#include <ola/Clock.h>
+#include <ola/base/Macro.h>
+#include <ola/thread/SchedulerInterface.h>
+
+namespace ola {
+namespace thread {
+
+/**
+ * @brief A hashed timer wheel.
+ *
+ * The wheel registers a single repeating timeout with the scheduler, which
+ * fires once per tick while any timers are active. Timers are placed in one
+ * of the wheel's slots by their expiry tick, so scheduling, re-scheduling and
+ * cancelling a timer are constant time and don't allocate memory.
+ *
+ * This suits large numbers of timers which are usually re-scheduled before
+ * they expire, such as heartbeat timers. Timers fire up to two ticks after the
+ * requested delay, but never before it.
+ *
+ * Timers are owned by the caller and can be scheduled any number of times.
+ */
+class TimerWheel {
+ public:
+  /**
+   * @brief A timer which can be scheduled on a TimerWheel.
+   */
+  class Timer {
+   public:
+    /**
+     * @brief Create a new timer.
+     * @param callback the callback to run when the timer expires, ownership is
+     *   transferred.
+     */
+    explicit Timer(Callback0<void> *callback);
+
+    /**
+     * @brief Destructor, this cancels the timer if it's scheduled.
+     */
+    ~Timer();
+
+    /**
+     * @brief Check if the timer is scheduled.
+     */
+    bool Scheduled() const { return m_wheel != NULL; }
+
+   private:
+    Callback0<void> *m_callback;
+    TimerWheel *m_wheel;  // the wheel we're scheduled on, or NULL
+    uint64_t m_expiry;  // the tick we expire on
+    Timer *m_previous;
+    Timer *m_next;
+
+    Timer();
+    void Unlink();
+
+    friend class TimerWheel;
+
+    DISALLOW_COPY_AND_ASSIGN(Timer);
+  };
+
+  /**
+   * @brief Create a new TimerWheel.
+   * @param scheduler the scheduler to use for the tick timeout.
+   * @param tick the resolution of the wheel.
+   * @param slot_count the number of slots in the wheel. Timers more than
+   *   slot_count ticks away are revisited once per revolution.
+   */
+  TimerWheel(SchedulerInterface *scheduler,
+             const TimeInterval &tick,
+             unsigned int slot_count = DEFAULT_SLOT_COUNT);
+  ~TimerWheel();
+
+  /**
+   * @brief Schedule a timer.
+   * @param timer the timer to schedule. If it's already scheduled, on this or
+   *   any other wheel, it's moved to the new expiry time.
+   * @param delay the minimum delay before the timer expires.
+   */
+  void Schedule(Timer *timer, const TimeInterval &delay);
+
+  /**
+   * @brief Cancel a timer. This does nothing if the timer isn't scheduled.
+   */
+  void Cancel(Timer *timer);
+
+  /**
+   * @brief The number of scheduled timers.
+   */
+  unsigned int Size() const { return m_size; }
+
+  /**
+   * @brief The resolution of the wheel.
+   */
+  const TimeInterval &TickInterval() const { return m_tick; }
+
+  static const unsigned int DEFAULT_SLOT_COUNT = 512;
+
+ private:
+  SchedulerInterface *m_scheduler;
+  const TimeInterval m_tick;
+  const unsigned int m_slot_count;
+  // Each slot is a circular list, with a sentinel at the head.
+  Timer *m_slots;
+  uint64_t m_current_tick;
+  unsigned int m_size;
+  timeout_id m_tick_timeout;
+
+  bool AdvanceTick();
+  void Insert(Timer *timer);
+
+  DISALLOW_COPY_AND_ASSIGN(TimerWheel);
+};
+}  // namespace thread
+}  // namespace ola
+#endif  // INCLUDE_OLA_THREAD_TIMERWHEEL_H_
@@ -0,0 +1,158 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * TripleBuffer.h
+ * Pass the latest value from one thread to another without locking.
+ * Copyright (C) 2026 agent
+ */
+
+#ifndef INCLUDE_OLA_THREAD_TRIPLEBUFFER_H_
+#define INCLUDE_OLA_THREAD_TRIPLEBUFFER_H_
+
+#include <stdint.h>
+#include <ola/base/Macro.h>
+
+namespace ola {
+namespace thread {
+
+/**
+ * @brief Tracks which of three slots is owned by the writer, the reader and
+ *   which is waiting to be picked up.
+ *
+ * This is the non-template part of TripleBuffer, you probably want to use
+ * that instead.
+ */
+class TripleBufferIndex {
+ public:
+  TripleBufferIndex();
+
+  /**
+   * @brief The slot the writer owns.
+   */
+  unsigned int Back() const { return m_back; }
+
+  /**
+   * @brief The slot the reader owns.
+   */
+  unsigned int Front() const { return m_front; }
+
+  /**
+   * @brief Hand the back slot to the reader. Only call this from the writer.
+   * @returns true if this replaced a value the reader never picked up.
+   */
+  bool Publish();
+
+  /**
+   * @brief Check if there is a new value for the reader.
+   */
+  bool HasUpdate() const;
+
+  /**
+   * @brief Take the newest value. Only call this from the reader.
+   * @returns true if the front slot changed, false if there was nothing new.
+   */
+  bool Update();
+
+  /**
+   * @brief The sequence number of the value in the front slot. The first
+   *   value published is 1, 0 means nothing has been read yet.
+   */
+  uint64_t FrontSequence() const { return m_sequence[m_front]; }
+
+ private:
+  unsigned int m_front;
+  unsigned int m_back;
+  // The slot in the middle, with FRESH set if the writer has published to it
+  // since the reader last took it.
+  uint32_t m_middle;
+  uint64_t m_next_sequence;
+  uint64_t m_sequence[3];
+
+  static const uint32_t INDEX_MASK = 0x3;
+  static const uint32_t FRESH = 0x4;
+
+  DISALLOW_COPY_AND_ASSIGN(TripleBufferIndex);
+};
+
+
+/**
+ * @brief Passes the latest value from a single writer thread to a single
+ *   reader thread.
+ *
+ * Neither side ever blocks. The writer fills in WriteBuffer() and calls
+ * Publish(). The reader calls Update() and then uses ReadBuffer(), which
+ * stays valid until the next call to Update(). If the writer publishes more
+ * than once between Update() calls, the reader only sees the newest value.
+ *
+ * Each slot is reused, so WriteBuffer() holds an old value which must be
+ * overwritten, and T should copy its data rather than share it.
+ *
+ * @code
+ *   TripleBuffer<DmxBuffer> frames;
+ *   // writer thread
+ *   frames.WriteBuffer()->Set(buffer);
+ *   frames.Publish();
+ *   // reader thread
+ *   frames.Update();
+ *   Send(frames.ReadBuffer());
+ * @endcode
+ */
+template <typename T>
+class TripleBuffer {
+ public:
+  TripleBuffer() {}
+
+  /**
+   * @brief The slot for the writer to fill in.
+   */
+  T *WriteBuffer() { return &m_slots[m_index.Back()]; }
+
+  /**
+   * @brief Make the contents of WriteBuffer() available to the reader.
+   * @returns true if this replaced a value the reader never picked up.
+   */
+  bool Publish() { return m_index.Publish(); }
+
+  /**
+   * @brief Check if a value has been published since the last Update().
+   */
+  bool HasUpdate() const { return m_index.HasUpdate(); }
+
+  /**
+   * @brief Take the newest value, if there is one.
+   * @returns true if ReadBuffer() changed.
+   */
+  bool Update() { return m_index.Update(); }
+
+  /**
+   * @brief The value the reader is using.
+   */
+  const T &ReadBuffer() const { return m_slots[m_index.Front()]; }
+
+  /**
+   * @brief The sequence number of ReadBuffer(). A jump of more than one
+   *   between calls to Update() means values were skipped.
+   */
+  uint64_t Sequence() const { return m_index.FrontSequence(); }
+
+ private:
+  TripleBufferIndex m_index;
+  T m_slots[3];
+
+  DISALLOW_COPY_AND_ASSIGN(TripleBuffer);
+};
+}  // namespace thread
+}  // namespace ola
+#endif  // INCLUDE_OLA_THREAD_TRIPLEBUFFER_H_
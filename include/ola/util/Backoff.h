@@ -22,6 +22,7 @@
 
 #include <math.h>
 #include <ola/Clock.h>
+#include <ola/math/Random.h>
 #include <memory>
 
 namespace ola {
@@ -117,7 +118,44 @@ class ExponentialBackoffPolicy: public BackOffPolicy {
 };
 
 
-// TODO(simon): add an ExponentialJitterBackoffPolicy
+/**
+ * An exponential backoff policy with jitter. The exponential interval is
+ * calculated as for ExponentialBackoffPolicy, and then a random time between
+ * half and all of that interval is chosen. This prevents a large number of
+ * clients that failed at the same time from all retrying in lock step.
+ *
+ * For an initial value of 1 and a max of 20 we'd produce something like:
+ *  0, 0.7, 1.2, 3.5, 4.9, 13.2, 18.1, 11.6, ...
+ *
+ * ola::math::InitRandom() should be called before using this policy.
+ */
+class ExponentialJitterBackoffPolicy: public BackOffPolicy {
+ public:
+    ExponentialJitterBackoffPolicy(const TimeInterval &initial,
+                                   const TimeInterval &max)
+        : m_initial(initial),
+          m_max(max) {
+    }
+
+    TimeInterval BackOffTime(unsigned int failed_attempts) const {
+      if (failed_attempts == 0)
+        return TimeInterval(0, 0);
+
+      TimeInterval interval = m_initial;
+      for (unsigned int i = 1; i < failed_attempts && interval < m_max; i++)
+        interval = interval * 2;
+      if (interval > m_max)
+        interval = m_max;
+
+      int upper = static_cast<int>(interval.InMilliSeconds());
+      int64_t msec = ola::math::Random(upper / 2, upper);
+      return TimeInterval(msec * ONE_THOUSAND);
+    }
+
+ private:
+    const TimeInterval m_initial;
+    const TimeInterval m_max;
+};
 
 // Generates backoff times.
 class BackoffGenerator {
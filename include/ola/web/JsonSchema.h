@@ -48,7 +48,46 @@ namespace web {
  * @{
  */
 
+class AllOfValidator;
+class AnyOfValidator;
+class ArrayValidator;
+class BoolValidator;
+class IntegerValidator;
+class NotValidator;
+class NullValidator;
+class NumberValidator;
+class ObjectValidator;
+class OneOfValidator;
+class ReferenceValidator;
+class SchemaCompiler;
 class SchemaDefinitions;
+class StringValidator;
+class WildcardValidator;
+
+/**
+ * @brief The interface for visitors of a tree of validators.
+ *
+ * This is used by the SchemaCompiler to turn a schema into a form that can
+ * be run against a stream of parser events.
+ */
+class ValidatorVisitorInterface {
+ public:
+  virtual ~ValidatorVisitorInterface() {}
+
+  virtual void Visit(WildcardValidator *validator) = 0;
+  virtual void Visit(ReferenceValidator *validator) = 0;
+  virtual void Visit(StringValidator *validator) = 0;
+  virtual void Visit(BoolValidator *validator) = 0;
+  virtual void Visit(NullValidator *validator) = 0;
+  virtual void Visit(IntegerValidator *validator) = 0;
+  virtual void Visit(NumberValidator *validator) = 0;
+  virtual void Visit(ObjectValidator *validator) = 0;
+  virtual void Visit(ArrayValidator *validator) = 0;
+  virtual void Visit(AllOfValidator *validator) = 0;
+  virtual void Visit(AnyOfValidator *validator) = 0;
+  virtual void Visit(OneOfValidator *validator) = 0;
+  virtual void Visit(NotValidator *validator) = 0;
+};
 
 /**
  * @brief The interface Json Schema Validators.
@@ -112,6 +151,16 @@ class ValidatorInterface : public JsonValueConstVisitorInterface {
    * lifetime of the validator.
    */
   virtual const JsonValue *GetDefaultValue() const = 0;
+
+  /**
+   * @brief Accept a ValidatorVisitorInterface.
+   *
+   * Validators that don't override this are not visited, the
+   * SchemaCompiler treats them as opaque.
+   */
+  virtual void Accept(ValidatorVisitorInterface *visitor) {
+    (void) visitor;
+  }
 };
 
 /**
@@ -230,6 +279,8 @@ class BaseValidator : public ValidatorInterface {
   virtual void ExtendSchema(JsonObject *schema) const {
     (void) schema;
   }
+
+  friend class SchemaCompiler;
 };
 
 /**
@@ -241,6 +292,8 @@ class WildcardValidator : public BaseValidator {
   WildcardValidator() : BaseValidator(JSON_UNDEFINED) {}
 
   bool IsValid() const { return true; }
+
+  void Accept(ValidatorVisitorInterface *visitor) { visitor->Visit(this); }
 };
 
 /**
@@ -279,6 +332,8 @@ class ReferenceValidator : public ValidatorInterface {
   void SetDefaultValue(const JsonValue *value);
   const JsonValue *GetDefaultValue() const;
 
+  void Accept(ValidatorVisitorInterface *visitor) { visitor->Visit(this); }
+
  private:
   const SchemaDefinitions *m_definitions;
   const std::string m_schema;
@@ -286,6 +341,8 @@ class ReferenceValidator : public ValidatorInterface {
 
   template <typename T>
   void Validate(const T &value);
+
+  friend class SchemaCompiler;
 };
 
 /**
@@ -313,11 +370,15 @@ class StringValidator : public BaseValidator {
 
   void Visit(const JsonString &str);
 
+  void Accept(ValidatorVisitorInterface *visitor) { visitor->Visit(this); }
+
  private:
   const Options m_options;
 
   void ExtendSchema(JsonObject *schema) const;
 
+  friend class SchemaCompiler;
+
   DISALLOW_COPY_AND_ASSIGN(StringValidator);
 };
 
@@ -330,6 +391,8 @@ class BoolValidator : public BaseValidator {
 
   void Visit(const JsonBool &value) { m_is_valid = CheckEnums(value); }
 
+  void Accept(ValidatorVisitorInterface *visitor) { visitor->Visit(this); }
+
  private:
   DISALLOW_COPY_AND_ASSIGN(BoolValidator);
 };
@@ -343,6 +406,8 @@ class NullValidator : public BaseValidator {
 
   void Visit(const JsonNull &value) { m_is_valid = CheckEnums(value); }
 
+  void Accept(ValidatorVisitorInterface *visitor) { visitor->Visit(this); }
+
  private:
   DISALLOW_COPY_AND_ASSIGN(NullValidator);
 };
@@ -487,6 +552,10 @@ class IntegerValidator : public BaseValidator {
   void Visit(const JsonInt64&);
   virtual void Visit(const JsonDouble&);
 
+  virtual void Accept(ValidatorVisitorInterface *visitor) {
+    visitor->Visit(this);
+  }
+
  protected:
   explicit IntegerValidator(JsonType type) : BaseValidator(type) {}
 
@@ -512,6 +581,8 @@ class NumberValidator : public IntegerValidator {
 
   void Visit(const JsonDouble&);
 
+  void Accept(ValidatorVisitorInterface *visitor) { visitor->Visit(this); }
+
  private:
   DISALLOW_COPY_AND_ASSIGN(NumberValidator);
 };
@@ -597,6 +668,8 @@ class ObjectValidator : public BaseValidator, JsonObjectPropertyVisitor {
 
   void VisitProperty(const std::string &property, const JsonValue &value);
 
+  void Accept(ValidatorVisitorInterface *visitor) { visitor->Visit(this); }
+
  private:
   typedef std::set<std::string> StringSet;
   typedef std::map<std::string, ValidatorInterface*> PropertyValidators;
@@ -614,6 +687,8 @@ class ObjectValidator : public BaseValidator, JsonObjectPropertyVisitor {
 
   void ExtendSchema(JsonObject *schema) const;
 
+  friend class SchemaCompiler;
+
   DISALLOW_COPY_AND_ASSIGN(ObjectValidator);
 };
 
@@ -702,6 +777,8 @@ class ArrayValidator : public BaseValidator {
 
   void Visit(const JsonArray &array);
 
+  void Accept(ValidatorVisitorInterface *visitor) { visitor->Visit(this); }
+
  private:
   typedef std::deque<ValidatorInterface*> ValidatorQueue;
 
@@ -742,6 +819,8 @@ class ArrayValidator : public BaseValidator {
   void ExtendSchema(JsonObject *schema) const;
   ArrayElementValidator* ConstructElementValidator() const;
 
+  friend class SchemaCompiler;
+
   DISALLOW_COPY_AND_ASSIGN(ArrayValidator);
 };
 
@@ -812,6 +891,8 @@ class ConjunctionValidator : public BaseValidator {
   void ExtendSchema(JsonObject *schema) const;
 
   virtual void Validate(const JsonValue &value) = 0;
+
+  friend class SchemaCompiler;
 };
 
 /**
@@ -828,6 +909,8 @@ class AllOfValidator : public ConjunctionValidator {
       : ConjunctionValidator("allOf", validators) {
   }
 
+  void Accept(ValidatorVisitorInterface *visitor) { visitor->Visit(this); }
+
  protected:
   void Validate(const JsonValue &value);
 
@@ -850,6 +933,8 @@ class AnyOfValidator : public ConjunctionValidator {
       : ConjunctionValidator("anyOf", validators) {
   }
 
+  void Accept(ValidatorVisitorInterface *visitor) { visitor->Visit(this); }
+
  protected:
   void Validate(const JsonValue &value);
 
@@ -872,6 +957,8 @@ class OneOfValidator : public ConjunctionValidator {
       : ConjunctionValidator("oneOf", validators) {
   }
 
+  void Accept(ValidatorVisitorInterface *visitor) { visitor->Visit(this); }
+
  protected:
   void Validate(const JsonValue &value);
 
@@ -933,6 +1020,8 @@ class NotValidator : public BaseValidator {
     Validate(value);
   }
 
+  void Accept(ValidatorVisitorInterface *visitor) { visitor->Visit(this); }
+
  private:
   std::auto_ptr<ValidatorInterface> m_validator;
 
@@ -940,6 +1029,8 @@ class NotValidator : public BaseValidator {
 
   void ExtendSchema(JsonObject *schema) const;
 
+  friend class SchemaCompiler;
+
   DISALLOW_COPY_AND_ASSIGN(NotValidator);
 };
 
@@ -1002,6 +1093,8 @@ class JsonSchema {
              ValidatorInterface *root_validator,
              SchemaDefinitions *schema_defs);
 
+  friend class SchemaCompiler;
+
   DISALLOW_COPY_AND_ASSIGN(JsonSchema);
 };
 
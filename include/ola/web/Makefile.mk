@@ -11,4 +11,5 @@ olawebinclude_HEADERS = \
     include/ola/web/JsonSections.h \
     include/ola/web/JsonTypes.h \
     include/ola/web/JsonWriter.h \
-    include/ola/web/OptionalItem.h
+    include/ola/web/OptionalItem.h \
+    include/ola/web/StreamingSchemaValidator.h
@@ -0,0 +1,132 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * StreamingSchemaValidator.h
+ * Validate JSON against a schema as it's parsed.
+ * Copyright (C) 2026 agent
+ */
+
+/**
+ * @addtogroup json
+ * @{
+ * @file StreamingSchemaValidator.h
+ * @brief A JsonParserInterface that validates against a JsonSchema.
+ * @}
+ */
+
+#ifndef INCLUDE_OLA_WEB_STREAMINGSCHEMAVALIDATOR_H_
+#define INCLUDE_OLA_WEB_STREAMINGSCHEMAVALIDATOR_H_
+
+#include <ola/base/Macro.h>
+#include <ola/web/JsonLexer.h>
+#include <ola/web/JsonSchema.h>
+#include <memory>
+#include <string>
+
+namespace ola {
+namespace web {
+
+class CompiledSchema;
+class CompiledSchemaNode;
+class ValueMatcher;
+
+/**
+ * @addtogroup json
+ * @{
+ */
+
+/**
+ * @brief Validates the events from a JsonLexer against a JsonSchema.
+ *
+ * JsonSchema::IsValid() requires the entire document to be parsed into a tree
+ * of JsonValues first. The StreamingSchemaValidator compiles the schema once,
+ * and then checks each value as the lexer produces it, so only the state for
+ * the containers that are currently open is held in memory.
+ *
+ * The results are the same as JsonSchema::IsValid(), with two exceptions
+ * where a value is still collected into a JsonValue first: arrays with
+ * uniqueItems set, and validators that aren't part of this library.
+ *
+ * @examplepara
+ * @code
+ *   StreamingSchemaValidator validator(schema);
+ *   bool ok = validator.Validate(input);
+ * @endcode
+ */
+class StreamingSchemaValidator : public JsonParserInterface {
+ public:
+  /**
+   * @brief Create a new StreamingSchemaValidator.
+   * @param schema the JsonSchema to validate against. Ownership is not
+   *   transferred, and the schema must outlive the validator.
+   */
+  explicit StreamingSchemaValidator(JsonSchema *schema);
+  ~StreamingSchemaValidator();
+
+  void Begin();
+  void End();
+
+  void String(const std::string &value);
+  void Number(uint32_t value);
+  void Number(int32_t value);
+  void Number(uint64_t value);
+  void Number(int64_t value);
+  void Number(const JsonDouble::DoubleRepresentation &rep);
+  void Number(double value);
+  void Bool(bool value);
+  void Null();
+  void OpenArray();
+  void CloseArray();
+  void OpenObject();
+  void ObjectKey(const std::string &key);
+  void CloseObject();
+
+  void SetError(const std::string &error);
+
+  /**
+   * @brief Parse and validate a JSON document.
+   * @param input the JSON text.
+   * @returns true if the text was valid JSON and matched the schema.
+   */
+  bool Validate(const std::string &input);
+
+  /**
+   * @brief Check if the last document matched the schema.
+   * @returns true if a complete value was parsed and it matched the schema,
+   *   false otherwise.
+   */
+  bool IsValid() const;
+
+  /**
+   * @brief Return the parse error for the last document, if any.
+   */
+  std::string GetError() const { return m_error; }
+
+ private:
+  std::auto_ptr<CompiledSchema> m_schema;
+  std::auto_ptr<ValueMatcher> m_matcher;
+  std::string m_error;
+  bool m_complete;
+  bool m_is_valid;
+
+  void ScalarValue(const JsonValue &value);
+  void MatcherUpdated();
+
+  DISALLOW_COPY_AND_ASSIGN(StreamingSchemaValidator);
+};
+/**@}*/
+}  // namespace web
+}  // namespace ola
+#endif  // INCLUDE_OLA_WEB_STREAMINGSCHEMAVALIDATOR_H_
@@ -81,6 +81,21 @@ class AbstractDevice {
   /** @brief Lookup a particular OutputPort in this Device */
   virtual OutputPort *GetOutputPort(unsigned int port_id) const = 0;
 
+  /**
+   * @brief Check if this Device wants CommitFrame() to be called.
+   * @note This is checked once, when the Device is registered.
+   */
+  virtual bool SupportsFrameCommit() const = 0;
+
+  /**
+   * @brief Called at the end of each iteration of the event loop in which
+   * DMX data was written to output ports.
+   *
+   * Devices with many output ports can hold on to the data passed to
+   * OutputPort::WriteDMX() and send all of it here.
+   */
+  virtual void CommitFrame() = 0;
+
   /** @brief Configure this Device */
   virtual void Configure(ola::rpc::RpcController *controller,
                          const std::string &request,
@@ -120,6 +135,8 @@ class Device: public AbstractDevice {
   // sane defaults
   bool AllowLooping() const { return false; }
   bool AllowMultiPortPatching() const { return false; }
+  bool SupportsFrameCommit() const { return false; }
+  void CommitFrame() {}
 
   bool AddPort(InputPort *port);
   bool AddPort(OutputPort *port);
@@ -123,12 +123,15 @@ class DmxSource {
      */
     uint8_t Priority() const { return m_priority; }
 
+    /*
+     * A source is inactive if it hasn't sent data for this long.
+     */
+    static const TimeInterval TIMEOUT_INTERVAL;
+
  private:
     DmxBuffer m_buffer;
     TimeStamp m_timestamp;
     uint8_t m_priority;
-
-    static const TimeInterval TIMEOUT_INTERVAL;
 };
 }  // namespace ola
 #endif  // INCLUDE_OLAD_DMXSOURCE_H_
@@ -102,6 +102,17 @@ class AbstractPlugin {
 
   virtual void ConflictsWith(std::set<ola_plugin_id> *conflict_set) const = 0;
 
+  /**
+   * @brief Check if this plugin can be started on a startup thread.
+   *
+   * Plugins that return true are started concurrently with other plugins by
+   * the PluginManager. During Start() they must only interact with olad
+   * through the PluginAdaptor.
+   * @return true if Start() may be called from a thread other than the main
+   *   thread.
+   */
+  virtual bool SupportsConcurrentStart() const = 0;
+
   // used to sort plugins
   virtual bool operator<(const AbstractPlugin &other) const = 0;
 };
@@ -145,6 +156,9 @@ class Plugin: public AbstractPlugin {
   // by default we don't conflict with any other plugins
   virtual void ConflictsWith(std::set<ola_plugin_id>*) const {}
 
+  // by default plugins are started from the main thread
+  virtual bool SupportsConcurrentStart() const { return false; }
+
   bool operator<(const AbstractPlugin &other) const {
     return Id() < other.Id();
   }
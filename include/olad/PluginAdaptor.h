@@ -32,13 +32,24 @@
 #include <ola/ExportMap.h>
 #include <ola/base/Macro.h>
 #include <ola/io/SelectServerInterface.h>
+#include <ola/network/InterfaceMonitor.h>
 #include <ola/rdm/UID.h>
+#include <ola/thread/Mutex.h>
 #include <olad/OlaServer.h>
 
 #include <string>
 
 namespace ola {
 
+/**
+ * @brief The interface between plugins and the rest of olad.
+ *
+ * Plugins may be started from the PluginManager's startup threads, so every
+ * method that touches the SelectServer, DeviceManager or PreferencesFactory is
+ * serialized by an internal lock. Execute() is thread safe by itself and
+ * doesn't take the lock, so plugin-owned threads can always post work to the
+ * main loop.
+ */
 class PluginAdaptor: public ola::io::SelectServerInterface {
  public:
   /**
@@ -50,6 +61,7 @@ class PluginAdaptor: public ola::io::SelectServerInterface {
    * @param port_broker pointer to the PortBroker object
    * @param instance_name the instance name of this OlaServer
    * @param uid the default ola::rdm::UID of this OlaServer
+   * @param interface_monitor the InterfaceMonitor, may be NULL.
    */
   PluginAdaptor(class DeviceManager *device_manager,
                 ola::io::SelectServerInterface *select_server,
@@ -57,7 +69,8 @@ class PluginAdaptor: public ola::io::SelectServerInterface {
                 class PreferencesFactory *preferences_factory,
                 class PortBrokerInterface *port_broker,
                 const std::string *instance_name,
-                const ola::rdm::UID *default_uid);
+                const ola::rdm::UID *default_uid,
+                ola::network::InterfaceMonitor *interface_monitor = NULL);
 
   // The following methods are part of the SelectServerInterface
   bool AddReadDescriptor(ola::io::ReadFileDescriptor *descriptor);
@@ -134,6 +147,17 @@ class PluginAdaptor: public ola::io::SelectServerInterface {
     return m_port_broker;
   }
 
+  /**
+   * @brief Return the InterfaceMonitor for the OLA server.
+   * @return the InterfaceMonitor, or NULL if there isn't one.
+   *
+   * Plugins should use this to look up interfaces rather than creating their
+   * own InterfacePicker, and can observe it to learn about address changes.
+   */
+  ola::network::InterfaceMonitor *GetInterfaceMonitor() const {
+    return m_interface_monitor;
+  }
+
   void DrainCallbacks();
 
  private:
@@ -144,6 +168,8 @@ class PluginAdaptor: public ola::io::SelectServerInterface {
   class PortBrokerInterface *m_port_broker;
   const std::string *m_instance_name;
   const ola::rdm::UID *m_default_uid;
+  ola::network::InterfaceMonitor *m_interface_monitor;
+  mutable ola::thread::Mutex m_mutex;
 
   DISALLOW_COPY_AND_ASSIGN(PluginAdaptor);
 };
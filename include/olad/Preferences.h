@@ -389,7 +389,9 @@ class PreferencesFactory {
  */
 class MemoryPreferences: public Preferences {
  public:
-  explicit MemoryPreferences(const std::string name): Preferences(name) {}
+  explicit MemoryPreferences(const std::string name)
+      : Preferences(name),
+        m_revision(0) {}
   virtual ~MemoryPreferences();
   virtual bool Load() { return true; }
   virtual bool Save() const { return true; }
@@ -438,6 +440,9 @@ class MemoryPreferences: public Preferences {
  protected:
   typedef std::multimap<std::string, std::string> PreferencesMap;
   PreferencesMap m_pref_map;
+  // Incremented each time the preferences are modified, this is used to skip
+  // redundant saves.
+  unsigned int m_revision;
 };
 
 
@@ -453,13 +458,31 @@ class MemoryPreferencesFactory: public PreferencesFactory {
 
 
 /**
- * The thread that saves preferences
+ * @brief The thread that saves preferences.
+ *
+ * Save requests are coalesced, no matter how many times a file is saved within
+ * the save delay it's only written once, with the most recent values. Files
+ * are written atomically so a crash mid-write won't corrupt the existing file.
  */
 class FilePreferenceSaverThread: public ola::thread::Thread {
  public:
   typedef std::multimap<std::string, std::string> PreferencesMap;
-  FilePreferenceSaverThread();
 
+  /**
+   * @brief Create a new FilePreferenceSaverThread.
+   * @param save_delay_ms the time to wait for further changes before writing
+   *   the preferences to disk.
+   */
+  explicit FilePreferenceSaverThread(
+      unsigned int save_delay_ms = DEFAULT_SAVE_DELAY_MS);
+
+  ~FilePreferenceSaverThread();
+
+  /**
+   * @brief Schedule preferences to be written to a file.
+   *
+   * This replaces any pending save for the same file.
+   */
   void SavePreferences(const std::string &filename,
                        const PreferencesMap &preferences);
 
@@ -480,8 +503,26 @@ class FilePreferenceSaverThread: public ola::thread::Thread {
    */
   void Synchronize();
 
+  /**
+   * @brief The number of files written so far.
+   */
+  unsigned int WriteCount() const;
+
+  static const unsigned int DEFAULT_SAVE_DELAY_MS = 1000;
+
  private:
+  typedef std::map<std::string, PreferencesMap*> PendingMap;
+
   ola::io::SelectServer m_ss;
+  const unsigned int m_save_delay_ms;
+  mutable ola::thread::Mutex m_pending_mutex;
+  // Protected by m_pending_mutex
+  PendingMap m_pending;
+  bool m_flush_scheduled;
+  unsigned int m_write_count;
+
+  void ScheduleFlush();
+  void FlushPending();
 
   /**
    * Notify the blocked thread we're done
@@ -501,9 +542,16 @@ class FileBackedPreferences: public MemoryPreferences {
                                  FilePreferenceSaverThread *saver_thread)
       : MemoryPreferences(name),
         m_directory(directory),
-        m_saver_thread(saver_thread) {}
+        m_saver_thread(saver_thread),
+        m_saved_revision(0) {}
 
   virtual bool Load();
+
+  /**
+   * @brief Queue the preferences to be saved.
+   *
+   * This is a no-op if nothing has changed since the last save or load.
+   */
   virtual bool Save() const;
 
   /**
@@ -517,6 +565,7 @@ class FileBackedPreferences: public MemoryPreferences {
  private:
   const std::string m_directory;
   FilePreferenceSaverThread *m_saver_thread;
+  mutable unsigned int m_saved_revision;
 
   bool ChangeDir() const;
 
@@ -25,10 +25,12 @@
 #include <ola/DmxBuffer.h>
 #include <ola/ExportMap.h>
 #include <ola/base/Macro.h>
+#include <ola/io/SelectServerInterface.h>
 #include <ola/rdm/RDMCommand.h>
 #include <ola/rdm/RDMControllerInterface.h>
 #include <ola/rdm/UID.h>
 #include <ola/rdm/UIDSet.h>
+#include <ola/thread/SchedulerInterface.h>
 #include <ola/util/SequenceNumber.h>
 #include <olad/DmxSource.h>
 
@@ -50,6 +52,15 @@ class Universe: public ola::rdm::RDMControllerInterface {
       MERGE_LTP
     };
 
+    /**
+     * @brief What to do when a source stops sending data.
+     */
+    enum expiry_mode {
+      EXPIRY_HOLD,  /**< Hold the last look until new data arrives */
+      EXPIRY_RELEASE,  /**< Re-merge the remaining sources */
+      EXPIRY_FADE,  /**< Fade to the remaining sources, or to zero */
+    };
+
     Universe(unsigned int uid, class UniverseStore *store,
              ExportMap *export_map,
              Clock *clock);
@@ -59,6 +70,9 @@ class Universe: public ola::rdm::RDMControllerInterface {
     std::string Name() const { return m_universe_name; }
     unsigned int UniverseId() const { return m_universe_id; }
     merge_mode MergeMode() const { return m_merge_mode; }
+    expiry_mode ExpiryMode() const { return m_expiry_mode; }
+    unsigned int MaxOutputRate() const { return m_max_output_rate; }
+    const TimeInterval& ExpiryFadeTime() const { return m_expiry_fade_time; }
     bool IsActive() const;
     uint8_t ActivePriority() const { return m_active_priority; }
 
@@ -82,6 +96,48 @@ class Universe: public ola::rdm::RDMControllerInterface {
     void SetName(const std::string &name);
     void SetMergeMode(merge_mode merge_mode);
 
+    /**
+     * @brief Set what happens when a source times out.
+     * @param mode the expiry_mode to use.
+     * @param fade_time the time to fade over, used with EXPIRY_FADE.
+     */
+    void SetExpiryMode(expiry_mode mode,
+                       const TimeInterval &fade_time = TimeInterval());
+
+    /**
+     * @brief Set the SelectServer used to time out sources.
+     * @param ss the SelectServer to use, or NULL.
+     *
+     * With a SelectServer, each source is timed out when it stops sending
+     * data, and the remaining sources re-merged per the expiry_mode. Without
+     * one, inactive sources are skipped the next time a merge runs.
+     */
+    void SetSelectServer(ola::io::SelectServerInterface *ss);
+
+    /**
+     * @brief Limit how often this universe writes to its outputs.
+     * @param max_fps the maximum frames per second, or 0 for no limit.
+     *
+     * When limited, input data is merged and sent to the output ports and
+     * sink clients when OutputTick() is called. Use
+     * UniverseStore::SetMaxOutputRate() rather than calling this directly,
+     * since the store runs the output clock.
+     */
+    void SetMaxOutputRate(unsigned int max_fps);
+
+    /**
+     * @brief Merge the input received since the last tick and output the
+     *   result, if anything changed.
+     */
+    void OutputTick();
+
+    /**
+     * @brief Export the input and output frame rates.
+     *
+     * This is called once a second by the UniverseStore.
+     */
+    void ExportFrameRates();
+
     /**
      * Set the time between periodic RDM discovery operations.
      */
@@ -93,6 +149,17 @@ class Universe: public ola::rdm::RDMControllerInterface {
     bool SetDMX(const DmxBuffer &buffer);
     const DmxBuffer &GetDMX() const { return m_buffer; }
 
+    /**
+     * @brief Seed this universe with previously saved data.
+     * @param buffer the DMX data to output.
+     * @param priority the priority the data was output at.
+     *
+     * The data is written to the current output ports, and to each output
+     * port as it's added, until a source provides new data. This is used to
+     * hold the last look across a restart of olad.
+     */
+    void RestoreDMX(const DmxBuffer &buffer, uint8_t priority);
+
     // These are the ports we need to notify when data changes
     bool AddPort(InputPort *port);
     bool AddPort(OutputPort *port);
@@ -132,6 +199,23 @@ class Universe: public ola::rdm::RDMControllerInterface {
                          bool full = true);
     void NewUIDList(OutputPort *port, const ola::rdm::UIDSet &uids);
     void GetUIDs(ola::rdm::UIDSet *uids) const;
+
+    /**
+     * @brief Get the output port each UID was discovered on.
+     * @param[out] uids a map of UID to the UniqueId() of the output port.
+     *   Ports without a unique id are skipped.
+     */
+    void GetUIDPorts(std::map<ola::rdm::UID, std::string> *uids) const;
+
+    /**
+     * @brief Seed the UID table with UIDs saved before a restart.
+     * @param uids a map of UID to the UniqueId() of the output port.
+     *
+     * RDM requests are routed to the restored UIDs as soon as their port is
+     * part of the universe, without waiting for discovery to complete. The
+     * next discovery on the port replaces its restored UIDs.
+     */
+    void RestoreUIDs(const std::map<ola::rdm::UID, std::string> &uids);
     unsigned int UIDCount() const;
     uint8_t GetRDMTransactionNumber();
 
@@ -139,13 +223,18 @@ class Universe: public ola::rdm::RDMControllerInterface {
       return m_universe_id == other.UniverseId();
     }
 
+    static const char K_EXPIRY_FADE_STR[];
+    static const char K_EXPIRY_HOLD_STR[];
+    static const char K_EXPIRY_RELEASE_STR[];
     static const char K_FPS_VAR[];
     static const char K_MERGE_HTP_STR[];
     static const char K_MERGE_LTP_STR[];
     static const char K_UNIVERSE_INPUT_PORT_VAR[];
+    static const char K_UNIVERSE_INPUT_RATE_VAR[];
     static const char K_UNIVERSE_MODE_VAR[];
     static const char K_UNIVERSE_NAME_VAR[];
     static const char K_UNIVERSE_OUTPUT_PORT_VAR[];
+    static const char K_UNIVERSE_OUTPUT_RATE_VAR[];
     static const char K_UNIVERSE_RDM_REQUESTS[];
     static const char K_UNIVERSE_SINK_CLIENTS_VAR[];
     static const char K_UNIVERSE_SOURCE_CLIENTS_VAR[];
@@ -162,6 +251,20 @@ class Universe: public ola::rdm::RDMControllerInterface {
 
     typedef std::map<Client*, bool> SourceClientMap;
 
+    /**
+     * Tracks when an input port or source client times out.
+     */
+    struct SourceState {
+      const InputPort *port;
+      const Client *client;
+      ola::thread::timeout_id timeout;
+      TimeStamp armed_timestamp;  // the source timestamp the timeout is for
+      bool expired;
+    };
+
+    // Keyed by the InputPort or Client
+    typedef std::map<const void*, SourceState> SourceStateMap;
+
     std::string m_universe_name;
     unsigned int m_universe_id;
     std::string m_universe_id_str;
@@ -177,26 +280,60 @@ class Universe: public ola::rdm::RDMControllerInterface {
     SourceClientMap m_source_clients;
     class UniverseStore *m_universe_store;
     DmxBuffer m_buffer;
+    bool m_restored_dmx;  // true if m_buffer holds restored data
     ExportMap *m_export_map;
     std::map<ola::rdm::UID, OutputPort*> m_output_uids;
+    // restored UIDs waiting for their port to be added
+    std::map<ola::rdm::UID, std::string> m_restored_uids;
     Clock *m_clock;
     TimeInterval m_rdm_discovery_interval;
     TimeStamp m_last_discovery_time;
     ola::SequenceNumber<uint8_t> m_transaction_number_sequence;
+    ola::io::SelectServerInterface *m_ss;
+    SourceStateMap m_source_states;
+    expiry_mode m_expiry_mode;
+    TimeInterval m_expiry_fade_time;
+    // The fade that's in progress, if any.
+    ola::thread::timeout_id m_fade_timeout;
+    DmxBuffer m_fade_start;
+    DmxBuffer m_fade_target;
+    unsigned int m_fade_step;
+    unsigned int m_fade_steps;
+    // Output rate limiting
+    unsigned int m_max_output_rate;
+    bool m_merge_pending;  // input has arrived since the last tick
+    bool m_output_pending;  // the data has changed since the last tick
+    unsigned int m_input_frames;
+    unsigned int m_output_frames;
 
     void HandleBroadcastAck(broadcast_request_tracker *tracker,
                             ola::rdm::RDMReply *reply);
     void HandleBroadcastDiscovery(broadcast_request_tracker *tracker,
                                   ola::rdm::RDMReply *reply);
     bool UpdateDependants();
+    void OutputChanged();
     void UpdateName();
     void UpdateMode();
     void HTPMergeSources(const std::vector<DmxSource> &sources);
     bool MergeAll(const InputPort *port, const Client *client);
+    bool SourceIsLive(const void *key, const DmxSource &source,
+                      const TimeStamp &now) const;
+    void TrackSource(const void *key, const InputPort *port,
+                     const Client *client, const DmxSource &source);
+    void ArmSourceTimeout(const void *key, SourceState *state,
+                          const TimeInterval &delay);
+    void SourceTimeout(const void *key);
+    void RemoveSourceState(const void *key);
+    void ReleaseExpiredSource();
+    void StartFade();
+    bool FadeStep();
+    void CancelFade();
     void PortDiscoveryComplete(BaseCallback0<void> *on_complete,
                                OutputPort *output_port,
                                const ola::rdm::UIDSet &uids);
     void DiscoveryComplete(ola::rdm::RDMDiscoveryCallback *on_complete);
+    void AddRestoredUIDs(OutputPort *port);
+    void UpdateUIDCount();
 
     void SafeIncrement(const std::string &name);
     void SafeDecrement(const std::string &name);
@@ -160,8 +160,12 @@ E131Node::~E131Node() {
 
 
 bool E131Node::Start() {
-  auto_ptr<ola::network::InterfacePicker> picker(
-    ola::network::InterfacePicker::NewPicker());
+  const ola::network::InterfacePicker *picker = m_options.interface_monitor;
+  auto_ptr<ola::network::InterfacePicker> our_picker;
+  if (!picker) {
+    our_picker.reset(ola::network::InterfacePicker::NewPicker());
+    picker = our_picker.get();
+  }
   if (!picker->ChooseInterface(&m_interface, m_preferred_ip)) {
     OLA_INFO << "Failed to find an interface";
     return false;
@@ -198,10 +202,17 @@ bool E131Node::Start() {
         UNIVERSE_DISCOVERY_INTERVAL,
         ola::NewCallback(this, &E131Node::PerformDiscoveryHousekeeping));
   }
+
+  if (m_options.interface_monitor) {
+    m_options.interface_monitor->AddObserver(this);
+  }
   return true;
 }
 
 bool E131Node::Stop() {
+  if (m_options.interface_monitor) {
+    m_options.interface_monitor->RemoveObserver(this);
+  }
   m_ss->RemoveTimeout(m_discovery_timeout);
   m_discovery_timeout = ola::thread::INVALID_TIMEOUT;
   return true;
@@ -381,6 +392,23 @@ bool E131Node::RemoveHandler(uint16_t universe) {
 }
 
 
+void E131Node::InterfaceAdded(const ola::network::Interface &iface) {
+  if (iface.name == m_interface.name) {
+    FollowInterface();
+  }
+}
+
+void E131Node::InterfaceRemoved(const ola::network::Interface &iface) {
+  if (iface.name != m_interface.name ||
+      iface.ip_address != m_interface.ip_address) {
+    return;
+  }
+  if (!FollowInterface()) {
+    OLA_WARN << "E1.31 interface " << iface.name << " lost "
+             << iface.ip_address;
+  }
+}
+
 void E131Node::GetKnownControllers(std::vector<KnownController> *controllers) {
   TrackedSources::const_iterator iter = m_discovered_sources.begin();
   for (; iter != m_discovered_sources.end(); ++iter) {
@@ -406,6 +434,52 @@ E131Node::tx_universe *E131Node::SetupOutgoingSettings(uint16_t universe) {
   return &iter->second;
 }
 
+/*
+ * Join the multicast groups for discovery and the universes we're listening
+ * to on the current interface.
+ */
+void E131Node::JoinMulticastGroups() {
+  vector<uint16_t> universes;
+  m_dmp_inflator.RegisteredUniverses(&universes);
+  if (m_options.enable_draft_discovery) {
+    universes.push_back(static_cast<uint16_t>(DISCOVERY_UNIVERSE_ID));
+  }
+
+  vector<uint16_t>::const_iterator iter = universes.begin();
+  for (; iter != universes.end(); ++iter) {
+    IPV4Address addr;
+    if (m_e131_sender.UniverseIP(*iter, &addr)) {
+      m_socket.JoinMulticast(m_interface.ip_address, addr);
+    }
+  }
+}
+
+/*
+ * Move to a new address on our interface, if the InterfaceMonitor says we
+ * should.
+ * @returns true if the node moved.
+ */
+bool E131Node::FollowInterface() {
+  ola::network::Interface iface;
+  if (!m_options.interface_monitor ||
+      !m_options.interface_monitor->FollowInterface(m_interface,
+                                                    m_preferred_ip, &iface)) {
+    return false;
+  }
+
+  OLA_INFO << "E1.31 interface " << iface.name << " moved from "
+           << m_interface.ip_address << " to " << iface.ip_address;
+  const bool link_replaced = iface.index != m_interface.index;
+  m_interface = iface;
+  m_socket.SetMulticastInterface(m_interface.ip_address);
+
+  // Memberships are attached to the link rather than the address, so they
+  // survive a change of address but not the link being recreated.
+  if (link_replaced) {
+    JoinMulticastGroups();
+  }
+  return true;
+}
 
 bool E131Node::PerformDiscoveryHousekeeping() {
   // Send the Universe Discovery packets.
@@ -35,6 +35,7 @@
 #include "ola/io/SelectServerInterface.h"
 #include "ola/thread/SchedulerInterface.h"
 #include "ola/network/Interface.h"
+#include "ola/network/InterfaceMonitor.h"
 #include "ola/network/Socket.h"
 #include "libs/acn/DMPE131Inflator.h"
 #include "libs/acn/E131DiscoveryInflator.h"
@@ -47,7 +48,7 @@
 namespace ola {
 namespace acn {
 
-class E131Node {
+class E131Node : public ola::network::InterfaceObserver {
  public:
   /**
    * @brief Options for the E131Node.
@@ -60,7 +61,8 @@ class E131Node {
          enable_draft_discovery(false),
          dscp(0),
          port(ola::acn::ACN_PORT),
-         source_name(ola::OLA_DEFAULT_INSTANCE_NAME) {
+         source_name(ola::OLA_DEFAULT_INSTANCE_NAME),
+         interface_monitor(NULL) {
     }
 
     bool use_rev2;  /**< Use Revision 0.2 of the 2009 draft */
@@ -69,6 +71,11 @@ class E131Node {
     uint8_t dscp;  /**< The DSCP value to tag packets with */
     uint16_t port; /**< The UDP port to use, defaults to ACN_PORT */
     std::string source_name; /**< The source name to use */
+    /**
+     * @brief The InterfaceMonitor to pick the interface from, and to follow
+     *   address changes with. If NULL the interfaces are scanned on Start().
+     */
+    ola::network::InterfaceMonitor *interface_monitor;
   };
 
   struct KnownController {
@@ -207,6 +214,22 @@ class E131Node {
    */
   void GetKnownControllers(std::vector<KnownController> *controllers);
 
+  /**
+   * @brief Called by the InterfaceMonitor when an interface comes up.
+   *
+   * If our address had gone, or the configured address has appeared on our
+   * interface, the node moves to it.
+   */
+  void InterfaceAdded(const ola::network::Interface &iface);
+
+  /**
+   * @brief Called by the InterfaceMonitor when an interface goes away.
+   *
+   * If it was our address, the node moves to another address on the same
+   * interface.
+   */
+  void InterfaceRemoved(const ola::network::Interface &iface);
+
  private:
   struct tx_universe {
     std::string source;
@@ -242,6 +265,8 @@ class E131Node {
   TrackedSources m_discovered_sources;
 
   tx_universe *SetupOutgoingSettings(uint16_t universe);
+  void JoinMulticastGroups();
+  bool FollowInterface();
 
   bool PerformDiscoveryHousekeeping();
   void NewDiscoveryPage(const HeaderSet &headers,
@@ -49,6 +49,23 @@ E133HealthCheckedConnection::E133HealthCheckedConnection(
 }
 
 
+E133HealthCheckedConnection::E133HealthCheckedConnection(
+  ola::e133::MessageBuilder *message_builder,
+  ola::io::NonBlockingSender *message_queue,
+  ola::SingleUseCallback0<void> *on_timeout,
+  ola::thread::SchedulingExecutorInterface *scheduler,
+  ola::thread::TimerWheel *timer_wheel,
+  const ola::TimeInterval heartbeat_interval,
+  const ola::TimeInterval timeout_interval)
+    : HealthCheckedConnection(timer_wheel, heartbeat_interval,
+                              timeout_interval),
+      m_message_builder(message_builder),
+      m_message_queue(message_queue),
+      m_on_timeout(on_timeout),
+      m_executor(scheduler) {
+}
+
+
 /**
  * Send a E1.33 heartbeat
  */
@@ -39,6 +39,7 @@
 #include <ola/io/NonBlockingSender.h>
 #include <ola/network/HealthCheckedConnection.h>
 #include <ola/thread/SchedulingExecutorInterface.h>
+#include <ola/thread/TimerWheel.h>
 
 #include <memory>
 
@@ -59,6 +60,21 @@ class E133HealthCheckedConnection
         const ola::TimeInterval timeout_interval =
           ola::TimeInterval(E133_HEARTBEAT_TIMEOUT, 0));
 
+    /**
+     * Create a connection which uses a shared TimerWheel for the heartbeats.
+     * The executor is still used to run the on_timeout callback.
+     */
+    E133HealthCheckedConnection(
+        ola::e133::MessageBuilder *message_builder,
+        ola::io::NonBlockingSender *message_queue,
+        ola::SingleUseCallback0<void> *on_timeout,
+        ola::thread::SchedulingExecutorInterface *scheduler,
+        ola::thread::TimerWheel *timer_wheel,
+        const ola::TimeInterval heartbeat_interval =
+          ola::TimeInterval(E133_TCP_HEARTBEAT_INTERVAL, 0),
+        const ola::TimeInterval timeout_interval =
+          ola::TimeInterval(E133_HEARTBEAT_TIMEOUT, 0));
+
     void SendHeartbeat();
     void HeartbeatTimeout();
 
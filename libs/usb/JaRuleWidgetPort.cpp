@@ -23,14 +23,15 @@
 #include <ola/Callback.h>
 #include <ola/Constants.h>
 #include <ola/Logging.h>
-#include <ola/stl/STLUtils.h>
 #include <ola/strings/Format.h>
 #include <ola/thread/Mutex.h>
 #include <ola/util/Utils.h>
 
-#include <memory>
+#include <string.h>
+
+#include <algorithm>
 #include <string>
-#include <utility>
+#include <vector>
 
 namespace ola {
 namespace usb {
@@ -43,7 +44,6 @@ using ola::utils::JoinUInt8;
 using ola::utils::SplitUInt16;
 using std::cerr;
 using std::string;
-using std::auto_ptr;
 
 namespace {
 
@@ -52,7 +52,7 @@ __attribute__((__stdcall__))
 #endif  // _WIN32
 void InTransferCompleteHandler(struct libusb_transfer *transfer) {
   JaRuleWidgetPort *port = static_cast<JaRuleWidgetPort*>(transfer->user_data);
-  return port->_InTransferComplete();
+  return port->_InTransferComplete(transfer);
 }
 
 #ifdef _WIN32
@@ -60,7 +60,7 @@ __attribute__((__stdcall__))
 #endif  // _WIN32
 void OutTransferCompleteHandler(struct libusb_transfer *transfer) {
   JaRuleWidgetPort *port = static_cast<JaRuleWidgetPort*>(transfer->user_data);
-  return port->_OutTransferComplete();
+  return port->_OutTransferComplete(transfer);
 }
 
 }  // namespace
@@ -78,10 +78,29 @@ JaRuleWidgetPort::JaRuleWidgetPort(ola::thread::ExecutorInterface *executor,
       m_uid(uid),
       m_physical_port(physical_port),
       m_handle(NULL),
-      m_out_transfer(adaptor->AllocTransfer(0)),
-      m_out_in_progress(false),
-      m_in_transfer(adaptor->AllocTransfer(0)),
-      m_in_in_progress(false) {
+      m_commands(LANE_COUNT * (MAX_QUEUED_MESSAGES + 1) + MAX_IN_FLIGHT) {
+  std::vector<PendingCommand>::iterator iter = m_commands.begin();
+  for (; iter != m_commands.end(); ++iter) {
+    m_free_commands.push_back(&(*iter));
+  }
+
+  std::fill(m_in_flight, m_in_flight + TOKEN_COUNT,
+            static_cast<PendingCommand*>(NULL));
+  std::fill(m_in_flight_count, m_in_flight_count + LANE_COUNT, 0);
+
+  for (unsigned int i = 0; i < MAX_IN_FLIGHT; i++) {
+    USBTransfer *transfer = new USBTransfer();
+    transfer->transfer = adaptor->AllocTransfer(0);
+    transfer->in_progress = false;
+    m_out_transfers.push_back(transfer);
+  }
+
+  for (unsigned int i = 0; i < IN_TRANSFER_COUNT; i++) {
+    USBTransfer *transfer = new USBTransfer();
+    transfer->transfer = adaptor->AllocTransfer(0);
+    transfer->in_progress = false;
+    m_in_transfers.push_back(transfer);
+  }
 }
 
 JaRuleWidgetPort::~JaRuleWidgetPort() {
@@ -92,42 +111,40 @@ JaRuleWidgetPort::~JaRuleWidgetPort() {
 
   {
     MutexLocker locker(&m_mutex);
-    if (!m_queued_commands.empty()) {
+    if (!(m_queued_commands[DMX_LANE].empty() &&
+          m_queued_commands[COMMAND_LANE].empty())) {
       OLA_WARN << "Queued commands remain, did we forget to call "
                   "CancelTransfer()?";
     }
 
-    if (!m_pending_commands.empty()) {
+    if (InFlightCount()) {
       OLA_WARN << "Pending commands remain, did we forget to call "
                   "CancelTransfer()?";
     }
 
     // Cancelling may take up to a second if the endpoint has stalled. I can't
     // really see a way to speed this up.
-    if (m_out_in_progress) {
-      m_adaptor->CancelTransfer(m_out_transfer);
+    USBTransfers::iterator iter = m_out_transfers.begin();
+    for (; iter != m_out_transfers.end(); ++iter) {
+      if ((*iter)->in_progress) {
+        m_adaptor->CancelTransfer((*iter)->transfer);
+      }
     }
 
-    if (m_in_in_progress) {
-      m_adaptor->CancelTransfer(m_in_transfer);
+    for (iter = m_in_transfers.begin(); iter != m_in_transfers.end(); ++iter) {
+      if ((*iter)->in_progress) {
+        m_adaptor->CancelTransfer((*iter)->transfer);
+      }
     }
   }
 
   OLA_DEBUG << "Waiting for transfers to complete";
-  bool transfers_pending = true;
-  while (transfers_pending) {
+  while (TransfersInProgress()) {
     // Spin waiting for the transfers to complete.
-    MutexLocker locker(&m_mutex);
-    transfers_pending = m_out_in_progress || m_in_in_progress;
-  }
-
-  if (m_out_transfer) {
-    m_adaptor->FreeTransfer(m_out_transfer);
   }
 
-  if (m_in_transfer) {
-    m_adaptor->FreeTransfer(m_in_transfer);
-  }
+  FreeTransfers(&m_out_transfers);
+  FreeTransfers(&m_in_transfers);
 }
 
 JaRulePortHandle* JaRuleWidgetPort::ClaimPort() {
@@ -147,40 +164,34 @@ void JaRuleWidgetPort::ReleasePort() {
 }
 
 void JaRuleWidgetPort::CancelAll() {
-  CommandQueue queued_commands;
-  PendingCommandMap pending_commands;
+  std::vector<CommandCompleteCallback*> callbacks;
 
   {
     MutexLocker locker(&m_mutex);
-    queued_commands = m_queued_commands;
-    while (!m_queued_commands.empty()) {
-      m_queued_commands.pop();
-    }
-    pending_commands.swap(m_pending_commands);
-  }
-
-  while (!queued_commands.empty()) {
-    auto_ptr<PendingCommand> command(queued_commands.front());
-    if (command->callback) {
-      command->callback->Run(COMMAND_RESULT_CANCELLED, RC_UNKNOWN, 0,
-                             ByteString());
+    for (unsigned int lane = 0; lane < LANE_COUNT; lane++) {
+      CommandQueue *queue = &m_queued_commands[lane];
+      while (!queue->empty()) {
+        callbacks.push_back(queue->front()->callback);
+        ReleaseCommand(queue->front());
+        queue->pop();
+      }
     }
-    queued_commands.pop();
-  }
 
-  PendingCommandMap::iterator iter = pending_commands.begin();
-  for (; iter != pending_commands.end(); ++iter) {
-    if (iter->second->callback) {
-      iter->second->callback->Run(COMMAND_RESULT_CANCELLED, RC_UNKNOWN, 0,
-                                  ByteString());
-      delete iter->second;
+    for (unsigned int token = 0; token < TOKEN_COUNT; token++) {
+      PendingCommand *command = m_in_flight[token];
+      if (command) {
+        callbacks.push_back(command->callback);
+        m_in_flight[token] = NULL;
+        m_in_flight_count[command->lane]--;
+        ReleaseCommand(command);
+      }
     }
   }
 
-  {
-    MutexLocker locker(&m_mutex);
-    if (!(m_queued_commands.empty() && m_pending_commands.empty())) {
-      OLA_WARN << "Some commands have not been cancelled";
+  std::vector<CommandCompleteCallback*>::iterator iter = callbacks.begin();
+  for (; iter != callbacks.end(); ++iter) {
+    if (*iter) {
+      (*iter)->Run(COMMAND_RESULT_CANCELLED, RC_UNKNOWN, 0, ByteString());
     }
   }
 }
@@ -204,34 +215,15 @@ void JaRuleWidgetPort::SendCommand(
     return;
   }
 
-  // Create the payload
-  ByteString payload;
-  payload.reserve(size + MIN_RESPONSE_SIZE);
-
-  payload.push_back(SOF_IDENTIFIER);
-  payload.push_back(0);  // token, will be set on TX
-  payload.push_back(command_class & 0xff);
-  payload.push_back(command_class >> 8);
-  payload.push_back(size & 0xff);
-  payload.push_back(size >> 8);
-  payload.append(data, size);
-  payload.push_back(EOF_IDENTIFIER);
-
-  if (payload.size() % USB_PACKET_SIZE == 0)  {
-    // We need to pad the message so that the transfer completes on the
-    // Device side. We could use LIBUSB_TRANSFER_ADD_ZERO_PACKET instead but
-    // that isn't available on all platforms.
-    payload.push_back(0);
-  }
-
-  auto_ptr<PendingCommand> command(new PendingCommand(
-      command_class, callback, payload));
-
   OLA_INFO << "Adding new command " << ToHex(command_class);
 
+  const Lane lane = (command_class == JARULE_CMD_TX_DMX ?
+                     DMX_LANE : COMMAND_LANE);
+
   MutexLocker locker(&m_mutex);
 
-  if (m_queued_commands.size() > MAX_QUEUED_MESSAGES) {
+  if (m_queued_commands[lane].size() > MAX_QUEUED_MESSAGES ||
+      m_free_commands.empty()) {
     locker.Release();
     OLA_WARN << "JaRule outbound queue is full";
     if (callback) {
@@ -240,126 +232,189 @@ void JaRuleWidgetPort::SendCommand(
     return;
   }
 
-  m_queued_commands.push(command.release());
-  MaybeSendCommand();
+  PendingCommand *command = m_free_commands.back();
+  m_free_commands.pop_back();
+  command->command = command_class;
+  command->callback = callback;
+  command->lane = lane;
+
+  // Build the frame
+  uint8_t *frame = command->frame;
+  unsigned int offset = 0;
+  frame[offset++] = SOF_IDENTIFIER;
+  frame[offset++] = 0;  // token, will be set on TX
+  frame[offset++] = command_class & 0xff;
+  frame[offset++] = command_class >> 8;
+  frame[offset++] = size & 0xff;
+  frame[offset++] = size >> 8;
+  if (size) {
+    memcpy(frame + offset, data, size);
+    offset += size;
+  }
+  frame[offset++] = EOF_IDENTIFIER;
+
+  if (offset % USB_PACKET_SIZE == 0)  {
+    // We need to pad the message so that the transfer completes on the
+    // Device side. We could use LIBUSB_TRANSFER_ADD_ZERO_PACKET instead but
+    // that isn't available on all platforms.
+    frame[offset++] = 0;
+  }
+  command->frame_size = offset;
+
+  m_queued_commands[lane].push(command);
+  MaybeSendCommands();
 }
 
-void JaRuleWidgetPort::_OutTransferComplete() {
+void JaRuleWidgetPort::_OutTransferComplete(libusb_transfer *transfer) {
   OLA_DEBUG << "Out Command status is "
-            << LibUsbAdaptor::ErrorCodeToString(m_in_transfer->status);
-  if (m_out_transfer->status == LIBUSB_TRANSFER_COMPLETED) {
-    if (m_out_transfer->actual_length != m_out_transfer->length) {
+            << LibUsbAdaptor::ErrorCodeToString(transfer->status);
+  if (transfer->status == LIBUSB_TRANSFER_COMPLETED) {
+    if (transfer->actual_length != transfer->length) {
       // TODO(simon): Decide what to do here
-      OLA_WARN << "Only sent " << m_out_transfer->actual_length << " / "
-               << m_out_transfer->length << " bytes";
+      OLA_WARN << "Only sent " << transfer->actual_length << " / "
+               << transfer->length << " bytes";
     }
   }
 
   MutexLocker locker(&m_mutex);
-  m_out_in_progress = false;
-  MaybeSendCommand();
+  USBTransfer *usb_transfer = FindTransfer(m_out_transfers, transfer);
+  if (usb_transfer) {
+    usb_transfer->in_progress = false;
+  }
+  MaybeSendCommands();
 }
 
-void JaRuleWidgetPort::_InTransferComplete() {
+void JaRuleWidgetPort::_InTransferComplete(libusb_transfer *transfer) {
   OLA_DEBUG << "In transfer completed status is "
-            << LibUsbAdaptor::ErrorCodeToString(m_in_transfer->status);
+            << LibUsbAdaptor::ErrorCodeToString(transfer->status);
 
   MutexLocker locker(&m_mutex);
-  m_in_in_progress = false;
+  USBTransfer *usb_transfer = FindTransfer(m_in_transfers, transfer);
+  if (usb_transfer) {
+    usb_transfer->in_progress = false;
+  }
 
-  if (m_in_transfer->status == LIBUSB_TRANSFER_COMPLETED) {
-    HandleResponse(m_in_transfer->buffer, m_in_transfer->actual_length);
+  if (transfer->status == LIBUSB_TRANSFER_COMPLETED) {
+    HandleResponse(transfer->buffer, transfer->actual_length);
   }
 
-  PendingCommandMap::iterator iter = m_pending_commands.begin();
-  TimeStamp time_limit;
-  m_clock.CurrentMonotonicTime(&time_limit);
-  time_limit -= TimeInterval(1, 0);
-  while (iter != m_pending_commands.end()) {
-    PendingCommand *command = iter->second;
-    if (command->out_time < time_limit) {
-      ScheduleCallback(command->callback, COMMAND_RESULT_TIMEOUT, RC_UNKNOWN, 0,
-                       ByteString());
-      delete command;
-      m_pending_commands.erase(iter++);
+  TimeoutCommands();
+
+  // A response frees up a token, so we may be able to send more.
+  MaybeSendCommands();
+  MaybeSubmitInTransfers();
+}
+
+unsigned int JaRuleWidgetPort::InFlightCount() const {
+  return m_in_flight_count[DMX_LANE] + m_in_flight_count[COMMAND_LANE];
+}
+
+bool JaRuleWidgetPort::CanSend(Lane lane) const {
+  if (m_queued_commands[lane].empty() || InFlightCount() >= MAX_IN_FLIGHT) {
+    return false;
+  }
+  // Hold back a token for DMX.
+  return lane == DMX_LANE ||
+         m_in_flight_count[COMMAND_LANE] < MAX_IN_FLIGHT - 1;
+}
+
+void JaRuleWidgetPort::MaybeSendCommands() {
+  while (true) {
+    if (CanSend(DMX_LANE)) {
+      if (!SendQueuedCommand(DMX_LANE)) {
+        return;
+      }
+    } else if (CanSend(COMMAND_LANE)) {
+      if (!SendQueuedCommand(COMMAND_LANE)) {
+        return;
+      }
     } else {
-      iter++;
+      return;
     }
   }
+}
 
-  if (!m_pending_commands.empty()) {
-    SubmitInTransfer();
+bool JaRuleWidgetPort::SendQueuedCommand(Lane lane) {
+  USBTransfer *usb_transfer = NULL;
+  USBTransfers::iterator iter = m_out_transfers.begin();
+  for (; iter != m_out_transfers.end(); ++iter) {
+    if (!(*iter)->in_progress) {
+      usb_transfer = *iter;
+      break;
+    }
   }
-}
 
-void JaRuleWidgetPort::MaybeSendCommand() {
-  if (m_out_in_progress ||
-      m_pending_commands.size() > MAX_IN_FLIGHT ||
-      m_queued_commands.empty()) {
-    return;
+  if (!usb_transfer) {
+    // Wait for an outbound transfer to complete.
+    return false;
   }
 
-  PendingCommand *command = m_queued_commands.front();
-  m_queued_commands.pop();
+  PendingCommand *command = m_queued_commands[lane].front();
+  m_queued_commands[lane].pop();
 
   uint8_t token = m_token.Next();
-  command->payload[1] = token;
+  command->frame[1] = token;
+  memcpy(usb_transfer->buffer, command->frame, command->frame_size);
   m_adaptor->FillBulkTransfer(
-      m_out_transfer, m_usb_handle, m_endpoint_number | LIBUSB_ENDPOINT_OUT,
-      const_cast<uint8_t*>(command->payload.data()),
-      command->payload.size(), OutTransferCompleteHandler,
+      usb_transfer->transfer, m_usb_handle,
+      m_endpoint_number | LIBUSB_ENDPOINT_OUT,
+      usb_transfer->buffer, command->frame_size, OutTransferCompleteHandler,
       static_cast<void*>(this), ENDPOINT_TIMEOUT_MS);
 
-  int r = m_adaptor->SubmitTransfer(m_out_transfer);
+  int r = m_adaptor->SubmitTransfer(usb_transfer->transfer);
   if (r) {
     OLA_WARN << "Failed to submit outbound transfer: "
              << LibUsbAdaptor::ErrorCodeToString(r);
     ScheduleCallback(command->callback, COMMAND_RESULT_SEND_ERROR, RC_UNKNOWN,
                      0, ByteString());
-    delete command;
-    return;
+    ReleaseCommand(command);
+    return true;
   }
+  usb_transfer->in_progress = true;
 
   m_clock.CurrentMonotonicTime(&command->out_time);
-  std::pair<PendingCommandMap::iterator, bool> p = m_pending_commands.insert(
-      PendingCommandMap::value_type(token, command));
-  if (!p.second) {
+  PendingCommand *old_command = m_in_flight[token];
+  if (old_command) {
     // We had an old entry, cancel it.
-    ScheduleCallback(p.first->second->callback,
+    ScheduleCallback(old_command->callback,
                      COMMAND_RESULT_CANCELLED, RC_UNKNOWN, 0, ByteString());
-    delete p.first->second;
-    p.first->second = command;
+    m_in_flight_count[old_command->lane]--;
+    ReleaseCommand(old_command);
   }
+  m_in_flight[token] = command;
+  m_in_flight_count[lane]++;
 
-  m_out_in_progress = true;
-  if (!m_in_in_progress) {
-    SubmitInTransfer();
-  }
-  return;
+  MaybeSubmitInTransfers();
+  return true;
 }
 
-bool JaRuleWidgetPort::SubmitInTransfer() {
-  if (m_in_in_progress) {
-    OLA_WARN << "Read already pending";
-    return true;
+void JaRuleWidgetPort::MaybeSubmitInTransfers() {
+  if (!InFlightCount()) {
+    return;
   }
 
-  m_adaptor->FillBulkTransfer(m_in_transfer, m_usb_handle,
-                              m_endpoint_number | LIBUSB_ENDPOINT_IN,
-                              m_in_buffer, IN_BUFFER_SIZE,
-                              InTransferCompleteHandler,
-                              static_cast<void*>(this),
-                              ENDPOINT_TIMEOUT_MS);
+  USBTransfers::iterator iter = m_in_transfers.begin();
+  for (; iter != m_in_transfers.end(); ++iter) {
+    USBTransfer *usb_transfer = *iter;
+    if (usb_transfer->in_progress) {
+      continue;
+    }
 
-  int r = m_adaptor->SubmitTransfer(m_in_transfer);
-  if (r) {
-    OLA_WARN << "Failed to submit input transfer: "
-             << LibUsbAdaptor::ErrorCodeToString(r);
-    return false;
+    m_adaptor->FillBulkTransfer(usb_transfer->transfer, m_usb_handle,
+                                m_endpoint_number | LIBUSB_ENDPOINT_IN,
+                                usb_transfer->buffer, IN_BUFFER_SIZE,
+                                InTransferCompleteHandler,
+                                static_cast<void*>(this),
+                                ENDPOINT_TIMEOUT_MS);
+
+    int r = m_adaptor->SubmitTransfer(usb_transfer->transfer);
+    if (r) {
+      OLA_WARN << "Failed to submit input transfer: "
+               << LibUsbAdaptor::ErrorCodeToString(r);
+      return;
+    }
+    usb_transfer->in_progress = true;
   }
-
-  m_in_in_progress = true;
-  return true;
 }
 
 /*
@@ -404,10 +459,12 @@ void JaRuleWidgetPort::HandleResponse(const uint8_t *data, unsigned int size) {
     return;
   }
 
-  PendingCommand *command;
-  if (!STLLookupAndRemove(&m_pending_commands, token, &command)) {
+  PendingCommand *command = m_in_flight[token];
+  if (!command) {
     return;
   }
+  m_in_flight[token] = NULL;
+  m_in_flight_count[command->lane]--;
 
   USBCommandResult status = COMMAND_RESULT_OK;
   if (command->command != command_class) {
@@ -420,7 +477,59 @@ void JaRuleWidgetPort::HandleResponse(const uint8_t *data, unsigned int size) {
   }
   ScheduleCallback(
       command->callback, status, return_code, status_flags, payload);
-  delete command;
+  ReleaseCommand(command);
+}
+
+void JaRuleWidgetPort::TimeoutCommands() {
+  if (!InFlightCount()) {
+    return;
+  }
+
+  TimeStamp time_limit;
+  m_clock.CurrentMonotonicTime(&time_limit);
+  time_limit -= TimeInterval(1, 0);
+  for (unsigned int token = 0; token < TOKEN_COUNT; token++) {
+    PendingCommand *command = m_in_flight[token];
+    if (command && command->out_time < time_limit) {
+      ScheduleCallback(command->callback, COMMAND_RESULT_TIMEOUT, RC_UNKNOWN, 0,
+                       ByteString());
+      m_in_flight[token] = NULL;
+      m_in_flight_count[command->lane]--;
+      ReleaseCommand(command);
+    }
+  }
+}
+
+void JaRuleWidgetPort::ReleaseCommand(PendingCommand *command) {
+  command->callback = NULL;
+  m_free_commands.push_back(command);
+}
+
+bool JaRuleWidgetPort::TransfersInProgress() {
+  MutexLocker locker(&m_mutex);
+  USBTransfers::const_iterator iter = m_out_transfers.begin();
+  for (; iter != m_out_transfers.end(); ++iter) {
+    if ((*iter)->in_progress) {
+      return true;
+    }
+  }
+  for (iter = m_in_transfers.begin(); iter != m_in_transfers.end(); ++iter) {
+    if ((*iter)->in_progress) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void JaRuleWidgetPort::FreeTransfers(USBTransfers *transfers) {
+  USBTransfers::iterator iter = transfers->begin();
+  for (; iter != transfers->end(); ++iter) {
+    if ((*iter)->transfer) {
+      m_adaptor->FreeTransfer((*iter)->transfer);
+    }
+    delete *iter;
+  }
+  transfers->clear();
 }
 
 /*
@@ -455,5 +564,17 @@ void JaRuleWidgetPort::RunCallback(CommandCompleteCallback *callback,
                                    CallbackArgs args) {
   callback->Run(args.result, args.return_code, args.status_flags, args.payload);
 }
+
+JaRuleWidgetPort::USBTransfer *JaRuleWidgetPort::FindTransfer(
+    const USBTransfers &transfers,
+    const libusb_transfer *transfer) {
+  USBTransfers::const_iterator iter = transfers.begin();
+  for (; iter != transfers.end(); ++iter) {
+    if ((*iter)->transfer == transfer) {
+      return *iter;
+    }
+  }
+  return NULL;
+}
 }  // namespace usb
 }  // namespace ola
@@ -28,8 +28,8 @@
 #include <ola/thread/Mutex.h>
 #include <ola/util/SequenceNumber.h>
 
-#include <map>
 #include <queue>
+#include <vector>
 
 #include "libs/usb/JaRulePortHandle.h"
 #include "libs/usb/LibUsbAdaptor.h"
@@ -43,6 +43,14 @@ namespace usb {
  *
  * Each port has its own libusb transfers as well as a command queue. This
  * avoids slow commands on one port blocking another.
+ *
+ * Several commands can be in flight at once, each identified by its token.
+ * Commands are queued on one of two lanes. DMX frames are always sent before
+ * any other queued command and one token is held back for them, so DMX
+ * output doesn't stall behind a slow run of RDM commands.
+ *
+ * The commands and the libusb transfers are allocated up front, so sending a
+ * command doesn't allocate memory.
  */
 class JaRuleWidgetPort {
  public:
@@ -105,13 +113,13 @@ class JaRuleWidgetPort {
    * @brief Called by the libusb callback when the transfer completes or is
    * cancelled.
    */
-  void _OutTransferComplete();
+  void _OutTransferComplete(libusb_transfer *transfer);
 
   /**
    * @brief Called by the libusb callback when the transfer completes or is
    * cancelled.
    */
-  void _InTransferComplete();
+  void _InTransferComplete(libusb_transfer *transfer);
 
  private:
   // This must be a multiple of the USB packet size otherwise we can experience
@@ -119,6 +127,7 @@ class JaRuleWidgetPort {
   // to be safe.
   enum { IN_BUFFER_SIZE = 1024 };
   enum { OUT_BUFFER_SIZE = 1024 };
+  enum { TOKEN_COUNT = 256 };
 
   // The arguments passed to the user supplied callback.
   typedef struct {
@@ -128,24 +137,30 @@ class JaRuleWidgetPort {
     const ola::io::ByteString payload;
   } CallbackArgs;
 
-  class PendingCommand {
-   public:
-    PendingCommand(CommandClass command,
-                   CommandCompleteCallback *callback,
-                   const ola::io::ByteString &payload)
-        : command(command),
-          callback(callback),
-          payload(payload) {
-    }
+  typedef enum {
+    DMX_LANE,  //!< DMX frames
+    COMMAND_LANE,  //!< Everything else
+    LANE_COUNT
+  } Lane;
 
+  struct PendingCommand {
     CommandClass command;
     CommandCompleteCallback *callback;
-    ola::io::ByteString payload;
+    Lane lane;
+    uint8_t frame[OUT_BUFFER_SIZE];
+    unsigned int frame_size;
     TimeStamp out_time;  // When this cmd was sent
   };
 
-  typedef std::map<uint8_t, PendingCommand*> PendingCommandMap;
+  struct USBTransfer {
+    libusb_transfer *transfer;
+    bool in_progress;
+    uint8_t buffer[IN_BUFFER_SIZE];
+  };
+
   typedef std::queue<PendingCommand*> CommandQueue;
+  typedef std::vector<PendingCommand*> CommandList;
+  typedef std::vector<USBTransfer*> USBTransfers;
 
   ola::Clock m_clock;
   ola::thread::ExecutorInterface* const m_executor;
@@ -159,20 +174,28 @@ class JaRuleWidgetPort {
   ola::SequenceNumber<uint8_t> m_token;
 
   ola::thread::Mutex m_mutex;
-  CommandQueue m_queued_commands;  // GUARDED_BY(m_mutex);
-  PendingCommandMap m_pending_commands;  // GUARDED_BY(m_mutex);
-
-  libusb_transfer *m_out_transfer;  // GUARDED_BY(m_mutex);
-  bool m_out_in_progress;  // GUARDED_BY(m_mutex);
-
-  uint8_t m_in_buffer[IN_BUFFER_SIZE];  // GUARDED_BY(m_mutex);
-  libusb_transfer *m_in_transfer;  // GUARDED_BY(m_mutex);
-  bool m_in_in_progress;  // GUARDED_BY(m_mutex);
-
-  void MaybeSendCommand();  // LOCK_REQUIRED(m_mutex);
-  bool SubmitInTransfer();  // LOCK_REQUIRED(m_mutex);
+  // The storage for all commands.
+  std::vector<PendingCommand> m_commands;
+  CommandList m_free_commands;  // GUARDED_BY(m_mutex);
+  CommandQueue m_queued_commands[LANE_COUNT];  // GUARDED_BY(m_mutex);
+  // The commands waiting for a response, indexed by token.
+  PendingCommand *m_in_flight[TOKEN_COUNT];  // GUARDED_BY(m_mutex);
+  unsigned int m_in_flight_count[LANE_COUNT];  // GUARDED_BY(m_mutex);
+
+  USBTransfers m_out_transfers;  // GUARDED_BY(m_mutex);
+  USBTransfers m_in_transfers;  // GUARDED_BY(m_mutex);
+
+  unsigned int InFlightCount() const;  // LOCK_REQUIRED(m_mutex);
+  bool CanSend(Lane lane) const;  // LOCK_REQUIRED(m_mutex);
+  void MaybeSendCommands();  // LOCK_REQUIRED(m_mutex);
+  bool SendQueuedCommand(Lane lane);  // LOCK_REQUIRED(m_mutex);
+  void MaybeSubmitInTransfers();  // LOCK_REQUIRED(m_mutex);
   void HandleResponse(const uint8_t *data,
                       unsigned int size);  // LOCK_REQUIRED(m_mutex);
+  void TimeoutCommands();  // LOCK_REQUIRED(m_mutex);
+  void ReleaseCommand(PendingCommand *command);  // LOCK_REQUIRED(m_mutex);
+  bool TransfersInProgress();
+  void FreeTransfers(USBTransfers *transfers);
 
   void ScheduleCallback(CommandCompleteCallback *callback,
                         USBCommandResult result,
@@ -182,13 +205,17 @@ class JaRuleWidgetPort {
   void RunCallback(CommandCompleteCallback *callback,
                    CallbackArgs args);
 
+  static USBTransfer *FindTransfer(const USBTransfers &transfers,
+                                   const libusb_transfer *transfer);
+
   static const uint8_t EOF_IDENTIFIER = 0xa5;
   static const uint8_t SOF_IDENTIFIER = 0x5a;
   static const unsigned int MAX_PAYLOAD_SIZE = 513;
   static const unsigned int MIN_RESPONSE_SIZE = 9;
   static const unsigned int USB_PACKET_SIZE = 64;
-  static const unsigned int MAX_IN_FLIGHT = 2;
+  static const unsigned int MAX_IN_FLIGHT = 4;
   static const unsigned int MAX_QUEUED_MESSAGES = 10;
+  static const unsigned int IN_TRANSFER_COUNT = 2;
 
   static const unsigned int ENDPOINT_TIMEOUT_MS = 1000;
 
@@ -0,0 +1,209 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * JaRuleWidgetPortTest.cpp
+ * Test fixture for the JaRuleWidgetPort class
+ * Copyright (C) 2026 agent
+ */
+
+#include <libusb.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <vector>
+
+#include "libs/usb/JaRuleConstants.h"
+#include "libs/usb/JaRuleWidgetPort.h"
+#include "libs/usb/MockJaRuleAdaptor.h"
+#include "ola/Callback.h"
+#include "ola/io/ByteString.h"
+#include "ola/io/SelectServer.h"
+#include "ola/rdm/UID.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::NewSingleCallback;
+using ola::io::ByteString;
+using ola::rdm::UID;
+using ola::usb::CommandClass;
+using ola::usb::JaRuleReturnCode;
+using ola::usb::JaRuleWidgetPort;
+using ola::usb::MockJaRuleAdaptor;
+using ola::usb::USBCommandResult;
+using std::vector;
+
+class JaRuleWidgetPortTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(JaRuleWidgetPortTest);
+  CPPUNIT_TEST(testCommands);
+  CPPUNIT_TEST(testDMXPriority);
+  CPPUNIT_TEST(testQueueFull);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  JaRuleWidgetPortTest()
+      : m_uid(0x7a70, 1),
+        m_expected_results(0) {
+  }
+
+  void setUp();
+
+  void testCommands();
+  void testDMXPriority();
+  void testQueueFull();
+
+ private:
+  struct Result {
+    CommandClass command;
+    USBCommandResult result;
+    JaRuleReturnCode return_code;
+  };
+
+  ola::io::SelectServer m_ss;
+  UID m_uid;
+  vector<Result> m_results;
+  unsigned int m_expected_results;
+
+  void SendCommand(JaRuleWidgetPort *port, CommandClass command);
+  void CommandComplete(CommandClass command,
+                       USBCommandResult result,
+                       JaRuleReturnCode return_code,
+                       uint8_t status_flags,
+                       const ByteString &payload);
+  void WaitForResults(unsigned int count);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(JaRuleWidgetPortTest);
+
+void JaRuleWidgetPortTest::setUp() {
+  m_results.clear();
+  m_expected_results = 0;
+}
+
+void JaRuleWidgetPortTest::SendCommand(JaRuleWidgetPort *port,
+                                       CommandClass command) {
+  const uint8_t data[] = {0, 1, 2, 3};
+  port->SendCommand(
+      command, data, sizeof(data),
+      NewSingleCallback(this, &JaRuleWidgetPortTest::CommandComplete,
+                        command));
+}
+
+void JaRuleWidgetPortTest::CommandComplete(
+    CommandClass command,
+    USBCommandResult result,
+    JaRuleReturnCode return_code,
+    OLA_UNUSED uint8_t status_flags,
+    OLA_UNUSED const ByteString &payload) {
+  Result r = {command, result, return_code};
+  m_results.push_back(r);
+  if (m_results.size() == m_expected_results) {
+    m_ss.Terminate();
+  }
+}
+
+void JaRuleWidgetPortTest::WaitForResults(unsigned int count) {
+  m_expected_results = count;
+  if (m_results.size() < count) {
+    ola::thread::timeout_id timeout = m_ss.RegisterSingleTimeout(
+        5000, NewSingleCallback(&m_ss, &ola::io::SelectServer::Terminate));
+    m_ss.Run();
+    m_ss.RemoveTimeout(timeout);
+  }
+  OLA_ASSERT_EQ(static_cast<size_t>(count), m_results.size());
+}
+
+/*
+ * Check commands are sent and the responses are matched by token.
+ */
+void JaRuleWidgetPortTest::testCommands() {
+  MockJaRuleAdaptor::Options options;
+  options.rdm_time = 1000;
+  MockJaRuleAdaptor adaptor(options);
+
+  {
+    JaRuleWidgetPort port(&m_ss, &adaptor, NULL, 1, m_uid, 0);
+    SendCommand(&port, ola::usb::JARULE_CMD_GET_HARDWARE_INFO);
+    SendCommand(&port, ola::usb::JARULE_CMD_RDM_REQUEST);
+    SendCommand(&port, ola::usb::JARULE_CMD_TX_DMX);
+    WaitForResults(3);
+  }
+
+  OLA_ASSERT_EQ(ola::usb::JARULE_CMD_GET_HARDWARE_INFO, m_results[0].command);
+  OLA_ASSERT_EQ(ola::usb::COMMAND_RESULT_OK, m_results[0].result);
+  OLA_ASSERT_EQ(ola::usb::RC_OK, m_results[0].return_code);
+  OLA_ASSERT_EQ(ola::usb::JARULE_CMD_RDM_REQUEST, m_results[1].command);
+  OLA_ASSERT_EQ(ola::usb::COMMAND_RESULT_OK, m_results[1].result);
+  OLA_ASSERT_EQ(ola::usb::RC_RDM_TIMEOUT, m_results[1].return_code);
+  OLA_ASSERT_EQ(ola::usb::JARULE_CMD_TX_DMX, m_results[2].command);
+  OLA_ASSERT_EQ(ola::usb::COMMAND_RESULT_OK, m_results[2].result);
+
+  // All three commands were in flight at once.
+  OLA_ASSERT_EQ(3u, adaptor.CommandCount());
+  OLA_ASSERT_EQ(3u, adaptor.MaxOutstanding());
+}
+
+/*
+ * Check DMX frames don't wait behind queued RDM commands.
+ */
+void JaRuleWidgetPortTest::testDMXPriority() {
+  MockJaRuleAdaptor::Options options;
+  options.rdm_time = 5000;
+  options.dmx_time = 1000;
+  MockJaRuleAdaptor adaptor(options);
+
+  {
+    JaRuleWidgetPort port(&m_ss, &adaptor, NULL, 1, m_uid, 0);
+    for (unsigned int i = 0; i < 8; i++) {
+      SendCommand(&port, ola::usb::JARULE_CMD_RDM_REQUEST);
+    }
+    SendCommand(&port, ola::usb::JARULE_CMD_TX_DMX);
+    WaitForResults(9);
+  }
+
+  // One token is kept for DMX, so the frame is only behind the three RDM
+  // commands already sent to the device.
+  OLA_ASSERT_EQ(ola::usb::JARULE_CMD_TX_DMX, m_results[3].command);
+  OLA_ASSERT_EQ(ola::usb::COMMAND_RESULT_OK, m_results[3].result);
+  OLA_ASSERT_EQ(4u, adaptor.MaxOutstanding());
+}
+
+/*
+ * Check each lane has its own queue limit.
+ */
+void JaRuleWidgetPortTest::testQueueFull() {
+  MockJaRuleAdaptor::Options options;
+  options.rdm_time = 1000000;
+  MockJaRuleAdaptor adaptor(options);
+
+  {
+    JaRuleWidgetPort port(&m_ss, &adaptor, NULL, 1, m_uid, 0);
+    // 3 in flight, 11 queued, the rest are rejected.
+    for (unsigned int i = 0; i < 16; i++) {
+      SendCommand(&port, ola::usb::JARULE_CMD_RDM_REQUEST);
+    }
+    OLA_ASSERT_EQ(static_cast<size_t>(2), m_results.size());
+    OLA_ASSERT_EQ(ola::usb::COMMAND_RESULT_QUEUE_FULL, m_results[0].result);
+    OLA_ASSERT_EQ(ola::usb::COMMAND_RESULT_QUEUE_FULL, m_results[1].result);
+
+    // DMX has its own queue, and a token is kept free for it.
+    SendCommand(&port, ola::usb::JARULE_CMD_TX_DMX);
+    OLA_ASSERT_EQ(static_cast<size_t>(2), m_results.size());
+    OLA_ASSERT_EQ(4u, adaptor.CommandCount());
+
+    port.CancelAll();
+    OLA_ASSERT_EQ(static_cast<size_t>(17), m_results.size());
+    for (unsigned int i = 2; i < m_results.size(); i++) {
+      OLA_ASSERT_EQ(ola::usb::COMMAND_RESULT_CANCELLED, m_results[i].result);
+    }
+  }
+}
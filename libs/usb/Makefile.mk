@@ -27,14 +27,36 @@ libs_usb_libolausb_la_CXXFLAGS = $(COMMON_CXXFLAGS) \
 libs_usb_libolausb_la_LIBADD = $(libusb_LIBS) \
                                common/libolacommon.la
 
+# PROGRAMS
+##################################################
+noinst_PROGRAMS += libs/usb/ja_rule_port_benchmark
+
+libs_usb_ja_rule_port_benchmark_SOURCES = \
+    libs/usb/ja_rule_port_benchmark.cpp \
+    libs/usb/MockJaRuleAdaptor.cpp \
+    libs/usb/MockJaRuleAdaptor.h
+libs_usb_ja_rule_port_benchmark_CXXFLAGS = $(COMMON_CXXFLAGS) \
+                                           $(libusb_CFLAGS)
+libs_usb_ja_rule_port_benchmark_LDADD = $(libusb_LIBS) \
+                                        libs/usb/libolausb.la
+
 # TESTS
 ##################################################
-test_programs += libs/usb/LibUsbThreadTester
+test_programs += libs/usb/JaRuleWidgetPortTester \
+                 libs/usb/LibUsbThreadTester
 
 LIBS_USB_TEST_LDADD = $(COMMON_TESTING_LIBS) \
                       $(libusb_LIBS) \
                       libs/usb/libolausb.la
 
+libs_usb_JaRuleWidgetPortTester_SOURCES = \
+    libs/usb/JaRuleWidgetPortTest.cpp \
+    libs/usb/MockJaRuleAdaptor.cpp \
+    libs/usb/MockJaRuleAdaptor.h
+libs_usb_JaRuleWidgetPortTester_CXXFLAGS = $(COMMON_TESTING_FLAGS) \
+                                           $(libusb_CFLAGS)
+libs_usb_JaRuleWidgetPortTester_LDADD = $(LIBS_USB_TEST_LDADD)
+
 libs_usb_LibUsbThreadTester_SOURCES = \
     libs/usb/LibUsbThreadTest.cpp
 libs_usb_LibUsbThreadTester_CXXFLAGS = $(COMMON_TESTING_FLAGS) \
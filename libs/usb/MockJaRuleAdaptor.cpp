@@ -0,0 +1,241 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * MockJaRuleAdaptor.cpp
+ * A LibUsbAdaptor which simulates a Ja Rule widget.
+ * Copyright (C) 2026 agent
+ */
+
+#include "libs/usb/MockJaRuleAdaptor.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "libs/usb/JaRuleConstants.h"
+
+namespace ola {
+namespace usb {
+
+using ola::io::ByteString;
+using ola::thread::MutexLocker;
+
+namespace {
+const uint8_t SOF_IDENTIFIER = 0x5a;
+const uint8_t EOF_IDENTIFIER = 0xa5;
+const unsigned int MIN_COMMAND_SIZE = 7;
+}  // namespace
+
+MockJaRuleAdaptor::MockJaRuleAdaptor(const Options &options)
+    : m_options(options),
+      m_term(false),
+      m_command_count(0),
+      m_outstanding(0),
+      m_max_outstanding(0) {
+  Start();
+}
+
+MockJaRuleAdaptor::~MockJaRuleAdaptor() {
+  {
+    MutexLocker locker(&m_mutex);
+    m_term = true;
+  }
+  m_cond.Signal();
+  Join();
+}
+
+bool MockJaRuleAdaptor::OpenDevice(OLA_UNUSED libusb_device *usb_device,
+                                   OLA_UNUSED libusb_device_handle **handle) {
+  return false;
+}
+
+bool MockJaRuleAdaptor::OpenDeviceAndClaimInterface(
+    OLA_UNUSED libusb_device *usb_device,
+    OLA_UNUSED int interface,
+    OLA_UNUSED libusb_device_handle **usb_handle) {
+  return false;
+}
+
+void MockJaRuleAdaptor::Close(OLA_UNUSED libusb_device_handle *usb_handle) {}
+
+int MockJaRuleAdaptor::SubmitTransfer(struct libusb_transfer *transfer) {
+  {
+    MutexLocker locker(&m_mutex);
+    if (transfer->endpoint & LIBUSB_ENDPOINT_IN) {
+      m_in_transfers.push_back(transfer);
+    } else {
+      HandleCommand(transfer->buffer, transfer->length);
+      transfer->status = LIBUSB_TRANSFER_COMPLETED;
+      transfer->actual_length = transfer->length;
+
+      TimeStamp now;
+      m_clock.CurrentMonotonicTime(&now);
+      Event event = {COMPLETE_TRANSFER, transfer, ByteString()};
+      AddEvent(now, event);
+    }
+  }
+  m_cond.Signal();
+  return 0;
+}
+
+int MockJaRuleAdaptor::CancelTransfer(struct libusb_transfer *transfer) {
+  {
+    MutexLocker locker(&m_mutex);
+    std::deque<libusb_transfer*>::iterator iter = std::find(
+        m_in_transfers.begin(), m_in_transfers.end(), transfer);
+    if (iter == m_in_transfers.end()) {
+      return LIBUSB_ERROR_NOT_FOUND;
+    }
+    m_in_transfers.erase(iter);
+    transfer->status = LIBUSB_TRANSFER_CANCELLED;
+    transfer->actual_length = 0;
+
+    TimeStamp now;
+    m_clock.CurrentMonotonicTime(&now);
+    Event event = {COMPLETE_TRANSFER, transfer, ByteString()};
+    AddEvent(now, event);
+  }
+  m_cond.Signal();
+  return 0;
+}
+
+unsigned int MockJaRuleAdaptor::CommandCount() const {
+  MutexLocker locker(&m_mutex);
+  return m_command_count;
+}
+
+unsigned int MockJaRuleAdaptor::MaxOutstanding() const {
+  MutexLocker locker(&m_mutex);
+  return m_max_outstanding;
+}
+
+void *MockJaRuleAdaptor::Run() {
+  m_mutex.Lock();
+  while (!m_term) {
+    TimeStamp now;
+    m_clock.CurrentMonotonicTime(&now);
+
+    TransferList completed;
+    while (!m_events.empty() && m_events.begin()->first <= now) {
+      Event event = m_events.begin()->second;
+      m_events.erase(m_events.begin());
+      if (event.type == COMPLETE_TRANSFER) {
+        completed.push_back(event.transfer);
+      } else {
+        m_responses.push_back(event.response);
+        m_outstanding--;
+      }
+    }
+    DeliverResponses(&completed);
+
+    if (!completed.empty()) {
+      // Run the callbacks without the lock, since they may submit more
+      // transfers.
+      m_mutex.Unlock();
+      TransferList::iterator iter = completed.begin();
+      for (; iter != completed.end(); ++iter) {
+        (*iter)->callback(*iter);
+      }
+      m_mutex.Lock();
+      continue;
+    }
+
+    if (m_events.empty()) {
+      m_cond.Wait(&m_mutex);
+    } else {
+      // TimedWait takes a wall clock time.
+      TimeStamp wake_up;
+      m_clock.CurrentRealTime(&wake_up);
+      wake_up += m_events.begin()->first - now;
+      m_cond.TimedWait(&m_mutex, wake_up);
+    }
+  }
+  m_mutex.Unlock();
+  return NULL;
+}
+
+void MockJaRuleAdaptor::HandleCommand(const uint8_t *data,
+                                      unsigned int size) {
+  if (size < MIN_COMMAND_SIZE || data[0] != SOF_IDENTIFIER) {
+    return;
+  }
+
+  const uint8_t token = data[1];
+  const uint16_t command = data[2] | (data[3] << 8);
+
+  unsigned int duration = m_options.command_time;
+  JaRuleReturnCode return_code = RC_OK;
+  switch (command) {
+    case JARULE_CMD_TX_DMX:
+      duration = m_options.dmx_time;
+      break;
+    case JARULE_CMD_RDM_DUB_REQUEST:
+    case JARULE_CMD_RDM_REQUEST:
+    case JARULE_CMD_RDM_BROADCAST_REQUEST:
+      duration = m_options.rdm_time;
+      return_code = RC_RDM_TIMEOUT;
+      break;
+    default:
+      break;
+  }
+
+  m_command_count++;
+  m_outstanding++;
+  m_max_outstanding = std::max(m_max_outstanding, m_outstanding);
+
+  // The device works through the commands one at a time.
+  TimeStamp now;
+  m_clock.CurrentMonotonicTime(&now);
+  if (m_device_free < now) {
+    m_device_free = now;
+  }
+  m_device_free += TimeInterval(static_cast<int64_t>(duration));
+
+  ByteString response;
+  response.push_back(SOF_IDENTIFIER);
+  response.push_back(token);
+  response.push_back(command & 0xff);
+  response.push_back(command >> 8);
+  response.push_back(0);  // payload size
+  response.push_back(0);
+  response.push_back(return_code);
+  response.push_back(0);  // status flags
+  response.push_back(EOF_IDENTIFIER);
+
+  Event event = {SEND_RESPONSE, NULL, response};
+  AddEvent(m_device_free, event);
+}
+
+void MockJaRuleAdaptor::AddEvent(const TimeStamp &when, const Event &event) {
+  m_events.insert(EventMap::value_type(when, event));
+}
+
+void MockJaRuleAdaptor::DeliverResponses(TransferList *completed) {
+  while (!m_responses.empty() && !m_in_transfers.empty()) {
+    libusb_transfer *transfer = m_in_transfers.front();
+    m_in_transfers.pop_front();
+    const ByteString &response = m_responses.front();
+
+    unsigned int size = std::min(static_cast<unsigned int>(response.size()),
+                                 static_cast<unsigned int>(transfer->length));
+    memcpy(transfer->buffer, response.data(), size);
+    transfer->status = LIBUSB_TRANSFER_COMPLETED;
+    transfer->actual_length = size;
+    completed->push_back(transfer);
+    m_responses.pop_front();
+  }
+}
+}  // namespace usb
+}  // namespace ola
@@ -0,0 +1,134 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * MockJaRuleAdaptor.h
+ * A LibUsbAdaptor which simulates a Ja Rule widget.
+ * Copyright (C) 2026 agent
+ */
+
+#ifndef LIBS_USB_MOCKJARULEADAPTOR_H_
+#define LIBS_USB_MOCKJARULEADAPTOR_H_
+
+#include <libusb.h>
+#include <ola/Clock.h>
+#include <ola/base/Macro.h>
+#include <ola/io/ByteString.h>
+#include <ola/thread/Mutex.h>
+#include <ola/thread/Thread.h>
+
+#include <deque>
+#include <map>
+#include <vector>
+
+#include "libs/usb/LibUsbAdaptor.h"
+
+namespace ola {
+namespace usb {
+
+/**
+ * @brief A LibUsbAdaptor which simulates a Ja Rule widget, for testing and
+ * benchmarking without hardware.
+ *
+ * The simulated device handles one command at a time, in the order they
+ * arrive, and takes a fixed time for each type of command. Transfers
+ * complete on an internal thread, as they would on the libusb thread.
+ *
+ * DMX and other commands return RC_OK. RDM requests return RC_RDM_TIMEOUT,
+ * as if there were no responders.
+ */
+class MockJaRuleAdaptor : public BaseLibUsbAdaptor,
+                          private ola::thread::Thread {
+ public:
+  struct Options {
+   public:
+    Options()
+        : dmx_time(0),
+          rdm_time(0),
+          command_time(0) {
+    }
+
+    unsigned int dmx_time;  //!< in microseconds
+    unsigned int rdm_time;  //!< in microseconds
+    unsigned int command_time;  //!< in microseconds
+  };
+
+  explicit MockJaRuleAdaptor(const Options &options);
+  ~MockJaRuleAdaptor();
+
+  bool OpenDevice(libusb_device *usb_device,
+                  libusb_device_handle **usb_handle);
+
+  bool OpenDeviceAndClaimInterface(libusb_device *usb_device,
+                                   int interface,
+                                   libusb_device_handle **usb_handle);
+
+  void Close(libusb_device_handle *usb_handle);
+
+  int SubmitTransfer(struct libusb_transfer *transfer);
+
+  int CancelTransfer(struct libusb_transfer *transfer);
+
+  /**
+   * @brief The number of commands the device has received.
+   */
+  unsigned int CommandCount() const;
+
+  /**
+   * @brief The largest number of commands the device had waiting at once.
+   */
+  unsigned int MaxOutstanding() const;
+
+  void *Run();
+
+ private:
+  typedef enum {
+    COMPLETE_TRANSFER,
+    SEND_RESPONSE,
+  } EventType;
+
+  struct Event {
+    EventType type;
+    libusb_transfer *transfer;
+    ola::io::ByteString response;
+  };
+
+  typedef std::multimap<TimeStamp, Event> EventMap;
+  typedef std::vector<libusb_transfer*> TransferList;
+
+  const Options m_options;
+  ola::Clock m_clock;
+
+  mutable ola::thread::Mutex m_mutex;
+  ola::thread::ConditionVariable m_cond;
+  bool m_term;  // GUARDED_BY(m_mutex);
+  EventMap m_events;  // GUARDED_BY(m_mutex);
+  std::deque<libusb_transfer*> m_in_transfers;  // GUARDED_BY(m_mutex);
+  std::deque<ola::io::ByteString> m_responses;  // GUARDED_BY(m_mutex);
+  TimeStamp m_device_free;  // GUARDED_BY(m_mutex);
+  unsigned int m_command_count;  // GUARDED_BY(m_mutex);
+  unsigned int m_outstanding;  // GUARDED_BY(m_mutex);
+  unsigned int m_max_outstanding;  // GUARDED_BY(m_mutex);
+
+  void HandleCommand(const uint8_t *data,
+                     unsigned int size);  // LOCK_REQUIRED(m_mutex);
+  void AddEvent(const TimeStamp &when,
+                const Event &event);  // LOCK_REQUIRED(m_mutex);
+  void DeliverResponses(TransferList *completed);  // LOCK_REQUIRED(m_mutex);
+
+  DISALLOW_COPY_AND_ASSIGN(MockJaRuleAdaptor);
+};
+}  // namespace usb
+}  // namespace ola
+#endif  // LIBS_USB_MOCKJARULEADAPTOR_H_
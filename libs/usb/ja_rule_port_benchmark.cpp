@@ -0,0 +1,189 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * ja_rule_port_benchmark.cpp
+ * Measure the DMX and RDM throughput of a JaRuleWidgetPort using a mock
+ * adaptor, so no hardware is required.
+ * Copyright (C) 2026 agent
+ */
+
+#include <libusb.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+
+#include "libs/usb/JaRuleConstants.h"
+#include "libs/usb/JaRuleWidgetPort.h"
+#include "libs/usb/MockJaRuleAdaptor.h"
+#include "ola/Callback.h"
+#include "ola/Clock.h"
+#include "ola/Constants.h"
+#include "ola/Logging.h"
+#include "ola/base/Flags.h"
+#include "ola/base/Init.h"
+#include "ola/base/Macro.h"
+#include "ola/io/ByteString.h"
+#include "ola/io/SelectServer.h"
+#include "ola/rdm/UID.h"
+
+using ola::TimeInterval;
+using ola::TimeStamp;
+using ola::io::ByteString;
+using ola::io::SelectServer;
+using ola::usb::JaRuleReturnCode;
+using ola::usb::JaRuleWidgetPort;
+using ola::usb::MockJaRuleAdaptor;
+using ola::usb::USBCommandResult;
+using std::cout;
+using std::endl;
+
+DEFINE_uint32(dmx_time, 1000, "The time the device takes to send a DMX "
+              "frame, in microseconds");
+DEFINE_uint32(rdm_time, 20000, "The time the device takes to complete an "
+              "RDM request, in microseconds");
+DEFINE_s_uint32(duration, d, 5, "The number of seconds to run for");
+DEFINE_s_uint32(rdm_outstanding, r, 2, "The number of RDM requests to keep "
+                "outstanding");
+
+namespace {
+
+/*
+ * Keeps a DMX frame and a number of RDM requests outstanding on a port.
+ */
+class PortLoader {
+ public:
+  explicit PortLoader(JaRuleWidgetPort *port)
+      : m_port(port),
+        m_running(true),
+        m_dmx_frames(0),
+        m_rdm_requests(0),
+        m_errors(0) {
+    std::fill(m_dmx, m_dmx + ola::DMX_UNIVERSE_SIZE, 0);
+    std::fill(m_rdm, m_rdm + sizeof(m_rdm), 0);
+  }
+
+  void Start(unsigned int rdm_outstanding) {
+    m_clock.CurrentMonotonicTime(&m_last_dmx);
+    SendDMX();
+    for (unsigned int i = 0; i < rdm_outstanding; i++) {
+      SendRDM();
+    }
+  }
+
+  void Stop() { m_running = false; }
+
+  unsigned int DMXFrames() const { return m_dmx_frames; }
+  unsigned int RDMRequests() const { return m_rdm_requests; }
+  unsigned int Errors() const { return m_errors; }
+  const TimeInterval &MaxDMXGap() const { return m_max_dmx_gap; }
+
+ private:
+  ola::Clock m_clock;
+  JaRuleWidgetPort *m_port;
+  bool m_running;
+  unsigned int m_dmx_frames;
+  unsigned int m_rdm_requests;
+  unsigned int m_errors;
+  TimeStamp m_last_dmx;
+  TimeInterval m_max_dmx_gap;
+  uint8_t m_dmx[ola::DMX_UNIVERSE_SIZE];
+  uint8_t m_rdm[26];
+
+  void SendDMX() {
+    m_port->SendCommand(
+        ola::usb::JARULE_CMD_TX_DMX, m_dmx, sizeof(m_dmx),
+        ola::NewSingleCallback(this, &PortLoader::DMXComplete));
+  }
+
+  void SendRDM() {
+    m_port->SendCommand(
+        ola::usb::JARULE_CMD_RDM_REQUEST, m_rdm, sizeof(m_rdm),
+        ola::NewSingleCallback(this, &PortLoader::RDMComplete));
+  }
+
+  void DMXComplete(USBCommandResult result, JaRuleReturnCode,
+                   uint8_t, const ByteString&) {
+    if (!m_running) {
+      return;
+    }
+    if (result != ola::usb::COMMAND_RESULT_OK) {
+      m_errors++;
+    }
+    m_dmx_frames++;
+
+    TimeStamp now;
+    m_clock.CurrentMonotonicTime(&now);
+    m_max_dmx_gap = std::max(m_max_dmx_gap, now - m_last_dmx);
+    m_last_dmx = now;
+    SendDMX();
+  }
+
+  void RDMComplete(USBCommandResult result, JaRuleReturnCode,
+                   uint8_t, const ByteString&) {
+    if (!m_running) {
+      return;
+    }
+    if (result != ola::usb::COMMAND_RESULT_OK) {
+      m_errors++;
+    }
+    m_rdm_requests++;    SendRDM();
+  }
+
+  DISALLOW_COPY_AND_ASSIGN(PortLoader);
+};
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  ola::AppInit(&argc, argv, "",
+               "Send DMX and RDM to a Ja Rule port backed by a mock device.");
+
+  MockJaRuleAdaptor::Options options;
+  options.dmx_time = FLAGS_dmx_time;
+  options.rdm_time = FLAGS_rdm_time;
+  MockJaRuleAdaptor adaptor(options);
+
+  SelectServer ss;
+  ola::Clock clock;
+  TimeStamp start, end;
+  {
+    JaRuleWidgetPort port(&ss, &adaptor, NULL, 1, ola::rdm::UID(0x7a70, 1),
+                          0);
+    PortLoader loader(&port);
+
+    clock.CurrentMonotonicTime(&start);
+    loader.Start(FLAGS_rdm_outstanding);
+    ss.RegisterSingleTimeout(
+        FLAGS_duration * 1000,
+        ola::NewSingleCallback(&ss, &SelectServer::Terminate));
+    ss.Run();
+    clock.CurrentMonotonicTime(&end);
+
+    loader.Stop();
+    port.CancelAll();
+
+    double seconds = (end - start).InMilliSeconds() / 1000.0;
+    cout << std::fixed << std::setprecision(1)
+         << "DMX frames/s:     " << loader.DMXFrames() / seconds << endl
+         << "Max DMX gap (ms): "
+         << loader.MaxDMXGap().AsInt() / 1000.0 << endl
+         << "RDM requests/s:   " << loader.RDMRequests() / seconds << endl
+         << "Errors:           " << loader.Errors() << endl
+         << "Max commands outstanding on the device: "
+         << adaptor.MaxOutstanding() << endl;
+  }
+  return 0;
+}
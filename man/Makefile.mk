@@ -14,6 +14,7 @@ dist_man_MANS += \
     man/ola_recorder.1 \
     man/ola_set_dmx.1 \
     man/ola_set_priority.1 \
+    man/ola_signal_decoder.1 \
     man/ola_streaming_client.1 \
     man/ola_timecode.1 \
     man/ola_trigger.1 \
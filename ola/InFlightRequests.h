@@ -0,0 +1,188 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * InFlightRequests.h
+ * Tracks the callbacks waiting on identical outstanding requests.
+ * Copyright (C) 2026 agent
+ */
+
+#ifndef OLA_INFLIGHTREQUESTS_H_
+#define OLA_INFLIGHTREQUESTS_H_
+
+#include <map>
+#include <vector>
+
+#include "ola/base/Macro.h"
+
+namespace ola {
+namespace client {
+
+/**
+ * @brief Identifies a request sent to the server.
+ */
+typedef unsigned int InFlightRequestId;
+
+/**
+ * @brief Groups the callbacks of requests that share a key.
+ *
+ * Only the first request for a key needs to be sent to the server, any
+ * requests for the same key that arrive before the response are added to the
+ * waiting list and run when the response arrives.
+ *
+ * Each request sent to the server is given a RequestId, which the completion
+ * handler uses to find the waiting callbacks. A request can be detached from
+ * its key, for instance once a write has made its response stale. A detached
+ * request still runs the callbacks already waiting on it, but new callers for
+ * the key will send a fresh request.
+ */
+template <typename Key, typename CallbackType>
+class InFlightRequests {
+ public:
+  typedef InFlightRequestId RequestId;
+  typedef std::vector<CallbackType*> Callbacks;
+
+  InFlightRequests() : m_next_id(0) {}
+  ~InFlightRequests() { Clear(); }
+
+  /**
+   * @brief Add a callback for a request.
+   * @param key the key of the request.
+   * @param callback the callback to run once the request completes, may be
+   *   NULL.
+   * @param[out] request_id the id of the request the callback is waiting on.
+   * @returns true if this is the first request for the key, in which case the
+   *   caller should send the request.
+   */
+  bool Add(const Key &key, CallbackType *callback, RequestId *request_id) {
+    typename JoinableMap::iterator iter = m_joinable.find(key);
+    if (iter != m_joinable.end()) {
+      *request_id = iter->second;
+      m_requests.find(*request_id)->second.callbacks.push_back(callback);
+      return false;
+    }
+
+    *request_id = m_next_id++;
+    m_joinable.insert(typename JoinableMap::value_type(key, *request_id));
+    typename RequestMap::iterator request_iter = m_requests.insert(
+        typename RequestMap::value_type(*request_id, Request(key))).first;
+    request_iter->second.callbacks.push_back(callback);
+    return true;
+  }
+
+  /**
+   * @brief Stop new callers joining the outstanding request for a key.
+   * @param key the key of the request.
+   */
+  void Detach(const Key &key) {
+    m_joinable.erase(key);
+  }
+
+  /**
+   * @brief Detach the outstanding requests whose keys match a predicate.
+   * @param predicate a functor taking a const Key&, returning true if the
+   *   request should be detached.
+   */
+  template <typename Predicate>
+  void DetachIf(Predicate predicate) {
+    typename JoinableMap::iterator iter = m_joinable.begin();
+    while (iter != m_joinable.end()) {
+      if (predicate(iter->first)) {
+        m_joinable.erase(iter++);
+      } else {
+        ++iter;
+      }
+    }
+  }
+
+  /**
+   * @brief Detach all outstanding requests.
+   */
+  void DetachAll() {
+    m_joinable.clear();
+  }
+
+  /**
+   * @brief Remove the callbacks waiting on a request.
+   * @param request_id the id of the request that completed.
+   * @param[out] callbacks the callbacks to run. Ownership is transferred. This
+   *   is left empty if the request has already been removed.
+   */
+  void Remove(RequestId request_id, Callbacks *callbacks) {
+    typename RequestMap::iterator iter = m_requests.find(request_id);
+    if (iter == m_requests.end()) {
+      return;
+    }
+    typename JoinableMap::iterator joinable_iter = m_joinable.find(
+        iter->second.key);
+    if (joinable_iter != m_joinable.end() &&
+        joinable_iter->second == request_id) {
+      m_joinable.erase(joinable_iter);
+    }
+    callbacks->swap(iter->second.callbacks);
+    m_requests.erase(iter);
+  }
+
+  /**
+   * @brief Remove the callbacks waiting on all outstanding requests.
+   * @param[out] callbacks the callbacks to run. Ownership is transferred.
+   */
+  void RemoveAll(Callbacks *callbacks) {
+    typename RequestMap::iterator iter = m_requests.begin();
+    for (; iter != m_requests.end(); ++iter) {
+      callbacks->insert(callbacks->end(), iter->second.callbacks.begin(),
+                        iter->second.callbacks.end());
+    }
+    m_requests.clear();
+    m_joinable.clear();
+  }
+
+  /**
+   * @brief Delete any callbacks that are still waiting.
+   */
+  void Clear() {
+    Callbacks callbacks;
+    RemoveAll(&callbacks);
+    typename Callbacks::iterator iter = callbacks.begin();
+    for (; iter != callbacks.end(); ++iter) {
+      delete *iter;
+    }
+  }
+
+  /**
+   * @brief The number of distinct requests outstanding, including detached
+   *   ones.
+   */
+  unsigned int Size() const { return m_requests.size(); }
+
+ private:
+  struct Request {
+    Key key;
+    Callbacks callbacks;
+
+    explicit Request(const Key &_key) : key(_key) {}
+  };
+
+  typedef std::map<Key, RequestId> JoinableMap;
+  typedef std::map<RequestId, Request> RequestMap;
+
+  RequestId m_next_id;
+  JoinableMap m_joinable;
+  RequestMap m_requests;
+
+  DISALLOW_COPY_AND_ASSIGN(InFlightRequests);
+};
+}  // namespace client
+}  // namespace ola
+#endif  // OLA_INFLIGHTREQUESTS_H_
@@ -20,6 +20,7 @@ ola_libola_la_SOURCES = \
     ola/ClientRDMAPIShim.cpp \
     ola/ClientTypesFactory.h \
     ola/ClientTypesFactory.cpp \
+    ola/InFlightRequests.h \
     ola/Module.cpp \
     ola/OlaCallbackClient.cpp \
     ola/OlaClient.cpp \
@@ -35,9 +36,10 @@ ola_libola_la_LIBADD = common/libolacommon.la
 ##################################################
 test_programs += ola/OlaClientTester
 
-ola_OlaClientTester_SOURCES = ola/OlaClientWrapperTest.cpp \
+ola_OlaClientTester_SOURCES = ola/OlaClientCoreTest.cpp \
+                              ola/OlaClientWrapperTest.cpp \
                               ola/StreamingClientTest.cpp
-ola_OlaClientTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
+ola_OlaClientTester_CXXFLAGS = $(COMMON_TESTING_PROTOBUF_FLAGS)
 ola_OlaClientTester_LDADD = $(COMMON_TESTING_LIBS) \
                             $(PLUGIN_LIBS) \
                             common/libolacommon.la \
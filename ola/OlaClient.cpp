@@ -168,6 +168,11 @@ void OlaClient::FetchDMX(unsigned int universe, DMXCallback *callback) {
   m_core->FetchDMX(universe, callback);
 }
 
+void OlaClient::FetchDMX(const vector<unsigned int> &universes,
+                         MultipleDMXCallback *callback) {
+  m_core->FetchDMX(universes, callback);
+}
+
 void OlaClient::RunDiscovery(unsigned int universe,
                              DiscoveryType discovery_type,
                              DiscoveryCallback *callback) {
@@ -24,6 +24,7 @@
 #include <sys/types.h>
 
 #include <algorithm>
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -50,14 +51,110 @@ using ola::rdm::UIDSet;
 using ola::rpc::RpcChannel;
 using ola::rpc::RpcController;
 using std::auto_ptr;
+using std::map;
 using std::string;
 using std::vector;
 
 const char OlaClientCore::NOT_CONNECTED_ERROR[] = "Not connected";
+// The error the RpcChannel returns if the server doesn't know the method.
+const char OlaClientCore::NOT_IMPLEMENTED_ERROR[] = "Not Implemented";
+
+/*
+ * Gathers the responses from the individual GetDmx() requests used when the
+ * server doesn't support GetDmxList(). This deletes itself once all the
+ * responses have arrived.
+ */
+class OlaClientCore::DMXListCollector {
+ public:
+  DMXListCollector(unsigned int outstanding, MultipleDMXCallback *callback)
+      : m_outstanding(outstanding),
+        m_callback(callback) {
+  }
+
+  void Fetched(unsigned int universe,
+               const Result &result,
+               const DMXMetadata&,
+               const DmxBuffer &buffer) {
+    if (result.Success()) {
+      m_data[universe] = buffer;
+    } else if (m_error.empty()) {
+      m_error = result.Error();
+    }
+
+    if (--m_outstanding == 0) {
+      // Like GetDmxList(), failed universes are left out. It's only an error
+      // if nothing was returned.
+      Result overall_result(m_data.empty() ? m_error : "");
+      m_callback->Run(overall_result, m_data);
+      delete this;
+    }
+  }
+
+ private:
+  unsigned int m_outstanding;
+  MultipleDMXCallback *m_callback;
+  map<unsigned int, DmxBuffer> m_data;
+  string m_error;
+};
+
+/*
+ * Matches the multi-universe DMX fetches that include a universe. The keys are
+ * sorted.
+ */
+class OlaClientCore::ListContainsUniverse {
+ public:
+  explicit ListContainsUniverse(unsigned int universe) : m_universe(universe) {}
+
+  bool operator()(const vector<unsigned int> &universes) const {
+    return std::binary_search(universes.begin(), universes.end(), m_universe);
+  }
+
+ private:
+  unsigned int m_universe;
+};
+
+/*
+ * Matches the RDM GETs that a SET to a UID could change.
+ */
+class OlaClientCore::RDMGetToResponder {
+ public:
+  RDMGetToResponder(unsigned int universe, const UID &uid)
+      : m_universe(universe),
+        m_uid(uid) {
+  }
+
+  bool operator()(const RDMGetKey &key) const {
+    return key.universe == m_universe && m_uid.DirectedToUID(key.uid);
+  }
+
+ private:
+  unsigned int m_universe;
+  UID m_uid;
+};
+
+bool OlaClientCore::RDMGetKey::operator<(const RDMGetKey &other) const {
+  if (universe != other.universe) {
+    return universe < other.universe;
+  }
+  if (uid != other.uid) {
+    return uid < other.uid;
+  }
+  if (sub_device != other.sub_device) {
+    return sub_device < other.sub_device;
+  }
+  if (pid != other.pid) {
+    return pid < other.pid;
+  }
+  if (include_raw_frames != other.include_raw_frames) {
+    return include_raw_frames < other.include_raw_frames;
+  }
+  return data < other.data;
+}
 
 OlaClientCore::OlaClientCore(ConnectedDescriptor *descriptor)
     : m_descriptor(descriptor),
-      m_connected(false) {
+      m_connected(false),
+      m_dmx_list_supported(true) {
 }
 
 
@@ -88,7 +185,11 @@ bool OlaClientCore::Setup() {
     m_channel.reset();
     return false;
   }
+  m_channel->SetChannelCloseHandler(NewSingleCallback(
+      this, &OlaClientCore::ChannelClosed,
+      static_cast<ClosedCallback*>(NULL)));
   m_connected = true;
+  m_dmx_list_supported = true;
   return true;
 }
 
@@ -104,6 +205,8 @@ bool OlaClientCore::Stop() {
     m_stub.reset();
   }
   m_connected = false;
+  // The responses for these won't arrive now the channel has gone.
+  ClearInFlightRequests();
   return 0;
 }
 
@@ -111,12 +214,9 @@ bool OlaClientCore::Stop() {
  * Set the close handler.
  */
 void OlaClientCore::SetCloseHandler(ClosedCallback *callback) {
-  if (callback) {
-    m_channel->SetChannelCloseHandler(
-        NewSingleCallback(this, &OlaClientCore::ChannelClosed, callback));
-  } else {
-    m_channel->SetChannelCloseHandler(NULL);
-  }
+  // The handler is always installed, so the in-flight requests can be failed.
+  m_channel->SetChannelCloseHandler(
+      NewSingleCallback(this, &OlaClientCore::ChannelClosed, callback));
 }
 
 void OlaClientCore::SetDMXCallback(RepeatableDMXCallback *callback) {
@@ -124,6 +224,7 @@ void OlaClientCore::SetDMXCallback(RepeatableDMXCallback *callback) {
 }
 
 void OlaClientCore::ReloadPlugins(SetCallback *callback) {
+  m_device_fetches.DetachAll();
   ola::proto::PluginReloadRequest request;
   RpcController *controller = new RpcController();
   ola::proto::Ack *reply = new ola::proto::Ack();
@@ -202,6 +303,13 @@ void OlaClientCore::FetchPluginState(
 
 void OlaClientCore::FetchDeviceInfo(ola_plugin_id filter,
                                     DeviceInfoCallback *callback) {
+  InFlightRequestId request_id;
+  if (!m_device_fetches.Add(filter, callback, &request_id)) {
+    return;
+  }
+  callback = NewSingleCallback(this, &OlaClientCore::DeviceInfoFetched,
+                               request_id);
+
   ola::proto::DeviceInfoRequest request;
   RpcController *controller = new RpcController();
   ola::proto::DeviceInfoReply *reply = new ola::proto::DeviceInfoReply();
@@ -238,6 +346,8 @@ void OlaClientCore::ConfigureDevice(
   RpcController *controller = new RpcController();
   ola::proto::DeviceConfigReply *reply = new ola::proto::DeviceConfigReply();
 
+  m_device_fetches.DetachAll();
+
   string configure_request;
   request.set_device_alias(device_alias);
   request.set_data(msg);
@@ -261,6 +371,8 @@ void OlaClientCore::SetPluginState(ola_plugin_id plugin_id,
   RpcController *controller = new RpcController();
   ola::proto::Ack *reply = new ola::proto::Ack();
 
+  m_device_fetches.DetachAll();
+
   request.set_plugin_id(plugin_id);
   request.set_enabled(state);
 
@@ -289,6 +401,8 @@ void OlaClientCore::SetPortPriorityInherit(unsigned int device_alias,
   request.set_is_output(port_direction == OUTPUT_PORT);
   request.set_priority_mode(ola::PRIORITY_MODE_INHERIT);
 
+  m_device_fetches.DetachAll();
+
   if (m_connected) {
     CompletionCallback *cb = ola::NewSingleCallback(
         this,
@@ -316,6 +430,8 @@ void OlaClientCore::SetPortPriorityOverride(unsigned int device_alias,
   request.set_priority_mode(ola::PRIORITY_MODE_STATIC);
   request.set_priority(value);
 
+  m_device_fetches.DetachAll();
+
   if (m_connected) {
     CompletionCallback *cb = ola::NewSingleCallback(
         this,
@@ -347,6 +463,13 @@ void OlaClientCore::FetchUniverseList(UniverseListCallback *callback) {
 
 void OlaClientCore::FetchUniverseInfo(unsigned int universe_id,
                                       UniverseInfoCallback *callback) {
+  InFlightRequestId request_id;
+  if (!m_universe_fetches.Add(universe_id, callback, &request_id)) {
+    return;
+  }
+  callback = NewSingleCallback(this, &OlaClientCore::UniverseInfoFetched,
+                               request_id);
+
   RpcController *controller = new RpcController();
   ola::proto::OptionalUniverseRequest request;
   ola::proto::UniverseInfoReply *reply = new ola::proto::UniverseInfoReply();
@@ -375,6 +498,9 @@ void OlaClientCore::SetUniverseName(unsigned int universe,
   request.set_universe(universe);
   request.set_name(name);
 
+  // A fetch that's already been sent may return the old name.
+  m_universe_fetches.Detach(universe);
+
   if (m_connected) {
     CompletionCallback *cb = ola::NewSingleCallback(
         this,
@@ -399,6 +525,8 @@ void OlaClientCore::SetUniverseMergeMode(unsigned int universe,
   request.set_universe(universe);
   request.set_merge_mode(merge_mode);
 
+  m_universe_fetches.Detach(universe);
+
   if (m_connected) {
     CompletionCallback *cb = ola::NewSingleCallback(
         this,
@@ -429,6 +557,10 @@ void OlaClientCore::Patch(unsigned int device_alias,
   request.set_is_output(port_direction == OUTPUT_PORT);
   request.set_action(action);
 
+  // Patching changes the ports of both the universes and the devices.
+  m_universe_fetches.DetachAll();
+  m_device_fetches.DetachAll();
+
   if (m_connected) {
     CompletionCallback *cb = ola::NewSingleCallback(
         this,
@@ -474,6 +606,11 @@ void OlaClientCore::SendDMX(unsigned int universe,
   request.set_data(data.Get());
   request.set_priority(args.priority);
 
+  // Fetches already sent may return the old data, later ones need to be sent
+  // after this update.
+  m_dmx_fetches.Detach(universe);
+  m_dmx_list_fetches.DetachIf(ListContainsUniverse(universe));
+
   if (args.callback) {
     // Full request
     RpcController *controller = new RpcController();
@@ -497,6 +634,12 @@ void OlaClientCore::SendDMX(unsigned int universe,
 
 void OlaClientCore::FetchDMX(unsigned int universe,
                              DMXCallback *callback) {
+  InFlightRequestId request_id;
+  if (!m_dmx_fetches.Add(universe, callback, &request_id)) {
+    return;
+  }
+  callback = NewSingleCallback(this, &OlaClientCore::DMXFetched, request_id);
+
   ola::proto::UniverseRequest request;
   RpcController *controller = new RpcController();
   ola::proto::DmxData *reply = new ola::proto::DmxData();
@@ -515,6 +658,44 @@ void OlaClientCore::FetchDMX(unsigned int universe,
   }
 }
 
+void OlaClientCore::FetchDMX(const vector<unsigned int> &universes,
+                             MultipleDMXCallback *callback) {
+  vector<unsigned int> key(universes);
+  std::sort(key.begin(), key.end());
+  key.erase(std::unique(key.begin(), key.end()), key.end());
+
+  InFlightRequestId request_id;
+  if (!m_dmx_list_fetches.Add(key, callback, &request_id)) {
+    return;
+  }
+
+  if (!m_connected) {
+    DMXListFetched(request_id, Result(NOT_CONNECTED_ERROR),
+                   map<unsigned int, DmxBuffer>());
+    return;
+  }
+
+  if (!m_dmx_list_supported) {
+    FetchDMXIndividually(request_id, key);
+    return;
+  }
+
+  ola::proto::UniverseListRequest request;
+  RpcController *controller = new RpcController();
+  ola::proto::DmxDataList *reply = new ola::proto::DmxDataList();
+
+  vector<unsigned int>::const_iterator iter = key.begin();
+  for (; iter != key.end(); ++iter) {
+    request.add_universe(*iter);
+  }
+
+  CompletionCallback *cb = NewSingleCallback(
+      this,
+      &OlaClientCore::HandleGetDmxList,
+      controller, reply, request_id, key);
+  m_stub->GetDmxList(controller, &request, reply, cb);
+}
+
 void OlaClientCore::RunDiscovery(unsigned int universe,
                                  DiscoveryType discovery_type,
                                  DiscoveryCallback *callback) {
@@ -641,7 +822,152 @@ void OlaClientCore::UpdateDmxData(ola::rpc::RpcController*,
 
 void OlaClientCore::ChannelClosed(ClosedCallback *callback,
                                   OLA_UNUSED ola::rpc::RpcSession *session) {
-  callback->Run();
+  // The responses for the in-flight requests won't arrive now.
+  FailInFlightRequests("Connection closed");
+  if (callback) {
+    callback->Run();
+  }
+}
+
+void OlaClientCore::ClearInFlightRequests() {
+  m_dmx_fetches.Clear();
+  m_dmx_list_fetches.Clear();
+  m_universe_fetches.Clear();
+  m_device_fetches.Clear();
+  m_rdm_gets.Clear();
+}
+
+void OlaClientCore::FailInFlightRequests(const string &error) {
+  const Result result(error);
+
+  // The multi-universe fetches go first, since failing the single universe
+  // fetches completes any that fell back to GetDmx().
+  InFlightRequests<vector<unsigned int>, MultipleDMXCallback>::Callbacks
+      dmx_list_callbacks;
+  m_dmx_list_fetches.RemoveAll(&dmx_list_callbacks);
+  for (unsigned int i = 0; i < dmx_list_callbacks.size(); i++) {
+    if (dmx_list_callbacks[i]) {
+      dmx_list_callbacks[i]->Run(result, map<unsigned int, DmxBuffer>());
+    }
+  }
+
+  InFlightRequests<unsigned int, DMXCallback>::Callbacks dmx_callbacks;
+  m_dmx_fetches.RemoveAll(&dmx_callbacks);
+  for (unsigned int i = 0; i < dmx_callbacks.size(); i++) {
+    if (dmx_callbacks[i]) {
+      dmx_callbacks[i]->Run(result, DMXMetadata(0), DmxBuffer());
+    }
+  }
+
+  const OlaUniverse null_universe(0, OlaUniverse::MERGE_LTP, "",
+                                  vector<OlaInputPort>(),
+                                  vector<OlaOutputPort>(), 0);
+  InFlightRequests<unsigned int, UniverseInfoCallback>::Callbacks
+      universe_callbacks;
+  m_universe_fetches.RemoveAll(&universe_callbacks);
+  for (unsigned int i = 0; i < universe_callbacks.size(); i++) {
+    if (universe_callbacks[i]) {
+      universe_callbacks[i]->Run(result, null_universe);
+    }
+  }
+
+  InFlightRequests<ola_plugin_id, DeviceInfoCallback>::Callbacks
+      device_callbacks;
+  m_device_fetches.RemoveAll(&device_callbacks);
+  for (unsigned int i = 0; i < device_callbacks.size(); i++) {
+    if (device_callbacks[i]) {
+      device_callbacks[i]->Run(result, vector<OlaDevice>());
+    }
+  }
+
+  InFlightRequests<RDMGetKey, RDMCallback>::Callbacks rdm_callbacks;
+  m_rdm_gets.RemoveAll(&rdm_callbacks);
+  for (unsigned int i = 0; i < rdm_callbacks.size(); i++) {
+    rdm_callbacks[i]->Run(result, RDMMetadata(), NULL);
+  }
+}
+
+// The following run the callbacks waiting on a coalesced request. The waiting
+// callbacks are removed before they're run, so a callback can issue the same
+// request again.
+
+void OlaClientCore::DeviceInfoFetched(InFlightRequestId request_id,
+                                      const Result &result,
+                                      const vector<OlaDevice> &devices) {
+  InFlightRequests<ola_plugin_id, DeviceInfoCallback>::Callbacks callbacks;
+  m_device_fetches.Remove(request_id, &callbacks);
+  for (unsigned int i = 0; i < callbacks.size(); i++) {
+    if (callbacks[i]) {
+      callbacks[i]->Run(result, devices);
+    }
+  }
+}
+
+void OlaClientCore::UniverseInfoFetched(InFlightRequestId request_id,
+                                        const Result &result,
+                                        const OlaUniverse &universe_info) {
+  InFlightRequests<unsigned int, UniverseInfoCallback>::Callbacks callbacks;
+  m_universe_fetches.Remove(request_id, &callbacks);
+  for (unsigned int i = 0; i < callbacks.size(); i++) {
+    if (callbacks[i]) {
+      callbacks[i]->Run(result, universe_info);
+    }
+  }
+}
+
+void OlaClientCore::DMXFetched(InFlightRequestId request_id,
+                               const Result &result,
+                               const DMXMetadata &metadata,
+                               const DmxBuffer &buffer) {
+  InFlightRequests<unsigned int, DMXCallback>::Callbacks callbacks;
+  m_dmx_fetches.Remove(request_id, &callbacks);
+  for (unsigned int i = 0; i < callbacks.size(); i++) {
+    if (callbacks[i]) {
+      callbacks[i]->Run(result, metadata, buffer);
+    }
+  }
+}
+
+void OlaClientCore::DMXListFetched(InFlightRequestId request_id,
+                                   const Result &result,
+                                   const map<unsigned int, DmxBuffer> &data) {
+  InFlightRequests<vector<unsigned int>, MultipleDMXCallback>::Callbacks
+      callbacks;
+  m_dmx_list_fetches.Remove(request_id, &callbacks);
+  for (unsigned int i = 0; i < callbacks.size(); i++) {
+    if (callbacks[i]) {
+      callbacks[i]->Run(result, data);
+    }
+  }
+}
+
+void OlaClientCore::RDMGetCompleted(InFlightRequestId request_id,
+                                    const Result &result,
+                                    const RDMMetadata &metadata,
+                                    const ola::rdm::RDMResponse *response) {
+  InFlightRequests<RDMGetKey, RDMCallback>::Callbacks callbacks;
+  m_rdm_gets.Remove(request_id, &callbacks);
+  for (unsigned int i = 0; i < callbacks.size(); i++) {
+    callbacks[i]->Run(result, metadata, response);
+  }
+}
+
+void OlaClientCore::FetchDMXIndividually(
+    InFlightRequestId request_id,
+    const vector<unsigned int> &universes) {
+  if (universes.empty()) {
+    DMXListFetched(request_id, Result(""), map<unsigned int, DmxBuffer>());
+    return;
+  }
+
+  DMXListCollector *collector = new DMXListCollector(
+      universes.size(),
+      NewSingleCallback(this, &OlaClientCore::DMXListFetched, request_id));
+  vector<unsigned int>::const_iterator iter = universes.begin();
+  for (; iter != universes.end(); ++iter) {
+    FetchDMX(*iter, NewSingleCallback(collector, &DMXListCollector::Fetched,
+                                      *iter));
+  }
 }
 
 
@@ -886,6 +1212,33 @@ void OlaClientCore::HandleGetDmx(RpcController *controller_ptr,
   callback->Run(result, metadata, buffer);
 }
 
+void OlaClientCore::HandleGetDmxList(RpcController *controller_ptr,
+                                     ola::proto::DmxDataList *reply_ptr,
+                                     InFlightRequestId request_id,
+                                     vector<unsigned int> universes) {
+  auto_ptr<RpcController> controller(controller_ptr);
+  auto_ptr<ola::proto::DmxDataList> reply(reply_ptr);
+
+  if (controller->Failed() &&
+      controller->ErrorText() == NOT_IMPLEMENTED_ERROR) {
+    OLA_INFO << "olad doesn't support GetDmxList, falling back to GetDmx";
+    m_dmx_list_supported = false;
+    FetchDMXIndividually(request_id, universes);
+    return;
+  }
+
+  Result result(controller->Failed() ? controller->ErrorText() : "");
+  map<unsigned int, DmxBuffer> data;
+
+  if (!controller->Failed()) {
+    for (int i = 0; i < reply->data_size(); ++i) {
+      const ola::proto::DmxData &dmx_data = reply->data(i);
+      data[dmx_data.universe()].Set(dmx_data.data());
+    }
+  }
+  DMXListFetched(request_id, result, data);
+}
+
 void OlaClientCore::HandleUIDList(RpcController *controller_ptr,
                                   ola::proto::UIDListReply *reply_ptr,
                                   DiscoveryCallback *callback) {
@@ -982,12 +1335,31 @@ void OlaClientCore::SendRDMCommand(bool is_set,
     return;
   }
 
+  const string param_data(reinterpret_cast<const char*>(data), data_length);
+  RDMCallback *callback = args.callback;
+
+  // Identical GETs share a request. QUEUED_MESSAGE is excluded since each GET
+  // returns a different message. A SET may change what the GETs already sent
+  // to the responder return, so later GETs are sent after it.
+  if (is_set) {
+    m_rdm_gets.DetachIf(RDMGetToResponder(universe, uid));
+  } else if (pid != ola::rdm::PID_QUEUED_MESSAGE) {
+    RDMGetKey key(universe, uid, sub_device, pid, param_data,
+                  args.include_raw_frames);
+    InFlightRequestId request_id;
+    if (!m_rdm_gets.Add(key, callback, &request_id)) {
+      return;
+    }
+    callback = NewSingleCallback(this, &OlaClientCore::RDMGetCompleted,
+                                 request_id);
+  }
+
   RpcController *controller = new RpcController();
   ola::proto::RDMResponse *reply = new ola::proto::RDMResponse();
 
   if (!m_connected) {
     controller->SetFailed(NOT_CONNECTED_ERROR);
-    HandleRDM(controller, reply, args.callback);
+    HandleRDM(controller, reply, callback);
     return;
   }
 
@@ -999,7 +1371,7 @@ void OlaClientCore::SendRDMCommand(bool is_set,
   request.set_sub_device(sub_device);
   request.set_param_id(pid);
   request.set_is_set(is_set);
-  request.set_data(string(reinterpret_cast<const char*>(data), data_length));
+  request.set_data(param_data);
 
   if (args.include_raw_frames) {
     request.set_include_raw_response(true);
@@ -1008,7 +1380,7 @@ void OlaClientCore::SendRDMCommand(bool is_set,
   CompletionCallback *cb = NewSingleCallback(
       this,
       &OlaClientCore::HandleRDM,
-      controller, reply, args.callback);
+      controller, reply, callback);
 
   m_stub->RDMCommand(controller, &request, reply, cb);
 }
@@ -21,8 +21,10 @@
 #ifndef OLA_OLACLIENTCORE_H_
 #define OLA_OLACLIENTCORE_H_
 
+#include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "common/protocol/Ola.pb.h"
 #include "common/protocol/OlaService.pb.h"
@@ -30,6 +32,7 @@
 #include "common/rpc/RpcController.h"
 #include "ola/Callback.h"
 #include "ola/DmxBuffer.h"
+#include "ola/InFlightRequests.h"
 #include "ola/client/CallbackTypes.h"
 #include "ola/client/ClientArgs.h"
 #include "ola/client/ClientTypes.h"
@@ -52,6 +55,10 @@ namespace client {
 /**
  * @brief The low level C++ API to olad.
  * Clients shouldn't use this directly. Instead use ola::client::OlaClient.
+ *
+ * Identical fetches that are issued while an earlier one is still
+ * outstanding share the earlier request, rather than sending another one to
+ * the server.
  */
 class OlaClientCore: public ola::proto::OlaClientService {
  public:
@@ -253,6 +260,14 @@ class OlaClientCore: public ola::proto::OlaClientService {
    */
   void FetchDMX(unsigned int universe, DMXCallback *callback);
 
+  /**
+   * @brief Fetch the latest DMX data for a list of universes.
+   * @param universes the universe ids to get data for.
+   * @param callback the MultipleDMXCallback to invoke upon completion.
+   */
+  void FetchDMX(const std::vector<unsigned int> &universes,
+                MultipleDMXCallback *callback);
+
   /**
    * @brief Trigger discovery for a universe.
    * @param universe the universe id to run discovery on.
@@ -323,14 +338,102 @@ class OlaClientCore: public ola::proto::OlaClientService {
                      CompletionCallback* done);
 
  private:
+  /**
+   * @brief Identifies an RDM GET, requests with the same key are coalesced.
+   */
+  struct RDMGetKey {
+    unsigned int universe;
+    ola::rdm::UID uid;
+    uint16_t sub_device;
+    uint16_t pid;
+    std::string data;
+    bool include_raw_frames;
+
+    RDMGetKey(unsigned int _universe, const ola::rdm::UID &_uid,
+              uint16_t _sub_device, uint16_t _pid, const std::string &_data,
+              bool _include_raw_frames)
+        : universe(_universe),
+          uid(_uid),
+          sub_device(_sub_device),
+          pid(_pid),
+          data(_data),
+          include_raw_frames(_include_raw_frames) {
+    }
+
+    bool operator<(const RDMGetKey &other) const;
+  };
+
+  class DMXListCollector;
+  class ListContainsUniverse;
+  class RDMGetToResponder;
+
   ola::io::ConnectedDescriptor *m_descriptor;
   std::auto_ptr<RepeatableDMXCallback> m_dmx_callback;
   std::auto_ptr<ola::rpc::RpcChannel> m_channel;
   std::auto_ptr<ola::proto::OlaServerService_Stub> m_stub;
   int m_connected;
+  bool m_dmx_list_supported;
+
+  InFlightRequests<unsigned int, DMXCallback> m_dmx_fetches;
+  InFlightRequests<std::vector<unsigned int>, MultipleDMXCallback>
+      m_dmx_list_fetches;
+  InFlightRequests<unsigned int, UniverseInfoCallback> m_universe_fetches;
+  InFlightRequests<ola_plugin_id, DeviceInfoCallback> m_device_fetches;
+  InFlightRequests<RDMGetKey, RDMCallback> m_rdm_gets;
 
   void ChannelClosed(ClosedCallback *callback, ola::rpc::RpcSession *session);
 
+  void ClearInFlightRequests();
+
+  /**
+   * @brief Run the callbacks waiting on all in-flight requests with an error.
+   */
+  void FailInFlightRequests(const std::string &error);
+
+  /**
+   * @brief Run the callbacks waiting on a FetchDeviceInfo().
+   */
+  void DeviceInfoFetched(InFlightRequestId request_id,
+                         const Result &result,
+                         const std::vector<OlaDevice> &devices);
+
+  /**
+   * @brief Run the callbacks waiting on a FetchUniverseInfo().
+   */
+  void UniverseInfoFetched(InFlightRequestId request_id,
+                           const Result &result,
+                           const OlaUniverse &universe_info);
+
+  /**
+   * @brief Run the callbacks waiting on a FetchDMX().
+   */
+  void DMXFetched(InFlightRequestId request_id,
+                  const Result &result,
+                  const DMXMetadata &metadata,
+                  const DmxBuffer &buffer);
+
+  /**
+   * @brief Run the callbacks waiting on a multi-universe FetchDMX().
+   */
+  void DMXListFetched(InFlightRequestId request_id,
+                      const Result &result,
+                      const std::map<unsigned int, DmxBuffer> &data);
+
+  /**
+   * @brief Run the callbacks waiting on a RDM GET.
+   */
+  void RDMGetCompleted(InFlightRequestId request_id,
+                       const Result &result,
+                       const RDMMetadata &metadata,
+                       const ola::rdm::RDMResponse *response);
+
+  /**
+   * @brief Fetch a list of universes with a GetDmx() request per universe.
+   * This is used if the server doesn't support GetDmxList().
+   */
+  void FetchDMXIndividually(InFlightRequestId request_id,
+                            const std::vector<unsigned int> &universes);
+
   /**
    * @brief Called when GetPlugins() completes.
    */
@@ -401,6 +504,14 @@ class OlaClientCore: public ola::proto::OlaClientService {
                     ola::proto::DmxData *reply,
                     DMXCallback *callback);
 
+  /**
+   * @brief Called when a GetDmxList() request completes.
+   */
+  void HandleGetDmxList(ola::rpc::RpcController *controller,
+                        ola::proto::DmxDataList *reply,
+                        InFlightRequestId request_id,
+                        std::vector<unsigned int> universes);
+
   /**
    * @brief Called when a RunDiscovery() request completes.
    */
@@ -442,6 +553,7 @@ class OlaClientCore: public ola::proto::OlaClientService {
       ola::rdm::RDMStatusCode *status_code);
 
   static const char NOT_CONNECTED_ERROR[];
+  static const char NOT_IMPLEMENTED_ERROR[];
 
   DISALLOW_COPY_AND_ASSIGN(OlaClientCore);
 };
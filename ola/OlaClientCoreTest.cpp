@@ -0,0 +1,703 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * OlaClientCoreTest.cpp
+ * Test fixture for the OlaClientCore class
+ * Copyright (C) 2026 agent
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/protocol/Ola.pb.h"
+#include "common/protocol/OlaService.pb.h"
+#include "common/rpc/RpcChannel.h"
+#include "common/rpc/RpcController.h"
+#include "ola/Callback.h"
+#include "ola/DmxBuffer.h"
+#include "ola/OlaClientCore.h"
+#include "ola/io/Descriptor.h"
+#include "ola/io/SelectServer.h"
+#include "ola/rdm/RDMEnums.h"
+#include "ola/rdm/UID.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::DmxBuffer;
+using ola::NewSingleCallback;
+using ola::TimeInterval;
+using ola::client::DMXMetadata;
+using ola::client::OlaClientCore;
+using ola::client::OlaDevice;
+using ola::client::OlaUniverse;
+using ola::client::RDMMetadata;
+using ola::client::Result;
+using ola::client::SendRDMArgs;
+using ola::io::PipeDescriptor;
+using ola::io::SelectServer;
+using ola::rdm::UID;
+using ola::rpc::RpcChannel;
+using ola::rpc::RpcController;
+using std::auto_ptr;
+using std::map;
+using std::string;
+using std::vector;
+
+/*
+ * A fake olad which counts the requests it receives.
+ */
+class FakeOlaServerService: public ola::proto::OlaServerService {
+ public:
+  FakeOlaServerService()
+      : get_dmx_calls(0),
+        get_dmx_list_calls(0),
+        universe_info_calls(0),
+        device_info_calls(0),
+        rdm_calls(0),
+        support_dmx_list(true) {
+  }
+
+  void GetDmx(RpcController *controller,
+              const ola::proto::UniverseRequest *request,
+              ola::proto::DmxData *response,
+              CompletionCallback *done) {
+    get_dmx_calls++;
+    if (!AddDMX(request->universe(), response)) {
+      controller->SetFailed("Universe doesn't exist");
+    }
+    done->Run();
+  }
+
+  void GetDmxList(RpcController *controller,
+                  const ola::proto::UniverseListRequest *request,
+                  ola::proto::DmxDataList *response,
+                  CompletionCallback *done) {
+    get_dmx_list_calls++;
+    if (support_dmx_list) {
+      for (int i = 0; i < request->universe_size(); i++) {
+        ola::proto::DmxData data;
+        if (AddDMX(request->universe(i), &data)) {
+          response->add_data()->CopyFrom(data);
+        }
+      }
+    } else {
+      // This is what the RpcChannel returns for an unknown method.
+      controller->SetFailed("Not Implemented");
+    }
+    done->Run();
+  }
+
+  void UpdateDmxData(RpcController*,
+                     const ola::proto::DmxData *request,
+                     ola::proto::Ack*,
+                     CompletionCallback *done) {
+    universes[request->universe()].Set(request->data());
+    done->Run();
+  }
+
+  void GetUniverseInfo(RpcController*,
+                       const ola::proto::OptionalUniverseRequest *request,
+                       ola::proto::UniverseInfoReply *response,
+                       CompletionCallback *done) {
+    universe_info_calls++;
+    ola::proto::UniverseInfo *info = response->add_universe();
+    info->set_universe(request->universe());
+    map<unsigned int, string>::const_iterator iter = names.find(
+        request->universe());
+    info->set_name(iter == names.end() ? "Universe" : iter->second);
+    info->set_merge_mode(ola::proto::HTP);
+    info->set_input_port_count(0);
+    info->set_output_port_count(0);
+    info->set_rdm_devices(0);
+    done->Run();
+  }
+
+  void SetUniverseName(RpcController*,
+                       const ola::proto::UniverseNameRequest *request,
+                       ola::proto::Ack*,
+                       CompletionCallback *done) {
+    names[request->universe()] = request->name();
+    done->Run();
+  }
+
+  void GetDeviceInfo(RpcController*,
+                     const ola::proto::DeviceInfoRequest*,
+                     ola::proto::DeviceInfoReply *response,
+                     CompletionCallback *done) {
+    device_info_calls++;
+    ola::proto::DeviceInfo *device = response->add_device();
+    device->set_device_alias(1);
+    device->set_plugin_id(ola::OLA_PLUGIN_DUMMY);
+    device->set_device_name("Dummy Device");
+    device->set_device_id("1");
+    done->Run();
+  }
+
+  void RDMCommand(RpcController*,
+                  const ola::proto::RDMRequest*,
+                  ola::proto::RDMResponse *response,
+                  CompletionCallback *done) {
+    rdm_calls++;
+    response->set_response_code(ola::proto::RDM_WAS_BROADCAST);
+    done->Run();
+  }
+
+  map<unsigned int, DmxBuffer> universes;
+  map<unsigned int, string> names;
+  unsigned int get_dmx_calls;
+  unsigned int get_dmx_list_calls;
+  unsigned int universe_info_calls;
+  unsigned int device_info_calls;
+  unsigned int rdm_calls;
+  bool support_dmx_list;
+
+ private:
+  bool AddDMX(unsigned int universe, ola::proto::DmxData *data) {
+    map<unsigned int, DmxBuffer>::const_iterator iter =
+        universes.find(universe);
+    if (iter == universes.end()) {
+      return false;
+    }
+    data->set_universe(universe);
+    data->set_data(iter->second.Get());
+    return true;
+  }
+};
+
+
+class OlaClientCoreTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(OlaClientCoreTest);
+  CPPUNIT_TEST(testFetchDMX);
+  CPPUNIT_TEST(testFetchInfo);
+  CPPUNIT_TEST(testRDM);
+  CPPUNIT_TEST(testFetchMultipleDMX);
+  CPPUNIT_TEST(testFetchMultipleDMXFallback);
+  CPPUNIT_TEST(testStop);
+  CPPUNIT_TEST(testWriteThenFetchDMX);
+  CPPUNIT_TEST(testWriteThenFetchInfo);
+  CPPUNIT_TEST(testRDMSetThenGet);
+  CPPUNIT_TEST(testChannelClosed);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void setUp();
+  void tearDown();
+
+  void testFetchDMX();
+  void testFetchInfo();
+  void testRDM();
+  void testFetchMultipleDMX();
+  void testFetchMultipleDMXFallback();
+  void testStop();
+  void testWriteThenFetchDMX();
+  void testWriteThenFetchInfo();
+  void testRDMSetThenGet();
+  void testChannelClosed();
+
+  void DMXFetched(unsigned int expected_universe,
+                  const Result &result,
+                  const DMXMetadata &metadata,
+                  const DmxBuffer &buffer);
+  void MultipleDMXFetched(const Result &result,
+                          const map<unsigned int, DmxBuffer> &data);
+  void NotConnected(const Result &result,
+                    const map<unsigned int, DmxBuffer> &data);
+  void UniverseInfoFetched(const Result &result, const OlaUniverse &universe);
+  void DeviceInfoFetched(const Result &result,
+                         const vector<OlaDevice> &devices);
+  void RDMComplete(const Result &result,
+                   const RDMMetadata &metadata,
+                   const ola::rdm::RDMResponse *response);
+  void SetComplete(const Result &result);
+  void DMXRecorded(const Result &result,
+                   const DMXMetadata &metadata,
+                   const DmxBuffer &buffer);
+  void UniverseNameRecorded(const Result &result,
+                            const OlaUniverse &universe);
+  void DMXFailed(const Result &result,
+                 const DMXMetadata &metadata,
+                 const DmxBuffer &buffer);
+  void UniverseInfoFailed(const Result &result, const OlaUniverse &universe);
+  void RDMFailed(const Result &result,
+                 const RDMMetadata &metadata,
+                 const ola::rdm::RDMResponse *response);
+  void ClientClosed();
+
+ private:
+  SelectServer m_ss;
+  FakeOlaServerService m_service;
+  auto_ptr<PipeDescriptor> m_client_end;
+  auto_ptr<PipeDescriptor> m_server_end;
+  auto_ptr<RpcChannel> m_server_channel;
+  auto_ptr<OlaClientCore> m_client;
+  unsigned int m_callbacks_run;
+  map<unsigned int, DmxBuffer> m_multiple_dmx;
+  vector<DmxBuffer> m_dmx_buffers;
+  vector<string> m_universe_names;
+
+  void RunUntil(unsigned int callbacks);
+  void SendRDMGet(uint16_t pid);
+};
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(OlaClientCoreTest);
+
+static const uint8_t SAMPLE_DMX_DATA[] = {1, 2, 3, 4, 5};
+
+void OlaClientCoreTest::setUp() {
+  m_callbacks_run = 0;
+  m_multiple_dmx.clear();
+  m_dmx_buffers.clear();
+  m_universe_names.clear();
+  m_service.universes[1] = DmxBuffer(SAMPLE_DMX_DATA, sizeof(SAMPLE_DMX_DATA));
+  m_service.universes[3] = DmxBuffer("9,8,7");
+
+  m_client_end.reset(new PipeDescriptor());
+  OLA_ASSERT_TRUE(m_client_end->Init());
+  m_server_end.reset(m_client_end->OppositeEnd());
+
+  m_server_channel.reset(new RpcChannel(&m_service, m_server_end.get()));
+  m_client.reset(new OlaClientCore(m_client_end.get()));
+  OLA_ASSERT_TRUE(m_client->Setup());
+
+  m_ss.AddReadDescriptor(m_client_end.get());
+  m_ss.AddReadDescriptor(m_server_end.get());
+}
+
+void OlaClientCoreTest::tearDown() {
+  // testStop() closes the client end, testChannelClosed() the server end.
+  if (m_client_end->ValidReadDescriptor()) {
+    m_ss.RemoveReadDescriptor(m_client_end.get());
+  }
+  if (m_server_end->ValidReadDescriptor()) {
+    m_ss.RemoveReadDescriptor(m_server_end.get());
+  }
+  m_client.reset();
+  m_server_channel.reset();
+  m_server_end.reset();
+  m_client_end.reset();
+}
+
+/*
+ * Run the SelectServer until the expected number of callbacks have run.
+ */
+void OlaClientCoreTest::RunUntil(unsigned int callbacks) {
+  for (unsigned int i = 0; i < 100 && m_callbacks_run < callbacks; i++) {
+    m_ss.RunOnce(TimeInterval(0, 10000));
+  }
+  OLA_ASSERT_EQ(callbacks, m_callbacks_run);
+}
+
+void OlaClientCoreTest::SendRDMGet(uint16_t pid) {
+  SendRDMArgs args(NewSingleCallback(this, &OlaClientCoreTest::RDMComplete));
+  m_client->RDMGet(1, UID(0x7a70, 1), 0, pid, NULL, 0, args);
+}
+
+void OlaClientCoreTest::DMXFetched(unsigned int expected_universe,
+                                   const Result &result,
+                                   const DMXMetadata &metadata,
+                                   const DmxBuffer &buffer) {
+  OLA_ASSERT_TRUE(result.Success());
+  OLA_ASSERT_EQ(expected_universe, metadata.universe);
+  OLA_ASSERT_EQ(m_service.universes[expected_universe], buffer);
+  m_callbacks_run++;
+}
+
+void OlaClientCoreTest::MultipleDMXFetched(
+    const Result &result,
+    const map<unsigned int, DmxBuffer> &data) {
+  OLA_ASSERT_TRUE(result.Success());
+  m_multiple_dmx = data;
+  m_callbacks_run++;
+}
+
+void OlaClientCoreTest::NotConnected(
+    const Result &result,
+    const map<unsigned int, DmxBuffer> &data) {
+  OLA_ASSERT_FALSE(result.Success());
+  OLA_ASSERT_TRUE(data.empty());
+  m_callbacks_run++;
+}
+
+void OlaClientCoreTest::UniverseInfoFetched(const Result &result,
+                                            const OlaUniverse &universe) {
+  OLA_ASSERT_TRUE(result.Success());
+  OLA_ASSERT_EQ(2u, universe.Id());
+  m_callbacks_run++;
+}
+
+void OlaClientCoreTest::DeviceInfoFetched(const Result &result,
+                                          const vector<OlaDevice> &devices) {
+  OLA_ASSERT_TRUE(result.Success());
+  OLA_ASSERT_EQ(static_cast<size_t>(1), devices.size());
+  m_callbacks_run++;
+}
+
+void OlaClientCoreTest::RDMComplete(const Result &result,
+                                    const RDMMetadata &metadata,
+                                    const ola::rdm::RDMResponse *response) {
+  OLA_ASSERT_TRUE(result.Success());
+  OLA_ASSERT_EQ(ola::rdm::RDM_WAS_BROADCAST, metadata.response_code);
+  OLA_ASSERT_NULL(response);
+  m_callbacks_run++;
+}
+
+void OlaClientCoreTest::SetComplete(const Result &result) {
+  OLA_ASSERT_TRUE(result.Success());
+  m_callbacks_run++;
+}
+
+void OlaClientCoreTest::DMXRecorded(const Result &result,
+                                    const DMXMetadata&,
+                                    const DmxBuffer &buffer) {
+  OLA_ASSERT_TRUE(result.Success());
+  m_dmx_buffers.push_back(buffer);
+  m_callbacks_run++;
+}
+
+void OlaClientCoreTest::UniverseNameRecorded(const Result &result,
+                                             const OlaUniverse &universe) {
+  OLA_ASSERT_TRUE(result.Success());
+  m_universe_names.push_back(universe.Name());
+  m_callbacks_run++;
+}
+
+void OlaClientCoreTest::DMXFailed(const Result &result,
+                                  const DMXMetadata&,
+                                  const DmxBuffer &buffer) {
+  OLA_ASSERT_FALSE(result.Success());
+  OLA_ASSERT_EQ(0u, buffer.Size());
+  m_callbacks_run++;
+}
+
+void OlaClientCoreTest::UniverseInfoFailed(const Result &result,
+                                           const OlaUniverse&) {
+  OLA_ASSERT_FALSE(result.Success());
+  m_callbacks_run++;
+}
+
+void OlaClientCoreTest::RDMFailed(const Result &result,
+                                  const RDMMetadata&,
+                                  const ola::rdm::RDMResponse *response) {
+  OLA_ASSERT_FALSE(result.Success());
+  OLA_ASSERT_NULL(response);
+  m_callbacks_run++;
+}
+
+void OlaClientCoreTest::ClientClosed() {
+  m_callbacks_run++;
+}
+
+
+/*
+ * Check that identical FetchDMX calls share a request.
+ */
+void OlaClientCoreTest::testFetchDMX() {
+  for (unsigned int i = 0; i < 3; i++) {
+    m_client->FetchDMX(
+        1, NewSingleCallback(this, &OlaClientCoreTest::DMXFetched, 1u));
+  }
+  m_client->FetchDMX(
+      3, NewSingleCallback(this, &OlaClientCoreTest::DMXFetched, 3u));
+  m_client->FetchDMX(1, NULL);
+
+  RunUntil(4);
+  OLA_ASSERT_EQ(2u, m_service.get_dmx_calls);
+
+  // Once the response has arrived, a new request is sent.
+  m_client->FetchDMX(
+      1, NewSingleCallback(this, &OlaClientCoreTest::DMXFetched, 1u));
+  RunUntil(5);
+  OLA_ASSERT_EQ(3u, m_service.get_dmx_calls);
+}
+
+
+/*
+ * Check that the universe & device info fetches are coalesced.
+ */
+void OlaClientCoreTest::testFetchInfo() {
+  for (unsigned int i = 0; i < 3; i++) {
+    m_client->FetchUniverseInfo(
+        2, NewSingleCallback(this, &OlaClientCoreTest::UniverseInfoFetched));
+    m_client->FetchDeviceInfo(
+        ola::OLA_PLUGIN_ALL,
+        NewSingleCallback(this, &OlaClientCoreTest::DeviceInfoFetched));
+  }
+
+  RunUntil(6);
+  OLA_ASSERT_EQ(1u, m_service.universe_info_calls);
+  OLA_ASSERT_EQ(1u, m_service.device_info_calls);
+}
+
+
+/*
+ * Check that only RDM GETs are coalesced.
+ */
+void OlaClientCoreTest::testRDM() {
+  SendRDMGet(ola::rdm::PID_DEVICE_INFO);
+  SendRDMGet(ola::rdm::PID_DEVICE_INFO);
+  RunUntil(2);
+  OLA_ASSERT_EQ(1u, m_service.rdm_calls);
+
+  // Each GET QUEUED_MESSAGE returns a different message.
+  SendRDMGet(ola::rdm::PID_QUEUED_MESSAGE);
+  SendRDMGet(ola::rdm::PID_QUEUED_MESSAGE);
+  RunUntil(4);
+  OLA_ASSERT_EQ(3u, m_service.rdm_calls);
+
+  const uint8_t identify = 1;
+  for (unsigned int i = 0; i < 2; i++) {
+    SendRDMArgs args(NewSingleCallback(this, &OlaClientCoreTest::RDMComplete));
+    m_client->RDMSet(1, UID(0x7a70, 1), 0, ola::rdm::PID_IDENTIFY_DEVICE,
+                     &identify, sizeof(identify), args);
+  }
+  RunUntil(6);
+  OLA_ASSERT_EQ(5u, m_service.rdm_calls);
+}
+
+
+/*
+ * Check that fetching multiple universes uses a single request.
+ */
+void OlaClientCoreTest::testFetchMultipleDMX() {
+  vector<unsigned int> universes;
+  universes.push_back(3);
+  universes.push_back(2);
+  universes.push_back(1);
+  universes.push_back(1);
+  m_client->FetchDMX(
+      universes,
+      NewSingleCallback(this, &OlaClientCoreTest::MultipleDMXFetched));
+
+  // The same set of universes, in a different order.
+  vector<unsigned int> sorted_universes;
+  sorted_universes.push_back(1);
+  sorted_universes.push_back(2);
+  sorted_universes.push_back(3);
+  m_client->FetchDMX(
+      sorted_universes,
+      NewSingleCallback(this, &OlaClientCoreTest::MultipleDMXFetched));
+
+  RunUntil(2);
+  OLA_ASSERT_EQ(1u, m_service.get_dmx_list_calls);
+  OLA_ASSERT_EQ(0u, m_service.get_dmx_calls);
+
+  // Universe 2 doesn't exist.
+  OLA_ASSERT_EQ(static_cast<size_t>(2), m_multiple_dmx.size());
+  OLA_ASSERT_EQ(m_service.universes[1], m_multiple_dmx[1]);
+  OLA_ASSERT_EQ(m_service.universes[3], m_multiple_dmx[3]);
+}
+
+
+/*
+ * Check we fall back to GetDmx if the server doesn't support GetDmxList.
+ */
+void OlaClientCoreTest::testFetchMultipleDMXFallback() {
+  m_service.support_dmx_list = false;
+
+  vector<unsigned int> universes;
+  universes.push_back(1);
+  universes.push_back(2);
+  universes.push_back(3);
+  m_client->FetchDMX(
+      universes,
+      NewSingleCallback(this, &OlaClientCoreTest::MultipleDMXFetched));
+
+  RunUntil(1);
+  OLA_ASSERT_EQ(1u, m_service.get_dmx_list_calls);
+  OLA_ASSERT_EQ(3u, m_service.get_dmx_calls);
+  OLA_ASSERT_EQ(static_cast<size_t>(2), m_multiple_dmx.size());
+  OLA_ASSERT_EQ(m_service.universes[1], m_multiple_dmx[1]);
+  OLA_ASSERT_EQ(m_service.universes[3], m_multiple_dmx[3]);
+
+  // The next fetch goes straight to GetDmx.
+  m_multiple_dmx.clear();
+  universes.pop_back();
+  m_client->FetchDMX(
+      universes,
+      NewSingleCallback(this, &OlaClientCoreTest::MultipleDMXFetched));
+  RunUntil(2);
+  OLA_ASSERT_EQ(1u, m_service.get_dmx_list_calls);
+  OLA_ASSERT_EQ(5u, m_service.get_dmx_calls);
+  OLA_ASSERT_EQ(static_cast<size_t>(1), m_multiple_dmx.size());
+  OLA_ASSERT_EQ(m_service.universes[1], m_multiple_dmx[1]);
+}
+
+
+/*
+ * Check that stopping the client with requests outstanding doesn't run the
+ * callbacks, and that later requests fail.
+ */
+void OlaClientCoreTest::testStop() {
+  m_client->FetchDMX(
+      1, NewSingleCallback(this, &OlaClientCoreTest::DMXFetched, 1u));
+  m_client->FetchDMX(
+      1, NewSingleCallback(this, &OlaClientCoreTest::DMXFetched, 1u));
+  m_ss.RemoveReadDescriptor(m_client_end.get());
+  m_client->Stop();
+  OLA_ASSERT_EQ(0u, m_callbacks_run);
+
+  vector<unsigned int> universes;
+  universes.push_back(1);
+  m_client->FetchDMX(
+      universes,
+      NewSingleCallback(this, &OlaClientCoreTest::NotConnected));
+  m_client->FetchDMX(
+      universes,
+      NewSingleCallback(this, &OlaClientCoreTest::NotConnected));
+  OLA_ASSERT_EQ(2u, m_callbacks_run);
+}
+
+
+/*
+ * Check that a fetch made after a DMX update isn't answered by a fetch sent
+ * before it.
+ */
+void OlaClientCoreTest::testWriteThenFetchDMX() {
+  const DmxBuffer original_data(m_service.universes[1]);
+  const DmxBuffer new_data("10,20,30");
+  vector<unsigned int> universes;
+  universes.push_back(1);
+  universes.push_back(3);
+
+  m_client->FetchDMX(
+      1, NewSingleCallback(this, &OlaClientCoreTest::DMXRecorded));
+  m_client->FetchDMX(
+      universes,
+      NewSingleCallback(this, &OlaClientCoreTest::MultipleDMXFetched));
+  m_client->SendDMX(
+      1, new_data,
+      ola::client::SendDMXArgs(
+          NewSingleCallback(this, &OlaClientCoreTest::SetComplete)));
+  m_client->FetchDMX(
+      1, NewSingleCallback(this, &OlaClientCoreTest::DMXRecorded));
+  m_client->FetchDMX(
+      universes,
+      NewSingleCallback(this, &OlaClientCoreTest::MultipleDMXFetched));
+
+  RunUntil(5);
+  OLA_ASSERT_EQ(2u, m_service.get_dmx_calls);
+  OLA_ASSERT_EQ(2u, m_service.get_dmx_list_calls);
+  OLA_ASSERT_EQ(static_cast<size_t>(2), m_dmx_buffers.size());
+  OLA_ASSERT_EQ(original_data, m_dmx_buffers[0]);
+  OLA_ASSERT_EQ(new_data, m_dmx_buffers[1]);
+  OLA_ASSERT_EQ(new_data, m_multiple_dmx[1]);
+
+  // An update to another universe doesn't affect the fetches for universe 3.
+  m_client->FetchDMX(
+      3, NewSingleCallback(this, &OlaClientCoreTest::DMXRecorded));
+  m_client->SendDMX(
+      1, original_data,
+      ola::client::SendDMXArgs(
+          NewSingleCallback(this, &OlaClientCoreTest::SetComplete)));
+  m_client->FetchDMX(
+      3, NewSingleCallback(this, &OlaClientCoreTest::DMXRecorded));
+  RunUntil(8);
+  OLA_ASSERT_EQ(3u, m_service.get_dmx_calls);
+}
+
+
+/*
+ * Check that a universe info fetch made after a change to the universe sends
+ * a new request.
+ */
+void OlaClientCoreTest::testWriteThenFetchInfo() {
+  m_client->FetchUniverseInfo(
+      2, NewSingleCallback(this, &OlaClientCoreTest::UniverseNameRecorded));
+  m_client->SetUniverseName(
+      2, "New Name", NewSingleCallback(this, &OlaClientCoreTest::SetComplete));
+  m_client->FetchUniverseInfo(
+      2, NewSingleCallback(this, &OlaClientCoreTest::UniverseNameRecorded));
+  m_client->FetchUniverseInfo(
+      2, NewSingleCallback(this, &OlaClientCoreTest::UniverseNameRecorded));
+
+  RunUntil(4);
+  OLA_ASSERT_EQ(2u, m_service.universe_info_calls);
+  OLA_ASSERT_EQ(static_cast<size_t>(3), m_universe_names.size());
+  OLA_ASSERT_EQ(string("Universe"), m_universe_names[0]);
+  OLA_ASSERT_EQ(string("New Name"), m_universe_names[1]);
+  OLA_ASSERT_EQ(string("New Name"), m_universe_names[2]);
+}
+
+
+/*
+ * Check that a RDM SET stops later GETs to the same responder joining a GET
+ * sent before it.
+ */
+void OlaClientCoreTest::testRDMSetThenGet() {
+  const UID other_uid(0x7a70, 2);
+  const uint8_t identify = 1;
+
+  SendRDMGet(ola::rdm::PID_DEVICE_INFO);
+  m_client->RDMGet(
+      1, other_uid, 0, ola::rdm::PID_DEVICE_INFO, NULL, 0,
+      SendRDMArgs(NewSingleCallback(this, &OlaClientCoreTest::RDMComplete)));
+  m_client->RDMSet(
+      1, UID(0x7a70, 1), 0, ola::rdm::PID_IDENTIFY_DEVICE, &identify,
+      sizeof(identify),
+      SendRDMArgs(NewSingleCallback(this, &OlaClientCoreTest::RDMComplete)));
+  SendRDMGet(ola::rdm::PID_DEVICE_INFO);
+  m_client->RDMGet(
+      1, other_uid, 0, ola::rdm::PID_DEVICE_INFO, NULL, 0,
+      SendRDMArgs(NewSingleCallback(this, &OlaClientCoreTest::RDMComplete)));
+
+  RunUntil(5);
+  OLA_ASSERT_EQ(4u, m_service.rdm_calls);
+
+  // A broadcast SET affects all the responders on the universe.
+  SendRDMGet(ola::rdm::PID_DEVICE_INFO);
+  m_client->RDMSet(
+      1, UID::AllDevices(), 0, ola::rdm::PID_IDENTIFY_DEVICE, &identify,
+      sizeof(identify),
+      SendRDMArgs(NewSingleCallback(this, &OlaClientCoreTest::RDMComplete)));
+  SendRDMGet(ola::rdm::PID_DEVICE_INFO);
+  RunUntil(8);
+  OLA_ASSERT_EQ(7u, m_service.rdm_calls);
+}
+
+
+/*
+ * Check that the requests in flight when the server closes the connection
+ * fail, rather than being left waiting.
+ */
+void OlaClientCoreTest::testChannelClosed() {
+  m_client->SetCloseHandler(
+      NewSingleCallback(this, &OlaClientCoreTest::ClientClosed));
+
+  // The server won't read the requests.
+  m_ss.RemoveReadDescriptor(m_server_end.get());
+
+  vector<unsigned int> universes;
+  universes.push_back(1);
+  for (unsigned int i = 0; i < 2; i++) {
+    m_client->FetchDMX(
+        1, NewSingleCallback(this, &OlaClientCoreTest::DMXFailed));
+    m_client->FetchDMX(
+        universes,
+        NewSingleCallback(this, &OlaClientCoreTest::NotConnected));
+    m_client->FetchUniverseInfo(
+        2, NewSingleCallback(this, &OlaClientCoreTest::UniverseInfoFailed));
+    m_client->RDMGet(
+        1, UID(0x7a70, 1), 0, ola::rdm::PID_DEVICE_INFO, NULL, 0,
+        SendRDMArgs(NewSingleCallback(this, &OlaClientCoreTest::RDMFailed)));
+  }
+  OLA_ASSERT_EQ(0u, m_callbacks_run);
+
+  m_server_channel.reset();
+  m_server_end->Close();
+  RunUntil(9);
+}
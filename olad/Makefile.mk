@@ -72,6 +72,18 @@ olad_olad_LDADD = olad/libolaserver.la \
                   common/libolacommon.la \
                   ola/libola.la
 
+if USE_DUMMY
+noinst_PROGRAMS += olad/rpc_benchmark
+olad_rpc_benchmark_SOURCES = olad/rpc_benchmark.cpp
+olad_rpc_benchmark_CXXFLAGS = $(COMMON_PROTOBUF_CXXFLAGS)
+olad_rpc_benchmark_LDADD = olad/libolaserver.la \
+                           plugins/dummy/liboladummy.la \
+                           olad/plugin_api/libolaserverplugininterface.la \
+                           common/libolacommon.la \
+                           common/testing/libolaheapcounter.la \
+                           ola/libola.la
+endif
+
 # TESTS
 ##################################################
 test_programs += \
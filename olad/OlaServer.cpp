@@ -27,6 +27,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -38,11 +39,13 @@
 #include "ola/ExportMap.h"
 #include "ola/Logging.h"
 #include "ola/base/Flags.h"
-#include "ola/network/InterfacePicker.h"
+#include "ola/file/Util.h"
+#include "ola/network/InterfaceMonitor.h"
 #include "ola/network/Socket.h"
 #include "ola/rdm/PidStore.h"
 #include "ola/rdm/UID.h"
 #include "ola/stl/STLUtils.h"
+#include "ola/thread/ExecutorThread.h"
 #include "olad/ClientBroker.h"
 #include "olad/DiscoveryAgent.h"
 #include "olad/OlaServer.h"
@@ -57,6 +60,7 @@
 #include "olad/plugin_api/Client.h"
 #include "olad/plugin_api/DeviceManager.h"
 #include "olad/plugin_api/PortManager.h"
+#include "olad/plugin_api/UniverseSnapshot.h"
 #include "olad/plugin_api/UniverseStore.h"
 
 #ifdef HAVE_LIBMICROHTTPD
@@ -67,6 +71,14 @@ DEFINE_s_uint16(rpc_port, r, ola::OlaServer::DEFAULT_RPC_PORT,
                 "The port to listen for RPCs on. Defaults to 9010.");
 DEFINE_default_bool(register_with_dns_sd, true,
                     "Don't register the web service using DNS-SD (Bonjour).");
+DEFINE_uint8(plugin_startup_threads,
+             ola::PluginManager::DEFAULT_STARTUP_THREADS,
+             "The number of threads used to start plugins concurrently.");
+DEFINE_string(state_snapshot_file, "",
+              "The file used to save and restore the universe state (name, "
+              "merge mode & last DMX data) across restarts.");
+DEFINE_uint32(state_snapshot_interval, 1000,
+              "The interval in ms between universe state snapshots.");
 
 namespace ola {
 
@@ -77,8 +89,17 @@ using ola::rpc::RpcSession;
 using ola::rpc::RpcServer;
 using std::auto_ptr;
 using std::pair;
+using std::string;
 using std::vector;
 
+namespace {
+void WriteSnapshotFile(string path, string data) {
+  if (!ola::file::WriteFileAtomically(path, data)) {
+    OLA_WARN << "Failed to write state snapshot to " << path;
+  }
+}
+}  // namespace
+
 const char OlaServer::INSTANCE_NAME_KEY[] = "instance-name";
 const char OlaServer::K_INSTANCE_NAME_VAR[] = "server-instance-name";
 const char OlaServer::K_UID_VAR[] = "server-uid";
@@ -103,7 +124,8 @@ OlaServer::OlaServer(const vector<PluginLoader*> &plugin_loaders,
       m_default_uid(OPEN_LIGHTING_ESTA_CODE, 0),
       m_server_preferences(NULL),
       m_universe_preferences(NULL),
-      m_housekeeping_timeout(ola::thread::INVALID_TIMEOUT) {
+      m_housekeeping_timeout(ola::thread::INVALID_TIMEOUT),
+      m_snapshot_timeout(ola::thread::INVALID_TIMEOUT) {
   if (!m_export_map) {
     m_our_export_map.reset(new ExportMap());
     m_export_map = m_our_export_map.get();
@@ -128,6 +150,17 @@ OlaServer::~OlaServer() {
     m_ss->RemoveTimeout(m_housekeeping_timeout);
   }
 
+  if (m_snapshot_timeout != ola::thread::INVALID_TIMEOUT) {
+    m_ss->RemoveTimeout(m_snapshot_timeout);
+  }
+
+  if (m_snapshot_writer.get()) {
+    // Flush any pending writes, then save the final state from this thread.
+    m_snapshot_writer->Stop();
+    m_snapshot_writer.reset();
+    SaveSnapshot(false);
+  }
+
   StopPlugins();
 
   m_broker.reset();
@@ -151,6 +184,7 @@ OlaServer::~OlaServer() {
   m_device_manager.reset();
   m_plugin_manager.reset();
   m_service_impl.reset();
+  m_interface_monitor.reset();
 }
 
 bool OlaServer::Init() {
@@ -177,18 +211,18 @@ bool OlaServer::Init() {
   signal(SIGPIPE, SIG_IGN);
 #endif  // _WIN32
 
-  // fetch the interface info
+  // fetch the interface info, the monitor is shared with the plugins.
+  m_interface_monitor.reset(new ola::network::InterfaceMonitor(m_ss));
+  m_interface_monitor->Init();
+
   ola::network::Interface iface;
-  {
-    auto_ptr<ola::network::InterfacePicker> picker(
-        ola::network::InterfacePicker::NewPicker());
-    if (!picker->ChooseInterface(&iface, m_options.network_interface)) {
-      OLA_WARN << "No network interface found";
-    } else {
-      // default to using the ip as an id
-      m_default_uid = ola::rdm::UID(OPEN_LIGHTING_ESTA_CODE,
-                                    iface.ip_address.AsInt());
-    }
+  if (!m_interface_monitor->ChooseInterface(&iface,
+                                            m_options.network_interface)) {
+    OLA_WARN << "No network interface found";
+  } else {
+    // default to using the ip as an id
+    m_default_uid = ola::rdm::UID(OPEN_LIGHTING_ESTA_CODE,
+                                  iface.ip_address.AsInt());
   }
   m_export_map->GetStringVar(K_UID_VAR)->Set(m_default_uid.ToString());
   OLA_INFO << "Server UID is " << m_default_uid;
@@ -211,6 +245,16 @@ bool OlaServer::Init() {
 
   auto_ptr<UniverseStore> universe_store(
       new UniverseStore(universe_preferences, m_export_map));
+  universe_store->SetSelectServer(m_ss);
+
+  if (!FLAGS_state_snapshot_file.str().empty()) {
+    auto_ptr<UniverseSnapshot> snapshot(new UniverseSnapshot());
+    if (snapshot->LoadFromFile(FLAGS_state_snapshot_file.str())) {
+      OLA_INFO << "Restoring state for " << snapshot->UniverseCount()
+               << " universes from " << FLAGS_state_snapshot_file.str();
+      universe_store->RestoreSnapshot(snapshot.release());
+    }
+  }
 
   auto_ptr<PortBroker> port_broker(new PortBroker());
 
@@ -225,10 +269,12 @@ bool OlaServer::Init() {
   auto_ptr<PluginAdaptor> plugin_adaptor(
       new PluginAdaptor(device_manager.get(), m_ss, m_export_map,
                         m_preferences_factory, port_broker.get(),
-                        &m_instance_name, &m_default_uid));
+                        &m_instance_name, &m_default_uid,
+                        m_interface_monitor.get()));
 
   auto_ptr<PluginManager> plugin_manager(
-    new PluginManager(m_plugin_loaders, plugin_adaptor.get()));
+    new PluginManager(m_plugin_loaders, plugin_adaptor.get(),
+                      FLAGS_plugin_startup_threads));
 
   auto_ptr<OlaServerServiceImpl> service_impl(new OlaServerServiceImpl(
       universe_store.get(),
@@ -305,6 +351,8 @@ bool OlaServer::Init() {
   m_rpc_server.reset(rpc_server.release());
   m_service_impl.reset(service_impl.release());
   m_universe_store.reset(universe_store.release());
+  m_universe_store->SetOutputCallback(
+      NewCallback(this, &OlaServer::CommitFrames));
 
   UpdatePidStore(pid_store.release());
 
@@ -316,6 +364,19 @@ bool OlaServer::Init() {
       K_HOUSEKEEPING_TIMEOUT_MS,
       ola::NewCallback(this, &OlaServer::RunHousekeeping));
 
+  if (!FLAGS_state_snapshot_file.str().empty() && !m_snapshot_writer.get()) {
+    m_snapshot_writer.reset(new ola::thread::ExecutorThread(
+        ola::thread::Thread::Options("snapshot-writer")));
+    if (m_snapshot_writer->Start()) {
+      m_snapshot_timeout = m_ss->RegisterRepeatingTimeout(
+          FLAGS_state_snapshot_interval,
+          ola::NewCallback(this, &OlaServer::RunSnapshot));
+    } else {
+      OLA_WARN << "Failed to start the snapshot writer thread";
+      m_snapshot_writer.reset();
+    }
+  }
+
   // The plugin load procedure can take a while so we run it in the main loop.
   m_ss->Execute(
       ola::NewSingleCallback(m_plugin_manager.get(), &PluginManager::LoadAll));
@@ -403,6 +464,15 @@ bool OlaServer::RunHousekeeping() {
   return true;
 }
 
+
+/*
+ * Called by the UniverseStore once the universes updated in this iteration of
+ * the event loop have written to their output ports.
+ */
+void OlaServer::CommitFrames() {
+  m_device_manager->CommitFrames();
+}
+
 #ifdef HAVE_LIBMICROHTTPD
 bool OlaServer::StartHttpServer(ola::rpc::RpcServer *server,
                                 const ola::network::Interface &iface) {
@@ -443,6 +513,35 @@ bool OlaServer::StartHttpServer(ola::rpc::RpcServer *server,
 }
 #endif  // HAVE_LIBMICROHTTPD
 
+bool OlaServer::RunSnapshot() {
+  SaveSnapshot(true);
+  return true;
+}
+
+void OlaServer::SaveSnapshot(bool async) {
+  if (!m_universe_store.get()) {
+    return;
+  }
+
+  UniverseSnapshot snapshot;
+  m_universe_store->TakeSnapshot(&snapshot);
+  string data;
+  snapshot.Serialize(&data);
+  if (data == m_last_snapshot) {
+    return;
+  }
+  m_last_snapshot = data;
+
+  // Serializing is cheap, the disk I/O isn't so we push that off the main
+  // thread.
+  if (async && m_snapshot_writer.get()) {
+    m_snapshot_writer->Execute(ola::NewSingleCallback(
+        &WriteSnapshotFile, FLAGS_state_snapshot_file.str(), data));
+  } else {
+    WriteSnapshotFile(FLAGS_state_snapshot_file.str(), data);
+  }
+}
+
 void OlaServer::StopPlugins() {
   if (m_plugin_manager.get()) {
     m_plugin_manager->UnloadAll();
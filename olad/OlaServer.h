@@ -29,6 +29,7 @@
 #include <ola/ExportMap.h>
 #include <ola/base/Macro.h>
 #include <ola/io/SelectServer.h>
+#include <ola/network/InterfaceMonitor.h>
 #include <ola/network/InterfacePicker.h>
 #include <ola/network/Socket.h>
 #include <ola/network/TCPSocketFactory.h>
@@ -49,6 +50,10 @@ class RpcSession;
 class RpcServer;
 }
 
+namespace thread {
+class ExecutorThread;
+}
+
 #ifdef HAVE_LIBMICROHTTPD
 typedef class OladHTTPServer OladHTTPServer_t;
 #else
@@ -182,6 +187,7 @@ class OlaServer : public ola::rpc::RpcSessionHandlerInterface {
   ola::rdm::UID m_default_uid;
 
   // These are all populated in Init.
+  std::auto_ptr<ola::network::InterfaceMonitor> m_interface_monitor;
   std::auto_ptr<class DeviceManager> m_device_manager;
   std::auto_ptr<class PluginManager> m_plugin_manager;
   std::auto_ptr<class PluginAdaptor> m_plugin_adaptor;
@@ -198,9 +204,20 @@ class OlaServer : public ola::rpc::RpcSessionHandlerInterface {
   std::string m_instance_name;
 
   ola::thread::timeout_id m_housekeeping_timeout;
+  ola::thread::timeout_id m_snapshot_timeout;
+  std::auto_ptr<ola::thread::ExecutorThread> m_snapshot_writer;
+  std::string m_last_snapshot;
   std::auto_ptr<OladHTTPServer_t> m_httpd;
 
   bool RunHousekeeping();
+  bool RunSnapshot();
+  void CommitFrames();
+
+  /**
+   * @brief Save the universe state to the snapshot file if it has changed.
+   * @param async true to write the file from the snapshot writer thread.
+   */
+  void SaveSnapshot(bool async);
 
 #ifdef HAVE_LIBMICROHTTPD
   bool StartHttpServer(ola::rpc::RpcServer *server,
@@ -56,6 +56,7 @@ using ola::proto::DeviceInfo;
 using ola::proto::DeviceInfoReply;
 using ola::proto::DeviceInfoRequest;
 using ola::proto::DmxData;
+using ola::proto::DmxDataList;
 using ola::proto::MergeModeRequest;
 using ola::proto::OptionalUniverseRequest;
 using ola::proto::PatchPortRequest;
@@ -68,6 +69,7 @@ using ola::proto::PortInfo;
 using ola::proto::RegisterDmxRequest;
 using ola::proto::UniverseInfo;
 using ola::proto::UniverseInfoReply;
+using ola::proto::UniverseListRequest;
 using ola::proto::UniverseNameRequest;
 using ola::proto::UniverseRequest;
 using ola::rdm::RDMRequest;
@@ -143,6 +145,24 @@ void OlaServerServiceImpl::GetDmx(
   response->set_universe(request->universe());
 }
 
+void OlaServerServiceImpl::GetDmxList(
+    RpcController*,
+    const UniverseListRequest* request,
+    DmxDataList* response,
+    ola::rpc::RpcService::CompletionCallback* done) {
+  ClosureRunner runner(done);
+  for (int i = 0; i < request->universe_size(); i++) {
+    Universe *universe = m_universe_store->GetUniverse(request->universe(i));
+    if (!universe) {
+      continue;
+    }
+
+    DmxData *data = response->add_data();
+    data->set_universe(request->universe(i));
+    data->set_data(universe->GetDMX().Get());
+  }
+}
+
 void OlaServerServiceImpl::RegisterForDmx(
     RpcController* controller,
     const RegisterDmxRequest* request,
@@ -75,6 +75,16 @@ class OlaServerServiceImpl : public ola::proto::OlaServerService {
               ola::proto::DmxData* response,
               ola::rpc::RpcService::CompletionCallback* done);
 
+  /**
+   * @brief Returns the current DMX values for a list of universes.
+   *
+   * Universes that don't exist are left out of the response.
+   */
+  void GetDmxList(ola::rpc::RpcController* controller,
+                  const ola::proto::UniverseListRequest* request,
+                  ola::proto::DmxDataList* response,
+                  ola::rpc::RpcService::CompletionCallback* done);
+
 
   /**
    * @brief Register a client to receive DMX data.
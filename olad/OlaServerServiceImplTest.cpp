@@ -56,6 +56,7 @@ using std::string;
 class OlaServerServiceImplTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(OlaServerServiceImplTest);
   CPPUNIT_TEST(testGetDmx);
+  CPPUNIT_TEST(testGetDmxList);
   CPPUNIT_TEST(testRegisterForDmx);
   CPPUNIT_TEST(testUpdateDmxData);
   CPPUNIT_TEST(testSetUniverseName);
@@ -72,6 +73,7 @@ class OlaServerServiceImplTest: public CppUnit::TestFixture {
     }
 
     void testGetDmx();
+    void testGetDmxList();
     void testRegisterForDmx();
     void testUpdateDmxData();
     void testSetUniverseName();
@@ -187,6 +189,11 @@ class SetMergeModeCheck {
 };
 
 
+static void MarkAsCalled(bool *called) {
+  *called = true;
+}
+
+
 /*
  * Assert that we got a missing universe error
  */
@@ -269,6 +276,54 @@ void OlaServerServiceImplTest::CallGetDmx(OlaServerServiceImpl *service,
 }
 
 
+/*
+ * Check that the GetDmxList method works
+ */
+void OlaServerServiceImplTest::testGetDmxList() {
+  UniverseStore store(NULL, NULL);
+  OlaServerServiceImpl service(&store, NULL, NULL, NULL, NULL, NULL, NULL);
+
+  Universe *universe1 = store.GetUniverseOrCreate(1);
+  Universe *universe3 = store.GetUniverseOrCreate(3);
+  OLA_ASSERT_NOT_NULL(universe1);
+  OLA_ASSERT_NOT_NULL(universe3);
+  DmxBuffer buffer(SAMPLE_DMX_DATA, sizeof(SAMPLE_DMX_DATA));
+  universe3->SetDMX(buffer);
+
+  RpcSession session(NULL);
+  RpcController controller(&session);
+  ola::proto::UniverseListRequest request;
+  ola::proto::DmxDataList response;
+  request.add_universe(1);
+  request.add_universe(2);
+  request.add_universe(3);
+
+  bool called = false;
+  service.GetDmxList(&controller, &request, &response,
+                     NewSingleCallback(&MarkAsCalled, &called));
+  OLA_ASSERT(called);
+  OLA_ASSERT_FALSE(controller.Failed());
+
+  // Universe 2 doesn't exist, so it's skipped.
+  OLA_ASSERT_EQ(2, response.data_size());
+  OLA_ASSERT_EQ(1, response.data(0).universe());
+  OLA_ASSERT_EQ(DmxBuffer(), DmxBuffer(response.data(0).data()));
+  OLA_ASSERT_EQ(3, response.data(1).universe());
+  OLA_ASSERT_EQ(buffer, DmxBuffer(response.data(1).data()));
+
+  // An empty request returns no data.
+  RpcController empty_controller(&session);
+  ola::proto::UniverseListRequest empty_request;
+  ola::proto::DmxDataList empty_response;
+  called = false;
+  service.GetDmxList(&empty_controller, &empty_request, &empty_response,
+                     NewSingleCallback(&MarkAsCalled, &called));
+  OLA_ASSERT(called);
+  OLA_ASSERT_FALSE(empty_controller.Failed());
+  OLA_ASSERT_EQ(0, empty_response.data_size());
+}
+
+
 /*
  * Check the RegisterForDmx method works
  */
@@ -20,6 +20,7 @@
 
 #include <sys/time.h>
 #include <iostream>
+#include <map>
 #include <string>
 #include <vector>
 
@@ -55,6 +56,7 @@ using ola::web::JsonArray;
 using ola::web::JsonObject;
 using std::cout;
 using std::endl;
+using std::map;
 using std::ostringstream;
 using std::string;
 using std::vector;
@@ -725,21 +727,45 @@ int OladHTTPServer::SetPluginState(const HTTPRequest *request,
  * @param request the HTTPRequest
  * @param response the HTTPResponse
  * @returns MHD_NO or MHD_YES
+ *
+ * If more than one universe is requested, the data for all of them is fetched
+ * with a single request, and returned in the universes array. The web UIs only
+ * show one universe at a time, so they don't use this yet.
  */
 int OladHTTPServer::GetDmx(const HTTPRequest *request,
                            HTTPResponse *response) {
   if (request->CheckParameterExists(HELP_PARAMETER)) {
-    return ServeUsage(response, "?u=[universe]");
+    return ServeUsage(
+        response,
+        "?u=[universe],[universe]...</p><p>"
+        "For a single universe the response is {\"dmx\": [values], "
+        "\"error\": \"\"}. For more than one universe it's "
+        "{\"universes\": [{\"universe\": [universe], \"dmx\": [values]}, "
+        "...], \"error\": \"\"}, universes that don't exist are left out.");
   }
-  string uni_id = request->GetParameter("u");
-  unsigned int universe_id;
-  if (!StringToInt(uni_id, &universe_id)) {
-    return ServeHelpRedirect(response);
+  vector<string> uni_ids;
+  StringSplit(request->GetParameter("u"), &uni_ids, ",");
+
+  vector<unsigned int> universe_ids;
+  vector<string>::const_iterator iter = uni_ids.begin();
+  for (; iter != uni_ids.end(); ++iter) {
+    unsigned int universe_id;
+    if (!StringToInt(*iter, &universe_id)) {
+      return ServeHelpRedirect(response);
+    }
+    universe_ids.push_back(universe_id);
   }
 
-  m_client.FetchDMX(
-      universe_id,
-      NewSingleCallback(this, &OladHTTPServer::HandleGetDmx, response));
+  if (universe_ids.size() == 1) {
+    m_client.FetchDMX(
+        universe_ids[0],
+        NewSingleCallback(this, &OladHTTPServer::HandleGetDmx, response));
+  } else {
+    m_client.FetchDMX(
+        universe_ids,
+        NewSingleCallback(this, &OladHTTPServer::HandleGetMultipleDmx,
+                          response));
+  }
   return MHD_YES;
 }
 
@@ -1206,6 +1232,37 @@ void OladHTTPServer::HandleGetDmx(HTTPResponse *response,
 }
 
 
+/**
+ * @brief Callback for m_client.FetchDmx called by GetDmx, when there are
+ *   multiple universes.
+ * @param response the HTTPResponse
+ * @param result the result of the API call
+ * @param data the DmxBuffer for each universe
+ */
+void OladHTTPServer::HandleGetMultipleDmx(
+    HTTPResponse *response,
+    const client::Result &result,
+    const map<unsigned int, DmxBuffer> &data) {
+  JsonObject json;
+  JsonArray *universes = json.AddArray("universes");
+  map<unsigned int, DmxBuffer>::const_iterator iter = data.begin();
+  for (; iter != data.end(); ++iter) {
+    JsonObject *universe = universes->AppendObject();
+    universe->Add("universe", iter->first);
+    // rather than adding 512 JsonValue we cheat and use raw here
+    ostringstream str;
+    str << "[" << iter->second.ToString() << "]";
+    universe->AddRaw("dmx", str.str());
+  }
+  json.Add("error", result.Error());
+
+  response->SetNoCache();
+  response->SetContentType(HTTPServer::CONTENT_TYPE_PLAIN);
+  response->SendJson(json);
+  delete response;
+}
+
+
 /**
  * @brief Handle the set DMX response.
  * @param response the HTTPResponse that is associated with the request.
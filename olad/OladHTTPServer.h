@@ -22,6 +22,7 @@
 #define OLAD_OLADHTTPSERVER_H_
 
 #include <time.h>
+#include <map>
 #include <string>
 #include <vector>
 #include "ola/ExportMap.h"
@@ -164,6 +165,10 @@ class OladHTTPServer: public ola::http::OlaHTTPServer {
                     const client::DMXMetadata &metadata,
                     const DmxBuffer &buffer);
 
+  void HandleGetMultipleDmx(ola::http::HTTPResponse *response,
+                            const client::Result &result,
+                            const std::map<unsigned int, DmxBuffer> &data);
+
   void HandleBoolResponse(ola::http::HTTPResponse *response,
                           const client::Result &result);
 
@@ -20,23 +20,35 @@
 
 #include "olad/PluginManager.h"
 
+#include <algorithm>
+#include <map>
 #include <set>
 #include <vector>
+#include "ola/Callback.h"
+#include "ola/ExportMap.h"
 #include "ola/Logging.h"
 #include "ola/stl/STLUtils.h"
+#include "ola/thread/ThreadPool.h"
 #include "olad/Plugin.h"
 #include "olad/PluginAdaptor.h"
 #include "olad/PluginLoader.h"
 
 namespace ola {
 
-using std::vector;
+using ola::thread::ThreadPool;
+using std::map;
 using std::set;
+using std::vector;
+
+const unsigned int PluginManager::DEFAULT_STARTUP_THREADS;
+const char PluginManager::K_PLUGIN_START_TIME_VAR[] = "plugin-start-time-us";
 
 PluginManager::PluginManager(const vector<PluginLoader*> &plugin_loaders,
-                             class PluginAdaptor *plugin_adaptor)
+                             class PluginAdaptor *plugin_adaptor,
+                             unsigned int startup_threads)
     : m_plugin_loaders(plugin_loaders),
-      m_plugin_adaptor(plugin_adaptor) {
+      m_plugin_adaptor(plugin_adaptor),
+      m_startup_threads(std::max(startup_threads, 1u)) {
 }
 
 PluginManager::~PluginManager() {
@@ -78,10 +90,17 @@ void PluginManager::LoadAll() {
   }
 
   // The second pass checks for conflicts and starts each plugin
-  PluginMap::iterator plugin_iter = m_enabled_plugins.begin();
-  for (; plugin_iter != m_enabled_plugins.end(); ++plugin_iter) {
-    StartIfSafe(plugin_iter->second);
-  }
+  vector<AbstractPlugin*> enabled_plugins;
+  STLValues(m_enabled_plugins, &enabled_plugins);
+
+  TimeStamp start, end;
+  Clock clock;
+  clock.CurrentMonotonicTime(&start);
+  StartPlugins(enabled_plugins);
+  clock.CurrentMonotonicTime(&end);
+  OLA_INFO << "Started " << m_active_plugins.size() << " of "
+           << enabled_plugins.size() << " enabled plugins in "
+           << (end - start) << "s";
 }
 
 void PluginManager::UnloadAll() {
@@ -92,6 +111,7 @@ void PluginManager::UnloadAll() {
   m_loaded_plugins.clear();
   m_active_plugins.clear();
   m_enabled_plugins.clear();
+  m_start_times.clear();
 
   vector<PluginLoader*>::iterator iter = m_plugin_loaders.begin();
   for (; iter != m_plugin_loaders.end(); ++iter) {
@@ -182,7 +202,111 @@ void PluginManager::GetConflictList(ola_plugin_id plugin_id,
   }
 }
 
+void PluginManager::StartTimes(
+    map<ola_plugin_id, TimeInterval> *start_times) const {
+  *start_times = m_start_times;
+}
+
+/*
+ * @brief Start a list of plugins, sorted by plugin id.
+ *
+ * Each pass over the list picks the plugins that don't conflict with any
+ * plugin earlier in the list which is yet to be started. The concurrent
+ * plugins from this set are started on the startup threads, the rest are
+ * started from this thread. Plugins that were passed over are retried on the
+ * next pass, once we know if the plugins they conflict with are running.
+ */
+void PluginManager::StartPlugins(const vector<AbstractPlugin*> &plugins) {
+  vector<AbstractPlugin*> pending = plugins;
+
+  while (!pending.empty()) {
+    vector<AbstractPlugin*> concurrent, serial, deferred;
+
+    vector<AbstractPlugin*>::iterator iter = pending.begin();
+    for (; iter != pending.end(); ++iter) {
+      bool conflicts = false;
+      vector<AbstractPlugin*>::const_iterator prior_iter = pending.begin();
+      for (; prior_iter != iter; ++prior_iter) {
+        if (PluginsConflict(*iter, *prior_iter)) {
+          conflicts = true;
+          break;
+        }
+      }
+
+      if (conflicts) {
+        deferred.push_back(*iter);
+      } else if ((*iter)->SupportsConcurrentStart()) {
+        concurrent.push_back(*iter);
+      } else {
+        serial.push_back(*iter);
+      }
+    }
+
+    StartConcurrently(concurrent);
+
+    for (iter = serial.begin(); iter != serial.end(); ++iter) {
+      StartIfSafe(*iter);
+    }
+    pending.swap(deferred);
+  }
+}
+
+/*
+ * @brief Start a set of non-conflicting plugins on the startup threads.
+ *
+ * This blocks until all the plugins have finished starting, so the main loop
+ * doesn't run while the plugins call into the PluginAdaptor.
+ */
+void PluginManager::StartConcurrently(
+    const vector<AbstractPlugin*> &plugins) {
+  vector<StartupState> states;
+  vector<AbstractPlugin*>::const_iterator iter = plugins.begin();
+  for (; iter != plugins.end(); ++iter) {
+    if (IsSafeToStart(*iter)) {
+      StartupState state = {*iter, false, TimeInterval()};
+      states.push_back(state);
+    }
+  }
+
+  if (states.empty()) {
+    return;
+  }
+
+  unsigned int thread_count = std::min(
+      m_startup_threads, static_cast<unsigned int>(states.size()));
+  ThreadPool pool(thread_count);
+  if (thread_count == 1 || !pool.Init()) {
+    vector<StartupState>::iterator state_iter = states.begin();
+    for (; state_iter != states.end(); ++state_iter) {
+      RunStart(&(*state_iter));
+    }
+  } else {
+    vector<StartupState>::iterator state_iter = states.begin();
+    for (; state_iter != states.end(); ++state_iter) {
+      pool.Execute(NewSingleCallback(&PluginManager::RunStart,
+                                     &(*state_iter)));
+    }
+    // The pool drains the queue before the threads exit.
+    pool.JoinAll();
+  }
+
+  vector<StartupState>::const_iterator state_iter = states.begin();
+  for (; state_iter != states.end(); ++state_iter) {
+    CompleteStart(*state_iter);
+  }
+}
+
 bool PluginManager::StartIfSafe(AbstractPlugin *plugin) {
+  if (!IsSafeToStart(plugin)) {
+    return false;
+  }
+
+  StartupState state = {plugin, false, TimeInterval()};
+  RunStart(&state);
+  return CompleteStart(state);
+}
+
+bool PluginManager::IsSafeToStart(const AbstractPlugin *plugin) const {
   AbstractPlugin *conflicting_plugin = CheckForRunningConflicts(plugin);
   if (conflicting_plugin) {
     OLA_WARN << "Not enabling " << plugin->Name()
@@ -191,16 +315,63 @@ bool PluginManager::StartIfSafe(AbstractPlugin *plugin) {
              << " which is already running";
     return false;
   }
+  return true;
+}
+
+/*
+ * @brief Record the outcome of starting a plugin.
+ * @returns true if the plugin started.
+ */
+bool PluginManager::CompleteStart(const StartupState &state) {
+  AbstractPlugin *plugin = state.plugin;
+  m_start_times[plugin->Id()] = state.duration;
+
+  ExportMap *export_map = m_plugin_adaptor->GetExportMap();
+  if (export_map) {
+    (*export_map->GetUIntMapVar(K_PLUGIN_START_TIME_VAR, "plugin"))[
+        plugin->Name()] = state.duration.AsInt();
+  }
 
-  OLA_INFO << "Trying to start " << plugin->Name();
-  bool ok = plugin->Start();
-  if (!ok) {
+  if (!state.started) {
     OLA_WARN << "Failed to start " << plugin->Name();
-  } else {
-    OLA_INFO << "Started " << plugin->Name();
-    STLReplace(&m_active_plugins, plugin->Id(), plugin);
+    return false;
   }
-  return ok;
+
+  OLA_INFO << "Started " << plugin->Name() << " in " << state.duration
+           << "s";
+  STLReplace(&m_active_plugins, plugin->Id(), plugin);
+  return true;
+}
+
+/*
+ * @brief Call Start() on a plugin, and measure how long it takes.
+ *
+ * This may be run on one of the startup threads.
+ */
+void PluginManager::RunStart(StartupState *state) {
+  OLA_INFO << "Trying to start " << state->plugin->Name();
+  Clock clock;
+  TimeStamp start, end;
+  clock.CurrentMonotonicTime(&start);
+  state->started = state->plugin->Start();
+  clock.CurrentMonotonicTime(&end);
+  state->duration = end - start;
+}
+
+/*
+ * @brief Check if either plugin lists the other as a conflict.
+ */
+bool PluginManager::PluginsConflict(const AbstractPlugin *plugin1,
+                                    const AbstractPlugin *plugin2) {
+  set<ola_plugin_id> conflict_list;
+  plugin1->ConflictsWith(&conflict_list);
+  if (STLContains(conflict_list, plugin2->Id())) {
+    return true;
+  }
+
+  conflict_list.clear();
+  plugin2->ConflictsWith(&conflict_list);
+  return STLContains(conflict_list, plugin1->Id());
 }
 
 /*
@@ -24,6 +24,7 @@
 #include <map>
 #include <vector>
 
+#include "ola/Clock.h"
 #include "ola/base/Macro.h"
 #include "ola/plugin_id.h"
 
@@ -48,6 +49,12 @@ class AbstractPlugin;
  *
  * Plugins are active if they weren't disabled, there were no conflicts that
  * prevented them from loading, and the call to Start() was successful.
+ *
+ * Plugins that support it are started concurrently on a pool of startup
+ * threads. Startup proceeds in waves so that the set of plugins which end up
+ * running is the same as if they had been started one at a time in plugin id
+ * order. The time taken to start each plugin is exported as the
+ * plugin-start-time-us variable.
  */
 class PluginManager {
  public:
@@ -55,9 +62,13 @@ class PluginManager {
    * @brief Create a new PluginManager.
    * @param plugin_loaders the list of PluginLoader to use.
    * @param plugin_adaptor the PluginAdaptor to pass to each plugin.
+   * @param startup_threads the maximum number of threads to use when
+   *   starting plugins. If this is 1, all plugins are started from the
+   *   calling thread.
    */
   PluginManager(const std::vector<PluginLoader*> &plugin_loaders,
-                PluginAdaptor *plugin_adaptor);
+                PluginAdaptor *plugin_adaptor,
+                unsigned int startup_threads = DEFAULT_STARTUP_THREADS);
 
   /**
    * @brief Destructor.
@@ -142,18 +153,45 @@ class PluginManager {
   void GetConflictList(ola_plugin_id plugin_id,
                        std::vector<AbstractPlugin*> *plugins);
 
+  /**
+   * @brief Return how long each plugin took to start.
+   * @param[out] start_times a map of plugin id to the duration of the most
+   *   recent call to Start().
+   */
+  void StartTimes(std::map<ola_plugin_id, TimeInterval> *start_times) const;
+
+  static const unsigned int DEFAULT_STARTUP_THREADS = 4;
+
  private:
   typedef std::map<ola_plugin_id, AbstractPlugin*> PluginMap;
 
+  struct StartupState {
+    AbstractPlugin *plugin;
+    bool started;
+    TimeInterval duration;
+  };
+
   std::vector<PluginLoader*> m_plugin_loaders;
   PluginMap m_loaded_plugins;  // plugins that are loaded
   PluginMap m_active_plugins;  // active plugins
   PluginMap m_enabled_plugins;  // enabled plugins
+  std::map<ola_plugin_id, TimeInterval> m_start_times;
   PluginAdaptor *m_plugin_adaptor;
+  const unsigned int m_startup_threads;
 
+  void StartPlugins(const std::vector<AbstractPlugin*> &plugins);
+  void StartConcurrently(const std::vector<AbstractPlugin*> &plugins);
   bool StartIfSafe(AbstractPlugin *plugin);
+  bool IsSafeToStart(const AbstractPlugin *plugin) const;
+  bool CompleteStart(const StartupState &state);
   AbstractPlugin* CheckForRunningConflicts(const AbstractPlugin *plugin) const;
 
+  static void RunStart(StartupState *state);
+  static bool PluginsConflict(const AbstractPlugin *plugin1,
+                              const AbstractPlugin *plugin2);
+
+  static const char K_PLUGIN_START_TIME_VAR[];
+
   DISALLOW_COPY_AND_ASSIGN(PluginManager);
 };
 }  // namespace ola
@@ -19,6 +19,7 @@
  */
 
 #include <cppunit/extensions/HelperMacros.h>
+#include <map>
 #include <set>
 #include <string>
 #include <vector>
@@ -29,12 +30,15 @@
 #include "olad/PluginManager.h"
 #include "olad/Preferences.h"
 #include "olad/plugin_api/TestCommon.h"
+#include "ola/stl/STLUtils.h"
 #include "ola/testing/TestUtils.h"
 
 
 using ola::AbstractPlugin;
 using ola::PluginLoader;
 using ola::PluginManager;
+using ola::TimeInterval;
+using std::map;
 using std::set;
 using std::string;
 using std::vector;
@@ -44,11 +48,13 @@ class PluginManagerTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(PluginManagerTest);
   CPPUNIT_TEST(testPluginManager);
   CPPUNIT_TEST(testConflictingPlugins);
+  CPPUNIT_TEST(testConcurrentStart);
   CPPUNIT_TEST_SUITE_END();
 
  public:
     void testPluginManager();
     void testConflictingPlugins();
+    void testConcurrentStart();
 
     void setUp() {
       ola::InitLogging(ola::OLA_LOG_INFO, ola::OLA_LOG_STDERR);
@@ -181,3 +187,60 @@ void PluginManagerTest::testConflictingPlugins() {
   manager.UnloadAll();
   VerifyPluginCounts(&manager, 0, 0, OLA_SOURCELINE());
 }
+
+
+/*
+ * Check that plugins started on the startup threads honor the conflict list
+ * in the same way as plugins started one at a time.
+ */
+void PluginManagerTest::testConcurrentStart() {
+  ola::MemoryPreferencesFactory factory;
+  ola::PluginAdaptor adaptor(NULL, NULL, NULL, &factory, NULL, NULL, NULL);
+
+  set<ola::ola_plugin_id> conflict_set1, conflict_set2, conflict_set3;
+  conflict_set1.insert(ola::OLA_PLUGIN_ARTNET);
+  TestMockPlugin plugin1(&adaptor, ola::OLA_PLUGIN_DUMMY, conflict_set1);
+  TestMockPlugin plugin2(&adaptor, ola::OLA_PLUGIN_ARTNET);
+  conflict_set2.insert(ola::OLA_PLUGIN_ARTNET);
+  TestMockPlugin plugin3(&adaptor, ola::OLA_PLUGIN_SHOWNET, conflict_set2);
+  conflict_set3.insert(ola::OLA_PLUGIN_DUMMY);
+  TestMockPlugin plugin4(&adaptor, ola::OLA_PLUGIN_SANDNET, conflict_set3);
+  TestMockPlugin plugin5(&adaptor, ola::OLA_PLUGIN_ESPNET);
+
+  plugin1.SetConcurrentStart(true);
+  plugin2.SetConcurrentStart(true);
+  plugin3.SetConcurrentStart(true);
+  plugin4.SetConcurrentStart(true);
+
+  vector<AbstractPlugin*> our_plugins;
+  our_plugins.push_back(&plugin1);
+  our_plugins.push_back(&plugin2);
+  our_plugins.push_back(&plugin3);
+  our_plugins.push_back(&plugin4);
+  our_plugins.push_back(&plugin5);
+
+  MockLoader loader(our_plugins);
+  vector<PluginLoader*> loaders;
+  loaders.push_back(&loader);
+
+  PluginManager manager(loaders, &adaptor, 4);
+  manager.LoadAll();
+
+  VerifyPluginCounts(&manager, 5, 3, OLA_SOURCELINE());
+
+  OLA_ASSERT_TRUE(plugin1.IsRunning());
+  OLA_ASSERT_FALSE(plugin2.IsRunning());
+  OLA_ASSERT_TRUE(plugin3.IsRunning());
+  OLA_ASSERT_FALSE(plugin4.IsRunning());
+  OLA_ASSERT_TRUE(plugin5.IsRunning());
+
+  map<ola::ola_plugin_id, TimeInterval> start_times;
+  manager.StartTimes(&start_times);
+  OLA_ASSERT_EQ(static_cast<size_t>(3), start_times.size());
+  OLA_ASSERT_TRUE(ola::STLContains(start_times, ola::OLA_PLUGIN_DUMMY));
+  OLA_ASSERT_TRUE(ola::STLContains(start_times, ola::OLA_PLUGIN_SHOWNET));
+  OLA_ASSERT_TRUE(ola::STLContains(start_times, ola::OLA_PLUGIN_ESPNET));
+
+  manager.UnloadAll();
+  VerifyPluginCounts(&manager, 0, 0, OLA_SOURCELINE());
+}
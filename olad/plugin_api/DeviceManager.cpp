@@ -121,6 +121,9 @@ bool DeviceManager::RegisterDevice(AbstractDevice *device) {
     }
   }
 
+  if (device->SupportsFrameCommit()) {
+    m_frame_commit_devices.insert(device);
+  }
   return true;
 }
 
@@ -195,12 +198,25 @@ void DeviceManager::SendTimeCode(const ola::timecode::TimeCode &timecode) {
   }
 }
 
+void DeviceManager::CommitFrames() {
+  set<AbstractDevice*>::iterator iter = m_frame_commit_devices.begin();
+  for (; iter != m_frame_commit_devices.end(); ++iter) {
+    (*iter)->CommitFrame();
+  }
+}
+
 /*
  * Save the port universe patchings for a device
  * @param device the device to save the settings for
  */
 void DeviceManager::ReleaseDevice(const AbstractDevice *device) {
-  if (!m_port_preferences || !device) {
+  if (!device) {
+    return;
+  }
+
+  m_frame_commit_devices.erase(const_cast<AbstractDevice*>(device));
+
+  if (!m_port_preferences) {
     return;
   }
 
@@ -135,6 +135,11 @@ class DeviceManager {
    */
   void SendTimeCode(const ola::timecode::TimeCode &timecode);
 
+  /**
+   * @brief Call CommitFrame() on all devices which support it.
+   */
+  void CommitFrames();
+
   static const unsigned int MISSING_DEVICE_ALIAS;
 
  private:
@@ -149,6 +154,7 @@ class DeviceManager {
 
   unsigned int m_next_device_alias;
   std::set<class OutputPort*> m_timecode_ports;
+  std::set<AbstractDevice*> m_frame_commit_devices;
 
   void ReleaseDevice(const AbstractDevice *device);
   void RestoreDevicePortSettings(AbstractDevice *device);
@@ -47,17 +47,34 @@ using std::string;
 using std::vector;
 
 
+/*
+ * A mock device which counts the calls to CommitFrame()
+ */
+class MockCommitDevice: public MockDevice {
+ public:
+  MockCommitDevice(AbstractPlugin *owner, const string &name)
+      : MockDevice(owner, name),
+        commit_count(0) {}
+  bool SupportsFrameCommit() const { return true; }
+  void CommitFrame() { commit_count++; }
+
+  unsigned int commit_count;
+};
+
+
 class DeviceManagerTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(DeviceManagerTest);
   CPPUNIT_TEST(testDeviceManager);
   CPPUNIT_TEST(testRestorePatchings);
   CPPUNIT_TEST(testRestorePriorities);
+  CPPUNIT_TEST(testCommitFrames);
   CPPUNIT_TEST_SUITE_END();
 
  public:
     void testDeviceManager();
     void testRestorePatchings();
     void testRestorePriorities();
+    void testCommitFrames();
 };
 
 
@@ -291,3 +308,33 @@ void DeviceManagerTest::testRestorePriorities() {
   OLA_ASSERT_EQ(string("60"),
                 prefs->GetValue("2-test_device_1-O-3_priority_value"));
 }
+
+
+/*
+ * Check that only devices which support it have CommitFrame() called.
+ */
+void DeviceManagerTest::testCommitFrames() {
+  DeviceManager manager(NULL, NULL);
+  TestMockPlugin plugin(NULL, ola::OLA_PLUGIN_ARTNET);
+  MockDevice device1(&plugin, "test device 1");
+  MockCommitDevice device2(&plugin, "test device 2");
+
+  OLA_ASSERT(manager.RegisterDevice(&device1));
+  OLA_ASSERT(manager.RegisterDevice(&device2));
+
+  manager.CommitFrames();
+  OLA_ASSERT_EQ(1u, device2.commit_count);
+  manager.CommitFrames();
+  OLA_ASSERT_EQ(2u, device2.commit_count);
+
+  // Once unregistered, the device isn't called.
+  OLA_ASSERT(manager.UnregisterDevice(&device2));
+  manager.CommitFrames();
+  OLA_ASSERT_EQ(2u, device2.commit_count);
+
+  // Or after everything is unregistered.
+  OLA_ASSERT(manager.RegisterDevice(&device2));
+  manager.UnregisterAllDevices();
+  manager.CommitFrames();
+  OLA_ASSERT_EQ(2u, device2.commit_count);
+}
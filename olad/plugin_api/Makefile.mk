@@ -26,6 +26,8 @@ olad_plugin_api_libolaserverplugininterface_la_SOURCES = \
     olad/plugin_api/PortManager.h \
     olad/plugin_api/Preferences.cpp \
     olad/plugin_api/Universe.cpp \
+    olad/plugin_api/UniverseSnapshot.cpp \
+    olad/plugin_api/UniverseSnapshot.h \
     olad/plugin_api/UniverseStore.cpp \
     olad/plugin_api/UniverseStore.h
 olad_plugin_api_libolaserverplugininterface_la_CXXFLAGS = \
@@ -29,6 +29,7 @@
 namespace ola {
 
 using ola::io::SelectServerInterface;
+using ola::thread::MutexLocker;
 using ola::thread::timeout_id;
 using std::string;
 
@@ -38,72 +39,86 @@ PluginAdaptor::PluginAdaptor(DeviceManager *device_manager,
                              PreferencesFactory *preferences_factory,
                              PortBrokerInterface *port_broker,
                              const std::string *instance_name,
-                             const ola::rdm::UID *default_uid):
+                             const ola::rdm::UID *default_uid,
+                             ola::network::InterfaceMonitor *monitor):
   m_device_manager(device_manager),
   m_ss(select_server),
   m_export_map(export_map),
   m_preferences_factory(preferences_factory),
   m_port_broker(port_broker),
   m_instance_name(instance_name),
-  m_default_uid(default_uid) {
+  m_default_uid(default_uid),
+  m_interface_monitor(monitor),
+  m_mutex(ola::thread::Mutex::RECURSIVE) {
 }
 
 bool PluginAdaptor::AddReadDescriptor(
     ola::io::ReadFileDescriptor *descriptor) {
+  MutexLocker locker(&m_mutex);
   return m_ss->AddReadDescriptor(descriptor);
 }
 
 bool PluginAdaptor::AddReadDescriptor(
     ola::io::ConnectedDescriptor *descriptor,
     bool delete_on_close) {
+  MutexLocker locker(&m_mutex);
   return m_ss->AddReadDescriptor(descriptor, delete_on_close);
 }
 
 void PluginAdaptor::RemoveReadDescriptor(
     ola::io::ReadFileDescriptor *descriptor) {
+  MutexLocker locker(&m_mutex);
   m_ss->RemoveReadDescriptor(descriptor);
 }
 
 void PluginAdaptor::RemoveReadDescriptor(
     ola::io::ConnectedDescriptor *descriptor) {
+  MutexLocker locker(&m_mutex);
   m_ss->RemoveReadDescriptor(descriptor);
 }
 
 bool PluginAdaptor::AddWriteDescriptor(
     ola::io::WriteFileDescriptor *descriptor) {
+  MutexLocker locker(&m_mutex);
   return m_ss->AddWriteDescriptor(descriptor);
 }
 
 void PluginAdaptor::RemoveWriteDescriptor(
     ola::io::WriteFileDescriptor *descriptor) {
+  MutexLocker locker(&m_mutex);
   m_ss->RemoveWriteDescriptor(descriptor);
 }
 
 timeout_id PluginAdaptor::RegisterRepeatingTimeout(
     unsigned int ms,
     Callback0<bool> *closure) {
+  MutexLocker locker(&m_mutex);
   return m_ss->RegisterRepeatingTimeout(ms, closure);
 }
 
 timeout_id PluginAdaptor::RegisterRepeatingTimeout(
     const TimeInterval &interval,
     Callback0<bool> *closure) {
+  MutexLocker locker(&m_mutex);
   return m_ss->RegisterRepeatingTimeout(interval, closure);
 }
 
 timeout_id PluginAdaptor::RegisterSingleTimeout(
     unsigned int ms,
     SingleUseCallback0<void> *closure) {
+  MutexLocker locker(&m_mutex);
   return m_ss->RegisterSingleTimeout(ms, closure);
 }
 
 timeout_id PluginAdaptor::RegisterSingleTimeout(
     const TimeInterval &interval,
     SingleUseCallback0<void> *closure) {
+  MutexLocker locker(&m_mutex);
   return m_ss->RegisterSingleTimeout(interval, closure);
 }
 
 void PluginAdaptor::RemoveTimeout(timeout_id id) {
+  MutexLocker locker(&m_mutex);
   m_ss->RemoveTimeout(id);
 }
 
@@ -116,14 +131,17 @@ void PluginAdaptor::DrainCallbacks() {
 }
 
 bool PluginAdaptor::RegisterDevice(AbstractDevice *device) const {
+  MutexLocker locker(&m_mutex);
   return m_device_manager->RegisterDevice(device);
 }
 
 bool PluginAdaptor::UnregisterDevice(AbstractDevice *device) const {
+  MutexLocker locker(&m_mutex);
   return m_device_manager->UnregisterDevice(device);
 }
 
 Preferences *PluginAdaptor::NewPreference(const string &name) const {
+  MutexLocker locker(&m_mutex);
   return m_preferences_factory->NewPreference(name);
 }
 
@@ -45,6 +45,7 @@
 #include <list>
 #include <map>
 #include <memory>
+#include <sstream>
 #include <string>
 #include <utility>
 #include <vector>
@@ -60,35 +61,29 @@
 namespace ola {
 
 using ola::thread::Mutex;
+using ola::thread::MutexLocker;
 using ola::thread::ConditionVariable;
 using std::ifstream;
-using std::ofstream;
 using std::map;
 using std::pair;
 using std::string;
 using std::vector;
 
 namespace {
-void SavePreferencesToFile(
-    const string *filename_ptr,
-    const FilePreferenceSaverThread::PreferencesMap *pref_map_ptr) {
-  std::auto_ptr<const string> filename(filename_ptr);
-  std::auto_ptr<const FilePreferenceSaverThread::PreferencesMap> pref_map(
-      pref_map_ptr);
-
+bool SavePreferencesToFile(
+    const string &filename,
+    const FilePreferenceSaverThread::PreferencesMap &pref_map) {
+  std::ostringstream output;
   FilePreferenceSaverThread::PreferencesMap::const_iterator iter;
-  ofstream pref_file(filename->data());
-
-  if (!pref_file.is_open()) {
-    OLA_WARN << "Could not open " << *filename_ptr << ": " << strerror(errno);
-    return;
+  for (iter = pref_map.begin(); iter != pref_map.end(); ++iter) {
+    output << iter->first << " = " << iter->second << std::endl;
   }
 
-  for (iter = pref_map->begin(); iter != pref_map->end(); ++iter) {
-    pref_file << iter->first << " = " << iter->second << std::endl;
+  if (!ola::file::WriteFileAtomically(filename, output.str())) {
+    OLA_WARN << "Could not save " << filename;
+    return false;
   }
-  pref_file.flush();
-  pref_file.close();
+  return true;
 }
 }  // namespace
 
@@ -250,13 +245,23 @@ MemoryPreferences::~MemoryPreferences() {
 
 void MemoryPreferences::Clear() {
   m_pref_map.clear();
+  m_revision++;
 }
 
 
 void MemoryPreferences::SetValue(const string &key,
                                  const string &value) {
-  m_pref_map.erase(key);
+  pair<PreferencesMap::iterator, PreferencesMap::iterator> range =
+      m_pref_map.equal_range(key);
+  PreferencesMap::iterator next = range.first;
+  if (range.first != range.second && range.first->second == value &&
+      ++next == range.second) {
+    // The value is unchanged, don't mark the preferences as dirty.
+    return;
+  }
+  m_pref_map.erase(range.first, range.second);
   m_pref_map.insert(make_pair(key, value));
+  m_revision++;
 }
 
 
@@ -273,6 +278,7 @@ void MemoryPreferences::SetValue(const string &key, int value) {
 void MemoryPreferences::SetMultipleValue(const string &key,
                                          const string &value) {
   m_pref_map.insert(make_pair(key, value));
+  m_revision++;
 }
 
 
@@ -360,7 +366,9 @@ bool MemoryPreferences::HasKey(const string &key) const {
 
 
 void MemoryPreferences::RemoveValue(const string &key) {
-  m_pref_map.erase(key);
+  if (m_pref_map.erase(key)) {
+    m_revision++;
+  }
 }
 
 
@@ -385,25 +393,39 @@ void MemoryPreferences::SetValueAsBool(const string &key, bool value) {
 // FilePreferenceSaverThread
 //-----------------------------------------------------------------------------
 
-FilePreferenceSaverThread::FilePreferenceSaverThread()
-    : Thread(Thread::Options("pref-saver")) {
+FilePreferenceSaverThread::FilePreferenceSaverThread(
+    unsigned int save_delay_ms)
+    : Thread(Thread::Options("pref-saver")),
+      m_save_delay_ms(save_delay_ms),
+      m_flush_scheduled(false),
+      m_write_count(0) {
   // set a long poll interval so we don't spin
   m_ss.SetDefaultInterval(TimeInterval(60, 0));
 }
 
+FilePreferenceSaverThread::~FilePreferenceSaverThread() {
+  STLDeleteValues(&m_pending);
+}
+
 void FilePreferenceSaverThread::SavePreferences(
     const string &file_name,
     const PreferencesMap &preferences) {
-  const string *file_name_ptr = new string(file_name);
-  const PreferencesMap *save_map = new PreferencesMap(preferences);
-  SingleUseCallback0<void> *cb =
-      NewSingleCallback(SavePreferencesToFile, file_name_ptr, save_map);
-  m_ss.Execute(cb);
+  PreferencesMap *save_map = new PreferencesMap(preferences);
+
+  MutexLocker locker(&m_pending_mutex);
+  STLReplaceAndDelete(&m_pending, file_name, save_map);
+  if (!m_flush_scheduled) {
+    m_flush_scheduled = true;
+    m_ss.Execute(
+        NewSingleCallback(this, &FilePreferenceSaverThread::ScheduleFlush));
+  }
 }
 
 
 void *FilePreferenceSaverThread::Run() {
   m_ss.Run();
+  // Write anything that's still outstanding before we exit.
+  FlushPending();
   return NULL;
 }
 
@@ -427,9 +449,46 @@ void FilePreferenceSaverThread::Synchronize() {
 }
 
 
+unsigned int FilePreferenceSaverThread::WriteCount() const {
+  MutexLocker locker(&m_pending_mutex);
+  return m_write_count;
+}
+
+
+void FilePreferenceSaverThread::ScheduleFlush() {
+  m_ss.RegisterSingleTimeout(
+      m_save_delay_ms,
+      NewSingleCallback(this, &FilePreferenceSaverThread::FlushPending));
+}
+
+
+void FilePreferenceSaverThread::FlushPending() {
+  PendingMap pending;
+  {
+    MutexLocker locker(&m_pending_mutex);
+    pending.swap(m_pending);
+    m_flush_scheduled = false;
+  }
+
+  unsigned int writes = 0;
+  PendingMap::iterator iter = pending.begin();
+  for (; iter != pending.end(); ++iter) {
+    if (SavePreferencesToFile(iter->first, *iter->second)) {
+      writes++;
+    }
+  }
+  STLDeleteValues(&pending);
+
+  MutexLocker locker(&m_pending_mutex);
+  m_write_count += writes;
+}
+
+
 void FilePreferenceSaverThread::CompleteSynchronization(
     ConditionVariable *condition,
     Mutex *mutex) {
+  // Don't wait for the save delay, write out any pending changes now.
+  FlushPending();
   // calling lock here forces us to block until Wait() is called on the
   // condition_var.
   mutex->Lock();
@@ -447,7 +506,11 @@ bool FileBackedPreferences::Load() {
 
 
 bool FileBackedPreferences::Save() const {
+  if (m_saved_revision == m_revision) {
+    return true;
+  }
   m_saver_thread->SavePreferences(FileName(), m_pref_map);
+  m_saved_revision = m_revision;
   return true;
 }
 
@@ -491,6 +554,9 @@ bool FileBackedPreferences::LoadFromFile(const string &filename) {
     m_pref_map.insert(make_pair(key, value));
   }
   pref_file.close();
+  // What's in memory now matches what's on disk.
+  m_revision++;
+  m_saved_revision = m_revision;
   return true;
 }
 }  // namespace ola
@@ -53,6 +53,7 @@ class PreferencesTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testFactory);
   CPPUNIT_TEST(testLoad);
   CPPUNIT_TEST(testSave);
+  CPPUNIT_TEST(testCoalescedSave);
   CPPUNIT_TEST_SUITE_END();
 
  public:
@@ -65,6 +66,7 @@ class PreferencesTest: public CppUnit::TestFixture {
     void testFactory();
     void testLoad();
     void testSave();
+    void testCoalescedSave();
 };
 
 
@@ -413,3 +415,45 @@ void PreferencesTest::testSave() {
 
   saver_thread.Join();
 }
+
+
+/*
+ * Check that repeated saves are coalesced into a single write.
+ */
+void PreferencesTest::testCoalescedSave() {
+  const string data_path = TEST_BUILD_DIR "/olad/ola-coalesced.conf";
+
+  // Use a long delay so only Synchronize() triggers the write.
+  ola::FilePreferenceSaverThread saver_thread(60000);
+  saver_thread.Start();
+  FileBackedPreferences preferences(TEST_BUILD_DIR "/olad", "coalesced",
+                                    &saver_thread);
+  unlink(data_path.c_str());
+
+  for (unsigned int i = 0; i < 100; i++) {
+    preferences.SetValue("uni_1_name", i);
+    preferences.SetValue("uni_2_name", "foo");
+    OLA_ASSERT(preferences.Save());
+  }
+  saver_thread.Synchronize();
+  OLA_ASSERT_EQ(1u, saver_thread.WriteCount());
+
+  // Nothing has changed, so this shouldn't write the file again.
+  preferences.SetValue("uni_2_name", "foo");
+  OLA_ASSERT(preferences.Save());
+  saver_thread.Synchronize();
+  OLA_ASSERT_EQ(1u, saver_thread.WriteCount());
+
+  FileBackedPreferences input_preferences("", "input", NULL);
+  OLA_ASSERT(input_preferences.LoadFromFile(data_path));
+  OLA_ASSERT(preferences == input_preferences);
+  OLA_ASSERT_EQ(string("99"), input_preferences.GetValue("uni_1_name"));
+
+  // Pending writes are flushed when the thread is stopped.
+  preferences.RemoveValue("uni_2_name");
+  OLA_ASSERT(preferences.Save());
+  saver_thread.Join();
+  OLA_ASSERT_EQ(2u, saver_thread.WriteCount());
+  OLA_ASSERT(input_preferences.LoadFromFile(data_path));
+  OLA_ASSERT_FALSE(input_preferences.HasKey("uni_2_name"));
+}
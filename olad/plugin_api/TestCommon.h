@@ -218,6 +218,7 @@ class TestMockPlugin: public ola::Plugin {
       : Plugin(plugin_adaptor),
         m_is_running(false),
         m_enabled(enabled),
+        m_concurrent_start(false),
         m_id(plugin_id) {}
 
   TestMockPlugin(ola::PluginAdaptor *plugin_adaptor,
@@ -227,6 +228,7 @@ class TestMockPlugin: public ola::Plugin {
       : Plugin(plugin_adaptor),
         m_is_running(false),
         m_enabled(enabled),
+        m_concurrent_start(false),
         m_id(plugin_id),
         m_conflict_set(conflict_set) {}
 
@@ -258,11 +260,15 @@ class TestMockPlugin: public ola::Plugin {
   ola::ola_plugin_id Id() const { return m_id; }
   std::string PluginPrefix() const { return "test"; }
 
+  bool SupportsConcurrentStart() const { return m_concurrent_start; }
+  void SetConcurrentStart(bool concurrent) { m_concurrent_start = concurrent; }
+
   bool IsRunning() { return m_is_running; }
 
  private:
   bool m_is_running;
   bool m_enabled;
+  bool m_concurrent_start;
   ola::ola_plugin_id m_id;
   std::set<ola::ola_plugin_id> m_conflict_set;
 };
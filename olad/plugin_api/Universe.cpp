@@ -40,6 +40,7 @@
 #include <vector>
 
 #include "ola/base/Array.h"
+#include "ola/Callback.h"
 #include "ola/Logging.h"
 #include "ola/MultiCallback.h"
 #include "ola/rdm/RDMCommand.h"
@@ -59,6 +60,7 @@ using ola::rdm::RDMRequest;
 using ola::rdm::RunRDMCallback;
 using ola::rdm::UID;
 using ola::strings::ToHex;
+using ola::thread::INVALID_TIMEOUT;
 using std::auto_ptr;
 using std::map;
 using std::ostringstream;
@@ -66,14 +68,22 @@ using std::set;
 using std::string;
 using std::vector;
 
+// How often the data is updated during a fade.
+static const unsigned int FADE_STEP_INTERVAL_MS = 25;
+
+const char Universe::K_EXPIRY_FADE_STR[] = "fade";
+const char Universe::K_EXPIRY_HOLD_STR[] = "hold";
+const char Universe::K_EXPIRY_RELEASE_STR[] = "release";
 const char Universe::K_UNIVERSE_UID_COUNT_VAR[] = "universe-uids";
 const char Universe::K_FPS_VAR[] = "universe-dmx-frames";
 const char Universe::K_MERGE_HTP_STR[] = "htp";
 const char Universe::K_MERGE_LTP_STR[] = "ltp";
 const char Universe::K_UNIVERSE_INPUT_PORT_VAR[] = "universe-input-ports";
+const char Universe::K_UNIVERSE_INPUT_RATE_VAR[] = "universe-input-fps";
 const char Universe::K_UNIVERSE_MODE_VAR[] = "universe-mode";
 const char Universe::K_UNIVERSE_NAME_VAR[] = "universe-name";
 const char Universe::K_UNIVERSE_OUTPUT_PORT_VAR[] = "universe-output-ports";
+const char Universe::K_UNIVERSE_OUTPUT_RATE_VAR[] = "universe-output-fps";
 const char Universe::K_UNIVERSE_RDM_REQUESTS[] = "universe-rdm-requests";
 const char Universe::K_UNIVERSE_SINK_CLIENTS_VAR[] = "universe-sink-clients";
 const char Universe::K_UNIVERSE_SOURCE_CLIENTS_VAR[] =
@@ -93,11 +103,23 @@ Universe::Universe(unsigned int universe_id, UniverseStore *store,
       m_active_priority(ola::dmx::SOURCE_PRIORITY_MIN),
       m_merge_mode(Universe::MERGE_LTP),
       m_universe_store(store),
+      m_restored_dmx(false),
       m_export_map(export_map),
       m_clock(clock),
       m_rdm_discovery_interval(),
       m_last_discovery_time(),
-      m_transaction_number_sequence() {
+      m_transaction_number_sequence(),
+      m_ss(NULL),
+      m_expiry_mode(EXPIRY_RELEASE),
+      m_expiry_fade_time(),
+      m_fade_timeout(INVALID_TIMEOUT),
+      m_fade_step(0),
+      m_fade_steps(0),
+      m_max_output_rate(0),
+      m_merge_pending(false),
+      m_output_pending(false),
+      m_input_frames(0),
+      m_output_frames(0) {
   ostringstream universe_id_str, universe_name_str;
   universe_id_str << universe_id;
   m_universe_id_str = universe_id_str.str();
@@ -110,7 +132,9 @@ Universe::Universe(unsigned int universe_id, UniverseStore *store,
   const char *vars[] = {
     K_FPS_VAR,
     K_UNIVERSE_INPUT_PORT_VAR,
+    K_UNIVERSE_INPUT_RATE_VAR,
     K_UNIVERSE_OUTPUT_PORT_VAR,
+    K_UNIVERSE_OUTPUT_RATE_VAR,
     K_UNIVERSE_RDM_REQUESTS,
     K_UNIVERSE_SINK_CLIENTS_VAR,
     K_UNIVERSE_SOURCE_CLIENTS_VAR,
@@ -133,6 +157,8 @@ Universe::Universe(unsigned int universe_id, UniverseStore *store,
  * Delete this universe
  */
 Universe::~Universe() {
+  SetSelectServer(NULL);
+
   const char *string_vars[] = {
     K_UNIVERSE_NAME_VAR,
     K_UNIVERSE_MODE_VAR,
@@ -141,7 +167,9 @@ Universe::~Universe() {
   const char *uint_vars[] = {
     K_FPS_VAR,
     K_UNIVERSE_INPUT_PORT_VAR,
+    K_UNIVERSE_INPUT_RATE_VAR,
     K_UNIVERSE_OUTPUT_PORT_VAR,
+    K_UNIVERSE_OUTPUT_RATE_VAR,
     K_UNIVERSE_RDM_REQUESTS,
     K_UNIVERSE_SINK_CLIENTS_VAR,
     K_UNIVERSE_SOURCE_CLIENTS_VAR,
@@ -185,12 +213,104 @@ void Universe::SetMergeMode(enum merge_mode merge_mode) {
 }
 
 
+/*
+ * Set what happens when a source times out.
+ */
+void Universe::SetExpiryMode(expiry_mode mode, const TimeInterval &fade_time) {
+  m_expiry_mode = mode;
+  m_expiry_fade_time = fade_time;
+}
+
+
+/*
+ * Set the SelectServer used to time out sources. Any existing timeouts are
+ * cancelled.
+ */
+void Universe::SetSelectServer(ola::io::SelectServerInterface *ss) {
+  CancelFade();
+  SourceStateMap::iterator iter = m_source_states.begin();
+  for (; iter != m_source_states.end(); ++iter) {
+    if (iter->second.timeout != INVALID_TIMEOUT) {
+      m_ss->RemoveTimeout(iter->second.timeout);
+    }
+  }
+  m_source_states.clear();
+  m_ss = ss;
+
+  if (!m_ss) {
+    return;
+  }
+
+  vector<InputPort*>::const_iterator port_iter = m_input_ports.begin();
+  for (; port_iter != m_input_ports.end(); ++port_iter) {
+    TrackSource(*port_iter, *port_iter, NULL, (*port_iter)->SourceData());
+  }
+  SourceClientMap::const_iterator client_iter = m_source_clients.begin();
+  for (; client_iter != m_source_clients.end(); ++client_iter) {
+    TrackSource(client_iter->first, NULL, client_iter->first,
+                client_iter->first->SourceData(m_universe_id));
+  }
+}
+
+
+/*
+ * Limit how often this universe writes to its outputs.
+ * @param max_fps the maximum frames per second, or 0 for no limit
+ */
+void Universe::SetMaxOutputRate(unsigned int max_fps) {
+  m_max_output_rate = max_fps;
+  if (!m_max_output_rate) {
+    // flush anything that was waiting for the next tick
+    OutputTick();
+  }
+}
+
+
+/*
+ * Merge the input that arrived since the last tick, and write the result to
+ * the outputs.
+ */
+void Universe::OutputTick() {
+  if (m_merge_pending) {
+    m_merge_pending = false;
+    if (MergeAll(NULL, NULL)) {
+      m_restored_dmx = false;
+      m_output_pending = true;
+    }
+  }
+
+  if (m_output_pending) {
+    m_output_pending = false;
+    UpdateDependants();
+  }
+}
+
+
+/*
+ * Export the number of frames received and sent since the last call.
+ */
+void Universe::ExportFrameRates() {
+  if (m_export_map) {
+    (*m_export_map->GetUIntMapVar(K_UNIVERSE_INPUT_RATE_VAR))[
+        m_universe_id_str] = m_input_frames;
+    (*m_export_map->GetUIntMapVar(K_UNIVERSE_OUTPUT_RATE_VAR))[
+        m_universe_id_str] = m_output_frames;
+  }
+  m_input_frames = 0;
+  m_output_frames = 0;
+}
+
+
 /*
  * Add an InputPort to this universe.
  * @param port the port to add
  */
 bool Universe::AddPort(InputPort *port) {
-  return GenericAddPort(port, &m_input_ports);
+  bool ok = GenericAddPort(port, &m_input_ports);
+  if (ok) {
+    TrackSource(port, port, NULL, port->SourceData());
+  }
+  return ok;
 }
 
 
@@ -199,7 +319,15 @@ bool Universe::AddPort(InputPort *port) {
  * @param port the port to add
  */
 bool Universe::AddPort(OutputPort *port) {
-  return GenericAddPort(port, &m_output_ports);
+  bool ok = GenericAddPort(port, &m_output_ports);
+  if (ok && m_restored_dmx) {
+    port->WriteDMX(m_buffer, m_active_priority);
+  }
+  if (ok && !m_restored_uids.empty()) {
+    AddRestoredUIDs(port);
+    UpdateUIDCount();
+  }
+  return ok;
 }
 
 
@@ -209,6 +337,7 @@ bool Universe::AddPort(OutputPort *port) {
  * @return true if the port was removed, false if it didn't exist
  */
 bool Universe::RemovePort(InputPort *port) {
+  RemoveSourceState(port);
   return GenericRemovePort(port, &m_input_ports);
 }
 
@@ -220,11 +349,7 @@ bool Universe::RemovePort(InputPort *port) {
  */
 bool Universe::RemovePort(OutputPort *port) {
   bool ret = GenericRemovePort(port, &m_output_ports, &m_output_uids);
-
-  if (m_export_map) {
-    (*m_export_map->GetUIntMapVar(K_UNIVERSE_UID_COUNT_VAR))[m_universe_id_str]
-        = m_output_uids.size();
-  }
+  UpdateUIDCount();
   return ret;
 }
 
@@ -286,6 +411,7 @@ bool Universe::AddSourceClient(Client *client) {
   OLA_INFO << "Added source client, " << client << " to universe "
            << m_universe_id;
 
+  TrackSource(client, NULL, client, client->SourceData(m_universe_id));
   SafeIncrement(K_UNIVERSE_SOURCE_CLIENTS_VAR);
   return true;
 }
@@ -303,6 +429,7 @@ bool Universe::RemoveSourceClient(Client *client) {
     return false;
   }
 
+  RemoveSourceState(client);
   SafeDecrement(K_UNIVERSE_SOURCE_CLIENTS_VAR);
 
   OLA_INFO << "Source client " << client << " has been removed from uni "
@@ -389,10 +516,27 @@ bool Universe::SetDMX(const DmxBuffer &buffer) {
     return true;
   }
   m_buffer.Set(buffer);
+  m_restored_dmx = false;
   return UpdateDependants();
 }
 
 
+/*
+ * Seed the universe with data saved before a restart.
+ * @param buffer the dmx buffer with the data
+ * @param priority the priority of the data
+ */
+void Universe::RestoreDMX(const DmxBuffer &buffer, uint8_t priority) {
+  if (!buffer.Size()) {
+    return;
+  }
+  m_buffer.Set(buffer);
+  m_active_priority = priority;
+  m_restored_dmx = true;
+  UpdateDependants();
+}
+
+
 /*
  * Call this when the dmx in a port that is part of this universe changes
  * @param port the port that has changed
@@ -403,7 +547,17 @@ bool Universe::PortDataChanged(InputPort *port) {
              << UniverseId();
     return false;
   }
-  if (MergeAll(port, NULL)) {
+  TrackSource(port, port, NULL, port->SourceData());
+  m_input_frames++;
+
+  // New data interrupts a fade, which means all sources need to be re-merged.
+  bool fading = m_fade_timeout != INVALID_TIMEOUT;
+  CancelFade();
+  if (m_max_output_rate) {
+    // merged on the next tick
+    m_merge_pending = true;
+  } else if (fading ? MergeAll(NULL, NULL) : MergeAll(port, NULL)) {
+    m_restored_dmx = false;
     UpdateDependants();
   }
   return true;
@@ -419,7 +573,15 @@ bool Universe::SourceClientDataChanged(Client *client) {
   }
 
   AddSourceClient(client);   // always add since this may be the first call
-  if (MergeAll(NULL, client)) {
+  TrackSource(client, NULL, client, client->SourceData(m_universe_id));
+  m_input_frames++;
+
+  bool fading = m_fade_timeout != INVALID_TIMEOUT;
+  CancelFade();
+  if (m_max_output_rate) {
+    m_merge_pending = true;
+  } else if (fading ? MergeAll(NULL, NULL) : MergeAll(NULL, client)) {
+    m_restored_dmx = false;
     UpdateDependants();
   }
   return true;
@@ -434,6 +596,7 @@ void Universe::CleanStaleSourceClients() {
   while (iter != m_source_clients.end()) {
     if (iter->second) {
       // if stale remove it
+      RemoveSourceState(iter->first);
       m_source_clients.erase(iter++);
       SafeDecrement(K_UNIVERSE_SOURCE_CLIENTS_VAR);
       OLA_INFO << "Removed Stale Client";
@@ -582,11 +745,7 @@ void Universe::NewUIDList(OutputPort *port, const ola::rdm::UIDSet &uids) {
       OLA_WARN << "UID " << *set_iter << " seen on more than one port";
     }
   }
-
-  if (m_export_map) {
-    (*m_export_map->GetUIntMapVar(K_UNIVERSE_UID_COUNT_VAR))[m_universe_id_str]
-        = m_output_uids.size();
-  }
+  UpdateUIDCount();
 }
 
 
@@ -601,6 +760,34 @@ void Universe::GetUIDs(ola::rdm::UIDSet *uids) const {
 }
 
 
+/*
+ * Returns the UniqueId() of the port each UID is on.
+ */
+void Universe::GetUIDPorts(map<UID, string> *uids) const {
+  map<UID, OutputPort*>::const_iterator iter = m_output_uids.begin();
+  for (; iter != m_output_uids.end(); ++iter) {
+    const string port_id = iter->second->UniqueId();
+    if (!port_id.empty()) {
+      (*uids)[iter->first] = port_id;
+    }
+  }
+}
+
+
+/*
+ * Seed the UID : port mapping with the UIDs saved before a restart. UIDs on
+ * ports that haven't been added yet are held until the port arrives.
+ */
+void Universe::RestoreUIDs(const map<UID, string> &uids) {
+  m_restored_uids.insert(uids.begin(), uids.end());
+  vector<OutputPort*>::iterator iter = m_output_ports.begin();
+  for (; iter != m_output_ports.end(); ++iter) {
+    AddRestoredUIDs(*iter);
+  }
+  UpdateUIDCount();
+}
+
+
 /**
  * Return the number of uids in the universe
  */
@@ -641,6 +828,9 @@ bool Universe::UpdateDependants() {
   for (iter = m_output_ports.begin(); iter != m_output_ports.end(); ++iter) {
     (*iter)->WriteDMX(m_buffer, m_active_priority);
   }
+  if (!m_output_ports.empty() && m_universe_store) {
+    m_universe_store->OutputPortsUpdated();
+  }
 
   // write to all clients
   for (client_iter = m_sink_clients.begin();
@@ -650,10 +840,25 @@ bool Universe::UpdateDependants() {
   }
 
   SafeIncrement(K_FPS_VAR);
+  m_output_frames++;
   return true;
 }
 
 
+/*
+ * Called when the merged data changes outside of the input path. If the
+ * output rate is limited this waits for the next tick.
+ */
+void Universe::OutputChanged() {
+  m_restored_dmx = false;
+  if (m_max_output_rate) {
+    m_output_pending = true;
+  } else {
+    UpdateDependants();
+  }
+}
+
+
 /*
  * Update the name in the export map.
  */
@@ -701,6 +906,9 @@ void Universe::HTPMergeSources(const vector<DmxSource> &sources) {
  * @param port the input port that changed or NULL
  * @param client the client that changed or NULL
  * @returns true if the data for this universe changed, false otherwise
+ *
+ * If both port and client are NULL, all sources are re-merged, this is used
+ * when a source times out.
  */
 bool Universe::MergeAll(const InputPort *port, const Client *client) {
   vector<DmxSource> active_sources;
@@ -709,14 +917,19 @@ bool Universe::MergeAll(const InputPort *port, const Client *client) {
   SourceClientMap::const_iterator client_iter;
 
   m_active_priority = ola::dmx::SOURCE_PRIORITY_MIN;
+  // With a SelectServer the source timeouts track liveness, so we only need
+  // the time when falling back to checking each source.
   TimeStamp now;
-  m_clock->CurrentMonotonicTime(&now);
+  if (!m_ss) {
+    m_clock->CurrentMonotonicTime(&now);
+  }
+  const bool remerge = !port && !client;
   bool changed_source_is_active = false;
 
   // Find the highest active ports
   for (iter = m_input_ports.begin(); iter != m_input_ports.end(); ++iter) {
     DmxSource source = (*iter)->SourceData();
-    if (!source.IsSet() || !source.IsActive(now) || !source.Data().Size()) {
+    if (!SourceIsLive(*iter, source, now)) {
       continue;
     }
 
@@ -740,7 +953,7 @@ bool Universe::MergeAll(const InputPort *port, const Client *client) {
        ++client_iter) {
     const DmxSource &source = client_iter->first->SourceData(UniverseId());
 
-    if (!source.IsSet() || !source.IsActive(now) || !source.Data().Size()) {
+    if (!SourceIsLive(client_iter->first, source, now)) {
       continue;
     }
 
@@ -759,12 +972,14 @@ bool Universe::MergeAll(const InputPort *port, const Client *client) {
   }
 
   if (active_sources.empty()) {
-    OLA_WARN << "Something changed but we didn't find any active sources "
-             << " for universe " << UniverseId();
+    if (!remerge) {
+      OLA_WARN << "Something changed but we didn't find any active sources "
+               << " for universe " << UniverseId();
+    }
     return false;
   }
 
-  if (!changed_source_is_active) {
+  if (!remerge && !changed_source_is_active) {
     // this source didn't have any effect, skip
     return false;
   }
@@ -779,8 +994,17 @@ bool Universe::MergeAll(const InputPort *port, const Client *client) {
       DmxSource changed_source;
       if (port) {
         changed_source = port->SourceData();
-      } else {
+      } else if (client) {
         changed_source = client->SourceData(UniverseId());
+      } else {
+        // re-merging, the newest source wins
+        changed_source = *source_iter;
+        for (; source_iter != active_sources.end(); source_iter++) {
+          if (changed_source.Timestamp() < source_iter->Timestamp()) {
+            changed_source = *source_iter;
+          }
+        }
+        source_iter = active_sources.begin();
       }
 
       // check that the current port/client is newer than all other active
@@ -800,6 +1024,203 @@ bool Universe::MergeAll(const InputPort *port, const Client *client) {
 }
 
 
+/*
+ * Check if a source should be included in the merge.
+ * @param key the InputPort or Client the source belongs to
+ * @param source the DmxSource
+ * @param now the current time, only used if there is no SelectServer
+ */
+bool Universe::SourceIsLive(const void *key, const DmxSource &source,
+                            const TimeStamp &now) const {
+  if (!source.IsSet() || !source.Data().Size()) {
+    return false;
+  }
+  if (!m_ss) {
+    return source.IsActive(now);
+  }
+  SourceStateMap::const_iterator iter = m_source_states.find(key);
+  return iter == m_source_states.end() || !iter->second.expired;
+}
+
+
+/*
+ * Start tracking a source, or note that it has sent new data.
+ *
+ * The timeout isn't moved each time new data arrives. Instead when it fires
+ * we check the timestamp of the source, and re-arm it for the difference if
+ * the source has sent data since.
+ */
+void Universe::TrackSource(const void *key, const InputPort *port,
+                           const Client *client, const DmxSource &source) {
+  if (!m_ss || !source.IsSet()) {
+    return;
+  }
+
+  SourceStateMap::iterator iter = m_source_states.find(key);
+  if (iter == m_source_states.end()) {
+    SourceState state = {port, client, INVALID_TIMEOUT, TimeStamp(), false};
+    iter = m_source_states.insert(
+        SourceStateMap::value_type(key, state)).first;
+  }
+
+  SourceState *state = &iter->second;
+  state->expired = false;
+  if (state->timeout != INVALID_TIMEOUT) {
+    return;
+  }
+
+  const TimeStamp now = *m_ss->WakeUpTime();
+  const TimeStamp expiry = source.Timestamp() + DmxSource::TIMEOUT_INTERVAL;
+  if (expiry <= now) {
+    state->expired = true;
+    return;
+  }
+  state->armed_timestamp = source.Timestamp();
+  ArmSourceTimeout(key, state, expiry - now);
+}
+
+
+/*
+ * Register a timeout for when the source expires.
+ */
+void Universe::ArmSourceTimeout(const void *key, SourceState *state,
+                                const TimeInterval &delay) {
+  state->timeout = m_ss->RegisterSingleTimeout(
+      delay,
+      NewSingleCallback(this, &Universe::SourceTimeout, key));
+}
+
+
+/*
+ * Called when a source may have expired.
+ */
+void Universe::SourceTimeout(const void *key) {
+  SourceStateMap::iterator iter = m_source_states.find(key);
+  if (iter == m_source_states.end()) {
+    return;
+  }
+
+  SourceState *state = &iter->second;
+  state->timeout = INVALID_TIMEOUT;
+  const DmxSource source = state->port ? state->port->SourceData() :
+      state->client->SourceData(m_universe_id);
+  if (state->armed_timestamp < source.Timestamp()) {
+    // new data arrived since the timeout was registered
+    const TimeInterval delay = source.Timestamp() - state->armed_timestamp;
+    state->armed_timestamp = source.Timestamp();
+    ArmSourceTimeout(key, state, delay);
+    return;
+  }
+
+  state->expired = true;
+  OLA_INFO << "Source " << key << " timed out on universe " << m_universe_id;
+  ReleaseExpiredSource();
+}
+
+
+/*
+ * Stop tracking a source.
+ */
+void Universe::RemoveSourceState(const void *key) {
+  SourceStateMap::iterator iter = m_source_states.find(key);
+  if (iter == m_source_states.end()) {
+    return;
+  }
+  if (iter->second.timeout != INVALID_TIMEOUT) {
+    m_ss->RemoveTimeout(iter->second.timeout);
+  }
+  m_source_states.erase(iter);
+}
+
+
+/*
+ * Apply the expiry_mode once a source has expired.
+ */
+void Universe::ReleaseExpiredSource() {
+  switch (m_expiry_mode) {
+    case EXPIRY_HOLD:
+      // The expired source is excluded the next time new data arrives.
+      return;
+    case EXPIRY_RELEASE:
+      if (MergeAll(NULL, NULL)) {
+        OutputChanged();
+      }
+      return;
+    case EXPIRY_FADE:
+      StartFade();
+      return;
+  }
+}
+
+
+/*
+ * Start fading from the current data to the result of merging the remaining
+ * sources, or to zero if there are none left.
+ */
+void Universe::StartFade() {
+  CancelFade();
+
+  m_fade_start.Set(m_buffer);
+  if (MergeAll(NULL, NULL)) {
+    m_fade_target.Set(m_buffer);
+  } else {
+    m_fade_target.Set(m_fade_start);
+    m_fade_target.SetRangeToValue(0, 0, m_fade_start.Size());
+  }
+  m_buffer.Set(m_fade_start);
+
+  m_fade_step = 0;
+  m_fade_steps = m_expiry_fade_time.InMilliSeconds() / FADE_STEP_INTERVAL_MS;
+  if (m_fade_steps == 0) {
+    m_buffer.Set(m_fade_target);
+    OutputChanged();
+    return;
+  }
+
+  m_fade_timeout = m_ss->RegisterRepeatingTimeout(
+      FADE_STEP_INTERVAL_MS,
+      NewCallback(this, &Universe::FadeStep));
+}
+
+
+/*
+ * Move one step closer to the fade target.
+ * @returns true if the fade is still in progress.
+ */
+bool Universe::FadeStep() {
+  m_fade_step++;
+  if (m_fade_step >= m_fade_steps) {
+    m_fade_timeout = INVALID_TIMEOUT;
+    m_buffer.Set(m_fade_target);
+  } else {
+    const unsigned int size = std::max(m_fade_start.Size(),
+                                       m_fade_target.Size());
+    uint8_t data[DMX_UNIVERSE_SIZE];
+    for (unsigned int i = 0; i < size; i++) {
+      const int start = m_fade_start.Get(i);
+      const int delta = m_fade_target.Get(i) - start;
+      data[i] = static_cast<uint8_t>(
+          start + delta * static_cast<int>(m_fade_step) /
+          static_cast<int>(m_fade_steps));
+    }
+    m_buffer.Set(data, size);
+  }
+  OutputChanged();
+  return m_fade_timeout != INVALID_TIMEOUT;
+}
+
+
+/*
+ * Stop any fade in progress.
+ */
+void Universe::CancelFade() {
+  if (m_fade_timeout != INVALID_TIMEOUT) {
+    m_ss->RemoveTimeout(m_fade_timeout);
+    m_fade_timeout = INVALID_TIMEOUT;
+  }
+}
+
+
 /**
  * Called when discovery completes on a single ports.
  */
@@ -823,6 +1244,39 @@ void Universe::DiscoveryComplete(RDMDiscoveryCallback *on_complete) {
 }
 
 
+/*
+ * Move the restored UIDs for a port into the UID : port mapping. UIDs that
+ * discovery has already found are left alone.
+ */
+void Universe::AddRestoredUIDs(OutputPort *port) {
+  const string port_id = port->UniqueId();
+  if (port_id.empty()) {
+    return;
+  }
+
+  map<UID, string>::iterator iter = m_restored_uids.begin();
+  while (iter != m_restored_uids.end()) {
+    if (iter->second == port_id) {
+      m_output_uids.insert(std::make_pair(iter->first, port));
+      m_restored_uids.erase(iter++);
+    } else {
+      ++iter;
+    }
+  }
+}
+
+
+/*
+ * Update the exported UID count.
+ */
+void Universe::UpdateUIDCount() {
+  if (m_export_map) {
+    (*m_export_map->GetUIntMapVar(K_UNIVERSE_UID_COUNT_VAR))[m_universe_id_str]
+        = m_output_uids.size();
+  }
+}
+
+
 /**
  * Track fan-out responses for a broadcast request.
  * This increments the port counter until we reach the expected value, and
@@ -0,0 +1,254 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * UniverseSnapshot.cpp
+ * A binary snapshot of the state of each universe.
+ * Copyright (C) 2026 agent
+ */
+
+#include "olad/plugin_api/UniverseSnapshot.h"
+
+#include <string.h>
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <string>
+
+#include "ola/Constants.h"
+#include "ola/Logging.h"
+#include "ola/file/Util.h"
+#include "ola/network/NetworkUtils.h"
+#include "ola/stl/STLUtils.h"
+
+namespace ola {
+
+using ola::network::HostToNetwork;
+using ola::network::NetworkToHost;
+using ola::rdm::UID;
+using std::map;
+using std::string;
+
+namespace {
+
+template <typename T>
+void Append(T value, string *output) {
+  value = HostToNetwork(value);
+  output->append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+/*
+ * Reads big endian values from a string, tracking the offset.
+ */
+class SnapshotReader {
+ public:
+  explicit SnapshotReader(const string &input)
+      : m_input(input),
+        m_offset(0) {
+  }
+
+  template <typename T>
+  bool Read(T *value) {
+    if (m_input.size() - m_offset < sizeof(T)) {
+      return false;
+    }
+    memcpy(value, m_input.data() + m_offset, sizeof(T));
+    *value = NetworkToHost(*value);
+    m_offset += sizeof(T);
+    return true;
+  }
+
+  bool ReadBytes(unsigned int length, const uint8_t **data) {
+    if (m_input.size() - m_offset < length) {
+      return false;
+    }
+    *data = reinterpret_cast<const uint8_t*>(m_input.data() + m_offset);
+    m_offset += length;
+    return true;
+  }
+
+  bool AtEnd() const { return m_offset == m_input.size(); }
+
+ private:
+  const string &m_input;
+  size_t m_offset;
+};
+
+bool ReadUIDs(SnapshotReader *reader, map<UID, string> *uids) {
+  uint16_t uid_count = 0;
+  if (!reader->Read(&uid_count)) {
+    return false;
+  }
+
+  for (uint16_t i = 0; i < uid_count; i++) {
+    uint16_t manufacturer_id = 0;
+    uint32_t device_id = 0;
+    uint8_t port_id_length = 0;
+    const uint8_t *port_id;
+    if (!(reader->Read(&manufacturer_id) && reader->Read(&device_id) &&
+          reader->Read(&port_id_length) &&
+          reader->ReadBytes(port_id_length, &port_id))) {
+      return false;
+    }
+    (*uids)[UID(manufacturer_id, device_id)].assign(
+        reinterpret_cast<const char*>(port_id), port_id_length);
+  }
+  return true;
+}
+}  // namespace
+
+// 'OLAS'
+const uint32_t UniverseSnapshot::SNAPSHOT_MAGIC = 0x4f4c4153;
+const uint8_t UniverseSnapshot::SNAPSHOT_VERSION = 2;
+
+void UniverseSnapshot::AddUniverse(const Universe &universe) {
+  UniverseState &state = m_universes[universe.UniverseId()];
+  state.name = universe.Name();
+  state.merge_mode = universe.MergeMode();
+  state.priority = universe.ActivePriority();
+  state.dmx.Set(universe.GetDMX());
+  state.uids.clear();
+  universe.GetUIDPorts(&state.uids);
+}
+
+void UniverseSnapshot::AddMissingUniverses(const UniverseSnapshot &other) {
+  UniverseStateMap::const_iterator iter = other.m_universes.begin();
+  for (; iter != other.m_universes.end(); ++iter) {
+    m_universes.insert(*iter);
+  }
+}
+
+const UniverseSnapshot::UniverseState *UniverseSnapshot::GetUniverse(
+    unsigned int universe_id) const {
+  return STLFind(&m_universes, universe_id);
+}
+
+void UniverseSnapshot::Serialize(string *output) const {
+  output->clear();
+  Append(SNAPSHOT_MAGIC, output);
+  Append(SNAPSHOT_VERSION, output);
+  Append(static_cast<uint32_t>(m_universes.size()), output);
+
+  UniverseStateMap::const_iterator iter = m_universes.begin();
+  for (; iter != m_universes.end(); ++iter) {
+    const UniverseState &state = iter->second;
+    Append(static_cast<uint32_t>(iter->first), output);
+    Append(static_cast<uint8_t>(state.merge_mode), output);
+    Append(state.priority, output);
+
+    uint16_t name_length = std::min(
+        state.name.size(),
+        static_cast<size_t>(std::numeric_limits<uint16_t>::max()));
+    Append(name_length, output);
+    output->append(state.name, 0, name_length);
+
+    Append(static_cast<uint16_t>(state.dmx.Size()), output);
+    output->append(reinterpret_cast<const char*>(state.dmx.GetRaw()),
+                   state.dmx.Size());
+
+    // Port ids are short, but skip any that won't fit rather than truncate
+    // them.
+    map<UID, string> uids;
+    map<UID, string>::const_iterator uid_iter = state.uids.begin();
+    for (; uid_iter != state.uids.end() &&
+           uids.size() < std::numeric_limits<uint16_t>::max(); ++uid_iter) {
+      if (uid_iter->second.size() <= std::numeric_limits<uint8_t>::max()) {
+        uids.insert(*uid_iter);
+      }
+    }
+
+    Append(static_cast<uint16_t>(uids.size()), output);
+    for (uid_iter = uids.begin(); uid_iter != uids.end(); ++uid_iter) {
+      Append(uid_iter->first.ManufacturerId(), output);
+      Append(uid_iter->first.DeviceId(), output);
+      Append(static_cast<uint8_t>(uid_iter->second.size()), output);
+      output->append(uid_iter->second);
+    }
+  }
+}
+
+bool UniverseSnapshot::Parse(const string &input) {
+  m_universes.clear();
+  SnapshotReader reader(input);
+
+  uint32_t magic = 0, universe_count = 0;
+  uint8_t version = 0;
+  if (!reader.Read(&magic) || magic != SNAPSHOT_MAGIC) {
+    OLA_WARN << "Universe snapshot has an invalid header";
+    return false;
+  }
+
+  if (!reader.Read(&version) || version < 1 || version > SNAPSHOT_VERSION) {
+    OLA_WARN << "Unknown universe snapshot version "
+             << static_cast<int>(version);
+    return false;
+  }
+
+  if (!reader.Read(&universe_count)) {
+    return false;
+  }
+
+  for (uint32_t i = 0; i < universe_count; i++) {
+    uint32_t universe_id = 0;
+    uint8_t merge_mode = 0, priority = 0;
+    uint16_t name_length = 0, dmx_length = 0;
+    const uint8_t *name, *dmx;
+
+    if (!(reader.Read(&universe_id) && reader.Read(&merge_mode) &&
+          reader.Read(&priority) && reader.Read(&name_length) &&
+          reader.ReadBytes(name_length, &name) && reader.Read(&dmx_length) &&
+          reader.ReadBytes(dmx_length, &dmx))) {
+      OLA_WARN << "Universe snapshot is truncated";
+      m_universes.clear();
+      return false;
+    }
+
+    if (dmx_length > DMX_UNIVERSE_SIZE) {
+      OLA_WARN << "Invalid DMX length " << dmx_length << " for universe "
+               << universe_id;
+      m_universes.clear();
+      return false;
+    }
+
+    UniverseState &state = m_universes[universe_id];
+    state.name.assign(reinterpret_cast<const char*>(name), name_length);
+    state.merge_mode = merge_mode == Universe::MERGE_HTP ?
+        Universe::MERGE_HTP : Universe::MERGE_LTP;
+    state.priority = priority;
+    state.dmx.Set(dmx, dmx_length);
+
+    if (version >= 2 && !ReadUIDs(&reader, &state.uids)) {
+      OLA_WARN << "Universe snapshot is truncated";
+      m_universes.clear();
+      return false;
+    }
+  }
+
+  if (!reader.AtEnd()) {
+    OLA_WARN << "Trailing data in universe snapshot";
+    m_universes.clear();
+    return false;
+  }
+  return true;
+}
+
+bool UniverseSnapshot::LoadFromFile(const string &path) {
+  string data;
+  if (!ola::file::ReadFile(path, &data)) {
+    OLA_INFO << "No universe snapshot at " << path;
+    return false;
+  }
+  return Parse(data);
+}
+}  // namespace ola
@@ -0,0 +1,148 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * UniverseSnapshot.h
+ * A binary snapshot of the state of each universe.
+ * Copyright (C) 2026 agent
+ */
+
+#ifndef OLAD_PLUGIN_API_UNIVERSESNAPSHOT_H_
+#define OLAD_PLUGIN_API_UNIVERSESNAPSHOT_H_
+
+#include <stdint.h>
+#include <map>
+#include <string>
+
+#include "ola/DmxBuffer.h"
+#include "ola/base/Macro.h"
+#include "ola/rdm/UID.h"
+#include "olad/Universe.h"
+
+namespace ola {
+
+/**
+ * @brief A snapshot of the state of a set of universes.
+ *
+ * Snapshots are written periodically while olad is running and read back at
+ * startup, so that outputs can resume with the last look rather than a
+ * blackout while we wait for sources to resend data.
+ *
+ * The RDM UIDs found on each universe are saved too, so that requests can be
+ * routed to responders before the first discovery after a restart completes.
+ *
+ * The on-disk format is a header followed by one record per universe. All
+ * values are big endian.
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~
+ * header:   magic (4) | version (1) | universe count (4)
+ * universe: id (4) | merge mode (1) | priority (1) | name length (2) | name |
+ *           dmx length (2) | dmx data | uid count (2) | uid...
+ * uid:      manufacturer id (2) | device id (4) | port id length (1) | port id
+ * ~~~~~~~~~~~~~~~~~~~~~
+ *
+ * Version 1 snapshots, which don't have the UID count or UIDs, are still
+ * accepted.
+ *
+ * The snapshot is only read at startup. Having a standby olad follow the
+ * snapshot and take over the outputs when the active one exits isn't
+ * supported yet.
+ */
+class UniverseSnapshot {
+ public:
+  /**
+   * @brief The saved state of a single universe.
+   */
+  struct UniverseState {
+    std::string name;
+    Universe::merge_mode merge_mode;
+    uint8_t priority;
+    DmxBuffer dmx;
+    std::map<ola::rdm::UID, std::string> uids;  // UID to output port id
+  };
+
+  typedef std::map<unsigned int, UniverseState> UniverseStateMap;
+
+  UniverseSnapshot() {}
+
+  /**
+   * @brief Record the current state of a universe.
+   * @param universe the universe to add to the snapshot.
+   */
+  void AddUniverse(const Universe &universe);
+
+  /**
+   * @brief Copy the universes from another snapshot.
+   * @param other the snapshot to copy from.
+   *
+   * Universes that are already in this snapshot are left as they are.
+   */
+  void AddMissingUniverses(const UniverseSnapshot &other);
+
+  /**
+   * @brief Lookup the state of a universe.
+   * @param universe_id the id of the universe.
+   * @returns the UniverseState or NULL if the universe isn't in the snapshot.
+   */
+  const UniverseState *GetUniverse(unsigned int universe_id) const;
+
+  /**
+   * @brief Remove a universe from the snapshot.
+   * @param universe_id the id of the universe.
+   */
+  void RemoveUniverse(unsigned int universe_id) {
+    m_universes.erase(universe_id);
+  }
+
+  /**
+   * @brief Return the number of universes in the snapshot.
+   */
+  unsigned int UniverseCount() const { return m_universes.size(); }
+
+  /**
+   * @brief Remove all universes from the snapshot.
+   */
+  void Clear() { m_universes.clear(); }
+
+  /**
+   * @brief Serialize the snapshot into the binary format.
+   * @param[out] output the string to write the snapshot to.
+   */
+  void Serialize(std::string *output) const;
+
+  /**
+   * @brief Replace the contents of this snapshot with a serialized snapshot.
+   * @param input the serialized snapshot.
+   * @returns true if the input was valid, false otherwise. On failure the
+   *   snapshot is left empty.
+   */
+  bool Parse(const std::string &input);
+
+  /**
+   * @brief Load a snapshot from a file.
+   * @param path the file to read.
+   * @returns true if the snapshot was loaded, false otherwise.
+   */
+  bool LoadFromFile(const std::string &path);
+
+  static const uint32_t SNAPSHOT_MAGIC;
+  static const uint8_t SNAPSHOT_VERSION;
+
+ private:
+  UniverseStateMap m_universes;
+
+  DISALLOW_COPY_AND_ASSIGN(UniverseSnapshot);
+};
+}  // namespace ola
+#endif  // OLAD_PLUGIN_API_UNIVERSESNAPSHOT_H_
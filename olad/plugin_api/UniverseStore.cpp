@@ -28,12 +28,14 @@
 #include <utility>
 #include <vector>
 
+#include "ola/Callback.h"
 #include "ola/ExportMap.h"
 #include "ola/Logging.h"
 #include "ola/StringUtils.h"
 #include "ola/stl/STLUtils.h"
 #include "olad/Preferences.h"
 #include "olad/Universe.h"
+#include "olad/plugin_api/UniverseSnapshot.h"
 
 namespace ola {
 
@@ -41,13 +43,18 @@ using std::pair;
 using std::set;
 using std::string;
 using std::vector;
+using ola::thread::INVALID_TIMEOUT;
 
 const unsigned int UniverseStore::MINIMUM_RDM_DISCOVERY_INTERVAL = 30;
+const unsigned int UniverseStore::MAXIMUM_OUTPUT_RATE = 1000;
 
 UniverseStore::UniverseStore(Preferences *preferences,
                              ExportMap *export_map)
     : m_preferences(preferences),
-      m_export_map(export_map) {
+      m_export_map(export_map),
+      m_ss(NULL),
+      m_frame_rate_timeout(INVALID_TIMEOUT),
+      m_output_timeout(INVALID_TIMEOUT) {
   if (export_map) {
     export_map->GetStringMapVar(Universe::K_UNIVERSE_NAME_VAR, "universe");
     export_map->GetStringMapVar(Universe::K_UNIVERSE_MODE_VAR, "universe");
@@ -55,7 +62,9 @@ UniverseStore::UniverseStore(Preferences *preferences,
     const char *vars[] = {
       Universe::K_FPS_VAR,
       Universe::K_UNIVERSE_INPUT_PORT_VAR,
+      Universe::K_UNIVERSE_INPUT_RATE_VAR,
       Universe::K_UNIVERSE_OUTPUT_PORT_VAR,
+      Universe::K_UNIVERSE_OUTPUT_RATE_VAR,
       Universe::K_UNIVERSE_SINK_CLIENTS_VAR,
       Universe::K_UNIVERSE_SOURCE_CLIENTS_VAR,
       Universe::K_UNIVERSE_UID_COUNT_VAR,
@@ -69,6 +78,7 @@ UniverseStore::UniverseStore(Preferences *preferences,
 
 UniverseStore::~UniverseStore() {
   DeleteAll();
+  StopTimers();
 }
 
 Universe *UniverseStore::GetUniverse(unsigned int universe_id) const {
@@ -83,9 +93,11 @@ Universe *UniverseStore::GetUniverseOrCreate(unsigned int universe_id) {
     iter->second = new Universe(universe_id, this, m_export_map, &m_clock);
 
     if (iter->second) {
+      iter->second->SetSelectServer(m_ss);
       if (m_preferences) {
         RestoreUniverseSettings(iter->second);
       }
+      RestoreFromSnapshot(iter->second);
     } else {
       OLA_WARN << "Failed to create universe " << universe_id;
     }
@@ -102,16 +114,97 @@ void UniverseStore::DeleteAll() {
 
   for (iter = m_universe_map.begin(); iter != m_universe_map.end(); iter++) {
     SaveUniverseSettings(iter->second);
+    RemoveFromOutputClock(iter->second);
     delete iter->second;
   }
   m_deletion_candidates.clear();
   m_universe_map.clear();
+  SavePreferences();
 }
 
 void UniverseStore::AddUniverseGarbageCollection(Universe *universe) {
   m_deletion_candidates.insert(universe);
 }
 
+void UniverseStore::SetOutputCallback(Callback0<void> *callback) {
+  m_output_callback.reset(callback);
+}
+
+void UniverseStore::OutputPortsUpdated() {
+  if (!m_output_callback.get()) {
+    return;
+  }
+
+  if (!m_ss) {
+    m_output_callback->Run();
+  } else if (m_output_timeout == INVALID_TIMEOUT) {
+    // A zero length timeout runs after the events that are already ready,
+    // which may update other universes.
+    m_output_timeout = m_ss->RegisterSingleTimeout(
+        0, NewSingleCallback(this, &UniverseStore::RunOutputCallback));
+  }
+}
+
+void UniverseStore::SetSelectServer(ola::io::SelectServerInterface *ss) {
+  StopTimers();
+  m_ss = ss;
+  UniverseMap::iterator iter = m_universe_map.begin();
+  for (; iter != m_universe_map.end(); ++iter) {
+    iter->second->SetSelectServer(ss);
+  }
+
+  OutputClockMap::iterator clock_iter = m_output_clocks.begin();
+  if (!m_ss) {
+    // without a clock the universes can't limit their output
+    for (; clock_iter != m_output_clocks.end(); ++clock_iter) {
+      set<Universe*>::iterator universe_iter =
+          clock_iter->second.universes.begin();
+      for (; universe_iter != clock_iter->second.universes.end();
+           ++universe_iter) {
+        (*universe_iter)->SetMaxOutputRate(0);
+      }
+    }
+    m_output_clocks.clear();
+    return;
+  }
+
+  for (; clock_iter != m_output_clocks.end(); ++clock_iter) {
+    StartOutputClock(clock_iter->first, &clock_iter->second);
+  }
+  m_frame_rate_timeout = m_ss->RegisterRepeatingTimeout(
+      TimeInterval(1, 0),
+      NewCallback(this, &UniverseStore::ExportFrameRates));
+}
+
+void UniverseStore::SetMaxOutputRate(Universe *universe,
+                                     unsigned int max_fps) {
+  RemoveFromOutputClock(universe);
+
+  if (max_fps > MAXIMUM_OUTPUT_RATE) {
+    OLA_WARN << "Output rate for universe " << universe->UniverseId()
+             << " is more than the maximum of " << MAXIMUM_OUTPUT_RATE;
+    max_fps = MAXIMUM_OUTPUT_RATE;
+  }
+
+  if (max_fps && !m_ss) {
+    OLA_WARN << "No SelectServer, not limiting the output rate of universe "
+             << universe->UniverseId();
+    max_fps = 0;
+  }
+
+  universe->SetMaxOutputRate(max_fps);
+  if (!max_fps) {
+    return;
+  }
+
+  pair<OutputClockMap::iterator, bool> p = m_output_clocks.insert(
+      OutputClockMap::value_type(max_fps, OutputClock()));
+  if (p.second) {
+    StartOutputClock(max_fps, &p.first->second);
+  }
+  p.first->second.universes.insert(universe);
+}
+
 void UniverseStore::GarbageCollectUniverses() {
   set<Universe*>::iterator iter;
   UniverseMap::iterator map_iter;
@@ -120,11 +213,167 @@ void UniverseStore::GarbageCollectUniverses() {
        iter != m_deletion_candidates.end(); iter++) {
     if (!(*iter)->IsActive()) {
       SaveUniverseSettings(*iter);
+      RemoveFromOutputClock(*iter);
       m_universe_map.erase((*iter)->UniverseId());
       delete *iter;
     }
   }
   m_deletion_candidates.clear();
+  SavePreferences();
+}
+
+
+void UniverseStore::TakeSnapshot(UniverseSnapshot *snapshot) const {
+  snapshot->Clear();
+  UniverseMap::const_iterator iter = m_universe_map.begin();
+  for (; iter != m_universe_map.end(); ++iter) {
+    snapshot->AddUniverse(*iter->second);
+  }
+
+  // Keep the universes that haven't been restored yet, otherwise they'd be
+  // lost if olad restarts before they're created.
+  if (m_snapshot.get()) {
+    snapshot->AddMissingUniverses(*m_snapshot);
+  }
+}
+
+void UniverseStore::RestoreSnapshot(UniverseSnapshot *snapshot) {
+  m_snapshot.reset(snapshot);
+  OLA_INFO << "Restoring " << snapshot->UniverseCount()
+           << " universes from snapshot";
+
+  UniverseMap::iterator iter = m_universe_map.begin();
+  for (; iter != m_universe_map.end(); ++iter) {
+    RestoreFromSnapshot(iter->second);
+  }
+}
+
+
+/*
+ * Restore a universe's last state from the snapshot, if there is one. Each
+ * universe is only restored once.
+ * @param universe the universe to update
+ */
+void UniverseStore::RestoreFromSnapshot(Universe *universe) {
+  if (!m_snapshot.get()) {
+    return;
+  }
+
+  const UniverseSnapshot::UniverseState *state = m_snapshot->GetUniverse(
+      universe->UniverseId());
+  if (!state) {
+    return;
+  }
+
+  universe->SetName(state->name);
+  universe->SetMergeMode(state->merge_mode);
+  universe->RestoreDMX(state->dmx, state->priority);
+  universe->RestoreUIDs(state->uids);
+  m_snapshot->RemoveUniverse(universe->UniverseId());
+
+  if (!m_snapshot->UniverseCount()) {
+    m_snapshot.reset();
+  }
+}
+
+
+/*
+ * Remove a universe from its output clock, stopping the clock if no other
+ * universes use it.
+ */
+void UniverseStore::RemoveFromOutputClock(Universe *universe) {
+  OutputClockMap::iterator iter = m_output_clocks.find(
+      universe->MaxOutputRate());
+  if (iter == m_output_clocks.end()) {
+    return;
+  }
+
+  iter->second.universes.erase(universe);
+  if (iter->second.universes.empty()) {
+    if (iter->second.timeout != INVALID_TIMEOUT) {
+      m_ss->RemoveTimeout(iter->second.timeout);
+    }
+    m_output_clocks.erase(iter);
+  }
+}
+
+
+/*
+ * Start the timer for an output clock.
+ */
+void UniverseStore::StartOutputClock(unsigned int max_fps,
+                                     OutputClock *output_clock) {
+  output_clock->timeout = m_ss->RegisterRepeatingTimeout(
+      TimeInterval(0, ONE_THOUSAND * ONE_THOUSAND / max_fps),
+      NewCallback(this, &UniverseStore::OutputClockTick, max_fps));
+}
+
+
+/*
+ * Cancel the output clocks, the frame rate timer and any pending output
+ * callback.
+ */
+void UniverseStore::StopTimers() {
+  if (!m_ss) {
+    return;
+  }
+
+  OutputClockMap::iterator iter = m_output_clocks.begin();
+  for (; iter != m_output_clocks.end(); ++iter) {
+    if (iter->second.timeout != INVALID_TIMEOUT) {
+      m_ss->RemoveTimeout(iter->second.timeout);
+      iter->second.timeout = INVALID_TIMEOUT;
+    }
+  }
+  if (m_frame_rate_timeout != INVALID_TIMEOUT) {
+    m_ss->RemoveTimeout(m_frame_rate_timeout);
+    m_frame_rate_timeout = INVALID_TIMEOUT;
+  }
+  if (m_output_timeout != INVALID_TIMEOUT) {
+    m_ss->RemoveTimeout(m_output_timeout);
+    m_output_timeout = INVALID_TIMEOUT;
+  }
+}
+
+
+/*
+ * Called on each tick of an output clock.
+ */
+bool UniverseStore::OutputClockTick(unsigned int max_fps) {
+  OutputClockMap::iterator iter = m_output_clocks.find(max_fps);
+  if (iter == m_output_clocks.end()) {
+    return false;
+  }
+
+  set<Universe*>::iterator universe_iter = iter->second.universes.begin();
+  for (; universe_iter != iter->second.universes.end(); ++universe_iter) {
+    (*universe_iter)->OutputTick();
+  }
+  return true;
+}
+
+
+/*
+ * Called once a second to export the frame rates of each universe.
+ */
+bool UniverseStore::ExportFrameRates() {
+  UniverseMap::iterator iter = m_universe_map.begin();
+  for (; iter != m_universe_map.end(); ++iter) {
+    iter->second->ExportFrameRates();
+  }
+  return true;
+}
+
+
+/*
+ * Run the output callback for the universes updated in this iteration of the
+ * event loop.
+ */
+void UniverseStore::RunOutputCallback() {
+  m_output_timeout = INVALID_TIMEOUT;
+  if (m_output_callback.get()) {
+    m_output_callback->Run();
+  }
 }
 
 
@@ -132,7 +381,7 @@ void UniverseStore::GarbageCollectUniverses() {
  * Restore a universe's settings
  * @param uni  the universe to update
  */
-bool UniverseStore::RestoreUniverseSettings(Universe *universe) const {
+bool UniverseStore::RestoreUniverseSettings(Universe *universe) {
   string key, value;
   std::ostringstream oss;
 
@@ -181,6 +430,47 @@ bool UniverseStore::RestoreUniverseSettings(Universe *universe) const {
         universe->UniverseId() << ", value was " << value;
     }
   }
+
+  // load what happens when a source times out
+  key = "uni_" + oss.str() + "_source_expiry";
+  value = m_preferences->GetValue(key);
+
+  if (!value.empty()) {
+    unsigned int fade_ms = 0;
+    string fade_value = m_preferences->GetValue(
+        "uni_" + oss.str() + "_source_expiry_fade_ms");
+    if (!fade_value.empty() && !StringToInt(fade_value, &fade_ms, true)) {
+      OLA_WARN << "Invalid source expiry fade time for universe " <<
+        universe->UniverseId() << ", value was " << fade_value;
+    }
+
+    if (value == Universe::K_EXPIRY_HOLD_STR) {
+      universe->SetExpiryMode(Universe::EXPIRY_HOLD);
+    } else if (value == Universe::K_EXPIRY_RELEASE_STR) {
+      universe->SetExpiryMode(Universe::EXPIRY_RELEASE);
+    } else if (value == Universe::K_EXPIRY_FADE_STR) {
+      universe->SetExpiryMode(Universe::EXPIRY_FADE,
+                              TimeInterval(fade_ms / 1000,
+                                           (fade_ms % 1000) * 1000));
+    } else {
+      OLA_WARN << "Invalid source expiry mode for universe " <<
+        universe->UniverseId() << ", value was " << value;
+    }
+  }
+
+  // load the output rate limit
+  key = "uni_" + oss.str() + "_max_output_rate";
+  value = m_preferences->GetValue(key);
+
+  if (!value.empty()) {
+    unsigned int max_fps;
+    if (StringToInt(value, &max_fps, true)) {
+      SetMaxOutputRate(universe, max_fps);
+    } else {
+      OLA_WARN << "Invalid output rate for universe " <<
+        universe->UniverseId() << ", value was " << value;
+    }
+  }
   return 0;
 }
 
@@ -209,9 +499,17 @@ bool UniverseStore::SaveUniverseSettings(Universe *universe) const {
 
   // We don't save the RDM Discovery interval since it can only be set in the
   // config files for now.
+  return 0;
+}
 
-  m_preferences->Save();
 
-  return 0;
+/*
+ * Write out any changed universe settings. The settings for all universes are
+ * batched into a single save.
+ */
+void UniverseStore::SavePreferences() const {
+  if (m_preferences) {
+    m_preferences->Save();
+  }
 }
 }  // namespace ola
@@ -22,16 +22,21 @@
 #define OLAD_PLUGIN_API_UNIVERSESTORE_H_
 
 #include <map>
+#include <memory>
 #include <set>
 #include <string>
 #include <vector>
 
+#include "ola/Callback.h"
 #include "ola/Clock.h"
 #include "ola/base/Macro.h"
+#include "ola/io/SelectServerInterface.h"
+#include "ola/thread/SchedulerInterface.h"
 
 namespace ola {
 
 class Universe;
+class UniverseSnapshot;
 
 /**
  * @brief Maintains a collection of Universe objects.
@@ -92,20 +97,95 @@ class UniverseStore {
    */
   void GarbageCollectUniverses();
 
+  /**
+   * @brief Record the state of all universes.
+   * @param[out] snapshot the snapshot to populate.
+   */
+  void TakeSnapshot(UniverseSnapshot *snapshot) const;
+
+  /**
+   * @brief Restore universes from a snapshot.
+   * @param snapshot the snapshot to restore, ownership is transferred.
+   *
+   * Universes that already exist are restored immediately, the rest are
+   * restored when they're first created.
+   */
+  void RestoreSnapshot(UniverseSnapshot *snapshot);
+
+  /**
+   * @brief Set the callback to run when a universe writes to its output
+   *   ports.
+   * @param callback the callback to run, ownership is transferred.
+   *
+   * If there is a SelectServer the callback is run once the event loop has
+   * handled all the events that are ready, so it runs once no matter how
+   * many universes were written to. Without a SelectServer it runs after
+   * each write.
+   */
+  void SetOutputCallback(Callback0<void> *callback);
+
+  /**
+   * @brief Called by a Universe after it writes to its output ports.
+   */
+  void OutputPortsUpdated();
+
+  /**
+   * @brief Set the SelectServer the universes use to time out sources.
+   * @param ss the SelectServer to use, or NULL.
+   *
+   * This applies to both the existing universes and any created later. The
+   * SelectServer also drives the output clocks, and the export of the frame
+   * rates.
+   */
+  void SetSelectServer(ola::io::SelectServerInterface *ss);
+
+  /**
+   * @brief Limit how often a universe writes to its outputs.
+   * @param universe the Universe to limit.
+   * @param max_fps the maximum frames per second, or 0 for no limit.
+   *
+   * Universes with the same rate share an output clock, so their frames are
+   * sent together. This requires a SelectServer.
+   */
+  void SetMaxOutputRate(Universe *universe, unsigned int max_fps);
+
  private:
   typedef std::map<unsigned int, Universe*> UniverseMap;
 
+  // The universes that output at the same rate.
+  struct OutputClock {
+    ola::thread::timeout_id timeout;
+    std::set<Universe*> universes;
+  };
+  // Keyed by the frames per second
+  typedef std::map<unsigned int, OutputClock> OutputClockMap;
+
   Preferences *m_preferences;
   ExportMap *m_export_map;
   UniverseMap m_universe_map;
   std::set<Universe*> m_deletion_candidates;  // list of universes we may be
                                               // able to delete
+  std::auto_ptr<UniverseSnapshot> m_snapshot;  // universes yet to be restored
+  std::auto_ptr<Callback0<void> > m_output_callback;
+  ola::io::SelectServerInterface *m_ss;
+  OutputClockMap m_output_clocks;
+  ola::thread::timeout_id m_frame_rate_timeout;
+  ola::thread::timeout_id m_output_timeout;
   Clock m_clock;
 
-  bool RestoreUniverseSettings(Universe *universe) const;
+  bool RestoreUniverseSettings(Universe *universe);
+  void RestoreFromSnapshot(Universe *universe);
   bool SaveUniverseSettings(Universe *universe) const;
+  void SavePreferences() const;
+  void RemoveFromOutputClock(Universe *universe);
+  void StartOutputClock(unsigned int max_fps, OutputClock *output_clock);
+  void StopTimers();
+  bool OutputClockTick(unsigned int max_fps);
+  bool ExportFrameRates();
+  void RunOutputCallback();
 
   static const unsigned int MINIMUM_RDM_DISCOVERY_INTERVAL;
+  static const unsigned int MAXIMUM_OUTPUT_RATE;
 
   DISALLOW_COPY_AND_ASSIGN(UniverseStore);
 };
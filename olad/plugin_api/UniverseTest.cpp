@@ -27,6 +27,8 @@
 #include "ola/Constants.h"
 #include "ola/Clock.h"
 #include "ola/DmxBuffer.h"
+#include "ola/ExportMap.h"
+#include "ola/io/SelectServer.h"
 #include "ola/rdm/RDMCommand.h"
 #include "ola/rdm/RDMReply.h"
 #include "ola/rdm/RDMResponseCodes.h"
@@ -40,6 +42,7 @@
 #include "olad/plugin_api/Client.h"
 #include "olad/plugin_api/PortManager.h"
 #include "olad/plugin_api/TestCommon.h"
+#include "olad/plugin_api/UniverseSnapshot.h"
 #include "olad/plugin_api/UniverseStore.h"
 #include "ola/testing/TestUtils.h"
 
@@ -47,8 +50,10 @@
 using ola::AbstractDevice;
 using ola::Clock;
 using ola::DmxBuffer;
+using ola::MockClock;
 using ola::NewCallback;
 using ola::NewSingleCallback;
+using ola::TimeInterval;
 using ola::TimeStamp;
 using ola::Universe;
 using ola::rdm::NewDiscoveryUniqueBranchRequest;
@@ -71,6 +76,7 @@ class UniverseTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testLifecycle);
   CPPUNIT_TEST(testSetGetDmx);
   CPPUNIT_TEST(testSendDmx);
+  CPPUNIT_TEST(testOutputCallback);
   CPPUNIT_TEST(testReceiveDmx);
   CPPUNIT_TEST(testSourceClients);
   CPPUNIT_TEST(testSinkClients);
@@ -78,6 +84,11 @@ class UniverseTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testHtpMerging);
   CPPUNIT_TEST(testRDMDiscovery);
   CPPUNIT_TEST(testRDMSend);
+  CPPUNIT_TEST(testSnapshot);
+  CPPUNIT_TEST(testSnapshotUIDs);
+  CPPUNIT_TEST(testSourceExpiry);
+  CPPUNIT_TEST(testSourceExpiryFade);
+  CPPUNIT_TEST(testOutputRateLimit);
   CPPUNIT_TEST_SUITE_END();
 
  public:
@@ -86,6 +97,7 @@ class UniverseTest: public CppUnit::TestFixture {
   void testLifecycle();
   void testSetGetDmx();
   void testSendDmx();
+  void testOutputCallback();
   void testReceiveDmx();
   void testSourceClients();
   void testSinkClients();
@@ -93,12 +105,26 @@ class UniverseTest: public CppUnit::TestFixture {
   void testHtpMerging();
   void testRDMDiscovery();
   void testRDMSend();
+  void testSnapshot();
+  void testSnapshotUIDs();
+  void testSourceExpiry();
+  void testSourceExpiryFade();
+  void testOutputRateLimit();
 
  private:
   ola::MemoryPreferences *m_preferences;
   ola::UniverseStore *m_store;
   DmxBuffer m_buffer;
   ola::Clock m_clock;
+  unsigned int m_output_updates;
+  MockClock m_mock_clock;
+  ola::io::SelectServer *m_ss;
+
+  void OutputPortsUpdated() { m_output_updates++; }
+
+  void SendClientDMX(ola::Client *client, Universe *universe,
+                     const string &data, uint8_t priority);
+  void AdvanceTime(int32_t sec, int32_t usec);
 
   void ConfirmUIDs(UIDSet *expected, const UIDSet &uids);
 
@@ -143,11 +169,36 @@ void UniverseTest::setUp() {
   m_preferences = new ola::MemoryPreferences("foo");
   m_store = new ola::UniverseStore(m_preferences, NULL);
   m_buffer.Set(TEST_DATA);
+  m_output_updates = 0;
+  m_ss = new ola::io::SelectServer(NULL, &m_mock_clock);
 }
 
 void UniverseTest::tearDown() {
   delete m_store;
   delete m_preferences;
+  delete m_ss;
+}
+
+
+/*
+ * Send data from a source client, timestamped like OlaServerServiceImpl does.
+ */
+void UniverseTest::SendClientDMX(ola::Client *client, Universe *universe,
+                                 const string &data, uint8_t priority) {
+  DmxBuffer buffer;
+  buffer.SetFromString(data);
+  ola::DmxSource source(buffer, *m_ss->WakeUpTime(), priority);
+  client->DMXReceived(universe->UniverseId(), source);
+  universe->SourceClientDataChanged(client);
+}
+
+
+/*
+ * Move the clock forward and run any timeouts that are now due.
+ */
+void UniverseTest::AdvanceTime(int32_t sec, int32_t usec) {
+  m_mock_clock.AdvanceTime(sec, usec);
+  m_ss->RunOnce(TimeInterval(0, 0));
 }
 
 /*
@@ -212,9 +263,15 @@ void UniverseTest::testSetGetDmx() {
  * Check that SendDmx updates all ports
  */
 void UniverseTest::testSendDmx() {
+  m_store->SetOutputCallback(
+      ola::NewCallback(this, &UniverseTest::OutputPortsUpdated));
   Universe *universe = m_store->GetUniverseOrCreate(TEST_UNIVERSE);
   OLA_ASSERT(universe);
 
+  // No output ports, so the output callback isn't run
+  OLA_ASSERT(universe->SetDMX(m_buffer));
+  OLA_ASSERT_EQ(0u, m_output_updates);
+
   TestMockOutputPort port(NULL, 1);  // output port
   universe->AddPort(&port);
   OLA_ASSERT_EQ((unsigned int) 0, universe->InputPortCount());
@@ -224,6 +281,7 @@ void UniverseTest::testSendDmx() {
   // send some data to the universe and check the port gets it
   OLA_ASSERT(universe->SetDMX(m_buffer));
   OLA_ASSERT_DMX_EQUALS(m_buffer, port.ReadDMX());
+  OLA_ASSERT_EQ(1u, m_output_updates);
 
   // remove the port from the universe
   universe->RemovePort(&port);
@@ -233,6 +291,54 @@ void UniverseTest::testSendDmx() {
 }
 
 
+/*
+ * Check that the output callback runs once per iteration of the event loop,
+ * however many universes are updated.
+ */
+void UniverseTest::testOutputCallback() {
+  m_store->SetSelectServer(m_ss);
+  m_store->SetOutputCallback(
+      ola::NewCallback(this, &UniverseTest::OutputPortsUpdated));
+  m_ss->RunOnce(TimeInterval(0, 0));
+
+  Universe *universe1 = m_store->GetUniverseOrCreate(TEST_UNIVERSE);
+  Universe *universe2 = m_store->GetUniverseOrCreate(TEST_UNIVERSE + 1);
+  OLA_ASSERT(universe1);
+  OLA_ASSERT(universe2);
+  TestMockOutputPort port1(NULL, 1);
+  TestMockOutputPort port2(NULL, 2);
+  universe1->AddPort(&port1);
+  universe2->AddPort(&port2);
+
+  // Both universes write to their ports straight away, the callback waits
+  // for the event loop.
+  OLA_ASSERT(universe1->SetDMX(m_buffer));
+  OLA_ASSERT(universe2->SetDMX(m_buffer));
+  OLA_ASSERT_DMX_EQUALS(m_buffer, port1.ReadDMX());
+  OLA_ASSERT_DMX_EQUALS(m_buffer, port2.ReadDMX());
+  OLA_ASSERT_EQ(0u, m_output_updates);
+
+  m_ss->RunOnce(TimeInterval(0, 0));
+  OLA_ASSERT_EQ(1u, m_output_updates);
+  m_ss->RunOnce(TimeInterval(0, 0));
+  OLA_ASSERT_EQ(1u, m_output_updates);
+
+  // The next update runs it again.
+  OLA_ASSERT(universe2->SetDMX(m_buffer));
+  m_ss->RunOnce(TimeInterval(0, 0));
+  OLA_ASSERT_EQ(2u, m_output_updates);
+
+  // A pending callback is cancelled if the SelectServer is removed.
+  OLA_ASSERT(universe1->SetDMX(m_buffer));
+  m_store->SetSelectServer(NULL);
+  m_ss->RunOnce(TimeInterval(0, 0));
+  OLA_ASSERT_EQ(2u, m_output_updates);
+
+  universe1->RemovePort(&port1);
+  universe2->RemovePort(&port2);
+}
+
+
 /*
  * Check that we update when ports have new data
  */
@@ -858,3 +964,325 @@ void UniverseTest::ConfirmRDM(int line,
                     str.str());
   OLA_ASSERT_EQ_MSG(expected_response, reply->Response(), str.str());
 }
+
+
+/*
+ * Check that universes can be saved to and restored from a snapshot.
+ */
+void UniverseTest::testSnapshot() {
+  Universe *universe = m_store->GetUniverseOrCreate(TEST_UNIVERSE);
+  OLA_ASSERT(universe);
+  universe->SetName("snapshot test");
+  universe->SetMergeMode(Universe::MERGE_HTP);
+  OLA_ASSERT(universe->SetDMX(m_buffer));
+
+  ola::UniverseSnapshot snapshot;
+  m_store->TakeSnapshot(&snapshot);
+  OLA_ASSERT_EQ(1u, snapshot.UniverseCount());
+
+  string serialized;
+  snapshot.Serialize(&serialized);
+
+  // Truncated snapshots are rejected.
+  ola::UniverseSnapshot truncated;
+  OLA_ASSERT_FALSE(
+      truncated.Parse(serialized.substr(0, serialized.size() - 1)));
+  OLA_ASSERT_EQ(0u, truncated.UniverseCount());
+
+  ola::UniverseSnapshot *restored = new ola::UniverseSnapshot();
+  OLA_ASSERT(restored->Parse(serialized));
+  OLA_ASSERT_EQ(1u, restored->UniverseCount());
+
+  ola::MemoryPreferences preferences("snapshot");
+  ola::UniverseStore store(&preferences, NULL);
+  store.RestoreSnapshot(restored);
+
+  // Universes that haven't been created yet are kept in new snapshots.
+  ola::UniverseSnapshot pending;
+  store.TakeSnapshot(&pending);
+  OLA_ASSERT_EQ(1u, pending.UniverseCount());
+  OLA_ASSERT(pending.GetUniverse(TEST_UNIVERSE));
+  OLA_ASSERT_EQ(string("snapshot test"),
+                pending.GetUniverse(TEST_UNIVERSE)->name);
+
+  universe = store.GetUniverseOrCreate(TEST_UNIVERSE);
+  OLA_ASSERT(universe);
+  OLA_ASSERT_EQ(string("snapshot test"), universe->Name());
+  OLA_ASSERT_EQ(Universe::MERGE_HTP, universe->MergeMode());
+  OLA_ASSERT_DMX_EQUALS(m_buffer, universe->GetDMX());
+
+  // Output ports patched after the restore receive the last look.
+  TestMockOutputPort port(NULL, 1);
+  universe->AddPort(&port);
+  OLA_ASSERT_DMX_EQUALS(m_buffer, port.ReadDMX());
+
+  // Once new data arrives, newly added ports no longer get the restored data.
+  DmxBuffer new_data;
+  new_data.SetFromString("1,2,3");
+  OLA_ASSERT(universe->SetDMX(new_data));
+  TestMockOutputPort port2(NULL, 2);
+  universe->AddPort(&port2);
+  OLA_ASSERT_EQ(0u, port2.ReadDMX().Size());
+
+  universe->RemovePort(&port);
+  universe->RemovePort(&port2);
+}
+
+
+/*
+ * Check that the UIDs on each port are saved in the snapshot, and restored
+ * when the port is added again.
+ */
+void UniverseTest::testSnapshotUIDs() {
+  Universe *universe = m_store->GetUniverseOrCreate(TEST_UNIVERSE);
+  OLA_ASSERT(universe);
+
+  TestMockPlugin plugin(NULL, ola::OLA_PLUGIN_ARTNET);
+  MockDevice device(&plugin, "foo");
+  UID uid1(0x7a70, 1);
+  UID uid2(0x7a70, 0x12345678);
+  UIDSet port_uids;
+  port_uids.AddUID(uid1);
+  port_uids.AddUID(uid2);
+  TestMockRDMOutputPort port(&device, 1, &port_uids, true);
+  universe->AddPort(&port);
+  port.SetUniverse(universe);
+  OLA_ASSERT_EQ(2u, universe->UIDCount());
+
+  // A port without a unique id isn't saved.
+  UIDSet other_uids;
+  other_uids.AddUID(UID(0x7a70, 3));
+  TestMockRDMOutputPort other_port(NULL, 2, &other_uids, true);
+  universe->AddPort(&other_port);
+  other_port.SetUniverse(universe);
+  OLA_ASSERT_EQ(3u, universe->UIDCount());
+
+  ola::UniverseSnapshot snapshot;
+  m_store->TakeSnapshot(&snapshot);
+  string serialized;
+  snapshot.Serialize(&serialized);
+  universe->RemovePort(&port);
+  universe->RemovePort(&other_port);
+
+  ola::UniverseSnapshot *restored = new ola::UniverseSnapshot();
+  OLA_ASSERT(restored->Parse(serialized));
+  const ola::UniverseSnapshot::UniverseState *state =
+      restored->GetUniverse(TEST_UNIVERSE);
+  OLA_ASSERT(state);
+  OLA_ASSERT_EQ(static_cast<size_t>(2), state->uids.size());
+  OLA_ASSERT_EQ(port.UniqueId(), state->uids.find(uid1)->second);
+  OLA_ASSERT_EQ(port.UniqueId(), state->uids.find(uid2)->second);
+
+  ola::MemoryPreferences preferences("snapshot");
+  ola::UniverseStore store(&preferences, NULL);
+  store.RestoreSnapshot(restored);
+  universe = store.GetUniverseOrCreate(TEST_UNIVERSE);
+  OLA_ASSERT(universe);
+  OLA_ASSERT_EQ(0u, universe->UIDCount());
+
+  // The UIDs can be used as soon as the port is added, before discovery.
+  UIDSet new_uids;
+  new_uids.AddUID(uid1);
+  TestMockRDMOutputPort new_port(&device, 1, &new_uids);
+  universe->AddPort(&new_port);
+  new_port.SetUniverse(universe);
+  UIDSet universe_uids;
+  universe->GetUIDs(&universe_uids);
+  OLA_ASSERT_EQ(2u, universe_uids.Size());
+  OLA_ASSERT(universe_uids.Contains(uid1));
+  OLA_ASSERT(universe_uids.Contains(uid2));
+
+  // Discovery replaces the restored UIDs.
+  UIDSet expected_uids;
+  expected_uids.AddUID(uid1);
+  universe->RunRDMDiscovery(
+    NewSingleCallback(this, &UniverseTest::ConfirmUIDs, &expected_uids),
+    true);
+  universe->RemovePort(&new_port);
+
+  // Version 1 snapshots don't have the UIDs.
+  string version1;
+  ola::UniverseSnapshot empty_uids;
+  store.TakeSnapshot(&empty_uids);
+  OLA_ASSERT_EQ(static_cast<size_t>(0),
+                empty_uids.GetUniverse(TEST_UNIVERSE)->uids.size());
+  empty_uids.Serialize(&version1);
+  version1[4] = 1;
+  version1.resize(version1.size() - 2);  // the UID count
+
+  ola::UniverseSnapshot old_snapshot;
+  OLA_ASSERT(old_snapshot.Parse(version1));
+  OLA_ASSERT_EQ(1u, old_snapshot.UniverseCount());
+  OLA_ASSERT_EQ(static_cast<size_t>(0),
+                old_snapshot.GetUniverse(TEST_UNIVERSE)->uids.size());
+}
+
+
+/*
+ * Check that sources time out, and that the remaining sources are re-merged
+ * or the last look is held.
+ */
+void UniverseTest::testSourceExpiry() {
+  m_store->SetSelectServer(m_ss);
+  m_ss->RunOnce(TimeInterval(0, 0));
+
+  Universe *universe = m_store->GetUniverseOrCreate(TEST_UNIVERSE);
+  OLA_ASSERT(universe);
+  OLA_ASSERT_EQ(Universe::EXPIRY_RELEASE, universe->ExpiryMode());
+
+  DmxBuffer high, low;
+  high.SetFromString("1,2,3");
+  low.SetFromString("4,5");
+
+  MockClient high_client, low_client;
+  SendClientDMX(&low_client, universe, "4,5", 100);
+  SendClientDMX(&high_client, universe, "1,2,3", 150);
+  OLA_ASSERT_EQ((uint8_t) 150, universe->ActivePriority());
+  OLA_ASSERT_DMX_EQUALS(high, universe->GetDMX());
+
+  // only the low priority source keeps sending
+  AdvanceTime(1, 0);
+  SendClientDMX(&low_client, universe, "4,5", 100);
+  AdvanceTime(1, 0);
+  SendClientDMX(&low_client, universe, "4,5", 100);
+  OLA_ASSERT_DMX_EQUALS(high, universe->GetDMX());
+
+  // the high priority source times out, the universe falls back to the low
+  // priority source without it needing to send anything.
+  AdvanceTime(0, 600000);
+  OLA_ASSERT_EQ((uint8_t) 100, universe->ActivePriority());
+  OLA_ASSERT_DMX_EQUALS(low, universe->GetDMX());
+
+  // the high priority source comes back
+  SendClientDMX(&high_client, universe, "1,2,3", 150);
+  OLA_ASSERT_DMX_EQUALS(high, universe->GetDMX());
+
+  // now hold the last look, even once both sources stop
+  universe->SetExpiryMode(Universe::EXPIRY_HOLD);
+  AdvanceTime(2, 0);
+  AdvanceTime(0, 600000);
+  OLA_ASSERT_DMX_EQUALS(high, universe->GetDMX());
+
+  // new data from the low priority source replaces the held data
+  SendClientDMX(&low_client, universe, "4,5", 100);
+  OLA_ASSERT_EQ((uint8_t) 100, universe->ActivePriority());
+  OLA_ASSERT_DMX_EQUALS(low, universe->GetDMX());
+
+  universe->RemoveSourceClient(&high_client);
+  universe->RemoveSourceClient(&low_client);
+  OLA_ASSERT_FALSE(universe->IsActive());
+}
+
+
+/*
+ * Check that a universe fades to zero once the last source times out.
+ */
+void UniverseTest::testSourceExpiryFade() {
+  m_store->SetSelectServer(m_ss);
+  m_ss->RunOnce(TimeInterval(0, 0));
+
+  Universe *universe = m_store->GetUniverseOrCreate(TEST_UNIVERSE);
+  OLA_ASSERT(universe);
+  universe->SetExpiryMode(Universe::EXPIRY_FADE, TimeInterval(0, 100000));
+
+  MockClient client;
+  SendClientDMX(&client, universe, "200,100", 100);
+
+  DmxBuffer expected;
+  expected.SetFromString("200,100");
+  OLA_ASSERT_DMX_EQUALS(expected, universe->GetDMX());
+
+  // the fade starts once the source times out
+  AdvanceTime(2, 500000);
+  OLA_ASSERT_DMX_EQUALS(expected, universe->GetDMX());
+
+  AdvanceTime(0, 25000);
+  AdvanceTime(0, 25000);
+  expected.SetFromString("100,50");
+  OLA_ASSERT_DMX_EQUALS(expected, universe->GetDMX());
+
+  AdvanceTime(0, 25000);
+  AdvanceTime(0, 25000);
+  expected.SetFromString("0,0");
+  OLA_ASSERT_DMX_EQUALS(expected, universe->GetDMX());
+
+  // new data interrupts a fade
+  SendClientDMX(&client, universe, "200,100", 100);
+  AdvanceTime(2, 500000);
+  AdvanceTime(0, 25000);
+  SendClientDMX(&client, universe, "10,20", 100);
+  expected.SetFromString("10,20");
+  OLA_ASSERT_DMX_EQUALS(expected, universe->GetDMX());
+  AdvanceTime(0, 100000);
+  OLA_ASSERT_DMX_EQUALS(expected, universe->GetDMX());
+
+  universe->RemoveSourceClient(&client);
+}
+
+
+/*
+ * Check that a universe with a maximum output rate coalesces the input it
+ * receives into one frame per tick.
+ */
+void UniverseTest::testOutputRateLimit() {
+  ola::ExportMap export_map;
+  ola::UniverseStore store(m_preferences, &export_map);
+  store.SetSelectServer(m_ss);
+  store.SetOutputCallback(
+      ola::NewCallback(this, &UniverseTest::OutputPortsUpdated));
+  m_ss->RunOnce(TimeInterval(0, 0));
+
+  Universe *universe = store.GetUniverseOrCreate(TEST_UNIVERSE);
+  OLA_ASSERT(universe);
+  TestMockOutputPort port(NULL, 1);
+  universe->AddPort(&port);
+
+  // 40 fps, so one tick every 25ms
+  store.SetMaxOutputRate(universe, 40);
+  OLA_ASSERT_EQ(40u, universe->MaxOutputRate());
+
+  // two sources send data, nothing is output until the next tick
+  MockClient client1, client2;
+  SendClientDMX(&client1, universe, "1,2,3", 100);
+  SendClientDMX(&client2, universe, "4,5,6", 100);
+  SendClientDMX(&client1, universe, "7,8,9", 100);
+  OLA_ASSERT_EQ(0u, m_output_updates);
+  OLA_ASSERT_EQ(0u, port.ReadDMX().Size());
+
+  AdvanceTime(0, 25000);
+  DmxBuffer expected;
+  expected.SetFromString("7,8,9");
+  OLA_ASSERT_EQ(1u, m_output_updates);
+  OLA_ASSERT_DMX_EQUALS(expected, port.ReadDMX());
+
+  // no new input means no new output
+  AdvanceTime(0, 25000);
+  OLA_ASSERT_EQ(1u, m_output_updates);
+
+  SendClientDMX(&client2, universe, "4,5,6", 100);
+  AdvanceTime(0, 25000);
+  expected.SetFromString("4,5,6");
+  OLA_ASSERT_EQ(2u, m_output_updates);
+  OLA_ASSERT_DMX_EQUALS(expected, port.ReadDMX());
+
+  // the rates are exported once a second
+  for (unsigned int i = 0; i < 37; i++) {
+    AdvanceTime(0, 25000);
+  }
+  OLA_ASSERT_EQ(4u, (*export_map.GetUIntMapVar(
+      Universe::K_UNIVERSE_INPUT_RATE_VAR))["1"]);
+  OLA_ASSERT_EQ(2u, (*export_map.GetUIntMapVar(
+      Universe::K_UNIVERSE_OUTPUT_RATE_VAR))["1"]);
+
+  // removing the limit outputs data immediately
+  store.SetMaxOutputRate(universe, 0);
+  SendClientDMX(&client1, universe, "1,2,3", 100);
+  expected.SetFromString("1,2,3");
+  OLA_ASSERT_DMX_EQUALS(expected, port.ReadDMX());
+  m_ss->RunOnce(TimeInterval(0, 0));
+  OLA_ASSERT_EQ(3u, m_output_updates);
+
+  universe->RemoveSourceClient(&client1);
+  universe->RemoveSourceClient(&client2);
+  universe->RemovePort(&port);
+}
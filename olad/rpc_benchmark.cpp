@@ -0,0 +1,698 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * rpc_benchmark.cpp
+ * Measure the latency and cost of sending DMX through an in-process olad.
+ * Copyright (C) 2026 agent
+ *
+ * This runs an OlaServer with only the Dummy plugin loaded, and connects a
+ * number of OlaClients to it over the loopback interface. Each sending client
+ * streams frames to every universe, and a single receiving client registers
+ * for all the universes. Each sender writes a sequence number into its own
+ * block of four channels, which survives both HTP and LTP merging, so the
+ * receiver can match every merged frame back to the time it was sent.
+ *
+ * The server and the clients share a single SelectServer, so the CPU time &
+ * allocation counts cover the client library as well as olad.
+ *
+ * The results are written to stdout as JSON (the default) or CSV, so they can
+ * be compared across releases.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ola/Callback.h"
+#include "ola/Clock.h"
+#include "ola/DmxBuffer.h"
+#include "ola/Logging.h"
+#include "ola/StringUtils.h"
+#include "ola/base/Flags.h"
+#include "ola/base/Init.h"
+#include "ola/base/SysExits.h"
+#include "ola/client/OlaClient.h"
+#include "ola/io/SelectServer.h"
+#include "ola/network/IPV4Address.h"
+#include "ola/network/SocketAddress.h"
+#include "ola/network/TCPSocket.h"
+#include "ola/stl/STLUtils.h"
+#include "ola/testing/HeapCounter.h"
+#include "ola/web/Json.h"
+#include "ola/web/JsonWriter.h"
+#include "olad/OlaServer.h"
+#include "olad/PluginLoader.h"
+#include "olad/Preferences.h"
+#include "plugins/dummy/DummyPlugin.h"
+
+using ola::Clock;
+using ola::DmxBuffer;
+using ola::NewCallback;
+using ola::NewSingleCallback;
+using ola::OlaServer;
+using ola::STLDeleteElements;
+using ola::TimeInterval;
+using ola::TimeStamp;
+using ola::client::DMXMetadata;
+using ola::client::OlaClient;
+using ola::client::OlaUniverse;
+using ola::client::Result;
+using ola::io::SelectServer;
+using ola::network::IPV4Address;
+using ola::network::IPV4SocketAddress;
+using ola::network::TCPAcceptingSocket;
+using ola::network::TCPSocket;
+using ola::web::JsonArray;
+using ola::web::JsonObject;
+using std::auto_ptr;
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+
+DEFINE_string(universes, "1,8,32",
+              "A comma separated list of universe counts to run.");
+DEFINE_string(clients, "1,4",
+              "A comma separated list of the number of sending clients.");
+DEFINE_string(rates, "44",
+              "A comma separated list of frame rates, in frames per second "
+              "per universe.");
+DEFINE_string(merge_modes, "htp,ltp",
+              "A comma separated list of merge modes to run.");
+DEFINE_uint32(duration, 2000, "The time in ms to measure each run for.");
+DEFINE_uint32(warmup, 250, "The time in ms to run before measuring.");
+DEFINE_string(format, "json", "The output format, either json or csv.");
+
+DECLARE_bool(register_with_dns_sd);
+
+namespace {
+
+// Each sender uses 4 channels for its sequence number.
+const unsigned int SEQUENCE_SIZE = 4;
+const unsigned int MAX_SENDERS = ola::DMX_UNIVERSE_SIZE / SEQUENCE_SIZE;
+// The number of send times we remember for each universe.
+const unsigned int HISTORY_SIZE = 1024;
+const unsigned int SETUP_TIMEOUT_MS = 5000;
+
+struct RunParameters {
+  unsigned int universes;
+  unsigned int clients;
+  unsigned int rate;
+  OlaUniverse::merge_mode merge_mode;
+};
+
+struct RunResult {
+  uint64_t frames_sent;
+  uint64_t frames_received;
+  uint64_t cpu_time;  // in microseconds
+  uint64_t allocations;
+  uint64_t allocated_bytes;
+  vector<unsigned int> latencies;  // in microseconds
+};
+
+/*
+ * Only load the Dummy plugin.
+ */
+class DummyPluginLoader : public ola::PluginLoader {
+ public:
+  DummyPluginLoader() {}
+  ~DummyPluginLoader() { UnloadPlugins(); }
+
+  vector<ola::AbstractPlugin*> LoadPlugins() {
+    if (m_plugins.empty()) {
+      m_plugins.push_back(
+          new ola::plugin::dummy::DummyPlugin(m_plugin_adaptor));
+    }
+    return m_plugins;
+  }
+
+  void UnloadPlugins() {
+    STLDeleteElements(&m_plugins);
+  }
+
+ private:
+  vector<ola::AbstractPlugin*> m_plugins;
+};
+
+uint64_t CPUTime() {
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage)) {
+    return 0;
+  }
+  return static_cast<uint64_t>(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) *
+      ola::USEC_IN_SECONDS + usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+}
+
+/*
+ * A client that streams DMX to each universe.
+ */
+class Sender {
+ public:
+  Sender(unsigned int index, OlaClient *client, unsigned int universes)
+      : m_index(index),
+        m_client(client),
+        m_universes(universes),
+        m_sequence(0),
+        m_send_times(universes * HISTORY_SIZE),
+        m_send_sequences(universes * HISTORY_SIZE, 0) {
+    m_buffer.Blackout();
+  }
+
+  /*
+   * Send the next frame to each universe.
+   */
+  void SendFrames(Clock *clock) {
+    m_sequence++;
+    const unsigned int offset = m_index * SEQUENCE_SIZE;
+    for (unsigned int i = 0; i < SEQUENCE_SIZE; i++) {
+      m_buffer.SetChannel(offset + i,
+                          m_sequence >> (8 * (SEQUENCE_SIZE - i - 1)));
+    }
+
+    for (unsigned int universe = 0; universe < m_universes; universe++) {
+      const unsigned int slot = universe * HISTORY_SIZE +
+                                m_sequence % HISTORY_SIZE;
+      clock->CurrentMonotonicTime(&m_send_times[slot]);
+      m_send_sequences[slot] = m_sequence;
+      m_client->SendDMX(universe + 1, m_buffer,
+                        ola::client::SendDMXArgs());
+    }
+  }
+
+  /*
+   * Find the time a frame was sent.
+   */
+  bool SendTime(unsigned int universe, uint32_t sequence,
+                TimeStamp *sent) const {
+    const unsigned int slot = universe * HISTORY_SIZE + sequence % HISTORY_SIZE;
+    if (m_send_sequences[slot] != sequence) {
+      return false;
+    }
+    *sent = m_send_times[slot];
+    return true;
+  }
+
+  static uint32_t Sequence(unsigned int index, const DmxBuffer &buffer) {
+    uint32_t sequence = 0;
+    for (unsigned int i = 0; i < SEQUENCE_SIZE; i++) {
+      sequence = (sequence << 8) + buffer.Get(index * SEQUENCE_SIZE + i);
+    }
+    return sequence;
+  }
+
+ private:
+  const unsigned int m_index;
+  OlaClient *m_client;
+  const unsigned int m_universes;
+  uint32_t m_sequence;
+  DmxBuffer m_buffer;
+  vector<TimeStamp> m_send_times;
+  vector<uint32_t> m_send_sequences;
+
+  DISALLOW_COPY_AND_ASSIGN(Sender);
+};
+
+/*
+ * A single run of the benchmark.
+ */
+class BenchmarkRun {
+ public:
+  explicit BenchmarkRun(const RunParameters &parameters)
+      : m_parameters(parameters),
+        m_pending(0),
+        m_measuring(false),
+        m_start_cpu_time(0),
+        m_start_allocations(0),
+        m_start_bytes(0),
+        m_result(NULL) {
+  }
+
+  ~BenchmarkRun();
+
+  bool Run(RunResult *result);
+
+ private:
+  const RunParameters m_parameters;
+  SelectServer m_ss;
+  Clock m_clock;
+  ola::MemoryPreferencesFactory m_preferences_factory;
+  DummyPluginLoader m_plugin_loader;
+  auto_ptr<OlaServer> m_server;
+  vector<TCPSocket*> m_sockets;
+  vector<OlaClient*> m_clients;
+  vector<Sender*> m_senders;
+  vector<ola::thread::timeout_id> m_timeouts;
+  // The last sequence number seen for each universe & sender.
+  vector<uint32_t> m_last_sequences;
+  unsigned int m_pending;
+  bool m_measuring;
+  uint64_t m_start_cpu_time;
+  uint64_t m_start_allocations;
+  uint64_t m_start_bytes;
+  RunResult *m_result;
+
+  bool StartServer();
+  OlaClient *NewClient();
+  bool SetupUniverses(OlaClient *receiver);
+  void SetupComplete(const Result &result);
+
+  bool SendFrames(Sender *sender);
+  void DMXReceived(const DMXMetadata &metadata, const DmxBuffer &data);
+  void StartMeasuring();
+  void StopMeasuring();
+
+  DISALLOW_COPY_AND_ASSIGN(BenchmarkRun);
+};
+
+BenchmarkRun::~BenchmarkRun() {
+  vector<ola::thread::timeout_id>::iterator timeout_iter = m_timeouts.begin();
+  for (; timeout_iter != m_timeouts.end(); ++timeout_iter) {
+    m_ss.RemoveTimeout(*timeout_iter);
+  }
+  STLDeleteElements(&m_senders);
+
+  vector<TCPSocket*>::iterator socket_iter = m_sockets.begin();
+  for (; socket_iter != m_sockets.end(); ++socket_iter) {
+    m_ss.RemoveReadDescriptor(*socket_iter);
+  }
+
+  vector<OlaClient*>::iterator iter = m_clients.begin();
+  for (; iter != m_clients.end(); ++iter) {
+    (*iter)->Stop();
+  }
+  STLDeleteElements(&m_clients);
+  STLDeleteElements(&m_sockets);
+  m_server.reset();
+}
+
+bool BenchmarkRun::Run(RunResult *result) {
+  if (!StartServer()) {
+    return false;
+  }
+
+  OlaClient *receiver = NewClient();
+  if (!receiver || !SetupUniverses(receiver)) {
+    return false;
+  }
+
+  m_last_sequences.assign(m_parameters.universes * m_parameters.clients, 0);
+  for (unsigned int i = 0; i < m_parameters.clients; i++) {
+    OlaClient *client = NewClient();
+    if (!client) {
+      return false;
+    }
+    m_senders.push_back(new Sender(i, client, m_parameters.universes));
+  }
+
+  const TimeInterval interval(
+      static_cast<int64_t>(ola::USEC_IN_SECONDS /
+                           m_parameters.rate));
+  vector<Sender*>::iterator iter = m_senders.begin();
+  for (; iter != m_senders.end(); ++iter) {
+    m_timeouts.push_back(m_ss.RegisterRepeatingTimeout(
+        interval, NewCallback(this, &BenchmarkRun::SendFrames, *iter)));
+  }
+
+  // Reserve space for the latency samples up front, so the measurement
+  // doesn't count the allocations for our own bookkeeping.
+  const uint64_t expected_frames = (
+      static_cast<uint64_t>(m_parameters.universes) * m_parameters.clients *
+      m_parameters.rate * FLAGS_duration / ola::ONE_THOUSAND);
+  result->latencies.clear();
+  result->latencies.reserve(expected_frames + expected_frames / 2);
+  m_result = result;
+
+  m_ss.RegisterSingleTimeout(
+      FLAGS_warmup, NewSingleCallback(this, &BenchmarkRun::StartMeasuring));
+  m_ss.RegisterSingleTimeout(
+      FLAGS_warmup + FLAGS_duration,
+      NewSingleCallback(this, &BenchmarkRun::StopMeasuring));
+  m_ss.Run();
+  m_result = NULL;
+  return true;
+}
+
+bool BenchmarkRun::StartServer() {
+  auto_ptr<TCPAcceptingSocket> accepting_socket(
+      new TCPAcceptingSocket(NULL));
+  if (!accepting_socket->Listen(
+          IPV4SocketAddress(IPV4Address::Loopback(), 0))) {
+    OLA_WARN << "Failed to listen on the loopback interface";
+    return false;
+  }
+
+  OlaServer::Options options;
+  options.http_enable = false;
+  options.http_localhost_only = true;
+  options.http_enable_quit = false;
+  options.http_port = 0;
+
+  vector<ola::PluginLoader*> plugin_loaders;
+  plugin_loaders.push_back(&m_plugin_loader);
+  m_server.reset(new OlaServer(plugin_loaders, &m_preferences_factory, &m_ss,
+                               options, accepting_socket.release()));
+  if (!m_server->Init()) {
+    OLA_WARN << "Failed to start the OlaServer";
+    return false;
+  }
+  return true;
+}
+
+OlaClient *BenchmarkRun::NewClient() {
+  IPV4SocketAddress server_address = m_server->LocalRPCAddress().V4Addr();
+  TCPSocket *socket = TCPSocket::Connect(server_address);
+  if (!socket) {
+    OLA_WARN << "Failed to connect to " << server_address;
+    return NULL;
+  }
+  socket->SetNoDelay();
+  m_sockets.push_back(socket);
+
+  OlaClient *client = new OlaClient(socket);
+  m_clients.push_back(client);
+  if (!m_ss.AddReadDescriptor(socket) || !client->Setup()) {
+    OLA_WARN << "Failed to setup client";
+    return NULL;
+  }
+  // Let the server accept the connection, otherwise the listen backlog fills
+  // up when there are many clients.
+  m_ss.RunOnce(TimeInterval(0, 0));
+  return client;
+}
+
+/*
+ * Register the receiver for each universe, set the merge mode and patch the
+ * Dummy port to the first universe.
+ */
+bool BenchmarkRun::SetupUniverses(OlaClient *receiver) {
+  receiver->SetDMXCallback(NewCallback(this, &BenchmarkRun::DMXReceived));
+  for (unsigned int universe = 1; universe <= m_parameters.universes;
+       universe++) {
+    receiver->RegisterUniverse(
+        universe, ola::client::REGISTER,
+        NewSingleCallback(this, &BenchmarkRun::SetupComplete));
+    receiver->SetUniverseMergeMode(
+        universe, m_parameters.merge_mode,
+        NewSingleCallback(this, &BenchmarkRun::SetupComplete));
+    m_pending += 2;
+  }
+
+  receiver->Patch(1, 0, ola::client::OUTPUT_PORT, ola::client::PATCH, 1,
+                  NewSingleCallback(this, &BenchmarkRun::SetupComplete));
+  m_pending++;
+
+  ola::thread::timeout_id timeout = m_ss.RegisterSingleTimeout(
+      SETUP_TIMEOUT_MS,
+      NewSingleCallback(&m_ss, &SelectServer::Terminate));
+  m_ss.Run();
+  m_ss.RemoveTimeout(timeout);
+
+  if (m_pending) {
+    OLA_WARN << "Timeout waiting for the universes to be setup";
+    return false;
+  }
+  return true;
+}
+
+void BenchmarkRun::SetupComplete(const Result &result) {
+  if (!result.Success()) {
+    OLA_WARN << "Setup failed: " << result.Error();
+  }
+  if (--m_pending == 0) {
+    m_ss.Terminate();
+  }
+}
+
+bool BenchmarkRun::SendFrames(Sender *sender) {
+  sender->SendFrames(&m_clock);
+  if (m_measuring) {
+    m_result->frames_sent += m_parameters.universes;
+  }
+  return true;
+}
+
+void BenchmarkRun::DMXReceived(const DMXMetadata &metadata,
+                               const DmxBuffer &data) {
+  TimeStamp now;
+  m_clock.CurrentMonotonicTime(&now);
+
+  if (metadata.universe == 0 || metadata.universe > m_parameters.universes) {
+    return;
+  }
+  const unsigned int universe = metadata.universe - 1;
+
+  for (unsigned int i = 0; i < m_senders.size(); i++) {
+    const uint32_t sequence = Sender::Sequence(i, data);
+    uint32_t *last_sequence = &m_last_sequences[universe * m_senders.size() +
+                                                i];
+    if (sequence == 0 || sequence <= *last_sequence) {
+      continue;
+    }
+    *last_sequence = sequence;
+
+    TimeStamp sent;
+    if (m_measuring && m_senders[i]->SendTime(universe, sequence, &sent)) {
+      m_result->latencies.push_back((now - sent).AsInt());
+    }
+  }
+
+  if (m_measuring) {
+    m_result->frames_received++;
+  }
+}
+
+void BenchmarkRun::StartMeasuring() {
+  m_result->frames_sent = 0;
+  m_result->frames_received = 0;
+  m_start_cpu_time = CPUTime();
+  ola::testing::HeapStats stats = ola::testing::GetHeapStats();
+  m_start_allocations = stats.allocations;
+  m_start_bytes = stats.bytes;
+  m_measuring = true;
+}
+
+void BenchmarkRun::StopMeasuring() {
+  m_measuring = false;
+  m_result->cpu_time = CPUTime() - m_start_cpu_time;
+  ola::testing::HeapStats stats = ola::testing::GetHeapStats();
+  m_result->allocations = stats.allocations - m_start_allocations;
+  m_result->allocated_bytes = stats.bytes - m_start_bytes;
+  m_ss.Terminate();
+}
+
+/*
+ * Parse a comma separated list of positive integers.
+ */
+bool ParseList(const string &input, vector<unsigned int> *values) {
+  vector<string> tokens;
+  ola::StringSplit(input, &tokens, ",");
+  vector<string>::const_iterator iter = tokens.begin();
+  for (; iter != tokens.end(); ++iter) {
+    unsigned int value;
+    if (!ola::StringToInt(*iter, &value) || value == 0) {
+      OLA_FATAL << "Invalid value: " << *iter;
+      return false;
+    }
+    values->push_back(value);
+  }
+  return !values->empty();
+}
+
+bool ParseMergeModes(const string &input,
+                     vector<OlaUniverse::merge_mode> *modes) {
+  vector<string> tokens;
+  ola::StringSplit(input, &tokens, ",");
+  vector<string>::iterator iter = tokens.begin();
+  for (; iter != tokens.end(); ++iter) {
+    ola::ToLower(&*iter);
+    if (*iter == "htp") {
+      modes->push_back(OlaUniverse::MERGE_HTP);
+    } else if (*iter == "ltp") {
+      modes->push_back(OlaUniverse::MERGE_LTP);
+    } else {
+      OLA_FATAL << "Invalid merge mode: " << *iter;
+      return false;
+    }
+  }
+  return !modes->empty();
+}
+
+/*
+ * Return the latency at the given percentile, the samples must be sorted.
+ */
+unsigned int Percentile(const vector<unsigned int> &samples,
+                        double percentile) {
+  if (samples.empty()) {
+    return 0;
+  }
+  size_t index = static_cast<size_t>(percentile * samples.size());
+  return samples[std::min(index, samples.size() - 1)];
+}
+
+double PerFrame(uint64_t value, uint64_t frames) {
+  return frames ? static_cast<double>(value) / frames : 0.0;
+}
+
+/*
+ * The numbers we report for each run.
+ */
+struct RunSummary {
+  RunParameters parameters;
+  unsigned int frames_sent;
+  unsigned int frames_received;
+  unsigned int latency_samples;
+  unsigned int latency_p50;
+  unsigned int latency_p99;
+  unsigned int latency_p999;
+  unsigned int latency_max;
+  double cpu_per_frame;
+  double allocations_per_frame;
+  double allocated_bytes_per_frame;
+};
+
+RunSummary Summarize(const RunParameters &parameters, RunResult *result) {
+  vector<unsigned int> *latencies = &result->latencies;
+  std::sort(latencies->begin(), latencies->end());
+
+  RunSummary summary;
+  summary.parameters = parameters;
+  summary.frames_sent = result->frames_sent;
+  summary.frames_received = result->frames_received;
+  summary.latency_samples = latencies->size();
+  summary.latency_p50 = Percentile(*latencies, 0.5);
+  summary.latency_p99 = Percentile(*latencies, 0.99);
+  summary.latency_p999 = Percentile(*latencies, 0.999);
+  summary.latency_max = latencies->empty() ? 0 : latencies->back();
+  summary.cpu_per_frame = PerFrame(result->cpu_time, result->frames_sent);
+  summary.allocations_per_frame = PerFrame(result->allocations,
+                                           result->frames_sent);
+  summary.allocated_bytes_per_frame = PerFrame(result->allocated_bytes,
+                                               result->frames_sent);
+  return summary;
+}
+
+const char *MergeModeName(OlaUniverse::merge_mode merge_mode) {
+  return merge_mode == OlaUniverse::MERGE_HTP ? "htp" : "ltp";
+}
+
+void WriteJson(const vector<RunSummary> &summaries) {
+  JsonArray results;
+  vector<RunSummary>::const_iterator iter = summaries.begin();
+  for (; iter != summaries.end(); ++iter) {
+    JsonObject *output = results.AppendObject();
+    output->Add("universes", iter->parameters.universes);
+    output->Add("clients", iter->parameters.clients);
+    output->Add("rate", iter->parameters.rate);
+    output->Add("merge_mode", MergeModeName(iter->parameters.merge_mode));
+    output->Add("frames_sent", iter->frames_sent);
+    output->Add("frames_received", iter->frames_received);
+    output->Add("latency_samples", iter->latency_samples);
+    output->Add("latency_p50_us", iter->latency_p50);
+    output->Add("latency_p99_us", iter->latency_p99);
+    output->Add("latency_p999_us", iter->latency_p999);
+    output->Add("latency_max_us", iter->latency_max);
+    output->Add("cpu_us_per_frame", iter->cpu_per_frame);
+    output->Add("allocations_per_frame", iter->allocations_per_frame);
+    output->Add("allocated_bytes_per_frame",
+                iter->allocated_bytes_per_frame);
+  }
+  ola::web::JsonWriter::Write(&cout, results);
+  cout << endl;
+}
+
+void WriteCSV(const vector<RunSummary> &summaries) {
+  cout << "universes,clients,rate,merge_mode,frames_sent,frames_received,"
+       << "latency_samples,latency_p50_us,latency_p99_us,latency_p999_us,"
+       << "latency_max_us,cpu_us_per_frame,allocations_per_frame,"
+       << "allocated_bytes_per_frame" << endl;
+
+  vector<RunSummary>::const_iterator iter = summaries.begin();
+  for (; iter != summaries.end(); ++iter) {
+    cout << iter->parameters.universes << "," << iter->parameters.clients
+         << "," << iter->parameters.rate << ","
+         << MergeModeName(iter->parameters.merge_mode) << ","
+         << iter->frames_sent << "," << iter->frames_received << ","
+         << iter->latency_samples << "," << iter->latency_p50 << ","
+         << iter->latency_p99 << "," << iter->latency_p999 << ","
+         << iter->latency_max << "," << iter->cpu_per_frame << ","
+         << iter->allocations_per_frame << ","
+         << iter->allocated_bytes_per_frame << endl;
+  }
+}
+}  // namespace
+
+/*
+ * Main
+ */
+int main(int argc, char *argv[]) {
+  ola::AppInit(&argc, argv, "[options]",
+               "Measure the latency and cost of sending DMX through an "
+               "in-process olad.");
+  FLAGS_register_with_dns_sd = false;
+
+  vector<unsigned int> universe_counts, client_counts, rates;
+  vector<OlaUniverse::merge_mode> merge_modes;
+  if (!ParseList(FLAGS_universes, &universe_counts) ||
+      !ParseList(FLAGS_clients, &client_counts) ||
+      !ParseList(FLAGS_rates, &rates) ||
+      !ParseMergeModes(FLAGS_merge_modes, &merge_modes)) {
+    exit(ola::EXIT_USAGE);
+  }
+
+  vector<RunSummary> summaries;
+  for (unsigned int u = 0; u < universe_counts.size(); u++) {
+    for (unsigned int c = 0; c < client_counts.size(); c++) {
+      for (unsigned int r = 0; r < rates.size(); r++) {
+        for (unsigned int m = 0; m < merge_modes.size(); m++) {
+          RunParameters parameters;
+          parameters.universes = universe_counts[u];
+          parameters.clients = client_counts[c];
+          parameters.rate = rates[r];
+          parameters.merge_mode = merge_modes[m];
+
+          if (parameters.clients > MAX_SENDERS) {
+            OLA_WARN << "Skipping " << parameters.clients
+                     << " clients, the maximum is " << MAX_SENDERS;
+            continue;
+          }
+
+          OLA_INFO << "Running " << parameters.universes << " universes, "
+                   << parameters.clients << " clients @ " << parameters.rate
+                   << " fps";
+          RunResult result;
+          BenchmarkRun run(parameters);
+          if (!run.Run(&result)) {
+            OLA_FATAL << "Benchmark run failed";
+            exit(ola::EXIT_SOFTWARE);
+          }
+          summaries.push_back(Summarize(parameters, &result));
+        }
+      }
+    }
+  }
+
+  if (FLAGS_format.str() == "csv") {
+    WriteCSV(summaries);
+  } else {
+    WriteJson(summaries);
+  }
+  return ola::EXIT_OK;
+}
@@ -34,6 +34,7 @@
 #include "ola/Logging.h"
 #include "ola/StringUtils.h"
 #include "ola/network/IPV4Address.h"
+#include "ola/network/InterfaceMonitor.h"
 #include "ola/network/InterfacePicker.h"
 #include "ola/network/NetworkUtils.h"
 #include "olad/PluginAdaptor.h"
@@ -87,9 +88,16 @@ bool ArtNetDevice::StartHook() {
   unsigned int net = StringToIntOrDefault(
       m_preferences->GetValue(K_NET_KEY), K_ARTNET_NET);
 
+  ola::network::InterfaceMonitor *monitor =
+      m_plugin_adaptor->GetInterfaceMonitor();
+  const ola::network::InterfacePicker *picker = monitor;
+  auto_ptr<ola::network::InterfacePicker> our_picker;
+  if (!picker) {
+    our_picker.reset(ola::network::InterfacePicker::NewPicker());
+    picker = our_picker.get();
+  }
+
   ola::network::Interface iface;
-  auto_ptr<ola::network::InterfacePicker> picker(
-      ola::network::InterfacePicker::NewPicker());
   ola::network::InterfacePicker::Options options;
   options.include_loopback = m_preferences->GetValueAsBool(K_LOOPBACK_KEY);
   if (!picker->ChooseInterface(&iface,
@@ -137,10 +145,17 @@ bool ArtNetDevice::StartHook() {
   m_timeout_id = m_plugin_adaptor->RegisterRepeatingTimeout(
       POLL_INTERVAL,
       NewCallback(m_node, &ArtNetNode::SendPoll));
+
+  if (monitor) {
+    monitor->AddObserver(this);
+  }
   return true;
 }
 
 void ArtNetDevice::PrePortStop() {
+  if (m_plugin_adaptor->GetInterfaceMonitor()) {
+    m_plugin_adaptor->GetInterfaceMonitor()->RemoveObserver(this);
+  }
   if (m_timeout_id != ola::thread::INVALID_TIMEOUT) {
     m_plugin_adaptor->RemoveTimeout(m_timeout_id);
     m_timeout_id = ola::thread::INVALID_TIMEOUT;
@@ -153,6 +168,25 @@ void ArtNetDevice::PostPortStop() {
   m_node = NULL;
 }
 
+void ArtNetDevice::InterfaceAdded(const ola::network::Interface &iface) {
+  if (m_node && iface.name == m_node->GetInterface().name) {
+    FollowInterface();
+  }
+}
+
+void ArtNetDevice::InterfaceRemoved(const ola::network::Interface &iface) {
+  if (!m_node) {
+    return;
+  }
+  const ola::network::Interface &current = m_node->GetInterface();
+  if (iface.name == current.name &&
+      iface.ip_address == current.ip_address &&
+      !FollowInterface()) {
+    OLA_WARN << "Art-Net interface " << iface.name << " lost "
+             << iface.ip_address;
+  }
+}
+
 void ArtNetDevice::Configure(RpcController *controller,
                              const string &request,
                              string *response,
@@ -176,6 +210,27 @@ void ArtNetDevice::Configure(RpcController *controller,
   }
 }
 
+/*
+ * Move the node to a new address on its interface, if the InterfaceMonitor
+ * says it should.
+ */
+bool ArtNetDevice::FollowInterface() {
+  ola::network::InterfaceMonitor *monitor =
+      m_plugin_adaptor->GetInterfaceMonitor();
+  const ola::network::Interface &current = m_node->GetInterface();
+  ola::network::Interface iface;
+  if (!monitor ||
+      !monitor->FollowInterface(current, m_preferences->GetValue(K_IP_KEY),
+                                &iface)) {
+    return false;
+  }
+
+  OLA_INFO << "Art-Net interface " << iface.name << " moved from "
+           << current.ip_address << " to " << iface.ip_address;
+  m_node->SetInterface(iface);
+  return true;
+}
+
 void ArtNetDevice::HandleOptions(Request *request, string *response) {
   bool status = true;
   if (request->has_options()) {
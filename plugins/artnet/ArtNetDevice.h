@@ -33,6 +33,7 @@
 
 #include <string>
 
+#include "ola/network/InterfaceMonitor.h"
 #include "olad/Device.h"
 #include "plugins/artnet/messages/ArtNetConfigMessages.pb.h"
 #include "plugins/artnet/ArtNetNode.h"
@@ -44,7 +45,8 @@ class Preferences;
 namespace plugin {
 namespace artnet {
 
-class ArtNetDevice: public Device {
+class ArtNetDevice: public Device,
+                    public ola::network::InterfaceObserver {
  public:
   /**
    * Create a new Art-Net Device
@@ -71,6 +73,13 @@ class ArtNetDevice: public Device {
                  std::string *response,
                  ConfigureCallback *done);
 
+  /**
+   * Follow the node's interface to a new address, if the current one has
+   * gone or the configured one has appeared.
+   */
+  void InterfaceAdded(const ola::network::Interface &iface);
+  void InterfaceRemoved(const ola::network::Interface &iface);
+
   static const char K_ALWAYS_BROADCAST_KEY[];
   static const char K_DEVICE_NAME[];
   static const char K_IP_KEY[];
@@ -110,6 +119,8 @@ class ArtNetDevice: public Device {
   class PluginAdaptor *m_plugin_adaptor;
   ola::thread::timeout_id m_timeout_id;
 
+  bool FollowInterface();
+
   /**
    * Handle an options request
    */
@@ -344,6 +344,14 @@ bool ArtNetNodeImpl::SetShortName(const string &name) {
   return SendPollReplyIfRequired();
 }
 
+bool ArtNetNodeImpl::SetInterface(const ola::network::Interface &iface) {
+  if (m_interface == iface) {
+    return true;
+  }
+  m_interface = iface;
+  return SendPollReplyIfRequired();
+}
+
 bool ArtNetNodeImpl::SetLongName(const string &name) {
   if (m_long_name == name) {
     return true;
@@ -143,6 +143,17 @@ class ArtNetNodeImpl {
   bool SetShortName(const std::string &name);
   std::string ShortName() const { return m_short_name; }
 
+  /**
+   * @brief Change the interface used by this node.
+   * @param iface the new interface, this should be on the same link.
+   *
+   * This is used when the interface is given a new address. The socket is
+   * bound to the wildcard address so only the addresses advertised in the
+   * ArtPollReply need to change.
+   */
+  bool SetInterface(const ola::network::Interface &iface);
+  const ola::network::Interface &GetInterface() const { return m_interface; }
+
   /**
    * @brief Set the long name.
    * @param name the long node name
@@ -717,6 +728,13 @@ class ArtNetNode {
     return m_impl.SetShortName(name);
   }
 
+  bool SetInterface(const ola::network::Interface &iface) {
+    return m_impl.SetInterface(iface);
+  }
+  const ola::network::Interface &GetInterface() const {
+    return m_impl.GetInterface();
+  }
+
   std::string ShortName() const { return m_impl.ShortName(); }
   bool SetLongName(const std::string &name) {
     return m_impl.SetLongName(name);
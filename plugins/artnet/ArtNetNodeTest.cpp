@@ -413,6 +413,22 @@ void ArtNetNodeTest::testBasicBehaviour() {
   OLA_ASSERT(node.SendPoll());
   m_socket->Verify();
 
+  // a change of address should be announced with a poll reply
+  Interface new_iface = iface;
+  new_iface.ip_address = IPV4Address::FromStringOrDie("10.0.0.2");
+  expected_poll_reply_packet[13] = 2;  // ip
+  expected_poll_reply_packet[115] = '2';  // node report
+  expected_poll_reply_packet[210] = 2;  // bind ip
+  ExpectedBroadcast(expected_poll_reply_packet,
+                    sizeof(expected_poll_reply_packet));
+  OLA_ASSERT(node.SetInterface(new_iface));
+  OLA_ASSERT_EQ(new_iface, node.GetInterface());
+  m_socket->Verify();
+
+  // setting the same interface is a no-op
+  OLA_ASSERT(node.SetInterface(new_iface));
+  m_socket->Verify();
+
   OLA_ASSERT(node.Stop());
 }
 
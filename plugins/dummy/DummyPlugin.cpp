@@ -46,6 +46,10 @@ const char DummyPlugin::DEVICE_NAME[] = "Dummy Device";
 const char DummyPlugin::DIMMER_COUNT_KEY[] = "dimmer_count";
 const char DummyPlugin::DIMMER_SUBDEVICE_COUNT_KEY[] = "dimmer_subdevice_count";
 const char DummyPlugin::DUMMY_DEVICE_COUNT_KEY[] = "dummy_device_count";
+const char DummyPlugin::FARM_COUNT_KEY[] = "farm_responder_count";
+const char DummyPlugin::FARM_LATENCY_KEY[] = "farm_response_latency";
+const char DummyPlugin::FARM_LOSS_KEY[] = "farm_response_loss";
+const unsigned int DummyPlugin::MAX_FARM_RESPONDER_COUNT = 1000000;
 const char DummyPlugin::MOVING_LIGHT_COUNT_KEY[] = "moving_light_count";
 const char DummyPlugin::NETWORK_COUNT_KEY[] = "network_device_count";
 const char DummyPlugin::PLUGIN_NAME[] = "Dummy";
@@ -100,8 +104,23 @@ bool DummyPlugin::StartHook() {
     options.number_of_network_responders = DEFAULT_DEVICE_COUNT;
   }
 
+  if (!StringToInt(m_preferences->GetValue(FARM_COUNT_KEY) ,
+                   &options.number_of_farm_responders)) {
+    options.number_of_farm_responders = 0;
+  }
+
+  if (!StringToInt(m_preferences->GetValue(FARM_LATENCY_KEY) ,
+                   &options.farm_response_latency)) {
+    options.farm_response_latency = 0;
+  }
+
+  if (!StringToInt(m_preferences->GetValue(FARM_LOSS_KEY) ,
+                   &options.farm_response_loss)) {
+    options.farm_response_loss = 0;
+  }
+
   std::auto_ptr<DummyDevice> device(
-      new DummyDevice(this, DEVICE_NAME, options));
+      new DummyDevice(this, DEVICE_NAME, options, m_plugin_adaptor));
   if (!device->Start()) {
     return false;
   }
@@ -173,6 +192,19 @@ bool DummyPlugin::SetDefaultPreferences() {
                                          IntValidator(0, 254),
                                          DEFAULT_DEVICE_COUNT);
 
+  save |= m_preferences->SetDefaultValue(
+      FARM_COUNT_KEY,
+      UIntValidator(0, MAX_FARM_RESPONDER_COUNT),
+      0u);
+
+  save |= m_preferences->SetDefaultValue(FARM_LATENCY_KEY,
+                                         UIntValidator(0, 1000),
+                                         0u);
+
+  save |= m_preferences->SetDefaultValue(FARM_LOSS_KEY,
+                                         UIntValidator(0, 100),
+                                         0u);
+
   if (save) {
     m_preferences->Save();
   }
@@ -58,6 +58,10 @@ class DummyPlugin: public Plugin {
     static const char DIMMER_COUNT_KEY[];
     static const char DIMMER_SUBDEVICE_COUNT_KEY[];
     static const char DUMMY_DEVICE_COUNT_KEY[];
+    static const char FARM_COUNT_KEY[];
+    static const char FARM_LATENCY_KEY[];
+    static const char FARM_LOSS_KEY[];
+    static const unsigned int MAX_FARM_RESPONDER_COUNT;
     static const char MOVING_LIGHT_COUNT_KEY[];
     static const char NETWORK_COUNT_KEY[];
     static const char PLUGIN_NAME[];
@@ -72,7 +72,8 @@ void AddResponders(map<UID, ola::rdm::RDMControllerInterface*> *responders,
 
 DummyPort::DummyPort(DummyDevice *parent,
                      const Options &options,
-                     unsigned int id)
+                     unsigned int id,
+                     ola::thread::SchedulerInterface *scheduler)
     : BasicOutputPort(parent, id, true, true) {
   UID first_uid(OPEN_LIGHTING_ESTA_CODE, DummyPort::kStartAddress);
   ola::rdm::UIDAllocator allocator(first_uid);
@@ -103,6 +104,21 @@ DummyPort::DummyPort(DummyDevice *parent,
       &m_responders, &allocator, options.number_of_sensor_responders);
   AddResponders<ola::rdm::NetworkResponder>(
       &m_responders, &allocator, options.number_of_network_responders);
+
+  if (options.number_of_farm_responders) {
+    if (!scheduler) {
+      OLA_WARN << "No scheduler, not creating the responder farm";
+    } else {
+      ResponderFarm::Options farm_options;
+      farm_options.responder_count = options.number_of_farm_responders;
+      farm_options.latency = options.farm_response_latency;
+      farm_options.loss = options.farm_response_loss;
+      m_farm.reset(new ResponderFarm(scheduler,
+                                     UID(kFarmManufacturerId, 0),
+                                     farm_options));
+      m_discovery_agent.reset(new ola::rdm::DiscoveryAgent(m_farm.get()));
+    }
+  }
 }
 
 
@@ -121,11 +137,11 @@ bool DummyPort::WriteDMX(const DmxBuffer &buffer,
 }
 
 void DummyPort::RunFullDiscovery(RDMDiscoveryCallback *callback) {
-  RunDiscovery(callback);
+  RunDiscovery(callback, false);
 }
 
 void DummyPort::RunIncrementalDiscovery(RDMDiscoveryCallback *callback) {
-  RunDiscovery(callback);
+  RunDiscovery(callback, true);
 }
 
 void DummyPort::SendRDMRequest(ola::rdm::RDMRequest *request_ptr,
@@ -134,14 +150,19 @@ void DummyPort::SendRDMRequest(ola::rdm::RDMRequest *request_ptr,
 
   UID dest = request->DestinationUID();
   if (dest.IsBroadcast()) {
-    if (m_responders.empty()) {
+    if (m_responders.empty() && !m_farm.get()) {
       RunRDMCallback(callback, ola::rdm::RDM_WAS_BROADCAST);
     } else {
       broadcast_request_tracker *tracker = new broadcast_request_tracker;
-      tracker->expected_count = m_responders.size();
+      tracker->expected_count = m_responders.size() + (m_farm.get() ? 1 : 0);
       tracker->current_count = 0;
       tracker->failed = false;
       tracker->callback = callback;
+      if (m_farm.get()) {
+        m_farm->SendRDMRequest(
+          request->Duplicate(),
+          NewSingleCallback(this, &DummyPort::HandleBroadcastAck, tracker));
+      }
       for (ResponderMap::iterator i = m_responders.begin();
            i != m_responders.end(); i++) {
         i->second->SendRDMRequest(
@@ -149,6 +170,8 @@ void DummyPort::SendRDMRequest(ola::rdm::RDMRequest *request_ptr,
           NewSingleCallback(this, &DummyPort::HandleBroadcastAck, tracker));
       }
     }
+  } else if (m_farm.get() && m_farm->Contains(dest)) {
+    m_farm->SendRDMRequest(request.release(), callback);
   } else {
     ola::rdm::RDMControllerInterface *controller = STLFindOrNull(
         m_responders, dest);
@@ -161,13 +184,56 @@ void DummyPort::SendRDMRequest(ola::rdm::RDMRequest *request_ptr,
 }
 
 
-void DummyPort::RunDiscovery(RDMDiscoveryCallback *callback) {
-  ola::rdm::UIDSet uid_set;
+void DummyPort::RunDiscovery(RDMDiscoveryCallback *callback,
+                             bool incremental) {
+  if (!m_discovery_agent.get()) {
+    ola::rdm::UIDSet uid_set;
+    AddResponderUIDs(&uid_set);
+    callback->Run(uid_set);
+    return;
+  }
+
+  // The farm responders are found with DUB, the others are just added.
+  m_discovery_callbacks.push_back(callback);
+  if (m_discovery_callbacks.size() > 1) {
+    // Discovery is already running
+    return;
+  }
+
+  ola::rdm::DiscoveryAgent::DiscoveryCompleteCallback *on_complete =
+      NewSingleCallback(this, &DummyPort::FarmDiscoveryComplete);
+  if (incremental) {
+    m_discovery_agent->StartIncrementalDiscovery(on_complete);
+  } else {
+    m_discovery_agent->StartFullDiscovery(on_complete);
+  }
+}
+
+
+void DummyPort::FarmDiscoveryComplete(bool ok,
+                                      const ola::rdm::UIDSet &farm_uids) {
+  if (!ok) {
+    OLA_WARN << "Responder farm discovery failed, found " << farm_uids.Size()
+             << " of " << m_farm->Size();
+  }
+
+  ola::rdm::UIDSet uid_set(farm_uids);
+  AddResponderUIDs(&uid_set);
+
+  DiscoveryCallbacks callbacks;
+  callbacks.swap(m_discovery_callbacks);
+  DiscoveryCallbacks::iterator iter = callbacks.begin();
+  for (; iter != callbacks.end(); ++iter) {
+    (*iter)->Run(uid_set);
+  }
+}
+
+
+void DummyPort::AddResponderUIDs(ola::rdm::UIDSet *uids) {
   for (ResponderMap::iterator i = m_responders.begin();
     i != m_responders.end(); i++) {
-    uid_set.AddUID(i->first);
+    uids->AddUID(i->first);
   }
-  callback->Run(uid_set);
 }
 
 
@@ -190,6 +256,15 @@ void DummyPort::HandleBroadcastAck(broadcast_request_tracker *tracker,
 
 
 DummyPort::~DummyPort() {
+  // The farm fails its pending replies when it's deleted, and those run the
+  // agent's callbacks, so the agent has to outlive the farm. Aborting first
+  // runs the discovery callbacks, which need the responders, and means the
+  // failed replies don't start any new branches.
+  if (m_discovery_agent.get()) {
+    m_discovery_agent->Abort();
+  }
+  m_farm.reset();
+  m_discovery_agent.reset();
   STLDeleteValues(&m_responders);
 }
 }  // namespace dummy
@@ -24,13 +24,18 @@
 #include <stdint.h>
 #include <string>
 #include <map>
+#include <memory>
 #include <vector>
 #include "ola/Constants.h"
 #include "ola/DmxBuffer.h"
+#include "ola/rdm/DiscoveryAgent.h"
 #include "ola/rdm/RDMControllerInterface.h"
 #include "ola/rdm/RDMEnums.h"
 #include "ola/rdm/UID.h"
+#include "ola/rdm/UIDSet.h"
+#include "ola/thread/SchedulerInterface.h"
 #include "olad/Port.h"
+#include "plugins/dummy/ResponderFarm.h"
 
 namespace ola {
 namespace plugin {
@@ -48,7 +53,10 @@ class DummyPort: public BasicOutputPort {
           number_of_ack_timer_responders(0),
           number_of_advanced_dimmers(1),
           number_of_sensor_responders(1),
-          number_of_network_responders(1) {
+          number_of_network_responders(1),
+          number_of_farm_responders(0),
+          farm_response_latency(0),
+          farm_response_loss(0) {
     }
 
     uint8_t number_of_dimmers;
@@ -59,6 +67,9 @@ class DummyPort: public BasicOutputPort {
     uint8_t number_of_advanced_dimmers;
     uint8_t number_of_sensor_responders;
     uint8_t number_of_network_responders;
+    uint32_t number_of_farm_responders;
+    unsigned int farm_response_latency;  // in ms
+    uint8_t farm_response_loss;  // as a percentage
   };
 
 
@@ -68,10 +79,13 @@ class DummyPort: public BasicOutputPort {
    * @param options the config for the DummyPort such as the number of fake RDM
    * devices to create
    * @param id the ID of this port
+   * @param scheduler the scheduler used by the responder farm. The farm is
+   *   only created if this is provided.
    */
   DummyPort(class DummyDevice *parent,
             const Options &options,
-            unsigned int id);
+            unsigned int id,
+            ola::thread::SchedulerInterface *scheduler = NULL);
   virtual ~DummyPort();
   bool WriteDMX(const DmxBuffer &buffer, uint8_t priority);
   std::string Description() const { return "Dummy Port"; }
@@ -95,16 +109,26 @@ class DummyPort: public BasicOutputPort {
   typedef std::map<ola::rdm::UID,
                    ola::rdm::RDMControllerInterface*> ResponderMap;
 
+  typedef std::vector<ola::rdm::RDMDiscoveryCallback*> DiscoveryCallbacks;
+
   DmxBuffer m_buffer;
   ResponderMap m_responders;
+  std::auto_ptr<ResponderFarm> m_farm;
+  std::auto_ptr<ola::rdm::DiscoveryAgent> m_discovery_agent;
+  DiscoveryCallbacks m_discovery_callbacks;
 
-  void RunDiscovery(ola::rdm::RDMDiscoveryCallback *callback);
+  void RunDiscovery(ola::rdm::RDMDiscoveryCallback *callback,
+                    bool incremental);
+  void FarmDiscoveryComplete(bool ok, const ola::rdm::UIDSet &farm_uids);
+  void AddResponderUIDs(ola::rdm::UIDSet *uids);
   void HandleBroadcastAck(broadcast_request_tracker *tracker,
                           ola::rdm::RDMReply *reply);
 
   // See https://wiki.openlighting.org/index.php/Open_Lighting_Allocations
   // Do not change.
   static const unsigned int kStartAddress = 0xffffff00;
+  // ESTA reserves 0x7ff0 - 0x7fff for prototyping.
+  static const uint16_t kFarmManufacturerId = 0x7ff0;
 };
 }  // namespace dummy
 }  // namespace plugin
@@ -26,12 +26,15 @@
 #endif  // HAVE_CONFIG_H
 
 #include <algorithm>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "common/rdm/TestHelper.h"
+#include "ola/Clock.h"
 #include "ola/Constants.h"
 #include "ola/Logging.h"
+#include "ola/io/SelectServer.h"
 #include "ola/network/Interface.h"
 #include "ola/network/NetworkUtils.h"
 #include "ola/rdm/OpenLightingEnums.h"
@@ -73,6 +76,7 @@ class MockDummyPort: public DummyPort {
 class DummyPortTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(DummyPortTest);
   CPPUNIT_TEST(testRDMDiscovery);
+  CPPUNIT_TEST(testDestroyDuringDiscovery);
   CPPUNIT_TEST(testUnknownPid);
   CPPUNIT_TEST(testSupportedParams);
   CPPUNIT_TEST(testDeviceInfo);
@@ -104,6 +108,7 @@ class DummyPortTest: public CppUnit::TestFixture {
   void Verify() { OLA_ASSERT_FALSE(m_expected_response); }
 
   void testRDMDiscovery();
+  void testDestroyDuringDiscovery();
   void testUnknownPid();
   void testSupportedParams();
   void testDeviceInfo();
@@ -198,6 +203,29 @@ void DummyPortTest::testRDMDiscovery() {
 }
 
 
+/*
+ * Check a port with a responder farm can be deleted while discovery is
+ * running.
+ */
+void DummyPortTest::testDestroyDuringDiscovery() {
+  ola::io::SelectServer ss;
+  DummyPort::Options options;
+  options.number_of_farm_responders = 10;
+  std::auto_ptr<DummyPort> port(new DummyPort(NULL, options, 1, &ss));
+
+  // The farm's reply to the first UnMuteAll is still pending when the port is
+  // deleted. Discovery is aborted, so only the regular responders are found.
+  port->RunFullDiscovery(
+      NewSingleCallback(this, &DummyPortTest::VerifyUIDs));
+  OLA_ASSERT_FALSE(m_got_uids);
+  port.reset();
+  OLA_ASSERT_TRUE(m_got_uids);
+
+  // Nothing is left scheduled.
+  ss.RunOnce(ola::TimeInterval(0, 0));
+}
+
+
 /*
  * Check that unknown pids fail
  */
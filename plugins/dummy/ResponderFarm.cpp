@@ -0,0 +1,700 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * ResponderFarm.cpp
+ * A large number of simulated RDM responders, for load testing.
+ * Copyright (C) 2026 agent
+ */
+
+#include <string.h>
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+#include "ola/Logging.h"
+#include "ola/math/Random.h"
+#include "ola/rdm/OpenLightingEnums.h"
+#include "ola/rdm/RDMCommand.h"
+#include "ola/rdm/RDMEnums.h"
+#include "ola/rdm/RDMReply.h"
+#include "ola/rdm/ResponderHelper.h"
+#include "ola/rdm/ResponderOps.h"
+#include "ola/rdm/ResponderPersonality.h"
+#include "ola/rdm/ResponderSlotData.h"
+#include "ola/stl/STLUtils.h"
+#include "plugins/dummy/ResponderFarm.h"
+
+namespace ola {
+namespace plugin {
+namespace dummy {
+
+using ola::rdm::NackWithReason;
+using ola::rdm::Personality;
+using ola::rdm::PersonalityCollection;
+using ola::rdm::PersonalityManager;
+using ola::rdm::RDMCallback;
+using ola::rdm::RDMReply;
+using ola::rdm::RDMRequest;
+using ola::rdm::RDMResponse;
+using ola::rdm::ResponderHelper;
+using ola::rdm::ResponderOps;
+using ola::rdm::SlotData;
+using ola::rdm::SlotDataCollection;
+using ola::rdm::UID;
+using std::auto_ptr;
+using std::string;
+
+namespace {
+void IgnoreReply(RDMReply*) {}
+
+const char DEFAULT_LABEL[] = "Dummy Farm Responder";
+}  // namespace
+
+/**
+ * @brief A view of one responder in the farm.
+ *
+ * These are created on the stack for each request. The PID handlers and the
+ * personalities are shared between all the responders.
+ */
+class ResponderFarm::FarmResponder {
+ public:
+  FarmResponder(ResponderFarm *farm, uint32_t index)
+      : m_farm(farm),
+        m_index(index),
+        m_state(&farm->m_responders[index]),
+        m_personality_manager(Personalities::Instance()) {
+    m_personality_manager.SetActivePersonality(m_state->personality);
+  }
+
+  ~FarmResponder() {
+    m_state->personality = m_personality_manager.ActivePersonalityNumber();
+  }
+
+  void SendRDMRequest(const UID &uid, RDMRequest *request,
+                      RDMCallback *callback) {
+    RDMOps::Instance()->HandleRDMRequest(this, uid, ola::rdm::ROOT_RDM_DEVICE,
+                                         request, callback);
+  }
+
+ private:
+  class RDMOps : public ResponderOps<FarmResponder> {
+   public:
+    static RDMOps *Instance() {
+      if (!instance)
+        instance = new RDMOps();
+      return instance;
+    }
+
+   private:
+    RDMOps() : ResponderOps<FarmResponder>(PARAM_HANDLERS) {}
+
+    static RDMOps *instance;
+  };
+
+  class Personalities : public PersonalityCollection {
+   public:
+    static const Personalities *Instance();
+
+   private:
+    explicit Personalities(const PersonalityList &personalities) :
+      PersonalityCollection(personalities) {
+    }
+
+    static Personalities *instance;
+  };
+
+  ResponderFarm *m_farm;
+  const uint32_t m_index;
+  ResponderState *m_state;
+  PersonalityManager m_personality_manager;
+
+  RDMResponse *GetDeviceInfo(const RDMRequest *request);
+  RDMResponse *GetFactoryDefaults(const RDMRequest *request);
+  RDMResponse *SetFactoryDefaults(const RDMRequest *request);
+  RDMResponse *GetDeviceModelDescription(const RDMRequest *request);
+  RDMResponse *GetManufacturerLabel(const RDMRequest *request);
+  RDMResponse *GetDeviceLabel(const RDMRequest *request);
+  RDMResponse *SetDeviceLabel(const RDMRequest *request);
+  RDMResponse *GetSoftwareVersionLabel(const RDMRequest *request);
+  RDMResponse *GetPersonality(const RDMRequest *request);
+  RDMResponse *SetPersonality(const RDMRequest *request);
+  RDMResponse *GetPersonalityDescription(const RDMRequest *request);
+  RDMResponse *GetSlotInfo(const RDMRequest *request);
+  RDMResponse *GetSlotDescription(const RDMRequest *request);
+  RDMResponse *GetSlotDefaultValues(const RDMRequest *request);
+  RDMResponse *GetDmxStartAddress(const RDMRequest *request);
+  RDMResponse *SetDmxStartAddress(const RDMRequest *request);
+  RDMResponse *GetIdentify(const RDMRequest *request);
+  RDMResponse *SetIdentify(const RDMRequest *request);
+
+  static const ResponderOps<FarmResponder>::ParamHandler PARAM_HANDLERS[];
+
+  DISALLOW_COPY_AND_ASSIGN(FarmResponder);
+};
+
+ResponderFarm::FarmResponder::RDMOps *
+    ResponderFarm::FarmResponder::RDMOps::instance = NULL;
+
+ResponderFarm::FarmResponder::Personalities *
+    ResponderFarm::FarmResponder::Personalities::instance = NULL;
+
+const ResponderFarm::FarmResponder::Personalities *
+    ResponderFarm::FarmResponder::Personalities::Instance() {
+  if (!instance) {
+    SlotDataCollection::SlotDataList dimmer_slots;
+    dimmer_slots.push_back(SlotData::PrimarySlot(ola::rdm::SD_INTENSITY, 0));
+
+    SlotDataCollection::SlotDataList rgb_slots;
+    rgb_slots.push_back(SlotData::PrimarySlot(ola::rdm::SD_COLOR_ADD_RED, 0));
+    rgb_slots.push_back(
+        SlotData::PrimarySlot(ola::rdm::SD_COLOR_ADD_GREEN, 0));
+    rgb_slots.push_back(SlotData::PrimarySlot(ola::rdm::SD_COLOR_ADD_BLUE, 0));
+
+    SlotDataCollection::SlotDataList rgbw_slots(rgb_slots);
+    rgbw_slots.push_back(
+        SlotData::PrimarySlot(ola::rdm::SD_COLOR_ADD_WHITE, 0));
+
+    PersonalityList personalities;
+    personalities.push_back(
+        Personality(1, "Dimmer", SlotDataCollection(dimmer_slots)));
+    personalities.push_back(
+        Personality(3, "RGB", SlotDataCollection(rgb_slots)));
+    personalities.push_back(
+        Personality(4, "RGBW", SlotDataCollection(rgbw_slots)));
+    instance = new Personalities(personalities);
+  }
+  return instance;
+}
+
+const ResponderOps<ResponderFarm::FarmResponder>::ParamHandler
+    ResponderFarm::FarmResponder::PARAM_HANDLERS[] = {
+  { ola::rdm::PID_DEVICE_INFO,
+    &FarmResponder::GetDeviceInfo,
+    NULL},
+  { ola::rdm::PID_DEVICE_MODEL_DESCRIPTION,
+    &FarmResponder::GetDeviceModelDescription,
+    NULL},
+  { ola::rdm::PID_MANUFACTURER_LABEL,
+    &FarmResponder::GetManufacturerLabel,
+    NULL},
+  { ola::rdm::PID_DEVICE_LABEL,
+    &FarmResponder::GetDeviceLabel,
+    &FarmResponder::SetDeviceLabel},
+  { ola::rdm::PID_FACTORY_DEFAULTS,
+    &FarmResponder::GetFactoryDefaults,
+    &FarmResponder::SetFactoryDefaults},
+  { ola::rdm::PID_SOFTWARE_VERSION_LABEL,
+    &FarmResponder::GetSoftwareVersionLabel,
+    NULL},
+  { ola::rdm::PID_DMX_PERSONALITY,
+    &FarmResponder::GetPersonality,
+    &FarmResponder::SetPersonality},
+  { ola::rdm::PID_DMX_PERSONALITY_DESCRIPTION,
+    &FarmResponder::GetPersonalityDescription,
+    NULL},
+  { ola::rdm::PID_SLOT_INFO,
+    &FarmResponder::GetSlotInfo,
+    NULL},
+  { ola::rdm::PID_SLOT_DESCRIPTION,
+    &FarmResponder::GetSlotDescription,
+    NULL},
+  { ola::rdm::PID_DEFAULT_SLOT_VALUE,
+    &FarmResponder::GetSlotDefaultValues,
+    NULL},
+  { ola::rdm::PID_DMX_START_ADDRESS,
+    &FarmResponder::GetDmxStartAddress,
+    &FarmResponder::SetDmxStartAddress},
+  { ola::rdm::PID_IDENTIFY_DEVICE,
+    &FarmResponder::GetIdentify,
+    &FarmResponder::SetIdentify},
+  { 0, NULL, NULL},
+};
+
+RDMResponse *ResponderFarm::FarmResponder::GetDeviceInfo(
+    const RDMRequest *request) {
+  return ResponderHelper::GetDeviceInfo(
+      request, ola::rdm::OLA_DUMMY_DEVICE_MODEL,
+      ola::rdm::PRODUCT_CATEGORY_OTHER, 1,
+      &m_personality_manager,
+      m_state->start_address,
+      0, 0);
+}
+
+RDMResponse *ResponderFarm::FarmResponder::GetFactoryDefaults(
+    const RDMRequest *request) {
+  if (request->ParamDataSize()) {
+    return NackWithReason(request, ola::rdm::NR_FORMAT_ERROR);
+  }
+
+  uint8_t using_defaults = (
+      m_state->start_address == 1 &&
+      m_state->personality == DEFAULT_PERSONALITY &&
+      !(m_state->flags & IDENTIFY_FLAG) &&
+      !STLContains(m_farm->m_labels, m_index));
+  return GetResponseFromData(request, &using_defaults, sizeof(using_defaults));
+}
+
+RDMResponse *ResponderFarm::FarmResponder::SetFactoryDefaults(
+    const RDMRequest *request) {
+  if (request->ParamDataSize()) {
+    return NackWithReason(request, ola::rdm::NR_FORMAT_ERROR);
+  }
+
+  m_state->start_address = 1;
+  m_personality_manager.SetActivePersonality(DEFAULT_PERSONALITY);
+  m_state->flags &= ~IDENTIFY_FLAG;
+  m_farm->m_labels.erase(m_index);
+  return ResponderHelper::EmptySetResponse(request);
+}
+
+RDMResponse *ResponderFarm::FarmResponder::GetDeviceModelDescription(
+    const RDMRequest *request) {
+  return ResponderHelper::GetString(request, "Dummy Farm Model");
+}
+
+RDMResponse *ResponderFarm::FarmResponder::GetManufacturerLabel(
+    const RDMRequest *request) {
+  return ResponderHelper::GetString(request, ola::rdm::OLA_MANUFACTURER_LABEL);
+}
+
+RDMResponse *ResponderFarm::FarmResponder::GetDeviceLabel(
+    const RDMRequest *request) {
+  const string *label = STLFind(&m_farm->m_labels, m_index);
+  return ResponderHelper::GetString(request, label ? *label : DEFAULT_LABEL);
+}
+
+RDMResponse *ResponderFarm::FarmResponder::SetDeviceLabel(
+    const RDMRequest *request) {
+  string label;
+  RDMResponse *response = ResponderHelper::SetString(request, &label);
+  if (response->ResponseType() == ola::rdm::RDM_ACK) {
+    if (label == DEFAULT_LABEL) {
+      m_farm->m_labels.erase(m_index);
+    } else {
+      STLReplace(&m_farm->m_labels, m_index, label);
+    }
+  }
+  return response;
+}
+
+RDMResponse *ResponderFarm::FarmResponder::GetSoftwareVersionLabel(
+    const RDMRequest *request) {
+  return ResponderHelper::GetString(request, "Dummy Farm Software Version");
+}
+
+RDMResponse *ResponderFarm::FarmResponder::GetPersonality(
+    const RDMRequest *request) {
+  return ResponderHelper::GetPersonality(request, &m_personality_manager);
+}
+
+RDMResponse *ResponderFarm::FarmResponder::SetPersonality(
+    const RDMRequest *request) {
+  return ResponderHelper::SetPersonality(request, &m_personality_manager,
+                                         m_state->start_address);
+}
+
+RDMResponse *ResponderFarm::FarmResponder::GetPersonalityDescription(
+    const RDMRequest *request) {
+  return ResponderHelper::GetPersonalityDescription(
+      request, &m_personality_manager);
+}
+
+RDMResponse *ResponderFarm::FarmResponder::GetSlotInfo(
+    const RDMRequest *request) {
+  return ResponderHelper::GetSlotInfo(request, &m_personality_manager);
+}
+
+RDMResponse *ResponderFarm::FarmResponder::GetSlotDescription(
+    const RDMRequest *request) {
+  return ResponderHelper::GetSlotDescription(request, &m_personality_manager);
+}
+
+RDMResponse *ResponderFarm::FarmResponder::GetSlotDefaultValues(
+    const RDMRequest *request) {
+  return ResponderHelper::GetSlotDefaultValues(request, &m_personality_manager);
+}
+
+RDMResponse *ResponderFarm::FarmResponder::GetDmxStartAddress(
+    const RDMRequest *request) {
+  return ResponderHelper::GetDmxAddress(request, &m_personality_manager,
+                                        m_state->start_address);
+}
+
+RDMResponse *ResponderFarm::FarmResponder::SetDmxStartAddress(
+    const RDMRequest *request) {
+  uint16_t start_address = m_state->start_address;
+  RDMResponse *response = ResponderHelper::SetDmxAddress(
+      request, &m_personality_manager, &start_address);
+  m_state->start_address = start_address;
+  return response;
+}
+
+RDMResponse *ResponderFarm::FarmResponder::GetIdentify(
+    const RDMRequest *request) {
+  return ResponderHelper::GetBoolValue(request,
+                                       m_state->flags & IDENTIFY_FLAG);
+}
+
+RDMResponse *ResponderFarm::FarmResponder::SetIdentify(
+    const RDMRequest *request) {
+  bool identify = m_state->flags & IDENTIFY_FLAG;
+  RDMResponse *response = ResponderHelper::SetBoolValue(request, &identify);
+  if (identify) {
+    m_state->flags |= IDENTIFY_FLAG;
+  } else {
+    m_state->flags &= ~IDENTIFY_FLAG;
+  }
+  return response;
+}
+
+
+ResponderFarm::ResponderFarm(ola::thread::SchedulerInterface *scheduler,
+                             const UID &first_uid,
+                             const Options &options)
+    : m_scheduler(scheduler),
+      m_first_uid(first_uid.ToUInt64()),
+      m_options(options),
+      m_shutting_down(false) {
+  uint64_t available = UID::AllDevices().ToUInt64() - m_first_uid;
+  uint32_t count = options.responder_count;
+  if (count > available) {
+    OLA_WARN << "Insufficient UIDs to create " << count
+             << " farm responders";
+    count = available;
+  }
+
+  ResponderState state;
+  state.start_address = 1;
+  state.personality = DEFAULT_PERSONALITY;
+  state.flags = 0;
+  m_responders.assign(count, state);
+  BuildUnmutedIndex();
+  OLA_INFO << "Created " << count << " farm responders starting at "
+           << first_uid;
+}
+
+ResponderFarm::~ResponderFarm() {
+  // RDM callbacks must always be run, so the pending replies are delivered
+  // now, as failures.
+  m_shutting_down = true;
+  while (!m_pending.empty()) {
+    PendingReply *pending = *m_pending.begin();
+    m_scheduler->RemoveTimeout(pending->timeout);
+    RunPending(pending);
+  }
+}
+
+bool ResponderFarm::Contains(const UID &uid) const {
+  uint32_t index;
+  return IndexOf(uid, &index);
+}
+
+void ResponderFarm::SendRDMRequest(RDMRequest *request_ptr,
+                                   RDMCallback *callback) {
+  auto_ptr<RDMRequest> request(request_ptr);
+
+  if (request->DestinationUID().IsBroadcast()) {
+    HandleBroadcast(request.release(), callback);
+    return;
+  }
+
+  uint32_t index;
+  if (!IndexOf(request->DestinationUID(), &index)) {
+    ola::rdm::RunRDMCallback(callback, ola::rdm::RDM_UNKNOWN_UID);
+    return;
+  }
+
+  if (Lost()) {
+    Schedule(NewSingleCallback(this, &ResponderFarm::DeliverReply, callback,
+                               new RDMReply(ola::rdm::RDM_TIMEOUT)));
+    return;
+  }
+
+  FarmResponder responder(this, index);
+  responder.SendRDMRequest(
+      UIDAt(index), request.release(),
+      NewSingleCallback(this, &ResponderFarm::ReplyComplete, callback));
+}
+
+void ResponderFarm::MuteDevice(const UID &target,
+                               MuteDeviceCallback *mute_complete) {
+  uint32_t index;
+  bool muted = IndexOf(target, &index) && !Lost();
+  if (muted) {
+    SetMuted(index, true);
+  }
+  Schedule(NewSingleCallback(this, &ResponderFarm::DeliverMute, mute_complete,
+                             muted));
+}
+
+void ResponderFarm::UnMuteAll(UnMuteDeviceCallback *unmute_complete) {
+  // Each responder may miss the broadcast.
+  ResponderStates::iterator iter = m_responders.begin();
+  for (; iter != m_responders.end(); ++iter) {
+    if (!Lost()) {
+      iter->flags &= ~MUTED_FLAG;
+    }
+  }
+  BuildUnmutedIndex();
+  Schedule(NewSingleCallback(this, &ResponderFarm::DeliverUnMute,
+                             unmute_complete));
+}
+
+void ResponderFarm::Branch(const UID &lower,
+                           const UID &upper,
+                           BranchCallback *callback) {
+  string data;
+  uint64_t start = std::max(lower.ToUInt64(), m_first_uid);
+  uint64_t end = std::min(upper.ToUInt64() + 1,
+                          m_first_uid + m_responders.size());
+
+  if (start < end) {
+    uint32_t before = CountUnmuted(start - m_first_uid);
+    uint32_t responding = CountUnmuted(end - m_first_uid) - before;
+
+    if (responding > 1 || (responding == 1 && !Lost())) {
+      uint8_t response[DUB_RESPONSE_SIZE];
+      memset(response, 0, sizeof(response));
+      AddDUBResponse(UIDAt(FindUnmuted(before + 1)), response);
+      if (responding > 1) {
+        // The responses collide, this is enough to corrupt the checksum.
+        AddDUBResponse(UIDAt(FindUnmuted(before + responding)), response);
+      }
+      data.assign(reinterpret_cast<char*>(response), sizeof(response));
+    }
+  }
+  Schedule(NewSingleCallback(this, &ResponderFarm::DeliverBranch, callback,
+                             data));
+}
+
+bool ResponderFarm::IndexOf(const UID &uid, uint32_t *index) const {
+  uint64_t value = uid.ToUInt64();
+  if (value < m_first_uid || value - m_first_uid >= m_responders.size()) {
+    return false;
+  }
+  *index = value - m_first_uid;
+  return true;
+}
+
+UID ResponderFarm::UIDAt(uint32_t index) const {
+  return UID(m_first_uid + index);
+}
+
+void ResponderFarm::SetMuted(uint32_t index, bool muted) {
+  ResponderState *state = &m_responders[index];
+  if (static_cast<bool>(state->flags & MUTED_FLAG) == muted) {
+    return;
+  }
+
+  if (muted) {
+    state->flags |= MUTED_FLAG;
+  } else {
+    state->flags &= ~MUTED_FLAG;
+  }
+
+  for (uint32_t i = index + 1; i < m_unmuted.size(); i += i & -i) {
+    if (muted) {
+      m_unmuted[i]--;
+    } else {
+      m_unmuted[i]++;
+    }
+  }
+}
+
+/*
+ * Return the number of unmuted responders with an index less than end.
+ */
+uint32_t ResponderFarm::CountUnmuted(uint32_t end) const {
+  uint32_t count = 0;
+  for (uint32_t i = end; i > 0; i -= i & -i) {
+    count += m_unmuted[i];
+  }
+  return count;
+}
+
+/*
+ * Return the index of the count'th unmuted responder, count starts from 1.
+ */
+uint32_t ResponderFarm::FindUnmuted(uint32_t count) const {
+  uint32_t size = m_responders.size();
+  uint32_t step = 1;
+  while (step <= size / 2) {
+    step <<= 1;
+  }
+
+  uint32_t index = 0;
+  for (; step; step >>= 1) {
+    if (index + step <= size && m_unmuted[index + step] < count) {
+      index += step;
+      count -= m_unmuted[index];
+    }
+  }
+  return index;
+}
+
+void ResponderFarm::BuildUnmutedIndex() {
+  uint32_t size = m_responders.size();
+  m_unmuted.assign(size + 1, 0);
+  for (uint32_t i = 1; i <= size; i++) {
+    if (!(m_responders[i - 1].flags & MUTED_FLAG)) {
+      m_unmuted[i]++;
+    }
+    uint32_t parent = i + (i & -i);
+    if (parent <= size) {
+      m_unmuted[parent] += m_unmuted[i];
+    }
+  }
+}
+
+bool ResponderFarm::Lost() const {
+  return m_options.loss && ola::math::Random(0, 99) < m_options.loss;
+}
+
+void ResponderFarm::HandleBroadcast(RDMRequest *request,
+                                    RDMCallback *callback) {
+  if (m_responders.empty() ||
+      !request->DestinationUID().DirectedToUID(UIDAt(0))) {
+    delete request;
+    Schedule(NewSingleCallback(this, &ResponderFarm::DeliverReply, callback,
+                               new RDMReply(ola::rdm::RDM_WAS_BROADCAST)));
+    return;
+  }
+  BroadcastChunk(request, callback, 0);
+}
+
+/*
+ * Apply a broadcast to the responders from start, and schedule the next
+ * chunk. Once all responders have been updated the reply is delivered.
+ */
+void ResponderFarm::BroadcastChunk(RDMRequest *request_ptr,
+                                   RDMCallback *callback,
+                                   uint32_t start) {
+  auto_ptr<RDMRequest> request(request_ptr);
+  if (m_shutting_down) {
+    ola::rdm::RunRDMCallback(callback, ola::rdm::RDM_FAILED_TO_SEND);
+    return;
+  }
+
+  uint32_t end = start + BROADCAST_CHUNK_SIZE;
+  if (end > m_responders.size()) {
+    end = m_responders.size();
+  }
+  auto_ptr<RDMCallback> ignore(NewCallback(&IgnoreReply));
+  for (uint32_t i = start; i < end; i++) {
+    if (!Lost()) {
+      FarmResponder responder(this, i);
+      responder.SendRDMRequest(UIDAt(i), request->Duplicate(), ignore.get());
+    }
+  }
+
+  if (end < m_responders.size()) {
+    ScheduleAfter(0, NewSingleCallback(this, &ResponderFarm::BroadcastChunk,
+                                       request.release(), callback, end));
+  } else {
+    Schedule(NewSingleCallback(this, &ResponderFarm::DeliverReply, callback,
+                               new RDMReply(ola::rdm::RDM_WAS_BROADCAST)));
+  }
+}
+
+void ResponderFarm::ReplyComplete(RDMCallback *callback, RDMReply *reply) {
+  const RDMResponse *response = reply->Response();
+  Schedule(NewSingleCallback(
+      this, &ResponderFarm::DeliverReply, callback,
+      new RDMReply(reply->StatusCode(),
+                   response ? response->Duplicate() : NULL)));
+}
+
+void ResponderFarm::DeliverReply(RDMCallback *callback, RDMReply *reply) {
+  auto_ptr<RDMReply> reply_ptr(reply);
+  if (m_shutting_down) {
+    ola::rdm::RunRDMCallback(callback, ola::rdm::RDM_FAILED_TO_SEND);
+  } else {
+    callback->Run(reply);
+  }
+}
+
+void ResponderFarm::DeliverMute(MuteDeviceCallback *callback, bool muted) {
+  callback->Run(muted && !m_shutting_down);
+}
+
+void ResponderFarm::DeliverUnMute(UnMuteDeviceCallback *callback) {
+  callback->Run();
+}
+
+void ResponderFarm::DeliverBranch(BranchCallback *callback, string data) {
+  if (data.empty() || m_shutting_down) {
+    callback->Run(NULL, 0);
+  } else {
+    callback->Run(reinterpret_cast<const uint8_t*>(data.data()), data.size());
+  }
+}
+
+void ResponderFarm::Schedule(ola::BaseCallback0<void> *closure) {
+  ScheduleAfter(m_options.latency, closure);
+}
+
+void ResponderFarm::ScheduleAfter(unsigned int delay,
+                                  ola::BaseCallback0<void> *closure) {
+  if (m_shutting_down) {
+    // A callback run from the destructor made another request.
+    closure->Run();
+    return;
+  }
+
+  PendingReply *pending = new PendingReply;
+  pending->closure = closure;
+  pending->timeout = m_scheduler->RegisterSingleTimeout(
+      delay,
+      NewSingleCallback(this, &ResponderFarm::RunPending, pending));
+  m_pending.insert(pending);
+}
+
+void ResponderFarm::RunPending(PendingReply *pending) {
+  m_pending.erase(pending);
+  ola::BaseCallback0<void> *closure = pending->closure;
+  delete pending;
+  closure->Run();
+}
+
+/*
+ * OR the DUB response for a UID into data, which must be DUB_RESPONSE_SIZE
+ * bytes.
+ */
+void ResponderFarm::AddDUBResponse(const UID &uid, uint8_t *data) {
+  uint8_t euid[UID::LENGTH];
+  uid.Pack(euid, sizeof(euid));
+
+  for (unsigned int i = 0; i < 7; i++) {
+    data[i] |= 0xfe;
+  }
+  data[7] |= 0xaa;
+
+  uint16_t checksum = 0;
+  for (unsigned int i = 0; i < UID::LENGTH; i++) {
+    data[8 + 2 * i] |= euid[i] | 0xaa;
+    data[9 + 2 * i] |= euid[i] | 0x55;
+    checksum += (euid[i] | 0xaa) + (euid[i] | 0x55);
+  }
+
+  data[20] |= (checksum >> 8) | 0xaa;
+  data[21] |= (checksum >> 8) | 0x55;
+  data[22] |= checksum | 0xaa;
+  data[23] |= checksum | 0x55;
+}
+}  // namespace dummy
+}  // namespace plugin
+}  // namespace ola
@@ -0,0 +1,185 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * ResponderFarm.h
+ * A large number of simulated RDM responders, for load testing.
+ * Copyright (C) 2026 agent
+ */
+
+#ifndef PLUGINS_DUMMY_RESPONDERFARM_H_
+#define PLUGINS_DUMMY_RESPONDERFARM_H_
+
+#include <stdint.h>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include "ola/Callback.h"
+#include "ola/base/Macro.h"
+#include "ola/rdm/DiscoveryAgent.h"
+#include "ola/rdm/RDMControllerInterface.h"
+#include "ola/rdm/UID.h"
+#include "ola/thread/SchedulerInterface.h"
+
+namespace ola {
+namespace plugin {
+namespace dummy {
+
+/**
+ * @brief Simulates up to millions of RDM responders on a single port.
+ *
+ * Unlike the responders in ola/rdm, the farm doesn't create an object per
+ * responder. The personalities and the PID handlers are shared and each
+ * responder only has a few bytes of mutable state. The UIDs are allocated
+ * sequentially from the first UID, so the state for a UID is found by
+ * index.
+ *
+ * The farm implements DiscoveryTargetInterface so it can be driven by a
+ * DiscoveryAgent. When more than one unmuted responder is within the range
+ * of a DUB, the responses are OR'ed together, as they would be on the line.
+ *
+ * Every reply is delivered from the scheduler after the configured latency,
+ * and a configurable percentage of them are dropped. Broadcasts are applied
+ * to BROADCAST_CHUNK_SIZE responders at a time, so a large farm doesn't
+ * block the scheduler. The reply to a broadcast is delivered once every
+ * responder has handled it.
+ *
+ * When the farm is deleted, any replies that are still pending are run with
+ * a failure.
+ */
+class ResponderFarm: public ola::rdm::DiscoveryTargetInterface {
+ public:
+  struct Options {
+   public:
+    Options()
+        : responder_count(0),
+          latency(0),
+          loss(0) {
+    }
+
+    uint32_t responder_count;
+    unsigned int latency;  // in ms
+    uint8_t loss;  // as a percentage
+  };
+
+  /**
+   * @brief Create a new ResponderFarm.
+   * @param scheduler the scheduler used to deliver the replies.
+   * @param first_uid the UID of the first responder.
+   * @param options the number of responders, latency and loss.
+   */
+  ResponderFarm(ola::thread::SchedulerInterface *scheduler,
+                const ola::rdm::UID &first_uid,
+                const Options &options);
+  ~ResponderFarm();
+
+  /**
+   * @brief The number of responders in the farm.
+   */
+  unsigned int Size() const { return m_responders.size(); }
+
+  /**
+   * @brief Check if a UID belongs to a responder in the farm.
+   */
+  bool Contains(const ola::rdm::UID &uid) const;
+
+  /**
+   * @brief Handle a RDM request.
+   *
+   * The request must either be broadcast or for a UID in the farm.
+   */
+  void SendRDMRequest(ola::rdm::RDMRequest *request,
+                      ola::rdm::RDMCallback *callback);
+
+  // DiscoveryTargetInterface methods
+  void MuteDevice(const ola::rdm::UID &target,
+                  MuteDeviceCallback *mute_complete);
+  void UnMuteAll(UnMuteDeviceCallback *unmute_complete);
+  void Branch(const ola::rdm::UID &lower,
+              const ola::rdm::UID &upper,
+              BranchCallback *callback);
+
+ private:
+  class FarmResponder;
+
+  /**
+   * @brief The mutable state for each responder.
+   */
+  struct ResponderState {
+    uint16_t start_address;
+    uint8_t personality;
+    uint8_t flags;
+  };
+
+  /**
+   * @brief A reply waiting to be delivered.
+   */
+  struct PendingReply {
+    ola::thread::timeout_id timeout;
+    ola::BaseCallback0<void> *closure;
+  };
+
+  typedef std::vector<ResponderState> ResponderStates;
+
+  ola::thread::SchedulerInterface *m_scheduler;
+  const uint64_t m_first_uid;
+  const Options m_options;
+  ResponderStates m_responders;
+  // A Fenwick tree counting the unmuted responders, so that DUB handling is
+  // O(log n) rather than O(n).
+  std::vector<uint32_t> m_unmuted;
+  // Labels are rarely set, so they're kept out of ResponderState.
+  std::map<uint32_t, std::string> m_labels;
+  std::set<PendingReply*> m_pending;
+  bool m_shutting_down;
+
+  bool IndexOf(const ola::rdm::UID &uid, uint32_t *index) const;
+  ola::rdm::UID UIDAt(uint32_t index) const;
+  void SetMuted(uint32_t index, bool muted);
+  uint32_t CountUnmuted(uint32_t end) const;
+  uint32_t FindUnmuted(uint32_t count) const;
+  void BuildUnmutedIndex();
+  bool Lost() const;
+
+  void HandleBroadcast(ola::rdm::RDMRequest *request,
+                       ola::rdm::RDMCallback *callback);
+  void BroadcastChunk(ola::rdm::RDMRequest *request,
+                      ola::rdm::RDMCallback *callback,
+                      uint32_t start);
+  void ReplyComplete(ola::rdm::RDMCallback *callback,
+                     ola::rdm::RDMReply *reply);
+  void DeliverReply(ola::rdm::RDMCallback *callback,
+                    ola::rdm::RDMReply *reply);
+  void DeliverMute(MuteDeviceCallback *callback, bool muted);
+  void DeliverUnMute(UnMuteDeviceCallback *callback);
+  void DeliverBranch(BranchCallback *callback, std::string data);
+  void Schedule(ola::BaseCallback0<void> *closure);
+  void ScheduleAfter(unsigned int delay, ola::BaseCallback0<void> *closure);
+  void RunPending(PendingReply *pending);
+
+  static void AddDUBResponse(const ola::rdm::UID &uid, uint8_t *data);
+
+  static const uint8_t IDENTIFY_FLAG = 0x01;
+  static const uint8_t MUTED_FLAG = 0x02;
+  static const uint8_t DEFAULT_PERSONALITY = 2;
+  static const unsigned int DUB_RESPONSE_SIZE = 24;
+  static const uint32_t BROADCAST_CHUNK_SIZE = 1000;
+
+  DISALLOW_COPY_AND_ASSIGN(ResponderFarm);
+};
+}  // namespace dummy
+}  // namespace plugin
+}  // namespace ola
+#endif  // PLUGINS_DUMMY_RESPONDERFARM_H_
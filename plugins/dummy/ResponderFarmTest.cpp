@@ -0,0 +1,455 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * ResponderFarmTest.cpp
+ * Test class for the responder farm.
+ * Copyright (C) 2026 agent
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <memory>
+#include <string>
+
+#include "ola/Callback.h"
+#include "ola/Logging.h"
+#include "ola/io/SelectServer.h"
+#include "ola/network/NetworkUtils.h"
+#include "ola/rdm/DiscoveryAgent.h"
+#include "ola/rdm/RDMCommand.h"
+#include "ola/rdm/RDMEnums.h"
+#include "ola/rdm/RDMReply.h"
+#include "ola/rdm/UID.h"
+#include "ola/rdm/UIDSet.h"
+#include "ola/testing/TestUtils.h"
+#include "plugins/dummy/DummyPort.h"
+#include "plugins/dummy/ResponderFarm.h"
+
+namespace ola {
+namespace plugin {
+namespace dummy {
+
+using ola::network::HostToNetwork;
+using ola::network::NetworkToHost;
+using ola::rdm::DiscoveryAgent;
+using ola::rdm::RDMGetRequest;
+using ola::rdm::RDMReply;
+using ola::rdm::RDMRequest;
+using ola::rdm::RDMSetRequest;
+using ola::rdm::UID;
+using ola::rdm::UIDSet;
+using std::auto_ptr;
+using std::string;
+
+class ResponderFarmTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(ResponderFarmTest);
+  CPPUNIT_TEST(testBranch);
+  CPPUNIT_TEST(testDiscovery);
+  CPPUNIT_TEST(testRDM);
+  CPPUNIT_TEST(testBroadcast);
+  CPPUNIT_TEST(testLoss);
+  CPPUNIT_TEST(testShutdown);
+  CPPUNIT_TEST(testDummyPort);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  ResponderFarmTest()
+      : TestFixture(),
+        m_first_uid(0x7ff0, 0),
+        m_source(1, 2) {
+  }
+
+  void setUp();
+
+  void testBranch();
+  void testDiscovery();
+  void testRDM();
+  void testBroadcast();
+  void testLoss();
+  void testShutdown();
+  void testDummyPort();
+
+ private:
+  ola::io::SelectServer m_ss;
+  UID m_first_uid;
+  UID m_source;
+  bool m_done;
+  bool m_ok;
+  UIDSet m_uids;
+  string m_data;
+  ola::rdm::RDMStatusCode m_status;
+
+  void Wait();
+  void DiscoveryComplete(bool ok, const UIDSet &uids);
+  void PortDiscoveryComplete(const UIDSet &uids);
+  void BranchComplete(const uint8_t *data, unsigned int length);
+  void MuteComplete(bool ok);
+  void RDMComplete(RDMReply *reply);
+  void Branch(ResponderFarm *farm, const UID &lower, const UID &upper);
+  bool Mute(ResponderFarm *farm, const UID &uid);
+  ola::rdm::RDMStatusCode SendRequest(ResponderFarm *farm,
+                                      RDMRequest *request);
+  uint16_t GetStartAddress(ResponderFarm *farm, const UID &uid);
+  ola::rdm::RDMStatusCode SetStartAddress(ResponderFarm *farm,
+                                          const UID &uid,
+                                          uint16_t start_address);
+  UID DecodeDUB() const;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(ResponderFarmTest);
+
+
+void ResponderFarmTest::setUp() {
+  ola::InitLogging(ola::OLA_LOG_WARN, ola::OLA_LOG_STDERR);
+  m_done = false;
+  m_ok = false;
+  m_uids.Clear();
+  m_data.clear();
+  m_status = ola::rdm::RDM_FAILED_TO_SEND;
+}
+
+/*
+ * Run the SelectServer until the current operation completes.
+ */
+void ResponderFarmTest::Wait() {
+  m_done = false;
+  ola::thread::timeout_id timeout = m_ss.RegisterSingleTimeout(
+      10000, NewSingleCallback(&m_ss, &ola::io::SelectServer::Terminate));
+  m_ss.Run();
+  m_ss.RemoveTimeout(timeout);
+  OLA_ASSERT_TRUE(m_done);
+}
+
+void ResponderFarmTest::DiscoveryComplete(bool ok, const UIDSet &uids) {
+  m_ok = ok;
+  m_uids = uids;
+  m_done = true;
+  m_ss.Terminate();
+}
+
+void ResponderFarmTest::PortDiscoveryComplete(const UIDSet &uids) {
+  DiscoveryComplete(true, uids);
+}
+
+void ResponderFarmTest::BranchComplete(const uint8_t *data,
+                                       unsigned int length) {
+  m_data.assign(reinterpret_cast<const char*>(data), length);
+  m_done = true;
+  m_ss.Terminate();
+}
+
+void ResponderFarmTest::MuteComplete(bool ok) {
+  m_ok = ok;
+  m_done = true;
+  m_ss.Terminate();
+}
+
+void ResponderFarmTest::RDMComplete(RDMReply *reply) {
+  m_status = reply->StatusCode();
+  m_data.clear();
+  if (reply->Response()) {
+    m_data.assign(
+        reinterpret_cast<const char*>(reply->Response()->ParamData()),
+        reply->Response()->ParamDataSize());
+  }
+  m_done = true;
+  m_ss.Terminate();
+}
+
+void ResponderFarmTest::Branch(ResponderFarm *farm, const UID &lower,
+                               const UID &upper) {
+  auto_ptr<ola::rdm::DiscoveryTargetInterface::BranchCallback> callback(
+      NewCallback(this, &ResponderFarmTest::BranchComplete));
+  farm->Branch(lower, upper, callback.get());
+  Wait();
+}
+
+bool ResponderFarmTest::Mute(ResponderFarm *farm, const UID &uid) {
+  auto_ptr<ola::rdm::DiscoveryTargetInterface::MuteDeviceCallback> callback(
+      NewCallback(this, &ResponderFarmTest::MuteComplete));
+  farm->MuteDevice(uid, callback.get());
+  Wait();
+  return m_ok;
+}
+
+ola::rdm::RDMStatusCode ResponderFarmTest::SendRequest(
+    ResponderFarm *farm,
+    RDMRequest *request) {
+  farm->SendRDMRequest(
+      request, NewSingleCallback(this, &ResponderFarmTest::RDMComplete));
+  Wait();
+  return m_status;
+}
+
+uint16_t ResponderFarmTest::GetStartAddress(ResponderFarm *farm,
+                                            const UID &uid) {
+  RDMRequest *request = new RDMGetRequest(
+      m_source, uid, 0, 1, 0, ola::rdm::PID_DMX_START_ADDRESS, NULL, 0);
+  OLA_ASSERT_EQ(ola::rdm::RDM_COMPLETED_OK, SendRequest(farm, request));
+  OLA_ASSERT_EQ(sizeof(uint16_t), m_data.size());
+  uint16_t start_address;
+  memcpy(&start_address, m_data.data(), sizeof(start_address));
+  return NetworkToHost(start_address);
+}
+
+ola::rdm::RDMStatusCode ResponderFarmTest::SetStartAddress(
+    ResponderFarm *farm,
+    const UID &uid,
+    uint16_t start_address) {
+  start_address = HostToNetwork(start_address);
+  RDMRequest *request = new RDMSetRequest(
+      m_source, uid, 0, 1, 0, ola::rdm::PID_DMX_START_ADDRESS,
+      reinterpret_cast<const uint8_t*>(&start_address),
+      sizeof(start_address));
+  return SendRequest(farm, request);
+}
+
+/*
+ * Decode the UID from a DUB response, this doesn't check the checksum.
+ */
+UID ResponderFarmTest::DecodeDUB() const {
+  OLA_ASSERT_EQ(static_cast<size_t>(24), m_data.size());
+  uint8_t euid[UID::LENGTH];
+  for (unsigned int i = 0; i < UID::LENGTH; i++) {
+    euid[i] = m_data[8 + 2 * i] & m_data[9 + 2 * i];
+  }
+  return UID(euid);
+}
+
+
+/*
+ * Check the responses to DUB commands.
+ */
+void ResponderFarmTest::testBranch() {
+  ResponderFarm::Options options;
+  options.responder_count = 4;
+  ResponderFarm farm(&m_ss, m_first_uid, options);
+  OLA_ASSERT_EQ(4u, farm.Size());
+
+  UID uid1(0x7ff0, 1);
+  UID uid2(0x7ff0, 2);
+  UID uid3(0x7ff0, 3);
+
+  // No responders in this range
+  Branch(&farm, UID(0x7a70, 0), UID(0x7a70, 0xffffffff));
+  OLA_ASSERT_TRUE(m_data.empty());
+
+  // A single responder
+  Branch(&farm, uid1, uid1);
+  OLA_ASSERT_EQ(uid1, DecodeDUB());
+
+  // Two responders collide, the responses are OR'ed together.
+  Branch(&farm, uid1, uid2);
+  OLA_ASSERT_EQ(UID(0x7ff0, 3), DecodeDUB());
+
+  // Once muted, responders stop responding
+  OLA_ASSERT_TRUE(Mute(&farm, uid1));
+  Branch(&farm, uid1, uid2);
+  OLA_ASSERT_EQ(uid2, DecodeDUB());
+
+  OLA_ASSERT_TRUE(Mute(&farm, uid2));
+  Branch(&farm, m_first_uid, UID::AllDevices());
+  OLA_ASSERT_FALSE(m_data.empty());
+  OLA_ASSERT_TRUE(Mute(&farm, m_first_uid));
+  Branch(&farm, m_first_uid, UID::AllDevices());
+  OLA_ASSERT_EQ(uid3, DecodeDUB());
+  OLA_ASSERT_TRUE(Mute(&farm, uid3));
+  Branch(&farm, m_first_uid, UID::AllDevices());
+  OLA_ASSERT_TRUE(m_data.empty());
+
+  // Unknown UIDs can't be muted
+  OLA_ASSERT_FALSE(Mute(&farm, UID(0x7ff0, 4)));
+}
+
+
+/*
+ * Check a DiscoveryAgent finds all the responders.
+ */
+void ResponderFarmTest::testDiscovery() {
+  ResponderFarm::Options options;
+  options.responder_count = 5000;
+  ResponderFarm farm(&m_ss, m_first_uid, options);
+  DiscoveryAgent agent(&farm);
+
+  agent.StartFullDiscovery(
+      NewSingleCallback(this, &ResponderFarmTest::DiscoveryComplete));
+  Wait();
+  OLA_ASSERT_TRUE(m_ok);
+  OLA_ASSERT_EQ(5000u, m_uids.Size());
+  OLA_ASSERT_TRUE(m_uids.Contains(m_first_uid));
+  OLA_ASSERT_TRUE(m_uids.Contains(UID(0x7ff0, 4999)));
+
+  agent.StartIncrementalDiscovery(
+      NewSingleCallback(this, &ResponderFarmTest::DiscoveryComplete));
+  Wait();
+  OLA_ASSERT_TRUE(m_ok);
+  OLA_ASSERT_EQ(5000u, m_uids.Size());
+}
+
+
+/*
+ * Check that each responder has its own state.
+ */
+void ResponderFarmTest::testRDM() {
+  ResponderFarm::Options options;
+  options.responder_count = 100;
+  ResponderFarm farm(&m_ss, m_first_uid, options);
+
+  UID uid(0x7ff0, 7);
+  UID other_uid(0x7ff0, 8);
+  OLA_ASSERT_EQ(static_cast<uint16_t>(1), GetStartAddress(&farm, uid));
+  OLA_ASSERT_EQ(ola::rdm::RDM_COMPLETED_OK,
+                SetStartAddress(&farm, uid, 100));
+  OLA_ASSERT_EQ(static_cast<uint16_t>(100), GetStartAddress(&farm, uid));
+  OLA_ASSERT_EQ(static_cast<uint16_t>(1), GetStartAddress(&farm, other_uid));
+
+  // Labels
+  const string label = "Farm Label";
+  OLA_ASSERT_EQ(
+      ola::rdm::RDM_COMPLETED_OK,
+      SendRequest(&farm, new RDMSetRequest(
+          m_source, uid, 0, 1, 0, ola::rdm::PID_DEVICE_LABEL,
+          reinterpret_cast<const uint8_t*>(label.data()), label.size())));
+  SendRequest(&farm, new RDMGetRequest(
+      m_source, uid, 0, 1, 0, ola::rdm::PID_DEVICE_LABEL, NULL, 0));
+  OLA_ASSERT_EQ(label, m_data);
+  SendRequest(&farm, new RDMGetRequest(
+      m_source, other_uid, 0, 1, 0, ola::rdm::PID_DEVICE_LABEL, NULL, 0));
+  OLA_ASSERT_EQ(string("Dummy Farm Responder"), m_data);
+
+  // Factory defaults reset the state
+  OLA_ASSERT_EQ(
+      ola::rdm::RDM_COMPLETED_OK,
+      SendRequest(&farm, new RDMSetRequest(
+          m_source, uid, 0, 1, 0, ola::rdm::PID_FACTORY_DEFAULTS, NULL, 0)));
+  OLA_ASSERT_EQ(static_cast<uint16_t>(1), GetStartAddress(&farm, uid));
+  SendRequest(&farm, new RDMGetRequest(
+      m_source, uid, 0, 1, 0, ola::rdm::PID_DEVICE_LABEL, NULL, 0));
+  OLA_ASSERT_EQ(string("Dummy Farm Responder"), m_data);
+
+  // Unknown UIDs
+  farm.SendRDMRequest(
+      new RDMGetRequest(m_source, UID(0x7ff0, 100), 0, 1, 0,
+                        ola::rdm::PID_DEVICE_INFO, NULL, 0),
+      NewSingleCallback(this, &ResponderFarmTest::RDMComplete));
+  OLA_ASSERT_EQ(ola::rdm::RDM_UNKNOWN_UID, m_status);
+}
+
+
+/*
+ * Check broadcast SETs reach every responder.
+ */
+void ResponderFarmTest::testBroadcast() {
+  // Enough responders that the broadcast is applied in several chunks.
+  ResponderFarm::Options options;
+  options.responder_count = 2500;
+  ResponderFarm farm(&m_ss, m_first_uid, options);
+
+  OLA_ASSERT_EQ(ola::rdm::RDM_WAS_BROADCAST,
+                SetStartAddress(&farm, UID::AllDevices(), 10));
+  OLA_ASSERT_EQ(static_cast<uint16_t>(10),
+                GetStartAddress(&farm, m_first_uid));
+  OLA_ASSERT_EQ(static_cast<uint16_t>(10),
+                GetStartAddress(&farm, UID(0x7ff0, 2499)));
+
+  // Vendorcast to another manufacturer
+  OLA_ASSERT_EQ(ola::rdm::RDM_WAS_BROADCAST,
+                SetStartAddress(&farm, UID::VendorcastAddress(0x7a70), 20));
+  OLA_ASSERT_EQ(static_cast<uint16_t>(10),
+                GetStartAddress(&farm, m_first_uid));
+}
+
+
+/*
+ * Check that lost responses are reported as timeouts.
+ */
+void ResponderFarmTest::testLoss() {
+  ResponderFarm::Options options;
+  options.responder_count = 10;
+  options.loss = 100;
+  options.latency = 5;
+  ResponderFarm farm(&m_ss, m_first_uid, options);
+
+  OLA_ASSERT_EQ(
+      ola::rdm::RDM_TIMEOUT,
+      SendRequest(&farm, new RDMGetRequest(
+          m_source, m_first_uid, 0, 1, 0, ola::rdm::PID_DEVICE_INFO,
+          NULL, 0)));
+  OLA_ASSERT_FALSE(Mute(&farm, m_first_uid));
+
+  Branch(&farm, m_first_uid, m_first_uid);
+  OLA_ASSERT_TRUE(m_data.empty());
+
+  // Collisions are still seen.
+  Branch(&farm, m_first_uid, UID::AllDevices());
+  OLA_ASSERT_FALSE(m_data.empty());
+}
+
+
+/*
+ * Check that pending replies are run with a failure when the farm is deleted.
+ */
+void ResponderFarmTest::testShutdown() {
+  ResponderFarm::Options options;
+  options.responder_count = 10;
+  options.latency = 10000;
+  m_ok = true;
+  auto_ptr<ola::rdm::DiscoveryTargetInterface::MuteDeviceCallback>
+      mute_callback(NewCallback(this, &ResponderFarmTest::MuteComplete));
+
+  {
+    ResponderFarm farm(&m_ss, m_first_uid, options);
+    farm.SendRDMRequest(
+        new RDMGetRequest(m_source, m_first_uid, 0, 1, 0,
+                          ola::rdm::PID_DEVICE_INFO, NULL, 0),
+        NewSingleCallback(this, &ResponderFarmTest::RDMComplete));
+    farm.MuteDevice(m_first_uid, mute_callback.get());
+    OLA_ASSERT_FALSE(m_done);
+  }
+
+  OLA_ASSERT_TRUE(m_done);
+  OLA_ASSERT_EQ(ola::rdm::RDM_FAILED_TO_SEND, m_status);
+  OLA_ASSERT_FALSE(m_ok);
+}
+
+
+/*
+ * Check the DummyPort reports the farm responders.
+ */
+void ResponderFarmTest::testDummyPort() {
+  DummyPort::Options options;
+  options.number_of_farm_responders = 500;
+  DummyPort port(NULL, options, 0, &m_ss);
+
+  port.RunFullDiscovery(
+      NewSingleCallback(this, &ResponderFarmTest::PortDiscoveryComplete));
+  Wait();
+  // The farm, plus the default responders
+  OLA_ASSERT_EQ(500u + 6u, m_uids.Size());
+  OLA_ASSERT_TRUE(m_uids.Contains(UID(0x7ff0, 499)));
+  OLA_ASSERT_TRUE(m_uids.Contains(UID(0x7a70, 0xffffff00)));
+
+  port.SendRDMRequest(
+      new RDMGetRequest(m_source, UID(0x7ff0, 42), 0, 1, 0,
+                        ola::rdm::PID_DEVICE_INFO, NULL, 0),
+      NewSingleCallback(this, &ResponderFarmTest::RDMComplete));
+  Wait();
+  OLA_ASSERT_EQ(ola::rdm::RDM_COMPLETED_OK, m_status);
+}
+}  // namespace dummy
+}  // namespace plugin
+}  // namespace ola
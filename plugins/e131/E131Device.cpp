@@ -115,11 +115,24 @@ void E131Device::PrePortStop() {
  * Stop this device
  */
 void E131Device::PostPortStop() {
+  m_input_ports.clear();
+  m_output_ports.clear();
   m_node->Stop();
   m_node.reset();
 }
 
 
+/*
+ * Send the data queued on each output port.
+ */
+void E131Device::CommitFrame() {
+  vector<E131OutputPort*>::iterator iter = m_output_ports.begin();
+  for (; iter != m_output_ports.end(); ++iter) {
+    (*iter)->Flush();
+  }
+}
+
+
 /*
  * Handle device config messages
  * @param controller An RpcController
@@ -58,6 +58,10 @@ class E131Device: public ola::Device {
 
   std::string DeviceId() const { return "1"; }
 
+  // The output ports queue their data until the frame is committed.
+  bool SupportsFrameCommit() const { return true; }
+  void CommitFrame();
+
   void Configure(ola::rpc::RpcController *controller,
                  const std::string &request,
                  std::string *response,
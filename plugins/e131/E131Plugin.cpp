@@ -96,6 +96,8 @@ bool E131Plugin::StartHook() {
     OLA_WARN << "Invalid value for output_ports";
   }
 
+  options.interface_monitor = m_plugin_adaptor->GetInterfaceMonitor();
+
   m_device = new E131Device(this, cid, ip_addr, m_plugin_adaptor, options);
 
   if (!m_device->Start()) {
@@ -42,6 +42,7 @@ class E131Plugin: public ola::Plugin {
     ola_plugin_id Id() const { return OLA_PLUGIN_E131; }
     std::string Description() const;
     std::string PluginPrefix() const { return PLUGIN_PREFIX; }
+    bool SupportsConcurrentStart() const { return true; }
 
  private:
     bool StartHook();
@@ -80,6 +80,7 @@ E131OutputPort::~E131OutputPort() {
  */
 void E131OutputPort::PostSetUniverse(Universe *old_universe,
                                      Universe *new_universe) {
+  m_pending = false;
   if (old_universe) {
     m_node->TerminateStream(old_universe->UniverseId(), m_last_priority);
   }
@@ -90,16 +91,30 @@ void E131OutputPort::PostSetUniverse(Universe *old_universe,
 
 
 /*
- * Write data to this port.
+ * Queue data for this port, it's sent by Flush().
  */
 bool E131OutputPort::WriteDMX(const DmxBuffer &buffer, uint8_t priority) {
-  Universe *universe = GetUniverse();
-  if (!universe)
+  if (!GetUniverse())
     return false;
 
   m_last_priority = (GetPriorityMode() == PRIORITY_MODE_STATIC) ?
       GetPriority() : priority;
-  return m_node->SendDMX(universe->UniverseId(), buffer, m_last_priority,
+  m_buffer.Set(buffer);
+  m_pending = true;
+  return true;
+}
+
+
+/*
+ * Send the queued data for this port.
+ */
+bool E131OutputPort::Flush() {
+  Universe *universe = GetUniverse();
+  if (!m_pending || !universe)
+    return true;
+
+  m_pending = false;
+  return m_node->SendDMX(universe->UniverseId(), m_buffer, m_last_priority,
                          m_preview_on);
 }
 }  // namespace e131
@@ -73,6 +73,7 @@ class E131OutputPort: public BasicOutputPort {
   E131OutputPort(E131Device *parent, int id, ola::acn::E131Node *node)
       : BasicOutputPort(parent, id),
         m_preview_on(false),
+        m_pending(false),
         m_node(node) {
     m_last_priority = GetPriority();
   }
@@ -89,12 +90,22 @@ class E131OutputPort: public BasicOutputPort {
 
   bool WriteDMX(const ola::DmxBuffer &buffer, uint8_t priority);
 
+  /**
+   * @brief Send the data queued by WriteDMX().
+   * @returns false if the data couldn't be sent.
+   *
+   * This is called from E131Device::CommitFrame(), so that all the universes
+   * updated in one iteration of the event loop are sent together.
+   */
+  bool Flush();
+
   void SetPreviewMode(bool preview_mode) { m_preview_on = preview_mode; }
   bool PreviewMode() const { return m_preview_on; }
   bool SupportsPriorities() const { return true; }
 
  private:
   bool m_preview_on;
+  bool m_pending;  // true if m_buffer hasn't been sent yet
   uint8_t m_last_priority;
   ola::DmxBuffer m_buffer;
   ola::acn::E131Node *m_node;
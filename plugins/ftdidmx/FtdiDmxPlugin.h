@@ -52,6 +52,8 @@ class FtdiDmxPlugin : public Plugin {
     conflict_set->insert(ola::OLA_PLUGIN_OPENDMX);
   }
 
+  bool SupportsConcurrentStart() const { return true; }
+
   std::string Description() const;
 
  private:
@@ -66,11 +66,9 @@ bool FtdiDmxThread::Stop() {
  * @brief Copy a DMXBuffer to the output thread
  */
 bool FtdiDmxThread::WriteDMX(const DmxBuffer &buffer) {
-  {
-    ola::thread::MutexLocker locker(&m_buffer_mutex);
-    m_buffer.Set(buffer);
-    return true;
-  }
+  m_buffer.WriteBuffer()->Set(buffer);
+  m_buffer.Publish();
+  return true;
 }
 
 
@@ -81,7 +79,6 @@ void *FtdiDmxThread::Run() {
   TimeStamp ts1, ts2, ts3;
   Clock clock;
   CheckTimeGranularity();
-  DmxBuffer buffer;
 
   int frameTime = static_cast<int>(floor(
     (static_cast<double>(1000) / m_frequency) + static_cast<double>(0.5)));
@@ -99,10 +96,8 @@ void *FtdiDmxThread::Run() {
       }
     }
 
-    {
-      ola::thread::MutexLocker locker(&m_buffer_mutex);
-      buffer.Set(m_buffer);
-    }
+    m_buffer.Update();
+    const DmxBuffer &buffer = m_buffer.ReadBuffer();
 
     clock.CurrentMonotonicTime(&ts1);
 
@@ -28,6 +28,7 @@
 
 #include "ola/DmxBuffer.h"
 #include "ola/thread/Thread.h"
+#include "ola/thread/TripleBuffer.h"
 
 namespace ola {
 namespace plugin {
@@ -49,9 +50,8 @@ class FtdiDmxThread : public ola::thread::Thread {
     FtdiInterface *m_interface;
     bool m_term;
     unsigned int m_frequency;
-    DmxBuffer m_buffer;
+    ola::thread::TripleBuffer<DmxBuffer> m_buffer;
     ola::thread::Mutex m_term_mutex;
-    ola::thread::Mutex m_buffer_mutex;
 
     void CheckTimeGranularity();
 
@@ -0,0 +1,92 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * FakeGPIOLines.cpp
+ * A fake GPIOLinesInterface used for testing.
+ * Copyright (C) 2026 agent
+ */
+
+#include "ola/Clock.h"
+#include "plugins/gpio/FakeGPIOLines.h"
+
+namespace ola {
+namespace plugin {
+namespace gpio {
+
+using ola::thread::MutexLocker;
+
+bool FakeGPIOLines::SetLines(uint64_t mask, uint64_t values) {
+  {
+    MutexLocker lock(&m_mutex);
+    m_updates++;
+    m_values = (m_values & ~mask) | (values & mask);
+    m_last_mask = mask;
+    m_turned_on |= mask & values;
+    m_turned_off |= mask & ~values;
+  }
+  m_cond_var.Signal();
+  return true;
+}
+
+void FakeGPIOLines::Reset() {
+  MutexLocker lock(&m_mutex);
+  m_updates = 0;
+  m_last_mask = 0;
+  m_turned_on = 0;
+  m_turned_off = 0;
+}
+
+bool FakeGPIOLines::WaitForUpdates(unsigned int count) {
+  Clock clock;
+  TimeStamp wake_up;
+  clock.CurrentRealTime(&wake_up);
+  wake_up += TimeInterval(5, 0);
+
+  MutexLocker lock(&m_mutex);
+  while (m_updates < count) {
+    if (!m_cond_var.TimedWait(&m_mutex, wake_up)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+unsigned int FakeGPIOLines::Updates() const {
+  MutexLocker lock(&m_mutex);
+  return m_updates;
+}
+
+uint64_t FakeGPIOLines::Values() const {
+  MutexLocker lock(&m_mutex);
+  return m_values;
+}
+
+uint64_t FakeGPIOLines::LastMask() const {
+  MutexLocker lock(&m_mutex);
+  return m_last_mask;
+}
+
+uint64_t FakeGPIOLines::TurnedOn() const {
+  MutexLocker lock(&m_mutex);
+  return m_turned_on;
+}
+
+uint64_t FakeGPIOLines::TurnedOff() const {
+  MutexLocker lock(&m_mutex);
+  return m_turned_off;
+}
+}  // namespace gpio
+}  // namespace plugin
+}  // namespace ola
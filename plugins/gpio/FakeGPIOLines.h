@@ -0,0 +1,75 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * FakeGPIOLines.h
+ * A fake GPIOLinesInterface used for testing.
+ * Copyright (C) 2026 agent
+ */
+
+#ifndef PLUGINS_GPIO_FAKEGPIOLINES_H_
+#define PLUGINS_GPIO_FAKEGPIOLINES_H_
+
+#include <stdint.h>
+#include <ola/thread/Mutex.h>
+#include <string>
+#include "plugins/gpio/GPIOLines.h"
+
+namespace ola {
+namespace plugin {
+namespace gpio {
+
+/**
+ * A Fake GPIOLinesInterface used for testing
+ */
+class FakeGPIOLines : public GPIOLinesInterface {
+ public:
+  FakeGPIOLines()
+    : m_updates(0),
+      m_values(0),
+      m_last_mask(0),
+      m_turned_on(0),
+      m_turned_off(0) {
+  }
+
+  bool Init() { return true; }
+
+  std::string Description() const { return "fake"; }
+
+  bool SetLines(uint64_t mask, uint64_t values);
+
+  // Methods used for testing
+  void Reset();
+  bool WaitForUpdates(unsigned int count);
+
+  unsigned int Updates() const;
+  uint64_t Values() const;
+  uint64_t LastMask() const;
+  uint64_t TurnedOn() const;
+  uint64_t TurnedOff() const;
+
+ private:
+  unsigned int m_updates;  // GUARDED_BY(m_mutex)
+  uint64_t m_values;  // GUARDED_BY(m_mutex)
+  uint64_t m_last_mask;  // GUARDED_BY(m_mutex)
+  uint64_t m_turned_on;  // GUARDED_BY(m_mutex)
+  uint64_t m_turned_off;  // GUARDED_BY(m_mutex)
+
+  mutable ola::thread::Mutex m_mutex;
+  ola::thread::ConditionVariable m_cond_var;
+};
+}  // namespace gpio
+}  // namespace plugin
+}  // namespace ola
+#endif  // PLUGINS_GPIO_FAKEGPIOLINES_H_
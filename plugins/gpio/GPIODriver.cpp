@@ -18,21 +18,21 @@
  * Copyright (C) 2014 Simon Newton
  */
 
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
 #include "plugins/gpio/GPIODriver.h"
 
 #include <errno.h>
-#include <fcntl.h>
 #include <stdint.h>
-#include <string.h>
-#include <sys/stat.h>
-#include <sys/types.h>
+#include <time.h>
 #include <unistd.h>
 
-#include <sstream>
-#include <string>
+#include <algorithm>
 #include <vector>
 
-#include "ola/io/IOUtils.h"
+#include "ola/Constants.h"
 #include "ola/Logging.h"
 #include "ola/thread/Mutex.h"
 
@@ -40,16 +40,18 @@ namespace ola {
 namespace plugin {
 namespace gpio {
 
-const char GPIODriver::GPIO_BASE_DIR[] = "/sys/class/gpio/gpio";
-
 using ola::thread::MutexLocker;
-using std::string;
 using std::vector;
 
-GPIODriver::GPIODriver(const Options &options)
+GPIODriver::GPIODriver(GPIOLinesInterface *lines, const Options &options)
     : m_options(options),
+      m_lines(lines),
       m_term(false),
-      m_dmx_changed(false) {
+      m_dmx_changed(false),
+      m_window_updates(0),
+      m_window_jitter_samples(0),
+      m_window_jitter_total(0),
+      m_window_jitter_max(0) {
 }
 
 GPIODriver::~GPIODriver() {
@@ -59,15 +61,25 @@ GPIODriver::~GPIODriver() {
   }
   m_cond.Signal();
   Join();
-
-  CloseGPIOFDs();
 }
 
 bool GPIODriver::Init() {
-  if (!SetupGPIO()) {
+  if (m_options.gpio_pins.size() > GPIOLinesInterface::MAX_LINES) {
+    OLA_WARN << "Too many GPIO pins, the limit is "
+             << GPIOLinesInterface::MAX_LINES;
+    return false;
+  }
+
+  if (m_options.pwm && m_options.pwm_frequency == 0) {
+    OLA_WARN << "The PWM frequency must be greater than 0";
     return false;
   }
 
+  if (!m_lines->Init()) {
+    return false;
+  }
+  m_pin_states.assign(m_options.gpio_pins.size(), UNDEFINED);
+  m_clock.CurrentMonotonicTime(&m_window_start);
   return Start();
 }
 
@@ -82,21 +94,70 @@ bool GPIODriver::SendDmx(const DmxBuffer &dmx) {
   return true;
 }
 
+GPIODriver::Stats GPIODriver::GetStats() const {
+  MutexLocker locker(&m_stats_mutex);
+  return m_stats;
+}
+
+void GPIODriver::BuildPWMSteps(const uint8_t *levels, unsigned int count,
+                               unsigned int period, PWMSteps *steps) {
+  steps->clear();
+
+  PWMStep first = {0, 0, 0};
+  for (unsigned int i = 0; i < count; i++) {
+    const uint64_t bit = static_cast<uint64_t>(1) << i;
+    first.mask |= bit;
+    if (levels[i] != DMX_MIN_SLOT_VALUE) {
+      first.values |= bit;
+    }
+  }
+  steps->push_back(first);
+
+  // Pins which are partly on are turned off in order of level. Levels which
+  // land on the same microsecond share a step.
+  vector<uint8_t> sorted(levels, levels + count);
+  std::sort(sorted.begin(), sorted.end());
+  sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+
+  vector<uint8_t>::const_iterator iter = sorted.begin();
+  for (; iter != sorted.end(); ++iter) {
+    if (*iter == DMX_MIN_SLOT_VALUE || *iter == DMX_MAX_SLOT_VALUE) {
+      continue;
+    }
+
+    unsigned int offset = static_cast<unsigned int>(
+        static_cast<uint64_t>(period) * *iter / DMX_MAX_SLOT_VALUE);
+    if (steps->back().offset != offset) {
+      PWMStep step = {offset, 0, 0};
+      steps->push_back(step);
+    }
+    for (unsigned int i = 0; i < count; i++) {
+      if (levels[i] == *iter) {
+        const uint64_t bit = static_cast<uint64_t>(1) << i;
+        steps->back().mask |= bit;
+        steps->back().values &= ~bit;
+      }
+    }
+  }
+}
+
 void *GPIODriver::Run() {
-  Clock clock;
   DmxBuffer output;
+  PWMSteps steps;
+  TimeStamp period_start;
+  bool dimming = false;
 
   while (true) {
-    bool update_pins = false;
-
-    TimeStamp wake_up;
-    // Use real time here because wake_up is passed to pthread_cond_timedwait
-    clock.CurrentRealTime(&wake_up);
-    wake_up += TimeInterval(1, 0);
+    bool dmx_changed = false;
 
-    // Wait for one of: i) termination ii) DMX changed iii) timeout
+    // While dimming we can't block, the next PWM period is due.
     m_mutex.Lock();
-    if (!m_term && !m_dmx_changed) {
+    if (!dimming && !m_term && !m_dmx_changed) {
+      TimeStamp wake_up;
+      // Use real time here because wake_up is passed to
+      // pthread_cond_timedwait
+      m_clock.CurrentRealTime(&wake_up);
+      wake_up += TimeInterval(1, 0);
       m_cond.TimedWait(&m_mutex, wake_up);
     }
 
@@ -106,59 +167,33 @@ void *GPIODriver::Run() {
     } else if (m_dmx_changed) {
       output.Set(m_buffer);
       m_dmx_changed = false;
-      update_pins = true;
+      dmx_changed = true;
     }
     m_mutex.Unlock();
-    if (update_pins) {
-      UpdateGPIOPins(output);
-    }
-  }
-  return NULL;
-}
 
-bool GPIODriver::SetupGPIO() {
-  /**
-   * This relies on the pins being exported:
-   *   echo N > /sys/class/gpio/export
-   * That requires root access.
-   */
-  const string direction("out");
-  bool failed = false;
-  vector<uint16_t>::const_iterator iter = m_options.gpio_pins.begin();
-  for (; iter != m_options.gpio_pins.end(); ++iter) {
-    std::ostringstream str;
-    str << GPIO_BASE_DIR << static_cast<int>(*iter) << "/value";
-    int pin_fd;
-    if (!ola::io::Open(str.str(), O_RDWR, &pin_fd)) {
-      failed = true;
-      break;
-    }
-
-    GPIOPin pin = {pin_fd, UNDEFINED, false};
-
-    // Set dir
-    str.str("");
-    str << GPIO_BASE_DIR << static_cast<int>(*iter) << "/direction";
-    int fd;
-    if (!ola::io::Open(str.str(), O_RDWR, &fd)) {
-      failed = true;
-      break;
-    }
-    if (write(fd, direction.c_str(), direction.size()) < 0) {
-      OLA_WARN << "Failed to enable output on " << str.str() << " : "
-               << strerror(errno);
-      failed = true;
+    if (!m_options.pwm) {
+      if (dmx_changed) {
+        UpdateGPIOPins(output);
+      }
+    } else {
+      if (dmx_changed) {
+        BuildPWMSteps(output, &steps);
+        if (!dimming) {
+          m_clock.CurrentMonotonicTime(&period_start);
+        }
+        // If every pin is fully on or off there is nothing to dim.
+        dimming = steps.size() > 1;
+      }
+      if (dmx_changed || dimming) {
+        RunPWMPeriod(steps, &period_start);
+      }
     }
-    close(fd);
-
-    m_gpio_pins.push_back(pin);
-  }
 
-  if (failed) {
-    CloseGPIOFDs();
-    return false;
+    TimeStamp now;
+    m_clock.CurrentMonotonicTime(&now);
+    UpdateStats(now);
   }
-  return true;
+  return NULL;
 }
 
 bool GPIODriver::UpdateGPIOPins(const DmxBuffer &dmx) {
@@ -169,13 +204,15 @@ bool GPIODriver::UpdateGPIOPins(const DmxBuffer &dmx) {
   };
   const uint16_t first_slot = m_options.start_address - 1;
 
+  uint64_t mask = 0;
+  uint64_t values = 0;
   for (uint16_t i = 0;
-       i < m_gpio_pins.size() && (i + first_slot < dmx.Size());
+       i < m_pin_states.size() && (i + first_slot < dmx.Size());
        i++) {
     Action action = NO_CHANGE;
     uint8_t slot_value = dmx.Get(i + first_slot);
 
-    switch (m_gpio_pins[i].state) {
+    switch (m_pin_states[i]) {
       case ON:
         action = (slot_value <= m_options.turn_off ? TURN_OFF : NO_CHANGE);
         break;
@@ -189,27 +226,127 @@ bool GPIODriver::UpdateGPIOPins(const DmxBuffer &dmx) {
         action = (slot_value >= m_options.turn_on ? TURN_ON : TURN_OFF);
     }
 
-    // Change the pin state if required.
     if (action != NO_CHANGE) {
-      char data = (action == TURN_ON ? '1' : '0');
-      if (write(m_gpio_pins[i].fd, &data, sizeof(data)) < 0) {
-        OLA_WARN << "Failed to toggle GPIO pin " << i << ", fd "
-                 << static_cast<int>(m_gpio_pins[i].fd) << ": "
-                 << strerror(errno);
-        return false;
+      const uint64_t bit = static_cast<uint64_t>(1) << i;
+      mask |= bit;
+      if (action == TURN_ON) {
+        values |= bit;
       }
-      m_gpio_pins[i].state = (action == TURN_ON ? ON : OFF);
+    }
+  }
+
+  if (!mask) {
+    return true;
+  }
+
+  // Change all the pins in one go.
+  if (!SetLines(mask, values)) {
+    return false;
+  }
+
+  for (uint16_t i = 0; i < m_pin_states.size(); i++) {
+    const uint64_t bit = static_cast<uint64_t>(1) << i;
+    if (mask & bit) {
+      m_pin_states[i] = (values & bit ? ON : OFF);
     }
   }
   return true;
 }
 
-void GPIODriver::CloseGPIOFDs() {
-  GPIOPins::iterator iter = m_gpio_pins.begin();
-  for (; iter != m_gpio_pins.end(); ++iter) {
-    close(iter->fd);
+void GPIODriver::BuildPWMSteps(const DmxBuffer &dmx, PWMSteps *steps) const {
+  const uint16_t first_slot = m_options.start_address - 1;
+  vector<uint8_t> levels(m_pin_states.size(), DMX_MIN_SLOT_VALUE);
+  for (uint16_t i = 0;
+       i < levels.size() && (i + first_slot < dmx.Size());
+       i++) {
+    levels[i] = dmx.Get(i + first_slot);
+  }
+  BuildPWMSteps(levels.empty() ? NULL : &levels[0], levels.size(),
+                MICROSECONDS_PER_SECOND / m_options.pwm_frequency, steps);
+}
+
+bool GPIODriver::RunPWMPeriod(const PWMSteps &steps,
+                              TimeStamp *period_start) {
+  bool ok = true;
+  PWMSteps::const_iterator iter = steps.begin();
+  for (; iter != steps.end(); ++iter) {
+    const TimeStamp target = *period_start + TimeInterval(iter->offset);
+    SleepUntil(target);
+    RecordJitter(target);
+    ok &= SetLines(iter->mask, iter->values);
+  }
+
+  const TimeInterval period(MICROSECONDS_PER_SECOND /
+                            m_options.pwm_frequency);
+  *period_start += period;
+
+  // If we've fallen more than a period behind, don't try to catch up.
+  TimeStamp now;
+  m_clock.CurrentMonotonicTime(&now);
+  if (now > *period_start + period) {
+    *period_start = now;
+  }
+  SleepUntil(*period_start);
+  return ok;
+}
+
+void GPIODriver::SleepUntil(const TimeStamp &wake_up) {
+#if defined(HAVE_CLOCK_NANOSLEEP) && defined(CLOCK_MONOTONIC)
+  struct timespec ts;
+  ts.tv_sec = wake_up.Seconds();
+  ts.tv_nsec = wake_up.MicroSeconds() * 1000;
+  while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) ==
+         EINTR) {
   }
-  m_gpio_pins.clear();
+#else
+  TimeStamp now;
+  m_clock.CurrentMonotonicTime(&now);
+  if (wake_up > now) {
+    usleep((wake_up - now).AsInt());
+  }
+#endif  // HAVE_CLOCK_NANOSLEEP
+}
+
+bool GPIODriver::SetLines(uint64_t mask, uint64_t values) {
+  m_window_updates++;
+  return m_lines->SetLines(mask, values);
+}
+
+void GPIODriver::RecordJitter(const TimeStamp &target) {
+  TimeStamp now;
+  m_clock.CurrentMonotonicTime(&now);
+  const int64_t jitter = now > target ? (now - target).AsInt() : 0;
+  m_window_jitter_samples++;
+  m_window_jitter_total += jitter;
+  m_window_jitter_max = std::max(m_window_jitter_max, jitter);
+}
+
+void GPIODriver::UpdateStats(const TimeStamp &now) {
+  const int64_t elapsed = (now - m_window_start).AsInt();
+  if (elapsed < static_cast<int64_t>(MICROSECONDS_PER_SECOND)) {
+    return;
+  }
+
+  Stats stats;
+  stats.update_rate = static_cast<unsigned int>(
+      static_cast<int64_t>(m_window_updates) * MICROSECONDS_PER_SECOND /
+      elapsed);
+  if (m_window_jitter_samples) {
+    stats.mean_jitter = static_cast<unsigned int>(
+        m_window_jitter_total / m_window_jitter_samples);
+    stats.max_jitter = static_cast<unsigned int>(m_window_jitter_max);
+  }
+
+  {
+    MutexLocker locker(&m_stats_mutex);
+    m_stats = stats;
+  }
+
+  m_window_start = now;
+  m_window_updates = 0;
+  m_window_jitter_samples = 0;
+  m_window_jitter_total = 0;
+  m_window_jitter_max = 0;
 }
 }  // namespace gpio
 }  // namespace plugin
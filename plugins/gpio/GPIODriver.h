@@ -22,18 +22,28 @@
 #define PLUGINS_GPIO_GPIODRIVER_H_
 
 #include <stdint.h>
+#include <ola/Clock.h>
 #include <ola/DmxBuffer.h>
 #include <ola/base/Macro.h>
 #include <ola/thread/Thread.h>
 
+#include <memory>
+#include <string>
 #include <vector>
 
+#include "plugins/gpio/GPIOLines.h"
+
 namespace ola {
 namespace plugin {
 namespace gpio {
 
 /**
  * @brief Uses data in a DMXBuffer to drive GPIO pins.
+ *
+ * By default each pin is switched on or off using the turn_on & turn_off
+ * thresholds. In PWM mode the pins are dimmed with software PWM instead. The
+ * pins which change at the same time are always set with a single call to
+ * the GPIOLinesInterface.
  */
 class GPIODriver : private ola::thread::Thread {
  public:
@@ -42,13 +52,28 @@ class GPIODriver : private ola::thread::Thread {
    */
   struct Options {
    public:
-    Options(): start_address(1), turn_on(128), turn_off(127) {}
+    Options()
+        : gpio_chip(""),
+          start_address(1),
+          turn_on(128),
+          turn_off(127),
+          pwm(false),
+          pwm_frequency(200) {
+    }
 
     /**
      * @brief A list of I/O pins to map to slots.
      */
     std::vector<uint16_t> gpio_pins;
 
+    /**
+     * @brief The GPIO character device to use, e.g. /dev/gpiochip0.
+     *
+     * If this is empty, the pins are controlled using sysfs, otherwise
+     * gpio_pins are the line offsets on the chip.
+     */
+    std::string gpio_chip;
+
     /**
      * @brief The DMX512 start address of the first pin
      */
@@ -63,13 +88,58 @@ class GPIODriver : private ola::thread::Thread {
      * @brief The value below which a pin will be turned off.
      */
     uint8_t turn_off;
+
+    /**
+     * @brief Dim the pins using software PWM, rather than switching them.
+     */
+    bool pwm;
+
+    /**
+     * @brief The PWM frequency in Hz.
+     */
+    uint16_t pwm_frequency;
+  };
+
+  /**
+   * @brief The measured performance of the driver.
+   */
+  struct Stats {
+   public:
+    Stats() : update_rate(0), mean_jitter(0), max_jitter(0) {}
+
+    /**
+     * @brief The number of times per second the lines were set.
+     */
+    unsigned int update_rate;
+
+    /**
+     * @brief The mean lateness of the PWM edges, in microseconds.
+     */
+    unsigned int mean_jitter;
+
+    /**
+     * @brief The worst lateness of the PWM edges, in microseconds.
+     */
+    unsigned int max_jitter;
   };
 
+  /**
+   * @brief A change to the lines, made part way through a PWM period.
+   */
+  struct PWMStep {
+    unsigned int offset;  // in microseconds from the start of the period
+    uint64_t mask;
+    uint64_t values;
+  };
+
+  typedef std::vector<PWMStep> PWMSteps;
+
   /**
    * @brief Create a new GPIODriver.
+   * @param lines the GPIOLinesInterface to use, ownership is transferred.
    * @param options the Options struct.
    */
-  explicit GPIODriver(const Options &options);
+  GPIODriver(GPIOLinesInterface *lines, const Options &options);
 
   /**
    * @brief Destructor.
@@ -88,6 +158,11 @@ class GPIODriver : private ola::thread::Thread {
    */
   std::vector<uint16_t> PinList() const { return m_options.gpio_pins; }
 
+  /**
+   * @brief Describe the backend used to set the pins.
+   */
+  std::string BackendDescription() const { return m_lines->Description(); }
+
   /**
    * @brief Set the values of the GPIO pins from the data in the DMXBuffer.
    * @param dmx the DmxBuffer with the values to use.
@@ -95,6 +170,22 @@ class GPIODriver : private ola::thread::Thread {
    */
   bool SendDmx(const DmxBuffer &dmx);
 
+  /**
+   * @brief Get the update rate and jitter measured over the last second.
+   */
+  Stats GetStats() const;
+
+  /**
+   * @brief Build the steps for one PWM period.
+   * @param levels the level of each line.
+   * @param count the number of lines, at most GPIOLinesInterface::MAX_LINES.
+   * @param period the length of the period in microseconds.
+   * @param[out] steps the steps, sorted by offset. The first step is at
+   *   offset 0 and sets every line.
+   */
+  static void BuildPWMSteps(const uint8_t *levels, unsigned int count,
+                            unsigned int period, PWMSteps *steps);
+
   void *Run();
 
  private:
@@ -104,16 +195,12 @@ class GPIODriver : private ola::thread::Thread {
     UNDEFINED,
   };
 
-  struct GPIOPin {
-    int fd;
-    GPIOState state;
-    bool last_value;
-  };
-
-  typedef std::vector<GPIOPin> GPIOPins;
+  typedef std::vector<GPIOState> GPIOStates;
 
   const Options m_options;
-  GPIOPins m_gpio_pins;
+  std::auto_ptr<GPIOLinesInterface> m_lines;
+  GPIOStates m_pin_states;
+  ola::Clock m_clock;
 
   DmxBuffer m_buffer;
   bool m_term;  // GUARDED_BY(m_mutex);
@@ -121,11 +208,25 @@ class GPIODriver : private ola::thread::Thread {
   ola::thread::Mutex m_mutex;
   ola::thread::ConditionVariable m_cond;
 
-  bool SetupGPIO();
-  bool UpdateGPIOPins(const DmxBuffer &dmx);
-  void CloseGPIOFDs();
+  // Only used by the driver thread
+  TimeStamp m_window_start;
+  unsigned int m_window_updates;
+  unsigned int m_window_jitter_samples;
+  int64_t m_window_jitter_total;
+  int64_t m_window_jitter_max;
 
-  static const char GPIO_BASE_DIR[];
+  Stats m_stats;  // GUARDED_BY(m_stats_mutex);
+  mutable ola::thread::Mutex m_stats_mutex;
+
+  bool UpdateGPIOPins(const DmxBuffer &dmx);
+  void BuildPWMSteps(const DmxBuffer &dmx, PWMSteps *steps) const;
+  bool RunPWMPeriod(const PWMSteps &steps, TimeStamp *period_start);
+  void SleepUntil(const TimeStamp &wake_up);
+  bool SetLines(uint64_t mask, uint64_t values);
+  void RecordJitter(const TimeStamp &target);
+  void UpdateStats(const TimeStamp &now);
+
+  static const unsigned int MICROSECONDS_PER_SECOND = 1000000;
 
   DISALLOW_COPY_AND_ASSIGN(GPIODriver);
 };
@@ -0,0 +1,170 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * GPIODriverTest.cpp
+ * Test fixture for the GPIODriver.
+ * Copyright (C) 2026 agent
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <stdint.h>
+#include <unistd.h>
+
+#include "ola/DmxBuffer.h"
+#include "ola/testing/TestUtils.h"
+#include "plugins/gpio/FakeGPIOLines.h"
+#include "plugins/gpio/GPIODriver.h"
+
+using ola::DmxBuffer;
+using ola::plugin::gpio::FakeGPIOLines;
+using ola::plugin::gpio::GPIODriver;
+
+class GPIODriverTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(GPIODriverTest);
+  CPPUNIT_TEST(testBuildPWMSteps);
+  CPPUNIT_TEST(testSwitch);
+  CPPUNIT_TEST(testPWM);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void setUp();
+
+  void testBuildPWMSteps();
+  void testSwitch();
+  void testPWM();
+
+ private:
+  GPIODriver::Options m_options;
+};
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(GPIODriverTest);
+
+void GPIODriverTest::setUp() {
+  m_options.gpio_pins.push_back(4);
+  m_options.gpio_pins.push_back(17);
+  m_options.gpio_pins.push_back(27);
+}
+
+
+/*
+ * Check the PWM steps are built correctly.
+ */
+void GPIODriverTest::testBuildPWMSteps() {
+  GPIODriver::PWMSteps steps;
+
+  const uint8_t levels[] = {0, 255, 128, 64, 128};
+  GPIODriver::BuildPWMSteps(levels, sizeof(levels), 1000, &steps);
+  OLA_ASSERT_EQ(static_cast<size_t>(3), steps.size());
+  OLA_ASSERT_EQ(0u, steps[0].offset);
+  OLA_ASSERT_EQ(static_cast<uint64_t>(0x1f), steps[0].mask);
+  OLA_ASSERT_EQ(static_cast<uint64_t>(0x1e), steps[0].values);
+  OLA_ASSERT_EQ(250u, steps[1].offset);
+  OLA_ASSERT_EQ(static_cast<uint64_t>(0x08), steps[1].mask);
+  OLA_ASSERT_EQ(static_cast<uint64_t>(0), steps[1].values);
+  OLA_ASSERT_EQ(501u, steps[2].offset);
+  OLA_ASSERT_EQ(static_cast<uint64_t>(0x14), steps[2].mask);
+  OLA_ASSERT_EQ(static_cast<uint64_t>(0), steps[2].values);
+
+  // Fully on or off doesn't need any more steps.
+  const uint8_t on_off[] = {255, 0, 255};
+  GPIODriver::BuildPWMSteps(on_off, sizeof(on_off), 1000, &steps);
+  OLA_ASSERT_EQ(static_cast<size_t>(1), steps.size());
+  OLA_ASSERT_EQ(static_cast<uint64_t>(0x07), steps[0].mask);
+  OLA_ASSERT_EQ(static_cast<uint64_t>(0x05), steps[0].values);
+
+  // Levels which round to the same offset share a step, and lines which
+  // round to 0 stay off.
+  const uint8_t close_levels[] = {1, 2, 3, 200};
+  GPIODriver::BuildPWMSteps(close_levels, sizeof(close_levels), 100, &steps);
+  OLA_ASSERT_EQ(static_cast<size_t>(3), steps.size());
+  OLA_ASSERT_EQ(0u, steps[0].offset);
+  OLA_ASSERT_EQ(static_cast<uint64_t>(0x0f), steps[0].mask);
+  OLA_ASSERT_EQ(static_cast<uint64_t>(0x0c), steps[0].values);
+  OLA_ASSERT_EQ(1u, steps[1].offset);
+  OLA_ASSERT_EQ(static_cast<uint64_t>(0x04), steps[1].mask);
+  OLA_ASSERT_EQ(78u, steps[2].offset);
+  OLA_ASSERT_EQ(static_cast<uint64_t>(0x08), steps[2].mask);
+}
+
+
+/*
+ * Check the pins are switched on and off, with one update per change.
+ */
+void GPIODriverTest::testSwitch() {
+  FakeGPIOLines *lines = new FakeGPIOLines();
+  GPIODriver driver(lines, m_options);
+  OLA_ASSERT_TRUE(driver.Init());
+
+  DmxBuffer buffer;
+  buffer.SetFromString("200,0,127");
+  driver.SendDmx(buffer);
+  OLA_ASSERT_TRUE(lines->WaitForUpdates(1));
+  OLA_ASSERT_EQ(static_cast<uint64_t>(0x07), lines->LastMask());
+  OLA_ASSERT_EQ(static_cast<uint64_t>(0x01), lines->Values());
+
+  // Only the pin which changed is updated.
+  buffer.SetFromString("200,128,127");
+  driver.SendDmx(buffer);
+  OLA_ASSERT_TRUE(lines->WaitForUpdates(2));
+  OLA_ASSERT_EQ(static_cast<uint64_t>(0x02), lines->LastMask());
+  OLA_ASSERT_EQ(static_cast<uint64_t>(0x03), lines->Values());
+
+  // Both pins are turned off in the same update
+  buffer.SetFromString("127,0,127");
+  driver.SendDmx(buffer);
+  OLA_ASSERT_TRUE(lines->WaitForUpdates(3));
+  OLA_ASSERT_EQ(static_cast<uint64_t>(0x03), lines->LastMask());
+  OLA_ASSERT_EQ(static_cast<uint64_t>(0), lines->Values());
+  OLA_ASSERT_EQ(3u, lines->Updates());
+}
+
+
+/*
+ * Check the pins are dimmed in PWM mode, and the stats are reported.
+ */
+void GPIODriverTest::testPWM() {
+  m_options.pwm = true;
+  m_options.pwm_frequency = 1000;
+  FakeGPIOLines *lines = new FakeGPIOLines();
+  GPIODriver driver(lines, m_options);
+  OLA_ASSERT_TRUE(driver.Init());
+
+  DmxBuffer buffer;
+  buffer.SetFromString("0,255,128");
+  driver.SendDmx(buffer);
+  OLA_ASSERT_TRUE(lines->WaitForUpdates(20));
+
+  OLA_ASSERT_EQ(static_cast<uint64_t>(0x06), lines->TurnedOn());
+  OLA_ASSERT_EQ(static_cast<uint64_t>(0x05), lines->TurnedOff());
+
+  // Wait for the stats to be reported, this takes a second.
+  GPIODriver::Stats stats;
+  for (unsigned int i = 0; i < 30 && !stats.update_rate; i++) {
+    usleep(100000);
+    stats = driver.GetStats();
+  }
+  OLA_ASSERT_TRUE(stats.update_rate > 0);
+  OLA_ASSERT_TRUE(stats.max_jitter >= stats.mean_jitter);
+
+  // Once all the pins are on or off, the updates stop.
+  buffer.SetFromString("0,255,255");
+  driver.SendDmx(buffer);
+  usleep(50000);
+  lines->Reset();
+  usleep(50000);
+  OLA_ASSERT_EQ(0u, lines->Updates());
+  OLA_ASSERT_EQ(static_cast<uint64_t>(0x06), lines->Values());
+}
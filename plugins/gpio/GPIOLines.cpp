@@ -0,0 +1,209 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * GPIOLines.cpp
+ * The backends used to set the state of GPIO lines.
+ * Copyright (C) 2026 agent
+ */
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
+#include "plugins/gpio/GPIOLines.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#ifdef HAVE_SYS_IOCTL_H
+#include <sys/ioctl.h>
+#endif  // HAVE_SYS_IOCTL_H
+#ifdef HAVE_LINUX_GPIO_H
+#include <linux/gpio.h>
+#endif  // HAVE_LINUX_GPIO_H
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ola/io/IOUtils.h"
+#include "ola/Logging.h"
+
+namespace ola {
+namespace plugin {
+namespace gpio {
+
+using std::string;
+using std::vector;
+
+const char SysfsGPIOLines::GPIO_BASE_DIR[] = "/sys/class/gpio/gpio";
+const char CharDevGPIOLines::CONSUMER[] = "olad";
+
+SysfsGPIOLines::SysfsGPIOLines(const vector<uint16_t> &pins)
+    : m_pins(pins) {
+}
+
+SysfsGPIOLines::~SysfsGPIOLines() {
+  CloseFDs();
+}
+
+bool SysfsGPIOLines::Init() {
+  /**
+   * This relies on the pins being exported:
+   *   echo N > /sys/class/gpio/export
+   * That requires root access.
+   */
+  if (m_pins.size() > MAX_LINES) {
+    OLA_WARN << "Too many GPIO pins, the limit is " << MAX_LINES;
+    return false;
+  }
+
+  const string direction("out");
+  bool failed = false;
+  vector<uint16_t>::const_iterator iter = m_pins.begin();
+  for (; iter != m_pins.end(); ++iter) {
+    std::ostringstream str;
+    str << GPIO_BASE_DIR << static_cast<int>(*iter) << "/value";
+    int pin_fd;
+    if (!ola::io::Open(str.str(), O_RDWR, &pin_fd)) {
+      failed = true;
+      break;
+    }
+    m_fds.push_back(pin_fd);
+
+    // Set dir
+    str.str("");
+    str << GPIO_BASE_DIR << static_cast<int>(*iter) << "/direction";
+    int fd;
+    if (!ola::io::Open(str.str(), O_RDWR, &fd)) {
+      failed = true;
+      break;
+    }
+    if (write(fd, direction.c_str(), direction.size()) < 0) {
+      OLA_WARN << "Failed to enable output on " << str.str() << " : "
+               << strerror(errno);
+      failed = true;
+    }
+    close(fd);
+  }
+
+  if (failed) {
+    CloseFDs();
+    return false;
+  }
+  return true;
+}
+
+bool SysfsGPIOLines::SetLines(uint64_t mask, uint64_t values) {
+  for (unsigned int i = 0; i < m_fds.size(); i++) {
+    const uint64_t bit = static_cast<uint64_t>(1) << i;
+    if (!(mask & bit)) {
+      continue;
+    }
+    char data = (values & bit ? '1' : '0');
+    if (write(m_fds[i], &data, sizeof(data)) < 0) {
+      OLA_WARN << "Failed to toggle GPIO pin " << m_pins[i] << ", fd "
+               << m_fds[i] << ": " << strerror(errno);
+      return false;
+    }
+  }
+  return true;
+}
+
+void SysfsGPIOLines::CloseFDs() {
+  vector<int>::iterator iter = m_fds.begin();
+  for (; iter != m_fds.end(); ++iter) {
+    close(*iter);
+  }
+  m_fds.clear();
+}
+
+
+CharDevGPIOLines::CharDevGPIOLines(const string &chip_path,
+                                   const vector<uint16_t> &offsets)
+    : m_chip_path(chip_path),
+      m_offsets(offsets),
+      m_fd(-1) {
+}
+
+CharDevGPIOLines::~CharDevGPIOLines() {
+  if (m_fd >= 0) {
+    close(m_fd);
+  }
+}
+
+#ifdef GPIO_V2_GET_LINE_IOCTL
+bool CharDevGPIOLines::Init() {
+  if (m_offsets.size() > MAX_LINES ||
+      m_offsets.size() > GPIO_V2_LINES_MAX) {
+    OLA_WARN << "Too many GPIO lines, the limit is " << MAX_LINES;
+    return false;
+  }
+
+  int chip_fd;
+  if (!ola::io::Open(m_chip_path, O_RDWR, &chip_fd)) {
+    return false;
+  }
+
+  struct gpio_v2_line_request request;
+  memset(&request, 0, sizeof(request));
+  for (unsigned int i = 0; i < m_offsets.size(); i++) {
+    request.offsets[i] = m_offsets[i];
+  }
+  request.num_lines = m_offsets.size();
+  strncpy(request.consumer, CONSUMER, sizeof(request.consumer) - 1);
+  request.config.flags = GPIO_V2_LINE_FLAG_OUTPUT;
+
+  int r = ioctl(chip_fd, GPIO_V2_GET_LINE_IOCTL, &request);
+  close(chip_fd);
+  if (r < 0) {
+    OLA_WARN << "Failed to request GPIO lines from " << m_chip_path << ": "
+             << strerror(errno);
+    return false;
+  }
+  m_fd = request.fd;
+  return true;
+}
+
+bool CharDevGPIOLines::SetLines(uint64_t mask, uint64_t values) {
+  if (!mask) {
+    return true;
+  }
+
+  struct gpio_v2_line_values line_values;
+  line_values.bits = values;
+  line_values.mask = mask;
+  if (ioctl(m_fd, GPIO_V2_LINE_SET_VALUES_IOCTL, &line_values) < 0) {
+    OLA_WARN << "Failed to set GPIO lines on " << m_chip_path << ": "
+             << strerror(errno);
+    return false;
+  }
+  return true;
+}
+#else
+bool CharDevGPIOLines::Init() {
+  OLA_WARN << "The GPIO character device isn't supported on this platform";
+  return false;
+}
+
+bool CharDevGPIOLines::SetLines(OLA_UNUSED uint64_t mask,
+                                OLA_UNUSED uint64_t values) {
+  return false;
+}
+#endif  // GPIO_V2_GET_LINE_IOCTL
+}  // namespace gpio
+}  // namespace plugin
+}  // namespace ola
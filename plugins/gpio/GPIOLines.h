@@ -0,0 +1,127 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * GPIOLines.h
+ * The backends used to set the state of GPIO lines.
+ * Copyright (C) 2026 agent
+ */
+
+#ifndef PLUGINS_GPIO_GPIOLINES_H_
+#define PLUGINS_GPIO_GPIOLINES_H_
+
+#include <stdint.h>
+#include <ola/base/Macro.h>
+
+#include <string>
+#include <vector>
+
+namespace ola {
+namespace plugin {
+namespace gpio {
+
+/**
+ * @brief The interface for setting a group of GPIO lines.
+ *
+ * Lines are identified by their index in the pin list the backend was
+ * created with, so a backend can control at most MAX_LINES lines.
+ */
+class GPIOLinesInterface {
+ public:
+  virtual ~GPIOLinesInterface() {}
+
+  /**
+   * @brief Open the lines and configure them as outputs.
+   * @returns true if successful, false otherwise.
+   */
+  virtual bool Init() = 0;
+
+  /**
+   * @brief A short description of the backend, i.e. sysfs or the chip path.
+   */
+  virtual std::string Description() const = 0;
+
+  /**
+   * @brief Set the state of some of the lines.
+   * @param mask the lines to change, bit N is the Nth line.
+   * @param values the new state of the lines in mask.
+   * @returns true if the lines were updated.
+   */
+  virtual bool SetLines(uint64_t mask, uint64_t values) = 0;
+
+  static const unsigned int MAX_LINES = 64;
+};
+
+
+/**
+ * @brief Sets GPIO lines using /sys/class/gpio.
+ *
+ * This needs one write() per line, and relies on the pins having been
+ * exported.
+ */
+class SysfsGPIOLines : public GPIOLinesInterface {
+ public:
+  explicit SysfsGPIOLines(const std::vector<uint16_t> &pins);
+  ~SysfsGPIOLines();
+
+  bool Init();
+  std::string Description() const { return "sysfs"; }
+  bool SetLines(uint64_t mask, uint64_t values);
+
+ private:
+  const std::vector<uint16_t> m_pins;
+  std::vector<int> m_fds;
+
+  void CloseFDs();
+
+  static const char GPIO_BASE_DIR[];
+
+  DISALLOW_COPY_AND_ASSIGN(SysfsGPIOLines);
+};
+
+
+/**
+ * @brief Sets GPIO lines using the GPIO character device.
+ *
+ * All the lines are requested together, which means any combination of them
+ * can be set with a single ioctl().
+ */
+class CharDevGPIOLines : public GPIOLinesInterface {
+ public:
+  /**
+   * @brief Create a new CharDevGPIOLines.
+   * @param chip_path the path to the chip, e.g. /dev/gpiochip0.
+   * @param offsets the line offsets on the chip.
+   */
+  CharDevGPIOLines(const std::string &chip_path,
+                   const std::vector<uint16_t> &offsets);
+  ~CharDevGPIOLines();
+
+  bool Init();
+  std::string Description() const { return m_chip_path; }
+  bool SetLines(uint64_t mask, uint64_t values);
+
+ private:
+  const std::string m_chip_path;
+  const std::vector<uint16_t> m_offsets;
+  int m_fd;
+
+  static const char CONSUMER[];
+
+  DISALLOW_COPY_AND_ASSIGN(CharDevGPIOLines);
+};
+}  // namespace gpio
+}  // namespace plugin
+}  // namespace ola
+#endif  // PLUGINS_GPIO_GPIOLINES_H_
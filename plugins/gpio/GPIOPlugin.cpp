@@ -38,7 +38,10 @@ using std::auto_ptr;
 using std::string;
 using std::vector;
 
+const char GPIOPlugin::GPIO_CHIP_KEY[] = "gpio_chip";
 const char GPIOPlugin::GPIO_PINS_KEY[] = "gpio_pins";
+const char GPIOPlugin::GPIO_PWM_FREQUENCY_KEY[] = "gpio_pwm_frequency";
+const char GPIOPlugin::GPIO_PWM_KEY[] = "gpio_pwm";
 const char GPIOPlugin::GPIO_SLOT_OFFSET_KEY[] = "gpio_slot_offset";
 const char GPIOPlugin::GPIO_TURN_OFF_KEY[] = "gpio_turn_off";
 const char GPIOPlugin::GPIO_TURN_ON_KEY[] = "gpio_turn_on";
@@ -65,6 +68,17 @@ bool GPIOPlugin::StartHook() {
     return false;
   }
 
+  if (!StringToInt(m_preferences->GetValue(GPIO_PWM_FREQUENCY_KEY),
+                   &options.pwm_frequency) ||
+      options.pwm_frequency == 0 ||
+      options.pwm_frequency > MAX_PWM_FREQUENCY) {
+    OLA_WARN << "Invalid value for " << GPIO_PWM_FREQUENCY_KEY;
+    return false;
+  }
+
+  options.pwm = m_preferences->GetValueAsBool(GPIO_PWM_KEY);
+  options.gpio_chip = m_preferences->GetValue(GPIO_CHIP_KEY);
+
   if (options.turn_off >= options.turn_on) {
     OLA_WARN << GPIO_TURN_OFF_KEY << " must be strictly less than "
              << GPIO_TURN_ON_KEY;
@@ -124,6 +138,16 @@ bool GPIOPlugin::SetDefaultPreferences() {
   save |= m_preferences->SetDefaultValue(GPIO_PINS_KEY,
                                          StringValidator(),
                                          "");
+  save |= m_preferences->SetDefaultValue(GPIO_CHIP_KEY,
+                                         StringValidator(true),
+                                         "");
+  save |= m_preferences->SetDefaultValue(GPIO_PWM_KEY,
+                                         BoolValidator(),
+                                         false);
+  save |= m_preferences->SetDefaultValue(
+      GPIO_PWM_FREQUENCY_KEY,
+      UIntValidator(1, MAX_PWM_FREQUENCY),
+      "200");
   save |= m_preferences->SetDefaultValue(GPIO_SLOT_OFFSET_KEY,
                                          UIntValidator(1, DMX_UNIVERSE_SIZE),
                                          "1");
@@ -54,13 +54,18 @@ class GPIOPlugin: public ola::Plugin {
   bool StopHook();
   bool SetDefaultPreferences();
 
+  static const char GPIO_CHIP_KEY[];
   static const char GPIO_PINS_KEY[];
+  static const char GPIO_PWM_FREQUENCY_KEY[];
+  static const char GPIO_PWM_KEY[];
   static const char GPIO_SLOT_OFFSET_KEY[];
   static const char GPIO_TURN_OFF_KEY[];
   static const char GPIO_TURN_ON_KEY[];
   static const char PLUGIN_NAME[];
   static const char PLUGIN_PREFIX[];
 
+  static const uint16_t MAX_PWM_FREQUENCY = 10000;
+
   DISALLOW_COPY_AND_ASSIGN(GPIOPlugin);
 };
 }  // namespace gpio
@@ -26,6 +26,7 @@
 
 #include "ola/StringUtils.h"
 #include "plugins/gpio/GPIODriver.h"
+#include "plugins/gpio/GPIOLines.h"
 
 namespace ola {
 namespace plugin {
@@ -34,10 +35,19 @@ namespace gpio {
 using std::string;
 using std::vector;
 
+namespace {
+GPIOLinesInterface *NewGPIOLines(const GPIODriver::Options &options) {
+  if (options.gpio_chip.empty()) {
+    return new SysfsGPIOLines(options.gpio_pins);
+  }
+  return new CharDevGPIOLines(options.gpio_chip, options.gpio_pins);
+}
+}  // namespace
+
 GPIOOutputPort::GPIOOutputPort(GPIODevice *parent,
                                const GPIODriver::Options &options)
     : BasicOutputPort(parent, 1),
-      m_driver(new GPIODriver(options)) {
+      m_driver(new GPIODriver(NewGPIOLines(options), options)) {
 }
 
 bool GPIOOutputPort::Init() {
@@ -46,7 +56,16 @@ bool GPIOOutputPort::Init() {
 
 string GPIOOutputPort::Description() const {
   vector<uint16_t> pins = m_driver->PinList();
-  return "Pins " + ola::StringJoin(", ", pins);
+  GPIODriver::Stats stats = m_driver->GetStats();
+  std::ostringstream str;
+  str << "Pins " << ola::StringJoin(", ", pins) << " ("
+      << m_driver->BackendDescription() << "), " << stats.update_rate
+      << " updates/s";
+  if (stats.max_jitter) {
+    str << ", jitter " << stats.mean_jitter << "us mean, "
+        << stats.max_jitter << "us max";
+  }
+  return str.str();
 }
 
 bool GPIOOutputPort::WriteDMX(const DmxBuffer &buffer,
@@ -7,7 +7,9 @@ lib_LTLIBRARIES += plugins/gpio/libolagpiocore.la \
 # This is a library which isn't coupled to olad
 plugins_gpio_libolagpiocore_la_SOURCES = \
     plugins/gpio/GPIODriver.cpp \
-    plugins/gpio/GPIODriver.h
+    plugins/gpio/GPIODriver.h \
+    plugins/gpio/GPIOLines.cpp \
+    plugins/gpio/GPIOLines.h
 plugins_gpio_libolagpiocore_la_LIBADD = common/libolacommon.la
 
 # Plugin description is generated from README.md
@@ -28,6 +30,19 @@ plugins_gpio_libolagpio_la_LIBADD = \
     common/libolacommon.la \
     olad/plugin_api/libolaserverplugininterface.la \
     plugins/gpio/libolagpiocore.la
+
+# TESTS
+##################################################
+test_programs += plugins/gpio/GPIOTester
+
+plugins_gpio_GPIOTester_SOURCES = \
+    plugins/gpio/FakeGPIOLines.cpp \
+    plugins/gpio/FakeGPIOLines.h \
+    plugins/gpio/GPIODriverTest.cpp
+plugins_gpio_GPIOTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
+plugins_gpio_GPIOTester_LDADD = $(COMMON_TESTING_LIBS) \
+                                plugins/gpio/libolagpiocore.la \
+                                common/libolacommon.la
 endif
 
 EXTRA_DIST += plugins/gpio/README.md
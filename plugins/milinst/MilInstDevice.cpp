@@ -47,10 +47,12 @@ const char MilInstDevice::TYPE_1553[] = "1-553";
  * Create a new device
  *
  * @param owner  the plugin that owns this device
- * @param name  the device name
+ * @param ss  the SelectServer to use
+ * @param preferences  the plugin's preferences
  * @param dev_path  path to the pro widget
  */
 MilInstDevice::MilInstDevice(AbstractPlugin *owner,
+                             ola::io::SelectServerInterface *ss,
                              Preferences *preferences,
                              const string &dev_path)
     : Device(owner, MILINST_DEVICE_NAME),
@@ -63,9 +65,9 @@ MilInstDevice::MilInstDevice(AbstractPlugin *owner,
   OLA_DEBUG << "Got type " << type;
 
   if (type.compare(TYPE_1553) == 0) {
-    m_widget.reset(new MilInstWidget1553(m_path, m_preferences));
+    m_widget.reset(new MilInstWidget1553(ss, m_path, m_preferences));
   } else {
-    m_widget.reset(new MilInstWidget1463(m_path));
+    m_widget.reset(new MilInstWidget1463(ss, m_path));
   }
 }
 
@@ -60,7 +60,8 @@ bool MilInstPlugin::StartHook() {
       continue;
     }
 
-    device = new MilInstDevice(this, m_preferences, *it);
+    device = new MilInstDevice(this, m_plugin_adaptor, m_preferences,
+                               *it);
     OLA_DEBUG << "Adding device " << *it;
 
     if (!device->Start()) {
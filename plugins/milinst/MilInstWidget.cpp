@@ -18,6 +18,8 @@
  * Copyright (C) 2013 Peter Newman
  */
 
+#include <string.h>
+
 #include <string>
 
 #include "ola/Logging.h"
@@ -34,6 +36,7 @@ using std::string;
  * New widget
  */
 MilInstWidget::~MilInstWidget() {
+  m_writer.reset();
   if (m_socket) {
     m_socket->Close();
     delete m_socket;
@@ -74,9 +77,31 @@ int MilInstWidget::ConnectToWidget(const string &path, speed_t speed) {
  * Disconnect from the widget
  */
 int MilInstWidget::Disconnect() {
+  m_writer.reset();
   m_socket->Close();
   return 0;
 }
+
+
+/*
+ * Send a DMX msg.
+ */
+bool MilInstWidget::SendDmx(const DmxBuffer &buffer) const {
+  // TODO(Peter): Probably add offset in here to send higher channels shifted
+  // down
+  if (!m_writer.get()) {
+    return false;
+  }
+  return m_writer->SendDmx(buffer);
+}
+
+
+void MilInstWidget::StartWriter(
+    ola::io::SerialFrameEncoder *encoder,
+    const ola::io::SerialFrameWriter::Options &options) {
+  m_writer.reset(new ola::io::SerialFrameWriter(m_ss, m_socket, encoder,
+                                                options));
+}
 }  // namespace milinst
 }  // namespace plugin
 }  // namespace ola
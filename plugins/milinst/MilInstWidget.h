@@ -23,9 +23,12 @@
 
 #include <fcntl.h>
 #include <termios.h>
+#include <memory>
+#include <sstream>
 #include <string>
 
-#include "ola/io/SelectServer.h"
+#include "common/io/SerialFrameWriter.h"
+#include "ola/io/SelectServerInterface.h"
 #include "ola/DmxBuffer.h"
 
 namespace ola {
@@ -36,8 +39,9 @@ class MilInstWidget {
  public:
   static int ConnectToWidget(const std::string &path, speed_t speed = B9600);
 
-  explicit MilInstWidget(const std::string &path)
+  MilInstWidget(ola::io::SelectServerInterface *ss, const std::string &path)
       : m_enabled(false),
+        m_ss(ss),
         m_path(path),
         m_socket(NULL) {}
 
@@ -53,19 +57,31 @@ class MilInstWidget {
   std::string Description() {
     std::ostringstream str;
     str << GetPath() << ", " << Type();
+    if (m_writer.get() && m_writer->MaxRefreshRate()) {
+      str << ", max " << m_writer->MaxRefreshRate() << " fps";
+    }
     return str.str();
   }
 
-  virtual bool SendDmx(const DmxBuffer &buffer) const = 0;
+  bool SendDmx(const DmxBuffer &buffer) const;
   virtual bool DetectDevice() = 0;
 
  protected:
-  virtual int SetChannel(unsigned int chan, uint8_t val) const = 0;
+  /**
+   * @brief Start writing frames to m_socket.
+   * @param encoder the encoder for the widget's protocol, ownership is
+   *   transferred.
+   * @param options the options for the SerialFrameWriter.
+   */
+  void StartWriter(ola::io::SerialFrameEncoder *encoder,
+                   const ola::io::SerialFrameWriter::Options &options);
 
   // instance variables
   bool m_enabled;
+  ola::io::SelectServerInterface *m_ss;
   const std::string m_path;
   ola::io::ConnectedDescriptor *m_socket;
+  std::auto_ptr<ola::io::SerialFrameWriter> m_writer;
 };
 }  // namespace milinst
 }  // namespace plugin
@@ -21,12 +21,37 @@
 #include <algorithm>
 
 #include "ola/Logging.h"
+#include "ola/io/Serial.h"
 #include "plugins/milinst/MilInstWidget1463.h"
 
 namespace ola {
 namespace plugin {
 namespace milinst {
 
+using ola::io::ByteString;
+using ola::io::SerialFrameWriter;
+
+/*
+ * The 1-463 takes (channel, value) pairs, so only the channels that changed
+ * are sent.
+ */
+class MilInstWidget1463::Encoder : public ola::io::SerialFrameEncoder {
+ public:
+  void Encode(const DmxBuffer &previous, const DmxBuffer &frame,
+              ByteString *output) {
+    unsigned int channels = std::min(
+        static_cast<unsigned int>(DMX_MAX_TRANSMIT_CHANNELS), frame.Size());
+    for (unsigned int i = 0; i < channels; i++) {
+      uint8_t value = frame.Get(i);
+      if (i < previous.Size() && previous.Get(i) == value) {
+        continue;
+      }
+      output->push_back(i + 1);
+      output->push_back(value);
+    }
+  }
+};
+
 /*
  * Connect to the widget
  */
@@ -40,6 +65,10 @@ bool MilInstWidget1463::Connect() {
 
   m_socket = new ola::io::DeviceDescriptor(fd);
 
+  SerialFrameWriter::Options options;
+  options.baud_rate = ola::io::BAUD_RATE_9600;
+  StartWriter(new Encoder(), options);
+
   OLA_DEBUG << "Connected to " << m_path;
   return true;
 }
@@ -53,53 +82,6 @@ bool MilInstWidget1463::DetectDevice() {
   // This device doesn't do two way comms, so just return true
   return true;
 }
-
-
-/*
- * Send a DMX msg.
-  */
-bool MilInstWidget1463::SendDmx(const DmxBuffer &buffer) const {
-  // TODO(Peter): Probably add offset in here to send higher channels shifted
-  // down
-  int bytes_sent = Send112(buffer);
-  OLA_DEBUG << "Sending DMX, sent " << bytes_sent << " bytes";
-  // Should this confirm we've sent more than 0 bytes and return false if not?
-  return true;
-}
-
-
-//-----------------------------------------------------------------------------
-// Private methods used for communicating with the widget
-/*
- * Set a single channel
- */
-int MilInstWidget1463::SetChannel(unsigned int chan, uint8_t val) const {
-  uint8_t msg[2];
-
-  msg[0] = chan;
-  msg[1] = val;
-  OLA_DEBUG << "Setting " << chan << " to " << static_cast<int>(val);
-  return m_socket->Send(msg, sizeof(msg));
-}
-
-
-/*
- * Send 112 channels worth of data
- * @param buffer a DmxBuffer with the data
- */
-int MilInstWidget1463::Send112(const DmxBuffer &buffer) const {
-  unsigned int channels = std::min((unsigned int) DMX_MAX_TRANSMIT_CHANNELS,
-                                   buffer.Size());
-  uint8_t msg[channels * 2];
-
-  for (unsigned int i = 0; i <= channels; i++) {
-    msg[i * 2] = i + 1;
-    msg[(i * 2) + 1] = buffer.Get(i);
-    OLA_DEBUG << "Setting " << (i + 1) << " to " <<
-        static_cast<int>(buffer.Get(i));
-  }
-  return m_socket->Send(msg, (channels * 2));
-}
 }  // namespace milinst
 }  // namespace plugin
 }  // namespace ola
@@ -31,17 +31,18 @@ namespace milinst {
 
 class MilInstWidget1463: public MilInstWidget {
  public:
-  explicit MilInstWidget1463(const std::string &path): MilInstWidget(path) {}
+  MilInstWidget1463(ola::io::SelectServerInterface *ss,
+                    const std::string &path)
+      : MilInstWidget(ss, path) {
+  }
   ~MilInstWidget1463() {}
 
   bool Connect();
   bool DetectDevice();
-  bool SendDmx(const DmxBuffer &buffer) const;
   std::string Type() { return "Milford Instruments 1-463 Widget"; }
 
  protected:
-  int SetChannel(unsigned int chan, uint8_t val) const;
-  int Send112(const DmxBuffer &buffer) const;
+  class Encoder;
 
   // This interface can only transmit 112 channels
   enum { DMX_MAX_TRANSMIT_CHANNELS = 112 };
@@ -33,6 +33,8 @@ namespace ola {
 namespace plugin {
 namespace milinst {
 
+using ola::io::ByteString;
+using ola::io::SerialFrameWriter;
 using std::set;
 using std::string;
 
@@ -44,9 +46,34 @@ const uint16_t MilInstWidget1553::CHANNELS_512 = 512;
 const uint16_t MilInstWidget1553::DEFAULT_CHANNELS = CHANNELS_128;
 
 
-MilInstWidget1553::MilInstWidget1553(const string &path,
+/*
+ * The 1-553 expects a load command followed by the configured number of
+ * channels, so every frame is sent in full.
+ */
+class MilInstWidget1553::Encoder : public ola::io::SerialFrameEncoder {
+ public:
+  explicit Encoder(uint16_t channels) : m_channels(channels) {}
+
+  void Encode(const DmxBuffer&, const DmxBuffer &frame,
+              ByteString *output) {
+    unsigned int channels = std::min(static_cast<unsigned int>(m_channels),
+                                     frame.Size());
+    uint8_t header[3];
+    header[0] = MILINST_1553_LOAD_COMMAND;
+    ola::utils::SplitUInt16(1, &header[1], &header[2]);
+    output->append(header, sizeof(header));
+    output->append(frame.GetRaw(), channels);
+  }
+
+ private:
+  const uint16_t m_channels;
+};
+
+
+MilInstWidget1553::MilInstWidget1553(ola::io::SelectServerInterface *ss,
+                                     const string &path,
                                      Preferences *preferences)
-    : MilInstWidget(path),
+    : MilInstWidget(ss, path),
       m_preferences(preferences) {
   SetWidgetDefaults();
 
@@ -69,6 +96,7 @@ bool MilInstWidget1553::Connect() {
       !ola::io::UIntToSpeedT(baudrate_int, &baudrate)) {
     OLA_DEBUG << "Invalid baudrate, defaulting to 9600";
     baudrate = DEFAULT_BAUDRATE;
+    baudrate_int = ola::io::BAUD_RATE_9600;
   }
 
   int fd = ConnectToWidget(m_path, baudrate);
@@ -81,6 +109,11 @@ bool MilInstWidget1553::Connect() {
   m_socket->SetOnData(
       NewCallback<MilInstWidget1553>(this, &MilInstWidget1553::SocketReady));
 
+  SerialFrameWriter::Options options;
+  options.baud_rate = baudrate_int;
+  options.full_frame_interval = 0;
+  StartWriter(new Encoder(m_channels), options);
+
   OLA_DEBUG << "Connected to " << m_path;
   return true;
 }
@@ -114,53 +147,6 @@ bool MilInstWidget1553::DetectDevice() {
 }
 
 
-/*
- * Send a DMX msg.
-  */
-bool MilInstWidget1553::SendDmx(const DmxBuffer &buffer) const {
-  // TODO(Peter): Probably add offset in here to send higher channels shifted
-  // down
-  int bytes_sent = Send(buffer);
-  OLA_DEBUG << "Sending DMX, sent " << bytes_sent << " bytes";
-  // Should this confirm we've sent more than 0 bytes and return false if not?
-  return true;
-}
-
-
-//-----------------------------------------------------------------------------
-// Private methods used for communicating with the widget
-/*
- * Set a single channel
- */
-int MilInstWidget1553::SetChannel(unsigned int chan, uint8_t val) const {
-  uint8_t msg[4];
-
-  msg[0] = MILINST_1553_LOAD_COMMAND;
-  ola::utils::SplitUInt16(chan, &msg[1], &msg[2]);
-  msg[3] = val;
-  OLA_DEBUG << "Setting " << chan << " to " << static_cast<int>(val);
-  return m_socket->Send(msg, sizeof(msg));
-}
-
-
-/*
- * Send data
- * @param buffer a DmxBuffer with the data
- */
-int MilInstWidget1553::Send(const DmxBuffer &buffer) const {
-  unsigned int channels = std::min(static_cast<unsigned int>(m_channels),
-                                   buffer.Size());
-  uint8_t msg[3 + channels];
-
-  msg[0] = MILINST_1553_LOAD_COMMAND;
-  ola::utils::SplitUInt16(1, &msg[1], &msg[2]);
-
-  buffer.Get(msg + 3, &channels);
-
-  return m_socket->Send(msg, sizeof(msg));
-}
-
-
 string MilInstWidget1553::BaudRateKey() const {
   return m_path + "-baudrate";
 }
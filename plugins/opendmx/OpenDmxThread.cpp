@@ -94,10 +94,8 @@ void *OpenDmxThread::Run() {
 
     } else {
       length = DMX_UNIVERSE_SIZE;
-      {
-        MutexLocker locker(&m_mutex);
-        m_buffer.Get(buffer + 1, &length);
-      }
+      m_buffer.Update();
+      m_buffer.ReadBuffer().Get(buffer + 1, &length);
 
       if (write(m_fd, buffer, length + 1) < 0) {
         // if you unplug the dongle
@@ -118,7 +116,7 @@ void *OpenDmxThread::Run() {
  */
 bool OpenDmxThread::Stop() {
   {
-    MutexLocker locker(&m_mutex);
+    MutexLocker locker(&m_term_mutex);
     m_term = true;
   }
   m_term_cond.Signal();
@@ -131,9 +129,9 @@ bool OpenDmxThread::Stop() {
  *
  */
 bool OpenDmxThread::WriteDmx(const DmxBuffer &buffer) {
-  MutexLocker locker(&m_mutex);
   // avoid the reference counting
-  m_buffer.Set(buffer);
+  m_buffer.WriteBuffer()->Set(buffer);
+  m_buffer.Publish();
   return true;
 }
 }  // namespace opendmx
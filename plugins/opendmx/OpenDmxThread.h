@@ -24,6 +24,7 @@
 #include <string>
 #include "ola/DmxBuffer.h"
 #include "ola/thread/Thread.h"
+#include "ola/thread/TripleBuffer.h"
 
 namespace ola {
 namespace plugin {
@@ -41,9 +42,8 @@ class OpenDmxThread: public ola::thread::Thread {
  private:
     int m_fd;
     std::string m_path;
-    DmxBuffer m_buffer;
+    ola::thread::TripleBuffer<DmxBuffer> m_buffer;
     bool m_term;
-    ola::thread::Mutex m_mutex;
     ola::thread::Mutex m_term_mutex;
     ola::thread::ConditionVariable m_term_cond;
 
@@ -52,10 +52,12 @@ const uint32_t RenardDevice::DEFAULT_BAUDRATE = ola::io::BAUD_RATE_57600;
  * Create a new device
  *
  * @param owner the plugin that owns this device
+ * @param ss the SelectServer to use
  * @param preferences config settings
  * @param dev_path path to the pro widget
  */
 RenardDevice::RenardDevice(AbstractPlugin *owner,
+                           ola::io::SelectServerInterface *ss,
                            class Preferences *preferences,
                            const string &dev_path)
     : Device(owner, RENARD_DEVICE_NAME),
@@ -82,8 +84,8 @@ RenardDevice::RenardDevice(AbstractPlugin *owner,
     baudrate = DEFAULT_BAUDRATE;
   }
 
-  m_widget.reset(new RenardWidget(m_dev_path, dmxOffset, channels, baudrate,
-                                  RENARD_START_ADDRESS));
+  m_widget.reset(new RenardWidget(ss, m_dev_path, dmxOffset, channels,
+                                  baudrate, RENARD_START_ADDRESS));
 
   OLA_DEBUG << "DMX offset set to " << static_cast<int>(dmxOffset);
   OLA_DEBUG << "Channels set to " << static_cast<int>(channels);
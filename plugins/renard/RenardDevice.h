@@ -24,6 +24,7 @@
 #include <memory>
 #include <string>
 
+#include "ola/io/SelectServerInterface.h"
 #include "olad/Device.h"
 
 namespace ola {
@@ -36,6 +37,7 @@ namespace renard {
 class RenardDevice: public ola::Device {
  public:
     RenardDevice(AbstractPlugin *owner,
+                 ola::io::SelectServerInterface *ss,
                  class Preferences *preferences,
                  const std::string &dev_path);
     ~RenardDevice();
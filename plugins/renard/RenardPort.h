@@ -39,7 +39,7 @@ class RenardOutputPort: public BasicOutputPort {
           m_widget(widget) {}
 
     bool WriteDMX(const DmxBuffer &buffer, uint8_t priority);
-    std::string Description() const { return m_widget->GetPath(); }
+    std::string Description() const { return m_widget->Description(); }
 
  private:
     RenardWidget *m_widget;
@@ -18,7 +18,10 @@
  * Copyright (C) 2013 Hakan Lindestaf
  */
 
+#include <string.h>
+
 #include <algorithm>
+#include <sstream>
 #include <string>
 
 #include "ola/Logging.h"
@@ -30,6 +33,8 @@ namespace ola {
 namespace plugin {
 namespace renard {
 
+using ola::io::ByteString;
+using ola::io::SerialFrameWriter;
 using std::string;
 
 // Based on standard Renard firmware
@@ -44,10 +49,113 @@ const uint8_t RenardWidget::RENARD_CHANNELS_IN_BANK = 8;
 // Discussions on the Renard firmware recommended a padding each 100 bytes or so
 const uint32_t RenardWidget::RENARD_BYTES_BETWEEN_PADDING = 100;
 
+/*
+ * Renard packets address a single bank, so only the banks that changed need
+ * to be sent.
+ */
+class RenardWidget::RenardEncoder : public ola::io::SerialFrameEncoder {
+ public:
+  RenardEncoder(uint32_t dmx_offset, uint32_t channels, uint8_t start_address)
+      : m_dmx_offset(dmx_offset),
+        m_channels(channels),
+        m_start_address(start_address),
+        m_byte_counter(0) {
+  }
+
+  void Encode(const DmxBuffer &previous, const DmxBuffer &frame,
+              ByteString *output);
+
+ private:
+  const uint32_t m_dmx_offset;
+  const uint32_t m_channels;
+  const uint8_t m_start_address;
+  uint32_t m_byte_counter;
+
+  bool BankChanged(const DmxBuffer &previous, const DmxBuffer &frame,
+                   unsigned int start, unsigned int end) const;
+  void AppendSlot(uint8_t value, ByteString *output);
+};
+
+void RenardWidget::RenardEncoder::Encode(const DmxBuffer &previous,
+                                         const DmxBuffer &frame,
+                                         ByteString *output) {
+  if (frame.Size() <= m_dmx_offset) {
+    return;
+  }
+  const unsigned int channels = std::min(m_channels,
+                                         frame.Size() - m_dmx_offset);
+
+  for (unsigned int start = 0; start < channels;
+       start += RENARD_CHANNELS_IN_BANK) {
+    const unsigned int end = std::min(
+        start + RENARD_CHANNELS_IN_BANK, channels);
+    if (!BankChanged(previous, frame, start, end)) {
+      continue;
+    }
+
+    if (m_byte_counter >= RENARD_BYTES_BETWEEN_PADDING) {
+      // Send PAD every 100 (or so) bytes. Note that the counter is per
+      // device, so the counter should span multiple frames.
+      output->push_back(RENARD_COMMAND_PAD);
+      m_byte_counter = 0;
+    }
+
+    // Send address
+    output->push_back(RENARD_COMMAND_START_PACKET);
+    output->push_back(m_start_address + (start / RENARD_CHANNELS_IN_BANK));
+    m_byte_counter += 2;
+
+    for (unsigned int i = start; i < end; i++) {
+      AppendSlot(frame.Get(m_dmx_offset + i), output);
+    }
+  }
+}
+
+bool RenardWidget::RenardEncoder::BankChanged(const DmxBuffer &previous,
+                                              const DmxBuffer &frame,
+                                              unsigned int start,
+                                              unsigned int end) const {
+  for (unsigned int i = start; i < end; i++) {
+    const unsigned int slot = m_dmx_offset + i;
+    if (slot >= previous.Size() || previous.Get(slot) != frame.Get(slot)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void RenardWidget::RenardEncoder::AppendSlot(uint8_t value,
+                                             ByteString *output) {
+  // Escaping magic bytes
+  switch (value) {
+    case RENARD_COMMAND_PAD:
+      output->push_back(RENARD_COMMAND_ESCAPE);
+      output->push_back(RENARD_ESCAPE_PAD);
+      m_byte_counter += 2;
+      break;
+    case RENARD_COMMAND_START_PACKET:
+      output->push_back(RENARD_COMMAND_ESCAPE);
+      output->push_back(RENARD_ESCAPE_START_PACKET);
+      m_byte_counter += 2;
+      break;
+    case RENARD_COMMAND_ESCAPE:
+      output->push_back(RENARD_COMMAND_ESCAPE);
+      output->push_back(RENARD_ESCAPE_ESCAPE);
+      m_byte_counter += 2;
+      break;
+    default:
+      output->push_back(value);
+      m_byte_counter++;
+      break;
+  }
+}
+
+
 /*
  * New widget
  */
 RenardWidget::~RenardWidget() {
+  m_writer.reset();
   if (m_socket) {
     m_socket->Close();
     delete m_socket;
@@ -74,6 +182,13 @@ bool RenardWidget::Connect() {
 
   m_socket = new ola::io::DeviceDescriptor(fd);
 
+  SerialFrameWriter::Options options;
+  options.baud_rate = m_baudrate;
+  m_writer.reset(new SerialFrameWriter(
+      m_ss, m_socket,
+      new RenardEncoder(m_dmxOffset, m_channels, m_startAddress),
+      options));
+
   OLA_DEBUG << "Connected to " << m_path;
   return true;
 }
@@ -112,6 +227,7 @@ int RenardWidget::ConnectToWidget(const string &path, speed_t speed) {
  * Disconnect from the widget
  */
 int RenardWidget::Disconnect() {
+  m_writer.reset();
   m_socket->Close();
   return 0;
 }
@@ -128,76 +244,27 @@ bool RenardWidget::DetectDevice() {
 
 
 /*
- * Send a DMX msg.
+ * Return the path and, once a frame has been sent, the refresh rate the baud
+ * rate allows.
  */
-bool RenardWidget::SendDmx(const DmxBuffer &buffer) {
-  unsigned int channels = std::max((unsigned int)0,
-                                   std::min((unsigned int) m_channels +
-                                            m_dmxOffset, buffer.Size()) -
-                                   m_dmxOffset);
-
-  OLA_DEBUG << "Sending " << static_cast<int>(channels) << " channels";
-
-  // Max buffer size for worst case scenario (escaping + padding)
-  unsigned int bufferSize = channels * 2 + 10;
-  uint8_t msg[bufferSize];
-
-  int dataToSend = 0;
-
-  for (unsigned int i = 0; i < channels; i++) {
-    if ((i % RENARD_CHANNELS_IN_BANK) == 0) {
-      if (m_byteCounter >= RENARD_BYTES_BETWEEN_PADDING) {
-        // Send PAD every 100 (or so) bytes. Note that the counter is per
-        // device, so the counter should span multiple calls to SendDMX.
-        msg[dataToSend++] = RENARD_COMMAND_PAD;
-        m_byteCounter = 0;
-      }
-
-      // Send address
-      msg[dataToSend++] = RENARD_COMMAND_START_PACKET;
-      msg[dataToSend++] = m_startAddress + (i / RENARD_CHANNELS_IN_BANK);
-      m_byteCounter += 2;
-    }
-
-    uint8_t b = buffer.Get(m_dmxOffset + i);
-
-    // Escaping magic bytes
-    switch (b) {
-      case RENARD_COMMAND_PAD:
-        msg[dataToSend++] = RENARD_COMMAND_ESCAPE;
-        msg[dataToSend++] = RENARD_ESCAPE_PAD;
-        m_byteCounter += 2;
-        break;
-
-      case RENARD_COMMAND_START_PACKET:
-        msg[dataToSend++] = RENARD_COMMAND_ESCAPE;
-        msg[dataToSend++] = RENARD_ESCAPE_START_PACKET;
-        m_byteCounter += 2;
-        break;
-
-      case RENARD_COMMAND_ESCAPE:
-        msg[dataToSend++] = RENARD_COMMAND_ESCAPE;
-        msg[dataToSend++] = RENARD_ESCAPE_ESCAPE;
-        m_byteCounter += 2;
-        break;
-
-      default:
-        msg[dataToSend++] = b;
-        m_byteCounter++;
-        break;
-    }
-
-    OLA_DEBUG << "Setting Renard " << m_startAddress +
-      (i / RENARD_CHANNELS_IN_BANK) << "/" <<
-      ((i % RENARD_CHANNELS_IN_BANK) + 1) << " to " <<
-      static_cast<int>(b);
+string RenardWidget::Description() const {
+  std::ostringstream str;
+  str << m_path;
+  if (m_writer.get() && m_writer->MaxRefreshRate()) {
+    str << ", max " << m_writer->MaxRefreshRate() << " fps";
   }
+  return str.str();
+}
 
-  int bytes_sent = m_socket->Send(msg, dataToSend);
-
-  OLA_DEBUG << "Sending DMX, sent " << bytes_sent << " bytes";
 
-  return true;
+/*
+ * Send a DMX msg.
+ */
+bool RenardWidget::SendDmx(const DmxBuffer &buffer) {
+  if (!m_writer.get()) {
+    return false;
+  }
+  return m_writer->SendDmx(buffer);
 }
 }  // namespace renard
 }  // namespace plugin
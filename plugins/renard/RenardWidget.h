@@ -23,9 +23,11 @@
 
 #include <fcntl.h>
 #include <termios.h>
+#include <memory>
 #include <string>
 
-#include "ola/io/SelectServer.h"
+#include "common/io/SerialFrameWriter.h"
+#include "ola/io/SelectServerInterface.h"
 #include "ola/io/Serial.h"
 #include "ola/DmxBuffer.h"
 
@@ -50,14 +52,15 @@ class RenardWidget {
     // default in the standard firmware is 0x80, and it may be a reasonable
     // future feature request to have this configurable for more advanced
     // Renard configurations (using wireless transmitters, etc).
-    explicit RenardWidget(const std::string &path,
-                          int dmxOffset,
-                          int channels,
-                          uint32_t baudrate,
-                          uint8_t startAddress)
-      : m_path(path),
+    RenardWidget(ola::io::SelectServerInterface *ss,
+                 const std::string &path,
+                 int dmxOffset,
+                 int channels,
+                 uint32_t baudrate,
+                 uint8_t startAddress)
+      : m_ss(ss),
+        m_path(path),
         m_socket(NULL),
-        m_byteCounter(0),
         m_dmxOffset(dmxOffset),
         m_channels(channels),
         m_baudrate(baudrate),
@@ -69,18 +72,22 @@ class RenardWidget {
     int Disconnect();
     ola::io::ConnectedDescriptor *GetSocket() { return m_socket; }
     std::string GetPath() { return m_path; }
+    std::string Description() const;
     bool SendDmx(const DmxBuffer &buffer);
     bool DetectDevice();
 
     static const uint8_t RENARD_CHANNELS_IN_BANK;
 
  private:
+    class RenardEncoder;
+
     int ConnectToWidget(const std::string &path, speed_t speed);
 
     // instance variables
+    ola::io::SelectServerInterface *m_ss;
     const std::string m_path;
     ola::io::ConnectedDescriptor *m_socket;
-    uint32_t m_byteCounter;
+    std::auto_ptr<ola::io::SerialFrameWriter> m_writer;
     uint32_t m_dmxOffset;
     uint32_t m_channels;
     uint32_t m_baudrate;
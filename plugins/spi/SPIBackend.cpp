@@ -71,10 +71,6 @@ uint8_t *HardwareBackend::OutputData::Resize(unsigned int length) {
   return m_data;
 }
 
-void HardwareBackend::OutputData::SetPending() {
-  m_write_pending = true;
-}
-
 void HardwareBackend::OutputData::SetLatchBytes(unsigned int latch_bytes) {
   m_latch_bytes = latch_bytes;
 }
@@ -86,9 +82,6 @@ HardwareBackend::OutputData& HardwareBackend::OutputData::operator=(
     if (data) {
       memcpy(data, other.m_data, other.m_size);
       memset(data + other.m_size, 0, other.m_latch_bytes);
-      m_write_pending = true;
-    } else {
-      m_write_pending = false;
     }
   }
   return *this;
@@ -101,8 +94,13 @@ HardwareBackend::HardwareBackend(const Options &options,
       m_drop_map(NULL),
       m_output_count(1 << options.gpio_pins.size()),
       m_exit(false),
+      m_defer_writes(options.defer_writes),
+      m_flush_pending(false),
       m_gpio_pins(options.gpio_pins) {
-  SetupOutputs(&m_output_data);
+  for (unsigned int i = 0; i < m_output_count; i++) {
+    m_output_data.push_back(new OutputData());
+    m_output_frames.push_back(new OutputFrames());
+  }
   if (export_map) {
     m_drop_map = export_map->GetUIntMapVar(SPI_DROP_VAR,
                                            SPI_DROP_VAR_KEY);
@@ -121,6 +119,7 @@ HardwareBackend::~HardwareBackend() {
   Join();
 
   STLDeleteElements(&m_output_data);
+  STLDeleteElements(&m_output_frames);
   CloseGPIOFDs();
 }
 
@@ -143,14 +142,8 @@ uint8_t *HardwareBackend::Checkout(uint8_t output_id,
     return NULL;
   }
 
-  m_mutex.Lock();
   uint8_t *output = m_output_data[output_id]->Resize(length);
-  if (!output) {
-    m_mutex.Unlock();
-  }
   m_output_data[output_id]->SetLatchBytes(latch_bytes);
-  // We return with the Mutex locked, the caller must then call Commit()
-  // coverity[LOCK]
   return output;
 }
 
@@ -159,72 +152,69 @@ void HardwareBackend::Commit(uint8_t output) {
     return;
   }
 
-  OutputData *output_data = m_output_data[output];
-  if (output_data->IsPending() && m_drop_map) {
+  // Copy the data, with the latch bytes, into a free slot.
+  OutputFrames *frames = m_output_frames[output];
+  *frames->WriteBuffer() = *m_output_data[output];
+  if (frames->Publish() && m_drop_map) {
     // There was already another write pending which we're now stomping on
     (*m_drop_map)[m_spi_writer->DevicePath()]++;
   }
-  output_data->SetPending();
-  m_mutex.Unlock();
-  m_cond_var.Signal();
+
+  if (m_defer_writes) {
+    m_flush_pending = true;
+  } else {
+    WakeOutputThread();
+  }
 }
 
-void *HardwareBackend::Run() {
-  Outputs outputs;
-  SetupOutputs(&outputs);
+void HardwareBackend::Flush() {
+  if (m_flush_pending) {
+    m_flush_pending = false;
+    WakeOutputThread();
+  }
+}
 
+void *HardwareBackend::Run() {
   while (true) {
-    m_mutex.Lock();
-
-    if (m_exit) {
-      m_mutex.Unlock();
-      STLDeleteElements(&outputs);
-      return NULL;
-    }
-
-    bool action_pending = false;
-    Outputs::const_iterator iter = m_output_data.begin();
-    for (; iter != m_output_data.end(); ++iter) {
-      if ((*iter)->IsPending()) {
-        action_pending = true;
-        break;
+    {
+      MutexLocker lock(&m_mutex);
+      while (!m_exit && !FramePending()) {
+        m_cond_var.Wait(&m_mutex);
       }
-    }
-    if (!action_pending) {
-      m_cond_var.Wait(&m_mutex);
-    }
-
-    if (m_exit) {
-      m_mutex.Unlock();
-      STLDeleteElements(&outputs);
-      return NULL;
-    }
-
-    for (unsigned int i = 0; i < m_output_data.size(); i++) {
-      if (m_output_data[i]->IsPending()) {
-        // take a copy
-        *outputs[i] = *m_output_data[i];
-        m_output_data[i]->ResetPending();
+      if (m_exit) {
+        return NULL;
       }
     }
-    m_mutex.Unlock();
 
-    for (unsigned int i = 0; i < outputs.size(); i++) {
-      if (outputs[i]->IsPending()) {
-        WriteOutput(i, outputs[i]);
-        outputs[i]->ResetPending();
+    for (unsigned int i = 0; i < m_output_frames.size(); i++) {
+      if (m_output_frames[i]->Update()) {
+        WriteOutput(i, m_output_frames[i]->ReadBuffer());
       }
     }
   }
 }
 
-void HardwareBackend::SetupOutputs(Outputs *outputs) {
-  for (unsigned int i = 0; i < m_output_count; i++) {
-    outputs->push_back(new OutputData());
+void HardwareBackend::WakeOutputThread() {
+  {
+    // The output thread checks for frames with the mutex held, so this
+    // ensures it's either seen the frame or is waiting on the condition.
+    MutexLocker lock(&m_mutex);
+  }
+  m_cond_var.Signal();
+}
+
+bool HardwareBackend::FramePending() const {
+  std::vector<OutputFrames*>::const_iterator iter = m_output_frames.begin();
+  for (; iter != m_output_frames.end(); ++iter) {
+    if ((*iter)->HasUpdate()) {
+      return true;
+    }
   }
+  return false;
 }
 
-void HardwareBackend::WriteOutput(uint8_t output_id, OutputData *output) {
+void HardwareBackend::WriteOutput(uint8_t output_id,
+                                  const OutputData &output) {
   const string on("1");
   const string off("0");
 
@@ -247,7 +237,7 @@ void HardwareBackend::WriteOutput(uint8_t output_id, OutputData *output) {
     }
   }
 
-  m_spi_writer->WriteSPIData(output->GetData(), output->Size());
+  m_spi_writer->WriteSPIData(output.GetData(), output.Size());
 }
 
 bool HardwareBackend::SetupGPIO() {
@@ -24,6 +24,7 @@
 
 #include <stdint.h>
 #include <ola/thread/Mutex.h>
+#include <ola/thread/TripleBuffer.h>
 #include <ola/thread/Thread.h>
 #include <string>
 #include <vector>
@@ -47,6 +48,13 @@ class SPIBackendInterface {
                             unsigned int latch_bytes) = 0;
   virtual void Commit(uint8_t output) = 0;
 
+  /**
+   * @brief Called once a set of outputs have been committed together.
+   *
+   * Backends which defer writes start them here.
+   */
+  virtual void Flush() = 0;
+
   virtual std::string DevicePath() const = 0;
 
   virtual bool Init() = 0;
@@ -67,6 +75,11 @@ class HardwareBackend : public ola::thread::Thread,
     // Which GPIO bits to use to select the output. The number of outputs
     // will be 2 ** gpio_pins.size();
     std::vector<uint16_t> gpio_pins;
+    // If true, committed outputs aren't written until Flush() is called, so
+    // all the outputs in a frame are written together.
+    bool defer_writes;
+
+    Options() : defer_writes(false) {}
   };
 
   HardwareBackend(const Options &options,
@@ -84,6 +97,7 @@ class HardwareBackend : public ola::thread::Thread,
                     unsigned int length,
                     unsigned int latch_bytes);
   void Commit(uint8_t output);
+  void Flush();
 
   std::string DevicePath() const { return m_spi_writer->DevicePath(); }
 
@@ -95,7 +109,6 @@ class HardwareBackend : public ola::thread::Thread,
    public:
     OutputData()
         : m_data(NULL),
-          m_write_pending(false),
           m_size(0),
           m_actual_size(0),
           m_latch_bytes(0) {
@@ -105,9 +118,6 @@ class HardwareBackend : public ola::thread::Thread,
 
     uint8_t *Resize(unsigned int length);
     void SetLatchBytes(unsigned int latch_bytes);
-    void SetPending();
-    bool IsPending() const { return m_write_pending; }
-    void ResetPending() { m_write_pending = false; }
     const uint8_t *GetData() const { return m_data; }
     unsigned int Size() const { return m_size; }
 
@@ -115,7 +125,6 @@ class HardwareBackend : public ola::thread::Thread,
 
    private:
     uint8_t *m_data;
-    bool m_write_pending;
     unsigned int m_size;
     unsigned int m_actual_size;
     unsigned int m_latch_bytes;
@@ -125,23 +134,31 @@ class HardwareBackend : public ola::thread::Thread,
 
   typedef std::vector<int> GPIOFds;
   typedef std::vector<OutputData*> Outputs;
+  typedef ola::thread::TripleBuffer<OutputData> OutputFrames;
 
   SPIWriterInterface *m_spi_writer;
   UIntMap *m_drop_map;
   const uint8_t m_output_count;
+  // Only used to wake the output thread when it's idle.
   ola::thread::Mutex m_mutex;
   ola::thread::ConditionVariable m_cond_var;
   bool m_exit;
+  const bool m_defer_writes;
+  bool m_flush_pending;
 
+  // The data for each output, owned by the caller of Checkout() / Commit().
   Outputs m_output_data;
+  // Committed frames, handed to the output thread.
+  std::vector<OutputFrames*> m_output_frames;
 
   // GPIO members
   GPIOFds m_gpio_fds;
   const std::vector<uint16_t> m_gpio_pins;
   std::vector<bool> m_gpio_pin_state;
 
-  void SetupOutputs(Outputs *outputs);
-  void WriteOutput(uint8_t output_id, OutputData *output);
+  bool FramePending() const;
+  void WakeOutputThread();
+  void WriteOutput(uint8_t output_id, const OutputData &output);
   bool SetupGPIO();
   void CloseGPIOFDs();
 };
@@ -184,6 +201,8 @@ class SoftwareBackend : public SPIBackendInterface,
                     unsigned int length,
                     unsigned int latch_bytes);
   void Commit(uint8_t output);
+  // The sync output controls when we write.
+  void Flush() {}
 
   std::string DevicePath() const { return m_spi_writer->DevicePath(); }
 
@@ -224,6 +243,7 @@ class FakeSPIBackend : public SPIBackendInterface {
                     unsigned int latch_bytes);
 
   void Commit(uint8_t output);
+  void Flush() {}
   const uint8_t *GetData(uint8_t output, unsigned int *length);
 
   std::string DevicePath() const { return "/dev/test"; }
@@ -41,6 +41,7 @@ class SPIBackendTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(SPIBackendTest);
   CPPUNIT_TEST(testHardwareDrops);
   CPPUNIT_TEST(testHardwareVariousFrameLengths);
+  CPPUNIT_TEST(testHardwareDeferredWrites);
   CPPUNIT_TEST(testInvalidOutputs);
   CPPUNIT_TEST(testSoftwareDrops);
   CPPUNIT_TEST(testSoftwareVariousFrameLengths);
@@ -60,6 +61,7 @@ class SPIBackendTest: public CppUnit::TestFixture {
 
   void testHardwareDrops();
   void testHardwareVariousFrameLengths();
+  void testHardwareDeferredWrites();
   void testInvalidOutputs();
   void testSoftwareDrops();
   void testSoftwareVariousFrameLengths();
@@ -226,6 +228,33 @@ void SPIBackendTest::testHardwareVariousFrameLengths() {
   m_writer.ResetWrite();
 }
 
+/**
+ * Check that deferred writes are sent when the backend is flushed.
+ */
+void SPIBackendTest::testHardwareDeferredWrites() {
+  HardwareBackend::Options options;
+  options.defer_writes = true;
+  HardwareBackend backend(options, &m_writer, &m_export_map);
+  OLA_ASSERT(backend.Init());
+
+  // Nothing pending, so this doesn't write anything.
+  backend.Flush();
+
+  OLA_ASSERT(SendSomeData(&backend, 0, DATA1, arraysize(DATA1), m_total_size));
+  backend.Flush();
+  m_writer.WaitForWrite();
+  OLA_ASSERT_EQ(1u, m_writer.WriteCount());
+  m_writer.CheckDataMatches(OLA_SOURCELINE(), EXPECTED1, arraysize(EXPECTED1));
+  m_writer.ResetWrite();
+
+  OLA_ASSERT(SendSomeData(&backend, 0, DATA3, arraysize(DATA3), m_total_size));
+  backend.Flush();
+  m_writer.WaitForWrite();
+  OLA_ASSERT_EQ(2u, m_writer.WriteCount());
+  m_writer.CheckDataMatches(OLA_SOURCELINE(), DATA3, arraysize(DATA3));
+  OLA_ASSERT_EQ(0u, DropCount());
+}
+
 /**
  * Check we can't send to invalid outputs.
  */
@@ -263,6 +263,8 @@ void SPIDevice::PopulateHardwareBackendOptions(
 
     options->gpio_pins.push_back(pin);
   }
+  // CommitFrame() flushes the outputs.
+  options->defer_writes = true;
 }
 
 void SPIDevice::PopulateSoftwareBackendOptions(
@@ -48,6 +48,8 @@ class SPIDevice: public ola::Device {
   std::string DeviceId() const;
 
   bool AllowMultiPortPatching() const { return true; }
+  bool SupportsFrameCommit() const { return true; }
+  void CommitFrame() { m_backend->Flush(); }
 
  protected:
   bool StartHook();
@@ -960,6 +960,8 @@ RDMResponse *SPIOutput::SetIdentify(const RDMRequest *request) {
       identify_buffer.Blackout();
     }
     InternalWriteDMX(identify_buffer);
+    // This isn't part of a universe update, so nothing else will flush it.
+    m_backend->Flush();
   }
   return response;
 }
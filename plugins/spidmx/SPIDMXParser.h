@@ -22,6 +22,7 @@
 #ifndef PLUGINS_SPIDMX_SPIDMXPARSER_H_
 #define PLUGINS_SPIDMX_SPIDMXPARSER_H_
 
+#include "common/dmx/SignalDecoder.h"
 #include "ola/Callback.h"
 #include "ola/DmxBuffer.h"
 #include "ola/base/Macro.h"
@@ -32,83 +33,25 @@ namespace spidmx {
 
 class SPIDMXParser {
  public:
-  SPIDMXParser(DmxBuffer *buffer, Callback0<void> *callback)
-    : m_dmx_buffer(buffer),
-      m_callback(callback),
-      m_state(WAIT_FOR_BREAK),   // reset in ChangeState()
-      m_chunk(NULL),             // reset in ParseDmx()
-      m_chunk_spi_bytecount(0),  // first reset in ParseDmx()
-      m_state_spi_bitcount(0),   // first reset in ChangeState()
-      m_current_dmx_value(0),    // first reset in InDataStartbit()
-      m_channel_count(0),        // first reset in ChangeState()
-      m_sampling_position(0) {   // reset in InDataStartbit()
-  }
+  SPIDMXParser(DmxBuffer *buffer, Callback0<void> *callback,
+               unsigned int sample_rate);
+
   void ParseDmx(uint8_t *buffer, uint64_t chunksize);
   void SetCallback(Callback0<void> *callback) {
     m_callback = callback;
   }
 
  private:
-  typedef enum {
-    WAIT_FOR_BREAK,
-    IN_BREAK,
-    WAIT_FOR_MAB,
-    IN_MAB,
-    IN_STARTCODE,
-    IN_STARTCODE_STOPBITS,
-    IN_DATA_STARTBIT,
-    IN_DATA_BITS,
-    IN_DATA_STOPBITS
-  } dmx_state_t;
-
-  // helper functions
-  int8_t DetectFallingEdge(uint8_t byte);
-  int8_t DetectRisingEdge(uint8_t byte);
-
-  void ChangeState(SPIDMXParser::dmx_state_t new_state);
-  void PacketComplete();
-
-  // handle one state each
-  void WaitForBreak();
-  void InBreak();
-  void WaitForMab();
-  void InMab();
-  void InStartcode();
-  void InStartcodeStopbits();
-  void InDataStartbit();
-  void InDataBits();
-  void InLastDataBit();
-  void InDataStopbits();
-
   /** a DmxBuffer that is filled and returned when ready */
   DmxBuffer *m_dmx_buffer;
 
   /** The callback to call when a packet end is detected or the chunk ends */
   Callback0<void> *m_callback;
 
-  /** current state */
-  SPIDMXParser::dmx_state_t m_state;
-
-  /** the raw SPI data */
-  uint8_t *m_chunk;
-
-  /** the current SPI byte */
-  uint64_t m_chunk_spi_bytecount;
-
-  /**
-   * Count how many SPI bits the current state is already active. Not used
-   * in all states.
-   */
-  uint64_t m_state_spi_bitcount;
-
-  /** The current DMX channel value (gets assembled from multiple SPI bytes) */
-  uint8_t m_current_dmx_value;
-
-  /** The current DMX channel count */
-  int16_t m_channel_count;
+  /** Decodes the frames from the raw SPI data */
+  ola::dmx::SignalDecoder m_decoder;
 
-  /** The currently used bit offset to sample the DMX bits */
-  uint8_t m_sampling_position;
+  void FrameReceived(const uint8_t *data, unsigned int length);
 
   DISALLOW_COPY_AND_ASSIGN(SPIDMXParser);
 };
@@ -78,8 +78,8 @@ bool SPIDMXThread::Stop() {
  * Copy a DmxBuffer to the output thread
  */
 bool SPIDMXThread::WriteDMX(const DmxBuffer &buffer) {
-  ola::thread::MutexLocker locker(&m_buffer_mutex);
-  m_dmx_tx_buffer.Set(buffer);
+  m_dmx_tx_buffer.WriteBuffer()->Set(buffer);
+  m_dmx_tx_buffer.Publish();
   return true;
 }
 
@@ -119,8 +119,6 @@ bool SPIDMXThread::SetReceiveCallback(Callback0<void> *callback) {
  * The method called by the thread
  */
 void *SPIDMXThread::Run() {
-  DmxBuffer dmx_buffer;
-
   uint8_t *spi_rx_ptr;
   uint8_t *spi_tx_ptr;
 
@@ -134,7 +132,8 @@ void *SPIDMXThread::Run() {
 
   // Setup the parser
   SPIDMXParser *parser = new SPIDMXParser(&m_dmx_rx_buffer,
-                                          m_receive_callback.get());
+                                          m_receive_callback.get(),
+                                          SPIDMXWidget::SPI_SPEED);
 
   while (1) {
     {
@@ -145,12 +144,10 @@ void *SPIDMXThread::Run() {
       }
     }
 
-    {
-      ola::thread::MutexLocker locker(&m_buffer_mutex);
-      dmx_buffer.Set(m_dmx_tx_buffer);
-    }
+    m_dmx_tx_buffer.Update();
 
-    // TODO(FloEdelmann) fill m_spi_tx_buffer with the values from dmx_buffer
+    // TODO(FloEdelmann) fill m_spi_tx_buffer with the values from
+    //                   m_dmx_tx_buffer.ReadBuffer()
     //                   (each bit repeated 8 times)
 
     // vectors store their contents contiguously,
@@ -28,6 +28,7 @@
 #include "ola/DmxBuffer.h"
 #include "ola/base/Macro.h"
 #include "ola/thread/Thread.h"
+#include "ola/thread/TripleBuffer.h"
 
 namespace ola {
 namespace plugin {
@@ -59,7 +60,7 @@ class SPIDMXThread : public ola::thread::Thread {
   /** receive DMX buffer to give to InputPort's callback */
   DmxBuffer m_dmx_rx_buffer;
   /** transmit DMX buffer that is set from WriteDMX */
-  DmxBuffer m_dmx_tx_buffer;
+  ola::thread::TripleBuffer<DmxBuffer> m_dmx_tx_buffer;
 
   /** receive buffer with raw SPI bytes */
   std::vector<uint8_t> m_spi_rx_buffer;
@@ -70,7 +71,6 @@ class SPIDMXThread : public ola::thread::Thread {
   std::auto_ptr<Callback0<void> > m_receive_callback;
 
   ola::thread::Mutex m_term_mutex;
-  ola::thread::Mutex m_buffer_mutex;
 
   DISALLOW_COPY_AND_ASSIGN(SPIDMXThread);
 };
@@ -68,6 +68,9 @@ class SPIDMXWidget {
   /** Setup device for DMX Output **/
   bool SetupOutput();
 
+  /** SPI sample frequency (2MHz) = 8x DMX frequency (250kHz) */
+  static const uint32_t SPI_SPEED = 2000000;
+
  private:
   const std::string m_path;
 
@@ -83,9 +86,6 @@ class SPIDMXWidget {
   /** Constant value for failed to open file */
   static const int FAILED_OPEN = -1;
 
-  /** SPI sample frequency (2MHz) = 8x DMX frequency (250kHz) */
-  static const uint32_t SPI_SPEED = 2000000;
-
   /** Don't delay after a read/write operation */
   static const uint16_t SPI_DELAY = 0;
 
@@ -29,13 +29,16 @@
 #include "ola/Callback.h"
 #include "ola/Logging.h"
 #include "ola/base/Array.h"
+#include "ola/io/Serial.h"
 #include "ola/util/Utils.h"
 
 namespace ola {
 namespace plugin {
 namespace stageprofi {
 
+using ola::io::ByteString;
 using ola::io::ConnectedDescriptor;
+using ola::io::SerialFrameWriter;
 using ola::TimeInterval;
 using ola::thread::INVALID_TIMEOUT;
 using std::string;
@@ -49,6 +52,41 @@ enum stageprofi_packet_type_e {
 
 typedef enum stageprofi_packet_type_e stageprofi_packet_type;
 
+/*
+ * Each SETDMX message carries a start address, so only the runs of channels
+ * that changed are sent.
+ */
+class StageProfiWidget::Encoder : public ola::io::SerialFrameEncoder {
+ public:
+  void Encode(const DmxBuffer &previous, const DmxBuffer &frame,
+              ByteString *output) {
+    SlotRanges ranges;
+    ChangedRanges(previous, frame, DMX_HEADER_SIZE, &ranges);
+    SlotRanges::const_iterator iter = ranges.begin();
+    for (; iter != ranges.end(); ++iter) {
+      unsigned int start = iter->start;
+      const unsigned int end = iter->start + iter->length;
+      while (start < end) {
+        unsigned int length = std::min(
+            static_cast<unsigned int>(DMX_MSG_LEN), end - start);
+        AppendSetDmx(start, frame.GetRaw() + start, length, output);
+        start += length;
+      }
+    }
+  }
+
+ private:
+  void AppendSetDmx(uint16_t start, const uint8_t *data, unsigned int length,
+                    ByteString *output) {
+    uint8_t header[DMX_HEADER_SIZE];
+    header[0] = ID_SETDMX;
+    ola::utils::SplitUInt16(start, &header[2], &header[1]);
+    header[3] = length;
+    output->append(header, sizeof(header));
+    output->append(data, length);
+  }
+};
+
 
 StageProfiWidget::StageProfiWidget(io::SelectServerInterface *ss,
                                    ConnectedDescriptor *descriptor,
@@ -60,13 +98,26 @@ StageProfiWidget::StageProfiWidget(io::SelectServerInterface *ss,
       m_disconnect_cb(disconnect_cb),
       m_timeout_id(INVALID_TIMEOUT),
       m_got_response(false) {
+  SerialFrameWriter::Options options;
+  // The detector opens USB widgets at 38400, network widgets have a path
+  // that's an IP address.
+  if (!widget_path.empty() && widget_path[0] == '/') {
+    options.baud_rate = ola::io::BAUD_RATE_38400;
+  }
+  m_writer.reset(new SerialFrameWriter(m_ss, m_descriptor.get(),
+                                       new Encoder(), options));
+  // Send the query before setting the error handler, the device isn't
+  // registered yet. If the query fails, DiscoveryTimeout() disconnects.
+  SendQueryPacket();
+  m_writer->SetOnError(
+      NewCallback(this, &StageProfiWidget::RunDisconnectHandler));
+
   m_descriptor->SetOnData(
       NewCallback<StageProfiWidget>(this, &StageProfiWidget::SocketReady));
   m_ss->AddReadDescriptor(m_descriptor.get());
   m_timeout_id = m_ss->RegisterSingleTimeout(
       TimeInterval(1, 0),
       ola::NewSingleCallback(this, &StageProfiWidget::DiscoveryTimeout));
-  SendQueryPacket();
 }
 
 StageProfiWidget::~StageProfiWidget() {
@@ -88,18 +139,7 @@ bool StageProfiWidget::SendDmx(const DmxBuffer &buffer) {
     return false;
   }
 
-  uint16_t index = 0;
-  while (index < buffer.Size()) {
-    unsigned int size = std::min((unsigned int) DMX_MSG_LEN,
-                                 buffer.Size() - index);
-    bool ok = Send255(index, buffer.GetRaw() + index, size);
-    if (!ok) {
-      OLA_INFO << "Failed to send StageProfi message, closing socket";
-      RunDisconnectHandler();
-    }
-    index += size;
-  }
-  return true;
+  return m_writer->SendDmx(buffer);
 }
 
 /*
@@ -127,32 +167,10 @@ void StageProfiWidget::DiscoveryTimeout() {
   }
 }
 
-/*
- * @brief Send 255 channels worth of data
- * @param start the start channel for the data
- * @param buf a pointer to the data
- * @param len the length of the data
- */
-bool StageProfiWidget::Send255(uint16_t start,
-                               const uint8_t *buf,
-                               unsigned int length) const {
-  uint8_t msg[DMX_MSG_LEN + DMX_HEADER_SIZE];
-  unsigned int len = std::min((unsigned int) DMX_MSG_LEN, length);
-
-  msg[0] = ID_SETDMX;
-  ola::utils::SplitUInt16(start, &msg[2], &msg[1]);
-  msg[3] = len;
-  memcpy(msg + DMX_HEADER_SIZE, buf, len);
-
-  // This needs to be an int, as m_descriptor->Send() below returns an int
-  const int bytes_to_send = len + DMX_HEADER_SIZE;
-  return m_descriptor->Send(msg, bytes_to_send) == bytes_to_send;
-}
-
 void StageProfiWidget::SendQueryPacket() {
-  uint8_t query[] = {'C', '?'};
-  ssize_t bytes_sent = m_descriptor->Send(query, arraysize(query));
-  OLA_DEBUG << "Sending StageprofiWidget query: C? returned " << bytes_sent;
+  const uint8_t query[] = {'C', '?'};
+  OLA_DEBUG << "Sending StageprofiWidget query: C?";
+  m_writer->SendCommand(query, arraysize(query));
 }
 
 void StageProfiWidget::RunDisconnectHandler() {
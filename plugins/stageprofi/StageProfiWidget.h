@@ -25,6 +25,7 @@
 #include <string>
 #include "ola/DmxBuffer.h"
 #include "ola/Callback.h"
+#include "common/io/SerialFrameWriter.h"
 #include "ola/io/Descriptor.h"
 #include "ola/io/SelectServerInterface.h"
 
@@ -64,11 +65,14 @@ class StageProfiWidget {
   bool SendDmx(const DmxBuffer &buffer);
 
  private:
+  class Encoder;
+
   enum { DMX_MSG_LEN = 255 };
   enum { DMX_HEADER_SIZE = 4};
 
   ola::io::SelectServerInterface *m_ss;
   std::auto_ptr<ola::io::ConnectedDescriptor> m_descriptor;
+  std::auto_ptr<ola::io::SerialFrameWriter> m_writer;
   const std::string m_widget_path;
   DisconnectCallback *m_disconnect_cb;
   ola::thread::timeout_id m_timeout_id;
@@ -76,7 +80,6 @@ class StageProfiWidget {
 
   void SocketReady();
   void DiscoveryTimeout();
-  bool Send255(uint16_t start, const uint8_t *buf, unsigned int len) const;
   void SendQueryPacket();
   void RunDisconnectHandler();
 };
@@ -46,6 +46,7 @@ class UartDmxPlugin : public Plugin {
   std::string PluginPrefix() const { return PLUGIN_PREFIX; }
   // This plugin is disabled unless explicitly enabled by a user.
   bool DefaultMode() const { return false; }
+  bool SupportsConcurrentStart() const { return true; }
 
   std::string Description() const;
 
@@ -62,8 +62,8 @@ bool UartDmxThread::Stop() {
  * Copy a DMXBuffer to the output thread
  */
 bool UartDmxThread::WriteDMX(const DmxBuffer &buffer) {
-  ola::thread::MutexLocker locker(&m_buffer_mutex);
-  m_buffer.Set(buffer);
+  m_buffer.WriteBuffer()->Set(buffer);
+  m_buffer.Publish();
   return true;
 }
 
@@ -75,7 +75,6 @@ void *UartDmxThread::Run() {
   TimeStamp ts1, ts2;
   Clock clock;
   CheckTimeGranularity();
-  DmxBuffer buffer;
 
   // Setup the widget
   if (!m_widget->IsOpen())
@@ -88,10 +87,8 @@ void *UartDmxThread::Run() {
         break;
     }
 
-    {
-      ola::thread::MutexLocker locker(&m_buffer_mutex);
-      buffer.Set(m_buffer);
-    }
+    m_buffer.Update();
+    const DmxBuffer &buffer = m_buffer.ReadBuffer();
 
     if (!m_widget->SetBreak(true))
       goto framesleep;
@@ -24,6 +24,7 @@
 
 #include "ola/DmxBuffer.h"
 #include "ola/thread/Thread.h"
+#include "ola/thread/TripleBuffer.h"
 
 namespace ola {
 namespace plugin {
@@ -46,9 +47,8 @@ class UartDmxThread : public ola::thread::Thread {
   bool m_term;
   unsigned int m_breakt;
   unsigned int m_malft;
-  DmxBuffer m_buffer;
+  ola::thread::TripleBuffer<DmxBuffer> m_buffer;
   ola::thread::Mutex m_term_mutex;
-  ola::thread::Mutex m_buffer_mutex;
 
   void CheckTimeGranularity();
 
@@ -58,7 +58,6 @@ bool ThreadedUsbSender::Start() {
 }
 
 void *ThreadedUsbSender::Run() {
-  DmxBuffer buffer;
   if (!m_usb_handle)
     return NULL;
 
@@ -69,11 +68,8 @@ void *ThreadedUsbSender::Run() {
         break;
     }
 
-    {
-      ola::thread::MutexLocker locker(&m_data_mutex);
-      buffer.Set(m_buffer);
-    }
-
+    m_buffer.Update();
+    const DmxBuffer &buffer = m_buffer.ReadBuffer();
     if (buffer.Size()) {
       if (!TransmitBuffer(m_usb_handle, buffer)) {
         OLA_WARN << "Send failed, stopping thread...";
@@ -90,9 +86,9 @@ void *ThreadedUsbSender::Run() {
 }
 
 bool ThreadedUsbSender::SendDMX(const DmxBuffer &buffer) {
-  // Store the new data in the shared buffer.
-  ola::thread::MutexLocker locker(&m_data_mutex);
-  m_buffer.Set(buffer);
+  // Hand the new data to the sender thread.
+  m_buffer.WriteBuffer()->Set(buffer);
+  m_buffer.Publish();
   return true;
 }
 }  // namespace usbdmx
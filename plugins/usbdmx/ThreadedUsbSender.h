@@ -25,6 +25,7 @@
 #include "ola/base/Macro.h"
 #include "ola/DmxBuffer.h"
 #include "ola/thread/Thread.h"
+#include "ola/thread/TripleBuffer.h"
 
 namespace ola {
 namespace plugin {
@@ -94,8 +95,7 @@ class ThreadedUsbSender: private ola::thread::Thread {
   libusb_device* const m_usb_device;
   libusb_device_handle* const m_usb_handle;
   int const m_interface_number;
-  DmxBuffer m_buffer;
-  ola::thread::Mutex m_data_mutex;
+  ola::thread::TripleBuffer<DmxBuffer> m_buffer;
   ola::thread::Mutex m_term_mutex;
 
   DISALLOW_COPY_AND_ASSIGN(ThreadedUsbSender);
@@ -64,6 +64,8 @@ class UsbDmxPlugin: public ola::Plugin {
   void ConflictsWith(
       std::set<ola_plugin_id>* conflicting_plugins) const;
 
+  bool SupportsConcurrentStart() const { return true; }
+
  private:
   std::auto_ptr<class PluginImplInterface> m_impl;
 
@@ -310,6 +310,20 @@ class ClientWrapper(object):
   def Client(self):
     return self._client
 
+  def SendDmxBatch(self, frames, callback=None):
+    """Send DMX data for several universes in a single write to the server.
+
+    Args:
+      frames: A dict of universe to DMX data, or a list of (universe, data)
+        tuples, see OlaClient.SendDmxBatch.
+      callback: The function to call as each universe completes, takes one
+        argument, a RequestStatus object.
+
+    Returns:
+      True if the requests were sent, False otherwise.
+    """
+    return self._client.SendDmxBatch(frames, callback)
+
   def Run(self):
     self._ss.Run()
 
@@ -247,6 +247,44 @@ class ClientWrapperTest(unittest.TestCase):
 
     self.assertTrue(results.gotdata)
 
+  # @timeout_decorator.timeout(2)
+  def testSendBatch(self):
+    """tests that SendDmxBatch sends all the frames in one write"""
+    sockets = socket.socketpair()
+    wrapper = ClientWrapper(sockets[0])
+
+    class results:
+      gotdata = False
+
+    def DataCallback(self):
+      data = sockets[1].recv(4096)
+      expected = (
+        handleRPCByteOrder(binascii.unhexlify(
+          "7d000010080110001a0d557064617465446d784461746122680801126400000"
+          "000000000000000000000000000000000000000000000000000000000000000"
+          "000000000000000000000000000000000000000000000000000000000000000"
+          "000000000000000000000000000000000000000000000000000000000000000"
+          "000000")) +
+        handleRPCByteOrder(binascii.unhexlify(
+          "1c000010080110011a0d557064617465446d7844617461220708021203010203")))
+      self.assertEqual(data, expected,
+                       msg="Regression check failed. If protocol change "
+                       "was intended set expected to: " +
+                       str(binascii.hexlify(data)))
+      results.gotdata = True
+      wrapper.AddEvent(0, wrapper.Stop)
+
+    wrapper._ss.AddReadDescriptor(sockets[1], lambda: DataCallback(self))
+    self.assertTrue(wrapper.SendDmxBatch(
+        [(1, bytearray(100)), (2, memoryview(b'\x01\x02\x03'))]))
+
+    wrapper.Run()
+
+    sockets[0].close()
+    sockets[1].close()
+
+    self.assertTrue(results.gotdata)
+
   # @timeout_decorator.timeout(2)
   def testFetchDmx(self):
     """uses client to send a FetchDMX with mocked olad.
@@ -314,6 +352,43 @@ class ClientWrapperTest(unittest.TestCase):
     self.assertTrue(results.got_request)
     self.assertTrue(results.got_response)
 
+  # @timeout_decorator.timeout(2)
+  def testFetchDmxSplitResponse(self):
+    """checks responses that arrive in pieces are reassembled."""
+    sockets = socket.socketpair()
+    wrapper = ClientWrapper(sockets[0])
+    client = wrapper.Client()
+
+    class results:
+      responses = []
+
+    def ResponseCallback(status, universe, data):
+      self.assertTrue(status.Succeeded())
+      results.responses.append((universe, data))
+
+    client.FetchDmx(0, ResponseCallback)
+    client.FetchDmx(0, ResponseCallback)
+    sockets[1].recv(4096)
+
+    response = handleRPCByteOrder(binascii.unhexlify(
+        "0d00001008021000220708001203010203"))
+    second_response = handleRPCByteOrder(binascii.unhexlify(
+        "0d00001008021001220708001203040506"))
+
+    # part of the header, then part of the body, then the rest of the first
+    # response along with all of the second.
+    data = response + second_response
+    for chunk in (data[0:2], data[2:10], data[10:]):
+      sockets[1].send(chunk)
+      client.SocketReady()
+
+    self.assertEqual(results.responses,
+                     [(0, array.array('B', [1, 2, 3])),
+                      (0, array.array('B', [4, 5, 6]))])
+
+    sockets[0].close()
+    sockets[1].close()
+
 
 if __name__ == '__main__':
   unittest.main()
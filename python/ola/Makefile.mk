@@ -56,6 +56,8 @@ python/ola/PidStoreLocation.py: python/ola/Makefile.mk configure.ac
 python/ola/Version.py: python/ola/Makefile.mk configure.ac config/ola_version.m4
 	echo "version = '${VERSION}'" > $(top_builddir)/python/ola/Version.py
 
+dist_noinst_SCRIPTS += python/ola/OlaClientBenchmark.py
+
 # TESTS
 ##################################################
 
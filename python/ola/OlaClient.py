@@ -18,8 +18,8 @@
 import array
 import socket
 import struct
-import sys
 
+from ola.rpc import Framing
 from ola.rpc.SimpleRpcController import SimpleRpcController
 from ola.rpc.StreamRpcChannel import StreamRpcChannel
 from ola.UID import UID
@@ -941,7 +941,8 @@ class OlaClient(Ola_pb2.OlaClientService):
 
     Args:
       universe: the universe to send the data for
-      data: An array object with the DMX data
+      data: An array object with the DMX data. A bytes, bytearray, memoryview
+        or uint8 numpy array can also be used.
       callback: The function to call once complete, takes one argument, a
         RequestStatus object.
 
@@ -951,21 +952,58 @@ class OlaClient(Ola_pb2.OlaClientService):
     if self._socket is None:
       return False
 
-    controller = SimpleRpcController()
-    request = Ola_pb2.DmxData()
-    request.universe = universe
-    if sys.version_info >= (3, 2):
-      request.data = data.tobytes()
-    else:
-      request.data = data.tostring()
     try:
-      self._stub.UpdateDmxData(
-          controller, request,
-          lambda x, y: self._AckMessageComplete(callback, x, y))
+      self._SendDmx(universe, data, callback)
     except socket.error:
       raise OLADNotRunningException()
     return True
 
+  def SendDmxBatch(self, frames, callback=None):
+    """Send DMX data for several universes in a single write to the server.
+
+    This is much cheaper than calling SendDmx for each universe when sending
+    many universes per frame.
+
+    Args:
+      frames: A dict of universe to DMX data, or a list of (universe, data)
+        tuples. The data can be any of the types SendDmx accepts.
+      callback: The function to call as each universe completes, takes one
+        argument, a RequestStatus object.
+
+    Returns:
+      True if the requests were sent, False otherwise.
+    """
+    if self._socket is None:
+      return False
+
+    if isinstance(frames, dict):
+      frames = frames.items()
+
+    try:
+      self._channel.StartBatch()
+      try:
+        for universe, data in frames:
+          self._SendDmx(universe, data, callback)
+      finally:
+        self._channel.SendBatch()
+    except socket.error:
+      raise OLADNotRunningException()
+    return True
+
+  def _SendDmx(self, universe, data, callback):
+    """Send an UpdateDmxData request.
+
+    The request is encoded directly, rather than building the DmxData and
+    RpcMessage objects, since this is called for every universe in every
+    frame.
+    """
+    controller = SimpleRpcController()
+    self._channel.CallEncodedMethod(
+        lambda message_id: Framing.EncodeDmxRequest(
+            message_id, 'UpdateDmxData', universe, data),
+        controller, Ola_pb2.Ack,
+        lambda x, y: self._AckMessageComplete(callback, x, y))
+
   def SetUniverseName(self, universe, name, callback=None):
     """Set the name of a universe.
 
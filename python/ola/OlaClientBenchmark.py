@@ -0,0 +1,157 @@
+#!/usr/bin/env python
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License as published by the Free Software Foundation; either
+# version 2.1 of the License, or (at your option) any later version.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this library; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+#
+# OlaClientBenchmark.py
+# Copyright (C) 2026 agent
+
+"""Measure how fast the client can send and receive DMX.
+
+This doesn't need olad, the client talks to one end of a socket pair and a
+thread throws away everything written to the other end. The numbers are the
+client side cost only, olad will be slower.
+"""
+
+from __future__ import print_function
+
+import argparse
+import array
+import socket
+import struct
+import threading
+import time
+
+from ola.DMXConstants import DMX_UNIVERSE_SIZE
+from ola.OlaClient import OlaClient
+from ola.rpc import Framing, Rpc_pb2
+from ola.rpc.StreamRpcChannel import StreamRpcChannel
+
+from ola import Ola_pb2
+
+__author__ = 'agent@local (agent)'
+
+
+def ParseArgs():
+  desc = 'Benchmark the python client.'
+  argparser = argparse.ArgumentParser(description=desc)
+  argparser.add_argument('--universes', '-u', type=int, default=50,
+                         help='The number of universes to send each frame.')
+  argparser.add_argument('--frames', '-f', type=int, default=400,
+                         help='The number of frames to send.')
+  return argparser.parse_args()
+
+
+def Drain(sock):
+  while sock.recv(65536):
+    pass
+
+
+def Report(name, frames, universes, elapsed):
+  print('%-28s %8.1f frames/s %10.0f universes/s' %
+        (name, frames / elapsed, frames * universes / elapsed))
+
+
+def Time(name, frames, universes, send_frame):
+  """Run send_frame for each frame and report the rate."""
+  start = time.time()
+  for i in range(frames):
+    send_frame(i)
+  Report(name, frames, universes, time.time() - start)
+
+
+def DmxResponse(message_id, data):
+  """Build the response olad sends for a GetDmx request."""
+  dmx = Ola_pb2.DmxData()
+  dmx.universe = 1
+  dmx.data = data
+  message = Rpc_pb2.RpcMessage()
+  message.type = Rpc_pb2.RESPONSE
+  message.id = message_id
+  message.buffer = dmx.SerializeToString()
+  body = message.SerializeToString()
+  header = ((StreamRpcChannel.PROTOCOL_VERSION << 28) |
+            (len(body) & StreamRpcChannel.SIZE_MASK))
+  return struct.pack('=L', header) + body
+
+
+def BenchmarkSend(args):
+  sockets = socket.socketpair()
+  drain = threading.Thread(target=Drain, args=(sockets[1],))
+  drain.start()
+  client = OlaClient(sockets[0])
+  universes = range(1, args.universes + 1)
+
+  data = array.array('B', [128] * DMX_UNIVERSE_SIZE)
+  Time('SendDmx, array', args.frames, args.universes,
+       lambda i: [client.SendDmx(u, data) for u in universes])
+
+  data = bytearray([128] * DMX_UNIVERSE_SIZE)
+  Time('SendDmx, bytearray', args.frames, args.universes,
+       lambda i: [client.SendDmx(u, data) for u in universes])
+
+  frames = [(u, data) for u in universes]
+  Time('SendDmxBatch, bytearray', args.frames, args.universes,
+       lambda i: client.SendDmxBatch(frames))
+
+  # olad never replies, so stop the client tracking the requests.
+  client._channel._outstanding_responses.clear()
+  sockets[0].close()
+  drain.join()
+  sockets[1].close()
+
+
+def BenchmarkReceive(args):
+  sockets = socket.socketpair()
+  drain = threading.Thread(target=Drain, args=(sockets[1],))
+  drain.start()
+  client = OlaClient(sockets[0])
+
+  class results:
+    count = 0
+
+  def DmxCallback(status, universe, data):
+    results.count += 1
+
+  responses = b''.join(
+      DmxResponse(i, bytes(bytearray([128] * DMX_UNIVERSE_SIZE)))
+      for i in range(args.universes))
+
+  def ReceiveFrame(i):
+    # The request ids start from 0 again each frame
+    client._channel._sequence = 0
+    for u in range(args.universes):
+      client.FetchDmx(u, DmxCallback)
+    expected = results.count + args.universes
+    offset = 0
+    while offset < len(responses):
+      offset += sockets[1].send(responses[offset:offset + 8192])
+      client.SocketReady()
+    while results.count < expected:
+      client.SocketReady()
+
+  Time('FetchDmx responses', args.frames, args.universes, ReceiveFrame)
+  sockets[0].close()
+  drain.join()
+  sockets[1].close()
+
+
+def main():
+  args = ParseArgs()
+  print('Native framing: %s' % ('yes' if Framing.NATIVE else 'no'))
+  BenchmarkSend(args)
+  BenchmarkReceive(args)
+
+
+if __name__ == '__main__':
+  main()
@@ -0,0 +1,136 @@
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License as published by the Free Software Foundation; either
+# version 2.1 of the License, or (at your option) any later version.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this library; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+#
+# Framing.py
+# Copyright (C) 2026 agent
+
+import struct
+
+"""Encodes and decodes the frames sent over a StreamRpcChannel.
+
+Each frame is a 4 byte header, holding the protocol version and the size of
+the message, followed by a serialized RpcMessage. If the optional native
+module, _rpcframing, was built it's used in place of the python functions.
+"""
+
+PROTOCOL_VERSION = 1
+VERSION_MASK = 0xf0000000
+SIZE_MASK = 0x0fffffff
+HEADER = struct.Struct('=L')
+
+# The RpcMessage and DmxData tags, see Rpc.proto and Ola.proto.
+_RPC_REQUEST_TYPE = b'\x08\x01'
+_RPC_ID_TAG = b'\x10'
+_RPC_NAME_TAG = b'\x1a'
+_RPC_BUFFER_TAG = b'\x22'
+_DMX_UNIVERSE_TAG = b'\x08'
+_DMX_DATA_TAG = b'\x12'
+
+
+def EncodeHeader(size):
+  """Encode a message size into a header, with the current version."""
+  return HEADER.pack(((PROTOCOL_VERSION << 28) & VERSION_MASK) |
+                     (size & SIZE_MASK))
+
+
+def DecodeHeader(header):
+  """Decode a header into a (version, size) tuple."""
+  return ((header & VERSION_MASK) >> 28, header & SIZE_MASK)
+
+
+def DmxBytes(data):
+  """Convert DMX data to bytes.
+
+  Args:
+    data: an array of unsigned bytes, or any other object that supports the
+      buffer protocol, such as bytes, bytearray, memoryview or a uint8 numpy
+      array.
+  """
+  if isinstance(data, bytes):
+    return data
+  try:
+    return memoryview(data).tobytes()
+  except TypeError:
+    # Python 2 arrays don't support memoryview
+    return data.tostring()
+
+
+def _EncodeVarint(value):
+  """Encode an integer as a protobuf varint."""
+  # Negative int32s are sign extended to 64 bits.
+  value &= 0xffffffffffffffff
+  out = bytearray()
+  while value >= 0x80:
+    out.append((value & 0x7f) | 0x80)
+    value >>= 7
+  out.append(value)
+  return bytes(out)
+
+
+def _PyEncodeDmxRequest(message_id, name, universe, data):
+  """Encode a framed RpcMessage REQUEST with a DmxData message.
+
+  Args:
+    message_id: the id of the RpcMessage.
+    name: the name of the method to call.
+    universe: the universe of the DmxData.
+    data: the DMX data, any type DmxBytes() accepts.
+
+  Returns:
+    The frame, as bytes.
+  """
+  data = DmxBytes(data)
+  if not isinstance(name, bytes):
+    name = name.encode('utf-8')
+  dmx_data = b''.join([
+      _DMX_UNIVERSE_TAG, _EncodeVarint(universe),
+      _DMX_DATA_TAG, _EncodeVarint(len(data)), data])
+  message = b''.join([
+      _RPC_REQUEST_TYPE,
+      _RPC_ID_TAG, _EncodeVarint(message_id),
+      _RPC_NAME_TAG, _EncodeVarint(len(name)), name,
+      _RPC_BUFFER_TAG, _EncodeVarint(len(dmx_data)), dmx_data])
+  return EncodeHeader(len(message)) + message
+
+
+def _PyDecodeFrames(buf):
+  """Split the complete frames from the start of a buffer.
+
+  Args:
+    buf: a bytearray, or any object that supports the buffer protocol.
+
+  Returns:
+    A tuple in the form ([(version, message)], bytes_used). Any incomplete
+    frame at the end of the buffer isn't used.
+  """
+  frames = []
+  offset = 0
+  length = len(buf)
+  while length - offset >= HEADER.size:
+    version, size = DecodeHeader(HEADER.unpack_from(buf, offset)[0])
+    end = offset + HEADER.size + size
+    if end > length:
+      break
+    frames.append((version, bytes(buf[offset + HEADER.size:end])))
+    offset = end
+  return frames, offset
+
+
+try:
+  from ola.rpc._rpcframing import DecodeFrames, EncodeDmxRequest
+  NATIVE = True
+except ImportError:
+  DecodeFrames = _PyDecodeFrames
+  EncodeDmxRequest = _PyEncodeDmxRequest
+  NATIVE = False
@@ -0,0 +1,116 @@
+#!/usr/bin/env python
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License as published by the Free Software Foundation; either
+# version 2.1 of the License, or (at your option) any later version.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this library; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+#
+# FramingTest.py
+# Copyright (C) 2026 agent
+
+import array
+import os
+import unittest
+
+from ola import Ola_pb2
+from ola.rpc import Framing, Rpc_pb2
+
+"""Test cases for the RPC framing functions."""
+
+
+def LoadNativeModule():
+  """Load the native module, from the build tree if the test script says
+  where it is, or from the installed package.
+  """
+  path = os.environ.get('OLA_RPC_FRAMING_MODULE')
+  if path and os.path.exists(path):
+    import importlib.util
+    spec = importlib.util.spec_from_file_location('_rpcframing', path)
+    module = importlib.util.module_from_spec(spec)
+    spec.loader.exec_module(module)
+    return module
+  try:
+    from ola.rpc import _rpcframing
+    return _rpcframing
+  except ImportError:
+    return None
+
+
+def ExpectedDmxRequest(message_id, name, universe, data):
+  """Build a DMX request with the protobuf library."""
+  dmx = Ola_pb2.DmxData()
+  dmx.universe = universe
+  dmx.data = bytes(data)
+  message = Rpc_pb2.RpcMessage()
+  message.type = Rpc_pb2.REQUEST
+  message.id = message_id
+  message.name = name
+  message.buffer = dmx.SerializeToString()
+  body = message.SerializeToString()
+  return Framing.EncodeHeader(len(body)) + body
+
+
+class FramingTest(unittest.TestCase):
+  REQUESTS = [
+      (0, 'UpdateDmxData', 1, bytearray(100)),
+      (1, 'UpdateDmxData', 2, bytearray(range(256)) * 2),
+      (300, 'StreamDmxData', 70000, b'\x01\x02\x03'),
+      (0xffffffff, 'UpdateDmxData', -1, b''),
+  ]
+
+  def CheckEncoder(self, encode):
+    for message_id, name, universe, data in self.REQUESTS:
+      self.assertEqual(ExpectedDmxRequest(message_id, name, universe, data),
+                       encode(message_id, name, universe, data))
+
+    # The other types of DMX data.
+    expected = ExpectedDmxRequest(5, 'UpdateDmxData', 1, b'\x00\x7f\xff')
+    for data in [array.array('B', [0, 127, 255]),
+                 bytearray(b'\x00\x7f\xff'),
+                 memoryview(b'\x00\x7f\xff')]:
+      self.assertEqual(expected, encode(5, 'UpdateDmxData', 1, data))
+
+  def CheckDecoder(self, decode):
+    frames = [ExpectedDmxRequest(*request) for request in self.REQUESTS]
+    data = bytearray(b''.join(frames))
+
+    self.assertEqual(([], 0), decode(bytearray()))
+    self.assertEqual(([], 0), decode(data[:3]))
+    self.assertEqual(([], 0), decode(data[:len(frames[0]) - 1]))
+
+    messages, used = decode(data[:len(frames[0]) + 10])
+    self.assertEqual(len(frames[0]), used)
+    self.assertEqual([(1, frames[0][Framing.HEADER.size:])], messages)
+
+    messages, used = decode(data)
+    self.assertEqual(len(data), used)
+    self.assertEqual([(1, f[Framing.HEADER.size:]) for f in frames], messages)
+
+    # A frame with a different version is still split out.
+    header = Framing.HEADER.pack((2 << 28) | 2)
+    self.assertEqual(([(2, b'\x08\x01')], 6), decode(header + b'\x08\x01'))
+
+  def testPython(self):
+    self.CheckEncoder(Framing._PyEncodeDmxRequest)
+    self.CheckDecoder(Framing._PyDecodeFrames)
+
+  def testNative(self):
+    native = LoadNativeModule()
+    if native is None:
+      self.skipTest('The native framing module was not built')
+    self.CheckEncoder(native.EncodeDmxRequest)
+    self.CheckDecoder(native.DecodeFrames)
+    self.assertRaises(ValueError, native.EncodeDmxRequest, 1 << 32,
+                      'UpdateDmxData', 1, b'')
+
+
+if __name__ == '__main__':
+  unittest.main()
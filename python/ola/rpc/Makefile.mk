@@ -5,12 +5,23 @@
 if BUILD_PYTHON_LIBS
 rpcpythondir = $(pkgpythondir)/rpc
 nodist_rpcpython_PYTHON = python/ola/rpc/Rpc_pb2.py
-rpcpython_PYTHON = python/ola/rpc/SimpleRpcController.py \
+rpcpython_PYTHON = python/ola/rpc/Framing.py \
+                   python/ola/rpc/SimpleRpcController.py \
                    python/ola/rpc/StreamRpcChannel.py \
                    python/ola/rpc/__init__.py
 built_sources += python/ola/rpc/Rpc_pb2.py
 endif
 
+# The optional native framing module, Framing.py falls back to python if it's
+# not installed.
+if BUILD_PYTHON_EXTENSION
+rpcpyexecdir = $(pkgpyexecdir)/rpc
+rpcpyexec_LTLIBRARIES = python/ola/rpc/_rpcframing.la
+python_ola_rpc__rpcframing_la_SOURCES = python/ola/rpc/_rpcframing.c
+python_ola_rpc__rpcframing_la_CPPFLAGS = $(PYTHON_CPPFLAGS)
+python_ola_rpc__rpcframing_la_LDFLAGS = -module -avoid-version -shared
+endif
+
 python/ola/rpc/Rpc_pb2.py: common/rpc/Rpc.proto
 	mkdir -p $(top_builddir)/python/ola/rpc
 	$(PROTOC) --python_out $(top_builddir)/python/ola/rpc -I ${top_srcdir}/common/rpc/ ${top_srcdir}/common/rpc/Rpc.proto
@@ -18,17 +29,41 @@ python/ola/rpc/Rpc_pb2.py: common/rpc/Rpc.proto
 # TESTS
 ##################################################
 if BUILD_PYTHON_LIBS
-test_scripts += python/ola/rpc/SimpleRpcControllerTest.sh
+test_scripts += \
+    python/ola/rpc/FramingTest.sh \
+    python/ola/rpc/SimpleRpcControllerTest.sh \
+    python/ola/rpc/StreamRpcChannelTest.sh
 endif
 
-dist_check_SCRIPTS += python/ola/rpc/SimpleRpcControllerTest.py
+dist_check_SCRIPTS += \
+    python/ola/rpc/FramingTest.py \
+    python/ola/rpc/SimpleRpcControllerTest.py \
+    python/ola/rpc/StreamRpcChannelTest.py
+
+# The native module isn't in the package directory until it's installed, so
+# tell the test where libtool put it.
+if BUILD_PYTHON_EXTENSION
+framing_module = ${top_builddir}/python/ola/rpc/.libs/_rpcframing.so
+endif
+
+python/ola/rpc/FramingTest.sh: python/ola/rpc/Makefile.mk
+	mkdir -p $(top_builddir)/python/ola/rpc
+	echo "PYTHONPATH=${top_builddir}/python OLA_RPC_FRAMING_MODULE=$(framing_module) $(PYTHON) ${srcdir}/python/ola/rpc/FramingTest.py; exit \$$?" > $(top_builddir)/python/ola/rpc/FramingTest.sh
+	chmod +x $(top_builddir)/python/ola/rpc/FramingTest.sh
 
 python/ola/rpc/SimpleRpcControllerTest.sh: python/ola/rpc/Makefile.mk
 	mkdir -p $(top_builddir)/python/ola/rpc
 	echo "PYTHONPATH=${top_builddir}/python $(PYTHON) ${srcdir}/python/ola/rpc/SimpleRpcControllerTest.py; exit \$$?" > $(top_builddir)/python/ola/rpc/SimpleRpcControllerTest.sh
 	chmod +x $(top_builddir)/python/ola/rpc/SimpleRpcControllerTest.sh
 
+python/ola/rpc/StreamRpcChannelTest.sh: python/ola/rpc/Makefile.mk
+	mkdir -p $(top_builddir)/python/ola/rpc
+	echo "PYTHONPATH=${top_builddir}/python $(PYTHON) ${srcdir}/python/ola/rpc/StreamRpcChannelTest.py; exit \$$?" > $(top_builddir)/python/ola/rpc/StreamRpcChannelTest.sh
+	chmod +x $(top_builddir)/python/ola/rpc/StreamRpcChannelTest.sh
+
 CLEANFILES += \
     python/ola/rpc/*.pyc \
+    python/ola/rpc/FramingTest.sh \
     python/ola/rpc/SimpleRpcControllerTest.sh \
+    python/ola/rpc/StreamRpcChannelTest.sh \
     python/ola/rpc/__pycache__/*
@@ -17,10 +17,9 @@
 
 import binascii
 import logging
-import struct
 
 from google.protobuf import service
-from ola.rpc import Rpc_pb2
+from ola.rpc import Framing, Rpc_pb2
 from ola.rpc.SimpleRpcController import SimpleRpcController
 
 from ola import ola_logger
@@ -49,10 +48,11 @@ class OutstandingResponse(object):
 
 class StreamRpcChannel(service.RpcChannel):
   """Implements a RpcChannel over a TCP socket."""
-  PROTOCOL_VERSION = 1
-  VERSION_MASK = 0xf0000000
-  SIZE_MASK = 0x0fffffff
+  PROTOCOL_VERSION = Framing.PROTOCOL_VERSION
+  VERSION_MASK = Framing.VERSION_MASK
+  SIZE_MASK = Framing.SIZE_MASK
   RECEIVE_BUFFER_SIZE = 8192
+  HEADER = Framing.HEADER
 
   def __init__(self, socket, service_impl, close_callback=None):
     """Create a new StreamRpcChannel.
@@ -66,9 +66,8 @@ class StreamRpcChannel(service.RpcChannel):
     self._sequence = 0
     self._outstanding_requests = {}
     self._outstanding_responses = {}
-    self._buffer = []  # The received data
-    self._expected_size = None  # The size of the message we're receiving
-    self._skip_message = False  # Skip the current message
+    self._buffer = bytearray()  # The received data
+    self._batch = None  # Messages waiting for SendBatch()
     self._close_callback = close_callback
     self._log_msgs = False  # set to enable wire message logging
     if self._log_msgs:
@@ -87,10 +86,28 @@ class StreamRpcChannel(service.RpcChannel):
         self._close_callback()
       return False
 
-    self._buffer.append(data)
+    self._buffer.extend(data)
     self._ProcessIncomingData()
     return True
 
+  def StartBatch(self):
+    """Hold outgoing messages until SendBatch() is called."""
+    if self._batch is None:
+      self._batch = []
+
+  def SendBatch(self):
+    """Send the messages held since StartBatch() with a single write.
+
+    Returns:
+      True if the send succeeded, False otherwise.
+    """
+    batch = self._batch
+    self._batch = None
+    if not batch:
+      return True
+    self._socket.sendall(b''.join(batch))
+    return True
+
   def CallMethod(self, method, controller, request, response_pb, done):
     """Call a method.
 
@@ -110,17 +127,24 @@ class StreamRpcChannel(service.RpcChannel):
     message.buffer = request.SerializeToString()
     self._SendMessage(message)
     self._sequence += 1
+    self._AddOutstandingResponse(message.id, controller, done, response_pb)
 
-    if message.id in self._outstanding_responses:
-      # fail any outstanding response with the same id, not the best approach
-      # but it'll do for now.
-      ola_logger.warning('Response %d already pending, failing now', message.id)
-      response = self._outstanding_responses[message.id]
-      response.controller.SetFailed('Duplicate request found')
-      self._InvokeCallback(response)
+  def CallEncodedMethod(self, encoder, controller, response_pb, done):
+    """Call a method, with a request the caller has already encoded.
 
-    response = OutstandingResponse(message.id, controller, done, response_pb)
-    self._outstanding_responses[message.id] = response
+    This skips building the RpcMessage, for requests that are sent often.
+
+    Args:
+      encoder: A function that takes the message id and returns the framed
+        RpcMessage, see Framing.EncodeDmxRequest.
+      controller: An RpcController object
+      response: The response class
+      done: A closure to call once complete.
+    """
+    message_id = self._sequence
+    self._SendData(encoder(message_id))
+    self._sequence += 1
+    self._AddOutstandingResponse(message_id, controller, done, response_pb)
 
   def RequestComplete(self, request, response):
     """This is called on the server side when a request has completed.
@@ -141,6 +165,19 @@ class StreamRpcChannel(service.RpcChannel):
     self._SendMessage(message)
     del self._outstanding_requests[request.id]
 
+  def _AddOutstandingResponse(self, message_id, controller, done, response_pb):
+    """Track a request that's waiting on a response."""
+    if message_id in self._outstanding_responses:
+      # fail any outstanding response with the same id, not the best approach
+      # but it'll do for now.
+      ola_logger.warning('Response %d already pending, failing now', message_id)
+      response = self._outstanding_responses[message_id]
+      response.controller.SetFailed('Duplicate request found')
+      self._InvokeCallback(response)
+
+    response = OutstandingResponse(message_id, controller, done, response_pb)
+    self._outstanding_responses[message_id] = response
+
   def _EncodeHeader(self, size):
     """Encode a version and size into a header.
 
@@ -150,9 +187,7 @@ class StreamRpcChannel(service.RpcChannel):
     Returns:
       The header field
     """
-    header = (self.PROTOCOL_VERSION << 28) & self.VERSION_MASK
-    header |= size & self.SIZE_MASK
-    return struct.pack('=L', header)
+    return Framing.EncodeHeader(size)
 
   def _DecodeHeader(self, header):
     """Decode a header into the version and size.
@@ -163,7 +198,7 @@ class StreamRpcChannel(service.RpcChannel):
     Return:
       A tuple in the form (version, size)
     """
-    return ((header & self.VERSION_MASK) >> 28, header & self.SIZE_MASK)
+    return Framing.DecodeHeader(header)
 
   def _SendMessage(self, message):
     """Send an RpcMessage.
@@ -176,11 +211,25 @@ class StreamRpcChannel(service.RpcChannel):
     """
     data = message.SerializeToString()
     # combine into one buffer to send so we avoid sending two packets
-    data = self._EncodeHeader(len(data)) + data
+    return self._SendData(self._EncodeHeader(len(data)) + data)
+
+  def _SendData(self, data):
+    """Send a framed RpcMessage.
+
+    Args:
+      data: The header and the serialized RpcMessage.
+
+    Returns:
+      True if the send succeeded, False otherwise.
+    """
     # this log is useful for building mock regression tests
     if self._log_msgs:
       logging.debug("send->" + str(binascii.hexlify(data)))
 
+    if self._batch is not None:
+      self._batch.append(data)
+      return True
+
     sent_bytes = self._socket.send(data)
     if sent_bytes != len(data):
       ola_logger.warning('Failed to send full datagram')
@@ -207,71 +256,25 @@ class StreamRpcChannel(service.RpcChannel):
     Args:
       message_id: The message number.
     """
-    message = Rpc_pb2.RpcMessage
+    message = Rpc_pb2.RpcMessage()
     message.type = Rpc_pb2.RESPONSE_NOT_IMPLEMENTED
     message.id = message_id
     self._SendMessage(message)
 
-  def _GrabData(self, size):
-    """Fetch the next N bytes of data from the buffer.
-
-    Args:
-      size: the amount of data to fetch.
-
-    Returns:
-      The next size bytes of data, or None if there isn't enough.
-    """
-    data_size = sum([len(s) for s in self._buffer])
-    if data_size < size:
-      return None
-
-    data = []
-    size_left = size
-    while size_left > 0:
-      chunk = self._buffer.pop(0)
-      if len(chunk) > size_left:
-        # we only want part of it
-        data.append(chunk[0:size_left])
-        self._buffer.insert(0, chunk[size_left:])
-        size_left = 0
-      else:
-        data.append(chunk)
-        size_left -= len(chunk)
-
-    return b''.join(data)
-
   def _ProcessIncomingData(self):
     """Process the received data."""
+    frames, used = Framing.DecodeFrames(self._buffer)
+    # drop the data we've processed, this is cheap if it's all of it
+    del self._buffer[:used]
 
-    while True:
-      if not self._expected_size:
-        # this is a new msg
-        raw_header = self._GrabData(4)
-        if not raw_header:
-          # not enough data yet
-          return
-        if self._log_msgs:
-          logging.debug("recvhdr<-" + str(binascii.hexlify(raw_header)))
-        header = struct.unpack('=L', raw_header)[0]
-        version, size = self._DecodeHeader(header)
-
-        if version != self.PROTOCOL_VERSION:
-          ola_logger.warning('Protocol mismatch: %d != %d', version,
-                             self.PROTOCOL_VERSION)
-          self._skip_message = True
-        self._expected_size = size
-
-      data = self._GrabData(self._expected_size)
-      if not data:
-        # not enough data yet
-        return
-
+    for version, data in frames:
       if self._log_msgs:
         logging.debug("recvmsg<-" + str(binascii.hexlify(data)))
-      if not self._skip_message:
-        self._HandleNewMessage(data)
-      self._expected_size = 0
-      self._skip_message = 0
+      if version != self.PROTOCOL_VERSION:
+        ola_logger.warning('Protocol mismatch: %d != %d', version,
+                           self.PROTOCOL_VERSION)
+        continue
+      self._HandleNewMessage(data)
 
   def _HandleNewMessage(self, data):
     """Handle a new Message.
@@ -293,12 +296,20 @@ class StreamRpcChannel(service.RpcChannel):
     Args:
       message: The RpcMessage object.
     """
+    if message.HasField('method_table_hash'):
+      # We don't support method tables, so the peer will keep sending names.
+      self._SendNotImplemented(message.id)
+      return
+
     if not self._service:
       ola_logger.warning('No service registered')
       return
 
     descriptor = self._service.GetDescriptor()
-    method = descriptor.FindMethodByName(message.name)
+    try:
+      method = descriptor.FindMethodByName(message.name)
+    except KeyError:
+      method = None
     if not method:
       ola_logger.warning('Failed to get method descriptor for %s', message.name)
       self._SendNotImplemented(message.id)
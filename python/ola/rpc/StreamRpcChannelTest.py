@@ -0,0 +1,110 @@
+#!/usr/bin/env python
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License as published by the Free Software Foundation; either
+# version 2.1 of the License, or (at your option) any later version.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this library; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+#
+# StreamRpcChannelTest.py
+# Copyright (C) 2026 agent
+
+import socket
+import unittest
+
+from ola import Ola_pb2
+from ola.rpc import Rpc_pb2
+from ola.rpc.StreamRpcChannel import StreamRpcChannel
+
+"""Test cases for the StreamRpcChannel."""
+
+__author__ = 'agent@local (agent)'
+
+
+class ClientService(Ola_pb2.OlaClientService):
+  """Records the DMX updates it receives."""
+  def __init__(self):
+    self.updates = []
+
+  def UpdateDmxData(self, controller, request, callback):
+    self.updates.append(request.universe)
+    callback(Ola_pb2.Ack())
+
+
+class StreamRpcChannelTest(unittest.TestCase):
+
+  def setUp(self):
+    self.sockets = socket.socketpair()
+    self.service = ClientService()
+    self.channel = StreamRpcChannel(self.sockets[0], self.service)
+
+  def tearDown(self):
+    self.sockets[0].close()
+    self.sockets[1].close()
+
+  def _Send(self, message):
+    """Send a message to the channel, as the peer would."""
+    data = message.SerializeToString()
+    self.sockets[1].sendall(self.channel._EncodeHeader(len(data)) + data)
+    self.assertTrue(self.channel.SocketReady())
+
+  def _Receive(self):
+    """Read the message the channel sent to the peer."""
+    header = self.sockets[1].recv(StreamRpcChannel.HEADER.size)
+    version, size = self.channel._DecodeHeader(
+        StreamRpcChannel.HEADER.unpack(header)[0])
+    self.assertEqual(StreamRpcChannel.PROTOCOL_VERSION, version)
+    message = Rpc_pb2.RpcMessage()
+    message.ParseFromString(self.sockets[1].recv(size))
+    return message
+
+  def _DmxRequest(self, message_id, name):
+    request = Ola_pb2.DmxData()
+    request.universe = 1
+    request.data = b'\x01\x02'
+    message = Rpc_pb2.RpcMessage()
+    message.type = Rpc_pb2.REQUEST
+    message.id = message_id
+    message.name = name
+    message.buffer = request.SerializeToString()
+    return message
+
+  def testMethodTableOffer(self):
+    # A newer peer offers its method table, which we don't support.
+    offer = Rpc_pb2.RpcMessage()
+    offer.type = Rpc_pb2.REQUEST
+    offer.id = 1
+    offer.name = 'ola.proto.OlaClientService'
+    offer.method_table_hash = 0x12345678
+    self._Send(offer)
+
+    reply = self._Receive()
+    self.assertEqual(Rpc_pb2.RESPONSE_NOT_IMPLEMENTED, reply.type)
+    self.assertEqual(1, reply.id)
+    self.assertFalse(reply.HasField('method_table_hash'))
+    self.assertEqual([], self.service.updates)
+
+    # Requests by name still work afterwards.
+    self._Send(self._DmxRequest(2, 'UpdateDmxData'))
+    reply = self._Receive()
+    self.assertEqual(Rpc_pb2.RESPONSE, reply.type)
+    self.assertEqual(2, reply.id)
+    self.assertEqual([1], self.service.updates)
+
+  def testUnknownMethod(self):
+    self._Send(self._DmxRequest(1, 'NoSuchMethod'))
+    reply = self._Receive()
+    self.assertEqual(Rpc_pb2.RESPONSE_NOT_IMPLEMENTED, reply.type)
+    self.assertEqual(1, reply.id)
+    self.assertEqual([], self.service.updates)
+
+
+if __name__ == '__main__':
+  unittest.main()
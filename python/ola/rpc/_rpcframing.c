@@ -0,0 +1,226 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * _rpcframing.c
+ * Native versions of the encoding & decoding functions in Framing.py.
+ * Copyright (C) 2026 agent
+ */
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <stdint.h>
+#include <string.h>
+
+#if PY_MAJOR_VERSION < 3
+#error "The _rpcframing module requires Python 3"
+#endif
+
+#define PROTOCOL_VERSION 1u
+#define SIZE_MASK 0x0fffffffu
+#define HEADER_SIZE 4
+
+/* The RpcMessage and DmxData tags, see Rpc.proto and Ola.proto. */
+#define RPC_TYPE_TAG 0x08
+#define RPC_ID_TAG 0x10
+#define RPC_NAME_TAG 0x1a
+#define RPC_BUFFER_TAG 0x22
+#define RPC_REQUEST 1
+#define DMX_UNIVERSE_TAG 0x08
+#define DMX_DATA_TAG 0x12
+
+static size_t VarintSize(uint64_t value) {
+  size_t size = 1;
+  while (value >= 0x80) {
+    value >>= 7;
+    size++;
+  }
+  return size;
+}
+
+static uint8_t *WriteVarint(uint8_t *ptr, uint64_t value) {
+  while (value >= 0x80) {
+    *ptr++ = (uint8_t) (value | 0x80);
+    value >>= 7;
+  }
+  *ptr++ = (uint8_t) value;
+  return ptr;
+}
+
+/*
+ * EncodeDmxRequest(message_id, name, universe, data)
+ * The DMX data is copied once, straight into the frame.
+ */
+static PyObject *EncodeDmxRequest(PyObject *self, PyObject *args) {
+  unsigned long message_id;
+  const char *name;
+  Py_ssize_t name_size;
+  long universe;
+  PyObject *data;
+  Py_buffer view;
+  uint64_t universe_value;
+  size_t dmx_size, message_size;
+  uint32_t header;
+  PyObject *frame;
+  uint8_t *ptr;
+
+  (void) self;
+  if (!PyArg_ParseTuple(args, "ks#lO", &message_id, &name, &name_size,
+                        &universe, &data)) {
+    return NULL;
+  }
+
+  if (message_id > 0xffffffffUL) {
+    PyErr_SetString(PyExc_ValueError, "Message id out of range");
+    return NULL;
+  }
+  if (universe < INT32_MIN || universe > INT32_MAX) {
+    PyErr_SetString(PyExc_ValueError, "Universe out of range");
+    return NULL;
+  }
+  /* Negative int32s are sign extended to 64 bits. */
+  universe_value = (uint64_t) (int64_t) universe;
+
+  if (PyObject_GetBuffer(data, &view, PyBUF_SIMPLE) < 0) {
+    return NULL;
+  }
+
+  dmx_size = 1 + VarintSize(universe_value) +
+             1 + VarintSize(view.len) + view.len;
+  message_size = 2 +
+                 1 + VarintSize(message_id) +
+                 1 + VarintSize(name_size) + name_size +
+                 1 + VarintSize(dmx_size) + dmx_size;
+  if (message_size > SIZE_MASK) {
+    PyBuffer_Release(&view);
+    PyErr_SetString(PyExc_ValueError, "Message too large");
+    return NULL;
+  }
+
+  frame = PyBytes_FromStringAndSize(NULL, HEADER_SIZE + message_size);
+  if (!frame) {
+    PyBuffer_Release(&view);
+    return NULL;
+  }
+
+  ptr = (uint8_t*) PyBytes_AS_STRING(frame);
+  /* The header is in host byte order, like the C++ RpcChannel. */
+  header = (PROTOCOL_VERSION << 28) | (uint32_t) message_size;
+  memcpy(ptr, &header, HEADER_SIZE);
+  ptr += HEADER_SIZE;
+
+  *ptr++ = RPC_TYPE_TAG;
+  *ptr++ = RPC_REQUEST;
+  *ptr++ = RPC_ID_TAG;
+  ptr = WriteVarint(ptr, message_id);
+  *ptr++ = RPC_NAME_TAG;
+  ptr = WriteVarint(ptr, name_size);
+  memcpy(ptr, name, name_size);
+  ptr += name_size;
+  *ptr++ = RPC_BUFFER_TAG;
+  ptr = WriteVarint(ptr, dmx_size);
+
+  *ptr++ = DMX_UNIVERSE_TAG;
+  ptr = WriteVarint(ptr, universe_value);
+  *ptr++ = DMX_DATA_TAG;
+  ptr = WriteVarint(ptr, view.len);
+  memcpy(ptr, view.buf, view.len);
+
+  PyBuffer_Release(&view);
+  return frame;
+}
+
+/*
+ * DecodeFrames(buffer)
+ * Returns ([(version, message)], bytes_used).
+ */
+static PyObject *DecodeFrames(PyObject *self, PyObject *args) {
+  PyObject *buffer;
+  Py_buffer view;
+  PyObject *frames;
+  Py_ssize_t offset = 0;
+  const uint8_t *data;
+
+  (void) self;
+  if (!PyArg_ParseTuple(args, "O", &buffer)) {
+    return NULL;
+  }
+  if (PyObject_GetBuffer(buffer, &view, PyBUF_SIMPLE) < 0) {
+    return NULL;
+  }
+
+  frames = PyList_New(0);
+  if (!frames) {
+    PyBuffer_Release(&view);
+    return NULL;
+  }
+
+  data = (const uint8_t*) view.buf;
+  while (view.len - offset >= HEADER_SIZE) {
+    uint32_t header;
+    Py_ssize_t size;
+    PyObject *frame;
+    int r;
+
+    memcpy(&header, data + offset, HEADER_SIZE);
+    size = header & SIZE_MASK;
+    if (view.len - offset - HEADER_SIZE < size) {
+      break;
+    }
+
+    frame = Py_BuildValue(
+        "(Iy#)", (unsigned int) (header >> 28),
+        (const char*) data + offset + HEADER_SIZE, size);
+    if (!frame) {
+      Py_DECREF(frames);
+      PyBuffer_Release(&view);
+      return NULL;
+    }
+    r = PyList_Append(frames, frame);
+    Py_DECREF(frame);
+    if (r < 0) {
+      Py_DECREF(frames);
+      PyBuffer_Release(&view);
+      return NULL;
+    }
+    offset += HEADER_SIZE + size;
+  }
+
+  PyBuffer_Release(&view);
+  return Py_BuildValue("(Nn)", frames, offset);
+}
+
+static PyMethodDef RpcFramingMethods[] = {
+  {"EncodeDmxRequest", EncodeDmxRequest, METH_VARARGS,
+   "Encode a framed RpcMessage REQUEST with a DmxData message."},
+  {"DecodeFrames", DecodeFrames, METH_VARARGS,
+   "Split the complete frames from the start of a buffer."},
+  {NULL, NULL, 0, NULL}
+};
+
+static struct PyModuleDef RpcFramingModule = {
+  PyModuleDef_HEAD_INIT,
+  "_rpcframing",
+  "Native RPC framing for the OLA python client.",
+  -1,
+  RpcFramingMethods,
+  NULL,
+  NULL,
+  NULL,
+  NULL
+};
+
+PyMODINIT_FUNC PyInit__rpcframing(void) {
+  return PyModule_Create(&RpcFramingModule);
+}
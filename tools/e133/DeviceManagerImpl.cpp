@@ -95,10 +95,14 @@ class DeviceState {
 
 // 5 second connect() timeout
 const TimeInterval DeviceManagerImpl::TCP_CONNECT_TIMEOUT(5, 0);
-// retry TCP connects after 5 seconds
+// retry TCP connects after 2.5 to 5 seconds, with jitter
 const TimeInterval DeviceManagerImpl::INITIAL_TCP_RETRY_DELAY(5, 0);
-// we grow the retry interval to a max of 30 seconds
+// we double the retry interval up to a max of 30 seconds
 const TimeInterval DeviceManagerImpl::MAX_TCP_RETRY_DELAY(30, 0);
+// heartbeats are checked once a second
+const TimeInterval DeviceManagerImpl::HEARTBEAT_TICK_INTERVAL(1, 0);
+// the number of TCP connects we'll have in progress at once
+const unsigned int DeviceManagerImpl::MAX_PENDING_TCP_CONNECTS = 64;
 
 
 /**
@@ -112,8 +116,10 @@ DeviceManagerImpl::DeviceManagerImpl(ola::io::SelectServerInterface *ss,
       m_tcp_socket_factory(NewCallback(this, &DeviceManagerImpl::OnTCPConnect)),
       m_connector(m_ss, &m_tcp_socket_factory, TCP_CONNECT_TIMEOUT),
       m_backoff_policy(INITIAL_TCP_RETRY_DELAY, MAX_TCP_RETRY_DELAY),
+      m_heartbeat_wheel(m_ss, HEARTBEAT_TICK_INTERVAL),
       m_message_builder(message_builder),
       m_root_inflator(NewCallback(this, &DeviceManagerImpl::RLPDataReceived)) {
+  m_connector.SetMaxPendingConnections(MAX_PENDING_TCP_CONNECTS);
   m_root_inflator.AddInflator(&m_e133_inflator);
   m_e133_inflator.AddInflator(&m_rdm_inflator);
   m_rdm_inflator.SetRDMHandler(
@@ -356,7 +362,8 @@ void DeviceManagerImpl::RLPDataReceived(
           m_message_builder,
           device_state->message_queue.get(),
           NewSingleCallback(this, &DeviceManagerImpl::SocketUnhealthy, src_ip),
-          m_ss);
+          m_ss,
+          &m_heartbeat_wheel);
 
   if (!health_checked_connection->Setup()) {
     OLA_WARN << "Failed to setup heartbeat controller for " << src_ip;
@@ -34,6 +34,8 @@
 #include <ola/network/IPV4Address.h>
 #include <ola/network/Socket.h>
 #include <ola/network/TCPSocketFactory.h>
+#include <ola/thread/TimerWheel.h>
+#include <ola/util/Backoff.h>
 
 #include <memory>
 #include <string>
@@ -106,7 +108,9 @@ class DeviceManagerImpl {
 
     ola::network::TCPSocketFactory m_tcp_socket_factory;
     ola::network::AdvancedTCPConnector m_connector;
-    ola::LinearBackoffPolicy m_backoff_policy;
+    ola::ExponentialJitterBackoffPolicy m_backoff_policy;
+    // Shared by all the health checked connections.
+    ola::thread::TimerWheel m_heartbeat_wheel;
 
     ola::e133::MessageBuilder *m_message_builder;
 
@@ -136,6 +140,8 @@ class DeviceManagerImpl {
     static const TimeInterval TCP_CONNECT_TIMEOUT;
     static const TimeInterval INITIAL_TCP_RETRY_DELAY;
     static const TimeInterval MAX_TCP_RETRY_DELAY;
+    static const TimeInterval HEARTBEAT_TICK_INTERVAL;
+    static const unsigned int MAX_PENDING_TCP_CONNECTS;
 };
 }  // namespace e133
 }  // namespace ola
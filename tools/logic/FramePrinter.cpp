@@ -0,0 +1,115 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * FramePrinter.cpp
+ * Display the DMX / RDM frames decoded from a signal.
+ * Copyright (C) 2026 agent
+ */
+
+#include <ola/Constants.h>
+#include <ola/Logging.h>
+#include <ola/StringUtils.h>
+#include <ola/rdm/RDMCommand.h>
+#include <ola/rdm/RDMPacket.h>
+
+#include <iomanip>
+#include <memory>
+#include <ostream>
+
+#include "tools/logic/FramePrinter.h"
+
+using ola::rdm::RDMCommand;
+using ola::strings::ToHex;
+using std::auto_ptr;
+using std::endl;
+
+FramePrinter::FramePrinter(std::ostream *output, const Options &options)
+    : m_output(output),
+      m_options(options),
+      m_pid_helper(options.pid_location, 4),
+      m_command_printer(output, &m_pid_helper) {
+  if (!m_pid_helper.Init()) {
+    OLA_WARN << "Failed to init PidStore";
+  }
+}
+
+
+void FramePrinter::FrameReceived(const uint8_t *data, unsigned int length) {
+  if (!length) {
+    return;
+  }
+
+  switch (data[0]) {
+    case ola::DMX512_START_CODE:
+      DisplayDMXFrame(data + 1, length - 1);
+      break;
+    case ola::rdm::START_CODE:
+      DisplayRDMFrame(data + 1, length - 1);
+      break;
+    default:
+      DisplayAlternateFrame(data, length);
+  }
+}
+
+
+void FramePrinter::DisplayDMXFrame(const uint8_t *data, unsigned int length) {
+  if (!m_options.display_dmx) {
+    return;
+  }
+
+  *m_output << "DMX " << std::dec;
+  *m_output << length << ":" << std::hex;
+  DisplayRawData(data, length);
+}
+
+
+void FramePrinter::DisplayRDMFrame(const uint8_t *data, unsigned int length) {
+  auto_ptr<RDMCommand> command(RDMCommand::Inflate(data, length));
+  if (command.get()) {
+    if (m_options.full_rdm) {
+      *m_output << "---------------------------------------" << endl;
+    }
+    command->Print(&m_command_printer, !m_options.full_rdm, true);
+  } else {
+    *m_output << "RDM " << std::dec;
+    *m_output << length << ":" << std::hex;
+    DisplayRawData(data, length);
+  }
+}
+
+
+void FramePrinter::DisplayAlternateFrame(const uint8_t *data,
+                                         unsigned int length) {
+  if (!m_options.display_asc || length == 0) {
+    return;
+  }
+
+  unsigned int slot_count = length - 1;
+  *m_output << "SC " << ToHex(static_cast<int>(data[0]))
+            << " " << slot_count << ":";
+  DisplayRawData(data + 1, slot_count);
+}
+
+
+/**
+ * Dump out the raw data if we couldn't parse it correctly.
+ */
+void FramePrinter::DisplayRawData(const uint8_t *data, unsigned int length) {
+  for (unsigned int i = 0; i < length; i++) {
+    *m_output << std::hex << std::setw(2) << std::setfill('0')
+              << static_cast<int>(data[i]) << " ";
+  }
+  *m_output << endl;
+}
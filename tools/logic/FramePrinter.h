@@ -0,0 +1,71 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * FramePrinter.h
+ * Display the DMX / RDM frames decoded from a signal.
+ * Copyright (C) 2026 agent
+ */
+
+#ifndef TOOLS_LOGIC_FRAMEPRINTER_H_
+#define TOOLS_LOGIC_FRAMEPRINTER_H_
+
+#include <stdint.h>
+#include <ola/base/Macro.h>
+#include <ola/rdm/CommandPrinter.h>
+#include <ola/rdm/PidStoreHelper.h>
+
+#include <ostream>
+#include <string>
+
+/**
+ * Displays the frames from a SignalDecoder.
+ */
+class FramePrinter {
+ public:
+  struct Options {
+   public:
+    Options()
+        : display_dmx(false),
+          display_asc(false),
+          full_rdm(false) {
+    }
+
+    bool display_dmx;  // display DMX frames
+    bool display_asc;  // display non-RDM alternate start code frames
+    bool full_rdm;  // unpack the RDM parameter data
+    std::string pid_location;  // the directory containing the PID definitions
+  };
+
+  FramePrinter(std::ostream *output, const Options &options);
+
+  /**
+   * Display a frame, the first byte is the start code.
+   */
+  void FrameReceived(const uint8_t *data, unsigned int length);
+
+ private:
+  std::ostream *m_output;
+  const Options m_options;
+  ola::rdm::PidStoreHelper m_pid_helper;
+  ola::rdm::CommandPrinter m_command_printer;
+
+  void DisplayDMXFrame(const uint8_t *data, unsigned int length);
+  void DisplayRDMFrame(const uint8_t *data, unsigned int length);
+  void DisplayAlternateFrame(const uint8_t *data, unsigned int length);
+  void DisplayRawData(const uint8_t *data, unsigned int length);
+
+  DISALLOW_COPY_AND_ASSIGN(FramePrinter);
+};
+#endif  // TOOLS_LOGIC_FRAMEPRINTER_H_
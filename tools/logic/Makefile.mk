@@ -1,10 +1,17 @@
+bin_PROGRAMS += tools/logic/ola_signal_decoder
 if HAVE_SALEAE_LOGIC
 bin_PROGRAMS += tools/logic/logic_rdm_sniffer
 endif
 
+tools_logic_ola_signal_decoder_SOURCES = \
+    tools/logic/FramePrinter.cpp \
+    tools/logic/FramePrinter.h \
+    tools/logic/ola-signal-decoder.cpp
+tools_logic_ola_signal_decoder_LDADD = common/libolacommon.la
+
 tools_logic_logic_rdm_sniffer_SOURCES = \
-    tools/logic/DMXSignalProcessor.cpp \
-    tools/logic/DMXSignalProcessor.h \
+    tools/logic/FramePrinter.cpp \
+    tools/logic/FramePrinter.h \
     tools/logic/logic-rdm-sniffer.cpp
 tools_logic_logic_rdm_sniffer_LDADD = common/libolacommon.la \
                                       $(libSaleaeDevice_LIBS)
@@ -40,8 +40,6 @@
 #include <ola/io/SelectServer.h>
 #include <ola/Logging.h>
 #include <ola/network/NetworkUtils.h>
-#include <ola/rdm/CommandPrinter.h>
-#include <ola/rdm/PidStoreHelper.h>
 #include <ola/rdm/RDMCommand.h>
 #include <ola/rdm/RDMEnums.h>
 #include <ola/rdm/RDMHelper.h>
@@ -57,22 +55,19 @@
 #include <vector>
 #include <queue>
 
-#include "tools/logic/DMXSignalProcessor.h"
+#include "common/dmx/SignalDecoder.h"
+#include "tools/logic/FramePrinter.h"
 
-using std::auto_ptr;
 using std::cerr;
 using std::cout;
 using std::endl;
 using std::string;
 using std::vector;
+using ola::dmx::SignalDecoder;
 using ola::io::SelectServer;
 using ola::messaging::Descriptor;
 using ola::messaging::Message;
-using ola::rdm::CommandPrinter;
-using ola::rdm::PidStoreHelper;
-using ola::rdm::RDMCommand;
 using ola::rdm::UID;
-using ola::strings::ToHex;
 
 
 using ola::thread::Mutex;
@@ -105,20 +100,15 @@ class LogicReader {
         m_device_id(0),
         m_logic(NULL),
         m_ss(ss),
-        m_signal_processor(ola::NewCallback(this, &LogicReader::FrameReceived),
-                           sample_rate),
-        m_pid_helper(FLAGS_pid_location.str(), 4),
-        m_command_printer(&cout, &m_pid_helper) {
-      if (!m_pid_helper.Init()) {
-        OLA_WARN << "Failed to init PidStore";
-      }
+        m_printer(&cout, PrinterOptions()),
+        m_decoder(ola::NewCallback(&m_printer, &FramePrinter::FrameReceived),
+                  sample_rate) {
     }
     ~LogicReader();
 
     void DeviceConnected(U64 device, GenericInterface *interface);
     void DeviceDisconnected(U64 device);
     void DataReceived(U64 device, U8 *data, uint32_t data_length);
-    void FrameReceived(const uint8_t *data, unsigned int length);
 
     void Stop();
 
@@ -133,17 +123,14 @@ class LogicReader {
     LogicInterface *m_logic;  // GUARDED_BY(m_mu);
     mutable Mutex m_mu;
     SelectServer *m_ss;
-    DMXSignalProcessor m_signal_processor;
-    PidStoreHelper m_pid_helper;
-    CommandPrinter m_command_printer;
+    FramePrinter m_printer;
+    SignalDecoder m_decoder;
     Mutex m_data_mu;
     std::queue<U8*> m_free_data;
 
     void ProcessData(U8 *data, uint32_t data_length);
-    void DisplayDMXFrame(const uint8_t *data, unsigned int length);
-    void DisplayRDMFrame(const uint8_t *data, unsigned int length);
-    void DisplayAlternateFrame(const uint8_t *data, unsigned int length);
-    void DisplayRawData(const uint8_t *data, unsigned int length);
+
+    static FramePrinter::Options PrinterOptions();
 };
 
 LogicReader::~LogicReader() {
@@ -220,24 +207,6 @@ void LogicReader::DataReceived(U64 device, U8 *data, uint32_t data_length) {
 }
 
 
-void LogicReader::FrameReceived(const uint8_t *data, unsigned int length) {
-  if (!length) {
-    return;
-  }
-
-  switch (data[0]) {
-    case ola::DMX512_START_CODE:
-      DisplayDMXFrame(data + 1, length - 1);
-      break;
-    case ola::rdm::START_CODE:
-      DisplayRDMFrame(data + 1, length - 1);
-      break;
-    default:
-      DisplayAlternateFrame(data, length);
-  }
-}
-
-
 void LogicReader::Stop() {
   MutexLocker lock(&m_mu);
   if (m_logic) {
@@ -253,7 +222,7 @@ void LogicReader::Stop() {
  * @param data_length the size of the data
  */
 void LogicReader::ProcessData(U8 *data, uint32_t data_length) {
-  m_signal_processor.Process(data, data_length, 0x01);
+  m_decoder.Process(data, data_length, 0x01);
   DevicesManagerInterface::DeleteU8ArrayPtr(data);
 
   /*
@@ -269,53 +238,13 @@ void LogicReader::ProcessData(U8 *data, uint32_t data_length) {
 }
 
 
-void LogicReader::DisplayDMXFrame(const uint8_t *data, unsigned int length) {
-  if (!FLAGS_display_dmx) {
-    return;
-  }
-
-  cout << "DMX " << std::dec;
-  cout << length << ":" << std::hex;
-  DisplayRawData(data, length);
-}
-
-void LogicReader::DisplayRDMFrame(const uint8_t *data, unsigned int length) {
-  auto_ptr<RDMCommand> command(RDMCommand::Inflate(data, length));
-  if (command.get()) {
-    if (FLAGS_full_rdm) {
-      cout << "---------------------------------------" << endl;
-    }
-    command->Print(&m_command_printer, !FLAGS_full_rdm, true);
-  } else {
-    cout << "RDM " << std::dec;
-    cout << length << ":" << std::hex;
-    DisplayRawData(data, length);
-  }
-}
-
-
-void LogicReader::DisplayAlternateFrame(const uint8_t *data,
-                                        unsigned int length) {
-  if (!FLAGS_display_asc || length == 0) {
-    return;
-  }
-
-  unsigned int slot_count = length - 1;
-  cout << "SC " << ToHex(static_cast<int>(data[0]))
-       << " " << slot_count << ":";
-  DisplayRawData(data + 1, slot_count);
-}
-
-
-/**
- * Dump out the raw data if we couldn't parse it correctly.
- */
-void LogicReader::DisplayRawData(const uint8_t *data, unsigned int length) {
-  for (unsigned int i = 0; i < length; i++) {
-    cout << std::hex << std::setw(2) << std::setfill('0')
-         << static_cast<int>(data[i]) << " ";
-  }
-  cout << endl;
+FramePrinter::Options LogicReader::PrinterOptions() {
+  FramePrinter::Options options;
+  options.display_dmx = FLAGS_display_dmx;
+  options.display_asc = FLAGS_display_asc;
+  options.full_rdm = FLAGS_full_rdm;
+  options.pid_location = FLAGS_pid_location.str();
+  return options;
 }
 
 // SaleaeDeviceApi callbacks
@@ -0,0 +1,133 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * ola-signal-decoder.cpp
+ * Decode DMX / RDM frames from a file of signal samples, such as a logic
+ * analyser capture or the data read by the SPI DMX plugin.
+ * Copyright (C) 2026 agent
+ */
+
+#include <stdint.h>
+#include <ola/Callback.h>
+#include <ola/Clock.h>
+#include <ola/Logging.h>
+#include <ola/base/Flags.h>
+#include <ola/base/Init.h>
+#include <ola/base/SysExits.h>
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "common/dmx/SignalDecoder.h"
+#include "tools/logic/FramePrinter.h"
+
+using ola::dmx::SignalDecoder;
+using std::string;
+using std::vector;
+
+DEFINE_default_bool(display_asc, false,
+                    "Display non-RDM alternate start code frames.");
+DEFINE_s_default_bool(full_rdm, r, false, "Unpack RDM parameter data.");
+DEFINE_s_default_bool(display_dmx, d, false,
+                      "Display DMX Frames. Defaults to false.");
+DEFINE_string(pid_location, "",
+              "The directory containing the PID definitions.");
+DEFINE_default_bool(packed, false,
+                    "The file has 8 samples per byte, MSB first, as received "
+                    "from a SPI bus. Otherwise there is one sample per byte.");
+DEFINE_uint32(sample_rate, 0,
+              "Sample rate in Hz. Defaults to 4000000, or 2000000 with "
+              "--packed, which is the rate the SPI DMX plugin uses.");
+DEFINE_uint8(mask, 1,
+             "The bits of each sample which carry the signal. Ignored with "
+             "--packed.");
+
+namespace {
+
+const unsigned int DEFAULT_SAMPLE_RATE = 4000000;
+// The same as SPIDMXWidget::SPI_SPEED.
+const unsigned int SPI_SAMPLE_RATE = 2000000;
+const unsigned int READ_SIZE = 1 << 16;
+
+/*
+ * Decode the samples in a file.
+ */
+bool DecodeFile(const string &filename, bool packed, uint8_t mask,
+                unsigned int sample_rate, FramePrinter *printer) {
+  std::ifstream file(filename.c_str(), std::ios::in | std::ios::binary);
+  if (!file.is_open()) {
+    OLA_WARN << "Failed to open " << filename;
+    return false;
+  }
+
+  SignalDecoder decoder(
+      ola::NewCallback(printer, &FramePrinter::FrameReceived), sample_rate);
+
+  ola::Clock clock;
+  ola::TimeStamp start, end;
+  clock.CurrentMonotonicTime(&start);
+
+  vector<uint8_t> buffer(READ_SIZE);
+  uint64_t samples = 0;
+  while (file) {
+    file.read(reinterpret_cast<char*>(&buffer[0]), buffer.size());
+    unsigned int size = file.gcount();
+    if (packed) {
+      decoder.ProcessPacked(&buffer[0], size);
+      samples += 8 * size;
+    } else {
+      decoder.Process(&buffer[0], size, mask);
+      samples += size;
+    }
+  }
+  decoder.Flush();
+
+  clock.CurrentMonotonicTime(&end);
+  OLA_INFO << "Decoded " << samples << " samples ("
+           << samples / static_cast<double>(sample_rate) << "s) in "
+           << (end - start);
+  return true;
+}
+}  // namespace
+
+/*
+ * Main.
+ */
+int main(int argc, char *argv[]) {
+  ola::AppInit(&argc, argv, "[ options ] <capture file>",
+               "Decode DMX/RDM frames from a file of signal samples, such as "
+               "a logic analyser capture or data read from a SPI bus.");
+
+  if (argc != 2) {
+    ola::DisplayUsageAndExit();
+  }
+
+  unsigned int sample_rate = FLAGS_sample_rate;
+  if (!sample_rate) {
+    sample_rate = FLAGS_packed ? SPI_SAMPLE_RATE : DEFAULT_SAMPLE_RATE;
+  }
+
+  FramePrinter::Options options;
+  options.display_dmx = FLAGS_display_dmx;
+  options.display_asc = FLAGS_display_asc;
+  options.full_rdm = FLAGS_full_rdm;
+  options.pid_location = FLAGS_pid_location.str();
+  FramePrinter printer(&std::cout, options);
+
+  return DecodeFile(argv[1], FLAGS_packed, FLAGS_mask, sample_rate,
+                    &printer) ? ola::EXIT_OK : ola::EXIT_NOINPUT;
+}
@@ -19,20 +19,13 @@
 
 #include <ola/Logging.h>
 #include <string.h>
-#include <unistd.h>
 #include <algorithm>
 #include <string>
 #include <vector>
 
-#ifdef _WIN32
-#define VC_EXTRALEAN
-#define WIN32_LEAN_AND_MEAN
-#include <ola/win/CleanWindows.h>
-#include <tchar.h>
-#endif  // _WIN32
-
 #include <ola/stl/STLUtils.h>
 #include "tools/ola_trigger/Action.h"
+#include "tools/ola_trigger/ProcessSpawner.h"
 #include "tools/ola_trigger/VariableInterpolator.h"
 
 using std::string;
@@ -62,81 +55,56 @@ void VariableAssignmentAction::Execute(Context *context, uint8_t) {
  * @brief Execute the command
  */
 void CommandAction::Execute(Context *context, uint8_t) {
-  char **args = BuildArgList(context);
+  vector<string> args;
+  if (!InterpolateArgs(context, &args)) {
+    OLA_WARN << "Failed to expand variables for " << m_command;
+    return;
+  }
 
   if (ola::LogLevel() >= ola::OLA_LOG_INFO) {
     std::ostringstream str;
-    char **ptr = args;
     str << "Executing: " << m_command << " : [";
-    ptr++;  // skip over argv[0]
-    while (*ptr) {
-      str << "\"" << *ptr++ << "\"";
-      if (*ptr) {
+    // skip over argv[0]
+    for (vector<string>::const_iterator iter = args.begin() + 1;
+         iter != args.end(); ++iter) {
+      if (iter != args.begin() + 1) {
         str << ", ";
       }
+      str << "\"" << *iter << "\"";
     }
     str << "]";
     OLA_INFO << str.str();
   }
 
-#ifdef _WIN32
-  std::ostringstream command_line_builder;
-  char** arg = args;
-  // Escape argv[0] if needed
-  if ((m_command.find(" ") != string::npos) &&
-      (m_command.find("\"") != 0)) {
-      command_line_builder << "\"" << m_command << "\" ";
+  if (m_spawner) {
+    m_spawner->Spawn(args);
   } else {
-    command_line_builder << m_command << " ";
-  }
-  ++arg;
-  while (*arg) {
-    command_line_builder << " " << *arg++;
+    ProcessSpawner::Launch(args);
   }
+}
 
-  STARTUPINFO startup_info;
-  PROCESS_INFORMATION process_information;
-
-  memset(&startup_info, 0, sizeof(startup_info));
-  startup_info.cb = sizeof(startup_info);
-  memset(&process_information, 0, sizeof(process_information));
-
-  LPTSTR cmd_line = _strdup(command_line_builder.str().c_str());
-
-  if (!CreateProcessA(NULL,
-                     cmd_line,
-                     NULL,
-                     NULL,
-                     FALSE,
-                     CREATE_NEW_CONSOLE,
-                     NULL,
-                     NULL,
-                     &startup_info,
-                     &process_information)) {
-    OLA_WARN << "Could not launch " << args[0] << ": " << GetLastError();
-    FreeArgList(args);
-  } else {
-    // Don't leak the handles
-    CloseHandle(process_information.hProcess);
-    CloseHandle(process_information.hThread);
-  }
 
-  free(cmd_line);
-#else
-  pid_t pid;
-  if ((pid = fork()) < 0) {
-    OLA_FATAL << "Could not fork to exec " << m_command;
-    FreeArgList(args);
-    return;
-  } else if (pid) {
-    // parent
-    OLA_DEBUG << "Child for " << m_command << " is " << pid;
-    FreeArgList(args);
-    return;
-  }
+/**
+ * @brief Interpolate the command and arguments.
+ * @param context the Context to use for the variables.
+ * @param[out] args the command, followed by the interpolated arguments.
+ * @returns true if all the variables were expanded, false otherwise.
+ */
+bool CommandAction::InterpolateArgs(const Context *context,
+                                    vector<string> *args) {
+  args->clear();
+  args->reserve(m_arguments.size() + 1);
+  args->push_back(m_command);
 
-  execvp(m_command.c_str(), args);
-#endif  // _WIN32
+  vector<string>::const_iterator iter = m_arguments.begin();
+  for (; iter != m_arguments.end(); iter++) {
+    string result;
+    if (!InterpolateVariables(*iter, &result, *context)) {
+      return false;
+    }
+    args->push_back(result);
+  }
+  return true;
 }
 
 
@@ -145,22 +113,18 @@ void CommandAction::Execute(Context *context, uint8_t) {
  * pointers which can be passed to exec()
  */
 char **CommandAction::BuildArgList(const Context *context) {
-  // we need to add the command here as the first arg, also +1 for the NULL
-  unsigned int array_size = m_arguments.size() + 2;
+  vector<string> interpolated_args;
+  if (!InterpolateArgs(context, &interpolated_args)) {
+    return NULL;
+  }
+
+  // +1 for the NULL
+  unsigned int array_size = interpolated_args.size() + 1;
   char **args = new char*[array_size];
   memset(args, 0, sizeof(args[0]) * array_size);
 
-  args[0] = StringToDynamicChar(m_command);
-
-  vector<string>::const_iterator iter = m_arguments.begin();
-  unsigned int i = 1;
-  for (; iter != m_arguments.end(); i++, iter++) {
-    string result;
-    if (!InterpolateVariables(*iter, &result, *context)) {
-      FreeArgList(args);
-      return NULL;
-    }
-    args[i] = StringToDynamicChar(result);
+  for (unsigned int i = 0; i < interpolated_args.size(); i++) {
+    args[i] = StringToDynamicChar(interpolated_args[i]);
   }
   return args;
 }
@@ -244,6 +208,7 @@ Slot::~Slot() {
 bool Slot::AddAction(const ValueInterval &interval_arg,
                      Action *rising_action,
                      Action *falling_action) {
+  m_compiled = false;
   ActionInterval action_interval(
       new ValueInterval(interval_arg),
       rising_action,
@@ -347,6 +312,25 @@ bool Slot::SetDefaultFallingAction(Action *action) {
 }
 
 
+/**
+ * @brief Build the table used to map DMX values to actions.
+ *
+ * This is called automatically if required, but may be called once the
+ * actions have been added to avoid the cost on the first frame.
+ */
+void Slot::Compile() {
+  memset(m_action_table, 0, sizeof(m_action_table));
+  for (unsigned int i = 0; i < m_actions.size(); i++) {
+    const ValueInterval *interval = m_actions[i].interval;
+    for (unsigned int value = interval->Lower(); value <= interval->Upper();
+         value++) {
+      m_action_table[value] = i + 1;
+    }
+  }
+  m_compiled = true;
+}
+
+
 /**
  * @brief Lookup the action for a value, and if we find one, execute it. Otherwise
  *   execute the default action if there is one.
@@ -396,17 +380,6 @@ string Slot::IntervalsAsString() const {
 }
 
 
-/**
- * @brief Given two interval iterators, first and last, return true if the value is
- *   contained within the lower and upper bounds of the intervals.
- */
-bool Slot::ValueWithinIntervals(uint8_t value,
-                                const ValueInterval &lower_interval,
-                                const ValueInterval &upper_interval) {
-  return lower_interval.Lower() <= value && value <= upper_interval.Upper();
-}
-
-
 /**
  * @brief Check if two ValueIntervals intersect.
  */
@@ -427,53 +400,17 @@ bool Slot::IntervalsIntersect(const ValueInterval *a1,
  * @returns the Action matching the value,  or NULL if there isn't one.
  */
 Action *Slot::LocateMatchingAction(uint8_t value, bool rising) {
-  if (m_actions.empty()) {
-    return NULL;
+  if (!m_compiled) {
+    Compile();
   }
 
-  ActionVector::iterator lower = m_actions.begin();
-  ActionVector::iterator upper = m_actions.end();
-  upper--;
-  if (!ValueWithinIntervals(value, *(lower->interval), *(upper->interval))) {
+  uint16_t index = m_action_table[value];
+  if (index == 0) {
     return NULL;
   }
-
-  // ok, we know the value lies between the intervals we have, first exclude
-  // the endpoints
-  if (lower->interval->Contains(value)) {
-    return rising ? lower->rising_action : lower->falling_action;
-  }
-
-  if (upper->interval->Contains(value)) {
-    return rising ? upper->rising_action : upper->falling_action;
-  }
-
-  // value isn't at the lower or upper interval, but lies somewhere between
-  // the two.
-  // @pre lower != upper
-  // @pre !lower.Contains(value) && !upper.Contains(value)
-  while (true) {
-    unsigned int difference = upper - lower;
-    ActionVector::iterator mid = lower + difference / 2;
-
-    if (mid == lower) {
-      // lower doesn't contain the value, so we don't have it
-      return NULL;
-    }
-
-    if (mid->interval->Contains(value)) {
-      return rising ? mid->rising_action : mid->falling_action;
-    } else if (value <= mid->interval->Lower()) {
-      upper = mid;
-    } else if (value >= mid->interval->Upper()) {
-      lower = mid;
-    } else {
-      OLA_WARN << "Inconsistent intervals detected when looking for: "
-               << static_cast<int>(value) << ", intervals: "
-               << IntervalsAsString(lower, upper);
-      return NULL;
-    }
-  }
+  const ActionInterval &action_interval = m_actions[index - 1];
+  return rising ? action_interval.rising_action :
+                  action_interval.falling_action;
 }
 
 
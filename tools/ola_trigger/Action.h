@@ -22,6 +22,7 @@
 #define TOOLS_OLA_TRIGGER_ACTION_H_
 
 #include <stdint.h>
+#include <ola/Constants.h>
 #include <ola/Logging.h>
 #include <sstream>
 #include <string>
@@ -29,6 +30,8 @@
 
 #include "tools/ola_trigger/Context.h"
 
+class ProcessSpawner;
+
 /*
  * @brief An Action is a behavior that is run when a particular DMX value is received
  * on a particular slot.
@@ -80,13 +83,18 @@ class VariableAssignmentAction: public Action {
 
 /**
  * @brief Command Action. This action executes a command.
+ *
+ * If a ProcessSpawner is provided the command is run from the spawner's
+ * thread, otherwise it's run immediately.
  */
 class CommandAction: public Action {
  public:
   CommandAction(const std::string &command,
-                const std::vector<std::string> &arguments)
+                const std::vector<std::string> &arguments,
+                ProcessSpawner *spawner = NULL)
       : m_command(command),
-        m_arguments(arguments) {
+        m_arguments(arguments),
+        m_spawner(spawner) {
   }
   virtual ~CommandAction() {}
 
@@ -95,7 +103,10 @@ class CommandAction: public Action {
  protected:
   const std::string m_command;
   std::vector<std::string> m_arguments;
+  ProcessSpawner *m_spawner;
 
+  bool InterpolateArgs(const Context *context,
+                       std::vector<std::string> *args);
   char **BuildArgList(const Context *context);
   void FreeArgList(char **args);
   char *StringToDynamicChar(const std::string &str);
@@ -147,7 +158,8 @@ class Slot {
       m_default_falling_action(NULL),
       m_slot_offset(slot_offset),
       m_old_value(0),
-      m_old_value_defined(false) {
+      m_old_value_defined(false),
+      m_compiled(false) {
   }
   ~Slot();
 
@@ -159,6 +171,7 @@ class Slot {
                  Action *falling_action);
   bool SetDefaultRisingAction(Action *action);
   bool SetDefaultFallingAction(Action *action);
+  void Compile();
   void TakeAction(Context *context, uint8_t value);
 
   std::string IntervalsAsString() const;
@@ -174,6 +187,11 @@ class Slot {
   uint8_t m_old_value;
   bool m_old_value_defined;
 
+  // Maps each DMX value to one more than the index of the matching interval
+  // in m_actions, or 0 if no interval contains the value. Built by Compile().
+  uint16_t m_action_table[ola::DMX_MAX_SLOT_VALUE + 1];
+  bool m_compiled;
+
   /**
    * @brief An interval of DMX values and the action to be taken for matching
    * values.
@@ -246,9 +264,6 @@ class Slot {
   typedef std::vector<ActionInterval> ActionVector;
   ActionVector m_actions;
 
-  bool ValueWithinIntervals(uint8_t value,
-                            const ValueInterval &lower_interval,
-                            const ValueInterval &upper_interval);
   bool IntervalsIntersect(const ValueInterval *a1,
                           const ValueInterval *a2);
   Action *LocateMatchingAction(uint8_t value, bool rising);
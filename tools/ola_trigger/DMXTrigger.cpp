@@ -26,6 +26,12 @@
 
 using ola::DmxBuffer;
 
+namespace {
+bool SlotOffsetLessThan(const Slot *a, const Slot *b) {
+  return *a < *b;
+}
+}  // namespace
+
 
 /**
  * @brief Create a new trigger
@@ -34,7 +40,12 @@ DMXTrigger::DMXTrigger(Context *context,
                        const SlotVector &actions)
     : m_context(context),
       m_slots(actions) {
-  sort(m_slots.begin(), m_slots.end());
+  sort(m_slots.begin(), m_slots.end(), SlotOffsetLessThan);
+
+  SlotVector::iterator iter = m_slots.begin();
+  for (; iter != m_slots.end(); iter++) {
+    (*iter)->Compile();
+  }
 }
 
 
@@ -42,6 +53,10 @@ DMXTrigger::DMXTrigger(Context *context,
  * @brief Called when new DMX arrives.
  */
 void DMXTrigger::NewDMX(const DmxBuffer &data) {
+  if (data == m_last_frame) {
+    return;
+  }
+
   SlotVector::iterator iter = m_slots.begin();
   for (; iter != m_slots.end(); iter++) {
     uint16_t slot_number = (*iter)->SlotOffset();
@@ -49,6 +64,12 @@ void DMXTrigger::NewDMX(const DmxBuffer &data) {
       // the DMX frame was too small
       break;
     }
-    (*iter)->TakeAction(m_context, data.Get(slot_number));
+    uint8_t value = data.Get(slot_number);
+    if (slot_number < m_last_frame.Size() &&
+        m_last_frame.Get(slot_number) == value) {
+      continue;
+    }
+    (*iter)->TakeAction(m_context, value);
   }
+  m_last_frame = data;
 }
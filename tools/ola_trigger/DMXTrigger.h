@@ -28,6 +28,9 @@
 
 /*
  * @brief The class which manages the triggering.
+ *
+ * Only the slots which changed since the previous frame are passed to their
+ * Slot objects.
  */
 class DMXTrigger {
  public:
@@ -40,6 +43,7 @@ class DMXTrigger {
 
  private:
   Context *m_context;
-  SlotVector m_slots;  // kept sorted
+  SlotVector m_slots;  // kept sorted by offset
+  ola::DmxBuffer m_last_frame;
 };
 #endif  // TOOLS_OLA_TRIGGER_DMXTRIGGER_H_
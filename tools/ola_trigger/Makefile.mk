@@ -22,6 +22,8 @@ tools_ola_trigger_libolatrigger_la_SOURCES = \
     tools/ola_trigger/Context.h \
     tools/ola_trigger/DMXTrigger.cpp \
     tools/ola_trigger/DMXTrigger.h \
+    tools/ola_trigger/ProcessSpawner.cpp \
+    tools/ola_trigger/ProcessSpawner.h \
     tools/ola_trigger/VariableInterpolator.h \
     tools/ola_trigger/VariableInterpolator.cpp
 tools_ola_trigger_libolatrigger_la_LIBADD = common/libolacommon.la
@@ -67,6 +69,7 @@ tools_ola_trigger_ActionTester_SOURCES = \
     tools/ola_trigger/DMXTriggerTest.cpp \
     tools/ola_trigger/IntervalTest.cpp \
     tools/ola_trigger/MockAction.h \
+    tools/ola_trigger/ProcessSpawnerTest.cpp \
     tools/ola_trigger/SlotTest.cpp \
     tools/ola_trigger/VariableInterpolatorTest.cpp
 tools_ola_trigger_ActionTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
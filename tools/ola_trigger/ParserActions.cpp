@@ -112,7 +112,7 @@ Action *CreateAssignmentAction(vector<string> *input) {
  * @returns a CommandAction object
  */
 Action *CreateCommandAction(const string &command, vector<string> *args) {
-  Action *action = new CommandAction(command, *args);
+  Action *action = new CommandAction(command, *args, global_spawner);
   delete args;
   return action;
 }
@@ -32,4 +32,7 @@ extern class Context *global_context;
 typedef std::map<uint16_t, class Slot*> SlotActionMap;
 extern SlotActionMap global_slots;
 
+// The spawner used to run commands, may be NULL
+extern class ProcessSpawner *global_spawner;
+
 #endif  // TOOLS_OLA_TRIGGER_PARSERGLOBALS_H_
@@ -0,0 +1,242 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * ProcessSpawner.cpp
+ * Runs commands from a separate thread.
+ * Copyright (C) 2026 agent
+ */
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
+#include <string.h>
+#include <unistd.h>
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#define VC_EXTRALEAN
+#define WIN32_LEAN_AND_MEAN
+#include <ola/win/CleanWindows.h>
+#include <tchar.h>
+#elif defined(HAVE_SPAWN_H)
+#include <spawn.h>
+#ifdef __APPLE__
+#include <crt_externs.h>
+#define environ (*_NSGetEnviron())
+#else
+extern char **environ;
+#endif  // __APPLE__
+#endif  // _WIN32
+
+#include <ola/Logging.h>
+#include "tools/ola_trigger/ProcessSpawner.h"
+
+using ola::TimeInterval;
+using ola::TimeStamp;
+using ola::thread::MutexLocker;
+using std::string;
+using std::vector;
+
+
+ProcessSpawner::ProcessSpawner(unsigned int max_pending)
+    : ola::thread::Thread(ola::thread::Thread::Options("ola-trigger-spawn")),
+      m_max_pending(max_pending),
+      m_stopping(false),
+      m_spawn_count(0),
+      m_dropped_count(0),
+      m_total_latency(0),
+      m_max_latency(0) {
+}
+
+
+ProcessSpawner::~ProcessSpawner() {
+  Stop();
+}
+
+
+bool ProcessSpawner::Spawn(const vector<string> &args) {
+  MutexLocker lock(&m_mutex);
+  if (m_pending.size() >= m_max_pending) {
+    m_dropped_count++;
+    OLA_WARN << "Too many commands waiting to run, dropping " << args[0];
+    return false;
+  }
+
+  PendingCommand command;
+  command.args = args;
+  m_clock.CurrentMonotonicTime(&command.queued);
+  m_pending.push(command);
+  m_condition.Signal();
+  return true;
+}
+
+
+void ProcessSpawner::Stop() {
+  if (!IsRunning()) {
+    return;
+  }
+
+  {
+    MutexLocker lock(&m_mutex);
+    m_stopping = true;
+    m_condition.Signal();
+  }
+  Join();
+
+  if (m_spawn_count) {
+    OLA_INFO << "Ran " << m_spawn_count << " commands, " << m_dropped_count
+             << " dropped. Trigger to execution latency: mean "
+             << MeanLatency().AsInt() << " us, max "
+             << MaxLatency().AsInt() << " us";
+  }
+}
+
+
+void *ProcessSpawner::Run() {
+  while (true) {
+    PendingCommand command;
+    {
+      MutexLocker lock(&m_mutex);
+      while (m_pending.empty() && !m_stopping) {
+        m_condition.Wait(&m_mutex);
+      }
+      if (m_pending.empty()) {
+        break;
+      }
+      command = m_pending.front();
+      m_pending.pop();
+    }
+
+    TimeStamp now;
+    m_clock.CurrentMonotonicTime(&now);
+    int64_t latency = (now - command.queued).AsInt();
+    Launch(command.args);
+
+    MutexLocker lock(&m_mutex);
+    m_spawn_count++;
+    m_total_latency += latency;
+    m_max_latency = std::max(m_max_latency, latency);
+  }
+  return NULL;
+}
+
+
+unsigned int ProcessSpawner::SpawnCount() const {
+  MutexLocker lock(&m_mutex);
+  return m_spawn_count;
+}
+
+
+unsigned int ProcessSpawner::DroppedCount() const {
+  MutexLocker lock(&m_mutex);
+  return m_dropped_count;
+}
+
+
+TimeInterval ProcessSpawner::MeanLatency() const {
+  MutexLocker lock(&m_mutex);
+  if (m_spawn_count == 0) {
+    return TimeInterval();
+  }
+  return TimeInterval(m_total_latency / m_spawn_count);
+}
+
+
+TimeInterval ProcessSpawner::MaxLatency() const {
+  MutexLocker lock(&m_mutex);
+  return TimeInterval(m_max_latency);
+}
+
+
+bool ProcessSpawner::Launch(const vector<string> &args) {
+  const string &command = args[0];
+
+#ifdef _WIN32
+  std::ostringstream command_line_builder;
+  // Escape argv[0] if needed
+  if ((command.find(" ") != string::npos) &&
+      (command.find("\"") != 0)) {
+      command_line_builder << "\"" << command << "\" ";
+  } else {
+    command_line_builder << command << " ";
+  }
+  vector<string>::const_iterator iter = args.begin() + 1;
+  for (; iter != args.end(); ++iter) {
+    command_line_builder << " " << *iter;
+  }
+
+  STARTUPINFO startup_info;
+  PROCESS_INFORMATION process_information;
+
+  memset(&startup_info, 0, sizeof(startup_info));
+  startup_info.cb = sizeof(startup_info);
+  memset(&process_information, 0, sizeof(process_information));
+
+  LPTSTR cmd_line = _strdup(command_line_builder.str().c_str());
+
+  bool ok = CreateProcessA(NULL,
+                           cmd_line,
+                           NULL,
+                           NULL,
+                           FALSE,
+                           CREATE_NEW_CONSOLE,
+                           NULL,
+                           NULL,
+                           &startup_info,
+                           &process_information);
+  if (!ok) {
+    OLA_WARN << "Could not launch " << command << ": " << GetLastError();
+  } else {
+    // Don't leak the handles
+    CloseHandle(process_information.hProcess);
+    CloseHandle(process_information.hThread);
+  }
+
+  free(cmd_line);
+  return ok;
+#else
+  vector<char*> argv;
+  argv.reserve(args.size() + 1);
+  vector<string>::const_iterator iter = args.begin();
+  for (; iter != args.end(); ++iter) {
+    argv.push_back(const_cast<char*>(iter->c_str()));
+  }
+  argv.push_back(NULL);
+
+  pid_t pid;
+#ifdef HAVE_SPAWN_H
+  int error = posix_spawnp(&pid, command.c_str(), NULL, NULL, &argv[0],
+                           environ);
+  if (error) {
+    OLA_WARN << "Could not launch " << command << ": " << strerror(error);
+    return false;
+  }
+#else
+  if ((pid = fork()) < 0) {
+    OLA_FATAL << "Could not fork to exec " << command;
+    return false;
+  } else if (pid == 0) {
+    execvp(command.c_str(), &argv[0]);
+    _exit(127);
+  }
+#endif  // HAVE_SPAWN_H
+  OLA_DEBUG << "Child for " << command << " is " << pid;
+  return true;
+#endif  // _WIN32
+}
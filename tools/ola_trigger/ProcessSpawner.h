@@ -0,0 +1,110 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * ProcessSpawner.h
+ * Runs commands from a separate thread.
+ * Copyright (C) 2026 agent
+ */
+
+#ifndef TOOLS_OLA_TRIGGER_PROCESSSPAWNER_H_
+#define TOOLS_OLA_TRIGGER_PROCESSSPAWNER_H_
+
+#include <ola/Clock.h>
+#include <ola/base/Macro.h>
+#include <ola/thread/Mutex.h>
+#include <ola/thread/Thread.h>
+#include <queue>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Runs commands on a separate thread, so that starting a process
+ * doesn't delay the processing of DMX data.
+ *
+ * The number of commands waiting to be run is bounded; if the queue is full,
+ * new commands are dropped.
+ */
+class ProcessSpawner: public ola::thread::Thread {
+ public:
+  /**
+   * @brief Create a new ProcessSpawner.
+   * @param max_pending the maximum number of commands waiting to be run.
+   */
+  explicit ProcessSpawner(unsigned int max_pending = DEFAULT_MAX_PENDING);
+  ~ProcessSpawner();
+
+  /**
+   * @brief Queue a command to be run.
+   * @param args the command, followed by its arguments.
+   * @returns true if the command was queued, false if the queue was full.
+   */
+  bool Spawn(const std::vector<std::string> &args);
+
+  /**
+   * @brief Run any queued commands and stop the thread.
+   */
+  void Stop();
+
+  void *Run();
+
+  /**
+   * @brief The number of commands which have been run.
+   */
+  unsigned int SpawnCount() const;
+
+  /**
+   * @brief The number of commands dropped because the queue was full.
+   */
+  unsigned int DroppedCount() const;
+
+  /**
+   * @brief The mean time between a command being queued and it starting.
+   */
+  ola::TimeInterval MeanLatency() const;
+
+  /**
+   * @brief The max time between a command being queued and it starting.
+   */
+  ola::TimeInterval MaxLatency() const;
+
+  /**
+   * @brief Run a command immediately.
+   * @param args the command, followed by its arguments.
+   * @returns true if the process was started, false otherwise.
+   */
+  static bool Launch(const std::vector<std::string> &args);
+
+  static const unsigned int DEFAULT_MAX_PENDING = 32;
+
+ private:
+  struct PendingCommand {
+    std::vector<std::string> args;
+    ola::TimeStamp queued;
+  };
+
+  const unsigned int m_max_pending;
+  ola::Clock m_clock;
+  mutable ola::thread::Mutex m_mutex;
+  ola::thread::ConditionVariable m_condition;
+  std::queue<PendingCommand> m_pending;
+  bool m_stopping;
+  unsigned int m_spawn_count;
+  unsigned int m_dropped_count;
+  int64_t m_total_latency;
+  int64_t m_max_latency;
+
+  DISALLOW_COPY_AND_ASSIGN(ProcessSpawner);
+};
+#endif  // TOOLS_OLA_TRIGGER_PROCESSSPAWNER_H_
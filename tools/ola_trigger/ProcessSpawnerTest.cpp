@@ -0,0 +1,101 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * ProcessSpawnerTest.cpp
+ * Test fixture for the ProcessSpawner class
+ * Copyright (C) 2026 agent
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#ifndef _WIN32
+#include <errno.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#endif  // _WIN32
+#include <ola/Logging.h>
+#include <string>
+#include <vector>
+
+#include "tools/ola_trigger/ProcessSpawner.h"
+#include "ola/testing/TestUtils.h"
+
+
+using std::string;
+using std::vector;
+
+
+class ProcessSpawnerTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(ProcessSpawnerTest);
+  CPPUNIT_TEST(testBoundedQueue);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void testBoundedQueue();
+
+  void setUp() {
+    ola::InitLogging(ola::OLA_LOG_INFO, ola::OLA_LOG_STDERR);
+  }
+};
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(ProcessSpawnerTest);
+
+
+/**
+ * Wait for all child processes to exit, ola-trigger does this from its
+ * SIGCHLD handler.
+ * @returns the number of children reaped.
+ */
+static unsigned int ReapChildren() {
+  unsigned int count = 0;
+#ifndef _WIN32
+  while (true) {
+    pid_t pid = waitpid(-1, NULL, 0);
+    if (pid > 0) {
+      count++;
+    } else if (errno != EINTR) {
+      break;
+    }
+  }
+#endif  // _WIN32
+  return count;
+}
+
+
+/**
+ * Check that commands beyond the limit are dropped, and the rest are run when
+ * the spawner stops.
+ */
+void ProcessSpawnerTest::testBoundedQueue() {
+  vector<string> args;
+  args.push_back("true");
+
+  ProcessSpawner spawner(2);
+  OLA_ASSERT_TRUE(spawner.Spawn(args));
+  OLA_ASSERT_TRUE(spawner.Spawn(args));
+  OLA_ASSERT_FALSE(spawner.Spawn(args));
+  OLA_ASSERT_EQ(1u, spawner.DroppedCount());
+  OLA_ASSERT_EQ(0u, spawner.SpawnCount());
+
+  OLA_ASSERT_TRUE(spawner.Start());
+  spawner.Stop();
+  OLA_ASSERT_EQ(2u, spawner.SpawnCount());
+  OLA_ASSERT_EQ(1u, spawner.DroppedCount());
+  OLA_ASSERT_TRUE(spawner.MaxLatency() >= spawner.MeanLatency());
+
+#ifndef _WIN32
+  OLA_ASSERT_EQ(2u, ReapChildren());
+#endif  // _WIN32
+}
@@ -45,6 +45,7 @@
 #include "tools/ola_trigger/Context.h"
 #include "tools/ola_trigger/DMXTrigger.h"
 #include "tools/ola_trigger/ParserGlobals.h"
+#include "tools/ola_trigger/ProcessSpawner.h"
 
 using ola::DmxBuffer;
 using ola::STLDeleteElements;
@@ -57,6 +58,9 @@ DEFINE_s_uint16(offset, o, 0,
                 "Apply an offset to the slot numbers. Valid offsets are 0 to "
                 "512, default is 0.");
 DEFINE_s_uint32(universe, u, 0, "The universe to use, defaults to 0.");
+DEFINE_uint32(max_pending_commands, ProcessSpawner::DEFAULT_MAX_PENDING,
+              "The maximum number of commands waiting to run, further "
+              "commands are dropped.");
 DEFINE_default_bool(validate, false,
                     "Validate the config file, rather than running it.");
 
@@ -66,6 +70,7 @@ int yyparse();
 // globals modified by the config parser
 Context *global_context;
 SlotActionMap global_slots;
+ProcessSpawner *global_spawner = NULL;
 
 // The SelectServer to kill when we catch SIGINT
 ola::io::SelectServer *ss = NULL;
@@ -184,6 +189,8 @@ int main(int argc, char *argv[]) {
 
   // setup the default context
   global_context = new Context();
+  ProcessSpawner spawner(FLAGS_max_pending_commands);
+  global_spawner = &spawner;
   OLA_INFO << "Loading config from " << config_file;
 
   // open the config file
@@ -222,6 +229,11 @@ int main(int argc, char *argv[]) {
     exit(ola::EXIT_OSERR);
   }
 
+  // commands are run from a separate thread so they don't delay the DMX
+  if (!spawner.Start()) {
+    exit(ola::EXIT_OSERR);
+  }
+
   // create the vector of Slot
   SlotList slots;
   if (ApplyOffset(FLAGS_offset, &slots)) {
@@ -241,5 +253,6 @@ int main(int argc, char *argv[]) {
   }
 
   // cleanup
+  spawner.Stop();
   STLDeleteElements(&slots);
 }
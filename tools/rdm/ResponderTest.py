@@ -68,6 +68,9 @@ class TestFixture(object):
   DEPS = []
   PROVIDES = []
   REQUIRES = []
+  # Set this if the test sends to broadcast or vendorcast UIDs, or sends DUBs,
+  # since other responders on the universe will see the commands too.
+  EXCLUSIVE = False
 
   def __init__(self, device, universe, uid, pid_store, *args, **kwargs):
     self._warnings = []
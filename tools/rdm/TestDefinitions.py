@@ -202,6 +202,7 @@ class MuteAllDevices(ResponderTestFixture):
   """Mute all devices, so we can perform DUB tests"""
   PID = 'DISC_MUTE'
   CATEGORY = TestCategory.NETWORK_MANAGEMENT
+  EXCLUSIVE = True
   REQUIRES = ['mute_supported']
   # This is a fake property used to ensure this tests runs before the DUB tests.
   PROVIDES = ['global_mute']
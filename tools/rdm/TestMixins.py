@@ -418,6 +418,8 @@ class SetLabelMixin(ResponderTestFixture):
 
 class SetNonUnicastLabelMixin(SetLabelMixin):
   """Send a SET device label to a broadcast or vendorcast UID."""
+  EXCLUSIVE = True
+
   def Uid(self):
     self.SetBroken('Base method of SetNonUnicastLabelMixin called')
 
@@ -618,6 +620,7 @@ class SetDMXStartAddressMixin(ResponderTestFixture):
 
 class SetNonUnicastDMXStartAddressMixin(SetDMXStartAddressMixin):
   """Send a set dmx start address to a non unicast UID."""
+  EXCLUSIVE = True
 
   def Uid(self):
     self.SetBroken('Base method of SetNonUnicastDMXStartAddressMixin called')
@@ -654,6 +657,7 @@ class SetNonUnicastIdentifyMixin(ResponderTestFixture):
   To avoid sending a broadcast identify on (which may strike all lamps in a
   large rig), we instead turn identify on and then send a broadcast off.
   """
+  EXCLUSIVE = True
   REQUIRES = ['identify_state']
 
   def Uid(self):
@@ -780,7 +784,8 @@ class SetOutOfRangePresetStatusMixin(ResponderTestFixture):
 # Discovery Mixins
 # -----------------------------------------------------------------------------
 class DiscoveryMixin(ResponderTestFixture):
-  """UnMute the device, send a DUB, confirm the UID, then mute again.
+  """Mute all devices, unmute this one, send a DUB, confirm the UID, then
+    mute it again.
 
     This mixin requires:
       LowerBound() the lower UID to use in the DUB
@@ -798,6 +803,7 @@ class DiscoveryMixin(ResponderTestFixture):
         ffff:ffffffff
   """
   PID = 'DISC_UNIQUE_BRANCH'
+  EXCLUSIVE = True
   # Global Mute here ensures we run after all devices have been muted
   REQUIRES = ['mute_supported', 'unmute_supported', 'global_mute']
 
@@ -831,7 +837,14 @@ class DiscoveryMixin(ResponderTestFixture):
       self.Stop()
       return
 
-    self.UnMuteDevice(self.SendDUB)
+    self.MuteAllDevices(lambda: self.UnMuteDevice(self.SendDUB))
+
+  def MuteAllDevices(self, next_method):
+    # Tests for other responders on the universe may have unmuted them.
+    mute_pid = self.LookupPid('DISC_MUTE')
+    self.AddExpectedResults([BroadcastResult(action=next_method)])
+    self.SendDirectedDiscovery(UID.AllDevices(), PidStore.ROOT_DEVICE,
+                               mute_pid)
 
   def SendDUB(self):
     lower_bound = self.LowerBound()
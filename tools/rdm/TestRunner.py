@@ -18,8 +18,10 @@
 import datetime
 import inspect
 import logging
+import threading
 import time
 
+from ola.ClientWrapper import ClientWrapper
 from ola.OlaClient import OlaClient, RDMNack
 from ola.RDMAPI import RDMAPI
 from ola.testing.rdm.ResponderTest import (OptionalParameterTestFixture,
@@ -216,10 +218,44 @@ def GetTestClasses(module):
   return classes
 
 
+class TestLock(object):
+  """Stops exclusive tests running at the same time as any other test.
+
+  Any number of tests can hold the lock in shared mode. Once an exclusive test
+  is waiting no more shared holders are let in, so it can't be starved.
+  """
+  def __init__(self):
+    self._condition = threading.Condition()
+    self._shared_count = 0
+    self._exclusive_held = False
+    self._exclusive_waiting = 0
+
+  def Acquire(self, exclusive):
+    with self._condition:
+      if exclusive:
+        self._exclusive_waiting += 1
+        while self._exclusive_held or self._shared_count:
+          self._condition.wait()
+        self._exclusive_waiting -= 1
+        self._exclusive_held = True
+      else:
+        while self._exclusive_held or self._exclusive_waiting:
+          self._condition.wait()
+        self._shared_count += 1
+
+  def Release(self, exclusive):
+    with self._condition:
+      if exclusive:
+        self._exclusive_held = False
+      else:
+        self._shared_count -= 1
+      self._condition.notify_all()
+
+
 class TestRunner(object):
   """The Test Runner executes the tests."""
   def __init__(self, universe, uid, broadcast_write_delay, inter_test_delay,
-               pid_store, wrapper, timestamp=False):
+               pid_store, wrapper, timestamp=False, test_lock=None):
     """Create a new TestRunner.
 
     Args:
@@ -230,12 +266,17 @@ class TestRunner(object):
       pid_store: A PidStore object
       wrapper: A ClientWrapper object
       timestamp: true to print timestamps with each test
+      test_lock: A TestLock shared with the runners for other responders on
+        the universe, or None if this is the only runner.
     """
     self._universe = universe
     self._uid = uid
     self._broadcast_write_delay = broadcast_write_delay
     self._inter_test_delay = inter_test_delay
     self._timestamp = timestamp
+    self._test_lock = test_lock
+    # Tell the tests for different responders apart in the log
+    self._log_prefix = '' if test_lock is None else '%s: ' % uid
     self._pid_store = pid_store
     self._api = RDMAPI(wrapper.Client(), pid_store, strict_checks=False)
     self._wrapper = wrapper
@@ -329,7 +370,8 @@ class TestRunner(object):
         else:
           end_header = start_time_as_string
 
-      logging.debug('%s%s: %s' % (start_header, test, test.__doc__))
+      logging.debug('%s%s%s: %s' %
+                    (start_header, self._log_prefix, test, test.__doc__))
 
       if test.state is TestState.BROKEN:
         test.LogDebug(' Test broken after init, skipping test.')
@@ -343,13 +385,21 @@ class TestRunner(object):
         tests_completed += 1
         continue
 
-      test.Run()
+      if self._test_lock is None:
+        test.Run()
+      else:
+        self._test_lock.Acquire(test.EXCLUSIVE)
+        try:
+          test.Run()
+        finally:
+          self._test_lock.Release(test.EXCLUSIVE)
 
       # Use inter_test_delay on all but the last test
       if test != tests[-1]:
         time.sleep(self._inter_test_delay / 1000.0)
 
-      logging.info('%s%s: %s' % (end_header, test, test.state.ColorString()))
+      logging.info('%s%s%s: %s' % (end_header, self._log_prefix, test,
+                                   test.state.ColorString()))
       tests_completed += 1
     return tests, device
 
@@ -451,3 +501,84 @@ class TestRunner(object):
       for test in remove_list:
         remaining_tests.remove(test)
     return tests
+
+
+class ParallelTestRunner(object):
+  """Runs the tests against several responders on a universe at once.
+
+  Each responder gets its own TestRunner, connection to olad and thread, so
+  the tests for a responder still run in dependency order while requests to
+  different responders are in flight together. Tests marked EXCLUSIVE run
+  while no other tests are running.
+  """
+  def __init__(self, universe, uids, broadcast_write_delay, inter_test_delay,
+               pid_store, timestamp=False, wrapper_class=ClientWrapper):
+    """Create a new ParallelTestRunner.
+
+    Args:
+      universe: The universe number to use
+      uids: The list of UIDs to test
+      broadcast_write_delay: the delay to use after sending broadcast sets
+      inter_test_delay: the delay to use between tests
+      pid_store: A PidStore object
+      timestamp: true to print timestamps with each test
+      wrapper_class: Called to create the ClientWrapper for each responder
+    """
+    self._universe = universe
+    self._uids = uids
+    self._broadcast_write_delay = broadcast_write_delay
+    self._inter_test_delay = inter_test_delay
+    self._pid_store = pid_store
+    self._timestamp = timestamp
+    self._wrapper_class = wrapper_class
+    self._test_lock = TestLock()
+    self._test_classes = []
+    self._runners = {}
+
+  def TimingStats(self):
+    """Returns a dict of UID to the TimingStats for that responder."""
+    return dict((uid, runner.TimingStats())
+                for uid, runner in self._runners.items())
+
+  def RegisterTest(self, test_class):
+    """Register a test, see TestRunner.RegisterTest()."""
+    self._test_classes.append(test_class)
+
+  def RunTests(self, whitelist=None, no_factory_defaults=False):
+    """Run all the tests against every responder.
+
+    Args:
+      whitelist: If not None, limit the tests to those in the list and their
+        dependencies.
+      no_factory_defaults: Avoid running the SET factory defaults test.
+
+    Returns:
+      A dict of UID to the (tests, device) tuple from TestRunner.RunTests().
+      Responders which couldn't be tested are left out.
+    """
+    results = {}
+    threads = []
+    for uid in self._uids:
+      thread = threading.Thread(
+          target=self._RunTestsForUID,
+          args=(uid, whitelist, no_factory_defaults, results))
+      thread.start()
+      threads.append(thread)
+
+    for thread in threads:
+      thread.join()
+    return results
+
+  def _RunTestsForUID(self, uid, whitelist, no_factory_defaults, results):
+    # The wrapper has to be created in the thread that runs it.
+    wrapper = self._wrapper_class()
+    runner = TestRunner(self._universe, uid, self._broadcast_write_delay,
+                        self._inter_test_delay, self._pid_store, wrapper,
+                        self._timestamp, self._test_lock)
+    self._runners[uid] = runner
+    try:
+      for test_class in self._test_classes:
+        runner.RegisterTest(test_class)
+      results[uid] = runner.RunTests(whitelist, no_factory_defaults)
+    except Exception:
+      logging.exception('Testing %s failed' % uid)
@@ -16,6 +16,7 @@
 # TestRunnerTest.py
 # Copyright (C) 2022 Peter Newman
 
+import threading
 import unittest
 
 from ola.testing.rdm import ResponderTest, TestDefinitions, TestRunner
@@ -55,5 +56,49 @@ class TestRunnerGetTestClasses(unittest.TestCase):
                       "Class %s found in list of test classes" % classname)
 
 
+class TestLockTest(unittest.TestCase):
+  TIMEOUT = 5
+
+  def _AcquireInThread(self, lock, exclusive):
+    acquired = threading.Event()
+
+    def Acquire():
+      lock.Acquire(exclusive)
+      acquired.set()
+
+    thread = threading.Thread(target=Acquire)
+    thread.start()
+    return thread, acquired
+
+  def testSharedHolders(self):
+    lock = TestRunner.TestLock()
+    lock.Acquire(False)
+    thread, acquired = self._AcquireInThread(lock, False)
+    self.assertTrue(acquired.wait(self.TIMEOUT))
+    thread.join()
+    lock.Release(False)
+    lock.Release(False)
+
+  def testExclusive(self):
+    lock = TestRunner.TestLock()
+    lock.Acquire(False)
+    exclusive_thread, exclusive_acquired = self._AcquireInThread(lock, True)
+    self.assertFalse(exclusive_acquired.wait(0.1))
+
+    # Once an exclusive holder is waiting, new shared holders have to wait
+    shared_thread, shared_acquired = self._AcquireInThread(lock, False)
+    self.assertFalse(shared_acquired.wait(0.1))
+
+    lock.Release(False)
+    self.assertTrue(exclusive_acquired.wait(self.TIMEOUT))
+    exclusive_thread.join()
+    self.assertFalse(shared_acquired.wait(0.1))
+
+    lock.Release(True)
+    self.assertTrue(shared_acquired.wait(self.TIMEOUT))
+    shared_thread.join()
+    lock.Release(False)
+
+
 if __name__ == '__main__':
   unittest.main()
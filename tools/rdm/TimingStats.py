@@ -46,6 +46,14 @@ class FrameTypeStats(object):
     if frame.data_time:
       self._data_times.append(frame.data_time)
 
+  def Merge(self, other):
+    """Add the frames from another FrameTypeStats."""
+    self._count += other._count
+    self._response_times.extend(other._response_times)
+    self._break_times.extend(other._break_times)
+    self._mark_times.extend(other._mark_times)
+    self._data_times.extend(other._data_times)
+
   def Count(self):
     return self._count
 
@@ -98,6 +106,11 @@ class TimingStats(object):
     else:
       logging.error('Unknown frame type %s' % frame_type)
 
+  def Merge(self, other):
+    """Add the frames from another TimingStats, i.e. another responder."""
+    for frame_type, stats in self._stats_by_type.items():
+      stats.Merge(other.GetStatsForType(frame_type))
+
   @staticmethod
   def FrameTypeFromCommandClass(command_class):
     types = {
@@ -23,6 +23,7 @@ import logging
 import re
 import sys
 import textwrap
+import threading
 import time
 from optparse import OptionParser
 
@@ -48,7 +49,7 @@ __author__ = 'nomis52@gmail.com (Simon Newton)'
 
 
 def ParseOptions():
-  usage = 'Usage: %prog [options] <uid>'
+  usage = 'Usage: %prog [options] <uid> [<uid> ...]'
   description = textwrap.dedent("""\
     Run a series of tests on a RDM responder to check the behaviour.
     This requires the OLA server to be running, and the RDM device to have been
@@ -57,8 +58,13 @@ def ParseOptions():
     the start address, device label etc. will be changed for all devices
     connected to the responder. Think twice about running this on your
     production lighting rig.
+    If more than one UID is given, or --all is used, the responders are
+    tested at the same time. Tests which send broadcast commands still run
+    one at a time.
   """)
   parser = OptionParser(usage, description=description)
+  parser.add_option('-a', '--all', action='store_true',
+                    help='Test all the responders on the universe.')
   parser.add_option('-c', '--slot-count', default=10,
                     help='Number of slots to send when sending DMX.')
   parser.add_option('-d', '--debug', action='store_true',
@@ -100,17 +106,18 @@ def ParseOptions():
   if options.list_tests:
     return options
 
-  if not args:
+  if not args and not options.all:
     parser.print_help()
     sys.exit(2)
 
-  uid = UID.FromString(args[0])
-  if uid is None:
-    parser.print_usage()
-    print('Invalid UID: %s' % args[0])
-    sys.exit(2)
-
-  options.uid = uid
+  options.uids = []
+  for arg in args:
+    uid = UID.FromString(arg)
+    if uid is None:
+      parser.print_usage()
+      print('Invalid UID: %s' % arg)
+      sys.exit(2)
+    options.uids.append(uid)
   return options
 
 
@@ -135,7 +142,11 @@ def SetupLogging(options):
       format='%(message)s')
 
   if options.log:
-    file_name = '%s.%s.%d' % (options.log, options.uid, time.time())
+    if len(options.uids) == 1:
+      log_name = str(options.uids[0])
+    else:
+      log_name = 'universe%d' % options.universe
+    file_name = '%s.%s.%d' % (options.log, log_name, time.time())
     file_handler = logging.FileHandler(file_name, 'w')
     file_handler.addFilter(MyFilter())
     if options.debug:
@@ -164,9 +175,9 @@ def LogAllTimingParams(response_type, stats):
   LogTimingParam('Data', stats.Data())
 
 
-def DisplayTiming(timing_stats):
+def DisplayTiming(timing_stats, title='Response Timing'):
   """Print timing information."""
-  logging.info('--------------- Response Timing ----------------')
+  logging.info('--------------- %s ----------------' % title)
 
   stats = timing_stats.GetStatsForType(TimingStats.GET)
   LogAllTimingParams('GET_RESPONSE', stats)
@@ -178,7 +189,7 @@ def DisplayTiming(timing_stats):
   LogAllTimingParams('DISCOVERY_UNIQUE_BRANCH', stats)
 
 
-def DisplaySummary(options, runner, tests, device, pid_store):
+def DisplaySummary(options, uid, timing_stats, tests, device, pid_store):
   """Log a summary of the tests."""
   by_category = {}
   warnings = []
@@ -199,12 +210,12 @@ def DisplaySummary(options, runner, tests, device, pid_store):
   logging.info('------------------- Summary --------------------')
   now = datetime.datetime.now()
   logging.info('Test Run: %s' % now.strftime('%F %r %z'))
-  logging.info('UID: %s' % options.uid)
+  logging.info('UID: %s' % uid)
 
   manufacturer_label = getattr(device, 'manufacturer_label', None)
   if not manufacturer_label:
     manufacturer_label = (
-        pid_store.ManufacturerIdToName(options.uid.manufacturer_id))
+        pid_store.ManufacturerIdToName(uid.manufacturer_id))
     if manufacturer_label:
       manufacturer_label = str(manufacturer_label)
   if manufacturer_label:
@@ -219,7 +230,6 @@ def DisplaySummary(options, runner, tests, device, pid_store):
     logging.info('Software Version: %s' % software_version)
 
   if options.timing:
-    timing_stats = runner.TimingStats()
     DisplayTiming(timing_stats)
 
   logging.info('------------------- Warnings --------------------')
@@ -269,45 +279,50 @@ def main():
                                  'manufacturer_names.proto'))
   wrapper = ClientWrapper()
 
-  global uid_ok
-  uid_ok = False
+  # The UID list, if the fetch succeeded.
+  fetched_uids = []
 
   def UIDList(state, uids):
     wrapper.Stop()
-    global uid_ok
     if not state.Succeeded():
       logging.error('Fetch failed: %s' % state.message)
       return
-
-    for uid in uids:
-      if uid == options.uid:
-        logging.debug('Found UID %s' % options.uid)
-        uid_ok = True
-
-    if not uid_ok:
-      logging.error('UID %s not found in universe %d' %
-                    (options.uid, options.universe))
-      return
-
-    if len(uids) > 1:
-      logging.info(
-          'The following devices were detected and will be reconfigured')
-      for uid in uids:
-        logging.info(' %s' % uid)
-
-      if not options.skip_check:
-        logging.info('Continue ? [Y/n]')
-        response = raw_input().strip().lower()
-        uid_ok = response == 'y' or response == ''
+    fetched_uids.append(list(uids))
 
   logging.debug('Fetching UID list from server')
   wrapper.Client().FetchUIDList(options.universe, UIDList)
   wrapper.Run()
   wrapper.Reset()
 
-  if not uid_ok:
+  if not fetched_uids:
+    sys.exit(1)
+  uids = fetched_uids[0]
+
+  if options.all:
+    if not uids:
+      logging.error('No responders found in universe %d' % options.universe)
+      sys.exit(1)
+    options.uids = uids
+
+  missing_uids = [uid for uid in options.uids if uid not in uids]
+  for uid in missing_uids:
+    logging.error('UID %s not found in universe %d' %
+                  (uid, options.universe))
+  if missing_uids:
     sys.exit(1)
 
+  if len(uids) > len(options.uids):
+    logging.info(
+        'The following devices were detected and will be reconfigured')
+    for uid in uids:
+      logging.info(' %s' % uid)
+
+    if not options.skip_check:
+      logging.info('Continue ? [Y/n]')
+      response = raw_input().strip().lower()
+      if response != 'y' and response != '':
+        sys.exit(1)
+
   test_filter = None
   if options.tests is not None:
     logging.info('Restricting tests to %s' % options.tests)
@@ -316,28 +331,65 @@ def main():
   logging.info(
       'Starting tests, universe %d, UID %s, broadcast write delay %dms, '
       'inter-test delay %dms' %
-      (options.universe, options.uid, options.broadcast_write_delay,
-       options.inter_test_delay))
-
-  runner = TestRunner.TestRunner(options.universe,
-                                 options.uid,
-                                 options.broadcast_write_delay,
-                                 options.inter_test_delay,
-                                 pid_store,
-                                 wrapper,
-                                 options.timestamp)
-
-  for test_class in test_classes:
-    runner.RegisterTest(test_class)
+      (options.universe, ', '.join(str(uid) for uid in options.uids),
+       options.broadcast_write_delay, options.inter_test_delay))
 
   DMXSender(wrapper,
             options.universe,
             options.dmx_frame_rate,
             options.slot_count)
 
-  tests, device = runner.RunTests(test_filter, options.no_factory_defaults)
+  if len(options.uids) == 1:
+    runner = TestRunner.TestRunner(options.universe,
+                                   options.uids[0],
+                                   options.broadcast_write_delay,
+                                   options.inter_test_delay,
+                                   pid_store,
+                                   wrapper,
+                                   options.timestamp)
+
+    for test_class in test_classes:
+      runner.RegisterTest(test_class)
+
+    tests, device = runner.RunTests(test_filter, options.no_factory_defaults)
+    DisplaySummary(options, options.uids[0], runner.TimingStats(), tests,
+                   device, pid_store)
+    return
+
+  runner = TestRunner.ParallelTestRunner(options.universe,
+                                         options.uids,
+                                         options.broadcast_write_delay,
+                                         options.inter_test_delay,
+                                         pid_store,
+                                         options.timestamp)
+  for test_class in test_classes:
+    runner.RegisterTest(test_class)
+
+  # The wrapper keeps sending DMX until all the responders are done.
+  results = {}
 
-  DisplaySummary(options, runner, tests, device, pid_store)
+  def RunTests():
+    results.update(runner.RunTests(test_filter, options.no_factory_defaults))
+    wrapper.Stop()
+
+  thread = threading.Thread(target=RunTests)
+  thread.start()
+  wrapper.Run()
+  thread.join()
+
+  timing_stats = runner.TimingStats()
+  for uid in options.uids:
+    if uid not in results:
+      logging.error('Testing %s did not complete' % uid)
+      continue
+    tests, device = results[uid]
+    DisplaySummary(options, uid, timing_stats[uid], tests, device, pid_store)
+
+  if options.timing:
+    all_stats = TimingStats()
+    for stats in timing_stats.values():
+      all_stats.Merge(stats)
+    DisplayTiming(all_stats, 'All Responders')
 
 
 if __name__ == '__main__':